@@ -11,9 +11,11 @@
  * limitations under the License.
  */
 
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <vector>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <iostream>
@@ -37,15 +39,97 @@
 
 static int data_cb(const struct nlmsghdr* nlh, void* data);
 
+namespace {
+// Workers draining sharded per-flow queues
+const size_t NUM_FLOW_WORKERS = 4;
+// Events beyond this per-worker backlog are shed so a churn storm can
+// never grow the queues without bound
+const size_t MAX_PENDING_FLOW_EVENTS = 8192;
+// Datagrams pulled out of the socket per recvmmsg call
+const unsigned int NL_RECV_BATCH = 64;
+// Kernel-side socket buffer; sized to ride out event storms without
+// ENOBUFS while the workers catch up
+const int NL_SOCKET_RCVBUF = 4 * 1024 * 1024;
+}  // namespace
+
 namespace magma {
 namespace lte {
 
 EventTracker::EventTracker(std::shared_ptr<PacketGenerator> pkt_gen, int zone)
-    : pkt_gen_(pkt_gen), zone_(zone) {}
+    : pkt_gen_(pkt_gen), zone_(zone), running_(true), dropped_events_(0) {
+  for (size_t i = 0; i < NUM_FLOW_WORKERS; i++) {
+    workers_.push_back(std::unique_ptr<flow_worker_s>(new flow_worker_s()));
+    workers_[i]->thread =
+        std::thread(&EventTracker::flow_worker_loop, this, workers_[i].get());
+  }
+}
+
+EventTracker::~EventTracker() {
+  for (auto& worker : workers_) {
+    {
+      std::lock_guard<std::mutex> lock(worker->mutex);
+      running_ = false;
+    }
+    worker->cv.notify_one();
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+  }
+}
+
+void EventTracker::handle_flow_event(const struct flow_information& flow) {
+  uint32_t hash = flow.saddr ^ flow.daddr ^ flow.l4_proto ^
+                  ((uint32_t) flow.sport << 16 | flow.dport);
+  hash                  = hash * 2654435761u;  // Knuth multiplicative mix
+  flow_worker_s* worker = workers_[hash % NUM_FLOW_WORKERS].get();
+  {
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    if (worker->queue.size() >= MAX_PENDING_FLOW_EVENTS) {
+      dropped_events_++;
+      if ((dropped_events_ % 1000) == 1) {
+        MLOG(MWARNING) << "Flow event queue full, dropped " << dropped_events_
+                       << " conntrack events so far";
+      }
+      return;
+    }
+    worker->queue.push_back(flow);
+  }
+  worker->cv.notify_one();
+}
+
+void EventTracker::flow_worker_loop(struct flow_worker_s* worker) {
+  while (true) {
+    struct flow_information flow;
+    {
+      std::unique_lock<std::mutex> lock(worker->mutex);
+      while (worker->queue.empty() && running_) {
+        // Push out any batched packets before going to sleep so the
+        // tail of a burst is never stranded in the TX ring
+        lock.unlock();
+        pkt_gen_->flush();
+        lock.lock();
+        if (!worker->queue.empty() || !running_) {
+          break;
+        }
+        worker->cv.wait(lock);
+      }
+      if (!running_ && worker->queue.empty()) {
+        return;
+      }
+      flow = worker->queue.front();
+      worker->queue.pop_front();
+    }
+    pkt_gen_->send_packet(&flow);
+  }
+}
 
 int EventTracker::init_conntrack_event_loop() {
   struct mnl_socket* nl;
-  char buf[MNL_SOCKET_BUFFER_SIZE];
+  // MNL_SOCKET_BUFFER_SIZE is not a compile-time constant, so the
+  // receive ring lives on the heap
+  std::vector<char> bufs(NL_RECV_BATCH * MNL_SOCKET_BUFFER_SIZE);
+  struct mmsghdr msgs[NL_RECV_BATCH];
+  struct iovec iovs[NL_RECV_BATCH];
   int ret;
 
   nl = mnl_socket_open(NETLINK_NETFILTER);
@@ -64,16 +148,48 @@ int EventTracker::init_conntrack_event_loop() {
     exit(EXIT_FAILURE);
   }
 
+  // A larger kernel buffer absorbs event storms while user space drains
+  int rcvbuf = NL_SOCKET_RCVBUF;
+  if (setsockopt(
+          mnl_socket_get_fd(nl), SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf,
+          sizeof(rcvbuf)) < 0) {
+    // SO_RCVBUFFORCE needs CAP_NET_ADMIN; fall back to the clamped set
+    setsockopt(
+        mnl_socket_get_fd(nl), SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+  }
+
+  memset(msgs, 0, sizeof(msgs));
+  for (unsigned int i = 0; i < NL_RECV_BATCH; i++) {
+    iovs[i].iov_base           = &bufs[i * MNL_SOCKET_BUFFER_SIZE];
+    iovs[i].iov_len            = MNL_SOCKET_BUFFER_SIZE;
+    msgs[i].msg_hdr.msg_iov    = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
   while (1) {
-    ret = mnl_socket_recvfrom(nl, buf, sizeof(buf));
+    // Block for the first datagram, then drain whatever else is queued
+    ret = recvmmsg(
+        mnl_socket_get_fd(nl), msgs, NL_RECV_BATCH, MSG_WAITFORONE, NULL);
     if (ret == -1) {
-      perror("mnl_socket_recvfrom");
+      if (errno == ENOBUFS) {
+        // Kernel dropped events faster than we drained; keep going, the
+        // queues resynchronize on the next conntrack cycle
+        MLOG(MWARNING) << "Netlink receive buffer overrun, events lost";
+        continue;
+      }
+      if (errno == EINTR) {
+        continue;
+      }
+      perror("recvmmsg");
       exit(EXIT_FAILURE);
     }
-    ret = mnl_cb_run(buf, ret, 0, 0, data_cb, (void*) this);
-    if (ret == -1) {
-      perror("mnl_cb_run");
-      exit(EXIT_FAILURE);
+    for (int i = 0; i < ret; i++) {
+      if (mnl_cb_run(
+              &bufs[i * MNL_SOCKET_BUFFER_SIZE], msgs[i].msg_len, 0, 0, data_cb,
+              (void*) this) == -1) {
+        perror("mnl_cb_run");
+        exit(EXIT_FAILURE);
+      }
     }
   }
 
@@ -229,7 +345,7 @@ static int data_attr_cb(const struct nlattr* attr, void* data) {
 static int data_cb(const struct nlmsghdr* nlh, void* data) {
   struct nlattr* tb[CTA_MAX + 1] = {};
   struct nfgenmsg* nfg = (struct nfgenmsg*) mnl_nlmsg_get_payload(nlh);
-  struct flow_information flow;
+  struct flow_information flow = {};
   struct in_addr src_ip;
   struct in_addr dst_ip;
 
@@ -272,7 +388,7 @@ static int data_cb(const struct nlmsghdr* nlh, void* data) {
     MLOG(MINFO) << "From zone " << mnl_attr_get_u16(tb[CTA_ZONE]);
   }
 
-  ((magma::lte::EventTracker*) data)->pkt_gen_->send_packet(&flow);
+  ((magma::lte::EventTracker*) data)->handle_flow_event(flow);
 
   return MNL_CB_OK;
 }
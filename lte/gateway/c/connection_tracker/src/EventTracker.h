@@ -12,6 +12,13 @@
  */
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "PacketGenerator.h"
 
 namespace magma {
@@ -21,10 +28,34 @@ class EventTracker {
  public:
   EventTracker(std::shared_ptr<PacketGenerator> pkt_gen, int zone);
 
+  ~EventTracker();
+
   int init_conntrack_event_loop();
 
+  /**
+   * Queue a parsed conntrack event on the worker that owns its 5-tuple
+   * hash. Events of the same flow always land on the same worker, so
+   * per-flow ordering is preserved while flows are processed in parallel
+   * @param flow - parsed flow information from the netlink message
+   */
+  void handle_flow_event(const struct flow_information& flow);
+
   std::shared_ptr<PacketGenerator> pkt_gen_;
   int zone_;
+
+ private:
+  struct flow_worker_s {
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<struct flow_information> queue;
+  };
+
+  void flow_worker_loop(struct flow_worker_s* worker);
+
+  std::vector<std::unique_ptr<struct flow_worker_s>> workers_;
+  bool running_;
+  uint64_t dropped_events_;
 };
 
 }  // namespace lte
@@ -11,6 +11,7 @@
  * limitations under the License.
  */
 
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -18,10 +19,52 @@
 #include <iostream>
 #include <string>
 
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+
 #include <tins/tins.h>
 
 #include "PacketGenerator.h"
 
+namespace {
+// TX ring geometry; 256 frames of 2 KiB is plenty for a reconciliation
+// sweep and stays within one hugepage-free mmap
+const unsigned int TX_BLOCK_SIZE  = 4096;
+const unsigned int TX_BLOCK_COUNT = 128;
+const unsigned int TX_FRAME_SIZE  = 2048;
+const unsigned int TX_FRAME_COUNT = 256;
+// Queued frames are pushed to the kernel in batches of this size
+const size_t TX_BATCH = 32;
+
+// Offsets into the crafted ethernet/IPv4 packet
+const size_t IP_OFFSET       = 14;
+const size_t IP_SADDR_OFFSET = IP_OFFSET + 12;
+const size_t IP_DADDR_OFFSET = IP_OFFSET + 16;
+const size_t IP_CSUM_OFFSET  = IP_OFFSET + 10;
+const size_t L4_OFFSET       = IP_OFFSET + 20;
+
+uint32_t checksum_add(const uint8_t* data, size_t len, uint32_t sum) {
+  for (size_t i = 0; i + 1 < len; i += 2) {
+    sum += (uint32_t)(data[i] << 8 | data[i + 1]);
+  }
+  if (len & 1) {
+    sum += (uint32_t)(data[len - 1] << 8);
+  }
+  return sum;
+}
+
+uint16_t checksum_fold(uint32_t sum) {
+  while (sum >> 16) {
+    sum = (sum & 0xffff) + (sum >> 16);
+  }
+  return (uint16_t) ~sum;
+}
+}  // namespace
+
 namespace magma {
 namespace lte {
 
@@ -32,13 +75,177 @@ PacketGenerator::PacketGenerator(
     const std::string& pkt_src_mac)
     : iface_name_(iface_name),
       pkt_dst_mac_(pkt_dst_mac),
-      pkt_src_mac_(pkt_src_mac) {
+      pkt_src_mac_(pkt_src_mac),
+      fd_(-1),
+      ring_(NULL),
+      ring_size_(0),
+      frame_count_(TX_FRAME_COUNT),
+      frame_size_(TX_FRAME_SIZE),
+      next_frame_(0),
+      pending_(0) {
   iface_ = NetworkInterface(iface_name_);
   MLOG(MINFO) << "Using interface " << iface_name_.c_str()
               << " for pkt generation";
+  build_templates();
+  if (!setup_tx_ring()) {
+    MLOG(MWARNING) << "AF_PACKET TX ring unavailable, falling back to "
+                      "per-packet sends";
+  }
+}
+
+PacketGenerator::~PacketGenerator() {
+  if (ring_ != NULL) {
+    munmap(ring_, ring_size_);
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+void PacketGenerator::build_templates() {
+  EthernetII tcp_pkt(pkt_dst_mac_, pkt_src_mac_);
+  tcp_pkt /= IP(IPv4Address(uint32_t(0)), IPv4Address(uint32_t(0)));
+  tcp_pkt /= TCP(0, 0);
+  tcp_template_ = tcp_pkt.serialize();
+
+  EthernetII udp_pkt(pkt_dst_mac_, pkt_src_mac_);
+  udp_pkt /= IP(IPv4Address(uint32_t(0)), IPv4Address(uint32_t(0)));
+  udp_pkt /= UDP(0, 0);
+  udp_template_ = udp_pkt.serialize();
+}
+
+bool PacketGenerator::setup_tx_ring() {
+  fd_ = socket(AF_PACKET, SOCK_RAW, 0);
+  if (fd_ < 0) {
+    return false;
+  }
+
+  int version = TPACKET_V2;
+  if (setsockopt(
+          fd_, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
+    close(fd_);
+    fd_ = -1;
+    return false;
+  }
+
+  struct tpacket_req req = {};
+  req.tp_block_size      = TX_BLOCK_SIZE;
+  req.tp_block_nr        = TX_BLOCK_COUNT;
+  req.tp_frame_size      = TX_FRAME_SIZE;
+  req.tp_frame_nr        = TX_FRAME_COUNT;
+  if (setsockopt(fd_, SOL_PACKET, PACKET_TX_RING, &req, sizeof(req)) < 0) {
+    close(fd_);
+    fd_ = -1;
+    return false;
+  }
+
+  ring_size_ = (size_t) req.tp_block_size * req.tp_block_nr;
+  ring_      = (uint8_t*) mmap(
+      NULL, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (ring_ == MAP_FAILED) {
+    ring_ = NULL;
+    close(fd_);
+    fd_ = -1;
+    return false;
+  }
+
+  struct sockaddr_ll addr = {};
+  addr.sll_family         = AF_PACKET;
+  addr.sll_ifindex        = if_nametoindex(iface_name_.c_str());
+  if (bind(fd_, (struct sockaddr*) &addr, sizeof(addr)) < 0) {
+    munmap(ring_, ring_size_);
+    ring_ = NULL;
+    close(fd_);
+    fd_ = -1;
+    return false;
+  }
+  return true;
+}
+
+bool PacketGenerator::send_via_ring(struct flow_information* flow) {
+  const std::vector<uint8_t>& tpl =
+      (flow->l4_proto == 6) ? tcp_template_ : udp_template_;
+  std::lock_guard<std::mutex> lock(ring_mutex_);
+
+  struct tpacket2_hdr* hdr =
+      (struct tpacket2_hdr*) (ring_ + next_frame_ * frame_size_);
+  if (hdr->tp_status != TP_STATUS_AVAILABLE) {
+    // Ring is full; kick the kernel and drop if it stays that way
+    flush_locked();
+    if (hdr->tp_status != TP_STATUS_AVAILABLE) {
+      return false;
+    }
+  }
+
+  uint8_t* frame = (uint8_t*) hdr + TPACKET2_HDRLEN - sizeof(struct sockaddr_ll);
+  memcpy(frame, tpl.data(), tpl.size());
+
+  // Patch addresses and ports into the template
+  memcpy(frame + IP_SADDR_OFFSET, &flow->saddr, sizeof(flow->saddr));
+  memcpy(frame + IP_DADDR_OFFSET, &flow->daddr, sizeof(flow->daddr));
+  uint16_t sport = htons(flow->sport);
+  uint16_t dport = htons(flow->dport);
+  memcpy(frame + L4_OFFSET, &sport, sizeof(sport));
+  memcpy(frame + L4_OFFSET + 2, &dport, sizeof(dport));
+
+  // IP header checksum
+  frame[IP_CSUM_OFFSET]     = 0;
+  frame[IP_CSUM_OFFSET + 1] = 0;
+  uint16_t ip_csum = checksum_fold(checksum_add(frame + IP_OFFSET, 20, 0));
+  frame[IP_CSUM_OFFSET]     = ip_csum >> 8;
+  frame[IP_CSUM_OFFSET + 1] = ip_csum & 0xff;
+
+  // L4 checksum over the pseudo header and the (payload-free) header
+  size_t l4_len           = tpl.size() - L4_OFFSET;
+  size_t l4_csum_offset   = L4_OFFSET + ((flow->l4_proto == 6) ? 16 : 6);
+  frame[l4_csum_offset]     = 0;
+  frame[l4_csum_offset + 1] = 0;
+  uint32_t sum = checksum_add(frame + IP_SADDR_OFFSET, 8, 0);
+  sum += flow->l4_proto;
+  sum += l4_len;
+  uint16_t l4_csum = checksum_fold(checksum_add(frame + L4_OFFSET, l4_len, sum));
+  if (l4_csum == 0) {
+    l4_csum = 0xffff;  // UDP uses zero to mean "no checksum"
+  }
+  frame[l4_csum_offset]     = l4_csum >> 8;
+  frame[l4_csum_offset + 1] = l4_csum & 0xff;
+
+  hdr->tp_len    = tpl.size();
+  hdr->tp_status = TP_STATUS_SEND_REQUEST;
+  next_frame_    = (next_frame_ + 1) % frame_count_;
+  pending_++;
+  if (pending_ >= TX_BATCH) {
+    flush_locked();
+  }
+  return true;
+}
+
+void PacketGenerator::flush() {
+  std::lock_guard<std::mutex> lock(ring_mutex_);
+  flush_locked();
+}
+
+void PacketGenerator::flush_locked() {
+  if (fd_ < 0 || pending_ == 0) {
+    return;
+  }
+  if (send(fd_, NULL, 0, MSG_DONTWAIT) < 0 && errno != EAGAIN &&
+      errno != ENOBUFS) {
+    MLOG(MDEBUG) << "TX ring flush failed: " << strerror(errno);
+  }
+  pending_ = 0;
 }
 
 bool PacketGenerator::send_packet(struct flow_information* flow) {
+  if (flow->l4_proto != 6 && flow->l4_proto != 17) {
+    MLOG(MDEBUG) << "Encountered unsupported protocol, not sending pkt";
+    return false;
+  }
+
+  if (fd_ >= 0) {
+    return send_via_ring(flow);
+  }
+
   PacketSender sender;
 
   // Random mac header for our internal packets
@@ -47,11 +254,8 @@ bool PacketGenerator::send_packet(struct flow_information* flow) {
 
   if (flow->l4_proto == 6) {
     eth_ /= TCP(flow->dport, flow->sport);
-  } else if (flow->l4_proto == 17) {
-    eth_ /= UDP(flow->dport, flow->sport);
   } else {
-    MLOG(MDEBUG) << "Encountered unsupported protocol, not sending pkt";
-    return false;
+    eth_ /= UDP(flow->dport, flow->sport);
   }
 
   sender.send(eth_, iface_);
@@ -60,4 +264,4 @@ bool PacketGenerator::send_packet(struct flow_information* flow) {
 }
 
 }  // namespace lte
-}  // namespace magma
\ No newline at end of file
+}  // namespace magma
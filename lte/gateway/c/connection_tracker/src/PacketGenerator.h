@@ -14,6 +14,10 @@
 
 #include <tins/tins.h>
 
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
 #include "magma_logging.h"
 
 struct flow_information {
@@ -32,19 +36,60 @@ class PacketGenerator {
   PacketGenerator(
       const std::string& iface_name, const std::string& pkt_dst_mac,
       const std::string& pkt_src_mac);
+
+  ~PacketGenerator();
+
   /**
-   * Send packet based on provided flow information
+   * Send packet based on provided flow information. When the AF_PACKET
+   * TX ring is available the packet is patched into a pre-serialized
+   * template and queued in the ring; otherwise it is crafted and sent
+   * through libtins
    * @param flow_information - flow_information
    * @return true if the operation was successful
    */
   bool send_packet(struct flow_information* flow);
 
+  /**
+   * Kick the kernel to transmit any packets queued in the TX ring.
+   * Called by the event workers when their queues drain, so the tail of
+   * a burst never lingers in the ring
+   */
+  void flush();
+
  private:
+  /**
+   * Map an AF_PACKET TPACKET_V2 TX ring bound to the interface
+   * @return true if the ring is ready, false to fall back to libtins
+   */
+  bool setup_tx_ring();
+
+  /**
+   * Serialize template packets once; per flow only addresses, ports and
+   * checksums are patched
+   */
+  void build_templates();
+
+  bool send_via_ring(struct flow_information* flow);
+
+  void flush_locked();
+
   std::string iface_name_;
   std::string pkt_dst_mac_;
   std::string pkt_src_mac_;
   Tins::NetworkInterface iface_;
+
+  // TX ring state; fd_ is -1 when the ring is unavailable
+  int fd_;
+  uint8_t* ring_;
+  size_t ring_size_;
+  size_t frame_count_;
+  size_t frame_size_;
+  size_t next_frame_;
+  size_t pending_;
+  std::vector<uint8_t> tcp_template_;
+  std::vector<uint8_t> udp_template_;
+  std::mutex ring_mutex_;
 };
 
 }  // namespace lte
-}  // namespace magma
\ No newline at end of file
+}  // namespace magma
@@ -0,0 +1,141 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include "bstr_intern.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dynamic_memory_check.h"
+
+typedef struct bstr_intern_entry_s {
+  uint64_t hash;  // content hash, compared before the bytes
+  uint32_t refs;
+  bstring blob;
+  struct bstr_intern_entry_s* next;
+} bstr_intern_entry_t;
+
+/* A handful of distinct blobs cover an entire homogeneous device
+   population, so a mutex-guarded list beats a hash table here: interning
+   happens once per capability indication, ref/release are pointer scans */
+static pthread_mutex_t bstr_intern_lock = PTHREAD_MUTEX_INITIALIZER;
+static bstr_intern_entry_t* bstr_intern_entries = NULL;
+
+//------------------------------------------------------------------------------
+static uint64_t bstr_intern_hash(const uint8_t* buf, uint32_t len) {
+  // FNV-1a, collisions are resolved by the byte comparison in bstr_intern
+  uint64_t hash = 0xcbf29ce484222325ULL;
+
+  for (uint32_t i = 0; i < len; i++) {
+    hash = (hash ^ buf[i]) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+//------------------------------------------------------------------------------
+static bstr_intern_entry_t* bstr_intern_find_blob(bstring b) {
+  bstr_intern_entry_t* entry = bstr_intern_entries;
+
+  while (entry && entry->blob != b) {
+    entry = entry->next;
+  }
+  return entry;
+}
+
+//------------------------------------------------------------------------------
+bstring bstr_intern(const uint8_t* buf, uint32_t len) {
+  uint64_t hash = bstr_intern_hash(buf, len);
+
+  pthread_mutex_lock(&bstr_intern_lock);
+
+  for (bstr_intern_entry_t* entry = bstr_intern_entries; entry != NULL;
+       entry = entry->next) {
+    if ((entry->hash == hash) && (blength(entry->blob) == (int) len) &&
+        (memcmp(entry->blob->data, buf, len) == 0)) {
+      entry->refs++;
+      pthread_mutex_unlock(&bstr_intern_lock);
+      return entry->blob;
+    }
+  }
+
+  bstr_intern_entry_t* entry = calloc(1, sizeof(bstr_intern_entry_t));
+
+  entry->hash         = hash;
+  entry->refs         = 1;
+  entry->blob         = blk2bstr(buf, len);
+  entry->next         = bstr_intern_entries;
+  bstr_intern_entries = entry;
+  pthread_mutex_unlock(&bstr_intern_lock);
+  return entry->blob;
+}
+
+//------------------------------------------------------------------------------
+bstring bstr_intern_ref(bstring b) {
+  if (b == NULL) {
+    return NULL;
+  }
+
+  pthread_mutex_lock(&bstr_intern_lock);
+
+  bstr_intern_entry_t* entry = bstr_intern_find_blob(b);
+
+  if (entry) {
+    entry->refs++;
+    pthread_mutex_unlock(&bstr_intern_lock);
+    return b;
+  }
+  pthread_mutex_unlock(&bstr_intern_lock);
+
+  // Not interned (e.g. rebuilt from stored state): keep copy semantics
+  return bstrcpy(b);
+}
+
+//------------------------------------------------------------------------------
+void bstr_intern_release(bstring* b) {
+  if ((b == NULL) || (*b == NULL)) {
+    return;
+  }
+
+  pthread_mutex_lock(&bstr_intern_lock);
+
+  bstr_intern_entry_t* prev = NULL;
+
+  for (bstr_intern_entry_t* entry = bstr_intern_entries; entry != NULL;
+       prev = entry, entry = entry->next) {
+    if (entry->blob != *b) {
+      continue;
+    }
+
+    if (--entry->refs == 0) {
+      if (prev) {
+        prev->next = entry->next;
+      } else {
+        bstr_intern_entries = entry->next;
+      }
+      bdestroy_wrapper(&entry->blob);
+      free_wrapper((void**) &entry);
+    }
+    pthread_mutex_unlock(&bstr_intern_lock);
+    *b = NULL;
+    return;
+  }
+  pthread_mutex_unlock(&bstr_intern_lock);
+
+  // Not interned: the caller held the only copy
+  bdestroy_wrapper(b);
+}
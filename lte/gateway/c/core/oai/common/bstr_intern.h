@@ -0,0 +1,56 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file bstr_intern.h
+  \brief Interning store for immutable, reference counted bstrings
+
+  Large opaque blobs such as UE radio capabilities are identical across
+  thousands of contexts in a homogeneous device population. Interning
+  keeps one shared buffer per distinct content: bstr_intern deduplicates
+  by content hash, bstr_intern_ref hands out another reference for the
+  cost of a counter bump instead of a copy, and bstr_intern_release drops
+  one reference, freeing the buffer with the last one. Interned bstrings
+  must be treated as immutable by every holder. Both ref and release fall
+  back to a plain copy/destroy for bstrings that were not interned, so
+  they are safe on any bstring regardless of its origin.
+*/
+
+#ifndef FILE_BSTR_INTERN_SEEN
+#define FILE_BSTR_INTERN_SEEN
+
+#include <stdint.h>
+
+#include "bstrlib.h"
+
+/** \brief Return a shared bstring holding a copy of buf; contents already
+ * in the store are deduplicated to the existing buffer. The reference
+ * must be dropped with bstr_intern_release, never bdestroy
+ **/
+bstring bstr_intern(const uint8_t* buf, uint32_t len);
+
+/** \brief Take one more reference on an interned bstring and return it.
+ * Falls back to bstrcpy when b was not interned; returns NULL for NULL
+ **/
+bstring bstr_intern_ref(bstring b);
+
+/** \brief Drop one reference, freeing the buffer with the last one, and
+ * set *b to NULL. Falls back to bdestroy for bstrings that were not
+ * interned; tolerates NULL
+ **/
+void bstr_intern_release(bstring* b);
+
+#endif /* FILE_BSTR_INTERN_SEEN */
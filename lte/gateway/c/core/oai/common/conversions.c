@@ -37,6 +37,12 @@
 #include <stdint.h>
 #include <ctype.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "conversions.h"
 
 static const char hex_to_ascii_table[16] = {
@@ -98,6 +104,75 @@ int ascii_to_hex(uint8_t* dst, const char* h) {
     dst[i++] = (high << 4) | low;
   }
 }
+//------------------------------------------------------------------------------
+size_t bcd_to_ascii(
+    const uint8_t* from, char* to, size_t from_len, size_t to_size) {
+  size_t out = 0;
+
+  if (to_size == 0) {
+    return 0;
+  }
+#if defined(__SSE2__)
+  // 8 BCD bytes expand to 16 digits in one shot: split the nibbles, restore
+  // wire order by interleaving, add '0' and locate the first non-decimal
+  // nibble (0xf filler) through the comparison mask.
+  while ((from_len >= 8) && (to_size - out >= 16)) {
+    __m128i raw    = _mm_loadl_epi64((const __m128i*) from);
+    __m128i nibble = _mm_set1_epi8(0x0f);
+    __m128i hi     = _mm_and_si128(_mm_srli_epi16(raw, 4), nibble);
+    __m128i lo     = _mm_and_si128(raw, nibble);
+    __m128i digits = _mm_unpacklo_epi8(hi, lo);
+    _mm_storeu_si128(
+        (__m128i*) (to + out), _mm_add_epi8(digits, _mm_set1_epi8('0')));
+    int bad = _mm_movemask_epi8(_mm_cmpgt_epi8(digits, _mm_set1_epi8(9)));
+    size_t n = bad ? (size_t) __builtin_ctz(bad) : 16;
+    out += n;
+    if (n < 16) {
+      to[out] = '\0';
+      return out;
+    }
+    from += 8;
+    from_len -= 8;
+  }
+#elif defined(__ARM_NEON)
+  while ((from_len >= 8) && (to_size - out >= 16)) {
+    uint8x8_t raw     = vld1_u8(from);
+    uint8x8x2_t pair  =
+        vzip_u8(vshr_n_u8(raw, 4), vand_u8(raw, vdup_n_u8(0x0f)));
+    uint8x16_t digits = vcombine_u8(pair.val[0], pair.val[1]);
+    vst1q_u8((uint8_t*) (to + out), vaddq_u8(digits, vdupq_n_u8('0')));
+    // Narrowing shift folds the 16-lane compare into a 64-bit mask with four
+    // bits per lane, the NEON stand-in for SSE movemask.
+    uint8x16_t bad = vcgtq_u8(digits, vdupq_n_u8(9));
+    uint64_t mask  = vget_lane_u64(
+        vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(bad), 4)), 0);
+    size_t n = mask ? (size_t)(__builtin_ctzll(mask) >> 2) : 16;
+    out += n;
+    if (n < 16) {
+      to[out] = '\0';
+      return out;
+    }
+    from += 8;
+    from_len -= 8;
+  }
+#endif
+  while ((from_len > 0) && (out + 1 < to_size)) {
+    uint8_t hi = (*from & 0xf0) >> 4;
+    uint8_t lo = *from & 0x0f;
+    if (hi > 9) break;
+    to[out++] = hex_to_ascii_table[hi];
+    if ((lo > 9) || (out + 1 >= to_size)) break;
+    to[out++] = hex_to_ascii_table[lo];
+    from++;
+    from_len--;
+  }
+  if (out >= to_size) {
+    out = to_size - 1;
+  }
+  to[out] = '\0';
+  return out;
+}
+
 //------------------------------------------------------------------------------
 imsi64_t imsi_to_imsi64(const imsi_t* const imsi) {
   imsi64_t imsi64 = INVALID_IMSI64;
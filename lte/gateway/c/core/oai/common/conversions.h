@@ -518,22 +518,9 @@ imsi64_t amf_imsi_to_imsi64(const imsi_t* const imsi);
 
 #define IMSI_TO_STRING(iMsI_t_PtR, iMsI_sTr, MaXlEn)                           \
   do {                                                                         \
-    int l_i = 0;                                                               \
-    int l_j = 0;                                                               \
-    while ((l_i < IMSI_BCD8_SIZE) && (l_j < MaXlEn - 1)) {                     \
-      if ((((iMsI_t_PtR)->u.value[l_i] & 0xf0) >> 4) > 9) break;               \
-      snprintf(                                                                \
-          ((iMsI_sTr) + l_j), (MaXlEn - l_j), "%u",                            \
-          (((iMsI_t_PtR)->u.value[l_i] & 0xf0) >> 4));                         \
-      l_j++;                                                                   \
-      if (((iMsI_t_PtR)->u.value[l_i] & 0xf) > 9 || (l_j >= MaXlEn - 1))       \
-        break;                                                                 \
-      snprintf(                                                                \
-          ((iMsI_sTr) + l_j), (MaXlEn - l_j), "%u",                            \
-          ((iMsI_t_PtR)->u.value[l_i] & 0xf));                                 \
-      l_j++;                                                                   \
-      l_i++;                                                                   \
-    }                                                                          \
+    int l_j = (int) bcd_to_ascii(                                              \
+        (iMsI_t_PtR)->u.value, (iMsI_sTr), IMSI_BCD8_SIZE,                     \
+        (size_t)(MaXlEn));                                                     \
     for (; l_j < MaXlEn; l_j++) (iMsI_sTr)[l_j] = '\0';                        \
   } while (0);
 
@@ -730,6 +717,14 @@ void imsi_string_to_3gpp_imsi(const Imsi_t* Imsi, imsi_t* imsi);
 
 void hexa_to_ascii(uint8_t* from, char* to, size_t length);
 
+/* Expand packed BCD digits to ASCII, two characters per input byte, stopping
+ * at the first nibble that is not a decimal digit (0xf filler). Vectorized
+ * with SSE2/NEON when available; the output is always NUL terminated within
+ * to_size and the number of characters written is returned.
+ */
+size_t bcd_to_ascii(
+    const uint8_t* from, char* to, size_t from_len, size_t to_size);
+
 int ascii_to_hex(uint8_t* dst, const char* h);
 #define UINT8_TO_BINARY_FMT "%c%c%c%c%c%c%c%c"
 #define UINT8_TO_BINARY_ARG(bYtE)                                              \
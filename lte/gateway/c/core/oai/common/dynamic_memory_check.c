@@ -29,22 +29,62 @@
  */
 
 /*! \file dynamic_memory_check.c
-  \brief
+  \brief Checked free implementations for soak builds
   \author Lionel Gauthier
   \company Eurecom
   \email: lionel.gauthier@eurecom.fr
+
+  Compiled only with -DDYNAMIC_MEMORY_CHECK=1; production builds inline
+  the wrappers from the header and this translation unit is empty.
+  Released blocks are filled with a poison byte and parked in a
+  quarantine ring before reaching free(), so a use after free reads
+  poison instead of recycled data and a double free of a quarantined
+  block is caught by the ring scan.
 */
+#if DYNAMIC_MEMORY_CHECK
+
+#include <malloc.h>
+#include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "dynamic_memory_check.h"
 #include "assertions.h"
 
+#define DMC_POISON_BYTE 0xDD
+// Blocks held back from the allocator; sized so short-lived re-reads of
+// freed messages land on poison without retaining unbounded memory
+#define DMC_QUARANTINE_SLOTS 256
+
+static struct {
+  pthread_mutex_t lock;
+  void* slots[DMC_QUARANTINE_SLOTS];
+  unsigned int next;
+} quarantine = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+//------------------------------------------------------------------------------
+static void quarantine_insert(void* p) {
+  pthread_mutex_lock(&quarantine.lock);
+  for (unsigned int i = 0; i < DMC_QUARANTINE_SLOTS; i++) {
+    AssertFatal(quarantine.slots[i] != p, "Double free of %p", p);
+  }
+  void* evicted = quarantine.slots[quarantine.next];
+  quarantine.slots[quarantine.next] = p;
+  quarantine.next = (quarantine.next + 1) % DMC_QUARANTINE_SLOTS;
+  pthread_mutex_unlock(&quarantine.lock);
+  if (evicted) {
+    free(evicted);
+  }
+}
+
 //------------------------------------------------------------------------------
 void free_wrapper(void** ptr) {
-  // for debug only
   AssertFatal(ptr, "Trying to free NULL ptr");
-  if (ptr) {
-    free(*ptr);
+  if (ptr && *ptr) {
+    memset(*ptr, DMC_POISON_BYTE, malloc_usable_size(*ptr));
+    quarantine_insert(*ptr);
     *ptr = NULL;
   }
 }
@@ -52,7 +92,13 @@ void free_wrapper(void** ptr) {
 //------------------------------------------------------------------------------
 void bdestroy_wrapper(bstring* b) {
   if ((b) && (*b)) {
+    // poison the payload before bdestroy releases it
+    if ((*b)->data && (*b)->mlen > 0) {
+      memset((*b)->data, DMC_POISON_BYTE, (*b)->mlen);
+    }
     bdestroy(*b);
     *b = NULL;
   }
 }
+
+#endif /* DYNAMIC_MEMORY_CHECK */
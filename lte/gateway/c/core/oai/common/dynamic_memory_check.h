@@ -36,8 +36,38 @@
 */
 #ifndef FILE_DYNAMIC_MEMORY_CHECK_SEEN
 #define FILE_DYNAMIC_MEMORY_CHECK_SEEN
+#include <stdlib.h>
+
 #include "bstrlib.h"
 
+/*
+ * Checking is a compile-time policy. Production builds inline the wrappers
+ * down to the underlying free so the 10k msg/s paths pay nothing for them;
+ * soak builds (-DDYNAMIC_MEMORY_CHECK=1) get the out-of-line checked
+ * implementations, which assert on double frees, poison released blocks
+ * and quarantine them so stale readers fault on poison instead of on
+ * recycled memory.
+ */
+#if DYNAMIC_MEMORY_CHECK
+
 void free_wrapper(void** ptr) __attribute__((hot));
 void bdestroy_wrapper(bstring* b);
+
+#else /* DYNAMIC_MEMORY_CHECK */
+
+static inline void free_wrapper(void** ptr) {
+  if (ptr) {
+    free(*ptr);
+    *ptr = NULL;
+  }
+}
+
+static inline void bdestroy_wrapper(bstring* b) {
+  if ((b) && (*b)) {
+    bdestroy(*b);
+    *b = NULL;
+  }
+}
+
+#endif /* DYNAMIC_MEMORY_CHECK */
 #endif /* FILE_DYNAMIC_MEMORY_CHECK_SEEN */
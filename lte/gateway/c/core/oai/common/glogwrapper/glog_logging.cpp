@@ -32,8 +32,11 @@
 #include <vector>
 #include <regex>
 #include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <thread>
 #include <cstdio>
+#include <string.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include "glog_logging.h"
@@ -96,11 +99,160 @@ void init_logging(const char* app_name, uint32_t default_verbosity) {
   }
 }
 
+namespace {
+
+// Levels at or below this (emergency/alert/critical in the oai mapping)
+// force a synchronous drain: the process may be about to abort and the
+// record has to reach disk first
+constexpr int32_t FORCE_FLUSH_MAX_LEVEL = 2;
+// How long the writer sleeps when the ring is empty; bounds how far
+// records can trail the caller on an idle disk
+constexpr unsigned int DRAIN_IDLE_SLEEP_US = 20000;
+
+// One slot of the bounded ring. The sequence doubles as the slot state
+// (classic bounded MPMC scheme): seq == pos means free for the producer
+// claiming pos, seq == pos + 1 means published and ready to drain.
+struct log_cell {
+  std::atomic<uint64_t> seq;
+  int32_t level;
+  char* msg;
+};
+
+struct {
+  log_cell* cells = nullptr;
+  uint64_t mask   = 0;
+  std::atomic<uint64_t> enqueue_pos{0};
+  std::atomic<uint64_t> dequeue_pos{0};
+  std::atomic<uint64_t> dropped{0};
+  std::atomic<bool> running{false};
+  std::thread writer;
+} async_sink;
+
+bool async_sink_enqueue(int32_t log_level, const char* str) {
+  uint64_t pos = async_sink.enqueue_pos.load(std::memory_order_relaxed);
+  for (;;) {
+    log_cell& cell = async_sink.cells[pos & async_sink.mask];
+    uint64_t seq   = cell.seq.load(std::memory_order_acquire);
+    intptr_t diff  = (intptr_t) seq - (intptr_t) pos;
+    if (diff == 0) {
+      if (async_sink.enqueue_pos.compare_exchange_weak(
+              pos, pos + 1, std::memory_order_relaxed)) {
+        cell.level = log_level;
+        cell.msg   = strdup(str);
+        cell.seq.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      // The writer has not freed this slot yet: the ring is full
+      return false;
+    } else {
+      pos = async_sink.enqueue_pos.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+// Single consumer; returns the number of records written out
+size_t async_sink_drain() {
+  size_t drained = 0;
+  uint64_t pos   = async_sink.dequeue_pos.load(std::memory_order_relaxed);
+  for (;;) {
+    log_cell& cell = async_sink.cells[pos & async_sink.mask];
+    uint64_t seq   = cell.seq.load(std::memory_order_acquire);
+    if ((intptr_t) seq - (intptr_t)(pos + 1) != 0) {
+      break;  // next record not published yet
+    }
+    VLOG(cell.level) << cell.msg;
+    free(cell.msg);
+    cell.msg = nullptr;
+    // Hand the slot back to the producer that will claim pos + ring size
+    cell.seq.store(pos + async_sink.mask + 1, std::memory_order_release);
+    pos++;
+    drained++;
+    async_sink.dequeue_pos.store(pos, std::memory_order_relaxed);
+  }
+  return drained;
+}
+
+void async_sink_writer_loop() {
+  uint64_t reported_drops = 0;
+  while (async_sink.running.load(std::memory_order_acquire)) {
+    size_t drained = async_sink_drain();
+    uint64_t drops = async_sink.dropped.load(std::memory_order_relaxed);
+    if (drops != reported_drops) {
+      LOG(WARNING) << "Async log sink overflowed, dropped "
+                   << (drops - reported_drops) << " records";
+      reported_drops = drops;
+    }
+    if (drained > 0) {
+      // One flush per drained batch instead of one per record
+      google::FlushLogFiles(google::GLOG_INFO);
+    } else {
+      usleep(DRAIN_IDLE_SLEEP_US);
+    }
+  }
+  async_sink_drain();
+  google::FlushLogFiles(google::GLOG_INFO);
+}
+
+bool async_sink_empty() {
+  return async_sink.dequeue_pos.load(std::memory_order_acquire) ==
+         async_sink.enqueue_pos.load(std::memory_order_acquire);
+}
+
+}  // namespace
+
+void start_async_log_sink(uint32_t record_count) {
+  if (async_sink.running.load(std::memory_order_acquire)) {
+    return;
+  }
+  uint64_t capacity = 1;
+  while (capacity < record_count) {
+    capacity <<= 1;
+  }
+  async_sink.cells = new log_cell[capacity];
+  async_sink.mask  = capacity - 1;
+  for (uint64_t i = 0; i < capacity; i++) {
+    async_sink.cells[i].seq.store(i, std::memory_order_relaxed);
+    async_sink.cells[i].msg = nullptr;
+  }
+  async_sink.enqueue_pos.store(0, std::memory_order_relaxed);
+  async_sink.dequeue_pos.store(0, std::memory_order_relaxed);
+  async_sink.running.store(true, std::memory_order_release);
+  async_sink.writer = std::thread(async_sink_writer_loop);
+}
+
+void stop_async_log_sink(void) {
+  if (!async_sink.running.load(std::memory_order_acquire)) {
+    return;
+  }
+  async_sink.running.store(false, std::memory_order_release);
+  async_sink.writer.join();  // the writer drains and flushes on its way out
+  delete[] async_sink.cells;
+  async_sink.cells = nullptr;
+  async_sink.mask  = 0;
+}
+
 void flush_log(int32_t log_level) {
+  if (async_sink.running.load(std::memory_order_acquire)) {
+    // The writer flushes after every drained batch; flushing here would
+    // reintroduce the disk wait this sink exists to remove
+    return;
+  }
   google::FlushLogFiles(log_level);
 }
 
 void log_string(int32_t log_level, const char* str) {
+  if (async_sink.running.load(std::memory_order_acquire)) {
+    if (!async_sink_enqueue(log_level, str)) {
+      async_sink.dropped.fetch_add(1, std::memory_order_relaxed);
+    } else if (log_level <= FORCE_FLUSH_MAX_LEVEL) {
+      while (!async_sink_empty()) {
+        usleep(1000);
+      }
+      google::FlushLogFiles(google::GLOG_INFO);
+    }
+    return;
+  }
   VLOG(log_level) << str;
   flush_log(log_level);
 }
@@ -45,6 +45,22 @@ void init_logging(const char* app_name, uint32_t default_verbosity);
 void log_string(int32_t log_level, const char* str);
 void flush_log(int32_t log_level);
 
+/*
+ * Start the asynchronous sink: log_string enqueues records into a
+ * lock-free bounded ring drained by a writer thread, and flush_log
+ * becomes a no-op (the writer flushes after every drained batch), so a
+ * slow disk stalls the writer instead of the calling task. When the
+ * ring is full records are dropped and counted; the writer reports the
+ * drop count once the disk catches up. Records at emergency, alert or
+ * critical level drain the ring synchronously before returning since
+ * the process is likely about to abort. record_count is rounded up to
+ * a power of two.
+ */
+void start_async_log_sink(uint32_t record_count);
+
+/* Drain whatever is queued, flush, and join the writer thread. */
+void stop_async_log_sink(void);
+
 #ifdef __cplusplus
 };
 #endif
@@ -40,6 +40,15 @@
 
 #include "intertask_interface_types.h"
 
+/* Frees the allocations a message carries internally, called once per
+ * message on the receive path. Dispatches through a per-message-type
+ * destructor table; messages without internal allocations (NULL slot) cost a
+ * single load + branch.
+ */
+typedef void (*itti_msg_destructor_t)(MessageDef* const message_p);
+
+void itti_free_msg_content_init(void);
+
 void itti_free_msg_content(MessageDef* const message_p);
 
 #endif /* FILE_ITTI_FREE_DEFINED_MSG_SEEN */
@@ -75,6 +75,8 @@
 
 #define LOG_CONNECT_PERIOD_MSEC 2000
 #define LOG_FLUSH_PERIOD_MSEC 50
+// Ring slots in the async glog sink; a full ring drops records
+#define LOG_ASYNC_SINK_RECORDS 8192
 
 #define LOG_DISPLAYED_FILENAME_MAX_LENGTH 32
 #define LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH 5
@@ -90,6 +92,8 @@
 
 #define LOG_MAGMA_REPO_ROOT "/oai/"
 #define MAX_TIME_STR_LEN 32
+#define LOG_DEFERRED_HEADER_MAX_LENGTH 224
+#define LOG_SITE_SAMPLING_ENV "MAGMA_LOG_SITE_SAMPLING"
 //-------------------------------
 
 typedef unsigned long log_message_number_t;
@@ -274,6 +278,10 @@ static bool log_is_enabled(
   return true;
 }
 
+// Per-thread cache of the thread context, set once on the first log line of a
+// thread so later lines skip the thread safe hashtable lookup
+static __thread log_thread_ctxt_t* t_log_thread_ctxt = NULL;
+
 //------------------------------------------------------------------------------
 // Get the associated thread context for the current thread allocating if
 // required
@@ -281,6 +289,10 @@ static void get_thread_context(log_thread_ctxt_t** thread_ctxt) {
   hashtable_rc_t hash_rc = HASH_TABLE_OK;
 
   if (NULL == *thread_ctxt) {
+    if (t_log_thread_ctxt) {
+      *thread_ctxt = t_log_thread_ctxt;
+      return;
+    }
     pthread_t p = pthread_self();
     hash_rc     = hashtable_ts_get(
         g_oai_log.thread_context_htbl, (hash_key_t) p, (void**) thread_ctxt);
@@ -293,6 +305,7 @@ static void get_thread_context(log_thread_ctxt_t** thread_ctxt) {
           HASH_TABLE_KEY_NOT_EXISTS != hash_rc,
           "Could not get new log thread context\n");
     }
+    t_log_thread_ctxt = *thread_ctxt;
   }
 }
 
@@ -575,6 +588,76 @@ static void log_get_readable_cur_time(time_t* cur_time, char* time_str) {
       (const struct tm*) cur_local_time);
 }
 
+//------------------------------------------------------------------------------
+// Capture the context of a log line on the emitting thread without formatting
+// it. The header is rendered by log_format_deferred_header() on the shared
+// logging drain thread, so with async output enabled producer threads only pay
+// for formatting the message body.
+static void log_capture_ctx_info(
+    shared_log_queue_item_t* item_p, const log_level_t log_levelP,
+    const log_proto_t protoP, const unsigned int line_numP,
+    const log_thread_ctxt_t* thread_ctxt, const char* short_source_fileP) {
+  clock_gettime(CLOCK_REALTIME, &item_p->log_meta.timestamp);
+  item_p->log_meta.tid               = thread_ctxt->tid;
+  item_p->log_meta.log_level         = log_levelP;
+  item_p->log_meta.proto             = protoP;
+  item_p->log_meta.short_source_file = short_source_fileP;
+  item_p->log_meta.line_num          = line_numP;
+  item_p->log_meta.prefix_id         = 0;
+  item_p->log_meta.has_prefix_id     = false;
+  item_p->log_meta.indent            = thread_ctxt->indent;
+  item_p->log_meta.valid             = true;
+}
+
+//------------------------------------------------------------------------------
+// Render the header of a deferred log line on the drain thread. The timestamp
+// captured at emission is printed with nanosecond resolution.
+static void log_format_deferred_header(
+    const shared_log_line_meta_t* meta, char* buf, const size_t buf_len) {
+  char date_str[MAX_TIME_STR_LEN];
+  char time_str[MAX_TIME_STR_LEN + 16];
+  struct tm cur_local_time;
+  size_t offset = 0;
+
+  localtime_r(&meta->timestamp.tv_sec, &cur_local_time);
+  strftime(date_str, sizeof(date_str), "%a %b %d %H:%M:%S", &cur_local_time);
+  snprintf(
+      time_str, sizeof(time_str), "%s.%09ld %04d", date_str,
+      meta->timestamp.tv_nsec, cur_local_time.tm_year + 1900);
+
+  if (g_oai_log.is_ansi_codes) {
+    offset += snprintf(
+        buf + offset, buf_len - offset, "%s",
+        &g_oai_log.log_level2ansi[meta->log_level][0]);
+  }
+  if (meta->has_prefix_id) {
+    snprintf(
+        buf + offset, buf_len - offset, LOG_CTXT_INFO_ID_FMT,
+        __sync_fetch_and_add(&g_oai_log.log_message_number, 1), time_str,
+        meta->tid, LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH,
+        LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH,
+        &g_oai_log.log_level2str[meta->log_level][0],
+        LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH,
+        LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH,
+        &g_oai_log.log_proto2str[meta->proto][0],
+        LOG_DISPLAYED_FILENAME_MAX_LENGTH, LOG_DISPLAYED_FILENAME_MAX_LENGTH,
+        meta->short_source_file, meta->line_num, meta->prefix_id, meta->indent,
+        " ");
+  } else {
+    snprintf(
+        buf + offset, buf_len - offset, LOG_CTXT_INFO_FMT,
+        __sync_fetch_and_add(&g_oai_log.log_message_number, 1), time_str,
+        meta->tid, LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH,
+        LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH,
+        &g_oai_log.log_level2str[meta->log_level][0],
+        LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH,
+        LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH,
+        &g_oai_log.log_proto2str[meta->proto][0],
+        LOG_DISPLAYED_FILENAME_MAX_LENGTH, LOG_DISPLAYED_FILENAME_MAX_LENGTH,
+        meta->short_source_file, meta->line_num, meta->indent, " ");
+  }
+}
+
 //------------------------------------------------------------------------------
 const char* log_level_int2str(const log_level_t log_level) {
   if ((MAX_LOG_LEVEL > log_level) && (MIN_LOG_LEVEL <= log_level)) {
@@ -598,12 +681,86 @@ log_level_t log_level_str2int(const char* const log_level_str) {
   // By default
   return MAX_LOG_LEVEL;  // == invalid
 }
+//------------------------------------------------------------------------------
+// Bounds of the registry of OAILOG_* call sites, provided by the linker for
+// the oai_log_sites section. Weak so that binaries linking this file without
+// any registered call site still resolve.
+extern log_site_t __start_oai_log_sites[] __attribute__((weak));
+extern log_site_t __stop_oai_log_sites[] __attribute__((weak));
+
+//------------------------------------------------------------------------------
+int log_site_set_sample_rate(
+    const char* file_match, uint32_t line, uint32_t sample_rate) {
+  int matched      = 0;
+  log_site_t* site = __start_oai_log_sites;
+
+  if (NULL == site) {
+    return 0;
+  }
+  for (; site < __stop_oai_log_sites; site++) {
+    if ((file_match) && (file_match[0]) && !strstr(site->file, file_match)) {
+      continue;
+    }
+    if ((line) && (line != site->line)) {
+      continue;
+    }
+    site->sample_rate = sample_rate;
+    matched++;
+  }
+  return matched;
+}
+
+//------------------------------------------------------------------------------
+// Apply per call site sample rates from MAGMA_LOG_SITE_SAMPLING, a comma
+// separated list of <file substring>[:<line>]=<rate> entries, e.g.
+// "nas_message.c=16,emm_sap.c:122=0". A rate of 0 drops the site, a rate of
+// N keeps one line in N.
+static void log_site_registry_apply_env(void) {
+  const char* env = getenv(LOG_SITE_SAMPLING_ENV);
+  char* entries   = NULL;
+  char* saveptr   = NULL;
+  char* entry     = NULL;
+
+  if ((NULL == env) || ('\0' == env[0])) {
+    return;
+  }
+  entries = strdup(env);
+  if (NULL == entries) {
+    return;
+  }
+  for (entry = strtok_r(entries, ",", &saveptr); entry;
+       entry = strtok_r(NULL, ",", &saveptr)) {
+    char* equal = strchr(entry, '=');
+    if (NULL == equal) {
+      OAI_FPRINTF_ERR(
+          "Ignoring malformed " LOG_SITE_SAMPLING_ENV " entry %s\n", entry);
+      continue;
+    }
+    *equal        = '\0';
+    uint32_t rate = (uint32_t) atoi(equal + 1);
+    uint32_t line = 0;
+    char* colon   = strrchr(entry, ':');
+    if (colon) {
+      *colon = '\0';
+      line   = (uint32_t) atoi(colon + 1);
+    }
+    int matched = log_site_set_sample_rate(entry, line, rate);
+    OAI_FPRINTF_INFO(
+        "Log site sampling: %d site(s) of %s set to rate 1/%u\n", matched,
+        entry, rate);
+  }
+  free(entries);
+}
+
 //------------------------------------------------------------------------------
 int log_init(
     const char* app_name, const log_level_t default_log_levelP,
     const int max_threadsP) {
   // init glog logging
   init_logging(app_name, default_log_levelP);
+  // Decouple the tasks from disk latency: records go through a bounded
+  // ring drained by a writer thread instead of a flush per record
+  start_async_log_sink(LOG_ASYNC_SINK_RECORDS);
 
   int i                     = 0;
   struct timeval start_time = {.tv_sec = 0, .tv_usec = 0};
@@ -766,6 +923,9 @@ int log_init(
   // lot before we actually set the log config, so treat syslog as default for
   // now.
   init_syslog();
+
+  log_site_registry_apply_env();
+
   log_message(
       NULL, OAILOG_LEVEL_INFO, LOG_UTIL, __FILE__, __LINE__,
       "Initializing OAI logging Done\n");
@@ -783,12 +943,23 @@ void log_itti_connect(void) {
 }
 //------------------------------------------------------------------------------
 void log_flush_message(struct shared_log_queue_item_s* item_p) {
-  int rv     = 0;
-  int rv_put = 0;
+  int rv                                      = 0;
+  int rv_put                                  = 0;
+  char header[LOG_DEFERRED_HEADER_MAX_LENGTH] = {0};
+
+  if (item_p->log_meta.valid) {
+    // the emitting thread only captured the line context, format the header
+    // here on the drain thread
+    log_format_deferred_header(&item_p->log_meta, header, sizeof(header));
+    item_p->log_meta.valid = false;
+  }
 
   if (blength(item_p->bstr) > 0) {
     if (g_oai_log.is_output_is_fd) {
       if (g_oai_log.log_fd) {
+        if (header[0]) {
+          fputs(header, g_oai_log.log_fd);
+        }
         rv_put = fputs((const char*) item_p->bstr->data, g_oai_log.log_fd);
         if (rv_put < 0) {
           // error occured
@@ -808,7 +979,7 @@ void log_flush_message(struct shared_log_queue_item_s* item_p) {
         fflush(g_oai_log.log_fd);
       }
     } else {
-      syslog(item_p->log.log_level, "%s", bdata(item_p->bstr));
+      syslog(item_p->log.log_level, "%s%s", header, bdata(item_p->bstr));
     }
   }
 }
@@ -840,6 +1011,7 @@ static void log_exit(void) {
   hashtable_ts_destroy(g_oai_log.thread_context_htbl);
   bdestroy_wrapper(&g_oai_log.bserver_address);
   bdestroy_wrapper(&g_oai_log.bserver_port);
+  stop_async_log_sink();
   OAI_FPRINTF_INFO("[TRACE] Leaving %s\n", __FUNCTION__);
 
   OAI_FPRINTF_INFO("TASK_LOG terminated\n");
@@ -1113,7 +1285,6 @@ void log_message_start_async(
   int rv                         = 0;
   int filename_length            = 0;
   log_thread_ctxt_t* thread_ctxt = thread_ctxtP;
-  hashtable_rc_t hash_rc         = HASH_TABLE_OK;
 
   if ((MIN_LOG_PROTOS > protoP) || (MAX_LOG_PROTOS <= protoP)) {
     return;
@@ -1125,74 +1296,29 @@ void log_message_start_async(
     return;
   }
 
-  if (NULL == thread_ctxt) {
-    pthread_t p = pthread_self();
-    hash_rc     = hashtable_ts_get(
-        g_oai_log.thread_context_htbl, (hash_key_t) p, (void**) &thread_ctxt);
-    if (HASH_TABLE_KEY_NOT_EXISTS == hash_rc) {
-      // make the thread safe LFDS collections usable by this thread
-      LOG_START_USE();
-      hash_rc = hashtable_ts_get(
-          g_oai_log.thread_context_htbl, (hash_key_t) p, (void**) &thread_ctxt);
-      AssertFatal(
-          NULL != thread_ctxt, "Could not get new log thread context\n");
-    }
-  }
+  get_thread_context(&thread_ctxt);
 
   if (!*messageP) {
     *messageP = get_new_log_queue_item(SH_TS_LOG_TXT);
   }
 
   if (*messageP) {
-    struct timeval elapsed_time;
     (*messageP)->log.log_level = log_levelP;
-    shared_log_get_elapsed_time_since_start(&elapsed_time);
 
     // get the short file name to use for printing in log
     const char* const short_source_fileP = get_short_file_name(source_fileP);
 
+    // defer the header formatting to the shared logging drain thread
     filename_length = strlen(short_source_fileP);
-    if (g_oai_log.is_ansi_codes) {
-      rv = bformata(
-          (*messageP)->bstr, "%s", &g_oai_log.log_level2ansi[log_levelP][0]);
-    }
     if (filename_length > LOG_DISPLAYED_FILENAME_MAX_LENGTH) {
-      rv = bformata(
-          (*messageP)->bstr,
-          "%06" PRIu64 " %05ld:%06ld %08lX %-*.*s %-*.*s %-*.*s:%04u   %*s",
-          __sync_fetch_and_add(&g_oai_log.log_message_number, 1),
-          elapsed_time.tv_sec, elapsed_time.tv_usec, thread_ctxt->tid,
-          LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH,
-          LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH,
-          &g_oai_log.log_level2str[log_levelP][0],
-          LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH,
-          LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH,
-          &g_oai_log.log_proto2str[protoP][0],
-          LOG_DISPLAYED_FILENAME_MAX_LENGTH, LOG_DISPLAYED_FILENAME_MAX_LENGTH,
+      log_capture_ctx_info(
+          *messageP, log_levelP, protoP, line_numP, thread_ctxt,
           &short_source_fileP
-              [filename_length - LOG_DISPLAYED_FILENAME_MAX_LENGTH],
-          line_numP, thread_ctxt->indent, " ");
+              [filename_length - LOG_DISPLAYED_FILENAME_MAX_LENGTH]);
     } else {
-      rv = bformata(
-          (*messageP)->bstr,
-          "%06" PRIu64 " %05ld:%06ld %08lX %-*.*s %-*.*s %-*.*s:%04u   %*s",
-          __sync_fetch_and_add(&g_oai_log.log_message_number, 1),
-          elapsed_time.tv_sec, elapsed_time.tv_usec, thread_ctxt->tid,
-          LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH,
-          LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH,
-          &g_oai_log.log_level2str[log_levelP][0],
-          LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH,
-          LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH,
-          &g_oai_log.log_proto2str[protoP][0],
-          LOG_DISPLAYED_FILENAME_MAX_LENGTH, LOG_DISPLAYED_FILENAME_MAX_LENGTH,
-          short_source_fileP, line_numP, thread_ctxt->indent, " ");
-    }
-
-    if (BSTR_ERR == rv) {
-      OAI_FPRINTF_ERR(
-          "Error while logging message : %s",
-          &g_oai_log.log_proto2str[protoP][0]);
-      goto error_event_start;
+      log_capture_ctx_info(
+          *messageP, log_levelP, protoP, line_numP, thread_ctxt,
+          short_source_fileP);
     }
 
     va_start(args, format);
@@ -1395,15 +1521,10 @@ void log_message_int(
     }
   } else {
     async_context_p = (shared_log_queue_item_t**) contextP;
-    rv              = append_log_ctx_info(
-        (*async_context_p)->bstr, &log_levelP, &protoP, line_numP,
-        filename_length, thread_ctxt, &cur_time, short_source_fileP);
-    if (BSTR_ERR == rv) {
-      OAI_FPRINTF_ERR(
-          "Error while logging LOG message : %s",
-          &g_oai_log.log_proto2str[protoP][0]);
-      goto error_event;
-    }
+    // defer the header formatting to the shared logging drain thread
+    log_capture_ctx_info(
+        *async_context_p, log_levelP, protoP, line_numP, thread_ctxt,
+        &short_source_fileP[filename_length]);
     rv =
         bvcformata((*async_context_p)->bstr, 4096, format, args);  // big number
     (*async_context_p)->log.log_level = g_oai_log.log_level2syslog[log_levelP];
@@ -1473,15 +1594,12 @@ void log_message_int_prefix_id(
     }
   } else {
     async_context_p = (shared_log_queue_item_t**) contextP;
-    rv              = append_log_ctx_info_prefix_id(
-        prefix_id, (*async_context_p)->bstr, &log_levelP, &protoP, line_numP,
-        filename_length, thread_ctxt, &cur_time, short_source_fileP);
-    if (BSTR_ERR == rv) {
-      OAI_FPRINTF_ERR(
-          "Error while logging LOG message : %s",
-          &g_oai_log.log_proto2str[protoP][0]);
-      goto error_event;
-    }
+    // defer the header formatting to the shared logging drain thread
+    log_capture_ctx_info(
+        *async_context_p, log_levelP, protoP, line_numP, thread_ctxt,
+        &short_source_fileP[filename_length]);
+    (*async_context_p)->log_meta.prefix_id     = prefix_id;
+    (*async_context_p)->log_meta.has_prefix_id = true;
     rv =
         bvcformata((*async_context_p)->bstr, 4096, format, args);  // big number
     (*async_context_p)->log.log_level = g_oai_log.log_level2syslog[log_levelP];
@@ -51,6 +51,7 @@ extern int fd_g_debug_lvl;
 #include <stdint.h>
 #include <stdbool.h>
 #include <pthread.h>
+#include <time.h>
 
 #include "bstrlib.h"
 #include "glogwrapper/glog_logging.h"
@@ -208,6 +209,26 @@ typedef struct log_private_s {
   int32_t log_level; /*!< \brief log level. */
 } log_private_t;
 
+/*! \struct  shared_log_line_meta_t
+ * \brief Context of a log line captured on the emitting thread.
+ * When valid is set, the line header (message number, timestamp, level,
+ * protocol, source location) is formatted from these fields on the shared
+ * logging drain thread instead of on the emitting thread, so producers only
+ * pay for formatting the message body.
+ */
+typedef struct shared_log_line_meta_s {
+  bool valid; /*!< \brief fields below are set, header not yet formatted. */
+  struct timespec timestamp;     /*!< \brief CLOCK_REALTIME at emission. */
+  pthread_t tid;                 /*!< \brief emitting thread. */
+  log_level_t log_level;         /*!< \brief log level of the line. */
+  log_proto_t proto;             /*!< \brief protocol/task of the line. */
+  const char* short_source_file; /*!< \brief points into a __FILE__ literal. */
+  unsigned int line_num;         /*!< \brief source line number. */
+  uint64_t prefix_id;            /*!< \brief optional line prefix identifier. */
+  bool has_prefix_id;            /*!< \brief prefix_id is meaningful. */
+  int indent;                    /*!< \brief function call depth indent. */
+} shared_log_line_meta_t;
+
 /*! \struct  log_config_t
  * \brief Structure containing the dynamically configurable parameters of the
  * Logging facilities. This structure is filled by configuration facilities when
@@ -295,6 +316,52 @@ inline void nopp(void* x, ...) {
     nopp(__VA_ARGS__);                                                         \
   } while (0)
 
+/*! \struct  log_site_t
+ * \brief Descriptor of one OAILOG_* call site. Each expansion of a leveled
+ * OAILOG_* macro emits one instance into the dedicated "oai_log_sites" linker
+ * section, giving every call site a stable compile time identity (file, line)
+ * that can be enumerated at runtime. sample_rate is adjustable per site while
+ * the process runs: 0 drops the site entirely, 1 (the default) logs every
+ * line, N logs one line in N. This allows keeping a hot site like NAS decode
+ * at DEBUG level with 1/N sampling instead of toggling the whole module.
+ */
+typedef struct log_site_s {
+  const char* file;     /*!< \brief __FILE__ of the call site. */
+  uint32_t line;        /*!< \brief __LINE__ of the call site. */
+  uint32_t sample_rate; /*!< \brief 0 = off, 1 = all lines, N = 1 in N. */
+  uint32_t counter;     /*!< \brief lines considered while sampling. */
+} log_site_t;
+
+/*
+ * Emit the site descriptor of one OAILOG_* expansion. The "used" attribute
+ * keeps unreferenced descriptors alive so the registry walk sees all sites.
+ */
+#define OAILOG_SITE_DECL(nAmE)                                                 \
+  static log_site_t nAmE __attribute__((used, section("oai_log_sites"))) = {   \
+      __FILE__, __LINE__, 1, 0}
+
+//------------------------------------------------------------------------------
+// Sampling decision for one call site, default configuration costs one load
+static inline bool log_site_sampled(log_site_t* site) {
+  uint32_t sample_rate = site->sample_rate;
+  if (1 == sample_rate) {
+    return true;
+  }
+  if (0 == sample_rate) {
+    return false;
+  }
+  return 0 == (__sync_fetch_and_add(&site->counter, 1) % sample_rate);
+}
+
+/*
+ * Set the sample rate of all registered call sites matching file_match (a
+ * substring of the __FILE__ of the site, an empty string matches all files)
+ * and line (0 matches all lines of the file). Returns the number of call
+ * sites updated. Safe to call at any time from any thread.
+ */
+int log_site_set_sample_rate(
+    const char* file_match, uint32_t line, uint32_t sample_rate);
+
 void log_configure(const log_config_t* const config);
 const char* log_level_int2str(const log_level_t log_level);
 log_level_t log_level_str2int(const char* const log_level_str);
@@ -393,43 +460,59 @@ char* bytes_to_hex(char* byte_array, int length, char* hex_array);
 #define OAILOG_ITTI_CONNECT log_itti_connect
 #define OAILOG_SPEC(pRoTo, ...)                                                \
   do {                                                                         \
+    OAILOG_SITE_DECL(_oai_log_site);                                           \
+    if (!log_site_sampled(&_oai_log_site)) break;                              \
     log_message(                                                               \
         NULL, OAILOG_LEVEL_NOTICE, pRoTo, __FILE__, __LINE__, ##__VA_ARGS__);  \
   } while (0) /*!< \brief 3GPP trace on specifications */
 #define OAILOG_EMERGENCY(pRoTo, ...)                                           \
   do {                                                                         \
+    OAILOG_SITE_DECL(_oai_log_site);                                           \
+    if (!log_site_sampled(&_oai_log_site)) break;                              \
     log_message(                                                               \
         NULL, OAILOG_LEVEL_EMERGENCY, pRoTo, __FILE__, __LINE__,               \
         ##__VA_ARGS__);                                                        \
   } while (0) /*!< \brief system is unusable */
 #define OAILOG_ALERT(pRoTo, ...)                                               \
   do {                                                                         \
+    OAILOG_SITE_DECL(_oai_log_site);                                           \
+    if (!log_site_sampled(&_oai_log_site)) break;                              \
     log_message(                                                               \
         NULL, OAILOG_LEVEL_ALERT, pRoTo, __FILE__, __LINE__, ##__VA_ARGS__);   \
   } while (0) /*!< \brief action must be taken immediately */
 #define OAILOG_CRITICAL(pRoTo, ...)                                            \
   do {                                                                         \
+    OAILOG_SITE_DECL(_oai_log_site);                                           \
+    if (!log_site_sampled(&_oai_log_site)) break;                              \
     log_message(                                                               \
         NULL, OAILOG_LEVEL_CRITICAL, pRoTo, __FILE__, __LINE__,                \
         ##__VA_ARGS__);                                                        \
   } while (0) /*!< \brief critical conditions */
 #define OAILOG_ERROR(pRoTo, ...)                                               \
   do {                                                                         \
+    OAILOG_SITE_DECL(_oai_log_site);                                           \
+    if (!log_site_sampled(&_oai_log_site)) break;                              \
     log_message(                                                               \
         NULL, OAILOG_LEVEL_ERROR, pRoTo, __FILE__, __LINE__, ##__VA_ARGS__);   \
   } while (0) /*!< \brief error conditions */
 #define OAILOG_WARNING(pRoTo, ...)                                             \
   do {                                                                         \
+    OAILOG_SITE_DECL(_oai_log_site);                                           \
+    if (!log_site_sampled(&_oai_log_site)) break;                              \
     log_message(                                                               \
         NULL, OAILOG_LEVEL_WARNING, pRoTo, __FILE__, __LINE__, ##__VA_ARGS__); \
   } while (0) /*!< \brief warning conditions */
 #define OAILOG_NOTICE(pRoTo, ...)                                              \
   do {                                                                         \
+    OAILOG_SITE_DECL(_oai_log_site);                                           \
+    if (!log_site_sampled(&_oai_log_site)) break;                              \
     log_message(                                                               \
         NULL, OAILOG_LEVEL_NOTICE, pRoTo, __FILE__, __LINE__, ##__VA_ARGS__);  \
   } while (0) /*!< \brief normal but significant condition */
 #define OAILOG_INFO(pRoTo, ...)                                                \
   do {                                                                         \
+    OAILOG_SITE_DECL(_oai_log_site);                                           \
+    if (!log_site_sampled(&_oai_log_site)) break;                              \
     log_message(                                                               \
         NULL, OAILOG_LEVEL_INFO, pRoTo, __FILE__, __LINE__, ##__VA_ARGS__);    \
   } while (0) /*!< \brief informational */
@@ -470,26 +553,36 @@ char* bytes_to_hex(char* byte_array, int length, char* hex_array);
 #if DEBUG_IS_ON
 #define OAILOG_DEBUG(pRoTo, ...)                                               \
   do {                                                                         \
+    OAILOG_SITE_DECL(_oai_log_site);                                           \
+    if (!log_site_sampled(&_oai_log_site)) break;                              \
     log_message(                                                               \
         NULL, OAILOG_LEVEL_DEBUG, pRoTo, __FILE__, __LINE__, ##__VA_ARGS__);   \
   } while (0) /*!< \brief debug informations */
 #define OAILOG_DEBUG_UE(pRoTo, ue_id, ...)                                     \
   do {                                                                         \
+    OAILOG_SITE_DECL(_oai_log_site);                                           \
+    if (!log_site_sampled(&_oai_log_site)) break;                              \
     log_message_prefix_id(                                                     \
         OAILOG_LEVEL_DEBUG, pRoTo, __FILE__, __LINE__, ue_id, ##__VA_ARGS__);  \
   } while (0) /*!< \brief debug informations */
 #if TRACE_IS_ON
 #define OAILOG_EXTERNAL(lOgLeVeL, pRoTo, ...)                                  \
   do {                                                                         \
+    OAILOG_SITE_DECL(_oai_log_site);                                           \
+    if (!log_site_sampled(&_oai_log_site)) break;                              \
     log_message(NULL, lOgLeVeL, pRoTo, __FILE__, __LINE__, ##__VA_ARGS__);     \
   } while (0)
 #define OAILOG_TRACE(pRoTo, ...)                                               \
   do {                                                                         \
+    OAILOG_SITE_DECL(_oai_log_site);                                           \
+    if (!log_site_sampled(&_oai_log_site)) break;                              \
     log_message(                                                               \
         NULL, OAILOG_LEVEL_TRACE, pRoTo, __FILE__, __LINE__, ##__VA_ARGS__);   \
   } while (0) /*!< \brief most detailed information, struct dumps */
 #define OAILOG_TRACE_UE(pRoTo, ue_id, ...)                                     \
   do {                                                                         \
+    OAILOG_SITE_DECL(_oai_log_site);                                           \
+    if (!log_site_sampled(&_oai_log_site)) break;                              \
     log_message_prefix_id(                                                     \
         OAILOG_LEVEL_TRACE, pRoTo, __FILE__, __LINE__, ue_id, ##__VA_ARGS__);  \
   } while (0) /*!< \brief most detailed information, struct dumps */
@@ -570,33 +663,45 @@ char* bytes_to_hex(char* byte_array, int length, char* hex_array);
 
 #define OAILOG_ALERT_UE(pRoTo, ue_id, ...)                                     \
   do {                                                                         \
+    OAILOG_SITE_DECL(_oai_log_site);                                           \
+    if (!log_site_sampled(&_oai_log_site)) break;                              \
     log_message_prefix_id(                                                     \
         OAILOG_LEVEL_ALERT, pRoTo, __FILE__, __LINE__, ue_id, ##__VA_ARGS__);  \
   } while (0) /*!< \brief action must be taken immediately */
 #define OAILOG_CRITICAL_UE(pRoTo, ue_id, ...)                                  \
   do {                                                                         \
+    OAILOG_SITE_DECL(_oai_log_site);                                           \
+    if (!log_site_sampled(&_oai_log_site)) break;                              \
     log_message_prefix_id(                                                     \
         OAILOG_LEVEL_CRITICAL, pRoTo, __FILE__, __LINE__, ue_id,               \
         ##__VA_ARGS__);                                                        \
   } while (0) /*!< \brief critical conditions */
 #define OAILOG_ERROR_UE(pRoTo, ue_id, ...)                                     \
   do {                                                                         \
+    OAILOG_SITE_DECL(_oai_log_site);                                           \
+    if (!log_site_sampled(&_oai_log_site)) break;                              \
     log_message_prefix_id(                                                     \
         OAILOG_LEVEL_ERROR, pRoTo, __FILE__, __LINE__, ue_id, ##__VA_ARGS__);  \
   } while (0) /*!< \brief error conditions */
 #define OAILOG_WARNING_UE(pRoTo, ue_id, ...)                                   \
   do {                                                                         \
+    OAILOG_SITE_DECL(_oai_log_site);                                           \
+    if (!log_site_sampled(&_oai_log_site)) break;                              \
     log_message_prefix_id(                                                     \
         OAILOG_LEVEL_WARNING, pRoTo, __FILE__, __LINE__, ue_id,                \
         ##__VA_ARGS__);                                                        \
   } while (0) /*!< \brief warning conditions */
 #define OAILOG_NOTICE_UE(pRoTo, ue_id, ...)                                    \
   do {                                                                         \
+    OAILOG_SITE_DECL(_oai_log_site);                                           \
+    if (!log_site_sampled(&_oai_log_site)) break;                              \
     log_message_prefix_id(                                                     \
         OAILOG_LEVEL_NOTICE, pRoTo, __FILE__, __LINE__, ue_id, ##__VA_ARGS__); \
   } while (0) /*!< \brief normal but significant condition */
 #define OAILOG_INFO_UE(pRoTo, ue_id, ...)                                      \
   do {                                                                         \
+    OAILOG_SITE_DECL(_oai_log_site);                                           \
+    if (!log_site_sampled(&_oai_log_site)) break;                              \
     log_message_prefix_id(                                                     \
         OAILOG_LEVEL_INFO, pRoTo, __FILE__, __LINE__, ue_id, ##__VA_ARGS__);   \
   } while (0) /*!< \brief informational */
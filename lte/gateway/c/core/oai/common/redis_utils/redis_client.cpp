@@ -27,30 +27,65 @@ extern "C" {
 }
 #endif
 
+#include <cstring>
+#include <mutex>
+
+#include <zlib.h>
+
 #include "includes/ServiceConfigLoader.h"
 #include <yaml-cpp/yaml.h>  // IWYU pragma: keep
 
 using google::protobuf::Message;
 
+namespace {
+// Compressed payloads carry a magic prefix followed by the original size,
+// so the read side can tell them apart from raw serialized protos and size
+// the inflate buffer up front
+constexpr char COMPRESSED_MAGIC[]      = "MZC1";
+constexpr size_t COMPRESSED_MAGIC_LEN  = 4;
+constexpr size_t COMPRESSED_HEADER_LEN =
+    COMPRESSED_MAGIC_LEN + sizeof(uint32_t);
+}  // namespace
+
 namespace magma {
 namespace lte {
 
-RedisClient::RedisClient(bool init_connection)
-    : db_client_(std::make_unique<cpp_redis::client>()), is_connected_(false) {
+RedisClient::RedisClient(bool init_connection, bool use_shared_connection)
+    : db_client_(
+          use_shared_connection ? shared_db_client() :
+                                  std::make_shared<cpp_redis::client>()),
+      is_connected_(false) {
   if (init_connection) {
     init_db_connection();
   }
 }
 
-void RedisClient::init_db_connection() {
-  magma::ServiceConfigLoader loader;
-
-  auto config = loader.load_service_config("redis");
-  auto addr   = config["bind"].as<std::string>();
-  auto port   = config["port"].as<uint32_t>();
+std::shared_ptr<cpp_redis::client> RedisClient::shared_db_client() {
+  static auto shared_client = std::make_shared<cpp_redis::client>();
+  return shared_client;
+}
 
-  // Make connection to db
-  db_client_->connect(addr, port, nullptr);
+void RedisClient::init_db_connection() {
+  static std::mutex connect_mutex;
+  std::lock_guard<std::mutex> lock(connect_mutex);
+
+  // Multiplexing clients share one connection; only the first caller
+  // actually connects
+  if (!db_client_->is_connected()) {
+    magma::ServiceConfigLoader loader;
+
+    auto config = loader.load_service_config("redis");
+    if (config["unix_socket_path"].IsDefined()) {
+      // tacopie treats a host starting with '/' as a unix domain socket,
+      // which skips the TCP stack for the local redis instance
+      auto path = config["unix_socket_path"].as<std::string>();
+      db_client_->connect(path, 0, nullptr);
+    } else {
+      auto addr = config["bind"].as<std::string>();
+      auto port = config["port"].as<uint32_t>();
+      db_client_->connect(addr, port, nullptr);
+    }
+  }
 
   is_connected_ = true;
 }
@@ -104,6 +139,78 @@ status_code_e RedisClient::write_proto_str(
   return RETURNok;
 }
 
+status_code_e RedisClient::write_compressed_proto_str(
+    const std::string& key, const std::string& proto_msg, uint64_t version) {
+  std::string compressed;
+  if ((compress_str(proto_msg, compressed) != RETURNok) ||
+      (compressed.size() >= proto_msg.size())) {
+    // Compression failed or did not shrink the payload; store it raw
+    return write_proto_str(key, proto_msg, version);
+  }
+  return write_proto_str(key, compressed, version);
+}
+
+status_code_e RedisClient::write_async(
+    const std::string& key, const std::string& value) {
+  if (!is_connected()) {
+    return RETURNerror;
+  }
+
+  pending_replies_.push_back(db_client_->set(key, value));
+  return RETURNok;
+}
+
+status_code_e RedisClient::write_proto_str_async(
+    const std::string& key, const std::string& proto_msg, uint64_t version) {
+  orc8r::RedisState wrapper_proto = orc8r::RedisState();
+  wrapper_proto.set_serialized_msg(proto_msg);
+  wrapper_proto.set_version(version);
+
+  std::string str_value;
+  if (serialize(wrapper_proto, str_value) != RETURNok) {
+    return RETURNerror;
+  }
+  return write_async(key, str_value);
+}
+
+status_code_e RedisClient::write_compressed_proto_str_async(
+    const std::string& key, const std::string& proto_msg, uint64_t version) {
+  std::string compressed;
+  if ((compress_str(proto_msg, compressed) != RETURNok) ||
+      (compressed.size() >= proto_msg.size())) {
+    // Compression failed or did not shrink the payload; store it raw
+    return write_proto_str_async(key, proto_msg, version);
+  }
+  return write_proto_str_async(key, compressed, version);
+}
+
+status_code_e RedisClient::clear_keys_async(
+    const std::vector<std::string>& keys_to_clear) {
+  if (!is_connected()) {
+    return RETURNerror;
+  }
+
+  pending_replies_.push_back(db_client_->del(keys_to_clear));
+  return RETURNok;
+}
+
+status_code_e RedisClient::commit_pending() {
+  if (pending_replies_.empty()) {
+    return RETURNok;
+  }
+
+  db_client_->sync_commit();
+
+  status_code_e rc = RETURNok;
+  for (auto& reply_future : pending_replies_) {
+    if (reply_future.get().is_error()) {
+      rc = RETURNerror;
+    }
+  }
+  pending_replies_.clear();
+  return rc;
+}
+
 status_code_e RedisClient::read_proto(
     const std::string& key, Message& proto_msg) {
   orc8r::RedisState wrapper_proto = orc8r::RedisState();
@@ -112,6 +219,13 @@ status_code_e RedisClient::read_proto(
   }
 
   std::string wrapped_val = wrapper_proto.serialized_msg();
+  if (is_compressed_payload(wrapped_val)) {
+    std::string inflated;
+    if (decompress_str(wrapped_val, inflated) != RETURNok) {
+      return RETURNerror;
+    }
+    wrapped_val = inflated;
+  }
   if (deserialize(proto_msg, wrapped_val) != RETURNok) {
     return RETURNerror;
   }
@@ -200,5 +314,51 @@ status_code_e RedisClient::deserialize(
   return RETURNok;
 }
 
+status_code_e RedisClient::compress_str(
+    const std::string& raw, std::string& compressed_out) {
+  uLongf compressed_len = compressBound(raw.size());
+  uint32_t raw_size     = raw.size();
+
+  compressed_out.assign(COMPRESSED_HEADER_LEN + compressed_len, '\0');
+  memcpy(&compressed_out[0], COMPRESSED_MAGIC, COMPRESSED_MAGIC_LEN);
+  memcpy(&compressed_out[COMPRESSED_MAGIC_LEN], &raw_size, sizeof(raw_size));
+  // Best-speed deflate: the point is shrinking redis traffic, not archival
+  if (compress2(
+          reinterpret_cast<Bytef*>(&compressed_out[COMPRESSED_HEADER_LEN]),
+          &compressed_len, reinterpret_cast<const Bytef*>(raw.data()),
+          raw.size(), Z_BEST_SPEED) != Z_OK) {
+    return RETURNerror;
+  }
+  compressed_out.resize(COMPRESSED_HEADER_LEN + compressed_len);
+  return RETURNok;
+}
+
+status_code_e RedisClient::decompress_str(
+    const std::string& compressed, std::string& raw_out) {
+  uint32_t raw_size = 0;
+
+  if (compressed.size() <= COMPRESSED_HEADER_LEN) {
+    return RETURNerror;
+  }
+  memcpy(
+      &raw_size, compressed.data() + COMPRESSED_MAGIC_LEN, sizeof(raw_size));
+  raw_out.assign(raw_size, '\0');
+  uLongf raw_len = raw_size;
+  if ((uncompress(
+           reinterpret_cast<Bytef*>(&raw_out[0]), &raw_len,
+           reinterpret_cast<const Bytef*>(
+               compressed.data() + COMPRESSED_HEADER_LEN),
+           compressed.size() - COMPRESSED_HEADER_LEN) != Z_OK) ||
+      (raw_len != raw_size)) {
+    return RETURNerror;
+  }
+  return RETURNok;
+}
+
+bool RedisClient::is_compressed_payload(const std::string& payload) {
+  return (payload.size() > COMPRESSED_HEADER_LEN) &&
+         (memcmp(payload.data(), COMPRESSED_MAGIC, COMPRESSED_MAGIC_LEN) == 0);
+}
+
 }  // namespace lte
 }  // namespace magma
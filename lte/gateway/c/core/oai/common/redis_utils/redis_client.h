@@ -17,7 +17,10 @@
 
 #pragma once
 
+#include <future>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <cpp_redis/cpp_redis>
 #include <google/protobuf/message.h>
@@ -30,11 +33,19 @@ namespace lte {
 
 class RedisClient {
  public:
-  explicit RedisClient(bool init_connection);
+  /**
+   * @param init_connection connect to the datastore on construction
+   * @param use_shared_connection multiplex commands over the process-wide
+   * connection (the default); pass false for a writer whose bulk pipelines
+   * must never stall other clients' commits
+   */
+  explicit RedisClient(
+      bool init_connection, bool use_shared_connection = true);
   ~RedisClient() = default;
 
   /**
-   * Initializes a connection to the redis datastore configured in redis.yml
+   * Initializes a connection to the redis datastore configured in redis.yml,
+   * over a unix domain socket when the config carries unix_socket_path
    * @return response code of success / error with db connection
    */
   void init_db_connection();
@@ -64,6 +75,61 @@ class RedisClient {
   status_code_e write_proto_str(
       const std::string& key, const std::string& proto_msg, uint64_t version);
 
+  /**
+   * Writes a protobuf object to redis with the serialized payload
+   * deflate-compressed; read_proto inflates such payloads transparently.
+   * Falls back to the raw payload when compression does not shrink it.
+   * @param key
+   * @param proto_msg
+   * @param version
+   * @return response code of operation
+   */
+  status_code_e write_compressed_proto_str(
+      const std::string& key, const std::string& proto_msg, uint64_t version);
+
+  /**
+   * Queues a write without committing it; commit_pending() flushes every
+   * queued command on one round trip
+   * @param key
+   * @param value
+   * @return response code of operation
+   */
+  status_code_e write_async(const std::string& key, const std::string& value);
+
+  /**
+   * Queued counterpart of write_proto_str
+   * @param key
+   * @param proto_msg
+   * @param version
+   * @return response code of operation
+   */
+  status_code_e write_proto_str_async(
+      const std::string& key, const std::string& proto_msg, uint64_t version);
+
+  /**
+   * Queued counterpart of write_compressed_proto_str
+   * @param key
+   * @param proto_msg
+   * @param version
+   * @return response code of operation
+   */
+  status_code_e write_compressed_proto_str_async(
+      const std::string& key, const std::string& proto_msg, uint64_t version);
+
+  /**
+   * Queued counterpart of clear_keys
+   * @param keys_to_clear
+   * @return response code of operation
+   */
+  status_code_e clear_keys_async(
+      const std::vector<std::string>& keys_to_clear);
+
+  /**
+   * Commits every queued command as one pipeline and checks all replies
+   * @return RETURNerror if any queued command failed
+   */
+  status_code_e commit_pending();
+
   /**
    * Converts protobuf Message and parses it to string
    * @param proto_msg
@@ -91,8 +157,13 @@ class RedisClient {
   bool is_connected() const { return is_connected_; }
 
  private:
-  std::unique_ptr<cpp_redis::client> db_client_;
+  std::shared_ptr<cpp_redis::client> db_client_;
   bool is_connected_;
+  // Replies of commands queued through the *_async methods
+  std::vector<std::future<cpp_redis::reply>> pending_replies_;
+
+  // The process-wide connection shared by the multiplexing clients
+  static std::shared_ptr<cpp_redis::client> shared_db_client();
 
   /**
    * Read the wrapper RedisState value from Redis for a key
@@ -112,6 +183,27 @@ class RedisClient {
   static status_code_e deserialize(
       google::protobuf::Message& proto_msg,
       const std::string& str_to_deserialize);
+
+  /**
+   * Deflates a serialized payload and prepends the compression header
+   * @param raw
+   * @param compressed_out
+   * @return response code of operation
+   */
+  static status_code_e compress_str(
+      const std::string& raw, std::string& compressed_out);
+
+  /**
+   * Inflates a payload produced by compress_str
+   * @param compressed
+   * @param raw_out
+   * @return response code of operation
+   */
+  static status_code_e decompress_str(
+      const std::string& compressed, std::string& raw_out);
+
+  // True when the payload carries the compression header
+  static bool is_compressed_payload(const std::string& payload);
 };
 
 }  // namespace lte
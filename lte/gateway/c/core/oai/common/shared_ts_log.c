@@ -141,7 +141,8 @@ shared_log_queue_item_t* get_new_log_queue_item(sh_ts_log_app_id_t app_id) {
       item_p = create_new_log_queue_item(app_id);
       AssertFatal(item_p, "Out of memory error");
     } else {
-      item_p->app_id = app_id;
+      item_p->app_id         = app_id;
+      item_p->log_meta.valid = false;
 #if defined(SHARED_LOG_PREALLOC_STRING_BUFFERS)
       btrunc(item_p->bstr, 0);
 #endif
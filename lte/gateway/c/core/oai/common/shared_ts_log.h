@@ -63,6 +63,7 @@ typedef struct shared_log_queue_item_s {
   sh_ts_log_app_id_t app_id; /*!< \brief application identifier. */
   bstring bstr;              /*!< \brief string containing the message. */
   log_private_t log;         /*!< \brief string containing the message. */
+  shared_log_line_meta_t log_meta; /*!< \brief deferred line header context. */
 } shared_log_queue_item_t;
 
 /*! \struct  log_config_t
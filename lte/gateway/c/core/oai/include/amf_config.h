@@ -14,6 +14,7 @@
 #pragma once
 
 #include <pthread.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <arpa/inet.h>
 #include <stdlib.h>
@@ -106,10 +107,22 @@ typedef struct guamfi_config_s {
 #define amf_config_read_lock(aMFcONFIG)                                        \
   pthread_rwlock_rdlock(&(aMFcONFIG)->rw_lock)
 #define amf_config_write_lock(aMFcONFIG)                                       \
-  pthread_rwlock_wrlock(&(aMFcONFIG)->rw_lock)
+  do {                                                                         \
+    pthread_rwlock_wrlock(&(aMFcONFIG)->rw_lock);                              \
+    __atomic_add_fetch(&(aMFcONFIG)->config_seq, 1, __ATOMIC_SEQ_CST);         \
+  } while (0)
 #define amf_config_unlock(aMFcONFIG)                                           \
   pthread_rwlock_unlock(&(aMFcONFIG)->rw_lock)
 
+/* Writers pair amf_config_write_lock with amf_config_write_unlock so that
+   the sequence counter brackets their updates; amf_config_unlock remains
+   for readers still on the rwlock */
+#define amf_config_write_unlock(aMFcONFIG)                                     \
+  do {                                                                         \
+    __atomic_add_fetch(&(aMFcONFIG)->config_seq, 1, __ATOMIC_SEQ_CST);         \
+    pthread_rwlock_unlock(&(aMFcONFIG)->rw_lock);                              \
+  } while (0)
+
   uint64_t imsi64_t;         /*holds the IMSI value*/
   uint32_t amf_ue_ngap_id_t; /*uniquely identifies the UE over the NG
                                         interface within the AMF*/
@@ -119,6 +132,12 @@ typedef struct amf_config_s {
   /* Reader/writer lock for this configuration */
   pthread_rwlock_t rw_lock;
 
+  /* Sequence counter for lock-free readers: even while the configuration is
+     stable, odd while a writer holds the write lock. Hot paths read the
+     configuration between amf_config_read_begin and amf_config_read_retry
+     instead of taking the rwlock */
+  uint64_t config_seq;
+
   bstring config_file;
   bstring pid_dir;
   bstring realm;
@@ -141,6 +160,25 @@ typedef struct amf_config_s {
   bool use_stateless;
 } amf_config_t;
 
+/* Open a lock-free read of the configuration: returns once no writer is in
+   progress. Validate the read with amf_config_read_retry and redo it when
+   that returns true. Readers never block writers and pay two atomic loads
+   per validated read instead of an rwlock acquire/release */
+static inline uint64_t amf_config_read_begin(const struct amf_config_s* cfg) {
+  uint64_t seq;
+
+  do {
+    seq = __atomic_load_n(&cfg->config_seq, __ATOMIC_ACQUIRE);
+  } while (seq & 1);
+  return seq;
+}
+
+static inline bool amf_config_read_retry(
+    const struct amf_config_s* cfg, uint64_t seq) {
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  return __atomic_load_n(&cfg->config_seq, __ATOMIC_RELAXED) != seq;
+}
+
 int amf_app_init(amf_config_t*);
 
 extern amf_config_t amf_config; /*global*/
@@ -48,3 +48,6 @@ MESSAGE_DEF(
 MESSAGE_DEF(
     IP_ALLOCATION_RESPONSE, itti_ip_allocation_response_t,
     ip_allocation_response)
+MESSAGE_DEF(
+    UPF_CLASSIFIER_RESPONSE, itti_upf_classifier_response_t,
+    upf_classifier_response)
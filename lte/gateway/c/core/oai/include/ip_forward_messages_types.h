@@ -30,6 +30,8 @@
 #ifndef FILE_SGI_FORWARD_MESSAGES_TYPES_SEEN
 #define FILE_SGI_FORWARD_MESSAGES_TYPES_SEEN
 
+#include <netinet/in.h>
+
 #include "common_types.h"
 #include "3gpp_24.007.h"
 #include "3gpp_24.008.h"
@@ -120,4 +122,18 @@ typedef struct itti_ip_allocation_response_s {
   paa_t paa;            ///< PDN Address Allocation
 } itti_ip_allocation_response_t;
 
+//-----------------------------------------------------------------------------
+/**
+ * Completion of an asynchronous UE session set call toward pipelined, sent
+ * from GRPC task to SPGW so dataplane programming failures are surfaced on
+ * the task that owns the bearer state instead of dying in the gRPC callback.
+ */
+typedef struct itti_upf_classifier_response_s {
+  SGIStatus_t status;       ///< SGI_STATUS_OK if the dataplane accepted
+  uint32_t operation_type;  ///< UESessionState operation echoed by pipelined
+  uint32_t cause_ie;        ///< CauseIE value from the response
+  struct in_addr ue_ipv4;   ///< UE IPv4 address of the affected session
+  struct in6_addr ue_ipv6;  ///< UE IPv6 address of the affected session
+} itti_upf_classifier_response_t;
+
 #endif /* FILE_SGI_FORWARD_MESSAGES_TYPES_SEEN */
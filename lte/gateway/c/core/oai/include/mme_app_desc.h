@@ -45,4 +45,9 @@ typedef struct mme_app_desc_s {
   uint32_t nb_ue_managed;
   uint32_t nb_ue_idle;
   uint32_t nb_bearers_managed;
+
+  /* Monotonic count of statistics updates since task start; combined with the
+   * hashtable mutation counters it tells the state manager whether anything
+   * changed since the last sync. In-memory only, never persisted. */
+  uint64_t state_version;
 } mme_app_desc_t;
@@ -51,6 +51,13 @@ void put_mme_nas_state(void);
  */
 void clear_mme_nas_state(void);
 
+/**
+ * Restore the UE context holding this mme_ue_s1ap_id from the data store
+ * if a stateless restart left it pending hydration; no-op once the
+ * background hydration sweep has finished.
+ */
+void mme_app_hydrate_ue_state_by_ue_id(mme_ue_s1ap_id_t mme_ue_s1ap_id);
+
 // Returns UE MME state hashtable, indexed by IMSI
 hash_table_ts_t* get_mme_ue_state(void);
 // Persists UE MME state for subscriber into db
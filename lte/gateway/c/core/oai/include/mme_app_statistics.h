@@ -18,6 +18,8 @@
 #ifndef FILE_MME_APP_STATISTICS_SEEN
 #define FILE_MME_APP_STATISTICS_SEEN
 
+#include "service303_messages_types.h"
+
 /*********************************** Utility Functions to update
  * Statistics**************************************/
 void update_mme_app_stats_connected_ue_add(void);
@@ -29,4 +31,8 @@ void update_mme_app_stats_default_bearer_sub(void);
 void update_mme_app_stats_attached_ue_add(void);
 void update_mme_app_stats_attached_ue_sub(void);
 
+// Consistent-enough snapshot of the counters for the periodic display and
+// service303 export; reads are atomic, no context walk is involved
+void mme_app_fill_stats_msg(application_mme_app_stats_msg_t* stats_msg);
+
 #endif /* FILE_MME_APP_STATISTICS_SEEN */
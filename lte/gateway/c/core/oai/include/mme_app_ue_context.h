@@ -327,31 +327,18 @@ typedef struct sgs_context_s {
   bool is_emergency_call;
 } sgs_context_t;
 
-/** @struct ue_mm_context_t
- *  @brief Useful parameters to know in MME application layer. They are set
- * according to 3GPP TS.23.401 #5.7.2
+/** @struct ue_subscription_t
+ *  @brief HSS subscription profile of the UE, set by S6A UPDATE LOCATION
+ * ANSWER and rarely read afterwards. Allocated separately from
+ * ue_mm_context_t and owned by it, so that UE context lookups and walks do
+ * not pull these cold bytes through the cache hierarchy
  */
-typedef struct ue_mm_context_s {
+typedef struct ue_subscription_s {
   /* msisdn: The basic MSISDN of the UE. The presence is dictated by its storage
    *         in the HSS, set by S6A UPDATE LOCATION ANSWER
    */
   bstring msisdn;
 
-  enum s1cause ue_context_rel_cause;
-  mm_state_t mm_state;
-  ecm_state_t ecm_state;
-
-  /* Last known E-UTRAN cell, set by nas_attach_req_t */
-  ecgi_t e_utran_cgi;
-
-  /* cell_age: Time elapsed since the last E-UTRAN Cell Global Identity was
-   *           acquired. Set by nas_auth_param_req_t
-   */
-  time_t cell_age;
-  /* TODO: add csg_id */
-  /* TODO: add csg_membership */
-  /* TODO Access mode: Access mode of last known ECGI when the UE was active */
-
   /* apn_config_profile: set by S6A UPDATE LOCATION ANSWER */
   apn_config_profile_t apn_config_profile;
 
@@ -370,6 +357,36 @@ typedef struct ue_mm_context_s {
    *           subscriber's profile. See TS 23.003 [9] clause 9.1.2 for more
    */
   bstring apn_oi_replacement;
+
+  /* Subscribed UE-AMBR: The Maximum Aggregated uplink and downlink MBR values
+   *           to be shared across all Non-GBR bearers according to the
+   *           subscription of the user. Set by S6A UPDATE LOCATION ANSWER
+   */
+  ambr_t subscribed_ue_ambr;
+
+  /* rau_tau_timer: Indicates a subscribed Periodic RAU/TAU Timer value
+   *           Set by S6A UPDATE LOCATION ANSWER
+   */
+  rau_tau_timer_t rau_tau_timer;
+
+  subscriber_status_t subscriber_status;
+  network_access_mode_t network_access_mode;
+  uint8_t num_reg_sub;
+  regional_subscription_t reg_sub[MAX_REGIONAL_SUB];
+} ue_subscription_t;
+
+/** @struct ue_mm_context_t
+ *  @brief Useful parameters to know in MME application layer. They are set
+ * according to 3GPP TS.23.401 #5.7.2
+ *  The leading fields are the hot ones touched by the lookup and state
+ * machine paths; subscription data lives behind the cold subscription
+ * pointer
+ */
+typedef struct ue_mm_context_s {
+  enum s1cause ue_context_rel_cause;
+  mm_state_t mm_state;
+  ecm_state_t ecm_state;
+
   teid_t mme_teid_s11;
   /* SCTP assoc id */
   sctp_assoc_id_t sctp_assoc_id_key;
@@ -382,20 +399,27 @@ typedef struct ue_mm_context_s {
   /* MME UE S1AP ID, Unique identity the UE within MME */
   mme_ue_s1ap_id_t mme_ue_s1ap_id;
 
-  /* Subscribed UE-AMBR: The Maximum Aggregated uplink and downlink MBR values
-   *           to be shared across all Non-GBR bearers according to the
-   *           subscription of the user. Set by S6A UPDATE LOCATION ANSWER
+  /* Last known E-UTRAN cell, set by nas_attach_req_t */
+  ecgi_t e_utran_cgi;
+
+  /* cell_age: Time elapsed since the last E-UTRAN Cell Global Identity was
+   *           acquired. Set by nas_auth_param_req_t
    */
-  ambr_t subscribed_ue_ambr;
+  time_t cell_age;
+  /* TODO: add csg_id */
+  /* TODO: add csg_membership */
+  /* TODO Access mode: Access mode of last known ECGI when the UE was active */
+
+  /* subscription: The HSS subscription profile, allocated together with the
+   *           UE context, filled by S6A UPDATE LOCATION ANSWER
+   */
+  ue_subscription_t* subscription;
+
   /* used_ue_ambr: The currently used Maximum Aggregated uplink and downlink
    *           MBR values to be shared across all Non-GBR bearers.
    *           Set by S6A UPDATE LOCATION ANSWER
    */
   ambr_t used_ue_ambr;
-  /* rau_tau_timer: Indicates a subscribed Periodic RAU/TAU Timer value
-   *           Set by S6A UPDATE LOCATION ANSWER
-   */
-  rau_tau_timer_t rau_tau_timer;
 
   int nb_active_pdn_contexts;
   pdn_context_t* pdn_contexts[MAX_APN_PER_UE];
@@ -454,10 +478,6 @@ typedef struct ue_mm_context_s {
 #define SUBSCRIPTION_KNOWN true
   bool subscription_known;
   ambr_t used_ambr;
-  subscriber_status_t subscriber_status;
-  network_access_mode_t network_access_mode;
-  uint8_t num_reg_sub;
-  regional_subscription_t reg_sub[MAX_REGIONAL_SUB];
 
   bool path_switch_req;
   bool erab_mod_ind;
@@ -550,6 +570,19 @@ void mme_ue_context_update_coll_keys(
     const mme_ue_s1ap_id_t mme_ue_s1ap_id, imsi64_t imsi,
     const s11_teid_t mme_s11_teid, const guti_t* const guti_p);
 
+/** \brief Re-key only the eNB-side lookup of an UE context after handover.
+ * Every other collection key (IMSI, S11 TEID, GUTI, mme_ue_s1ap_id) is
+ * unchanged by an intra-MME handover, so this avoids the full coll-keys
+ * rebuild on that latency-sensitive path.
+ * \param mme_ue_context_p The MME context
+ * \param ue_context_p The UE context
+ * \param enb_s1ap_id_key The new eNB UE id identifier
+ **/
+void mme_ue_context_update_enb_key_on_handover(
+    mme_ue_context_t* const mme_ue_context_p,
+    ue_mm_context_t* const ue_context_p,
+    const enb_s1ap_id_key_t enb_s1ap_id_key);
+
 /** \brief dump MME associative collections
  **/
 
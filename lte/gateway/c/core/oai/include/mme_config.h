@@ -38,6 +38,7 @@
 #define FILE_MME_CONFIG_SEEN
 
 #include <pthread.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <arpa/inet.h>
 #include <stdlib.h>
@@ -79,6 +80,7 @@
 #define MME_CONFIG_STRING_STATS_TIMER "STATS_TIMER_SEC"
 
 #define MME_CONFIG_STRING_USE_STATELESS "USE_STATELESS"
+#define MME_CONFIG_STRING_USE_HUGEPAGE_ARENA "USE_HUGEPAGE_ARENA"
 #define MME_CONFIG_STRING_ENABLE_CONVERGED_CORE "ENABLE_CONVERGED_CORE"
 #define MME_CONFIG_STRING_FULL_NETWORK_NAME "FULL_NETWORK_NAME"
 #define MME_CONFIG_STRING_SHORT_NETWORK_NAME "SHORT_NETWORK_NAME"
@@ -102,6 +104,10 @@
 
 #define MME_CONFIG_STRING_INTERTASK_INTERFACE_CONFIG "INTERTASK_INTERFACE"
 #define MME_CONFIG_STRING_INTERTASK_INTERFACE_QUEUE_SIZE "ITTI_QUEUE_SIZE"
+#define MME_CONFIG_STRING_ITTI_TASK_PLACEMENT "TASK_PLACEMENT"
+#define MME_CONFIG_STRING_ITTI_TASK_NAME "TASK_NAME"
+#define MME_CONFIG_STRING_ITTI_TASK_CORE "CORE"
+#define MME_CONFIG_STRING_ITTI_TASK_SCHED_FIFO_PRIORITY "SCHED_FIFO_PRIORITY"
 
 #define MME_CONFIG_STRING_S6A_CONFIG "S6A"
 #define MME_CONFIG_STRING_S6A_CONF_FILE_PATH "S6A_CONF"
@@ -270,9 +276,19 @@ typedef struct s6a_config_s {
   bstring hss_realm;
 } s6a_config_t;
 
+#define ITTI_TASK_PLACEMENT_MAX 16
+
+typedef struct itti_task_placement_s {
+  bstring task_name;    // registered task name, e.g. "TASK_S1AP"
+  int core;             // CPU to pin the task thread to, -1 leaves it free
+  int sched_fifo_prio;  // SCHED_FIFO priority, 0 keeps the default class
+} itti_task_placement_t;
+
 typedef struct itti_config_s {
   uint32_t queue_size;
   bstring log_file;
+  int nb_task_placements;
+  itti_task_placement_t task_placements[ITTI_TASK_PLACEMENT_MAX];
 } itti_config_t;
 
 typedef struct apn_map_s {
@@ -361,6 +377,12 @@ typedef struct mme_config_s {
   /* Reader/writer lock for this configuration */
   pthread_rwlock_t rw_lock;
 
+  /* Sequence counter for lock-free readers: even while the configuration is
+     stable, odd while a writer holds the write lock. Hot paths read the
+     configuration between mme_config_read_begin and mme_config_read_retry
+     instead of taking the rwlock */
+  uint64_t config_seq;
+
   bstring config_file;
   bstring pid_dir;
   bstring realm;
@@ -408,6 +430,7 @@ typedef struct mme_config_s {
   lai_t lai;
   fed_mode_map_config_t mode_map_config;
   bool use_stateless;
+  bool use_hugepage_arena;
   bool use_ha;
   bool enable_gtpu_private_ip_correction;
   bool enable_converged_core;
@@ -436,8 +459,39 @@ void mme_config_exit(void);
 #define mme_config_read_lock(mMEcONFIG)                                        \
   pthread_rwlock_rdlock(&(mMEcONFIG)->rw_lock)
 #define mme_config_write_lock(mMEcONFIG)                                       \
-  pthread_rwlock_wrlock(&(mMEcONFIG)->rw_lock)
+  do {                                                                         \
+    pthread_rwlock_wrlock(&(mMEcONFIG)->rw_lock);                              \
+    __atomic_add_fetch(&(mMEcONFIG)->config_seq, 1, __ATOMIC_SEQ_CST);         \
+  } while (0)
 #define mme_config_unlock(mMEcONFIG)                                           \
   pthread_rwlock_unlock(&(mMEcONFIG)->rw_lock)
 
+/* Writers pair mme_config_write_lock with mme_config_write_unlock so that
+   the sequence counter brackets their updates; mme_config_unlock remains
+   for readers still on the rwlock */
+#define mme_config_write_unlock(mMEcONFIG)                                     \
+  do {                                                                         \
+    __atomic_add_fetch(&(mMEcONFIG)->config_seq, 1, __ATOMIC_SEQ_CST);         \
+    pthread_rwlock_unlock(&(mMEcONFIG)->rw_lock);                              \
+  } while (0)
+
+/* Open a lock-free read of the configuration: returns once no writer is in
+   progress. Validate the read with mme_config_read_retry and redo it when
+   that returns true. Readers never block writers and pay two atomic loads
+   per validated read instead of an rwlock acquire/release */
+static inline uint64_t mme_config_read_begin(const struct mme_config_s* cfg) {
+  uint64_t seq;
+
+  do {
+    seq = __atomic_load_n(&cfg->config_seq, __ATOMIC_ACQUIRE);
+  } while (seq & 1);
+  return seq;
+}
+
+static inline bool mme_config_read_retry(
+    const struct mme_config_s* cfg, uint64_t seq) {
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  return __atomic_load_n(&cfg->config_seq, __ATOMIC_RELAXED) != seq;
+}
+
 #endif /* FILE_MME_CONFIG_SEEN */
@@ -0,0 +1,57 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+/*! \file mme_tai_table.h
+ * \brief Read-optimized lookup tables over the served TAI list
+ *
+ * The served PLMN/TAC checks run for every NAS message and for many S1AP
+ * messages, but the configured list is stored as parallel arrays that were
+ * scanned linearly per check. This module derives collision-free hash
+ * tables from the served TAI list whenever the configuration changes, so a
+ * membership check is a couple of loads: a 1024-bit bitmap rejects foreign
+ * PLMNs on the first load, and the hash seed is chosen at build time to
+ * place the configured entries in distinct slots, so the confirming probe
+ * does not chain. Lookups validate against a sequence counter in the same
+ * way lock-free mme_config reads do, so they never take a lock.
+ */
+
+#ifndef FILE_MME_TAI_TABLE_SEEN
+#define FILE_MME_TAI_TABLE_SEEN
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "mme_config.h"
+
+/*
+ * Rebuild the lookup tables from the given served TAI list. Called after
+ * configuration parsing and again by any future configuration writer;
+ * concurrent lookups retry across the rebuild.
+ */
+void mme_tai_table_rebuild(const served_tai_t* served_tai);
+
+/* @return true when the PLMN is one of the served PLMNs */
+bool mme_tai_table_plmn_served(
+    uint16_t mcc, uint16_t mnc, uint16_t mnc_len);
+
+/* @return true when the TAC is served under any configured PLMN */
+bool mme_tai_table_tac_served(uint16_t tac);
+
+/* @return true when the exact PLMN+TAC pair is in the served TAI list */
+bool mme_tai_table_tai_served(
+    uint16_t mcc, uint16_t mnc, uint16_t mnc_len, uint16_t tac);
+
+#endif /* FILE_MME_TAI_TABLE_SEEN */
@@ -67,6 +67,9 @@ MESSAGE_DEF(
     s1ap_enb_initiated_reset_ack)
 MESSAGE_DEF(
     S1AP_PAGING_REQUEST, itti_s1ap_paging_request_t, s1ap_paging_request)
+MESSAGE_DEF(
+    S1AP_PAGING_REQUEST_BATCH, itti_s1ap_paging_request_batch_t,
+    s1ap_paging_request_batch)
 MESSAGE_DEF(
     S1AP_UE_CONTEXT_MODIFICATION_REQUEST, itti_s1ap_ue_context_mod_req_t,
     s1ap_ue_context_mod_request)
@@ -37,6 +37,7 @@
 #ifndef FILE_S1AP_MESSAGES_TYPES_SEEN
 #define FILE_S1AP_MESSAGES_TYPES_SEEN
 
+#include "common_types.h"
 #include "3gpp_24.008.h"
 #include "3gpp_36.401.h"
 #include "3gpp_36.413.h"
@@ -76,6 +77,8 @@
   (mSGpTR)->ittiMsg.s1ap_initial_ue_message
 #define S1AP_NAS_DL_DATA_REQ(mSGpTR) (mSGpTR)->ittiMsg.s1ap_nas_dl_data_req
 #define S1AP_PAGING_REQUEST(mSGpTR) (mSGpTR)->ittiMsg.s1ap_paging_request
+#define S1AP_PAGING_REQUEST_BATCH(mSGpTR)                                      \
+  (mSGpTR)->ittiMsg.s1ap_paging_request_batch
 #define S1AP_E_RAB_REL_CMD(mSGpTR) (mSGpTR)->ittiMsg.s1ap_e_rab_rel_cmd
 #define S1AP_E_RAB_REL_RSP(mSGpTR) (mSGpTR)->ittiMsg.s1ap_e_rab_rel_rsp
 #define S1AP_PATH_SWITCH_REQUEST(mSGpTR)                                       \
@@ -257,8 +260,18 @@ typedef struct itti_s1ap_paging_request_s {
   s1ap_cn_domain_t domain_indicator;
   uint8_t tai_list_count;
   paging_tai_list_t paging_tai_list[TRACKING_AREA_IDENTITY_MAX_NUM_OF_TAIS];
+  /* Per-UE IMSI, needed for batched paging where the ITTI message header
+   * cannot carry one IMSI per entry */
+  imsi64_t imsi64;
 } itti_s1ap_paging_request_t;
 
+/* Batch of paging requests flushed from mme_app once per aggregation tick;
+ * the array is allocated by mme_app and freed by the s1ap handler */
+typedef struct itti_s1ap_paging_request_batch_s {
+  uint16_t count;
+  itti_s1ap_paging_request_t* paging_requests;
+} itti_s1ap_paging_request_batch_t;
+
 typedef struct itti_s1ap_initial_ue_message_s {
   sctp_assoc_id_t sctp_assoc_id;  // key stored in MME_APP for MME_APP forward
                                   // NAS response to S1AP
@@ -24,6 +24,7 @@
 
 #include "common_types.h"
 #include "hashtable.h"
+#include "hashtable_oa_uint64.h"
 
 // Forward declarations
 struct enb_description_s;
@@ -40,7 +41,8 @@ typedef struct s1ap_state_s {
 } s1ap_state_t;
 
 typedef struct s1ap_imsi_map_s {
-  hash_table_uint64_ts_t* mme_ue_id_imsi_htbl;
+  // open-addressing table: read lock-free on every uplink NAS message
+  hash_table_oa_uint64_ts_t* mme_ue_id_imsi_htbl;
 } s1ap_imsi_map_t;
 
 enum s1_timer_class_s {
@@ -31,6 +31,8 @@
 void service303_mme_app_statistics_read(
     application_mme_app_stats_msg_t* stats_msg_p);
 void service303_s1ap_statistics_read(application_s1ap_stats_msg_t* stats_msg_p);
+// Exports allocator gauges; no-op unless built with USE_JEMALLOC
+void service303_allocator_statistics_read(void);
 void service303_statistics_display(void);
 
 // service303 conf type added to be able to use same task interface for MME and
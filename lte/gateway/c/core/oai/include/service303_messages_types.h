@@ -39,6 +39,10 @@ typedef struct application_mme_app_stats_msg {
   uint32_t nb_ue_connected;
   uint32_t nb_default_eps_bearers;
   uint32_t nb_s1u_bearers;
+  // Occupancy of the UE context hashtable, see hashtable_ts_get_stats()
+  uint32_t nb_ue_context_htbl_buckets;
+  uint32_t nb_ue_context_htbl_elements;
+  uint32_t ue_context_htbl_max_chain;
 } application_mme_app_stats_msg_t;
 
 typedef struct application_s1ap_stats_msg {
@@ -16,7 +16,19 @@
  */
 
 /*
- * Sends a SGS_DOWNLINK_UNITDATA message to NAS for SMS Orc8r service.
+ * Sends a SGS_DOWNLINK_UNITDATA message to NAS for SMS Orc8r service, or
+ * queues it behind an in-flight delivery towards the same UE.
  */
 int handle_sms_orc8r_downlink_unitdata(
     const itti_sgsap_downlink_unitdata_t* sgs_dl_unitdata_p);
+
+/*
+ * Called when an uplink unitdata from the UE shows a live NAS connection;
+ * piggybacks the next queued MT SMS for that UE on it.
+ */
+void sms_orc8r_notify_ue_activity(const char* imsi, uint8_t imsi_length);
+
+/*
+ * Periodic sweep releasing queued MT SMS for UEs whose acks never came back.
+ */
+void sms_orc8r_flush_stale_pending_sms(void);
@@ -65,6 +65,20 @@ void put_spgw_ue_state(imsi64_t imsi64);
  */
 void delete_spgw_ue_state(imsi64_t imsi64);
 
+/**
+ * Marks the bearer context for an S11 teid as modified so it is written
+ * on the next put_spgw_ue_state() call for its UE
+ * @param teid
+ */
+void mark_spgw_teid_state_dirty(teid_t teid);
+
+/**
+ * Removes the keyed db record of a bearer context
+ * @param imsi64
+ * @param teid
+ */
+void delete_spgw_teid_state(imsi64_t imsi64, teid_t teid);
+
 /**
  * Callback function for s11_bearer_context_information hashtable freefunc
  * @param context_p spgw eps bearer context entry on hashtable
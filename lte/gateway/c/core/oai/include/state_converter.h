@@ -27,6 +27,7 @@ extern "C" {
 #include "assertions.h"
 #include "common_types.h"
 #include "hashtable.h"
+#include "hashtable_oa_uint64.h"
 #include "log.h"
 
 #ifdef __cplusplus
@@ -138,6 +139,14 @@ class StateConverter {
       const google::protobuf::Map<unsigned long, unsigned long>& proto_map,
       hash_table_uint64_ts_t* state_htbl);
 
+  static void hashtable_oa_uint64_ts_to_proto(
+      hash_table_oa_uint64_ts_t* htbl,
+      google::protobuf::Map<unsigned long, unsigned long>* proto_map);
+
+  static void proto_to_hashtable_oa_uint64_ts(
+      const google::protobuf::Map<unsigned long, unsigned long>& proto_map,
+      hash_table_oa_uint64_ts_t* state_htbl);
+
   static void guti_to_proto(const guti_t& guti_state, oai::Guti* guti_proto);
 
   static void ecgi_to_proto(const ecgi_t& state_ecgi, oai::Ecgi* ecgi_proto);
@@ -250,7 +250,8 @@ class StateManager {
   // TODO: Make this a unique_ptr
   StateType* state_cache_p;
   hash_table_ts_t* state_ue_ht;
-  // TODO: Revisit one shared connection for all types of state
+  // Each manager keeps its own client, but they all multiplex commands over
+  // one shared connection to the datastore
   std::unique_ptr<RedisClient> redis_client;
   // Flag for check asserting if the state has been initialized.
   bool is_initialized;
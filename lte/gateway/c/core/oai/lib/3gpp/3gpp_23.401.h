@@ -105,6 +105,10 @@ typedef struct sgw_eps_bearer_ctxt_s {
   uint8_t num_sdf;
   uint32_t sdf_id[TRAFFIC_FLOW_TEMPLATE_NB_PACKET_FILTERS_MAX];
   char policy_rule_name[POLICY_RULE_NAME_MAXLEN + 1];
+
+  uint32_t bearer_slot;  ///< Slot + 1 in the sgw_s8 bearer table, 0 when the
+                         ///< bearer is not registered. Runtime only, not
+                         ///< persisted; used by the sgw_s8 task.
 } sgw_eps_bearer_ctxt_t;
 
 typedef struct sgw_pdn_connection_s {
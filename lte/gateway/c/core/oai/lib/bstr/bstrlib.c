@@ -106,6 +106,40 @@ static int snapUpSize(int i) {
   return i;
 }
 
+/*  Test whether the data buffer of b lives inline, directly behind its
+ *  header.  Inline data is not an allocation of its own and can be neither
+ *  realloc'ed nor freed; writers must spill to a heap block instead.
+ */
+static int bstr__data_is_inline(const_bstring b) {
+  return b->data == (unsigned char*) (b + 1);
+}
+
+/*  Allocate a string header together with a data buffer of at least mlen
+ *  bytes.  Small buffers are placed inline behind the header in a single
+ *  allocation, which halves the allocation count for the short strings
+ *  that dominate typical workloads.  Returns NULL on allocation failure.
+ */
+static bstring bstr__alloc_with_data(int mlen) {
+  bstring b;
+
+  if (mlen <= BSTR_SBO_CAPACITY) {
+    b = (bstring) bstr__alloc(
+        sizeof(struct tagbstring) + (size_t) BSTR_SBO_CAPACITY);
+    if (b == NULL) return NULL;
+    b->data = (unsigned char*) (b + 1);
+    b->mlen = BSTR_SBO_CAPACITY;
+    return b;
+  }
+  b = (bstring) bstr__alloc(sizeof(struct tagbstring));
+  if (b == NULL) return NULL;
+  b->data = (unsigned char*) bstr__alloc((size_t)(b->mlen = mlen));
+  if (b->data == NULL) {
+    bstr__free(b);
+    return NULL;
+  }
+  return b;
+}
+
 /*  int balloc (bstring b, int len)
  *
  *  Increase the size of the memory backing the bstring b to at least len.
@@ -122,8 +156,18 @@ int balloc(bstring b, int olen) {
 
     if ((len = snapUpSize(olen)) <= b->mlen) return BSTR_OK;
 
-    /* Assume probability of a non-moving realloc is 0.125 */
-    if (7 * b->mlen < 8 * b->slen) {
+    if (bstr__data_is_inline(b)) {
+      /* Inline data cannot be passed to realloc or free; copy it out into
+         a heap block of its own */
+      if (NULL == (x = (unsigned char*) bstr__alloc((size_t) len))) {
+        len = olen;
+        if (NULL == (x = (unsigned char*) bstr__alloc((size_t) len))) {
+          return BSTR_ERR;
+        }
+      }
+      if (b->slen) bstr__memcpy((char*) x, (char*) b->data, (size_t) b->slen);
+      /* Assume probability of a non-moving realloc is 0.125 */
+    } else if (7 * b->mlen < 8 * b->slen) {
       /* If slen is close to mlen in size then use realloc to reduce
                            the memory defragmentation */
 
@@ -188,8 +232,16 @@ int ballocmin(bstring b, int len) {
   if (len < b->slen + 1) len = b->slen + 1;
 
   if (len != b->mlen) {
-    s = (unsigned char*) bstr__realloc(b->data, (size_t) len);
-    if (NULL == s) return BSTR_ERR;
+    if (bstr__data_is_inline(b)) {
+      /* Inline storage cannot shrink; grow by spilling into a heap block */
+      if (len <= b->mlen) return BSTR_OK;
+      s = (unsigned char*) bstr__alloc((size_t) len);
+      if (NULL == s) return BSTR_ERR;
+      if (b->slen) bstr__memcpy((char*) s, (char*) b->data, (size_t) b->slen);
+    } else {
+      s = (unsigned char*) bstr__realloc(b->data, (size_t) len);
+      if (NULL == s) return BSTR_ERR;
+    }
     s[b->slen] = (unsigned char) '\0';
     b->data    = s;
     b->mlen    = len;
@@ -213,13 +265,9 @@ bstring bfromcstr(const char* str) {
   i = snapUpSize((int) (j + (2 - (j != 0))));
   if (i <= (int) j) return NULL;
 
-  b = (bstring) bstr__alloc(sizeof(struct tagbstring));
+  b = bstr__alloc_with_data(i);
   if (NULL == b) return NULL;
   b->slen = (int) j;
-  if (NULL == (b->data = (unsigned char*) bstr__alloc(b->mlen = i))) {
-    bstr__free(b);
-    return NULL;
-  }
 
   bstr__memcpy(b->data, str, j + 1);
   return b;
@@ -240,13 +288,9 @@ bstring bfromcstr_with_str_len(const char* str, int len) {
   i = snapUpSize((int) (j + (2 - (j != 0))));
   if (i <= (int) j) return NULL;
 
-  b = (bstring) bstr__alloc(sizeof(struct tagbstring));
+  b = bstr__alloc_with_data(i);
   if (NULL == b) return NULL;
   b->slen = j;
-  if (NULL == (b->data = (unsigned char*) bstr__alloc(b->mlen = i))) {
-    bstr__free(b);
-    return NULL;
-  }
   bstr__memcpy(b->data, str, j);
   b->data[j] = '\0';
   return b;
@@ -274,18 +318,12 @@ bstring bfromcstrrangealloc(int minl, int maxl, const char* str) {
   if (maxl < minl) maxl = minl;
   i = maxl;
 
-  b = (bstring) bstr__alloc(sizeof(struct tagbstring));
-  if (b == NULL) return NULL;
-  b->slen = (int) j;
-
-  while (NULL == (b->data = (unsigned char*) bstr__alloc(b->mlen = i))) {
+  while (NULL == (b = bstr__alloc_with_data(i))) {
     int k = (i >> 1) + (minl >> 1);
-    if (i == k || i < minl) {
-      bstr__free(b);
-      return NULL;
-    }
+    if (i == k || i < minl) return NULL;
     i = k;
   }
+  b->slen = (int) j;
 
   bstr__memcpy(b->data, str, j + 1);
   return b;
@@ -311,20 +349,13 @@ bstring blk2bstr(const void* blk, int len) {
   int i;
 
   if (blk == NULL || len < 0) return NULL;
-  b = (bstring) bstr__alloc(sizeof(struct tagbstring));
-  if (b == NULL) return NULL;
-  b->slen = len;
 
   i = len + (2 - (len != 0));
   i = snapUpSize(i);
 
-  b->mlen = i;
-
-  b->data = (unsigned char*) bstr__alloc((size_t) b->mlen);
-  if (b->data == NULL) {
-    bstr__free(b);
-    return NULL;
-  }
+  b = bstr__alloc_with_data(i);
+  if (b == NULL) return NULL;
+  b->slen = len;
 
   if (len > 0) bstr__memcpy(b->data, blk, (size_t) len);
   b->data[len] = (unsigned char) '\0';
@@ -483,27 +514,19 @@ bstring bstrcpy(const_bstring b) {
   /* Attempted to copy an invalid string? */
   if (b == NULL || b->slen < 0 || b->data == NULL) return NULL;
 
-  b0 = (bstring) bstr__alloc(sizeof(struct tagbstring));
-  if (b0 == NULL) {
-    /* Unable to allocate memory for string header */
-    return NULL;
-  }
-
   i = b->slen;
   j = snapUpSize(i + 1);
 
-  b0->data = (unsigned char*) bstr__alloc(j);
-  if (b0->data == NULL) {
-    j        = i + 1;
-    b0->data = (unsigned char*) bstr__alloc(j);
-    if (b0->data == NULL) {
-      /* Unable to allocate memory for string data */
-      bstr__free(b0);
+  b0 = bstr__alloc_with_data(j);
+  if (b0 == NULL) {
+    j  = i + 1;
+    b0 = bstr__alloc_with_data(j);
+    if (b0 == NULL) {
+      /* Unable to allocate memory for the copy */
       return NULL;
     }
   }
 
-  b0->mlen = j;
   b0->slen = i;
 
   if (i) bstr__memcpy((char*) b0->data, (char*) b->data, i);
@@ -1122,7 +1145,8 @@ int bdestroy(bstring b) {
       b->data == NULL)
     return BSTR_ERR;
 
-  bstr__free(b->data);
+  /* Inline data is part of the header allocation and is released with it */
+  if (!bstr__data_is_inline(b)) bstr__free(b->data);
 
   /* In case there is any stale usage, there is one more chance to
            notice this error. */
@@ -2446,29 +2470,24 @@ bstring bjoinblk(const struct bstrList* bl, const void* blk, int len) {
     c += v;
   }
 
-  b = (bstring) bstr__alloc(sizeof(struct tagbstring));
+  if (len > 0) {
+    v = (bl->qty - 1) * len;
+    if ((bl->qty > 512 || len > 127) && v / len != bl->qty - 1)
+      return NULL;                    /* Overflow */
+    if (v > INT_MAX - c) return NULL; /* Overflow */
+    c += v;
+  }
+
+  b = bstr__alloc_with_data(c);
+  if (b == NULL) return NULL;
+  p = b->data;
   if (len == 0) {
-    p = b->data = (unsigned char*) bstr__alloc(c);
-    if (p == NULL) {
-      bstr__free(b);
-      return NULL;
-    }
     for (i = 0; i < bl->qty; i++) {
       v = bl->entry[i]->slen;
       bstr__memcpy(p, bl->entry[i]->data, v);
       p += v;
     }
   } else {
-    v = (bl->qty - 1) * len;
-    if ((bl->qty > 512 || len > 127) && v / len != bl->qty - 1)
-      return NULL;                    /* Overflow */
-    if (v > INT_MAX - c) return NULL; /* Overflow */
-    c += v;
-    p = b->data = (unsigned char*) bstr__alloc(c);
-    if (p == NULL) {
-      bstr__free(b);
-      return NULL;
-    }
     v = bl->entry[0]->slen;
     bstr__memcpy(p, bl->entry[0]->data, v);
     p += v;
@@ -2482,7 +2501,7 @@ bstring bjoinblk(const struct bstrList* bl, const void* blk, int len) {
       }
     }
   }
-  b->mlen        = c;
+  /* mlen was set by bstr__alloc_with_data */
   b->slen        = c - 1;
   b->data[c - 1] = (unsigned char) '\0';
   return b;
@@ -209,6 +209,14 @@ struct tagbstring {
   unsigned char* data;
 };
 
+/* Strings whose snapped buffer size does not exceed this threshold keep
+   their data inline, directly behind the tagbstring header in the same
+   allocation.  The buffer spills into its own heap block when it grows
+   past the inline capacity.  Set to 0 to disable the small-buffer layout. */
+#ifndef BSTR_SBO_CAPACITY
+#define BSTR_SBO_CAPACITY (32)
+#endif
+
 /* Accessor macros */
 #define blengthe(b, e)                                                         \
   (((b) == (void*) 0 || (b)->slen < 0) ? (int) (e) : ((b)->slen))
@@ -17,8 +17,12 @@
 
 #include "EventClientAPI.h"
 
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
 #include <thread>
+#include <utility>
+#include <vector>
 #include <grpcpp/support/status.h>
 #include <orc8r/protos/common.pb.h>
 
@@ -34,13 +38,25 @@ using magma::orc8r::Void;
 namespace magma {
 namespace lte {
 
-void init_eventd_client() {
-  auto& client = AsyncEventdClient::getInstance();
-  std::thread resp_loop_thread([&]() { client.rpc_response_loop(); });
-  resp_loop_thread.detach();
-}
+namespace {
 
-int log_event(const Event& event) {
+// Upper bound on events staged for the flusher thread. Events are
+// best-effort telemetry, so beyond this the newest ones are dropped
+// rather than stalling the signaling path
+constexpr size_t MAX_STAGED_EVENTS = 1024;
+
+std::mutex staging_mutex;
+std::condition_variable staging_cv;
+// Events staged by signaling threads, drained in one swap per flush
+std::vector<Event> staging_buffer;
+uint64_t dropped_events = 0;
+
+/**
+ * Hands one event to the async eventd client. Runs on the flusher
+ * thread, so proto serialization and RPC setup never touch the
+ * signaling path
+ */
+void send_event(const Event& event) {
   AsyncEventdClient::getInstance().log_event(event, [=](Status status, Void v) {
     if (status.ok()) {
       std::cout << "[DEBUG] Success logging event: " << event.event_type()
@@ -55,8 +71,57 @@ int log_event(const Event& event) {
               << "; Status: " << status.error_message() << std::endl;
     return int(status.error_code());
   });
+}
+
+/**
+ * Flusher loop: waits for staged events and sends each batch after a
+ * single buffer swap, so a burst of attaches costs one wakeup
+ */
+void flush_staged_events() {
+  std::vector<Event> batch;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(staging_mutex);
+      staging_cv.wait(lock, [] { return !staging_buffer.empty(); });
+      batch.swap(staging_buffer);
+    }
+    for (const Event& event : batch) {
+      send_event(event);
+    }
+    batch.clear();
+  }
+}
+
+}  // namespace
+
+void init_eventd_client() {
+  auto& client = AsyncEventdClient::getInstance();
+  std::thread resp_loop_thread([&]() { client.rpc_response_loop(); });
+  resp_loop_thread.detach();
+  std::thread flush_thread([]() { flush_staged_events(); });
+  flush_thread.detach();
+}
+
+int log_event(Event&& event) {
+  {
+    std::lock_guard<std::mutex> lock(staging_mutex);
+    if (staging_buffer.size() >= MAX_STAGED_EVENTS) {
+      dropped_events++;
+      if ((dropped_events % 100) == 1) {
+        std::cout << "[ERROR] Event staging buffer full, dropped "
+                  << dropped_events << " events so far" << std::endl;
+      }
+      return 0;
+    }
+    staging_buffer.push_back(std::move(event));
+  }
+  staging_cv.notify_one();
   return 0;
 }
 
+int log_event(const Event& event) {
+  return log_event(Event(event));
+}
+
 }  // namespace lte
 }  // namespace magma
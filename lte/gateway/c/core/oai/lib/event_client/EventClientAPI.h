@@ -23,9 +23,13 @@ namespace lte {
 
 void init_eventd_client();
 
-// This call is async so the return code does not matter here.
+// This call only stages the event for a background flusher thread, so
+// the return code does not matter here.
 // TODO return void?
 int log_event(const magma::orc8r::Event& event);
 
+// Move-in overload so hot callers skip the proto copy on enqueue
+int log_event(magma::orc8r::Event&& event);
+
 }  // namespace lte
 }  // namespace magma
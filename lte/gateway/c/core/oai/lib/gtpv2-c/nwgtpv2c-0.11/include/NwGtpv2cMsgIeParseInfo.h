@@ -54,14 +54,31 @@ typedef struct nw_gtpv2c_grouped_ie_parse_info_s {
 
 } nw_gtpv2c_grouped_ie_parse_info_t;
 
+/**
+ * Upper bound on mandatory IEs in one message; each one is assigned a
+ * bit in the mandatory IE presence mask.
+ */
+#define NW_GTPV2C_MANDATORY_IE_MAXIMUM (64)
+
 typedef struct nw_gtpv2c_msg_ie_parse_info_s {
   uint16_t msgType;
   uint16_t mandatoryIeCount;
   nw_gtpv2c_stack_handle_t hStack;
 
+  /**
+   * Mask with one bit set per mandatory IE of this message type; a
+   * parsed message is complete when the seen-IE mask equals this mask.
+   */
+  uint64_t mandatoryIeMask;
+
+  /** Bit index back to IE type/instance, for reporting the missing IE */
+  uint8_t mandatoryIeType[NW_GTPV2C_MANDATORY_IE_MAXIMUM];
+  uint8_t mandatoryIeInstance[NW_GTPV2C_MANDATORY_IE_MAXIMUM];
+
   struct {
     uint8_t ieMinLength;
     uint8_t iePresence;
+    uint8_t mandatoryBitIdx;
     nw_gtpv2c_grouped_ie_parse_info_t* pGroupedIeInfo;
   } ieParseInfo[NW_GTPV2C_IE_TYPE_MAXIMUM][NW_GTPV2C_IE_INSTANCE_MAXIMUM];
 
@@ -44,6 +44,13 @@
  * @brief This file defines APIs to parser gtpv2c messages.
  */
 
+/**
+ * Upper bound on IEs registered with one parser; each registration is
+ * recorded so a pooled parser can be scrubbed entry by entry instead of
+ * wiping the whole type/instance table.
+ */
+#define NW_GTPV2C_PARSER_MAX_ADDED_IE (64)
+
 typedef struct nw_gtpv2c_msg_parser_s {
   uint16_t msgType;
   uint16_t mandatoryIeCount;
@@ -53,6 +60,14 @@ typedef struct nw_gtpv2c_msg_parser_s {
       void* ieReadCallbackArg);
   void* ieReadCallbackArg;
 
+  uint16_t addedIeCount;
+  struct {
+    uint8_t ieType;
+    uint8_t ieInstance;
+  } addedIe[NW_GTPV2C_PARSER_MAX_ADDED_IE];
+
+  struct nw_gtpv2c_msg_parser_s* pNext; /**< Parser pool chaining */
+
   struct {
     uint8_t iePresence;
     bool firstInstanceOccurred; /**< If we have multiple bearer contexts, check
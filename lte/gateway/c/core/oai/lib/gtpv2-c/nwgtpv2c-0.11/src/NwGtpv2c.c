@@ -97,6 +97,39 @@ extern "C" {
 
 static nw_gtpv2c_timeout_info_t* gpGtpv2cTimeoutInfoPool = NULL;
 
+#define NW_GTPV2C_TIMEOUT_INFO_POOL_CHUNK (64)
+
+/**
+   Allocate a timeout info from the pool, refilling the pool with a chunk
+   of timeout infos in one allocation when it runs empty so retransmission
+   timer churn does not pay one malloc per timer. Pool members are
+   recycled for the lifetime of the process and never freed individually.
+*/
+static nw_gtpv2c_timeout_info_t* nwGtpv2cTimeoutInfoAllocFromPool(
+    nw_gtpv2c_stack_t* thiz) {
+  nw_gtpv2c_timeout_info_t* timeoutInfo;
+  nw_gtpv2c_timeout_info_t* pChunk;
+  int i;
+
+  if (!gpGtpv2cTimeoutInfoPool) {
+    NW_GTPV2C_MALLOC(
+        thiz, NW_GTPV2C_TIMEOUT_INFO_POOL_CHUNK *
+                  sizeof(nw_gtpv2c_timeout_info_t),
+        pChunk, nw_gtpv2c_timeout_info_t*);
+
+    if (!pChunk) return NULL;
+
+    for (i = 0; i < NW_GTPV2C_TIMEOUT_INFO_POOL_CHUNK; i++) {
+      pChunk[i].next          = gpGtpv2cTimeoutInfoPool;
+      gpGtpv2cTimeoutInfoPool = &pChunk[i];
+    }
+  }
+
+  timeoutInfo             = gpGtpv2cTimeoutInfoPool;
+  gpGtpv2cTimeoutInfoPool = gpGtpv2cTimeoutInfoPool->next;
+  return timeoutInfo;
+}
+
 typedef struct {
   int currSize;
   int maxSize;
@@ -128,7 +161,16 @@ static nw_rc_t nwGtpv2cTmrMinHeapInsert(
     NwGtpv2cTmrMinHeapT* thiz, nw_gtpv2c_timeout_info_t* pTimerEvent) {
   int holeIndex = thiz->currSize++;
 
-  NW_ASSERT(thiz->currSize < thiz->maxSize);
+  if (thiz->currSize >= thiz->maxSize) {
+    // Grow the heap instead of asserting out under retransmission storms
+    nw_gtpv2c_timeout_info_t** pGrownHeap =
+        (nw_gtpv2c_timeout_info_t**) realloc(
+            thiz->pHeap,
+            2 * thiz->maxSize * sizeof(nw_gtpv2c_timeout_info_t*));
+    NW_ASSERT(pGrownHeap != NULL);
+    thiz->pHeap   = pGrownHeap;
+    thiz->maxSize = 2 * thiz->maxSize;
+  }
 
   while ((holeIndex > 0) &&
          NW_GTPV2C_TIMER_CMP_P(
@@ -2253,14 +2295,7 @@ nw_rc_t nwGtpv2cStartTimer(
 
   OAILOG_FUNC_IN(LOG_GTPV2C);
 
-  if (gpGtpv2cTimeoutInfoPool) {
-    timeoutInfo             = gpGtpv2cTimeoutInfoPool;
-    gpGtpv2cTimeoutInfoPool = gpGtpv2cTimeoutInfoPool->next;
-  } else {
-    NW_GTPV2C_MALLOC(
-        thiz, sizeof(nw_gtpv2c_timeout_info_t), timeoutInfo,
-        nw_gtpv2c_timeout_info_t*);
-  }
+  timeoutInfo = nwGtpv2cTimeoutInfoAllocFromPool(thiz);
 
   if (timeoutInfo) {
     timeoutInfo->tmrType             = tmrType;
@@ -2340,14 +2375,7 @@ nw_rc_t nwGtpv2cStartTimerOld(
   NW_ASSERT(thiz != NULL);
   OAILOG_FUNC_IN(LOG_GTPV2C);
 
-  if (gpGtpv2cTimeoutInfoPool) {
-    timeoutInfo             = gpGtpv2cTimeoutInfoPool;
-    gpGtpv2cTimeoutInfoPool = gpGtpv2cTimeoutInfoPool->next;
-  } else {
-    NW_GTPV2C_MALLOC(
-        thiz, sizeof(nw_gtpv2c_timeout_info_t), timeoutInfo,
-        nw_gtpv2c_timeout_info_t*);
-  }
+  timeoutInfo = nwGtpv2cTimeoutInfoAllocFromPool(thiz);
 
   if (timeoutInfo) {
     timeoutInfo->tmrType             = tmrType;
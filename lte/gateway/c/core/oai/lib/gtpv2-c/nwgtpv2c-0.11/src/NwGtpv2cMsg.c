@@ -59,6 +59,41 @@ extern "C" {
 
 static nw_gtpv2c_msg_t* gpGtpv2cMsgPool = NULL;
 
+#define NW_GTPV2C_MSG_POOL_CHUNK (32)
+
+/*----------------------------------------------------------------------------*
+   Allocate a message from the pool, refilling the pool with a chunk of
+   messages in one allocation when it runs empty so signalling storms do
+   not pay one malloc per message. Pool members are recycled for the
+   lifetime of the process and never freed individually.
+  ----------------------------------------------------------------------------*/
+
+static nw_gtpv2c_msg_t* nwGtpv2cMsgAllocFromPool(nw_gtpv2c_stack_t* pStack) {
+  nw_gtpv2c_msg_t* pMsg;
+  nw_gtpv2c_msg_t* pChunk;
+  int i;
+
+  if (!gpGtpv2cMsgPool) {
+    NW_GTPV2C_MALLOC(
+        pStack, NW_GTPV2C_MSG_POOL_CHUNK * sizeof(nw_gtpv2c_msg_t), pChunk,
+        nw_gtpv2c_msg_t*);
+
+    if (!pChunk) return NULL;
+
+    for (i = 0; i < NW_GTPV2C_MSG_POOL_CHUNK; i++) {
+      pChunk[i].next  = gpGtpv2cMsgPool;
+      gpGtpv2cMsgPool = &pChunk[i];
+    }
+
+    OAILOG_DEBUG(
+        LOG_GTPV2C, "ALLOCATED NEW MESSAGE POOL CHUNK %p!\n", pChunk);
+  }
+
+  pMsg            = gpGtpv2cMsgPool;
+  gpGtpv2cMsgPool = gpGtpv2cMsgPool->next;
+  return pMsg;
+}
+
 /*----------------------------------------------------------------------------*
                          P U B L I C   F U N C T I O N S
   ----------------------------------------------------------------------------*/
@@ -71,13 +106,7 @@ nw_rc_t nwGtpv2cMsgNew(
   nw_gtpv2c_msg_t* pMsg;
   NW_ASSERT(pStack);
 
-  if (gpGtpv2cMsgPool) {
-    pMsg            = gpGtpv2cMsgPool;
-    gpGtpv2cMsgPool = gpGtpv2cMsgPool->next;
-  } else {
-    NW_GTPV2C_MALLOC(pStack, sizeof(nw_gtpv2c_msg_t), pMsg, nw_gtpv2c_msg_t*);
-    OAILOG_DEBUG(LOG_GTPV2C, "ALLOCATED NEW MESSAGE %p!\n", pMsg);
-  }
+  pMsg = nwGtpv2cMsgAllocFromPool(pStack);
 
   if (pMsg) {
     pMsg->version     = NW_GTP_VERSION;
@@ -104,12 +133,7 @@ nw_rc_t nwGtpv2cMsgFromBufferNew(
 
   NW_ASSERT(pStack);
 
-  if (gpGtpv2cMsgPool) {
-    pMsg            = gpGtpv2cMsgPool;
-    gpGtpv2cMsgPool = gpGtpv2cMsgPool->next;
-  } else {
-    NW_GTPV2C_MALLOC(pStack, sizeof(nw_gtpv2c_msg_t), pMsg, nw_gtpv2c_msg_t*);
-  }
+  pMsg = nwGtpv2cMsgAllocFromPool(pStack);
 
   if (pMsg) {
     *phMsg = (nw_gtpv2c_msg_handle_t) pMsg;
@@ -905,8 +905,20 @@ static nw_rc_t nwGtpv2cMsgIeParseInfoUpdate(
     thiz->ieParseInfo[pMsgIeInfo[i].ieType][pMsgIeInfo[i].ieInstance]
         .ieMinLength = pMsgIeInfo[i].ieMinLength;
 
-    if (pMsgIeInfo[i].iePresence == NW_GTPV2C_IE_PRESENCE_MANDATORY)
+    if (pMsgIeInfo[i].iePresence == NW_GTPV2C_IE_PRESENCE_MANDATORY) {
+      /*
+       * Assign every mandatory IE a bit in the presence mask so the
+       * parser can validate completeness with one mask compare
+       */
+      NW_ASSERT(thiz->mandatoryIeCount < NW_GTPV2C_MANDATORY_IE_MAXIMUM);
+      thiz->ieParseInfo[pMsgIeInfo[i].ieType][pMsgIeInfo[i].ieInstance]
+          .mandatoryBitIdx = thiz->mandatoryIeCount;
+      thiz->mandatoryIeMask |= ((uint64_t) 1) << thiz->mandatoryIeCount;
+      thiz->mandatoryIeType[thiz->mandatoryIeCount] = pMsgIeInfo[i].ieType;
+      thiz->mandatoryIeInstance[thiz->mandatoryIeCount] =
+          pMsgIeInfo[i].ieInstance;
       thiz->mandatoryIeCount++;
+    }
   }
 
   return NW_OK;
@@ -1177,8 +1189,8 @@ nw_rc_t nwGtpv2cMsgIeParseInfoDelete(nw_gtpv2c_msg_ie_parse_info_t* thiz) {
 nw_rc_t nwGtpv2cMsgIeParse(
     NW_IN nw_gtpv2c_msg_ie_parse_info_t* thiz,
     NW_IN nw_gtpv2c_msg_handle_t hMsg, NW_INOUT nw_gtpv2c_error_t* pError) {
-  nw_rc_t rc                = NW_OK;
-  uint16_t mandatoryIeCount = 0;
+  nw_rc_t rc                 = NW_OK;
+  uint64_t mandatorySeenMask = 0;
   uint8_t* pIeBufStart;
   uint8_t* pIeBufEnd;
   uint16_t ieType;
@@ -1277,7 +1289,9 @@ nw_rc_t nwGtpv2cMsgIeParse(
 
       if (thiz->ieParseInfo[ieType][ieInstance].iePresence ==
           NW_GTPV2C_IE_PRESENCE_MANDATORY) {
-        mandatoryIeCount++;
+        mandatorySeenMask |=
+            ((uint64_t) 1)
+            << thiz->ieParseInfo[ieType][ieInstance].mandatoryBitIdx;
       }
     } else {
       OAILOG_WARNING(
@@ -1290,24 +1304,23 @@ nw_rc_t nwGtpv2cMsgIeParse(
     pIeBufStart += (ieLength + 4);
   }
 
-  if ((NW_OK == rc) && (mandatoryIeCount != thiz->mandatoryIeCount)) {
-    for (ieType = 0; ieType < NW_GTPV2C_IE_TYPE_MAXIMUM; ieType++) {
-      for (ieInstance = 0; ieInstance < NW_GTPV2C_IE_INSTANCE_MAXIMUM;
-           ieInstance++) {
-        if (thiz->ieParseInfo[ieType][ieInstance].iePresence ==
-            NW_GTPV2C_IE_PRESENCE_MANDATORY) {
-          if (pMsg->isIeValid[ieType][ieInstance] == false) {
-            OAILOG_ERROR(
-                LOG_GTPV2C,
-                "Mandatory IE of type %u and instance %u missing in msg type "
-                "%u\n",
-                ieType, ieInstance, pMsg->msgType);
-            pError->cause                = NW_GTPV2C_CAUSE_MANDATORY_IE_MISSING;
-            pError->offendingIe.type     = ieType;
-            pError->offendingIe.instance = ieInstance;
-            return NW_FAILURE;
-          }
-        }
+  if ((NW_OK == rc) && (mandatorySeenMask != thiz->mandatoryIeMask)) {
+    uint64_t missingMask = thiz->mandatoryIeMask & ~mandatorySeenMask;
+    uint16_t bitIdx;
+
+    for (bitIdx = 0; bitIdx < thiz->mandatoryIeCount; bitIdx++) {
+      if (missingMask & (((uint64_t) 1) << bitIdx)) {
+        ieType     = thiz->mandatoryIeType[bitIdx];
+        ieInstance = thiz->mandatoryIeInstance[bitIdx];
+        OAILOG_ERROR(
+            LOG_GTPV2C,
+            "Mandatory IE of type %u and instance %u missing in msg type "
+            "%u\n",
+            ieType, ieInstance, pMsg->msgType);
+        pError->cause                = NW_GTPV2C_CAUSE_MANDATORY_IE_MISSING;
+        pError->offendingIe.type     = ieType;
+        pError->offendingIe.instance = ieInstance;
+        return NW_FAILURE;
       }
     }
 
@@ -49,6 +49,14 @@
 extern "C" {
 #endif
 
+/*
+ * Parsers are large (the type/instance table dominates) and the s11
+ * handlers build and tear one down per received message, so retired
+ * parsers are kept on a pool with only their registered entries
+ * scrubbed instead of being freed and re-zeroed wholesale.
+ */
+static nw_gtpv2c_msg_parser_t* gpGtpv2cMsgParserPool = NULL;
+
 /**
    Allocate a gtpv2c message Parser.
 
@@ -64,10 +72,19 @@ nw_rc_t nwGtpv2cMsgParserNew(
         void* ieReadCallbackArg),
     NW_IN void* ieReadCallbackArg, NW_IN nw_gtpv2c_msg_parser_t** pthiz) {
   nw_gtpv2c_msg_parser_t* thiz;
-  thiz = (nw_gtpv2c_msg_parser_t*) malloc(sizeof(nw_gtpv2c_msg_parser_t));
+
+  if (gpGtpv2cMsgParserPool) {
+    thiz                  = gpGtpv2cMsgParserPool;
+    gpGtpv2cMsgParserPool = gpGtpv2cMsgParserPool->pNext;
+  } else {
+    thiz = (nw_gtpv2c_msg_parser_t*) malloc(sizeof(nw_gtpv2c_msg_parser_t));
+
+    if (thiz) {
+      memset(thiz, 0, sizeof(nw_gtpv2c_msg_parser_t));
+    }
+  }
 
   if (thiz) {
-    memset(thiz, 0, sizeof(nw_gtpv2c_msg_parser_t));
     thiz->msgType           = msgType;
     thiz->hStack            = hGtpcStackHandle;
     *pthiz                  = thiz;
@@ -80,7 +97,8 @@ nw_rc_t nwGtpv2cMsgParserNew(
 }
 
 /**
-   Free a gtpv2c message parser.
+   Retire a gtpv2c message parser to the pool, scrubbing only the IE
+   entries that were registered on it.
 
    @param[in] hGtpcStackHandle : gtpv2c stack handle.
    @param[in] thiz : Message parser handle.
@@ -89,7 +107,21 @@ nw_rc_t nwGtpv2cMsgParserNew(
 nw_rc_t nwGtpv2cMsgParserDelete(
     NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
     NW_IN nw_gtpv2c_msg_parser_t* thiz) {
-  NW_GTPV2C_FREE(hGtpcStackHandle, thiz);
+  uint16_t i;
+
+  for (i = 0; i < thiz->addedIeCount; i++) {
+    memset(
+        &thiz->ieParseInfo[thiz->addedIe[i].ieType][thiz->addedIe[i]
+                                                        .ieInstance],
+        0,
+        sizeof(thiz->ieParseInfo[thiz->addedIe[i].ieType]
+                                [thiz->addedIe[i].ieInstance]));
+  }
+
+  thiz->addedIeCount     = 0;
+  thiz->mandatoryIeCount = 0;
+  thiz->pNext            = gpGtpv2cMsgParserPool;
+  gpGtpv2cMsgParserPool  = thiz;
   return NW_OK;
 }
 
@@ -127,9 +159,13 @@ nw_rc_t nwGtpv2cMsgParserAddIe(
 
   if (thiz->ieParseInfo[ieType][ieInstance].iePresence == 0) {
     NW_ASSERT(ieInstance <= NW_GTPV2C_IE_INSTANCE_MAXIMUM);
+    NW_ASSERT(thiz->addedIeCount < NW_GTPV2C_PARSER_MAX_ADDED_IE);
     thiz->ieParseInfo[ieType][ieInstance].ieReadCallback    = ieReadCallback;
     thiz->ieParseInfo[ieType][ieInstance].ieReadCallbackArg = ieReadCallbackArg;
     thiz->ieParseInfo[ieType][ieInstance].iePresence        = iePresence;
+    thiz->addedIe[thiz->addedIeCount].ieType                = ieType;
+    thiz->addedIe[thiz->addedIeCount].ieInstance            = ieInstance;
+    thiz->addedIeCount++;
 
     if (iePresence == NW_GTPV2C_IE_PRESENCE_MANDATORY) {
       thiz->mandatoryIeCount++;
@@ -56,10 +56,42 @@ extern "C" {
 
 static nw_gtpv2c_trxn_t* gpGtpv2cTrxnPool = NULL;
 
+#define NW_GTPV2C_TRXN_POOL_CHUNK (64)
+
 /*--------------------------------------------------------------------------*
                      P R I V A T E      F U N C T I O N S
   --------------------------------------------------------------------------*/
 
+/*---------------------------------------------------------------------------
+   Allocate a transaction from the pool, refilling the pool with a chunk
+   of transactions in one allocation when it runs empty so signalling
+   storms do not pay one malloc per transaction. Pool members are
+   recycled for the lifetime of the process and never freed individually.
+  --------------------------------------------------------------------------*/
+
+static nw_gtpv2c_trxn_t* nwGtpv2cTrxnAllocFromPool(nw_gtpv2c_stack_t* thiz) {
+  nw_gtpv2c_trxn_t* pTrxn;
+  nw_gtpv2c_trxn_t* pChunk;
+  int i;
+
+  if (!gpGtpv2cTrxnPool) {
+    NW_GTPV2C_MALLOC(
+        thiz, NW_GTPV2C_TRXN_POOL_CHUNK * sizeof(nw_gtpv2c_trxn_t), pChunk,
+        nw_gtpv2c_trxn_t*);
+
+    if (!pChunk) return NULL;
+
+    for (i = 0; i < NW_GTPV2C_TRXN_POOL_CHUNK; i++) {
+      pChunk[i].next   = gpGtpv2cTrxnPool;
+      gpGtpv2cTrxnPool = &pChunk[i];
+    }
+  }
+
+  pTrxn            = gpGtpv2cTrxnPool;
+  gpGtpv2cTrxnPool = gpGtpv2cTrxnPool->next;
+  return pTrxn;
+}
+
 /*---------------------------------------------------------------------------
    Send msg retransmission to peer via data request to UDP Entity
   --------------------------------------------------------------------------*/
@@ -240,12 +272,7 @@ static nw_rc_t nwGtpv2cTrxnStopPeerRspTimer(nw_gtpv2c_trxn_t* thiz) {
 nw_gtpv2c_trxn_t* nwGtpv2cTrxnNew(NW_IN nw_gtpv2c_stack_t* thiz) {
   nw_gtpv2c_trxn_t* pTrxn;
 
-  if (gpGtpv2cTrxnPool) {
-    pTrxn            = gpGtpv2cTrxnPool;
-    gpGtpv2cTrxnPool = gpGtpv2cTrxnPool->next;
-  } else {
-    NW_GTPV2C_MALLOC(thiz, sizeof(nw_gtpv2c_trxn_t), pTrxn, nw_gtpv2c_trxn_t*);
-  }
+  pTrxn = nwGtpv2cTrxnAllocFromPool(thiz);
 
   if (pTrxn) {
     OAILOG_DEBUG(
@@ -281,12 +308,7 @@ nw_gtpv2c_trxn_t* nwGtpv2cTrxnWithSeqNumNew(
     NW_IN nw_gtpv2c_stack_t* thiz, NW_IN uint32_t seqNum) {
   nw_gtpv2c_trxn_t* pTrxn;
 
-  if (gpGtpv2cTrxnPool) {
-    pTrxn            = gpGtpv2cTrxnPool;
-    gpGtpv2cTrxnPool = gpGtpv2cTrxnPool->next;
-  } else {
-    NW_GTPV2C_MALLOC(thiz, sizeof(nw_gtpv2c_trxn_t), pTrxn, nw_gtpv2c_trxn_t*);
-  }
+  pTrxn = nwGtpv2cTrxnAllocFromPool(thiz);
 
   if (pTrxn) {
     OAILOG_DEBUG(
@@ -328,12 +350,7 @@ nw_gtpv2c_trxn_t* nwGtpv2cTrxnOutstandingRxNew(
 
   // todo: ipv6 for retransmission1
 
-  if (gpGtpv2cTrxnPool) {
-    pTrxn            = gpGtpv2cTrxnPool;
-    gpGtpv2cTrxnPool = gpGtpv2cTrxnPool->next;
-  } else {
-    NW_GTPV2C_MALLOC(thiz, sizeof(nw_gtpv2c_trxn_t), pTrxn, nw_gtpv2c_trxn_t*);
-  }
+  pTrxn = nwGtpv2cTrxnAllocFromPool(thiz);
 
   if (pTrxn) {
     OAILOG_DEBUG(
@@ -44,6 +44,7 @@
 #include "bstrlib.h"
 #include "dynamic_memory_check.h"
 #include "hashtable.h"
+#include "huge_alloc.h"
 
 #if TRACE_HASHTABLE
 #define PRINT_HASHTABLE(hTbLe, ...)                                            \
@@ -53,6 +54,15 @@
 #else
 #define PRINT_HASHTABLE(...)
 #endif
+
+/* Incremental growth: once the element count exceeds
+   HASH_TABLE_GROW_LOAD_NUM/HASH_TABLE_GROW_LOAD_DEN of the bucket count, a
+   doubled bucket array is installed and the old buckets are drained into it
+   a few at a time by subsequent operations, so no single insert ever pays
+   for a full rehash. */
+#define HASH_TABLE_GROW_LOAD_NUM 3
+#define HASH_TABLE_GROW_LOAD_DEN 4
+#define HASH_TABLE_MIGRATE_BUCKETS_PER_OP 8
 //------------------------------------------------------------------------------
 char* hashtable_rc_code2string(hashtable_rc_t rcP) {
   switch (rcP) {
@@ -103,6 +113,230 @@ static inline hash_size_t def_hashfunc(const uint64_t keyP) {
   return (hash_size_t) keyP;
 }
 
+//------------------------------------------------------------------------------
+/*
+   Incremental growth machinery (non thread safe tables).
+   hashtable_start_grow() parks the current bucket array in old_nodes and
+   installs a doubled one; hashtable_migrate_step() then drains the bucket the
+   caller is about to address (so mutating operations only ever work on the
+   new array) plus a bounded batch of further buckets, and releases the old
+   array once it is empty. hashtable_drain() finishes an in-progress grow for
+   the whole-table walkers (resize, apply_callback).
+*/
+static void hashtable_migrate_bucket(
+    hash_table_t* const hashtblP, const hash_size_t old_hashP) {
+  hash_node_t* node              = hashtblP->old_nodes[old_hashP];
+  hashtblP->old_nodes[old_hashP] = NULL;
+
+  while (node) {
+    hash_node_t* next     = node->next;
+    hash_size_t hash      = hashtblP->hashfunc(node->key) % hashtblP->size;
+    node->next            = hashtblP->nodes[hash];
+    hashtblP->nodes[hash] = node;
+    node                  = next;
+  }
+}
+
+static void hashtable_finish_grow(hash_table_t* const hashtblP) {
+  huge_free((void**) &hashtblP->old_nodes);
+  hashtblP->old_size    = 0;
+  hashtblP->migrate_pos = 0;
+  PRINT_HASHTABLE(
+      hashtblP, "%s(%s) grow to %lu buckets complete\n", __FUNCTION__,
+      bdata(hashtblP->name), (unsigned long) hashtblP->size);
+}
+
+static void hashtable_migrate_step(
+    hash_table_t* const hashtblP, const hash_key_t keyP) {
+  if (!hashtblP->old_nodes) {
+    return;
+  }
+  hashtable_migrate_bucket(
+      hashtblP, hashtblP->hashfunc(keyP) % hashtblP->old_size);
+
+  for (int i = 0; (i < HASH_TABLE_MIGRATE_BUCKETS_PER_OP) &&
+                  (hashtblP->migrate_pos < hashtblP->old_size);
+       i++) {
+    hashtable_migrate_bucket(hashtblP, hashtblP->migrate_pos++);
+  }
+
+  if (hashtblP->migrate_pos >= hashtblP->old_size) {
+    hashtable_finish_grow(hashtblP);
+  }
+}
+
+static void hashtable_drain(hash_table_t* const hashtblP) {
+  if (!hashtblP->old_nodes) {
+    return;
+  }
+  while (hashtblP->migrate_pos < hashtblP->old_size) {
+    hashtable_migrate_bucket(hashtblP, hashtblP->migrate_pos++);
+  }
+  hashtable_finish_grow(hashtblP);
+}
+
+static void hashtable_start_grow(hash_table_t* const hashtblP) {
+  hash_node_t** new_nodes = NULL;
+
+  if (hashtblP->old_nodes) {
+    // Previous grow still draining
+    return;
+  }
+  if (!(new_nodes = huge_calloc(hashtblP->size * 2, sizeof(hash_node_t*)))) {
+    // Keep serving from the crowded table
+    return;
+  }
+  hashtblP->old_nodes   = hashtblP->nodes;
+  hashtblP->old_size    = hashtblP->size;
+  hashtblP->migrate_pos = 0;
+  hashtblP->nodes       = new_nodes;
+  hashtblP->size        = hashtblP->size * 2;
+  PRINT_HASHTABLE(
+      hashtblP, "%s(%s) growing %lu -> %lu buckets\n", __FUNCTION__,
+      bdata(hashtblP->name), (unsigned long) hashtblP->old_size,
+      (unsigned long) hashtblP->size);
+}
+
+static inline bool hashtable_over_load_factor(const hash_table_t* hashtblP) {
+  return (
+      hashtblP->num_elements * HASH_TABLE_GROW_LOAD_DEN >
+      hashtblP->size * HASH_TABLE_GROW_LOAD_NUM);
+}
+
+//------------------------------------------------------------------------------
+/*
+   Incremental growth machinery (thread safe tables). All grow state is
+   guarded by the table mutex; operations acquire their bucket lock while
+   holding the mutex and capture the nodes/lock arrays they will work on, so
+   they keep a consistent view even if the arrays are swapped under them.
+   Draining a bucket takes its old per-bucket lock first, which fences out
+   any operation that picked up the old array before the grow started.
+*/
+static void hashtable_ts_migrate_bucket(
+    hash_table_ts_t* const hashtblP, const hash_size_t old_hashP) {
+  hash_node_t* node = NULL;
+
+  pthread_mutex_lock(&hashtblP->old_lock_nodes[old_hashP]);
+  node                           = hashtblP->old_nodes[old_hashP];
+  hashtblP->old_nodes[old_hashP] = NULL;
+  pthread_mutex_unlock(&hashtblP->old_lock_nodes[old_hashP]);
+
+  while (node) {
+    hash_node_t* next = node->next;
+    hash_size_t hash  = hashtblP->hashfunc(node->key) % hashtblP->size;
+    pthread_mutex_lock(&hashtblP->lock_nodes[hash]);
+    node->next            = hashtblP->nodes[hash];
+    hashtblP->nodes[hash] = node;
+    pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
+    node = next;
+  }
+}
+
+// Caller holds hashtblP->mutex
+static void hashtable_ts_release_retired(hash_table_ts_t* const hashtblP) {
+  if (!hashtblP->retired_lock_nodes) {
+    return;
+  }
+  for (hash_size_t n = 0; n < hashtblP->retired_size; n++) {
+    pthread_mutex_destroy(&hashtblP->retired_lock_nodes[n]);
+  }
+  huge_free((void**) &hashtblP->retired_lock_nodes);
+  hashtblP->retired_size = 0;
+}
+
+// Caller holds hashtblP->mutex. The old lock array is only retired here: a
+// reader may still hold one of its locks, so it is released on the next
+// grow or on destroy, when any such reader is long gone
+static void hashtable_ts_finish_grow(hash_table_ts_t* const hashtblP) {
+  huge_free((void**) &hashtblP->old_nodes);
+  hashtable_ts_release_retired(hashtblP);
+  hashtblP->retired_lock_nodes = hashtblP->old_lock_nodes;
+  hashtblP->retired_size       = hashtblP->old_size;
+  hashtblP->old_lock_nodes     = NULL;
+  hashtblP->old_size           = 0;
+  hashtblP->migrate_pos        = 0;
+  PRINT_HASHTABLE(
+      hashtblP, "%s(%s) grow to %lu buckets complete\n", __FUNCTION__,
+      bdata(hashtblP->name), (unsigned long) hashtblP->size);
+}
+
+// Caller holds hashtblP->mutex
+static void hashtable_ts_migrate_step(
+    hash_table_ts_t* const hashtblP, const hash_key_t keyP) {
+  if (!hashtblP->old_nodes) {
+    return;
+  }
+  hashtable_ts_migrate_bucket(
+      hashtblP, hashtblP->hashfunc(keyP) % hashtblP->old_size);
+
+  for (int i = 0; (i < HASH_TABLE_MIGRATE_BUCKETS_PER_OP) &&
+                  (hashtblP->migrate_pos < hashtblP->old_size);
+       i++) {
+    hashtable_ts_migrate_bucket(hashtblP, hashtblP->migrate_pos++);
+  }
+
+  if (hashtblP->migrate_pos >= hashtblP->old_size) {
+    hashtable_ts_finish_grow(hashtblP);
+  }
+}
+
+// Takes hashtblP->mutex; finishes any in-progress grow so whole-table
+// walkers only have one array to visit
+static void hashtable_ts_drain(hash_table_ts_t* const hashtblP) {
+  pthread_mutex_lock(&hashtblP->mutex);
+  while (hashtblP->old_nodes &&
+         (hashtblP->migrate_pos < hashtblP->old_size)) {
+    hashtable_ts_migrate_bucket(hashtblP, hashtblP->migrate_pos++);
+  }
+  if (hashtblP->old_nodes) {
+    hashtable_ts_finish_grow(hashtblP);
+  }
+  pthread_mutex_unlock(&hashtblP->mutex);
+}
+
+// Caller holds hashtblP->mutex
+static void hashtable_ts_start_grow(hash_table_ts_t* const hashtblP) {
+  hash_node_t** new_nodes     = NULL;
+  pthread_mutex_t* new_locks  = NULL;
+  hash_size_t new_size        = hashtblP->size * 2;
+
+  if (hashtblP->old_nodes) {
+    // Previous grow still draining
+    return;
+  }
+  if (!(new_nodes = huge_calloc(new_size, sizeof(hash_node_t*)))) {
+    return;
+  }
+  if (!(new_locks = huge_calloc(new_size, sizeof(pthread_mutex_t)))) {
+    huge_free((void**) &new_nodes);
+    return;
+  }
+  for (hash_size_t n = 0; n < new_size; n++) {
+    pthread_mutex_init(&new_locks[n], NULL);
+  }
+  hashtblP->old_nodes      = hashtblP->nodes;
+  hashtblP->old_lock_nodes = hashtblP->lock_nodes;
+  hashtblP->old_size       = hashtblP->size;
+  hashtblP->migrate_pos    = 0;
+  hashtblP->nodes          = new_nodes;
+  hashtblP->lock_nodes     = new_locks;
+  hashtblP->size           = new_size;
+  PRINT_HASHTABLE(
+      hashtblP, "%s(%s) growing %lu -> %lu buckets\n", __FUNCTION__,
+      bdata(hashtblP->name), (unsigned long) hashtblP->old_size,
+      (unsigned long) hashtblP->size);
+}
+
+// Caller holds hashtblP->mutex; num_elements is read atomically since the
+// bucket paths bump it outside the mutex
+static inline bool hashtable_ts_over_load_factor(
+    const hash_table_ts_t* hashtblP) {
+  return (
+      __atomic_load_n(&hashtblP->num_elements, __ATOMIC_RELAXED) *
+          HASH_TABLE_GROW_LOAD_DEN >
+      hashtblP->size * HASH_TABLE_GROW_LOAD_NUM);
+}
+
 //------------------------------------------------------------------------------
 /*
    Initialization
@@ -143,14 +377,17 @@ hash_table_t* hashtable_init(
   size |= size >> 16;
   size++;
 
-  if (!(hashtblP->nodes = calloc(size, sizeof(hash_node_t*)))) {
+  if (!(hashtblP->nodes = huge_calloc(size, sizeof(hash_node_t*)))) {
     free_wrapper((void**) &hashtblP);
     return NULL;
   }
   hashtblP->log_enabled = true;
 
   PRINT_HASHTABLE(hashtblP, "allocated nodes\n");
-  hashtblP->size = size;
+  hashtblP->size        = size;
+  hashtblP->old_nodes   = NULL;
+  hashtblP->old_size    = 0;
+  hashtblP->migrate_pos = 0;
 
   if (hashfuncP)
     hashtblP->hashfunc = hashfuncP;
@@ -237,13 +474,13 @@ hash_table_ts_t* hashtable_ts_init(
 
   memset(hashtblP, 0, sizeof(*hashtblP));
 
-  if (!(hashtblP->nodes = calloc(size, sizeof(hash_node_t*)))) {
+  if (!(hashtblP->nodes = huge_calloc(size, sizeof(hash_node_t*)))) {
     free_wrapper((void**) &hashtblP);
     return NULL;
   }
 
-  if (!(hashtblP->lock_nodes = calloc(size, sizeof(pthread_mutex_t)))) {
-    free_wrapper((void**) &hashtblP->nodes);
+  if (!(hashtblP->lock_nodes = huge_calloc(size, sizeof(pthread_mutex_t)))) {
+    huge_free((void**) &hashtblP->nodes);
     free_wrapper((void**) &hashtblP->name);
     free_wrapper((void**) &hashtblP);
     return NULL;
@@ -329,7 +566,25 @@ hashtable_rc_t hashtable_destroy(hash_table_t* hashtblP) {
     }
   }
 
-  free_wrapper((void**) &hashtblP->nodes);
+  for (n = 0; hashtblP->old_nodes && (n < hashtblP->old_size); ++n) {
+    node = hashtblP->old_nodes[n];
+
+    while (node) {
+      oldnode = node;
+      node    = node->next;
+
+      if (oldnode->data) {
+        hashtblP->freefunc(&oldnode->data);
+      }
+
+      free_wrapper((void**) &oldnode);
+    }
+  }
+  if (hashtblP->old_nodes) {
+    huge_free((void**) &hashtblP->old_nodes);
+  }
+
+  huge_free((void**) &hashtblP->nodes);
   bdestroy_wrapper(&hashtblP->name);
   if (hashtblP->is_allocated_by_malloc) {
     free_wrapper((void**) &hashtblP);
@@ -352,6 +607,12 @@ hashtable_rc_t hashtable_ts_destroy(hash_table_ts_t* hashtblP) {
     return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
   }
 
+  // Fold any in-progress grow back into a single array first
+  hashtable_ts_drain(hashtblP);
+  pthread_mutex_lock(&hashtblP->mutex);
+  hashtable_ts_release_retired(hashtblP);
+  pthread_mutex_unlock(&hashtblP->mutex);
+
   for (n = 0; n < hashtblP->size; ++n) {
     pthread_mutex_lock(&hashtblP->lock_nodes[n]);
     node = hashtblP->nodes[n];
@@ -371,9 +632,9 @@ hashtable_rc_t hashtable_ts_destroy(hash_table_ts_t* hashtblP) {
     pthread_mutex_destroy(&hashtblP->lock_nodes[n]);
   }
 
-  free_wrapper((void**) &hashtblP->nodes);
+  huge_free((void**) &hashtblP->nodes);
   bdestroy_wrapper(&hashtblP->name);
-  free_wrapper((void**) &hashtblP->lock_nodes);
+  huge_free((void**) &hashtblP->lock_nodes);
   free_wrapper((void**) &hashtblP->lock_attr);
   if (hashtblP->is_allocated_by_malloc) {
     free_wrapper((void**) &hashtblP);
@@ -404,6 +665,23 @@ hashtable_rc_t hashtable_is_key_exists(
 
     node = node->next;
   }
+
+  // During an incremental grow the key may still sit in a not yet
+  // migrated bucket of the previous array
+  if (hashtblP->old_nodes) {
+    node = hashtblP->old_nodes[hashtblP->hashfunc(keyP) % hashtblP->old_size];
+
+    while (node) {
+      if (node->key == keyP) {
+        PRINT_HASHTABLE(
+            hashtblP, "%s(%s,key 0x%" PRIx64 ") return OK\n", __FUNCTION__,
+            bdata(hashtblP->name), keyP);
+        return HASH_TABLE_OK;
+      }
+
+      node = node->next;
+    }
+  }
   PRINT_HASHTABLE(
       hashtblP, "%s(%s,key 0x%" PRIx64 ") return KEY_NOT_EXISTS\n",
       __FUNCTION__, bdata(hashtblP->name), keyP);
@@ -413,20 +691,35 @@ hashtable_rc_t hashtable_is_key_exists(
 //------------------------------------------------------------------------------
 hashtable_rc_t hashtable_ts_is_key_exists(
     const hash_table_ts_t* const hashtblP, const hash_key_t keyP) {
-  hash_node_t* node = NULL;
-  hash_size_t hash  = 0;
+  hash_node_t* node         = NULL;
+  hash_node_t* old_node     = NULL;
+  pthread_mutex_t* lock     = NULL;
+  pthread_mutex_t* old_lock = NULL;
+  hash_size_t hash          = 0;
 
   if (!hashtblP) {
     return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
   }
-
-  hash = hashtblP->hashfunc(keyP) % hashtblP->size;
-  pthread_mutex_lock(&hashtblP->lock_nodes[hash]);
-  node = hashtblP->nodes[hash];
+  // The mutex guards the grow state, not the table's logical content
+  hash_table_ts_t* ht = (hash_table_ts_t*) hashtblP;
+
+  pthread_mutex_lock(&ht->mutex);
+  hash = ht->hashfunc(keyP) % ht->size;
+  lock = &ht->lock_nodes[hash];
+  pthread_mutex_lock(lock);
+  node = ht->nodes[hash];
+  if (ht->old_nodes) {
+    hash_size_t old_hash = ht->hashfunc(keyP) % ht->old_size;
+    old_lock             = &ht->old_lock_nodes[old_hash];
+    pthread_mutex_lock(old_lock);
+    old_node = ht->old_nodes[old_hash];
+  }
+  pthread_mutex_unlock(&ht->mutex);
 
   while (node) {
     if (node->key == keyP) {
-      pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
+      if (old_lock) pthread_mutex_unlock(old_lock);
+      pthread_mutex_unlock(lock);
       PRINT_HASHTABLE(
           hashtblP, "%s(%s,key 0x%" PRIx64 ") return OK\n", __FUNCTION__,
           bdata(hashtblP->name), keyP);
@@ -435,7 +728,21 @@ hashtable_rc_t hashtable_ts_is_key_exists(
 
     node = node->next;
   }
-  pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
+
+  while (old_node) {
+    if (old_node->key == keyP) {
+      pthread_mutex_unlock(old_lock);
+      pthread_mutex_unlock(lock);
+      PRINT_HASHTABLE(
+          hashtblP, "%s(%s,key 0x%" PRIx64 ") return OK\n", __FUNCTION__,
+          bdata(hashtblP->name), keyP);
+      return HASH_TABLE_OK;
+    }
+
+    old_node = old_node->next;
+  }
+  if (old_lock) pthread_mutex_unlock(old_lock);
+  pthread_mutex_unlock(lock);
   PRINT_HASHTABLE(
       hashtblP, "%s(%s,key 0x%" PRIx64 ") return KEY_NOT_EXISTS\n",
       __FUNCTION__, bdata(hashtblP->name), keyP);
@@ -449,6 +756,9 @@ hashtable_key_array_t* hashtable_ts_get_keys(hash_table_ts_t* const hashtblP) {
   unsigned int i            = 0;
   hashtable_key_array_t* ka = NULL;
 
+  // Fold any in-progress grow so a single bucket walk sees every key
+  hashtable_ts_drain(hashtblP);
+
   ka = calloc(1, sizeof(hashtable_key_array_t));
   if (ka == NULL) return NULL;
 
@@ -489,6 +799,8 @@ hashtable_element_array_t* hashtable_ts_get_elements(
   if ((!hashtblP) || !(hashtblP->num_elements)) {
     return NULL;
   }
+  // Fold any in-progress grow so a single bucket walk sees every element
+  hashtable_ts_drain(hashtblP);
   ea           = calloc(1, sizeof(hashtable_element_array_t));
   ea->elements = calloc(hashtblP->num_elements, sizeof(void*));
 
@@ -525,6 +837,9 @@ hashtable_rc_t hashtable_apply_callback_on_elements(
     return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
   }
 
+  // Fold any in-progress grow so a single bucket walk sees every element
+  hashtable_drain(hashtblP);
+
   while ((num_elements < hashtblP->num_elements) && (i < hashtblP->size)) {
     if (hashtblP->nodes[i] != NULL) {
       node = hashtblP->nodes[i];
@@ -562,6 +877,9 @@ hashtable_rc_t hashtable_ts_apply_callback_on_elements(
     return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
   }
 
+  // Fold any in-progress grow so a single bucket walk sees every element
+  hashtable_ts_drain(hashtblP);
+
   while ((num_elements < hashtblP->num_elements) && (i < hashtblP->size)) {
     pthread_mutex_lock(&hashtblP->lock_nodes[i]);
     if (hashtblP->nodes[i] != NULL) {
@@ -613,6 +931,23 @@ hashtable_rc_t hashtable_dump_content(
     }
     i += 1;
   }
+
+  for (i = 0; hashtblP->old_nodes && (i < hashtblP->old_size); i++) {
+    node = hashtblP->old_nodes[i];
+
+    while (node) {
+      bstring b0 = bformat(
+          "Key 0x%" PRIx64 " Element %p Node %p (old array)\n", node->key,
+          node->data, node);
+      if (!b0) {
+        PRINT_HASHTABLE(hashtblP, "Error while dumping hashtable content");
+      } else {
+        bconcat(str, b0);
+        bdestroy_wrapper(&b0);
+      }
+      node = node->next;
+    }
+  }
   return HASH_TABLE_OK;
 }
 
@@ -648,6 +983,30 @@ hashtable_rc_t hashtable_ts_dump_content(
     }
     i += 1;
   }
+
+  // Not yet migrated buckets of an in-progress grow; the mutex keeps the
+  // old arrays pinned while we walk them
+  hash_table_ts_t* ht = (hash_table_ts_t*) hashtblP;
+  pthread_mutex_lock(&ht->mutex);
+  for (i = 0; ht->old_nodes && (i < ht->old_size); i++) {
+    pthread_mutex_lock(&ht->old_lock_nodes[i]);
+    node = ht->old_nodes[i];
+
+    while (node) {
+      bstring b0 = bformat(
+          "Key 0x%" PRIx64 " Element %p Node %p Next %p (old array)\n",
+          node->key, node->data, node, node->next);
+      if (!b0) {
+        PRINT_HASHTABLE(hashtblP, "Error while dumping hashtable content");
+      } else {
+        bconcat(str, b0);
+        bdestroy_wrapper(&b0);
+      }
+      node = node->next;
+    }
+    pthread_mutex_unlock(&ht->old_lock_nodes[i]);
+  }
+  pthread_mutex_unlock(&ht->mutex);
   return HASH_TABLE_OK;
 }
 
@@ -666,6 +1025,10 @@ hashtable_rc_t hashtable_insert(
     return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
   }
 
+  if (!hashtblP->old_nodes && hashtable_over_load_factor(hashtblP)) {
+    hashtable_start_grow(hashtblP);
+  }
+  hashtable_migrate_step(hashtblP, keyP);
   hash = hashtblP->hashfunc(keyP) % hashtblP->size;
   node = hashtblP->nodes[hash];
 
@@ -719,23 +1082,38 @@ hashtable_rc_t hashtable_insert(
 */
 hashtable_rc_t hashtable_ts_insert(
     hash_table_ts_t* const hashtblP, const hash_key_t keyP, void* dataP) {
-  hash_node_t* node = NULL;
-  hash_size_t hash  = 0;
+  hash_node_t* node     = NULL;
+  hash_node_t** nodes   = NULL;
+  pthread_mutex_t* lock = NULL;
+  hash_size_t hash      = 0;
 
   if (!hashtblP) {
     return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
   }
 
-  hash = hashtblP->hashfunc(keyP) % hashtblP->size;
-  pthread_mutex_lock(&hashtblP->lock_nodes[hash]);
-  node = hashtblP->nodes[hash];
+  // Start a grow once the load factor is crossed, drain the addressed
+  // bucket (and a bounded batch more) of any in-progress grow, then
+  // capture the arrays we will work on: the bucket lock is taken under
+  // the mutex, so even if the arrays are swapped out under us a later
+  // drain of this bucket has to wait for our lock
+  pthread_mutex_lock(&hashtblP->mutex);
+  if (!hashtblP->old_nodes && hashtable_ts_over_load_factor(hashtblP)) {
+    hashtable_ts_start_grow(hashtblP);
+  }
+  hashtable_ts_migrate_step(hashtblP, keyP);
+  hash  = hashtblP->hashfunc(keyP) % hashtblP->size;
+  nodes = hashtblP->nodes;
+  lock  = &hashtblP->lock_nodes[hash];
+  pthread_mutex_lock(lock);
+  pthread_mutex_unlock(&hashtblP->mutex);
+  node = nodes[hash];
 
   while (node) {
     if (node->key == keyP) {
       if ((node->data) && (node->data != dataP)) {
         hashtblP->freefunc(&node->data);
         node->data = dataP;
-        pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
+        pthread_mutex_unlock(lock);
         PRINT_HASHTABLE(
             hashtblP,
             "%s(%s,key 0x%" PRIx64 " data %p) return INSERT_OVERWRITTEN_DATA\n",
@@ -743,7 +1121,7 @@ hashtable_rc_t hashtable_ts_insert(
         return HASH_TABLE_INSERT_OVERWRITTEN_DATA;
       }
       node->data = dataP;
-      pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
+      pthread_mutex_unlock(lock);
       PRINT_HASHTABLE(
           hashtblP, "%s(%s,key 0x%" PRIx64 " data %p) return OK\n",
           __FUNCTION__, bdata(hashtblP->name), keyP, dataP);
@@ -758,15 +1136,15 @@ hashtable_rc_t hashtable_ts_insert(
   node->key  = keyP;
   node->data = dataP;
 
-  if (hashtblP->nodes[hash]) {
-    node->next = hashtblP->nodes[hash];
+  if (nodes[hash]) {
+    node->next = nodes[hash];
   } else {
     node->next = NULL;
   }
 
-  hashtblP->nodes[hash] = node;
+  nodes[hash] = node;
   __sync_fetch_and_add(&hashtblP->num_elements, 1);
-  pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
+  pthread_mutex_unlock(lock);
   PRINT_HASHTABLE(
       hashtblP, "%s(%s,key 0x%" PRIx64 " data %p) next %p return OK\n",
       __FUNCTION__, bdata(hashtblP->name), keyP, dataP, node->next);
@@ -788,6 +1166,7 @@ hashtable_rc_t hashtable_free(
     return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
   }
 
+  hashtable_migrate_step(hashtblP, keyP);
   hash = hashtblP->hashfunc(keyP) % hashtblP->size;
   node = hashtblP->nodes[hash];
 
@@ -829,22 +1208,30 @@ hashtable_rc_t hashtable_free(
 hashtable_rc_t hashtable_ts_free(
     hash_table_ts_t* const hashtblP, const hash_key_t keyP) {
   hash_node_t *node, *prevnode = NULL;
-  hash_size_t hash = 0;
+  hash_node_t** nodes   = NULL;
+  pthread_mutex_t* lock = NULL;
+  hash_size_t hash      = 0;
 
   if (!hashtblP) {
     return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
   }
 
-  hash = hashtblP->hashfunc(keyP) % hashtblP->size;
-  pthread_mutex_lock(&hashtblP->lock_nodes[hash]);
-  node = hashtblP->nodes[hash];
+  // See hashtable_ts_insert() for the grow/capture discipline
+  pthread_mutex_lock(&hashtblP->mutex);
+  hashtable_ts_migrate_step(hashtblP, keyP);
+  hash  = hashtblP->hashfunc(keyP) % hashtblP->size;
+  nodes = hashtblP->nodes;
+  lock  = &hashtblP->lock_nodes[hash];
+  pthread_mutex_lock(lock);
+  pthread_mutex_unlock(&hashtblP->mutex);
+  node = nodes[hash];
 
   while (node) {
     if (node->key == keyP) {
       if (prevnode)
         prevnode->next = node->next;
       else
-        hashtblP->nodes[hash] = node->next;
+        nodes[hash] = node->next;
 
       if (node->data) {
         hashtblP->freefunc(&node->data);
@@ -852,7 +1239,7 @@ hashtable_rc_t hashtable_ts_free(
 
       free_wrapper((void**) &node);
       __sync_fetch_and_sub(&hashtblP->num_elements, 1);
-      pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
+      pthread_mutex_unlock(lock);
       PRINT_HASHTABLE(
           hashtblP, "%s(%s,key 0x%" PRIx64 ") return OK\n", __FUNCTION__,
           bdata(hashtblP->name), keyP);
@@ -863,7 +1250,7 @@ hashtable_rc_t hashtable_ts_free(
     node     = node->next;
   }
 
-  pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
+  pthread_mutex_unlock(lock);
   PRINT_HASHTABLE(
       hashtblP, "%s(%s,key 0x%" PRIx64 ") return KEY_NOT_EXISTS\n",
       __FUNCTION__, bdata(hashtblP->name), keyP);
@@ -885,6 +1272,7 @@ hashtable_rc_t hashtable_remove(
     return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
   }
 
+  hashtable_migrate_step(hashtblP, keyP);
   hash = hashtblP->hashfunc(keyP) % hashtblP->size;
   node = hashtblP->nodes[hash];
 
@@ -923,27 +1311,35 @@ hashtable_rc_t hashtable_remove(
 hashtable_rc_t hashtable_ts_remove(
     hash_table_ts_t* const hashtblP, const hash_key_t keyP, void** dataP) {
   hash_node_t *node, *prevnode = NULL;
-  hash_size_t hash = 0;
+  hash_node_t** nodes   = NULL;
+  pthread_mutex_t* lock = NULL;
+  hash_size_t hash      = 0;
 
   if (!hashtblP) {
     return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
   }
 
-  hash = hashtblP->hashfunc(keyP) % hashtblP->size;
-  pthread_mutex_lock(&hashtblP->lock_nodes[hash]);
-  node = hashtblP->nodes[hash];
+  // See hashtable_ts_insert() for the grow/capture discipline
+  pthread_mutex_lock(&hashtblP->mutex);
+  hashtable_ts_migrate_step(hashtblP, keyP);
+  hash  = hashtblP->hashfunc(keyP) % hashtblP->size;
+  nodes = hashtblP->nodes;
+  lock  = &hashtblP->lock_nodes[hash];
+  pthread_mutex_lock(lock);
+  pthread_mutex_unlock(&hashtblP->mutex);
+  node = nodes[hash];
 
   while (node) {
     if (node->key == keyP) {
       if (prevnode)
         prevnode->next = node->next;
       else
-        hashtblP->nodes[hash] = node->next;
+        nodes[hash] = node->next;
 
       *dataP = node->data;
       free_wrapper((void**) &node);
       __sync_fetch_and_sub(&hashtblP->num_elements, 1);
-      pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
+      pthread_mutex_unlock(lock);
       PRINT_HASHTABLE(
           hashtblP, "%s(%s,key 0x%" PRIx64 ") return OK\n", __FUNCTION__,
           bdata(hashtblP->name), keyP);
@@ -953,7 +1349,7 @@ hashtable_rc_t hashtable_ts_remove(
     prevnode = node;
     node     = node->next;
   }
-  pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
+  pthread_mutex_unlock(lock);
 
   PRINT_HASHTABLE(
       hashtblP, "%s(%s,key 0x%" PRIx64 ") return KEY_NOT_EXISTS\n",
@@ -991,6 +1387,24 @@ hashtable_rc_t hashtable_get(
     node = node->next;
   }
 
+  // During an incremental grow the key may still sit in a not yet
+  // migrated bucket of the previous array
+  if (hashtblP->old_nodes) {
+    node = hashtblP->old_nodes[hashtblP->hashfunc(keyP) % hashtblP->old_size];
+
+    while (node) {
+      if (node->key == keyP) {
+        *dataP = node->data;
+        PRINT_HASHTABLE(
+            hashtblP, "%s(%s,key 0x%" PRIx64 " data %p) return OK\n",
+            __FUNCTION__, bdata(hashtblP->name), keyP, *dataP);
+        return HASH_TABLE_OK;
+      }
+
+      node = node->next;
+    }
+  }
+
   PRINT_HASHTABLE(
       hashtblP, "%s(%s,key 0x%" PRIx64 ") return KEY_NOT_EXISTS\n",
       __FUNCTION__, bdata(hashtblP->name), keyP);
@@ -1005,23 +1419,37 @@ hashtable_rc_t hashtable_get(
 hashtable_rc_t hashtable_ts_get(
     const hash_table_ts_t* const hashtblP, const hash_key_t keyP,
     void** dataP) {
-  hash_node_t* node = NULL;
-  hash_size_t hash  = 0;
+  hash_node_t* node         = NULL;
+  hash_node_t* old_node     = NULL;
+  pthread_mutex_t* lock     = NULL;
+  pthread_mutex_t* old_lock = NULL;
+  hash_size_t hash          = 0;
 
   *dataP = NULL;
   if (!hashtblP) {
     return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
   }
-
-  hash = hashtblP->hashfunc(keyP) % hashtblP->size;
-
-  pthread_mutex_lock(&hashtblP->lock_nodes[hash]);
-  node = hashtblP->nodes[hash];
+  // The mutex guards the grow state, not the table's logical content
+  hash_table_ts_t* ht = (hash_table_ts_t*) hashtblP;
+
+  pthread_mutex_lock(&ht->mutex);
+  hash = ht->hashfunc(keyP) % ht->size;
+  lock = &ht->lock_nodes[hash];
+  pthread_mutex_lock(lock);
+  node = ht->nodes[hash];
+  if (ht->old_nodes) {
+    hash_size_t old_hash = ht->hashfunc(keyP) % ht->old_size;
+    old_lock             = &ht->old_lock_nodes[old_hash];
+    pthread_mutex_lock(old_lock);
+    old_node = ht->old_nodes[old_hash];
+  }
+  pthread_mutex_unlock(&ht->mutex);
 
   while (node) {
     if (node->key == keyP) {
       *dataP = node->data;
-      pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
+      if (old_lock) pthread_mutex_unlock(old_lock);
+      pthread_mutex_unlock(lock);
       PRINT_HASHTABLE(
           hashtblP, "%s(%s,key 0x%" PRIx64 " data %p) return OK\n",
           __FUNCTION__, bdata(hashtblP->name), keyP, *dataP);
@@ -1030,7 +1458,22 @@ hashtable_rc_t hashtable_ts_get(
 
     node = node->next;
   }
-  pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
+
+  while (old_node) {
+    if (old_node->key == keyP) {
+      *dataP = old_node->data;
+      pthread_mutex_unlock(old_lock);
+      pthread_mutex_unlock(lock);
+      PRINT_HASHTABLE(
+          hashtblP, "%s(%s,key 0x%" PRIx64 " data %p) return OK\n",
+          __FUNCTION__, bdata(hashtblP->name), keyP, *dataP);
+      return HASH_TABLE_OK;
+    }
+
+    old_node = old_node->next;
+  }
+  if (old_lock) pthread_mutex_unlock(old_lock);
+  pthread_mutex_unlock(lock);
   PRINT_HASHTABLE(
       hashtblP, "%s(%s,key 0x%" PRIx64 ") return KEY_NOT_EXISTS\n",
       __FUNCTION__, bdata(hashtblP->name), keyP);
@@ -1055,10 +1498,8 @@ hashtable_rc_t hashtable_ts_get(
    for resizing the table. Resizing a hash table is not as easy as a realloc().
    All hash values must be recalculated and each element must be inserted into
    its new position. We create a temporary hash_table_t object (newtbl) to be
-   used while building the new hashes. This allows us to reuse
-   hashtable_insert() and hashtable_free(), when moving the elements to the new
-   table. After that, we can just free_wrapper the old table and copy the
-   elements from newtbl to hashtbl.
+   used while building the new hashes, relink the existing nodes into its
+   bucket array, then adopt that array.
 */
 
 hashtable_rc_t hashtable_resize(
@@ -1066,11 +1507,12 @@ hashtable_rc_t hashtable_resize(
   hash_table_t newtbl;
   hash_size_t n;
   hash_node_t *node, *next;
-  void* dummy = NULL;
 
   if (!hashtblP) {
     return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
   }
+  // Fold any in-progress incremental grow so there is one array to move
+  hashtable_drain(hashtblP);
   hash_size_t size = sizeP;
   // upper power of two:
   // http://graphics.stanford.edu/~seander/bithacks.html#RoundUpPowerOf2Float
@@ -1097,20 +1539,22 @@ hashtable_rc_t hashtable_resize(
   size |= size >> 16;
   size++;
 
+  memset(&newtbl, 0, sizeof(newtbl));
   newtbl.size     = size;
   newtbl.hashfunc = hashtblP->hashfunc;
 
-  if (!(newtbl.nodes = calloc(size, sizeof(hash_node_t*)))) return -1;
+  if (!(newtbl.nodes = huge_calloc(size, sizeof(hash_node_t*)))) return -1;
 
   for (n = 0; n < hashtblP->size; ++n) {
     for (node = hashtblP->nodes[n]; node; node = next) {
-      next = node->next;
-      hashtable_remove(hashtblP, node->key, &dummy);
-      hashtable_insert(&newtbl, node->key, node->data);
+      next               = node->next;
+      hash_size_t hash   = newtbl.hashfunc(node->key) % newtbl.size;
+      node->next         = newtbl.nodes[hash];
+      newtbl.nodes[hash] = node;
     }
   }
 
-  free_wrapper((void**) &hashtblP->nodes);
+  huge_free((void**) &hashtblP->nodes);
   hashtblP->nodes = newtbl.nodes;
   hashtblP->size  = newtbl.size;
   return HASH_TABLE_OK;
@@ -1126,10 +1570,10 @@ hashtable_rc_t hashtable_resize(
    for resizing the table. Resizing a hash table is not as easy as a realloc().
    All hash values must be recalculated and each element must be inserted into
    its new position. We create a temporary hash_table_t object (newtbl) to be
-   used while building the new hashes. This allows us to reuse
-   hashtable_insert() and hashtable_free(), when moving the elements to the new
-   table. After that, we can just free_wrapper the old table and copy the
-   elements from newtbl to hashtbl. Dangerous not really thread safe.
+   used while building the new hashes. The nodes are relinked into the new
+   bucket array under the table mutex and each source bucket lock, so
+   operations that are already holding a bucket lock finish before their
+   bucket is moved.
 */
 
 hashtable_rc_t hashtable_ts_resize(
@@ -1137,11 +1581,12 @@ hashtable_rc_t hashtable_ts_resize(
   hash_table_ts_t newtbl = {.mutex = PTHREAD_MUTEX_INITIALIZER, 0};
   hash_size_t n          = 0;
   hash_node_t *node = NULL, *next = NULL;
-  void* dummy = NULL;
 
   if (!hashtblP) {
     return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
   }
+  // Fold any in-progress incremental grow so there is one array to move
+  hashtable_ts_drain(hashtblP);
   hash_size_t size = sizeP;
   // upper power of two:
   // http://graphics.stanford.edu/~seander/bithacks.html#RoundUpPowerOf2Float
@@ -1171,31 +1616,132 @@ hashtable_rc_t hashtable_ts_resize(
   newtbl.size     = size;
   newtbl.hashfunc = hashtblP->hashfunc;
 
-  if (!(newtbl.nodes = calloc(size, sizeof(hash_node_t*))))
+  if (!(newtbl.nodes = huge_calloc(size, sizeof(hash_node_t*))))
     return HASH_TABLE_SYSTEM_ERROR;
 
-  if (!(newtbl.lock_nodes = calloc(size, sizeof(pthread_mutex_t)))) {
-    free_wrapper((void**) &newtbl.nodes);
+  if (!(newtbl.lock_nodes = huge_calloc(size, sizeof(pthread_mutex_t)))) {
+    huge_free((void**) &newtbl.nodes);
     return HASH_TABLE_SYSTEM_ERROR;
   }
-  for (n = 0; n < hashtblP->size; ++n) {
+  for (n = 0; n < size; ++n) {
     pthread_mutex_init(&newtbl.lock_nodes[n], NULL);
   }
 
   pthread_mutex_lock(&hashtblP->mutex);
   for (n = 0; n < hashtblP->size; ++n) {
+    pthread_mutex_lock(&hashtblP->lock_nodes[n]);
     for (node = hashtblP->nodes[n]; node; node = next) {
-      next = node->next;
-      hashtable_ts_remove(hashtblP, node->key, &dummy);
-      hashtable_ts_insert(&newtbl, node->key, node->data);
+      next               = node->next;
+      hash_size_t hash   = newtbl.hashfunc(node->key) % newtbl.size;
+      node->next         = newtbl.nodes[hash];
+      newtbl.nodes[hash] = node;
     }
+    hashtblP->nodes[n] = NULL;
+    pthread_mutex_unlock(&hashtblP->lock_nodes[n]);
+    pthread_mutex_destroy(&hashtblP->lock_nodes[n]);
   }
 
-  free_wrapper((void**) &hashtblP->nodes);
-  free_wrapper((void**) &hashtblP->lock_nodes);
+  huge_free((void**) &hashtblP->nodes);
+  huge_free((void**) &hashtblP->lock_nodes);
   hashtblP->size       = newtbl.size;
   hashtblP->nodes      = newtbl.nodes;
   hashtblP->lock_nodes = newtbl.lock_nodes;
   pthread_mutex_unlock(&hashtblP->mutex);
   return HASH_TABLE_OK;
 }
+
+//------------------------------------------------------------------------------
+/*
+   Occupancy statistics
+   Fills a snapshot of the table occupancy (bucket count, element count,
+   longest chain and grow progress) for the periodic service303 export.
+   Walks every bucket, so call it from a stats tick, not a fast path.
+*/
+hashtable_rc_t hashtable_get_stats(
+    const hash_table_t* const hashtblP, hashtable_stats_t* const statsP) {
+  hash_node_t* node = NULL;
+  hash_size_t n     = 0;
+  hash_size_t chain = 0;
+
+  if (!hashtblP || !statsP) {
+    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
+  }
+  memset(statsP, 0, sizeof(*statsP));
+  statsP->size         = hashtblP->size;
+  statsP->num_elements = hashtblP->num_elements;
+  if (hashtblP->old_nodes) {
+    statsP->buckets_to_migrate = hashtblP->old_size - hashtblP->migrate_pos;
+  }
+
+  for (n = 0; n < hashtblP->size; n++) {
+    chain = 0;
+    for (node = hashtblP->nodes[n]; node; node = node->next) {
+      chain++;
+    }
+    if (chain > statsP->max_chain_length) {
+      statsP->max_chain_length = chain;
+    }
+  }
+
+  for (n = 0; hashtblP->old_nodes && (n < hashtblP->old_size); n++) {
+    chain = 0;
+    for (node = hashtblP->old_nodes[n]; node; node = node->next) {
+      chain++;
+    }
+    if (chain > statsP->max_chain_length) {
+      statsP->max_chain_length = chain;
+    }
+  }
+  return HASH_TABLE_OK;
+}
+
+//------------------------------------------------------------------------------
+/*
+   Occupancy statistics, thread safe variant. The mutex is held for the
+   whole walk so the bucket arrays cannot be swapped or released under it;
+   the per-bucket locks keep the chains coherent.
+*/
+hashtable_rc_t hashtable_ts_get_stats(
+    hash_table_ts_t* const hashtblP, hashtable_stats_t* const statsP) {
+  hash_node_t* node = NULL;
+  hash_size_t n     = 0;
+  hash_size_t chain = 0;
+
+  if (!hashtblP || !statsP) {
+    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
+  }
+  memset(statsP, 0, sizeof(*statsP));
+
+  pthread_mutex_lock(&hashtblP->mutex);
+  statsP->size         = hashtblP->size;
+  statsP->num_elements = hashtblP->num_elements;
+  if (hashtblP->old_nodes) {
+    statsP->buckets_to_migrate = hashtblP->old_size - hashtblP->migrate_pos;
+  }
+
+  for (n = 0; n < hashtblP->size; n++) {
+    chain = 0;
+    pthread_mutex_lock(&hashtblP->lock_nodes[n]);
+    for (node = hashtblP->nodes[n]; node; node = node->next) {
+      chain++;
+    }
+    pthread_mutex_unlock(&hashtblP->lock_nodes[n]);
+    if (chain > statsP->max_chain_length) {
+      statsP->max_chain_length = chain;
+    }
+  }
+
+  for (n = 0; hashtblP->old_nodes && (n < hashtblP->old_size); n++) {
+    chain = 0;
+    pthread_mutex_lock(&hashtblP->old_lock_nodes[n]);
+    for (node = hashtblP->old_nodes[n]; node; node = node->next) {
+      chain++;
+    }
+    pthread_mutex_unlock(&hashtblP->old_lock_nodes[n]);
+    if (chain > statsP->max_chain_length) {
+      statsP->max_chain_length = chain;
+    }
+  }
+  pthread_mutex_unlock(&hashtblP->mutex);
+  return HASH_TABLE_OK;
+}
@@ -88,6 +88,11 @@ typedef struct hash_table_s {
   hash_size_t size;
   hash_size_t num_elements;
   struct hash_node_s** nodes;
+  /* Non NULL while an incremental grow is draining the previous bucket
+     array into nodes; buckets below migrate_pos are already empty */
+  struct hash_node_s** old_nodes;
+  hash_size_t old_size;
+  hash_size_t migrate_pos;
   hash_size_t (*hashfunc)(const hash_key_t);
   void (*freefunc)(void**);
   bstring name;
@@ -101,6 +106,16 @@ typedef struct hash_table_ts_s {
   hash_size_t num_elements;
   struct hash_node_s** nodes;
   pthread_mutex_t* lock_nodes;
+  /* Incremental grow state, guarded by mutex; see hash_table_s. The lock
+     array of a finished grow is retired rather than freed in place, since
+     a late reader may still hold one of its locks; it is released on the
+     next grow or on destroy */
+  struct hash_node_s** old_nodes;
+  pthread_mutex_t* old_lock_nodes;
+  hash_size_t old_size;
+  hash_size_t migrate_pos;
+  pthread_mutex_t* retired_lock_nodes;
+  hash_size_t retired_size;
   pthread_mutexattr_t* lock_attr;
   hash_size_t (*hashfunc)(const hash_key_t);
   void (*freefunc)(void**);
@@ -122,6 +137,9 @@ typedef struct hash_table_uint64_ts_s {
   pthread_mutex_t mutex;
   hash_size_t size;
   hash_size_t num_elements;
+  /* Monotonic count of mutating operations; lets state sync skip converting
+     tables that were not touched since the last write */
+  uint64_t mutation_count;
   struct hash_node_uint64_s** nodes;
   pthread_mutex_t* lock_nodes;
   hash_size_t (*hashfunc)(const hash_key_t);
@@ -145,6 +163,17 @@ typedef struct hashtable_uint64_element_array_s {
   uint64_t* elements;
 } hashtable_uint64_element_array_t;
 
+/* Occupancy snapshot filled by hashtable_get_stats()/hashtable_ts_get_stats(),
+   meant to be exported as gauges through service303 */
+typedef struct hashtable_stats_s {
+  hash_size_t size;
+  hash_size_t num_elements;
+  hash_size_t max_chain_length;
+  /* Buckets of the previous array still waiting to be drained, 0 when no
+     incremental grow is in progress */
+  hash_size_t buckets_to_migrate;
+} hashtable_stats_t;
+
 char* hashtable_rc_code2string(hashtable_rc_t rc);
 void hash_free_int_func(void** memory);
 hash_table_t* hashtable_init(
@@ -175,6 +204,8 @@ hashtable_rc_t hashtable_get(
     __attribute__((hot));
 hashtable_rc_t hashtable_resize(
     hash_table_t* const hashtbl, const hash_size_t size);
+hashtable_rc_t hashtable_get_stats(
+    const hash_table_t* const hashtbl, hashtable_stats_t* const stats);
 
 // Thread-safe functions
 hash_table_ts_t* hashtable_ts_init(
@@ -210,6 +241,8 @@ hashtable_rc_t hashtable_ts_get(
     __attribute__((hot));
 hashtable_rc_t hashtable_ts_resize(
     hash_table_ts_t* const hashtbl, const hash_size_t size);
+hashtable_rc_t hashtable_ts_get_stats(
+    hash_table_ts_t* const hashtbl, hashtable_stats_t* const stats);
 hash_table_uint64_ts_t* hashtable_uint64_ts_init(
     hash_table_uint64_ts_t* const hashtbl, const hash_size_t size,
     hash_size_t (*hashfunc)(const hash_key_t), bstring display_name_p);
@@ -0,0 +1,569 @@
+/*
+Copyright 2020 The Magma Authors.
+
+This source code is licensed under the BSD-style license found in the
+LICENSE file in the root directory of this source tree.
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*! \file hashtable_oa_uint64.c
+  \brief Open-addressing uint64 -> uint64 hash table with seqlock readers
+*/
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <pthread.h>
+
+#include "bstrlib.h"
+#include "dynamic_memory_check.h"
+#include "hashtable.h"
+#include "hashtable_oa_uint64.h"
+
+#if TRACE_HASHTABLE
+#define PRINT_HASHTABLE(hTbLe, ...)                                            \
+  do {                                                                         \
+    if (hTbLe->log_enabled) OAILOG_TRACE(LOG_UTIL, ##__VA_ARGS__);             \
+  } while (0)
+#else
+#define PRINT_HASHTABLE(...)
+#endif
+
+/*
+   Probe distances are stored plus one in a uint8_t, so a probe sequence is
+   bounded; insertions that would exceed it trigger a grow instead.
+*/
+#define OA_MAX_DIST_PLUS_ONE 255
+#define OA_MIN_CAPACITY 16
+
+typedef struct oa_retired_buckets_s {
+  struct oa_retired_buckets_s* next;
+  hash_key_t* keys;
+  uint64_t* datas;
+  uint8_t* dists;
+} oa_retired_buckets_t;
+
+//------------------------------------------------------------------------------
+static inline hash_size_t oa_def_hashfunc(const uint64_t keyP) {
+  return (hash_size_t) keyP;
+}
+
+//------------------------------------------------------------------------------
+static hash_size_t oa_round_up_pow2(hash_size_t size) {
+  // upper power of two, same bithack as the chained tables:
+  // http://graphics.stanford.edu/~seander/bithacks.html#RoundUpPowerOf2Float
+  size--;
+  size |= size >> 1;
+  size |= size >> 2;
+  size |= size >> 4;
+  size |= size >> 8;
+  size |= size >> 16;
+  size++;
+  return size;
+}
+
+//------------------------------------------------------------------------------
+static bool oa_alloc_buckets(
+    hash_size_t capacity, hash_key_t** keys, uint64_t** datas,
+    uint8_t** dists) {
+  *keys  = malloc(capacity * sizeof(hash_key_t));
+  *datas = malloc(capacity * sizeof(uint64_t));
+  *dists = calloc(capacity, sizeof(uint8_t));
+
+  if (!*keys || !*datas || !*dists) {
+    free_wrapper((void**) keys);
+    free_wrapper((void**) datas);
+    free_wrapper((void**) dists);
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+/*
+   Raw robin-hood insertion into the given bucket arrays; caller guarantees
+   exclusive access. Returns false if the probe sequence would overflow the
+   distance byte; the entry displaced at that point is handed back through
+   key_io/data_io so the caller can grow the table and retry it.
+*/
+static bool oa_raw_insert(
+    hash_key_t* keys, uint64_t* datas, uint8_t* dists,
+    const hash_size_t capacity, hash_size_t (*hashfunc)(const hash_key_t),
+    hash_key_t* key_io, uint64_t* data_io) {
+  hash_key_t key  = *key_io;
+  uint64_t data   = *data_io;
+  hash_size_t idx = hashfunc(key) & (capacity - 1);
+  uint8_t dist    = 1;
+
+  for (;;) {
+    if (dists[idx] == 0) {
+      keys[idx]  = key;
+      datas[idx] = data;
+      dists[idx] = dist;
+      return true;
+    }
+
+    if (dists[idx] < dist) {
+      /*
+       * Robin hood: displace the richer resident entry and keep probing
+       * with it
+       */
+      hash_key_t tmp_key = keys[idx];
+      uint64_t tmp_data  = datas[idx];
+      uint8_t tmp_dist   = dists[idx];
+
+      keys[idx]  = key;
+      datas[idx] = data;
+      dists[idx] = dist;
+      key        = tmp_key;
+      data       = tmp_data;
+      dist       = tmp_dist;
+    }
+
+    idx = (idx + 1) & (capacity - 1);
+
+    if (++dist == OA_MAX_DIST_PLUS_ONE) {
+      *key_io  = key;
+      *data_io = data;
+      return false;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+/*
+   Grow to the requested capacity. The previous bucket arrays are kept on the
+   retired list instead of being freed: a lock-free reader may still be
+   probing them, and retired generations sum to less than the current one.
+   Called with the writer mutex held and the seqlock generation odd.
+*/
+static hashtable_rc_t oa_grow(
+    hash_table_oa_uint64_ts_t* const hashtblP, hash_size_t new_capacity) {
+  hash_key_t* keys;
+  uint64_t* datas;
+  uint8_t* dists;
+  oa_retired_buckets_t* retired;
+  hash_size_t n;
+
+  for (;;) {
+    if (!oa_alloc_buckets(new_capacity, &keys, &datas, &dists)) {
+      return HASH_TABLE_SYSTEM_ERROR;
+    }
+
+    for (n = 0; n < hashtblP->capacity; n++) {
+      hash_key_t key = hashtblP->keys[n];
+      uint64_t data  = hashtblP->datas[n];
+
+      if (hashtblP->dists[n] == 0) {
+        continue;
+      }
+      if (!oa_raw_insert(
+              keys, datas, dists, new_capacity, hashtblP->hashfunc, &key,
+              &data)) {
+        break;
+      }
+    }
+
+    if (n >= hashtblP->capacity) {
+      break;
+    }
+    /*
+     * Pathological clustering in the new layout, double again
+     */
+    free_wrapper((void**) &keys);
+    free_wrapper((void**) &datas);
+    free_wrapper((void**) &dists);
+    new_capacity <<= 1;
+  }
+
+  retired = malloc(sizeof(oa_retired_buckets_t));
+
+  if (!retired) {
+    free_wrapper((void**) &keys);
+    free_wrapper((void**) &datas);
+    free_wrapper((void**) &dists);
+    return HASH_TABLE_SYSTEM_ERROR;
+  }
+
+  retired->next     = hashtblP->retired;
+  retired->keys     = hashtblP->keys;
+  retired->datas    = hashtblP->datas;
+  retired->dists    = hashtblP->dists;
+  hashtblP->retired = retired;
+
+  /*
+   * Publish the new arrays before the new capacity: a reader that observes
+   * the new capacity through its acquire load is then guaranteed to also
+   * observe the new (larger) arrays, never old arrays with a larger mask
+   */
+  hashtblP->keys  = keys;
+  hashtblP->datas = datas;
+  hashtblP->dists = dists;
+  __atomic_store_n(&hashtblP->capacity, new_capacity, __ATOMIC_RELEASE);
+  return HASH_TABLE_OK;
+}
+
+//------------------------------------------------------------------------------
+hash_table_oa_uint64_ts_t* hashtable_oa_uint64_ts_init(
+    hash_table_oa_uint64_ts_t* const hashtblP, const hash_size_t sizeP,
+    hash_size_t (*hashfuncP)(const hash_key_t), bstring display_name_pP) {
+  hash_size_t capacity = oa_round_up_pow2(sizeP);
+
+  if (capacity < OA_MIN_CAPACITY) {
+    capacity = OA_MIN_CAPACITY;
+  }
+
+  memset(hashtblP, 0, sizeof(*hashtblP));
+
+  if (!oa_alloc_buckets(
+          capacity, &hashtblP->keys, &hashtblP->datas, &hashtblP->dists)) {
+    return NULL;
+  }
+
+  pthread_mutex_init(&hashtblP->mutex, NULL);
+  hashtblP->capacity = capacity;
+
+  if (hashfuncP)
+    hashtblP->hashfunc = hashfuncP;
+  else
+    hashtblP->hashfunc = oa_def_hashfunc;
+
+  if (display_name_pP) {
+    hashtblP->name = bstrcpy(display_name_pP);
+  } else {
+    hashtblP->name = bformat("hashtable_oa@%p", hashtblP);
+  }
+  hashtblP->is_allocated_by_malloc = false;
+  hashtblP->log_enabled            = true;
+  return hashtblP;
+}
+
+//------------------------------------------------------------------------------
+hash_table_oa_uint64_ts_t* hashtable_oa_uint64_ts_create(
+    const hash_size_t sizeP, hash_size_t (*hashfuncP)(const hash_key_t),
+    bstring display_name_pP) {
+  hash_table_oa_uint64_ts_t* hashtbl = NULL;
+
+  if (!(hashtbl = calloc(1, sizeof(hash_table_oa_uint64_ts_t)))) {
+    return NULL;
+  }
+
+  if (!hashtable_oa_uint64_ts_init(
+          hashtbl, sizeP, hashfuncP, display_name_pP)) {
+    free_wrapper((void**) &hashtbl);
+    return NULL;
+  }
+  hashtbl->is_allocated_by_malloc = true;
+  return hashtbl;
+}
+
+//------------------------------------------------------------------------------
+hashtable_rc_t hashtable_oa_uint64_ts_destroy(
+    hash_table_oa_uint64_ts_t* hashtblP) {
+  oa_retired_buckets_t* retired = NULL;
+
+  if (!hashtblP) {
+    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
+  }
+
+  pthread_mutex_lock(&hashtblP->mutex);
+  free_wrapper((void**) &hashtblP->keys);
+  free_wrapper((void**) &hashtblP->datas);
+  free_wrapper((void**) &hashtblP->dists);
+
+  while (hashtblP->retired) {
+    retired           = hashtblP->retired;
+    hashtblP->retired = retired->next;
+    free_wrapper((void**) &retired->keys);
+    free_wrapper((void**) &retired->datas);
+    free_wrapper((void**) &retired->dists);
+    free_wrapper((void**) &retired);
+  }
+
+  bdestroy_wrapper(&hashtblP->name);
+  hashtblP->capacity     = 0;
+  hashtblP->num_elements = 0;
+  pthread_mutex_unlock(&hashtblP->mutex);
+  pthread_mutex_destroy(&hashtblP->mutex);
+  if (hashtblP->is_allocated_by_malloc) {
+    free_wrapper((void**) &hashtblP);
+  }
+  return HASH_TABLE_OK;
+}
+
+//------------------------------------------------------------------------------
+/*
+   Lock-free lookup: probe a consistent snapshot of the bucket arrays and
+   retry if a writer bumped the seqlock generation meanwhile. The robin-hood
+   invariant lets the probe stop as soon as it hits a bucket whose resident
+   is closer to home than the probed key would be.
+*/
+hashtable_rc_t hashtable_oa_uint64_ts_get(
+    const hash_table_oa_uint64_ts_t* const hashtblP, const hash_key_t keyP,
+    uint64_t* const dataP) {
+  if (!hashtblP) {
+    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
+  }
+
+  for (;;) {
+    uint64_t seq = __atomic_load_n(&hashtblP->seq, __ATOMIC_ACQUIRE);
+
+    if (seq & 1) {
+      continue; /* write in progress */
+    }
+
+    hash_size_t capacity =
+        __atomic_load_n(&hashtblP->capacity, __ATOMIC_ACQUIRE);
+    const hash_key_t* keys  = hashtblP->keys;
+    const uint64_t* datas   = hashtblP->datas;
+    const uint8_t* dists    = hashtblP->dists;
+    hash_size_t idx         = hashtblP->hashfunc(keyP) & (capacity - 1);
+    uint8_t dist            = 1;
+    uint64_t data           = 0;
+    hashtable_rc_t rc       = HASH_TABLE_KEY_NOT_EXISTS;
+
+    for (;;) {
+      uint8_t d = dists[idx];
+
+      if ((d == 0) || (d < dist)) {
+        break;
+      }
+
+      if (keys[idx] == keyP) {
+        data = datas[idx];
+        rc   = HASH_TABLE_OK;
+        break;
+      }
+
+      idx = (idx + 1) & (capacity - 1);
+
+      if (++dist == OA_MAX_DIST_PLUS_ONE) {
+        break;
+      }
+    }
+
+    /*
+     * Order the bucket loads above before the generation re-read, mirroring
+     * read_seqcount_retry + smp_rmb; an acquire on the re-read alone only
+     * orders the loads following it
+     */
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    if (__atomic_load_n(&hashtblP->seq, __ATOMIC_RELAXED) == seq) {
+      if (rc == HASH_TABLE_OK) {
+        *dataP = data;
+        PRINT_HASHTABLE(
+            hashtblP, "%s(%s,key 0x%" PRIx64 " data %" PRIx64 ") return OK\n",
+            __FUNCTION__, bdata(hashtblP->name), keyP, data);
+      } else {
+        PRINT_HASHTABLE(
+            hashtblP, "%s(%s,key 0x%" PRIx64 ") return KEY_NOT_EXISTS\n",
+            __FUNCTION__, bdata(hashtblP->name), keyP);
+      }
+      return rc;
+    }
+    /* a writer interleaved, retry the probe */
+  }
+}
+
+//------------------------------------------------------------------------------
+hashtable_rc_t hashtable_oa_uint64_ts_is_key_exists(
+    const hash_table_oa_uint64_ts_t* const hashtblP, const hash_key_t keyP) {
+  uint64_t data = 0;
+
+  return hashtable_oa_uint64_ts_get(hashtblP, keyP, &data);
+}
+
+//------------------------------------------------------------------------------
+hashtable_rc_t hashtable_oa_uint64_ts_insert(
+    hash_table_oa_uint64_ts_t* const hashtblP, const hash_key_t keyP,
+    const uint64_t dataP) {
+  hashtable_rc_t rc = HASH_TABLE_OK;
+  hash_size_t idx;
+  uint8_t dist;
+
+  if (!hashtblP) {
+    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
+  }
+
+  if (keyP == HASHTABLE_NOT_A_KEY_VALUE) {
+    return HASH_TABLE_BAD_PARAMETER_KEY;
+  }
+
+  pthread_mutex_lock(&hashtblP->mutex);
+  __atomic_store_n(&hashtblP->seq, hashtblP->seq + 1, __ATOMIC_RELAXED);
+  /*
+   * Order the odd generation before the bucket mutations below, mirroring
+   * write_seqcount_begin + smp_wmb; a release store alone only orders the
+   * writes preceding it
+   */
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  /*
+   * Overwrite in place when the key is already present
+   */
+  idx  = hashtblP->hashfunc(keyP) & (hashtblP->capacity - 1);
+  dist = 1;
+
+  while ((hashtblP->dists[idx] != 0) && (hashtblP->dists[idx] >= dist)) {
+    if (hashtblP->keys[idx] == keyP) {
+      rc = (hashtblP->datas[idx] == dataP) ? HASH_TABLE_SAME_KEY_VALUE_EXISTS :
+                                             HASH_TABLE_INSERT_OVERWRITTEN_DATA;
+      hashtblP->datas[idx] = dataP;
+      __atomic_store_n(&hashtblP->seq, hashtblP->seq + 1, __ATOMIC_RELEASE);
+      pthread_mutex_unlock(&hashtblP->mutex);
+      PRINT_HASHTABLE(
+          hashtblP, "%s(%s,key 0x%" PRIx64 " data %" PRIx64 ") return %d\n",
+          __FUNCTION__, bdata(hashtblP->name), keyP, dataP, rc);
+      return rc;
+    }
+    idx = (idx + 1) & (hashtblP->capacity - 1);
+    dist++;
+  }
+
+  /*
+   * Grow at 7/8 load, or whenever a probe sequence overflows the distance
+   * byte
+   */
+  if ((hashtblP->num_elements + 1) * 8 >= hashtblP->capacity * 7) {
+    rc = oa_grow(hashtblP, hashtblP->capacity << 1);
+  }
+
+  if (rc == HASH_TABLE_OK) {
+    hash_key_t carry_key = keyP;
+    uint64_t carry_data  = dataP;
+
+    while (!oa_raw_insert(
+        hashtblP->keys, hashtblP->datas, hashtblP->dists, hashtblP->capacity,
+        hashtblP->hashfunc, &carry_key, &carry_data)) {
+      rc = oa_grow(hashtblP, hashtblP->capacity << 1);
+
+      if (rc != HASH_TABLE_OK) {
+        /* allocation failure: the displaced carry entry is dropped */
+        break;
+      }
+    }
+  }
+
+  if (rc == HASH_TABLE_OK) {
+    hashtblP->num_elements += 1;
+  }
+  __atomic_store_n(&hashtblP->seq, hashtblP->seq + 1, __ATOMIC_RELEASE);
+  pthread_mutex_unlock(&hashtblP->mutex);
+  PRINT_HASHTABLE(
+      hashtblP, "%s(%s,key 0x%" PRIx64 " data %" PRIx64 ") return %d\n",
+      __FUNCTION__, bdata(hashtblP->name), keyP, dataP, rc);
+  return rc;
+}
+
+//------------------------------------------------------------------------------
+hashtable_rc_t hashtable_oa_uint64_ts_remove(
+    hash_table_oa_uint64_ts_t* const hashtblP, const hash_key_t keyP) {
+  hashtable_rc_t rc = HASH_TABLE_KEY_NOT_EXISTS;
+  hash_size_t idx;
+  hash_size_t next;
+  uint8_t dist;
+
+  if (!hashtblP) {
+    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
+  }
+
+  pthread_mutex_lock(&hashtblP->mutex);
+  __atomic_store_n(&hashtblP->seq, hashtblP->seq + 1, __ATOMIC_RELAXED);
+  /* See the insert path: the odd store must precede the bucket mutations */
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  idx  = hashtblP->hashfunc(keyP) & (hashtblP->capacity - 1);
+  dist = 1;
+
+  while ((hashtblP->dists[idx] != 0) && (hashtblP->dists[idx] >= dist)) {
+    if (hashtblP->keys[idx] == keyP) {
+      /*
+       * Backward-shift deletion keeps probe sequences dense so lookups can
+       * keep using the robin-hood early exit
+       */
+      next = (idx + 1) & (hashtblP->capacity - 1);
+
+      while (hashtblP->dists[next] > 1) {
+        hashtblP->keys[idx]  = hashtblP->keys[next];
+        hashtblP->datas[idx] = hashtblP->datas[next];
+        hashtblP->dists[idx] = hashtblP->dists[next] - 1;
+        idx                  = next;
+        next                 = (next + 1) & (hashtblP->capacity - 1);
+      }
+
+      hashtblP->dists[idx] = 0;
+      hashtblP->num_elements -= 1;
+      rc = HASH_TABLE_OK;
+      break;
+    }
+    idx = (idx + 1) & (hashtblP->capacity - 1);
+    dist++;
+  }
+
+  __atomic_store_n(&hashtblP->seq, hashtblP->seq + 1, __ATOMIC_RELEASE);
+  pthread_mutex_unlock(&hashtblP->mutex);
+  PRINT_HASHTABLE(
+      hashtblP, "%s(%s,key 0x%" PRIx64 ") return %d\n", __FUNCTION__,
+      bdata(hashtblP->name), keyP, rc);
+  return rc;
+}
+
+//------------------------------------------------------------------------------
+// may cost a lot CPU...
+hashtable_key_array_t* hashtable_oa_uint64_ts_get_keys(
+    hash_table_oa_uint64_ts_t* const hashtblP) {
+  hashtable_key_array_t* ka = NULL;
+  hash_size_t n             = 0;
+
+  if ((!hashtblP) || !(hashtblP->num_elements)) {
+    return NULL;
+  }
+
+  pthread_mutex_lock(&hashtblP->mutex);
+  ka       = calloc(1, sizeof(hashtable_key_array_t));
+  ka->keys = calloc(hashtblP->num_elements, sizeof(hash_key_t));
+
+  for (n = 0; n < hashtblP->capacity; n++) {
+    if (hashtblP->dists[n] != 0) {
+      ka->keys[ka->num_keys++] = hashtblP->keys[n];
+    }
+  }
+  pthread_mutex_unlock(&hashtblP->mutex);
+  return ka;
+}
+
+//------------------------------------------------------------------------------
+// may cost a lot CPU...
+// Also useful if we want to find an element in the collection based on compare
+// criteria different than the single key The compare criteria in implemented in
+// the funct_cb function
+hashtable_rc_t hashtable_oa_uint64_ts_apply_callback_on_elements(
+    hash_table_oa_uint64_ts_t* const hashtblP,
+    bool funct_cb(
+        const hash_key_t keyP, const uint64_t dataP, void* parameterP,
+        void** resultP),
+    void* parameterP, void** resultP) {
+  hash_size_t n = 0;
+
+  if (!hashtblP) {
+    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
+  }
+
+  pthread_mutex_lock(&hashtblP->mutex);
+
+  for (n = 0; n < hashtblP->capacity; n++) {
+    if (hashtblP->dists[n] != 0) {
+      if (funct_cb(
+              hashtblP->keys[n], hashtblP->datas[n], parameterP, resultP)) {
+        break;
+      }
+    }
+  }
+  pthread_mutex_unlock(&hashtblP->mutex);
+  return HASH_TABLE_OK;
+}
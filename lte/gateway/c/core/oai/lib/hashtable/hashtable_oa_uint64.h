@@ -0,0 +1,84 @@
+/*
+Copyright 2020 The Magma Authors.
+
+This source code is licensed under the BSD-style license found in the
+LICENSE file in the root directory of this source tree.
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*! \file hashtable_oa_uint64.h
+  \brief Open-addressing uint64 -> uint64 hash table with seqlock readers
+
+  Robin-hood open addressing replacement for hash_table_uint64_ts_t on hot
+  lookup paths. Keys, data and probe distances live in three flat arrays, so
+  a probe walks 8 keys per cache line instead of chasing a malloc'd node
+  pointer per collision. Writers serialize on a single mutex; readers are
+  lock free, validating a seqlock generation counter around each probe, so
+  lookups never contend with each other.
+
+  HASHTABLE_NOT_A_KEY_VALUE can not be stored as a key, matching the
+  convention of the chained tables.
+*/
+#ifndef FILE_HASH_TABLE_OA_UINT64_SEEN
+#define FILE_HASH_TABLE_OA_UINT64_SEEN
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <stddef.h>
+
+#include "bstrlib.h"
+#include "hashtable.h"
+
+typedef struct hash_table_oa_uint64_ts_s {
+  pthread_mutex_t mutex; /* serializes writers */
+  volatile uint64_t seq; /* seqlock generation, odd while a write is active */
+  hash_size_t capacity;  /* always a power of two */
+  hash_size_t num_elements;
+  hash_key_t* keys;
+  uint64_t* datas;
+  uint8_t* dists; /* probe distance plus one; 0 marks an empty bucket */
+  void* retired;  /* bucket arrays of previous generations, kept until destroy
+                     so lock-free readers never touch freed memory across a
+                     resize */
+  hash_size_t (*hashfunc)(const hash_key_t);
+  bstring name;
+  bool is_allocated_by_malloc;
+  bool log_enabled;
+} hash_table_oa_uint64_ts_t;
+
+hash_table_oa_uint64_ts_t* hashtable_oa_uint64_ts_init(
+    hash_table_oa_uint64_ts_t* const hashtbl, const hash_size_t size,
+    hash_size_t (*hashfunc)(const hash_key_t), bstring display_name_p);
+__attribute__((malloc)) hash_table_oa_uint64_ts_t*
+hashtable_oa_uint64_ts_create(
+    const hash_size_t size, hash_size_t (*hashfunc)(const hash_key_t),
+    bstring name_p);
+hashtable_rc_t hashtable_oa_uint64_ts_destroy(
+    hash_table_oa_uint64_ts_t* hashtbl);
+hashtable_rc_t hashtable_oa_uint64_ts_is_key_exists(
+    const hash_table_oa_uint64_ts_t* const hashtbl, const hash_key_t key)
+    __attribute__((hot, warn_unused_result));
+hashtable_key_array_t* hashtable_oa_uint64_ts_get_keys(
+    hash_table_oa_uint64_ts_t* const hashtbl);
+hashtable_rc_t hashtable_oa_uint64_ts_apply_callback_on_elements(
+    hash_table_oa_uint64_ts_t* const hashtbl,
+    bool func_cb(
+        const hash_key_t key, const uint64_t element, void* parameter,
+        void** result),
+    void* parameter, void** result);
+hashtable_rc_t hashtable_oa_uint64_ts_insert(
+    hash_table_oa_uint64_ts_t* const hashtbl, const hash_key_t key,
+    const uint64_t data);
+hashtable_rc_t hashtable_oa_uint64_ts_remove(
+    hash_table_oa_uint64_ts_t* const hashtbl, const hash_key_t key);
+hashtable_rc_t hashtable_oa_uint64_ts_get(
+    const hash_table_oa_uint64_ts_t* const hashtbl, const hash_key_t key,
+    uint64_t* const data) __attribute__((hot));
+
+#endif
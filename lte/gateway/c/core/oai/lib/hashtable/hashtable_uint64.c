@@ -42,6 +42,7 @@
 #include "bstrlib.h"
 #include "dynamic_memory_check.h"
 #include "hashtable.h"
+#include "huge_alloc.h"
 
 #if TRACE_HASHTABLE
 #define PRINT_HASHTABLE(hTbLe, ...)                                            \
@@ -104,7 +105,7 @@ hash_table_uint64_t* hashtable_uint64_init(
   size |= size >> 16;
   size++;
 
-  if (!(hashtblP->nodes = calloc(size, sizeof(hash_node_uint64_t*)))) {
+  if (!(hashtblP->nodes = huge_calloc(size, sizeof(hash_node_uint64_t*)))) {
     free_wrapper((void**) &hashtblP);
     return NULL;
   }
@@ -191,13 +192,13 @@ hash_table_uint64_ts_t* hashtable_uint64_ts_init(
 
   memset(hashtblP, 0, sizeof(*hashtblP));
 
-  if (!(hashtblP->nodes = calloc(size, sizeof(hash_node_uint64_t*)))) {
+  if (!(hashtblP->nodes = huge_calloc(size, sizeof(hash_node_uint64_t*)))) {
     free_wrapper((void**) &hashtblP);
     return NULL;
   }
 
-  if (!(hashtblP->lock_nodes = calloc(size, sizeof(pthread_mutex_t)))) {
-    free_wrapper((void**) &hashtblP->nodes);
+  if (!(hashtblP->lock_nodes = huge_calloc(size, sizeof(pthread_mutex_t)))) {
+    huge_free((void**) &hashtblP->nodes);
     free_wrapper((void**) &hashtblP->name);
     free_wrapper((void**) &hashtblP);
     return NULL;
@@ -274,7 +275,7 @@ hashtable_rc_t hashtable_uint64_destroy(hash_table_uint64_t* hashtblP) {
     }
   }
 
-  free_wrapper((void**) &hashtblP->nodes);
+  huge_free((void**) &hashtblP->nodes);
   bdestroy_wrapper(&hashtblP->name);
   hashtblP->size = 0;
   if (hashtblP->is_allocated_by_malloc) {
@@ -312,9 +313,9 @@ hashtable_rc_t hashtable_uint64_ts_destroy(hash_table_uint64_ts_t* hashtblP) {
     pthread_mutex_destroy(&hashtblP->lock_nodes[n]);
   }
 
-  free_wrapper((void**) &hashtblP->nodes);
+  huge_free((void**) &hashtblP->nodes);
   bdestroy_wrapper(&hashtblP->name);
-  free_wrapper((void**) &hashtblP->lock_nodes);
+  huge_free((void**) &hashtblP->lock_nodes);
   hashtblP->size = 0;
   if (hashtblP->is_allocated_by_malloc) {
     free_wrapper((void**) &hashtblP);
@@ -670,6 +671,7 @@ hashtable_rc_t hashtable_uint64_ts_insert(
     if (node->key == keyP) {
       if (node->data != dataP) {
         node->data = dataP;
+        __sync_fetch_and_add(&hashtblP->mutation_count, 1);
         pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
         PRINT_HASHTABLE(
             hashtblP,
@@ -701,6 +703,7 @@ hashtable_rc_t hashtable_uint64_ts_insert(
 
   hashtblP->nodes[hash] = node;
   __sync_fetch_and_add(&hashtblP->num_elements, 1);
+  __sync_fetch_and_add(&hashtblP->mutation_count, 1);
   pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
   PRINT_HASHTABLE(
       hashtblP, "%s(%s,key 0x%" PRIx64 " data %p) next %p return OK\n",
@@ -779,6 +782,7 @@ hashtable_rc_t hashtable_uint64_ts_remove(
 
       free_wrapper((void**) &node);
       __sync_fetch_and_sub(&hashtblP->num_elements, 1);
+      __sync_fetch_and_add(&hashtblP->mutation_count, 1);
       pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
       PRINT_HASHTABLE(
           hashtblP, "%s(%s,key 0x%" PRIx64 ") return OK\n", __FUNCTION__,
@@ -926,7 +930,8 @@ hashtable_rc_t hashtable_uint64_resize(
   newtbl.size     = size;
   newtbl.hashfunc = hashtblP->hashfunc;
 
-  if (!(newtbl.nodes = calloc(size, sizeof(hash_node_uint64_t*)))) return -1;
+  if (!(newtbl.nodes = huge_calloc(size, sizeof(hash_node_uint64_t*))))
+    return -1;
 
   for (n = 0; n < hashtblP->size; ++n) {
     for (node = hashtblP->nodes[n]; node; node = next) {
@@ -936,7 +941,7 @@ hashtable_rc_t hashtable_uint64_resize(
     }
   }
 
-  free_wrapper((void**) &hashtblP->nodes);
+  huge_free((void**) &hashtblP->nodes);
   hashtblP->nodes = newtbl.nodes;
   hashtblP->size  = newtbl.size;
   return HASH_TABLE_OK;
@@ -997,11 +1002,11 @@ hashtable_rc_t hashtable_uint64_ts_resize(
   newtbl.size     = size;
   newtbl.hashfunc = hashtblP->hashfunc;
 
-  if (!(newtbl.nodes = calloc(size, sizeof(hash_node_uint64_t*))))
+  if (!(newtbl.nodes = huge_calloc(size, sizeof(hash_node_uint64_t*))))
     return HASH_TABLE_SYSTEM_ERROR;
 
-  if (!(newtbl.lock_nodes = calloc(size, sizeof(pthread_mutex_t)))) {
-    free_wrapper((void**) &newtbl.nodes);
+  if (!(newtbl.lock_nodes = huge_calloc(size, sizeof(pthread_mutex_t)))) {
+    huge_free((void**) &newtbl.nodes);
     return HASH_TABLE_SYSTEM_ERROR;
   }
   for (n = 0; n < hashtblP->size; ++n) {
@@ -1017,8 +1022,8 @@ hashtable_rc_t hashtable_uint64_ts_resize(
     }
   }
 
-  free_wrapper((void**) &hashtblP->nodes);
-  free_wrapper((void**) &hashtblP->lock_nodes);
+  huge_free((void**) &hashtblP->nodes);
+  huge_free((void**) &hashtblP->lock_nodes);
   hashtblP->size       = newtbl.size;
   hashtblP->nodes      = newtbl.nodes;
   hashtblP->lock_nodes = newtbl.lock_nodes;
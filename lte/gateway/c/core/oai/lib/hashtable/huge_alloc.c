@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2015, EURECOM (www.eurecom.fr)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+/*! \file huge_alloc.c
+  \brief At 100k UEs the bucket arrays of the UE and bearer hashtables span
+  thousands of 4K pages and TLB misses show up in every lookup-heavy
+  profile; backing them with 2MB pages removes those misses. mmap with
+  MAP_HUGETLB is attempted per allocation and calloc is the transparent
+  fallback, so running without reserved hugepages changes nothing
+*/
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+#include "huge_alloc.h"
+#include "dynamic_memory_check.h"
+
+#define HUGE_PAGE_SIZE (2UL * 1024 * 1024)
+// Below half a hugepage the TLB win cannot pay for the wasted tail
+#define HUGE_ALLOC_THRESHOLD (HUGE_PAGE_SIZE / 2)
+#define HUGE_ALLOC_MAX_REGIONS 128
+
+// Registry of live hugepage regions, so huge_free can tell them apart from
+// calloc fallbacks; the MME allocates a handful of large tables, not many
+typedef struct huge_region_s {
+  void* addr;
+  size_t length;
+} huge_region_t;
+
+static pthread_mutex_t huge_alloc_lock = PTHREAD_MUTEX_INITIALIZER;
+static huge_region_t huge_regions[HUGE_ALLOC_MAX_REGIONS];
+static bool huge_alloc_enabled = false;
+
+void huge_alloc_set_enabled(bool enabled) {
+  huge_alloc_enabled = enabled;
+}
+
+bool huge_alloc_is_enabled(void) {
+  return huge_alloc_enabled;
+}
+
+void* huge_calloc(size_t nmemb, size_t size) {
+#if USE_HUGEPAGE_ARENA
+  size_t length = nmemb * size;
+
+  if (huge_alloc_enabled && length >= HUGE_ALLOC_THRESHOLD) {
+    length     = (length + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    void* addr = mmap(
+        NULL, length, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+    if (addr != MAP_FAILED) {
+      // anonymous mappings are zero-filled, matching calloc
+      pthread_mutex_lock(&huge_alloc_lock);
+      for (int i = 0; i < HUGE_ALLOC_MAX_REGIONS; i++) {
+        if (huge_regions[i].addr == NULL) {
+          huge_regions[i].addr   = addr;
+          huge_regions[i].length = length;
+          pthread_mutex_unlock(&huge_alloc_lock);
+          return addr;
+        }
+      }
+      pthread_mutex_unlock(&huge_alloc_lock);
+      // registry full: stay on the fallback path rather than leak
+      munmap(addr, length);
+    }
+    // no hugepages reserved on this host: transparent calloc fallback
+  }
+#endif
+  return calloc(nmemb, size);
+}
+
+void huge_free(void** ptrP) {
+  if ((ptrP == NULL) || (*ptrP == NULL)) {
+    return;
+  }
+#if USE_HUGEPAGE_ARENA
+  pthread_mutex_lock(&huge_alloc_lock);
+  for (int i = 0; i < HUGE_ALLOC_MAX_REGIONS; i++) {
+    if (huge_regions[i].addr == *ptrP) {
+      munmap(huge_regions[i].addr, huge_regions[i].length);
+      huge_regions[i].addr   = NULL;
+      huge_regions[i].length = 0;
+      pthread_mutex_unlock(&huge_alloc_lock);
+      *ptrP = NULL;
+      return;
+    }
+  }
+  pthread_mutex_unlock(&huge_alloc_lock);
+#endif
+  free_wrapper(ptrP);
+}
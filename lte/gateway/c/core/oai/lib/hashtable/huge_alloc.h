@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2015, EURECOM (www.eurecom.fr)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+/*! \file huge_alloc.h
+  \brief Optional 2MB hugepage backing for large long-lived allocations
+  (hashtable bucket arrays, context slabs), with transparent calloc fallback
+*/
+
+#ifndef FILE_HUGE_ALLOC_SEEN
+#define FILE_HUGE_ALLOC_SEEN
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*! \brief Enable or disable hugepage backing at runtime; allocations made
+  while disabled simply come from calloc. Compiled out entirely unless the
+  USE_HUGEPAGE_ARENA build option is set */
+void huge_alloc_set_enabled(bool enabled);
+bool huge_alloc_is_enabled(void);
+
+/*! \brief calloc drop-in: large allocations come from 2MB hugepages when
+  enabled and available, everything else from calloc */
+void* huge_calloc(size_t nmemb, size_t size);
+
+/*! \brief free counterpart for huge_calloc; safe on any pointer obtained
+  from it, hugepage-backed or not. NULLs the pointer like free_wrapper */
+void huge_free(void** ptrP);
+
+#endif
@@ -81,6 +81,9 @@ typedef struct obj_hash_table_uint64_s {
   pthread_mutex_t mutex;
   hash_size_t size;
   hash_size_t num_elements;
+  /* Monotonic count of mutating operations; lets state sync skip converting
+     tables that were not touched since the last write */
+  uint64_t mutation_count;
   struct obj_hash_node_uint64_s** nodes;
   pthread_mutex_t* lock_nodes;
   hash_size_t (*hashfunc)(const void*, int);
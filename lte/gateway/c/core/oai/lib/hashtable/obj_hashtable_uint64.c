@@ -607,6 +607,7 @@ hashtable_rc_t obj_hashtable_uint64_ts_insert(
         node->key_size = key_sizeP;
         // no waste of memory here because if node->key == keyP, it is a reuse
         // of the same key
+        __sync_fetch_and_add(&hashtblP->mutation_count, 1);
         pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
         PRINT_HASHTABLE(
             hashtblP,
@@ -654,6 +655,7 @@ hashtable_rc_t obj_hashtable_uint64_ts_insert(
 
   hashtblP->nodes[hash] = node;
   __sync_fetch_and_add(&hashtblP->num_elements, 1);
+  __sync_fetch_and_add(&hashtblP->mutation_count, 1);
   pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
   PRINT_HASHTABLE(
       hashtblP, "%s(%s,key %p klen %u data %" PRIx64 ") hash %lx return OK\n",
@@ -747,6 +749,7 @@ hashtable_rc_t obj_hashtable_uint64_ts_free(
       hashtblP->freekeyfunc(&node->key);
       free_wrapper((void**) &node);
       __sync_fetch_and_sub(&hashtblP->num_elements, 1);
+      __sync_fetch_and_add(&hashtblP->mutation_count, 1);
       pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
       PRINT_HASHTABLE(
           hashtblP, "%s(%s,key %p) hash %lx return OK\n", __FUNCTION__,
@@ -848,6 +851,7 @@ hashtable_rc_t obj_hashtable_uint64_ts_remove(
       hashtblP->freekeyfunc(&node->key);
       free_wrapper((void**) &node);
       __sync_fetch_and_sub(&hashtblP->num_elements, 1);
+      __sync_fetch_and_add(&hashtblP->mutation_count, 1);
       pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
       PRINT_HASHTABLE(
           hashtblP, "%s(%s,key %p) hash %lx return OK\n", __FUNCTION__,
@@ -30,6 +30,7 @@
 
 #define _GNU_SOURCE
 #include <pthread.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -39,12 +40,18 @@
 #include <signal.h>
 #include <malloc.h>
 #include <stdint.h>
+#include <sys/syscall.h>
 #include <sys/time.h>
 
+#if USE_JEMALLOC
+#include <jemalloc/jemalloc.h>
+#endif
+
 #include "assertions.h"
 #include "intertask_interface.h"
 #include "intertask_interface_conf.h"
 #include "common_defs.h"
+#include "magma_sdt.h"
 
 /* Includes "intertask_interface_init.h" to check prototype coherence, but
    disable threads and messages information generation.
@@ -56,6 +63,11 @@
 
 #include "signals.h"
 #include "timer.h"
+#include "itti_ring.h"
+#include "itti_latency.h"
+#include "itti_shed.h"
+#include "itti_watchdog.h"
+#include "itti_free_defined_msg.h"
 #include "dynamic_memory_check.h"
 #include "shared_ts_log.h"
 #include "log.h"
@@ -96,6 +108,10 @@ typedef struct thread_desc_s {
 
   volatile task_state_t task_state;  // State of the thread
 
+  int placement_core;       // CPU the thread is pinned to, -1 leaves it free
+  int placement_fifo_prio;  // SCHED_FIFO priority, 0 keeps the default class
+  pid_t task_tid;           // kernel tid, for the migration counter
+
 } thread_desc_t;
 
 typedef struct itti_desc_s {
@@ -118,6 +134,40 @@ typedef struct itti_desc_s {
 
 static itti_desc_t itti_desc;
 
+/* Message handlers of tasks served by the ring transport, indexed by task
+   id. The ring poller below invokes them directly, once per pending
+   message, instead of going through a pull socket */
+static zloop_reader_fn* itti_ring_msg_handlers[TASK_MAX];
+
+/* Arguments passed to the handlers above; NULL unless the latency
+   instrumentation interposer is installed */
+static void* itti_ring_msg_handler_args[TASK_MAX];
+
+/* Task whose rings the current thread is draining; consulted by
+   receive_msg when invoked from the ring poller with a NULL reader */
+static __thread task_id_t itti_ring_pop_task_id = TASK_UNKNOWN;
+
+static int itti_ring_poller_fn(
+    zloop_t* loop, zmq_pollitem_t* item, void* arg) {
+  task_zmq_ctx_t* task_zmq_ctx_p = (task_zmq_ctx_t*) arg;
+  task_id_t task_id              = task_zmq_ctx_p->task_id;
+
+  itti_ring_drain_event_fd(task_id);
+  itti_ring_pop_task_id = task_id;
+
+  while (itti_ring_pending(task_id)) {
+    int rc = itti_ring_msg_handlers[task_id](
+        loop, NULL, itti_ring_msg_handler_args[task_id]);
+
+    if (rc != 0) {
+      // Handler requested the event loop to stop
+      return rc;
+    }
+  }
+
+  return 0;
+}
+
 status_code_e send_msg_to_task(
     task_zmq_ctx_t* task_zmq_ctx_p, task_id_t destination_task_id,
     MessageDef* message) {
@@ -128,6 +178,30 @@ status_code_e send_msg_to_task(
         itti_get_message_name(message->ittiMsgHeader.messageId),
         itti_get_task_name(destination_task_id));
 
+    // Drop deferrable messages for destinations over their watermark; the
+    // caller can map the error to a cause code. No-op when shedding is off
+    if (unlikely(itti_shed_on_send(destination_task_id, message))) {
+      free(message);
+      return RETURNerror;
+    }
+
+    // Re-stamp the header with the send time so receivers can measure the
+    // queue-wait; no-op when latency instrumentation is off
+    itti_latency_stamp_send(message);
+
+    MAGMA_USDT3(
+        itti_send_msg, destination_task_id, message->ittiMsgHeader.messageId,
+        message->ittiMsgHeader.ittiMsgSize);
+
+    if (itti_ring_transport_enabled()) {
+      // The ring is single-producer, so threads sharing this context are
+      // serialized; the receiver frees the message after handling it
+      pthread_mutex_lock(&task_zmq_ctx_p->send_mutex);
+      itti_ring_push(task_zmq_ctx_p->task_id, destination_task_id, message);
+      pthread_mutex_unlock(&task_zmq_ctx_p->send_mutex);
+      return RETURNok;
+    }
+
     // TODO: can we use zframe_frommem to avoid memcopy
     zframe_t* frame = zframe_new(
         message, sizeof(MessageHeader) + message->ittiMsgHeader.ittiMsgSize);
@@ -151,6 +225,16 @@ status_code_e send_msg_to_task(
 }
 
 MessageDef* receive_msg(zsock_t* reader) {
+  if (reader == NULL) {
+    // Ring transport: the sender's message pointer is handed over directly,
+    // no copy is needed
+    MessageDef* msg = itti_ring_pop(itti_ring_pop_task_id);
+    AssertFatal(msg != NULL, "receive_msg called with no pending message!\n");
+    itti_shed_note_receive();
+    itti_latency_note_receive(msg);
+    return msg;
+  }
+
   zframe_t* msg_frame = zframe_recv(reader);
   assert(msg_frame);
 
@@ -160,10 +244,31 @@ MessageDef* receive_msg(zsock_t* reader) {
   memcpy(msg, zframe_data(msg_frame), zframe_size(msg_frame));
 
   zframe_destroy(&msg_frame);
+  itti_shed_note_receive();
+  itti_latency_note_receive(msg);
   return msg;
 }
 
 void send_broadcast_msg(task_zmq_ctx_t* task_zmq_ctx_p, MessageDef* message) {
+  if (itti_ring_transport_enabled()) {
+    size_t size = sizeof(MessageHeader) + message->ittiMsgHeader.ittiMsgSize;
+
+    for (int i = 0; i < TASK_MAX; i++) {
+      if (task_zmq_ctx_p->push_socks[i]) {
+        // Each receiver frees its own message, so push a copy per ring
+        MessageDef* copy = (MessageDef*) malloc(size);
+        AssertFatal(copy != NULL, "Message memory allocation failed!\n");
+        memcpy(copy, message, size);
+        pthread_mutex_lock(&task_zmq_ctx_p->send_mutex);
+        itti_ring_push(task_zmq_ctx_p->task_id, i, copy);
+        pthread_mutex_unlock(&task_zmq_ctx_p->send_mutex);
+      }
+    }
+
+    free(message);
+    return;
+  }
+
   zframe_t* frame = zframe_new(
       message, sizeof(MessageHeader) + message->ittiMsgHeader.ittiMsgSize);
   assert(frame);
@@ -205,9 +310,17 @@ void init_task_context(
     task_zmq_ctx_t* task_zmq_ctx_p) {
   task_zmq_ctx_p->task_id = task_id;
 
+  // Runs on the task's own thread, so received messages are debited from
+  // this task's watermark counter
+  itti_shed_register_thread(task_id);
+
   task_zmq_ctx_p->event_loop = zloop_new();
   assert(task_zmq_ctx_p->event_loop);
 
+  // Heartbeat this loop so a handler stuck past the stall threshold is
+  // detected and its stack dumped; no-op when the watchdog is off
+  itti_watchdog_arm_loop(task_id, task_zmq_ctx_p->event_loop);
+
   pthread_mutex_init(&task_zmq_ctx_p->send_mutex, NULL);
 
   for (int i = 0; i < remote_tasks_count; i++) {
@@ -217,19 +330,47 @@ void init_task_context(
         task_zmq_ctx_p->push_socks[remote_task_ids[i]],
         "remote task id: %d uri: %s", remote_task_ids[i],
         itti_desc.tasks_info[remote_task_ids[i]].uri);
+
+    if (itti_ring_transport_enabled()) {
+      itti_ring_create(task_id, remote_task_ids[i]);
+    }
   }
 
   if (msg_handler) {
-    task_zmq_ctx_p->pull_sock =
-        zsock_new_pull(itti_desc.tasks_info[task_id].uri);
-    AssertFatal(
-        task_zmq_ctx_p->pull_sock, "task id: %d uri: %s", task_id,
-        itti_desc.tasks_info[task_id].uri);
+    void* msg_handler_arg = NULL;
 
-    int rc = zloop_reader(
-        task_zmq_ctx_p->event_loop, task_zmq_ctx_p->pull_sock, msg_handler,
-        NULL);
-    assert(rc == 0);
+    if (itti_latency_enabled()) {
+      // Route messages through the latency interposer, which samples
+      // queue-wait and handler duration around the real handler
+      msg_handler_arg = itti_latency_make_handler_ctx(task_id, msg_handler);
+      msg_handler     = itti_latency_reader_fn;
+    }
+
+    if (itti_ring_transport_enabled()) {
+      // Messages arrive through the sender rings; the eventfd is only a
+      // doorbell, polled from the same zloop that serves timers
+      itti_ring_msg_handlers[task_id]     = msg_handler;
+      itti_ring_msg_handler_args[task_id] = msg_handler_arg;
+      zmq_pollitem_t item                 = {0};
+      item.fd                         = itti_ring_event_fd(task_id);
+      item.events                     = ZMQ_POLLIN;
+
+      int rc = zloop_poller(
+          task_zmq_ctx_p->event_loop, &item, itti_ring_poller_fn,
+          task_zmq_ctx_p);
+      assert(rc == 0);
+    } else {
+      task_zmq_ctx_p->pull_sock =
+          zsock_new_pull(itti_desc.tasks_info[task_id].uri);
+      AssertFatal(
+          task_zmq_ctx_p->pull_sock, "task id: %d uri: %s", task_id,
+          itti_desc.tasks_info[task_id].uri);
+
+      int rc = zloop_reader(
+          task_zmq_ctx_p->event_loop, task_zmq_ctx_p->pull_sock, msg_handler,
+          msg_handler_arg);
+      assert(rc == 0);
+    }
   }
 
   task_zmq_ctx_p->ready = true;
@@ -254,6 +395,14 @@ const char* itti_get_message_name(MessagesIds message_id) {
   return (itti_desc.messages_info[message_id].name);
 }
 
+uint32_t itti_get_message_size(MessagesIds message_id) {
+  AssertFatal(
+      message_id < itti_desc.messages_id_max,
+      "Message id (%d) is out of range (%d)!\n", message_id,
+      itti_desc.messages_id_max);
+  return (itti_desc.messages_info[message_id].size);
+}
+
 const char* itti_get_task_name(task_id_t task_id) {
   if (itti_desc.task_max > 0) {
     AssertFatal(
@@ -325,6 +474,68 @@ MessageDef* DEPRECATEDitti_alloc_new_message_fatal(
   return message_p;
 }
 
+void itti_set_task_placement(
+    task_id_t task_id, int core, int sched_fifo_prio) {
+  thread_id_t thread_id = TASK_GET_THREAD_ID(task_id);
+
+  AssertFatal(
+      thread_id < itti_desc.thread_max,
+      "Thread id (%d) is out of range (%d)!\n", thread_id,
+      itti_desc.thread_max);
+  AssertFatal(
+      itti_desc.threads[thread_id].task_state == TASK_STATE_NOT_CONFIGURED,
+      "Placement for task %d must be set before the task is created!\n",
+      task_id);
+
+  itti_desc.threads[thread_id].placement_core      = core;
+  itti_desc.threads[thread_id].placement_fifo_prio = sched_fifo_prio;
+}
+
+task_id_t itti_get_task_id_by_name(const char* name) {
+  task_id_t task_id;
+
+  if (name == NULL) {
+    return TASK_UNKNOWN;
+  }
+  for (task_id = TASK_FIRST; task_id < itti_desc.task_max; task_id++) {
+    if (strcmp(itti_desc.tasks_info[task_id].name, name) == 0) {
+      return task_id;
+    }
+  }
+  return TASK_UNKNOWN;
+}
+
+uint64_t itti_get_task_migrations(task_id_t task_id) {
+  thread_id_t thread_id = TASK_GET_THREAD_ID(task_id);
+  char path[64];
+  char line[256];
+  uint64_t migrations = 0;
+
+  if ((thread_id >= itti_desc.thread_max) ||
+      (itti_desc.threads[thread_id].task_tid == 0)) {
+    return 0;
+  }
+  snprintf(
+      path, sizeof(path), "/proc/self/task/%d/sched",
+      itti_desc.threads[thread_id].task_tid);
+
+  FILE* fp = fopen(path, "r");
+  if (fp == NULL) {
+    return 0;
+  }
+  while (fgets(line, sizeof(line), fp)) {
+    if (strncmp(line, "se.nr_migrations", 16) == 0) {
+      char* colon = strchr(line, ':');
+      if (colon) {
+        migrations = strtoull(colon + 1, NULL, 10);
+      }
+      break;
+    }
+  }
+  fclose(fp);
+  return migrations;
+}
+
 status_code_e itti_create_task(
     task_id_t task_id, void* (*start_routine)(void*), void* args_p) {
   thread_id_t thread_id = TASK_GET_THREAD_ID(task_id);
@@ -354,6 +565,41 @@ status_code_e itti_create_task(
 
   pthread_setname_np(
       itti_desc.threads[thread_id].task_thread, itti_get_task_name(task_id));
+
+  // Apply the configured placement: pinning and scheduling class must be in
+  // effect before the task thread starts handling messages
+  if (itti_desc.threads[thread_id].placement_core >= 0) {
+    cpu_set_t cpuset;
+
+    CPU_ZERO(&cpuset);
+    CPU_SET(itti_desc.threads[thread_id].placement_core, &cpuset);
+    result = pthread_setaffinity_np(
+        itti_desc.threads[thread_id].task_thread, sizeof(cpu_set_t), &cpuset);
+    if (result != 0) {
+      OAILOG_ERROR(
+          LOG_ITTI, "Failed to pin task %s to core %d (%d)\n",
+          itti_get_task_name(task_id),
+          itti_desc.threads[thread_id].placement_core, result);
+    } else {
+      ITTI_DEBUG(
+          ITTI_DEBUG_INIT, " Pinned task %s to core %d\n",
+          itti_get_task_name(task_id),
+          itti_desc.threads[thread_id].placement_core);
+    }
+  }
+  if (itti_desc.threads[thread_id].placement_fifo_prio > 0) {
+    struct sched_param sched_params = {
+        .sched_priority = itti_desc.threads[thread_id].placement_fifo_prio};
+
+    result = pthread_setschedparam(
+        itti_desc.threads[thread_id].task_thread, SCHED_FIFO, &sched_params);
+    if (result != 0) {
+      OAILOG_ERROR(
+          LOG_ITTI, "Failed to set SCHED_FIFO prio %d for task %s (%d)\n",
+          itti_desc.threads[thread_id].placement_fifo_prio,
+          itti_get_task_name(task_id), result);
+    }
+  }
   itti_desc.created_tasks++;
 
   // Wait till the thread is completely ready
@@ -372,6 +618,23 @@ void itti_mark_task_ready(task_id_t task_id) {
       "Thread id (%d) is out of range (%d)!\n", thread_id,
       itti_desc.thread_max);
 
+  // Runs on the task thread itself: remember the kernel tid so the per-task
+  // migration counter can be read back from /proc
+  itti_desc.threads[thread_id].task_tid = (pid_t) syscall(SYS_gettid);
+
+#if USE_JEMALLOC
+  // Bind this task thread to its own jemalloc arena. ITTI messages are
+  // allocated by the producer and freed by the consumer; dedicated arenas
+  // keep the allocation hot paths of different tasks off shared arena
+  // locks during signaling storms
+  unsigned arena   = 0;
+  size_t arena_len = sizeof(arena);
+
+  if (mallctl("arenas.create", &arena, &arena_len, NULL, 0) == 0) {
+    mallctl("thread.arena", NULL, NULL, &arena, sizeof(arena));
+  }
+#endif
+
   // Mark the thread as using LFDS queue
 
   LFDS710_MISC_MAKE_VALID_ON_CURRENT_LOGICAL_CORE_INITS_COMPLETED_BEFORE_NOW_ON_ANY_OTHER_LOGICAL_CORE;
@@ -417,13 +680,36 @@ int itti_init(
 
   for (thread_id = THREAD_FIRST; thread_id < itti_desc.thread_max;
        thread_id++) {
-    itti_desc.threads[thread_id].task_state = TASK_STATE_NOT_CONFIGURED;
+    itti_desc.threads[thread_id].task_state     = TASK_STATE_NOT_CONFIGURED;
+    itti_desc.threads[thread_id].placement_core = -1;
   }
 
   itti_desc.running       = 1;
   itti_desc.created_tasks = 0;
   itti_desc.ready_tasks   = 0;
 
+  // Select the lock-free ring transport instead of ZMQ inproc sockets when
+  // requested; must happen here, before any task context is initialized
+  const char* ring_transport = getenv("MAGMA_ITTI_RING_TRANSPORT");
+
+  if (ring_transport != NULL && strcmp(ring_transport, "1") == 0) {
+    itti_ring_set_transport_enabled(true);
+    itti_ring_init();
+    ITTI_DEBUG(ITTI_DEBUG_INIT, " Using ring transport for ITTI messages\n");
+  }
+
+  // Enable sampled per (task, message) latency histograms when requested
+  itti_latency_init();
+
+  // Enable per-task queue watermarks and overload shedding when requested
+  itti_shed_init();
+
+  // Enable the event-loop stall watchdog when requested
+  itti_watchdog_init();
+
+  // Populate the per-message destructor table used by itti_free_msg_content
+  itti_free_msg_content_init();
+
   return 0;
 }
 
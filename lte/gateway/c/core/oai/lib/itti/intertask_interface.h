@@ -108,7 +108,8 @@ status_code_e send_msg_to_task(
     MessageDef* message);
 
 /** \brief Receive a message from zsock
- \param reader Pointer to ZMQ socket
+ \param reader Pointer to ZMQ socket, or NULL when invoked from the ring
+ transport poller, in which case the message is popped from the task's rings
  @returns Pointer to the message read (caller to free)
  **/
 MessageDef* receive_msg(zsock_t* reader);
@@ -164,6 +165,27 @@ void send_broadcast_msg(task_zmq_ctx_t* task_zmq_ctx_p, MessageDef* message);
 status_code_e itti_create_task(
     task_id_t task_id, void* (*start_routine)(void*), void* args_p);
 
+/** \brief Configure placement for a task thread, to be applied when the
+ * task is created; must be called before itti_create_task for that task
+ * \param task_id task to place
+ * \param core CPU to pin the task thread to, -1 leaves it floating
+ * \param sched_fifo_prio SCHED_FIFO priority, 0 keeps the default class
+ **/
+void itti_set_task_placement(task_id_t task_id, int core, int sched_fifo_prio);
+
+/** \brief Look up a task id from its registered name (e.g. "TASK_S1AP")
+ * \param name task name as registered in tasks_def.h
+ * @returns the task id, or TASK_UNKNOWN if the name matches no task
+ **/
+task_id_t itti_get_task_id_by_name(const char* name);
+
+/** \brief Read the kernel migration counter of a task thread from /proc,
+ * to verify a pinned layout actually holds
+ * \param task_id task to query
+ * @returns number of core migrations, 0 if the task is not running
+ **/
+uint64_t itti_get_task_migrations(task_id_t task_id);
+
 /** \brief Mark the task as in ready state
  * \param task_id task to mark as ready
  **/
@@ -178,6 +200,11 @@ void itti_exit_task(void);
  **/
 const char* itti_get_message_name(MessagesIds message_id);
 
+/** \brief Return the payload size registered for the message
+ * \param message_id Id of the message
+ **/
+uint32_t itti_get_message_size(MessagesIds message_id);
+
 /** \brief Return the printable string associated with a task id
  * \param thread_id Id of the task
  **/
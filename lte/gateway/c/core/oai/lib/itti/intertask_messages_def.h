@@ -66,3 +66,7 @@ MESSAGE_DEF(RECOVERY_MESSAGE, IttiMsgEmpty, recovery_message)
 
 // This message leads to recovery of timers for all tasks after MME restart
 MESSAGE_DEF(TEST_MESSAGE, IttiMsgEmpty, test_message)
+
+// Envelope carrying several pooled messages delivered in one send, see
+// itti_msg_batch.h
+MESSAGE_DEF(ITTI_MSG_BATCH, itti_msg_batch_t, itti_msg_batch)
@@ -52,4 +52,16 @@ typedef struct IttiMsgText_s {
   char text[];
 } IttiMsgText;
 
+// Maximum number of messages carried by one ITTI_MSG_BATCH envelope
+#define ITTI_MSG_BATCH_MAX_MSGS 16
+
+// Batch envelope: carries pointers to fully built messages so that several
+// events can be delivered to a task in a single send. The pointed-to
+// messages come from the itti_msg_batch pool; the receiver hands each one
+// back with itti_batch_release_msg() once it has been handled.
+typedef struct itti_msg_batch_s {
+  uint32_t count;
+  struct MessageDef_s* msgs[ITTI_MSG_BATCH_MAX_MSGS];
+} itti_msg_batch_t;
+
 #endif /* INTERTASK_MESSAGES_TYPES_H_ */
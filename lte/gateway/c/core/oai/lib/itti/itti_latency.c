@@ -0,0 +1,215 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include "itti_latency.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "assertions.h"
+
+#define ITTI_LATENCY_SAMPLE_RATE_ENV "MAGMA_ITTI_LATENCY_SAMPLE_RATE"
+
+/* Power-of-two microsecond buckets; bucket b counts latencies of at most
+   (1 << b) us, the last bucket collects everything above ~8.4 s */
+#define ITTI_LATENCY_NUM_BUCKETS 24
+
+typedef struct itti_latency_hist_s {
+  uint64_t buckets[ITTI_LATENCY_NUM_BUCKETS];
+} itti_latency_hist_t;
+
+/* The two measured stages of one (destination task, message id) pair */
+typedef struct itti_latency_pair_s {
+  itti_latency_hist_t queue_wait;
+  itti_latency_hist_t handler;
+} itti_latency_pair_t;
+
+typedef struct itti_latency_task_ctx_s {
+  task_id_t task_id;
+  zloop_reader_fn* handler;  // real handler of the task
+  uint32_t skip_count;       // invocations since the last sampled one
+} itti_latency_task_ctx_t;
+
+/* Sample 1 handled message in N; 0 keeps the instrumentation off */
+static uint32_t itti_latency_sample_rate = 0;
+
+/* Histograms indexed by task_id * MESSAGES_ID_MAX + message_id, allocated
+   only when the instrumentation is enabled */
+static itti_latency_pair_t* itti_latency_table = NULL;
+
+static itti_latency_task_ctx_t itti_latency_task_ctx[TASK_MAX];
+
+/* Sampling state of the handler invocation running on this thread, filled
+   by the interposer and completed by itti_latency_note_receive */
+static __thread bool t_sample_active       = false;
+static __thread MessagesIds t_message_id   = MESSAGES_ID_MAX;
+static __thread long t_queue_wait_us       = 0;
+
+//------------------------------------------------------------------------------
+bool itti_latency_enabled(void) {
+  return itti_latency_sample_rate > 0;
+}
+
+//------------------------------------------------------------------------------
+void itti_latency_init(void) {
+  const char* sample_rate = getenv(ITTI_LATENCY_SAMPLE_RATE_ENV);
+
+  if ((NULL == sample_rate) || (atoi(sample_rate) <= 0)) {
+    return;
+  }
+  itti_latency_table =
+      calloc(TASK_MAX * MESSAGES_ID_MAX, sizeof(itti_latency_pair_t));
+  AssertFatal(
+      itti_latency_table != NULL,
+      "Could not allocate ITTI latency histograms!\n");
+  itti_latency_sample_rate = (uint32_t) atoi(sample_rate);
+}
+
+//------------------------------------------------------------------------------
+void itti_latency_stamp_send(MessageDef* message) {
+  if (0 == itti_latency_sample_rate) {
+    return;
+  }
+  clock_gettime(CLOCK_MONOTONIC_RAW, &message->ittiMsgHeader.timestamp);
+}
+
+//------------------------------------------------------------------------------
+void itti_latency_note_receive(const MessageDef* message) {
+  if (!t_sample_active) {
+    return;
+  }
+  t_message_id    = message->ittiMsgHeader.messageId;
+  t_queue_wait_us = itti_get_message_latency(message->ittiMsgHeader.timestamp);
+}
+
+//------------------------------------------------------------------------------
+static int itti_latency_bucket(long latency_us) {
+  if (latency_us <= 1) {
+    return 0;
+  }
+  int bucket = 64 - __builtin_clzll((uint64_t) latency_us - 1);
+
+  return bucket < ITTI_LATENCY_NUM_BUCKETS ? bucket :
+                                             ITTI_LATENCY_NUM_BUCKETS - 1;
+}
+
+//------------------------------------------------------------------------------
+static void itti_latency_record(
+    task_id_t task_id, MessagesIds message_id, long queue_wait_us,
+    long handler_us) {
+  itti_latency_pair_t* pair =
+      &itti_latency_table[task_id * MESSAGES_ID_MAX + message_id];
+
+  // Only the task thread writes this pair, the exporter reads it from the
+  // service303 thread and tolerates slightly stale counts
+  pair->queue_wait.buckets[itti_latency_bucket(queue_wait_us)]++;
+  pair->handler.buckets[itti_latency_bucket(handler_us)]++;
+}
+
+//------------------------------------------------------------------------------
+int itti_latency_reader_fn(zloop_t* loop, zsock_t* reader, void* arg) {
+  itti_latency_task_ctx_t* ctx = (itti_latency_task_ctx_t*) arg;
+
+  if (++ctx->skip_count < itti_latency_sample_rate) {
+    return ctx->handler(loop, reader, NULL);
+  }
+  ctx->skip_count = 0;
+
+  struct timespec handler_start;
+  struct timespec handler_end;
+
+  t_sample_active = true;
+  t_message_id    = MESSAGES_ID_MAX;
+  clock_gettime(CLOCK_MONOTONIC_RAW, &handler_start);
+  int rc = ctx->handler(loop, reader, NULL);
+  clock_gettime(CLOCK_MONOTONIC_RAW, &handler_end);
+  t_sample_active = false;
+
+  if (t_message_id < MESSAGES_ID_MAX) {
+    long handler_us =
+        1000000 * (handler_end.tv_sec - handler_start.tv_sec) +
+        (handler_end.tv_nsec - handler_start.tv_nsec) / 1000;
+
+    itti_latency_record(ctx->task_id, t_message_id, t_queue_wait_us,
+                        handler_us);
+  }
+  return rc;
+}
+
+//------------------------------------------------------------------------------
+void* itti_latency_make_handler_ctx(
+    task_id_t task_id, zloop_reader_fn* handler) {
+  itti_latency_task_ctx[task_id].task_id = task_id;
+  itti_latency_task_ctx[task_id].handler = handler;
+  return &itti_latency_task_ctx[task_id];
+}
+
+//------------------------------------------------------------------------------
+static void itti_latency_export_hist(
+    itti_latency_stats_cb cb, task_id_t task_id, MessagesIds message_id,
+    const char* stage, const itti_latency_hist_t* hist) {
+  static const struct {
+    const char* name;
+    double fraction;
+  } quantiles[] = {{"p50", 0.50}, {"p99", 0.99}, {"p999", 0.999}};
+
+  uint64_t total = 0;
+
+  for (int b = 0; b < ITTI_LATENCY_NUM_BUCKETS; b++) {
+    total += hist->buckets[b];
+  }
+  if (0 == total) {
+    return;
+  }
+  for (size_t q = 0; q < sizeof(quantiles) / sizeof(quantiles[0]); q++) {
+    uint64_t rank       = (uint64_t)(quantiles[q].fraction * total);
+    uint64_t cumulative = 0;
+    int b               = 0;
+
+    if (rank >= total) {
+      rank = total - 1;
+    }
+    for (; b < ITTI_LATENCY_NUM_BUCKETS; b++) {
+      cumulative += hist->buckets[b];
+      if (cumulative > rank) {
+        break;
+      }
+    }
+    // Report the upper bound of the bucket holding the quantile
+    cb(itti_get_task_name(task_id), itti_get_message_name(message_id), stage,
+       quantiles[q].name, (double) (1ULL << b));
+  }
+}
+
+//------------------------------------------------------------------------------
+void itti_latency_export_stats(itti_latency_stats_cb cb) {
+  if ((0 == itti_latency_sample_rate) || (NULL == cb)) {
+    return;
+  }
+  for (int task_id = TASK_FIRST; task_id < TASK_MAX; task_id++) {
+    for (int message_id = 0; message_id < MESSAGES_ID_MAX; message_id++) {
+      itti_latency_pair_t* pair =
+          &itti_latency_table[task_id * MESSAGES_ID_MAX + message_id];
+
+      itti_latency_export_hist(
+          cb, task_id, message_id, "queue_wait", &pair->queue_wait);
+      itti_latency_export_hist(
+          cb, task_id, message_id, "handler", &pair->handler);
+    }
+  }
+}
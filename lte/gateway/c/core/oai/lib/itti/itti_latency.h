@@ -0,0 +1,85 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file itti_latency.h
+  \brief Sampled latency histograms across ITTI task boundaries
+
+  When enabled, send_msg_to_task stamps a monotonic timestamp into the
+  message header and every task's message handler runs behind a small
+  interposer. For a sampled message the interposer records the queue-wait
+  (send to receive) and the handler duration into power-of-two microsecond
+  bucket histograms kept per (destination task, message id) pair, from
+  which p50/p99/p999 are derived and exported through service303. With
+  MAGMA_ITTI_LATENCY_SAMPLE_RATE unset the interposer is never installed
+  and the send path pays a single predicted branch per message.
+*/
+
+#ifndef ITTI_LATENCY_H_
+#define ITTI_LATENCY_H_
+
+#include <stdbool.h>
+
+#include "intertask_interface.h"
+
+/** \brief Returns true when latency instrumentation has been selected
+ **/
+bool itti_latency_enabled(void);
+
+/** \brief Read MAGMA_ITTI_LATENCY_SAMPLE_RATE (sample 1 message in N, 0 or
+ * unset disables the instrumentation) and allocate the histogram table.
+ * Called from itti_init, before any task context is initialized
+ **/
+void itti_latency_init(void);
+
+/** \brief Stamp the send time of a message into its header. Called by
+ * send_msg_to_task; does nothing when the instrumentation is off
+ **/
+void itti_latency_stamp_send(MessageDef* message);
+
+/** \brief Note the identity and queue-wait of a received message for the
+ * interposer of the current thread. Called by receive_msg; does nothing
+ * unless the current handler invocation is being sampled
+ **/
+void itti_latency_note_receive(const MessageDef* message);
+
+/** \brief Message handler interposer registered by init_task_context in
+ * place of the task handler when the instrumentation is on. arg is the
+ * context returned by itti_latency_make_handler_ctx
+ **/
+int itti_latency_reader_fn(zloop_t* loop, zsock_t* reader, void* arg);
+
+/** \brief Remember the real handler of a task and return the context to
+ * pass to itti_latency_reader_fn for it
+ **/
+void* itti_latency_make_handler_ctx(
+    task_id_t task_id, zloop_reader_fn* handler);
+
+/** \brief Callback receiving one exported quantile: task and message names,
+ * stage ("queue_wait" or "handler"), quantile ("p50", "p99", "p999") and
+ * the latency value in microseconds
+ **/
+typedef void (*itti_latency_stats_cb)(
+    const char* task_name, const char* message_name, const char* stage,
+    const char* quantile, double value_us);
+
+/** \brief Derive p50/p99/p999 of every (task, message) pair that sampled
+ * at least one message and hand them to cb. Called periodically from the
+ * service303 statistics timer
+ **/
+void itti_latency_export_stats(itti_latency_stats_cb cb);
+
+#endif /* ITTI_LATENCY_H_ */
@@ -0,0 +1,140 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "assertions.h"
+#include "intertask_interface.h"
+#include "itti_msg_batch.h"
+#include "memory_pools.h"
+
+// Envelope pool shared by all producer threads; memory_pools is lock free
+static memory_pools_handle_t batch_pools = NULL;
+static uint32_t batch_payload_max        = 0;
+
+/* Batching state is thread local: each producer thread accumulates its own
+ * batch inside its own window and flushes it itself, so no lock is ever
+ * taken between allocating a message and handing the batch over */
+static __thread bool batch_window_open      = false;
+static __thread uint32_t batch_count        = 0;
+static __thread task_id_t batch_destination = TASK_UNKNOWN;
+static __thread MessageDef* batch_msgs[ITTI_MSG_BATCH_MAX_MSGS];
+
+//------------------------------------------------------------------------------
+status_code_e itti_batch_init(uint32_t pool_items, uint32_t max_payload_size) {
+  AssertFatal(batch_pools == NULL, "itti batch pool initialized twice!\n");
+
+  batch_pools = memory_pools_create(1);
+  if (batch_pools == NULL) {
+    return RETURNerror;
+  }
+  if (memory_pools_add_pool(
+          batch_pools, pool_items,
+          sizeof(MessageHeader) + max_payload_size) != 0) {
+    return RETURNerror;
+  }
+  batch_payload_max = max_payload_size;
+  return RETURNok;
+}
+
+//------------------------------------------------------------------------------
+static void itti_batch_flush(task_zmq_ctx_t* task_zmq_ctx_p) {
+  if (batch_count == 0) {
+    return;
+  }
+
+  /* The envelope itself goes through the regular transport and only holds
+   * the message pointers; they stay valid across the zframe copy since all
+   * tasks live in one process */
+  MessageDef* envelope = itti_alloc_new_message(
+      batch_msgs[0]->ittiMsgHeader.originTaskId, ITTI_MSG_BATCH);
+  itti_msg_batch_t* batch = &envelope->ittiMsg.itti_msg_batch;
+  batch->count            = batch_count;
+  memcpy(batch->msgs, batch_msgs, batch_count * sizeof(MessageDef*));
+
+  send_msg_to_task(task_zmq_ctx_p, batch_destination, envelope);
+
+  batch_count       = 0;
+  batch_destination = TASK_UNKNOWN;
+}
+
+//------------------------------------------------------------------------------
+void itti_batch_window_begin(void) {
+  AssertFatal(!batch_window_open, "itti batch windows do not nest!\n");
+  batch_window_open = true;
+}
+
+//------------------------------------------------------------------------------
+void itti_batch_window_end(task_zmq_ctx_t* task_zmq_ctx_p) {
+  AssertFatal(batch_window_open, "itti batch window is not open!\n");
+  itti_batch_flush(task_zmq_ctx_p);
+  batch_window_open = false;
+}
+
+//------------------------------------------------------------------------------
+MessageDef* itti_batch_alloc_msg(
+    task_id_t origin_task_id, MessagesIds message_id) {
+  if (!batch_window_open || (batch_pools == NULL)) {
+    return NULL;
+  }
+
+  uint32_t size = itti_get_message_size(message_id);
+  if (size > batch_payload_max) {
+    return NULL;
+  }
+
+  MessageDef* message = (MessageDef*) memory_pools_allocate(
+      batch_pools, sizeof(MessageHeader) + size, 0, (uint16_t) message_id);
+  if (message == NULL) {
+    // Whole pool in flight; the caller falls back to the regular path
+    return NULL;
+  }
+
+  memset(&message->ittiMsg, 0, size);
+  message->ittiMsgHeader.messageId    = message_id;
+  message->ittiMsgHeader.originTaskId = origin_task_id;
+  message->ittiMsgHeader.ittiMsgSize  = size;
+  message->ittiMsgHeader.imsi         = 0;
+  clock_gettime(CLOCK_MONOTONIC_RAW, &message->ittiMsgHeader.timestamp);
+
+  return message;
+}
+
+//------------------------------------------------------------------------------
+void itti_batch_queue_msg(
+    task_zmq_ctx_t* task_zmq_ctx_p, task_id_t destination_task_id,
+    MessageDef* message) {
+  AssertFatal(
+      batch_window_open, "itti batch queue outside of a batching window!\n");
+
+  if ((batch_count > 0) && (batch_destination != destination_task_id)) {
+    itti_batch_flush(task_zmq_ctx_p);
+  }
+  batch_destination         = destination_task_id;
+  batch_msgs[batch_count++] = message;
+  if (batch_count == ITTI_MSG_BATCH_MAX_MSGS) {
+    itti_batch_flush(task_zmq_ctx_p);
+  }
+}
+
+//------------------------------------------------------------------------------
+void itti_batch_release_msg(MessageDef* message) {
+  memory_pools_free(batch_pools, message, 0);
+}
@@ -0,0 +1,85 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file itti_msg_batch.h
+  \brief Pooled message envelopes and batched delivery for bursty producers
+
+  Bridge for threads that turn external events into ITTI messages in bursts,
+  typically gRPC response pollers: a flood of answers after an HSS reconnect
+  otherwise costs one malloc and one socket write per answer. Messages are
+  allocated from a fixed pool (lib/itti/memory_pools.c) and queued into a
+  thread-local batch; the batch is shipped to the destination task as a
+  single ITTI_MSG_BATCH envelope carrying the message pointers, so the whole
+  burst is one send and one receiver wakeup.
+
+  Pooled messages never travel through send_msg_to_task directly (the
+  regular transport would free() them); they only ride inside a batch
+  envelope, and the receiver returns each one to the pool with
+  itti_batch_release_msg() after handling it. A producer must open a
+  batching window around a burst; outside a window itti_batch_alloc_msg
+  returns NULL and the caller falls back to the regular per-message path, so
+  one-off sends from other threads keep their current behavior.
+*/
+
+#ifndef ITTI_MSG_BATCH_H_
+#define ITTI_MSG_BATCH_H_
+
+#include <stdint.h>
+
+#include "intertask_interface.h"
+
+/** \brief Create the envelope pool. Call once at start-up, before any
+ * batching window is opened
+ * \param pool_items Number of envelopes in the pool; allocation falls back
+ * to the regular path when they are all in flight
+ * \param max_payload_size Largest message payload the pool must carry
+ **/
+status_code_e itti_batch_init(uint32_t pool_items, uint32_t max_payload_size);
+
+/** \brief Open a batching window on the calling thread. Windows do not
+ * nest; every begin must be paired with an itti_batch_window_end
+ **/
+void itti_batch_window_begin(void);
+
+/** \brief Close the calling thread's batching window, flushing any pending
+ * batch to its destination
+ **/
+void itti_batch_window_end(task_zmq_ctx_t* task_zmq_ctx_p);
+
+/** \brief Alloc and memset(0) a pooled message, like itti_alloc_new_message
+ * @returns NULL when no window is open on this thread, the pool is
+ * exhausted or the payload does not fit; the caller must then use the
+ * regular alloc and send path
+ **/
+MessageDef* itti_batch_alloc_msg(
+    task_id_t origin_task_id, MessagesIds message_id);
+
+/** \brief Queue a pooled message for batched delivery. Must be called
+ * inside the window that allocated the message. Flushes by itself when the
+ * batch is full or the destination changes
+ **/
+void itti_batch_queue_msg(
+    task_zmq_ctx_t* task_zmq_ctx_p, task_id_t destination_task_id,
+    MessageDef* message);
+
+/** \brief Return a batched message to the pool. Called by the receiving
+ * task for each entry of an ITTI_MSG_BATCH envelope, after handling it and
+ * freeing its content with itti_free_msg_content
+ **/
+void itti_batch_release_msg(MessageDef* message);
+
+#endif /* ITTI_MSG_BATCH_H_ */
@@ -0,0 +1,218 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include "itti_ring.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "assertions.h"
+
+typedef struct itti_ring_s {
+  MessageDef* slots[ITTI_RING_SLOTS];
+  /* Producer and consumer cursors live on separate cache lines to avoid
+     false sharing: tail is only written by the sender, head only by the
+     receiver. Cursors grow monotonically; slot index is cursor modulo
+     ITTI_RING_SLOTS */
+  uint32_t tail __attribute__((aligned(64)));
+  uint32_t head __attribute__((aligned(64)));
+} itti_ring_t;
+
+/* Priority bands: the normal band carries latency-critical signaling
+   (security mode, context setup, ...), the bulk band carries flood-prone
+   traffic demoted by itti_ring_band_of below */
+typedef enum itti_ring_band_e {
+  ITTI_RING_BAND_NORMAL = 0,
+  ITTI_RING_BAND_BULK,
+  ITTI_RING_BAND_MAX,
+} itti_ring_band_t;
+
+static itti_ring_t* itti_rings[ITTI_RING_BAND_MAX][TASK_MAX][TASK_MAX];
+static int itti_ring_evfds[TASK_MAX];
+/* Round-robin cursor over sender rings, only touched by the dst task */
+static task_id_t itti_ring_next_sender[ITTI_RING_BAND_MAX][TASK_MAX];
+/* Normal-band messages served since the last bulk one, only touched by
+   the dst task */
+static uint32_t itti_ring_normal_streak[TASK_MAX];
+static bool itti_ring_enabled = false;
+
+//------------------------------------------------------------------------------
+static itti_ring_band_t itti_ring_band_of(MessagesIds message_id) {
+  switch (message_id) {
+    /* Paging fan-out: one core-network trigger turns into per-eNB
+       messages, so a tracking area wide page floods the S1AP queue */
+    case S1AP_PAGING_REQUEST:
+    case S1AP_PAGING_REQUEST_BATCH:
+    case NGAP_PAGING_REQUEST:
+    case S11_PAGING_REQUEST:
+    case SGSAP_PAGING_REQUEST:
+    /* Periodic statistics reporting is never latency-sensitive */
+    case APPLICATION_MME_APP_STATS_MSG:
+    case APPLICATION_S1AP_STATS_MSG:
+      return ITTI_RING_BAND_BULK;
+    default:
+      return ITTI_RING_BAND_NORMAL;
+  }
+}
+
+bool itti_ring_transport_enabled(void) {
+  return itti_ring_enabled;
+}
+
+void itti_ring_set_transport_enabled(bool enabled) {
+  itti_ring_enabled = enabled;
+}
+
+void itti_ring_init(void) {
+  for (int i = 0; i < TASK_MAX; i++) {
+    itti_ring_evfds[i] = eventfd(0, EFD_NONBLOCK);
+    AssertFatal(
+        itti_ring_evfds[i] != -1, "Could not create ITTI ring eventfd!\n");
+  }
+}
+
+void itti_ring_create(task_id_t src, task_id_t dst) {
+  for (int band = 0; band < ITTI_RING_BAND_MAX; band++) {
+    if (itti_rings[band][src][dst] != NULL) {
+      continue;
+    }
+
+    itti_ring_t* ring = calloc(1, sizeof(itti_ring_t));
+    AssertFatal(ring != NULL, "ITTI ring memory allocation failed!\n");
+    itti_rings[band][src][dst] = ring;
+  }
+}
+
+bool itti_ring_exists(task_id_t src, task_id_t dst) {
+  return itti_rings[ITTI_RING_BAND_NORMAL][src][dst] != NULL;
+}
+
+void itti_ring_push(task_id_t src, task_id_t dst, MessageDef* message) {
+  itti_ring_band_t band = itti_ring_band_of(message->ittiMsgHeader.messageId);
+  itti_ring_t* ring     = itti_rings[band][src][dst];
+
+  AssertFatal(
+      ring != NULL, "Pushing to task without ring. id: %d to %d!\n", src, dst);
+
+  uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+
+  /* Ring full: wait for the receiver to drain, mirroring how the ZMQ
+     transport blocks at its high-water mark */
+  while (tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) >=
+         ITTI_RING_SLOTS) {
+    usleep(10);
+  }
+
+  ring->slots[tail & (ITTI_RING_SLOTS - 1)] = message;
+  __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_SEQ_CST);
+
+  /* Wake the receiver only on the empty -> non-empty transition. If the
+     receiver was mid-drain it will observe the new tail before sleeping;
+     spurious wakeups are harmless as the poller re-checks the rings */
+  if (__atomic_load_n(&ring->head, __ATOMIC_SEQ_CST) == tail) {
+    uint64_t one = 1;
+    int rc       = write(itti_ring_evfds[dst], &one, sizeof(one));
+    AssertFatal(
+        rc == sizeof(one), "Could not signal ITTI ring eventfd for task %d!\n",
+        dst);
+  }
+}
+
+static MessageDef* itti_ring_pop_band(task_id_t dst, itti_ring_band_t band) {
+  for (int i = 0; i < TASK_MAX; i++) {
+    task_id_t src = (itti_ring_next_sender[band][dst] + i) % TASK_MAX;
+    itti_ring_t* ring = itti_rings[band][src][dst];
+
+    if (ring == NULL) {
+      continue;
+    }
+
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+
+    if (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == head) {
+      continue;
+    }
+
+    MessageDef* message = ring->slots[head & (ITTI_RING_SLOTS - 1)];
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_SEQ_CST);
+    itti_ring_next_sender[band][dst] = (src + 1) % TASK_MAX;
+    return message;
+  }
+
+  return NULL;
+}
+
+MessageDef* itti_ring_pop(task_id_t dst) {
+  MessageDef* message = NULL;
+
+  /* Weighted draining: the normal band goes first, but after
+     ITTI_RING_BULK_INTERVAL normal messages in a row one bulk message is
+     served, so neither band starves while both are backlogged */
+  if (itti_ring_normal_streak[dst] >= ITTI_RING_BULK_INTERVAL) {
+    itti_ring_normal_streak[dst] = 0;
+    message = itti_ring_pop_band(dst, ITTI_RING_BAND_BULK);
+
+    if (message != NULL) {
+      return message;
+    }
+  }
+
+  message = itti_ring_pop_band(dst, ITTI_RING_BAND_NORMAL);
+
+  if (message != NULL) {
+    itti_ring_normal_streak[dst]++;
+    return message;
+  }
+
+  itti_ring_normal_streak[dst] = 0;
+  return itti_ring_pop_band(dst, ITTI_RING_BAND_BULK);
+}
+
+bool itti_ring_pending(task_id_t dst) {
+  for (int band = 0; band < ITTI_RING_BAND_MAX; band++) {
+    for (int src = 0; src < TASK_MAX; src++) {
+      itti_ring_t* ring = itti_rings[band][src][dst];
+
+      if (ring == NULL) {
+        continue;
+      }
+
+      if (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) !=
+          __atomic_load_n(&ring->head, __ATOMIC_RELAXED)) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+int itti_ring_event_fd(task_id_t dst) {
+  return itti_ring_evfds[dst];
+}
+
+void itti_ring_drain_event_fd(task_id_t dst) {
+  uint64_t count;
+
+  /* Non-blocking read clears the accumulated wakeup count; EAGAIN when a
+     previous drain already consumed it is fine */
+  if (read(itti_ring_evfds[dst], &count, sizeof(count)) == -1) {
+    /* nothing to drain */
+  }
+}
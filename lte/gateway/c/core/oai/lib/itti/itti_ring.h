@@ -0,0 +1,107 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file itti_ring.h
+  \brief Lock-free SPSC ring transport for ITTI messages
+
+  Alternative to the ZMQ inproc transport: one single-producer
+  single-consumer ring per sender/receiver task pair carries MessageDef
+  pointers directly, so a send is a slot store plus a cursor update instead
+  of a zframe allocation, a memcpy and a socket write. Receivers are woken
+  through a per-task eventfd that their zloop polls, so the existing task
+  event loops and timers keep working unchanged. Per-pair FIFO ordering is
+  preserved within a band; ordering across different senders was never
+  guaranteed by the ZMQ transport either.
+
+  Messages are carried in two priority bands so that bulk signaling does
+  not queue ahead of latency-critical procedures: paging and statistics
+  messages travel in the bulk band, everything else (security mode,
+  context setup, ...) in the normal band. The receiver drains the normal
+  band first but serves one bulk message for every
+  ITTI_RING_BULK_INTERVAL normal ones, so paging keeps progressing during
+  an attach storm and attach completion stays bounded during a paging
+  flood.
+*/
+
+#ifndef ITTI_RING_H_
+#define ITTI_RING_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "intertask_interface.h"
+
+/* Number of slots per sender/receiver ring; must be a power of two */
+#define ITTI_RING_SLOTS 1024
+
+/* Normal-band messages served between two bulk-band ones while both bands
+   are backlogged */
+#define ITTI_RING_BULK_INTERVAL 8
+
+/** \brief Returns true when the ring transport has been selected
+ **/
+bool itti_ring_transport_enabled(void);
+
+/** \brief Select or deselect the ring transport. Must be called before any
+ * task context is initialized; itti_init does this when the
+ * MAGMA_ITTI_RING_TRANSPORT environment variable is set to 1
+ **/
+void itti_ring_set_transport_enabled(bool enabled);
+
+/** \brief Create the per-task wakeup eventfds. Called from itti_init once
+ * the transport is selected
+ **/
+void itti_ring_init(void);
+
+/** \brief Allocate the rings (one per priority band) carrying messages
+ * from src to dst, if they do not exist yet. Called by the sending task
+ * while initializing its context
+ **/
+void itti_ring_create(task_id_t src, task_id_t dst);
+
+/** \brief Returns true if rings from src to dst have been created
+ **/
+bool itti_ring_exists(task_id_t src, task_id_t dst);
+
+/** \brief Hand a message pointer over to the dst task on the band its
+ * message id maps to. Ownership of the message transfers to the receiver.
+ * Blocks while the ring is full, like the ZMQ transport does at its
+ * high-water mark
+ **/
+void itti_ring_push(task_id_t src, task_id_t dst, MessageDef* message);
+
+/** \brief Pop the next pending message for the dst task, draining sender
+ * rings round-robin with weighted draining across the two bands. Must
+ * only be called from the dst task thread
+ * @returns message pointer, or NULL if all rings are empty
+ **/
+MessageDef* itti_ring_pop(task_id_t dst);
+
+/** \brief Returns true if any sender ring for dst holds a message, on
+ * either band
+ **/
+bool itti_ring_pending(task_id_t dst);
+
+/** \brief Returns the eventfd the dst task polls for wakeups
+ **/
+int itti_ring_event_fd(task_id_t dst);
+
+/** \brief Clear the accumulated wakeup count on the dst task's eventfd
+ **/
+void itti_ring_drain_event_fd(task_id_t dst);
+
+#endif /* ITTI_RING_H_ */
@@ -0,0 +1,167 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include "itti_shed.h"
+
+#include <stdlib.h>
+
+#define ITTI_SHED_HIGH_WATERMARK_ENV "MAGMA_ITTI_SHED_HIGH_WATERMARK"
+#define ITTI_SHED_LOW_WATERMARK_ENV "MAGMA_ITTI_SHED_LOW_WATERMARK"
+
+typedef struct itti_shed_task_state_s {
+  int64_t depth;       // messages sent to and not yet received by the task
+  uint64_t shed;       // messages dropped because the task was shedding
+  bool shedding;       // true from high watermark down to low watermark
+  bool ever_received;  // suppresses export of tasks that never ran
+} itti_shed_task_state_t;
+
+/* Queued messages at which a task starts shedding; 0 keeps shedding off */
+static int64_t itti_shed_high_watermark = 0;
+
+/* Queued messages at which a shedding task accepts sheddable traffic
+   again; the gap provides hysteresis so the decision does not flap */
+static int64_t itti_shed_low_watermark = 0;
+
+static itti_shed_task_state_t itti_shed_tasks[TASK_MAX];
+
+static uint8_t itti_shed_message_class[MESSAGES_ID_MAX];
+
+/* Task whose messages the current thread receives, bound by
+   init_task_context; senders debit nothing through this */
+static __thread task_id_t itti_shed_thread_task_id = TASK_UNKNOWN;
+
+//------------------------------------------------------------------------------
+bool itti_shed_enabled(void) {
+  return itti_shed_high_watermark > 0;
+}
+
+//------------------------------------------------------------------------------
+void itti_shed_init(void) {
+  const char* high = getenv(ITTI_SHED_HIGH_WATERMARK_ENV);
+
+  if ((NULL == high) || (atoll(high) <= 0)) {
+    return;
+  }
+  itti_shed_high_watermark = atoll(high);
+  itti_shed_low_watermark  = itti_shed_high_watermark / 2;
+
+  const char* low = getenv(ITTI_SHED_LOW_WATERMARK_ENV);
+
+  if ((low != NULL) && (atoll(low) > 0) &&
+      (atoll(low) < itti_shed_high_watermark)) {
+    itti_shed_low_watermark = atoll(low);
+  }
+}
+
+//------------------------------------------------------------------------------
+void itti_shed_set_message_class(
+    MessagesIds message_id, itti_shed_class_t cls) {
+  if (message_id < MESSAGES_ID_MAX) {
+    itti_shed_message_class[message_id] = (uint8_t) cls;
+  }
+}
+
+//------------------------------------------------------------------------------
+bool itti_shed_on_send(
+    task_id_t destination_task_id, const MessageDef* message) {
+  if (0 == itti_shed_high_watermark) {
+    return false;
+  }
+
+  itti_shed_task_state_t* state = &itti_shed_tasks[destination_task_id];
+  int64_t depth = __atomic_load_n(&state->depth, __ATOMIC_RELAXED);
+
+  // Hysteresis: shedding engages at the high watermark and only releases
+  // once the backlog has drained below the low one. The flags are advisory
+  // and written racily; an occasional message admitted or shed one depth
+  // off the threshold is harmless
+  if (state->shedding) {
+    if (depth <= itti_shed_low_watermark) {
+      state->shedding = false;
+    }
+  } else if (depth >= itti_shed_high_watermark) {
+    state->shedding = true;
+  }
+
+  if (state->shedding &&
+      (itti_shed_message_class[message->ittiMsgHeader.messageId] ==
+       ITTI_SHED_CLASS_SHEDDABLE)) {
+    __atomic_add_fetch(&state->shed, 1, __ATOMIC_RELAXED);
+    return true;
+  }
+
+  __atomic_add_fetch(&state->depth, 1, __ATOMIC_RELAXED);
+  return false;
+}
+
+//------------------------------------------------------------------------------
+void itti_shed_register_thread(task_id_t task_id) {
+  itti_shed_thread_task_id = task_id;
+}
+
+//------------------------------------------------------------------------------
+void itti_shed_note_receive(void) {
+  if ((0 == itti_shed_high_watermark) ||
+      (TASK_UNKNOWN == itti_shed_thread_task_id)) {
+    return;
+  }
+
+  itti_shed_task_state_t* state = &itti_shed_tasks[itti_shed_thread_task_id];
+
+  __atomic_sub_fetch(&state->depth, 1, __ATOMIC_RELAXED);
+  state->ever_received = true;
+}
+
+//------------------------------------------------------------------------------
+int64_t itti_shed_queue_depth(task_id_t task_id) {
+  if (0 == itti_shed_high_watermark) {
+    return 0;
+  }
+
+  int64_t depth =
+      __atomic_load_n(&itti_shed_tasks[task_id].depth, __ATOMIC_RELAXED);
+
+  return depth > 0 ? depth : 0;
+}
+
+//------------------------------------------------------------------------------
+bool itti_shed_active(task_id_t task_id) {
+  if (0 == itti_shed_high_watermark) {
+    return false;
+  }
+  return itti_shed_tasks[task_id].shedding;
+}
+
+//------------------------------------------------------------------------------
+void itti_shed_export_stats(itti_shed_stats_cb cb) {
+  if (0 == itti_shed_high_watermark) {
+    return;
+  }
+
+  for (task_id_t task_id = TASK_FIRST; task_id < TASK_MAX; task_id++) {
+    itti_shed_task_state_t* state = &itti_shed_tasks[task_id];
+
+    if (!state->ever_received) {
+      continue;
+    }
+
+    int64_t depth = __atomic_load_n(&state->depth, __ATOMIC_RELAXED);
+
+    cb(itti_get_task_name(task_id), depth > 0 ? (double) depth : 0,
+       (double) __atomic_load_n(&state->shed, __ATOMIC_RELAXED));
+  }
+}
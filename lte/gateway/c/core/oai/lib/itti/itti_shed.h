@@ -0,0 +1,104 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file itti_shed.h
+  \brief Per-task queue watermarks with typed overload shedding
+
+  ITTI queues otherwise grow without bound until memory pressure kills the
+  process. When enabled, send_msg_to_task maintains a depth counter per
+  destination task; once a task crosses its high watermark, messages whose
+  id has been registered as sheddable are dropped at the send side (the
+  sender gets RETURNerror and can answer the peer with a cause code) until
+  the depth falls back below the low watermark. Messages not registered as
+  sheddable always pass, so attach completions and other state-carrying
+  signaling survive overload at the cost of deferrable work such as paging.
+  Depths and drop counts are exported through service303. With
+  MAGMA_ITTI_SHED_HIGH_WATERMARK unset the send path pays a single
+  predicted branch per message.
+*/
+
+#ifndef ITTI_SHED_H_
+#define ITTI_SHED_H_
+
+#include <stdbool.h>
+
+#include "intertask_interface.h"
+
+/* How a message id behaves when its destination task is over watermark */
+typedef enum itti_shed_class_e {
+  ITTI_SHED_CLASS_PROTECTED = 0,  // always delivered (default)
+  ITTI_SHED_CLASS_SHEDDABLE,      // dropped while the task is shedding
+} itti_shed_class_t;
+
+/** \brief Returns true when watermark shedding has been selected
+ **/
+bool itti_shed_enabled(void);
+
+/** \brief Read MAGMA_ITTI_SHED_HIGH_WATERMARK (queued messages per task, 0
+ * or unset disables shedding) and MAGMA_ITTI_SHED_LOW_WATERMARK (default
+ * half of high). Called from itti_init, before any task context exists
+ **/
+void itti_shed_init(void);
+
+/** \brief Register the shedding class of a message id; ids not registered
+ * are ITTI_SHED_CLASS_PROTECTED. Call after itti_init, before tasks start
+ **/
+void itti_shed_set_message_class(MessagesIds message_id, itti_shed_class_t cls);
+
+/** \brief Account one message bound for destination_task_id and decide its
+ * fate. Returns true when the message must be shed: the destination is
+ * over watermark and the message id is sheddable. The caller keeps
+ * ownership of the message and must not enqueue it. Called by
+ * send_msg_to_task
+ **/
+bool itti_shed_on_send(task_id_t destination_task_id, const MessageDef* message);
+
+/** \brief Bind the calling thread to task_id so received messages are
+ * debited from the right depth counter. Called by init_task_context on
+ * the task's own thread
+ **/
+void itti_shed_register_thread(task_id_t task_id);
+
+/** \brief Debit one message from the depth of the task bound to the
+ * calling thread. Called by receive_msg
+ **/
+void itti_shed_note_receive(void);
+
+/** \brief Queue depth of task_id as tracked by the shedding counters;
+ * 0 when depth accounting is off
+ **/
+int64_t itti_shed_queue_depth(task_id_t task_id);
+
+/** \brief Returns true while task_id is between its watermarks, so senders
+ * of request/response messages can reject the peer with a cause code
+ * instead of queueing work the task will not get to in time
+ **/
+bool itti_shed_active(task_id_t task_id);
+
+/** \brief Callback receiving the export of one task: its name, current
+ * queue depth and messages shed since start
+ **/
+typedef void (*itti_shed_stats_cb)(
+    const char* task_name, double queue_depth, double shed_total);
+
+/** \brief Hand the depth and drop count of every task that received at
+ * least one message to cb. Called periodically from the service303
+ * statistics timer
+ **/
+void itti_shed_export_stats(itti_shed_stats_cb cb);
+
+#endif /* ITTI_SHED_H_ */
@@ -0,0 +1,176 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#define _GNU_SOURCE
+#include "itti_watchdog.h"
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "backtrace.h"
+#include "itti_shed.h"
+#include "log.h"
+
+#define ITTI_WATCHDOG_STALL_MSEC_ENV "MAGMA_ITTI_WATCHDOG_STALL_MSEC"
+
+/* SIGURG is ignored by default and unused elsewhere in the process, so it
+   can be borrowed to ask the stuck thread for its own stack */
+#define ITTI_WATCHDOG_SIGNAL SIGURG
+
+typedef struct itti_watchdog_task_state_s {
+  uint64_t heartbeat_ms;  // last time the task's zloop was responsive
+  uint64_t stalls;        // stall episodes since start
+  pid_t tid;              // kernel thread id, 0 until the task arms
+  bool reported;          // current stall already logged and signalled
+} itti_watchdog_task_state_t;
+
+/* Handler runtime past which a task counts as stalled; 0 keeps the
+   watchdog off */
+static int64_t itti_watchdog_stall_msec = 0;
+
+static itti_watchdog_task_state_t itti_watchdog_tasks[TASK_MAX];
+
+//------------------------------------------------------------------------------
+static uint64_t itti_watchdog_now_ms(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+  return ((uint64_t) now.tv_sec * 1000) + (now.tv_nsec / 1000000);
+}
+
+//------------------------------------------------------------------------------
+/* Runs on the stalled thread itself, which is the only place its stack
+   can be read without ptrace */
+static void itti_watchdog_dump_handler(int signo) {
+  display_backtrace();
+}
+
+//------------------------------------------------------------------------------
+static int itti_watchdog_heartbeat_fn(zloop_t* loop, int id, void* arg) {
+  itti_watchdog_task_state_t* state =
+      &itti_watchdog_tasks[(task_id_t)(intptr_t) arg];
+
+  __atomic_store_n(
+      &state->heartbeat_ms, itti_watchdog_now_ms(), __ATOMIC_RELAXED);
+  state->reported = false;
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+static void* itti_watchdog_monitor(void* arg) {
+  pthread_setname_np(pthread_self(), "itti_watchdog");
+
+  while (true) {
+    usleep((itti_watchdog_stall_msec * 1000) / 2);
+
+    uint64_t now_ms = itti_watchdog_now_ms();
+
+    for (task_id_t task_id = TASK_FIRST; task_id < TASK_MAX; task_id++) {
+      itti_watchdog_task_state_t* state = &itti_watchdog_tasks[task_id];
+
+      if ((0 == state->tid) || state->reported) {
+        continue;
+      }
+
+      uint64_t age_ms =
+          now_ms - __atomic_load_n(&state->heartbeat_ms, __ATOMIC_RELAXED);
+
+      if (age_ms < (uint64_t) itti_watchdog_stall_msec) {
+        continue;
+      }
+      // Reported once per episode; the heartbeat timer clears the flag
+      // when the loop comes back
+      state->reported = true;
+      state->stalls++;
+      OAILOG_ERROR(
+          LOG_ITTI,
+          "Task %s event loop stalled for %" PRIu64 " ms (queue depth %" PRId64
+          "), requesting its stack\n",
+          itti_get_task_name(task_id), age_ms,
+          itti_shed_queue_depth(task_id));
+      syscall(SYS_tgkill, getpid(), state->tid, ITTI_WATCHDOG_SIGNAL);
+    }
+  }
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+bool itti_watchdog_enabled(void) {
+  return itti_watchdog_stall_msec > 0;
+}
+
+//------------------------------------------------------------------------------
+void itti_watchdog_init(void) {
+  const char* stall = getenv(ITTI_WATCHDOG_STALL_MSEC_ENV);
+
+  if ((NULL == stall) || (atoll(stall) <= 0)) {
+    return;
+  }
+  itti_watchdog_stall_msec = atoll(stall);
+
+  struct sigaction act;
+
+  memset(&act, 0, sizeof(act));
+  act.sa_handler = itti_watchdog_dump_handler;
+  sigaction(ITTI_WATCHDOG_SIGNAL, &act, NULL);
+
+  pthread_t monitor;
+
+  pthread_create(&monitor, NULL, itti_watchdog_monitor, NULL);
+  pthread_detach(monitor);
+}
+
+//------------------------------------------------------------------------------
+void itti_watchdog_arm_loop(task_id_t task_id, zloop_t* loop) {
+  if (!itti_watchdog_enabled()) {
+    return;
+  }
+
+  itti_watchdog_task_state_t* state = &itti_watchdog_tasks[task_id];
+
+  __atomic_store_n(
+      &state->heartbeat_ms, itti_watchdog_now_ms(), __ATOMIC_RELAXED);
+  state->tid = (pid_t) syscall(SYS_gettid);
+
+  // Fires only while the loop is serving handlers and timers; a handler
+  // stuck past the threshold silences it and trips the monitor
+  zloop_timer(
+      loop, itti_watchdog_stall_msec / 2, 0, itti_watchdog_heartbeat_fn,
+      (void*) (intptr_t) task_id);
+}
+
+//------------------------------------------------------------------------------
+void itti_watchdog_export_stats(itti_watchdog_stats_cb cb) {
+  if (!itti_watchdog_enabled()) {
+    return;
+  }
+
+  for (task_id_t task_id = TASK_FIRST; task_id < TASK_MAX; task_id++) {
+    itti_watchdog_task_state_t* state = &itti_watchdog_tasks[task_id];
+
+    if (0 == state->tid) {
+      continue;
+    }
+    cb(itti_get_task_name(task_id), (double) state->stalls);
+  }
+}
@@ -0,0 +1,66 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file itti_watchdog.h
+  \brief Event-loop stall watchdog with stuck-thread stack dumps
+
+  A task stuck in one message handler is otherwise only visible through
+  downstream timeouts. When enabled, every task heartbeats from a timer
+  on its own zloop, so a handler that overruns the stall threshold stops
+  the heartbeat; a monitor thread notices the stale slot, logs the stall
+  together with the task's queue depth and signals the stuck thread,
+  which prints its own stack through the backtrace machinery. Stall
+  counts are exported through service303. With
+  MAGMA_ITTI_WATCHDOG_STALL_MSEC unset no timers are registered and the
+  loops pay no cost.
+*/
+
+#ifndef ITTI_WATCHDOG_H_
+#define ITTI_WATCHDOG_H_
+
+#include <stdbool.h>
+
+#include "intertask_interface.h"
+
+/** \brief Returns true when the watchdog has been selected
+ **/
+bool itti_watchdog_enabled(void);
+
+/** \brief Read MAGMA_ITTI_WATCHDOG_STALL_MSEC (0 or unset disables the
+ * watchdog), install the stack-dump signal handler and start the monitor
+ * thread. Called from itti_init, before any task context is initialized
+ **/
+void itti_watchdog_init(void);
+
+/** \brief Bind the calling thread to task_id and register the heartbeat
+ * timer on its zloop. Called by init_task_context on the task's own
+ * thread; does nothing when the watchdog is off
+ **/
+void itti_watchdog_arm_loop(task_id_t task_id, zloop_t* loop);
+
+/** \brief Callback receiving the export of one task: its name and stall
+ * episodes since start
+ **/
+typedef void (*itti_watchdog_stats_cb)(
+    const char* task_name, double stall_total);
+
+/** \brief Hand the stall count of every armed task to cb. Called
+ * periodically from the service303 statistics timer
+ **/
+void itti_watchdog_export_stats(itti_watchdog_stats_cb cb);
+
+#endif /* ITTI_WATCHDOG_H_ */
@@ -28,6 +28,7 @@
  * policies, either expressed or implied, of the FreeBSD Project.
  */
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/types.h>
@@ -123,7 +124,7 @@ typedef struct memory_pools_s {
 } memory_pools_t;
 
 //------------------------------------------------------------------------------
-static const uint32_t MAX_POOLS_NUMBER      = 20;
+#define MAX_POOLS_NUMBER 20
 static const uint32_t MAX_POOL_ITEMS_NUMBER = 200 * 1000;
 static const uint32_t MAX_POOL_ITEM_SIZE    = 100 * 1000;
 
@@ -141,6 +142,26 @@ static const pool_start_mark_t POOL_START_MARK =
 static const pools_start_mark_t POOLS_START_MARK =
     CHARS_TO_UINT32('P', 'S', 's', 't');
 
+/*------------------------------------------------------------------------------*/
+/*
+ * Per-thread magazine cache: each thread keeps a small stack of free item
+ * indexes per pool, so allocate/free pairs serviced by the same thread never
+ * touch the shared items group and its atomic operations. Items held in a
+ * magazine are counted as allocated by the central pool.
+ */
+#define MAGAZINE_ITEMS_NUMBER 32
+
+typedef struct thread_magazines_s {
+  memory_pools_t* memory_pools;
+  uint32_t counts[MAX_POOLS_NUMBER];
+  items_group_index_t indexes[MAX_POOLS_NUMBER][MAGAZINE_ITEMS_NUMBER];
+} thread_magazines_t;
+
+static __thread thread_magazines_t thread_magazines;
+
+static volatile uint64_t magazines_hits   = 0;
+static volatile uint64_t magazines_misses = 0;
+
 /*------------------------------------------------------------------------------*/
 static inline uint32_t items_group_number_items(items_group_t* items_group) {
   return items_group->number_plus_one - 1;
@@ -256,6 +277,34 @@ static inline int items_group_put_free_item(
   return (EXIT_SUCCESS);
 }
 
+//------------------------------------------------------------------------------
+static void thread_magazines_flush(memory_pools_t* memory_pools) {
+  pool_id_t pool;
+
+  for (pool = 0; pool < memory_pools->pools_defined; pool++) {
+    while (thread_magazines.counts[pool] > 0) {
+      items_group_put_free_item(
+          &memory_pools->pools[pool].items_group_free,
+          thread_magazines.indexes[pool][--thread_magazines.counts[pool]]);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+static inline void thread_magazines_bind(memory_pools_t* memory_pools) {
+  if (thread_magazines.memory_pools != memory_pools) {
+    /*
+     * Thread switched to another pools instance, return cached items to
+     * their owning pools first
+     */
+    if (thread_magazines.memory_pools != NULL) {
+      thread_magazines_flush(thread_magazines.memory_pools);
+    }
+
+    thread_magazines.memory_pools = memory_pools;
+  }
+}
+
 //------------------------------------------------------------------------------
 static inline memory_pools_t* memory_pools_from_handler(
     memory_pools_handle_t memory_pools_handle) {
@@ -368,7 +417,7 @@ char* memory_pools_statistics(memory_pools_handle_t memory_pools_handle) {
   AssertFatal(
       memory_pools != NULL, "Failed to retrieve memory pool for handle %p!\n",
       memory_pools_handle);
-  statistics_len = memory_pools->pools_defined * 200;
+  statistics_len = (memory_pools->pools_defined + 1) * 200;
   statistics     = malloc(statistics_len);
   printed_chars  = snprintf(
       &statistics[0], statistics_len,
@@ -391,9 +440,14 @@ char* memory_pools_statistics(memory_pools_handle_t memory_pools_handle) {
         allocated_pool_memory / (1024));
   }
 
-  printed_chars = snprintf(
+  printed_chars += snprintf(
       &statistics[printed_chars], statistics_len - printed_chars,
       "Pools memory %u Kbytes\n", allocated_pools_memory / (1024));
+  snprintf(
+      &statistics[printed_chars], statistics_len - printed_chars,
+      "Magazines: %" PRIu64 " hits, %" PRIu64
+      " misses (cached items count as allocated)\n",
+      magazines_hits, magazines_misses);
   return (statistics);
 }
 
@@ -513,6 +567,7 @@ memory_pool_item_handle_t memory_pools_allocate(
   AssertError(
       memory_pools != NULL, {},
       "Failed to retrieve memory pool for handle %p!\n", memory_pools_handle);
+  thread_magazines_bind(memory_pools);
 
   for (pool = 0; pool < memory_pools->pools_defined; pool++) {
     if ((memory_pools->pools[pool].item_data_number *
@@ -523,9 +578,23 @@ memory_pool_item_handle_t memory_pools_allocate(
       continue;
     }
 
+    /*
+     * Serve from this thread's magazine when possible, no atomics involved
+     */
+    if (thread_magazines.counts[pool] > 0) {
+      item_index =
+          thread_magazines.indexes[pool][--thread_magazines.counts[pool]];
+      __sync_fetch_and_add(&magazines_hits, 1);
+      break;
+    }
+
     item_index =
         items_group_get_free_item(&memory_pools->pools[pool].items_group_free);
 
+    if (item_index > ITEMS_GROUP_INDEX_INVALID) {
+      __sync_fetch_and_add(&magazines_misses, 1);
+    }
+
     if (item_index <= ITEMS_GROUP_INDEX_INVALID) {
       /*
        * Allocation failed, skip this pool
@@ -647,7 +716,19 @@ int memory_pools_free(
       "%d)!\n",
       memory_pool_item->start.item_status, pool, item_index);
   memory_pool_item->start.item_status = ITEM_STATUS_FREE;
-  result                              = items_group_put_free_item(
+  /*
+   * Cache the item in this thread's magazine when there is room, otherwise
+   * return it to the shared items group
+   */
+  thread_magazines_bind(memory_pools);
+
+  if (thread_magazines.counts[pool] < MAGAZINE_ITEMS_NUMBER) {
+    thread_magazines.indexes[pool][thread_magazines.counts[pool]++] =
+        item_index;
+    return (EXIT_SUCCESS);
+  }
+
+  result = items_group_put_free_item(
       &memory_pools->pools[pool].items_group_free, item_index);
   AssertError(
       result == EXIT_SUCCESS, {},
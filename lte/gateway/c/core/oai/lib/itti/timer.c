@@ -42,80 +42,269 @@
 #include "intertask_interface.h"
 #include "timer.h"
 #include "log.h"
-#include "queue.h"
+#include "bstrlib.h"
+#include "hashtable.h"
 #include "dynamic_memory_check.h"
 #include "assertions.h"
+#include "service303.h"
 #include "timer_messages_types.h"
 
 int timer_handle_signal(siginfo_t* info, task_zmq_ctx_t* task_ctx);
 
+/*
+ * Timers are kept in a hierarchical timing wheel driven by a single periodic
+ * kernel timer (the "tick source"), instead of one kernel timer per logical
+ * timer. Start, stop and expiry handling are all O(1): timers are found by id
+ * through a hashtable and unlinked from their wheel slot through a back
+ * pointer, replacing the former linear scan of a single timer list.
+ *
+ * Level 0 spans WHEEL_SLOTS ticks at WHEEL_TICK_MSEC resolution; each higher
+ * level spans WHEEL_SLOTS times the previous one. With 4 levels of 256 slots
+ * and a 10 msec tick the wheel covers ~4.9 days; later deadlines are parked
+ * in the furthest slot of the top level and re-inserted when it cascades.
+ */
+#define WHEEL_TICK_MSEC 10
+#define WHEEL_LEVELS 4
+#define WHEEL_SLOT_BITS 8
+#define WHEEL_SLOTS (1 << WHEEL_SLOT_BITS)
+#define WHEEL_SLOT_MASK (WHEEL_SLOTS - 1)
+
+#define TIMER_REGISTRY_SIZE 512
+// Refresh the occupancy gauge about once a second (in ticks)
+#define WHEEL_STATS_PERIOD_TICKS (1000 / WHEEL_TICK_MSEC)
+
 struct timer_elm_s {
+  long id;            ///< Unique timer id handed back to the requester
   task_id_t task_id;  ///< Task ID which has requested the timer
   int32_t instance;   ///< Instance of the task which has requested the timer
-  timer_t timer;      ///< Unique timer id
   timer_type_t type;  ///< Timer type
   void*
       timer_arg;  ///< Optional argument that will be passed when timer expires
-  STAILQ_ENTRY(timer_elm_s) entries;  ///< Pointer to next element
+  uint64_t expiry_tick;   ///< Absolute tick at which the timer fires
+  uint64_t period_ticks;  ///< Re-arm interval in ticks (periodic timers only)
+  bool in_wheel;          ///< true while linked into a wheel slot
+  struct timer_elm_s* next;    ///< Next element in the wheel slot
+  struct timer_elm_s** pprev;  ///< Address of the link pointing at us
 };
 
 typedef struct timer_desc_s {
-  STAILQ_HEAD(timer_list_head, timer_elm_s) timer_queue;
+  struct timer_elm_s* wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+  uint64_t current_tick;   ///< Ticks elapsed while the tick source was armed
+  uint32_t wheel_count;    ///< Number of timers currently linked in the wheel
+  hash_table_t* registry;  ///< timer id -> struct timer_elm_s*
+  long next_timer_id;
+  timer_t tick_timer;  ///< The single kernel timer driving the wheel
+  bool tick_armed;
   pthread_mutex_t timer_list_mutex;
-  struct timespec timeout;
 } timer_desc_t;
 
 static timer_desc_t timer_desc;
 
-static int timer_delete_helper(struct timer_elm_s* timer_p);
-static struct timer_elm_s* find_timer(long timer_id);
+// Snapshot of an expired timer, taken under the lock so that the ITTI
+// notification can be sent without holding it
+struct timer_expiry_s {
+  long id;
+  task_id_t task_id;
+  void* timer_arg;
+};
 
-#define TIMER_SEARCH(vAR, tIMERfIELD, tIMERvALUE, tIMERqUEUE)                  \
-  do {                                                                         \
-    STAILQ_FOREACH(vAR, tIMERqUEUE, entries) {                                 \
-      if (((vAR)->tIMERfIELD == tIMERvALUE)) break;                            \
-    }                                                                          \
-  } while (0)
+//------------------------------------------------------------------------------
+static void wheel_unlink(struct timer_elm_s* timer_p) {
+  if (timer_p->next != NULL) {
+    timer_p->next->pprev = timer_p->pprev;
+  }
+  *timer_p->pprev = timer_p->next;
+  timer_p->next     = NULL;
+  timer_p->pprev    = NULL;
+  timer_p->in_wheel = false;
+  timer_desc.wheel_count--;
+}
 
-int timer_handle_signal(siginfo_t* info, task_zmq_ctx_t* task_ctx) {
+//------------------------------------------------------------------------------
+static void wheel_insert(struct timer_elm_s* timer_p) {
+  uint64_t expiry = timer_p->expiry_tick;
+  uint64_t delta;
+  int level = 0;
+  uint32_t slot;
+  struct timer_elm_s** head;
+
+  if (expiry <= timer_desc.current_tick) {
+    // Already due: fire on the next tick
+    expiry = timer_desc.current_tick + 1;
+  }
+  delta = expiry - timer_desc.current_tick;
+
+  if (delta >> (WHEEL_SLOT_BITS * WHEEL_LEVELS)) {
+    // Beyond the wheel horizon: park as far away as possible, the cascade
+    // will re-insert it with the remaining delay
+    expiry =
+        timer_desc.current_tick + (1ULL << (WHEEL_SLOT_BITS * WHEEL_LEVELS)) -
+        1;
+    level = WHEEL_LEVELS - 1;
+  } else {
+    while (level < WHEEL_LEVELS - 1 &&
+           (delta >> (WHEEL_SLOT_BITS * (level + 1))) != 0) {
+      level++;
+    }
+  }
+
+  slot = (uint32_t)((expiry >> (WHEEL_SLOT_BITS * level)) & WHEEL_SLOT_MASK);
+  head = &timer_desc.wheel[level][slot];
+
+  timer_p->next = *head;
+  if (*head != NULL) {
+    (*head)->pprev = &timer_p->next;
+  }
+  *head             = timer_p;
+  timer_p->pprev    = head;
+  timer_p->in_wheel = true;
+  timer_desc.wheel_count++;
+}
+
+//------------------------------------------------------------------------------
+// Arm the tick source while timers are pending, disarm it when the wheel
+// empties so an idle process takes no periodic wakeups
+static void tick_source_update(void) {
+  struct itimerspec its;
+
+  if ((timer_desc.wheel_count > 0) == timer_desc.tick_armed) {
+    return;
+  }
+
+  memset(&its, 0, sizeof(its));
+  if (timer_desc.wheel_count > 0) {
+    its.it_value.tv_nsec    = WHEEL_TICK_MSEC * 1000000;
+    its.it_interval.tv_nsec = WHEEL_TICK_MSEC * 1000000;
+  }
+
+  if (timer_settime(timer_desc.tick_timer, 0, &its, NULL) < 0) {
+    OAILOG_ERROR(
+        LOG_ITTI, "Failed to %s timer tick source: (%s:%d)\n",
+        timer_desc.wheel_count > 0 ? "arm" : "disarm", strerror(errno), errno);
+    return;
+  }
+  timer_desc.tick_armed = (timer_desc.wheel_count > 0);
+}
+
+//------------------------------------------------------------------------------
+// Advance the wheel by one tick, appending expired timers to the expiry
+// snapshot array. Called with the timer list mutex held.
+static int wheel_advance_one_tick(
+    struct timer_expiry_s** expired_pp, int* n_expired_p, int* sz_expired_p) {
   struct timer_elm_s* timer_p;
-  MessageDef* message_p;
-  timer_has_expired_t* timer_expired_p;
-  task_id_t task_id;
+  uint32_t slot;
+  int level;
+
+  timer_desc.current_tick++;
 
   /*
-   * Get back pointer to timer list element
+   * Cascade a slot of each higher level whose digit just rolled over, moving
+   * its timers down to finer-grained levels
    */
-  timer_p = (struct timer_elm_s*) info->si_ptr;
-  // LG: To many traces for msc timer:
-  // TMR_DEBUG("Timer with id 0x%lx has expired", (long)timer_p->timer);
-  task_id = timer_p->task_id;
-  message_p =
-      DEPRECATEDitti_alloc_new_message_fatal(TASK_MAIN, TIMER_HAS_EXPIRED);
-  timer_expired_p           = &message_p->ittiMsg.timer_has_expired;
-  timer_expired_p->timer_id = (long) timer_p->timer;
-  timer_expired_p->arg      = timer_p->timer_arg;
+  for (level = 1; level < WHEEL_LEVELS; level++) {
+    if (timer_desc.current_tick & ((1ULL << (WHEEL_SLOT_BITS * level)) - 1)) {
+      break;
+    }
+    slot = (uint32_t)(
+        (timer_desc.current_tick >> (WHEEL_SLOT_BITS * level)) &
+        WHEEL_SLOT_MASK);
+    while ((timer_p = timer_desc.wheel[level][slot]) != NULL) {
+      wheel_unlink(timer_p);
+      wheel_insert(timer_p);
+    }
+  }
+
+  slot = (uint32_t)(timer_desc.current_tick & WHEEL_SLOT_MASK);
+  while ((timer_p = timer_desc.wheel[0][slot]) != NULL) {
+    wheel_unlink(timer_p);
+
+    if (*n_expired_p >= *sz_expired_p) {
+      int new_sz = *sz_expired_p ? *sz_expired_p * 2 : 8;
+      struct timer_expiry_s* grown =
+          realloc(*expired_pp, new_sz * sizeof(struct timer_expiry_s));
+      if (grown == NULL) {
+        OAILOG_ERROR(LOG_ITTI, "Failed to grow timer expiry snapshot\n");
+        // Re-insert so the timer fires on a later tick instead of being lost
+        timer_p->expiry_tick = timer_desc.current_tick + 1;
+        wheel_insert(timer_p);
+        return -1;
+      }
+      *expired_pp  = grown;
+      *sz_expired_p = new_sz;
+    }
+    (*expired_pp)[*n_expired_p].id        = timer_p->id;
+    (*expired_pp)[*n_expired_p].task_id   = timer_p->task_id;
+    (*expired_pp)[*n_expired_p].timer_arg = timer_p->timer_arg;
+    (*n_expired_p)++;
+
+    if (timer_p->type == TIMER_PERIODIC) {
+      timer_p->expiry_tick += timer_p->period_ticks;
+      wheel_insert(timer_p);
+    }
+    // One-shot timers stay in the registry until timer_handle_expired or
+    // timer_remove, so timer_exists keeps answering true for them
+  }
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+int timer_handle_signal(siginfo_t* info, task_zmq_ctx_t* task_ctx) {
+  struct timer_expiry_s* expired = NULL;
+  int n_expired                  = 0;
+  int sz_expired                 = 0;
+  uint64_t n_ticks               = 1;
+  MessageDef* message_p;
+  timer_has_expired_t* timer_expired_p;
+  int rc = 0;
+  int i;
+
+  // Catch up on ticks the main thread was too busy to service
+  if (info->si_code == SI_TIMER && info->si_overrun > 0) {
+    n_ticks += info->si_overrun;
+  }
+
+  pthread_mutex_lock(&timer_desc.timer_list_mutex);
+  while (n_ticks--) {
+    wheel_advance_one_tick(&expired, &n_expired, &sz_expired);
+  }
+  if ((timer_desc.current_tick % WHEEL_STATS_PERIOD_TICKS) == 0) {
+    set_gauge("itti_timer_wheel_occupancy", timer_desc.wheel_count, NO_LABELS);
+  }
+  tick_source_update();
+  pthread_mutex_unlock(&timer_desc.timer_list_mutex);
 
   /*
-   * Notify task of timer expiry
+   * Notify tasks of timer expiries outside the lock
    */
-  if (send_msg_to_task(task_ctx, task_id, message_p) < 0) {
-    OAILOG_DEBUG(
-        LOG_ITTI, "Failed to send msg TIMER_HAS_EXPIRED to task %u\n", task_id);
-    return -1;
+  for (i = 0; i < n_expired; i++) {
+    message_p =
+        DEPRECATEDitti_alloc_new_message_fatal(TASK_MAIN, TIMER_HAS_EXPIRED);
+    timer_expired_p           = &message_p->ittiMsg.timer_has_expired;
+    timer_expired_p->timer_id = expired[i].id;
+    timer_expired_p->arg      = expired[i].timer_arg;
+
+    if (send_msg_to_task(task_ctx, expired[i].task_id, message_p) < 0) {
+      OAILOG_DEBUG(
+          LOG_ITTI, "Failed to send msg TIMER_HAS_EXPIRED to task %u\n",
+          expired[i].task_id);
+      rc = -1;
+    }
+  }
+  if (n_expired > 0) {
+    increment_counter("itti_timer_wheel_fired", n_expired, NO_LABELS);
   }
 
-  return 0;
+  free(expired);
+  return rc;
 }
 
+//------------------------------------------------------------------------------
 int timer_setup(
     uint32_t interval_sec, uint32_t interval_us, task_id_t task_id,
     int32_t instance, timer_type_t type, void* timer_arg, size_t arg_size,
     long* timer_id) {
-  struct sigevent se;
-  struct itimerspec its;
   struct timer_elm_s* timer_p;
-  timer_t timer;
+  uint64_t interval_ticks;
 
   if (timer_id == NULL) {
     return -1;
@@ -134,8 +323,6 @@ int timer_setup(
     return -1;
   }
 
-  memset(&timer, 0, sizeof(timer_t));
-  memset(&se, 0, sizeof(struct sigevent));
   timer_p->task_id  = task_id;
   timer_p->instance = instance;
   timer_p->type     = type;
@@ -152,98 +339,56 @@ int timer_setup(
   }
 
   /*
-   * Setting up alarm
-   */
-  /*
-   * Set and enable alarm
+   * Round the interval up to whole ticks; a zero interval still fires
+   * on the next tick
    */
-  se.sigev_notify          = SIGEV_SIGNAL;
-  se.sigev_signo           = SIGTIMER;
-  se.sigev_value.sival_ptr = timer_p;
+  interval_ticks = ((uint64_t) interval_sec * 1000 + interval_us / 1000 +
+                    WHEEL_TICK_MSEC - 1) /
+                   WHEEL_TICK_MSEC;
+  if (interval_ticks == 0) {
+    interval_ticks = 1;
+  }
 
-  /*
-   * At the timer creation, the timer structure will be filled in with timer_id,
-   * * * which is unique for this process. This id is allocated by kernel and
-   * the
-   * * * value might be used to distinguish timers.
-   */
-  if (timer_create(CLOCK_REALTIME, &se, &timer) < 0) {
-    OAILOG_ERROR(
-        LOG_ITTI, "Failed to create timer: (%s:%d)\n", strerror(errno), errno);
-    free_wrapper((void**) &timer_p);
-    return -1;
+  pthread_mutex_lock(&timer_desc.timer_list_mutex);
+  timer_p->id = timer_desc.next_timer_id++;
+  if (timer_desc.next_timer_id <= 0) {
+    timer_desc.next_timer_id = 1;
   }
+  timer_p->expiry_tick  = timer_desc.current_tick + interval_ticks;
+  timer_p->period_ticks = interval_ticks;
 
-  /*
-   * Fill in the first expiration value.
-   */
-  its.it_value.tv_sec  = interval_sec;
-  its.it_value.tv_nsec = interval_us * 1000;
-
-  if (type == TIMER_PERIODIC) {
-    /*
-     * Asked for periodic timer. We set the interval time
-     */
-    its.it_interval.tv_sec  = interval_sec;
-    its.it_interval.tv_nsec = interval_us * 1000;
-  } else {
-    /*
-     * Asked for one-shot timer. Do not set the interval field
-     */
-    its.it_interval.tv_sec  = 0;
-    its.it_interval.tv_nsec = 0;
+  if (hashtable_insert(
+          timer_desc.registry, (hash_key_t) timer_p->id, timer_p) !=
+      HASH_TABLE_OK) {
+    pthread_mutex_unlock(&timer_desc.timer_list_mutex);
+    OAILOG_ERROR(LOG_ITTI, "Failed to register timer 0x%lx\n", timer_p->id);
+    free_wrapper(&timer_p->timer_arg);
+    free_wrapper((void**) &timer_p);
+    return -1;
   }
+  wheel_insert(timer_p);
+  tick_source_update();
+  pthread_mutex_unlock(&timer_desc.timer_list_mutex);
 
-  timer_settime(timer, 0, &its, NULL);
   /*
    * Simply set the timer_id argument. so it can be used by caller
    */
-  *timer_id = (long) timer;
+  *timer_id = timer_p->id;
   OAILOG_INFO(
       LOG_ITTI,
       "Requesting new %s timer with id 0x%lx that expires within "
       "%d sec and %d usec\n",
       type == TIMER_PERIODIC ? "periodic" : "single shot", *timer_id,
       interval_sec, interval_us);
-  timer_p->timer = timer;
-  /*
-   * Lock the queue and insert the timer at the tail
-   */
-  pthread_mutex_lock(&timer_desc.timer_list_mutex);
-  STAILQ_INSERT_TAIL(&timer_desc.timer_queue, timer_p, entries);
-  pthread_mutex_unlock(&timer_desc.timer_list_mutex);
   return 0;
 }
 
-// Helper function to delete a timer from queue and cleanup associated resources
-static int timer_delete_helper(struct timer_elm_s* timer_p) {
-  int rc = TIMER_OK;
-  pthread_mutex_lock(&timer_desc.timer_list_mutex);
-  STAILQ_REMOVE(&timer_desc.timer_queue, timer_p, timer_elm_s, entries);
-  pthread_mutex_unlock(&timer_desc.timer_list_mutex);
-
-  if (timer_delete(timer_p->timer) < 0) {
-    OAILOG_ERROR(
-        LOG_ITTI, "Failed to delete timer 0x%lx\n", (long) timer_p->timer);
-    rc = TIMER_ERR;
-  }
-
-  free_wrapper(&timer_p->timer_arg);
-  free_wrapper((void**) &timer_p);
-  timer_p = NULL;
-  return rc;
-}
-
-// Helper function to find a timer in the queue
+// Helper function to look a timer up in the registry. Called with the timer
+// list mutex held.
 static struct timer_elm_s* find_timer(long timer_id) {
   struct timer_elm_s* timer_p = NULL;
-  pthread_mutex_lock(&timer_desc.timer_list_mutex);
-  TIMER_SEARCH(timer_p, timer, ((timer_t) timer_id), &timer_desc.timer_queue);
 
-  if (timer_p == NULL) {
-    OAILOG_ERROR(LOG_ITTI, "Didn't find timer 0x%lx in list\n", timer_id);
-  }
-  pthread_mutex_unlock(&timer_desc.timer_list_mutex);
+  hashtable_get(timer_desc.registry, (hash_key_t) timer_id, (void**) &timer_p);
   return timer_p;
 }
 
@@ -254,17 +399,32 @@ static struct timer_elm_s* find_timer(long timer_id) {
  */
 int timer_handle_expired(long timer_id) {
   OAILOG_INFO(LOG_ITTI, "timer 0x%lx expired \n", timer_id);
-  struct timer_elm_s* timer_p = find_timer(timer_id);
+  struct timer_elm_s* timer_p;
+
+  pthread_mutex_lock(&timer_desc.timer_list_mutex);
+  timer_p = find_timer(timer_id);
   if (timer_p == NULL) {
+    pthread_mutex_unlock(&timer_desc.timer_list_mutex);
+    OAILOG_ERROR(LOG_ITTI, "Didn't find timer 0x%lx in list\n", timer_id);
     return TIMER_NOT_FOUND;
   }
 
   if (timer_p->type == TIMER_ONE_SHOT) {
     OAILOG_INFO(
         LOG_ITTI, "Timer 0x%lx expiry signal received, deleting\n", timer_id);
-    return timer_delete_helper(timer_p);
+    hashtable_remove(
+        timer_desc.registry, (hash_key_t) timer_id, (void**) &timer_p);
+    if (timer_p->in_wheel) {
+      wheel_unlink(timer_p);
+      tick_source_update();
+    }
+    pthread_mutex_unlock(&timer_desc.timer_list_mutex);
+    free_wrapper(&timer_p->timer_arg);
+    free_wrapper((void**) &timer_p);
+    return TIMER_OK;
   }
 
+  pthread_mutex_unlock(&timer_desc.timer_list_mutex);
   OAILOG_INFO(
       LOG_ITTI, "Timer 0x%lx expired but is not one shot, not deleting\n",
       timer_id);
@@ -272,16 +432,24 @@ int timer_handle_expired(long timer_id) {
 }
 
 bool timer_exists(long timer_id) {
-  return find_timer(timer_id) != NULL;
+  bool exists;
+
+  pthread_mutex_lock(&timer_desc.timer_list_mutex);
+  exists = (find_timer(timer_id) != NULL);
+  pthread_mutex_unlock(&timer_desc.timer_list_mutex);
+  if (!exists) {
+    OAILOG_ERROR(LOG_ITTI, "Didn't find timer 0x%lx in list\n", timer_id);
+  }
+  return exists;
 }
 
 int timer_remove(long timer_id, void** arg) {
-  int rc = 0;
-  struct timer_elm_s* timer_p;
+  struct timer_elm_s* timer_p = NULL;
 
   OAILOG_DEBUG(LOG_ITTI, "Removing timer 0x%lx\n", timer_id);
   pthread_mutex_lock(&timer_desc.timer_list_mutex);
-  TIMER_SEARCH(timer_p, timer, ((timer_t) timer_id), &timer_desc.timer_queue);
+  hashtable_remove(
+      timer_desc.registry, (hash_key_t) timer_id, (void**) &timer_p);
 
   /*
    * We didn't find the timer in list
@@ -293,27 +461,47 @@ int timer_remove(long timer_id, void** arg) {
     return -1;
   }
 
-  STAILQ_REMOVE(&timer_desc.timer_queue, timer_p, timer_elm_s, entries);
+  if (timer_p->in_wheel) {
+    wheel_unlink(timer_p);
+    tick_source_update();
+  }
   pthread_mutex_unlock(&timer_desc.timer_list_mutex);
 
   // let user of API get back arg that can be an allocated memory (memory leak).
 
   if (arg) *arg = timer_p->timer_arg;
-  if (timer_delete(timer_p->timer) < 0) {
-    OAILOG_ERROR(
-        LOG_ITTI, "Failed to delete timer 0x%lx\n", (long) timer_p->timer);
-    rc = -1;
-  }
-
   free_wrapper((void**) &timer_p);
-  return rc;
+  return 0;
 }
 
 int timer_init(void) {
+  struct sigevent se;
+
   OAI_FPRINTF_INFO("Initializing TIMER module\n");
   memset(&timer_desc, 0, sizeof(timer_desc_t));
-  STAILQ_INIT(&timer_desc.timer_queue);
+  timer_desc.next_timer_id = 1;
   pthread_mutex_init(&timer_desc.timer_list_mutex, NULL);
+  timer_desc.registry = hashtable_create(
+      TIMER_REGISTRY_SIZE, NULL, NULL, bfromcstr("itti_timer_registry"));
+  if (timer_desc.registry == NULL) {
+    OAILOG_ERROR(LOG_ITTI, "Failed to create timer registry\n");
+    return -1;
+  }
+
+  /*
+   * The tick source is the only kernel timer; it is armed on demand when
+   * the first timer is inserted in the wheel
+   */
+  memset(&se, 0, sizeof(struct sigevent));
+  se.sigev_notify          = SIGEV_SIGNAL;
+  se.sigev_signo           = SIGTIMER;
+  se.sigev_value.sival_ptr = NULL;
+  if (timer_create(CLOCK_REALTIME, &se, &timer_desc.tick_timer) < 0) {
+    OAILOG_ERROR(
+        LOG_ITTI, "Failed to create timer tick source: (%s:%d)\n",
+        strerror(errno), errno);
+    return -1;
+  }
   OAI_FPRINTF_INFO("Initializing TIMER module: DONE\n");
   return 0;
 }
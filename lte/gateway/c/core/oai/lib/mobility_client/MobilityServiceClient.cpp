@@ -57,7 +57,7 @@ int MobilityServiceClient::AllocateIPv4AddressAsync(
 
   request.set_apn(apn);
 
-  AllocateIPAddressRPC(request, callback);
+  EnqueueAllocateIPAddress(request, callback);
   return 0;
 }
 
@@ -73,7 +73,7 @@ int MobilityServiceClient::AllocateIPv6AddressAsync(
 
   request.set_apn(apn);
 
-  AllocateIPAddressRPC(request, callback);
+  EnqueueAllocateIPAddress(request, callback);
   return 0;
 }
 
@@ -89,7 +89,7 @@ int MobilityServiceClient::AllocateIPv4v6AddressAsync(
 
   request.set_apn(apn);
 
-  AllocateIPAddressRPC(request, callback);
+  EnqueueAllocateIPAddress(request, callback);
   return 0;
 }
 
@@ -247,13 +247,77 @@ int MobilityServiceClient::GetSubscriberIDFromIPv4(
   return 0;
 }
 
-void MobilityServiceClient::AllocateIPAddressRPC(
+void MobilityServiceClient::EnqueueAllocateIPAddress(
     const AllocateIPRequest& request,
     const std::function<void(Status, AllocateIPAddressResponse)>& callback) {
-  auto localResp = new AsyncLocalResponse<AllocateIPAddressResponse>(
-      std::move(callback), RESPONSE_TIMEOUT);
-  localResp->set_response_reader(std::move(stub_->AsyncAllocateIPAddress(
-      localResp->get_context(), request, &queue_)));
+  std::vector<PendingAllocation> batch;
+  {
+    std::lock_guard<std::mutex> lock(alloc_batch_mutex_);
+    if (alloc_batch_in_flight_) {
+      pending_allocations_.push_back({request, callback});
+      return;
+    }
+    alloc_batch_in_flight_ = true;
+    batch.push_back({request, callback});
+  }
+  SendAllocateIPAddressBatch(std::move(batch));
+}
+
+void MobilityServiceClient::SendAllocateIPAddressBatch(
+    std::vector<PendingAllocation> batch) {
+  AllocateIPBatchRequest batch_request = AllocateIPBatchRequest();
+  for (const auto& pending : batch) {
+    *batch_request.add_requests() = pending.request;
+  }
+
+  auto shared_batch =
+      std::make_shared<std::vector<PendingAllocation>>(std::move(batch));
+  auto localResp = new AsyncLocalResponse<AllocateIPBatchResponse>(
+      [this, shared_batch](Status status, AllocateIPBatchResponse response) {
+        // Results come back in request order, one per entry
+        for (size_t i = 0; i < shared_batch->size(); i++) {
+          Status item_status = status;
+          AllocateIPAddressResponse item_response;
+          if (status.ok()) {
+            if ((int) i < response.results_size()) {
+              const auto& result = response.results(i);
+              if (result.success()) {
+                item_response = result.response();
+              } else {
+                item_status = Status(
+                    (grpc::StatusCode) result.status_code(),
+                    result.error_details());
+              }
+            } else {
+              item_status = Status(
+                  grpc::StatusCode::INTERNAL,
+                  "Missing result in AllocateIPAddressBatch response");
+            }
+          }
+          (*shared_batch)[i].callback(item_status, item_response);
+        }
+
+        // Ship whatever queued up while this batch was in flight
+        std::vector<PendingAllocation> next_batch;
+        {
+          std::lock_guard<std::mutex> lock(alloc_batch_mutex_);
+          if (pending_allocations_.empty()) {
+            alloc_batch_in_flight_ = false;
+          } else {
+            while (!pending_allocations_.empty() &&
+                   next_batch.size() < ALLOC_BATCH_MAX_SIZE) {
+              next_batch.push_back(std::move(pending_allocations_.front()));
+              pending_allocations_.pop_front();
+            }
+          }
+        }
+        if (!next_batch.empty()) {
+          SendAllocateIPAddressBatch(std::move(next_batch));
+        }
+      },
+      RESPONSE_TIMEOUT);
+  localResp->set_response_reader(std::move(stub_->AsyncAllocateIPAddressBatch(
+      localResp->get_context(), batch_request, &queue_)));
 }
 
 void MobilityServiceClient::ReleaseIPAddressRPC(
@@ -20,9 +20,12 @@
 #include <grpc++/grpc++.h>
 
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "includes/GRPCReceiver.h"
 #include "lte/protos/mobilityd.grpc.pb.h"
@@ -171,18 +174,41 @@ class MobilityServiceClient : public GRPCReceiver {
  private:
   MobilityServiceClient();
   static const uint32_t RESPONSE_TIMEOUT = 10;  // seconds
+  // Upper bound on allocation requests coalesced into one batch RPC
+  static const uint32_t ALLOC_BATCH_MAX_SIZE = 64;
   std::unique_ptr<MobilityService::Stub> stub_{};
 
+  // Allocation request waiting for the in-flight batch RPC to complete
+  struct PendingAllocation {
+    AllocateIPRequest request;
+    std::function<void(grpc::Status, AllocateIPAddressResponse)> callback;
+  };
+
+  std::mutex alloc_batch_mutex_;
+  std::deque<PendingAllocation> pending_allocations_;
+  bool alloc_batch_in_flight_ = false;
+
   /**
-   * Helper function to chain callback for gRPC response
+   * Queues an allocation request for batched dispatch. When no batch RPC
+   * is in flight the request is sent immediately (a batch of one), so the
+   * common idle case pays no extra latency; requests arriving while an
+   * RPC is in flight are coalesced into the next AllocateIPAddressBatch
+   * call, bounding mobilityd round trips under group attach load.
    * @param request AllocateIP gRPC Request proto
    * @param callback std::function that returns Status and actual gRPC response
    */
-  void AllocateIPAddressRPC(
+  void EnqueueAllocateIPAddress(
       const AllocateIPRequest& request,
       const std::function<void(grpc::Status, AllocateIPAddressResponse)>&
           callback);
 
+  /**
+   * Issues one AllocateIPAddressBatch RPC for the given requests and fans
+   * the per-entry results back out to their callbacks in request order.
+   * @param batch allocation requests with their completion callbacks
+   */
+  void SendAllocateIPAddressBatch(std::vector<PendingAllocation> batch);
+
   /**
    * Helper function to chain callback for gRPC response
    * @param request ReleaseIP gRPC Request proto
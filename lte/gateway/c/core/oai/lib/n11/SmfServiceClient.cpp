@@ -118,15 +118,60 @@ int AsyncSmfServiceClient::amf_smf_create_pdu_session_ipv4(
   return 0;
 }
 
+std::string AsyncSmfServiceClient::sm_context_key(
+    const SetSMSessionContext& request) {
+  return request.common_context().sid().id() + ":" +
+         std::to_string(request.rat_specific_context()
+                            .m5gsm_session_context()
+                            .pdu_session_id());
+}
+
 bool AsyncSmfServiceClient::set_smf_session(SetSMSessionContext& request) {
+  std::string key = sm_context_key(request);
+  {
+    std::lock_guard<std::mutex> lock(pending_lock_);
+    auto it = pending_sm_contexts_.find(key);
+    if (it != pending_sm_contexts_.end()) {
+      // A call for this session is in flight: keep only the newest state,
+      // any earlier queued modify is superseded by it
+      it->second.next     = request;
+      it->second.has_next = true;
+      return true;
+    }
+    pending_sm_contexts_[key];  // mark the session in flight
+  }
   SetSMFSessionRPC(
-      request, [](const Status& status, const SmContextVoid& response) {
+      request,
+      [this, key](const Status& status, const SmContextVoid& response) {
         handle_session_context_response(status, response);
+        dispatch_next_sm_context(key);
       });
 
   return true;
 }
 
+void AsyncSmfServiceClient::dispatch_next_sm_context(const std::string& key) {
+  SetSMSessionContext next;
+  {
+    std::lock_guard<std::mutex> lock(pending_lock_);
+    auto it = pending_sm_contexts_.find(key);
+    if (it == pending_sm_contexts_.end()) {
+      return;
+    }
+    if (!it->second.has_next) {
+      pending_sm_contexts_.erase(it);
+      return;
+    }
+    next                = std::move(it->second.next);
+    it->second.has_next = false;
+  }
+  SetSMFSessionRPC(
+      next, [this, key](const Status& status, const SmContextVoid& response) {
+        handle_session_context_response(status, response);
+        dispatch_next_sm_context(key);
+      });
+}
+
 void AsyncSmfServiceClient::SetSMFSessionRPC(
     SetSMSessionContext& request,
     const std::function<void(Status, SmContextVoid)>& callback) {
@@ -20,6 +20,9 @@
 #include <stdint.h>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 
 using grpc::Status;
 using magma::lte::SetSmNotificationContext;
@@ -59,6 +62,20 @@ class AsyncSmfServiceClient : public magma::GRPCReceiver,
       SetSmNotificationContext& notify,
       const std::function<void(Status, SmContextVoid)>& callback);
 
+  // Per-session coalescing of SM context calls: while one call for a
+  // session is in flight only the newest follow-up is kept, so a rapid
+  // modify sequence collapses into the latest-state call once the
+  // in-flight response arrives
+  struct PendingSmContext {
+    bool has_next = false;
+    SetSMSessionContext next;
+  };
+  std::mutex pending_lock_;
+  std::unordered_map<std::string, PendingSmContext> pending_sm_contexts_;
+
+  static std::string sm_context_key(const SetSMSessionContext& request);
+  void dispatch_next_sm_context(const std::string& key);
+
  public:
   static AsyncSmfServiceClient& getInstance();
 
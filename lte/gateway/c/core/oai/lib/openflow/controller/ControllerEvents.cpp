@@ -82,6 +82,11 @@ const uint16_t ErrorEvent::get_error_code() const {
   return error_code_;
 }
 
+FlowStatsReplyEvent::FlowStatsReplyEvent(
+    fluid_base::OFConnection* ofconn, fluid_base::OFHandler& ofhandler,
+    const void* data, const size_t len)
+    : DataEvent(ofconn, ofhandler, data, len, EVENT_FLOW_STATS_REPLY) {}
+
 ExternalEvent::ExternalEvent(const ControllerEventType type)
     : ControllerEvent(NULL, type) {}
 
@@ -401,4 +406,7 @@ const struct in_addr& DeletePagingRuleEvent::get_ue_ip() const {
   return ue_info_.get_ip();
 }
 
+PollFlowStatsEvent::PollFlowStatsEvent()
+    : ExternalEvent(EVENT_POLL_FLOW_STATS) {}
+
 }  // namespace openflow
@@ -41,6 +41,8 @@ enum ControllerEventType {
   EVENT_DELETE_PAGING_RULE,
   EVENT_ADD_GTP_S8_TUNNEL,
   EVENT_DELETE_GTP_S8_TUNNEL,
+  EVENT_FLOW_STATS_REPLY,
+  EVENT_POLL_FLOW_STATS,
 };
 
 /**
@@ -130,6 +132,17 @@ class ErrorEvent : public ControllerEvent {
   const uint16_t error_code_;
 };
 
+/**
+ * Event triggered when the switch answers a flow stats request with one
+ * segment of a multipart reply
+ */
+class FlowStatsReplyEvent : public DataEvent {
+ public:
+  FlowStatsReplyEvent(
+      fluid_base::OFConnection* ofconn, fluid_base::OFHandler& ofhandler,
+      const void* data, const size_t len);
+};
+
 /*
  * Event triggered externally, so it allows for delayed assignment of the
  * openflow connection. This way, the controller can set the latest known
@@ -336,4 +349,13 @@ class DeletePagingRuleEvent : public ExternalEvent {
   const UeNetworkInfo ue_info_;
 };
 
+/*
+ * Event triggered by another thread to refresh the flow stats counters
+ * from the switch
+ */
+class PollFlowStatsEvent : public ExternalEvent {
+ public:
+  PollFlowStatsEvent();
+};
+
 }  // namespace openflow
@@ -15,10 +15,14 @@
  *      contact@openairinterface.org
  */
 
+#include <cstdlib>
+#include <vector>
+
 #include "OpenflowController.h"
 #include "PagingApplication.h"
 #include "BaseApplication.h"
 #include "ControllerMain.h"
+#include "FlowStatsApplication.h"
 #include "GTPApplication.h"
 extern "C" {
 #include "log.h"
@@ -30,10 +34,27 @@ static const int OFP_LOCAL   = 65534;
 static const int OF13P_LOCAL = 0xfffffffe;
 
 namespace {
-openflow::OpenflowController ctrl(
-    CONTROLLER_ADDR, CONTROLLER_PORT, NUM_WORKERS, false);
+// Number of libfluid event-loop workers, each running its own
+// epoll-backed loop. Overridable for deployments with heavier signaling
+int get_num_workers(void) {
+  const char* env = getenv("MAGMA_OF_NUM_WORKERS");
+  if (env != NULL && atoi(env) > 0) {
+    return atoi(env);
+  }
+  return NUM_WORKERS;
 }
 
+openflow::OpenflowController ctrl(
+    CONTROLLER_ADDR, CONTROLLER_PORT, get_num_workers(), false);
+
+// Tracks packet/byte counters for the cookie classes GTPApplication
+// stamps on tunnel flows. At namespace scope so the C accessors below
+// can read snapshots without going through the event loop
+openflow::FlowStatsApplication flow_stats_app(
+    std::vector<uint64_t>{openflow::GTPApplication::UPLINK_COOKIE,
+                          openflow::GTPApplication::DOWNLINK_COOKIE});
+}  // namespace
+
 int start_of_controller(bool persist_state) {
   static openflow::PagingApplication paging_app;
   static openflow::BaseApplication base_app(persist_state);
@@ -68,6 +89,9 @@ int start_of_controller(bool persist_state) {
   ctrl.register_for_event(&gtp_app, openflow::EVENT_DELETE_GTP_S8_TUNNEL);
   ctrl.register_for_event(&gtp_app, openflow::EVENT_DISCARD_DATA_ON_GTP_TUNNEL);
   ctrl.register_for_event(&gtp_app, openflow::EVENT_FORWARD_DATA_ON_GTP_TUNNEL);
+  ctrl.register_for_event(&flow_stats_app, openflow::EVENT_SWITCH_UP);
+  ctrl.register_for_event(&flow_stats_app, openflow::EVENT_POLL_FLOW_STATS);
+  ctrl.register_for_event(&flow_stats_app, openflow::EVENT_FLOW_STATS_REPLY);
   ctrl.start();
   OAILOG_INFO(LOG_GTPV1U, "Started openflow controller\n");
 #define CONNECTION_WAIT_TIME 300
@@ -201,3 +225,28 @@ int openflow_controller_delete_paging_rule(struct in_addr ue_ip) {
   ctrl.inject_external_event(paging_event, external_event_callback);
   OAILOG_FUNC_RETURN(LOG_GTPV1U, RETURNok);
 }
+
+int openflow_controller_poll_flow_stats(void) {
+  auto poll_event = std::make_shared<openflow::PollFlowStatsEvent>();
+  ctrl.inject_external_event(poll_event, external_event_callback);
+  OAILOG_FUNC_RETURN(LOG_GTPV1U, RETURNok);
+}
+
+int openflow_controller_read_flow_stats(
+    struct of_flow_stats* stats, int max_entries) {
+  std::vector<openflow::flow_stats_entry> entries;
+  flow_stats_app.take_snapshot(&entries);
+  int count = 0;
+  for (const auto& entry : entries) {
+    if (count >= max_entries) {
+      break;
+    }
+    stats[count].cookie        = entry.cookie;
+    stats[count].packets       = entry.packets;
+    stats[count].bytes         = entry.bytes;
+    stats[count].delta_packets = entry.delta_packets;
+    stats[count].delta_bytes   = entry.delta_bytes;
+    count++;
+  }
+  return count;
+}
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "gtpv1u.h"
 
 #ifdef __cplusplus
@@ -64,6 +65,31 @@ int openflow_controller_del_gtp_s8_tunnel(
     struct in_addr ue, struct in6_addr* ue_ipv6, uint32_t i_tei,
     struct ip_flow_dl* flow_dl, uint32_t enb_gtp_port, uint32_t pgw_gtp_port);
 
+/*
+ * Per-cookie flow counters as maintained by the flow stats application.
+ * Deltas cover the polls completed since the previous read
+ */
+struct of_flow_stats {
+  uint64_t cookie;
+  uint64_t packets;
+  uint64_t bytes;
+  uint64_t delta_packets;
+  uint64_t delta_bytes;
+};
+
+/*
+ * Ask the switch for fresh flow counters. Returns immediately; the reply
+ * is folded into the counter table as it streams in
+ */
+int openflow_controller_poll_flow_stats(void);
+
+/*
+ * Copy up to max_entries counter entries into stats and reset the
+ * accumulated deltas. Returns the number of entries copied
+ */
+int openflow_controller_read_flow_stats(
+    struct of_flow_stats* stats, int max_entries);
+
 #ifdef __cplusplus
 }
 #endif
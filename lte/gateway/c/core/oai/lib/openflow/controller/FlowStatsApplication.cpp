@@ -0,0 +1,157 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include <netinet/in.h>
+
+#include <fluid/of13msg.hh>
+
+#include "FlowStatsApplication.h"
+extern "C" {
+#include "log.h"
+}
+
+using namespace fluid_msg;
+
+namespace openflow {
+
+FlowStatsApplication::FlowStatsApplication(
+    const std::vector<uint64_t>& tracked_cookies)
+    : outstanding_replies_(0) {
+  table_.reserve(tracked_cookies.size());
+  for (std::size_t i = 0; i < tracked_cookies.size(); i++) {
+    table_slot slot   = {};
+    slot.stats.cookie = tracked_cookies[i];
+    table_.push_back(slot);
+  }
+}
+
+void FlowStatsApplication::take_snapshot(
+    std::vector<flow_stats_entry>* entries_out) {
+  std::lock_guard<std::mutex> lock(table_mutex_);
+  entries_out->clear();
+  entries_out->reserve(table_.size());
+  for (auto& slot : table_) {
+    entries_out->push_back(slot.stats);
+    slot.stats.delta_packets = 0;
+    slot.stats.delta_bytes   = 0;
+  }
+}
+
+void FlowStatsApplication::event_callback(
+    const ControllerEvent& ev, const OpenflowMessenger& messenger) {
+  if (ev.get_type() == EVENT_POLL_FLOW_STATS) {
+    poll_flow_stats(ev, messenger);
+  } else if (ev.get_type() == EVENT_FLOW_STATS_REPLY) {
+    handle_stats_reply(static_cast<const DataEvent&>(ev));
+  } else if (ev.get_type() == EVENT_SWITCH_UP) {
+    // Switch counters restart from zero on a fresh connection
+    std::lock_guard<std::mutex> lock(table_mutex_);
+    for (auto& slot : table_) {
+      slot.stats.packets = 0;
+      slot.stats.bytes   = 0;
+      slot.poll_packets  = 0;
+      slot.poll_bytes    = 0;
+    }
+    outstanding_replies_ = 0;
+  }
+}
+
+void FlowStatsApplication::poll_flow_stats(
+    const ControllerEvent& ev, const OpenflowMessenger& messenger) {
+  {
+    std::lock_guard<std::mutex> lock(table_mutex_);
+    if (outstanding_replies_ > 0) {
+      // A poll is already streaming in; its replies carry counters at
+      // least as fresh as this request would
+      OAILOG_DEBUG(
+          LOG_GTPV1U, "Coalesced flow stats poll into outstanding request\n");
+      return;
+    }
+    outstanding_replies_ = table_.size();
+    for (auto& slot : table_) {
+      slot.poll_packets = 0;
+      slot.poll_bytes   = 0;
+    }
+  }
+  // The slot cookies are immutable after construction, so reading them
+  // outside the lock is fine
+  for (const auto& slot : table_) {
+    of13::MultipartRequestFlow req(
+        0 /* xid */, 0 /* flags */, 0 /* table_id */, of13::OFPP_ANY,
+        of13::OFPG_ANY, slot.stats.cookie, ~static_cast<uint64_t>(0));
+    messenger.send_of_msg(req, ev.get_connection());
+  }
+}
+
+void FlowStatsApplication::handle_stats_reply(const DataEvent& ev) {
+  auto reply_header =
+      reinterpret_cast<const struct of13::ofp_multipart_reply*>(ev.get_data());
+  if (ntohs(reply_header->type) != of13::OFPMP_FLOW) {
+    // Not a flow stats reply; some other multipart request answered
+    return;
+  }
+  bool last_segment =
+      (ntohs(reply_header->flags) & of13::OFPMPF_REPLY_MORE) == 0;
+
+  of13::MultipartReplyFlow reply;
+  reply.unpack(
+      const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(ev.get_data())));
+  std::vector<of13::FlowStats> flow_stats = reply.flow_stats();
+
+  std::lock_guard<std::mutex> lock(table_mutex_);
+  if (outstanding_replies_ == 0) {
+    // Stale segment from before a switch reconnect
+    return;
+  }
+  for (auto& stats : flow_stats) {
+    table_slot* slot = find_slot(stats.cookie());
+    if (slot == NULL) {
+      continue;
+    }
+    slot->poll_packets += stats.packet_count();
+    slot->poll_bytes += stats.byte_count();
+  }
+  if (last_segment) {
+    outstanding_replies_--;
+    if (outstanding_replies_ > 0) {
+      return;
+    }
+    for (auto& slot : table_) {
+      // Totals only move backwards when flows of the class were removed
+      // between polls; skip the delta for that poll rather than underflow
+      if (slot.poll_packets >= slot.stats.packets &&
+          slot.poll_bytes >= slot.stats.bytes) {
+        slot.stats.delta_packets += slot.poll_packets - slot.stats.packets;
+        slot.stats.delta_bytes += slot.poll_bytes - slot.stats.bytes;
+      }
+      slot.stats.packets = slot.poll_packets;
+      slot.stats.bytes   = slot.poll_bytes;
+    }
+  }
+}
+
+FlowStatsApplication::table_slot* FlowStatsApplication::find_slot(
+    uint64_t cookie) {
+  for (auto& slot : table_) {
+    if (slot.stats.cookie == cookie) {
+      return &slot;
+    }
+  }
+  return NULL;
+}
+
+}  // namespace openflow
@@ -0,0 +1,115 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "OpenflowController.h"
+
+namespace openflow {
+
+/**
+ * Counters for one flow cookie class. Installed flows carry a class
+ * cookie (e.g. GTP uplink/downlink), so one entry aggregates all flows
+ * of its class. Deltas accumulate across polls until a snapshot
+ * collects them
+ */
+struct flow_stats_entry {
+  uint64_t cookie;
+  uint64_t packets;
+  uint64_t bytes;
+  uint64_t delta_packets;
+  uint64_t delta_bytes;
+};
+
+/**
+ * FlowStatsApplication keeps per-cookie packet/byte counters current
+ * from cookie-filtered flow stats requests. Reply segments are folded
+ * into a preallocated table as they stream in, so a poll never
+ * materializes the full flow table, and callers read counters through a
+ * cheap snapshot instead of triggering a table dump of their own
+ */
+class FlowStatsApplication : public Application {
+ public:
+  explicit FlowStatsApplication(const std::vector<uint64_t>& tracked_cookies);
+
+  /**
+   * Copies the counter table into entries_out and zeroes the accumulated
+   * deltas, so every delta is reported exactly once
+   *
+   * @param entries_out (out) - filled with one entry per tracked cookie
+   */
+  void take_snapshot(std::vector<flow_stats_entry>* entries_out);
+
+ private:
+  /**
+   * Table slot for one tracked cookie, with scratch totals for the poll
+   * currently streaming in
+   */
+  struct table_slot {
+    flow_stats_entry stats;
+    uint64_t poll_packets;
+    uint64_t poll_bytes;
+  };
+
+  /**
+   * Main callback event required by inherited Application class. Whenever
+   * the controller gets an event like packet in or switch up, it will pass
+   * it to the application here
+   *
+   * @param ev (in) - pointer to some subclass of ControllerEvent that occurred
+   */
+  virtual void event_callback(
+      const ControllerEvent& ev, const OpenflowMessenger& messenger);
+
+  /**
+   * Sends one flow stats request per tracked cookie, filtered on
+   * cookie/cookie_mask so the switch never serializes unrelated flows.
+   * A poll arriving while replies are still streaming in is coalesced
+   * into the outstanding one
+   */
+  void poll_flow_stats(
+      const ControllerEvent& ev, const OpenflowMessenger& messenger);
+
+  /**
+   * Folds one multipart reply segment into the table as it arrives.
+   * Totals accumulate per segment; once the final segment of the last
+   * outstanding request lands, deltas are computed against the previous
+   * poll and the cumulative counters are swapped in
+   *
+   * @param ev (in) - data event carrying the raw multipart reply
+   */
+  void handle_stats_reply(const DataEvent& ev);
+
+  /**
+   * Returns the slot tracking the cookie, or NULL if untracked
+   */
+  table_slot* find_slot(uint64_t cookie);
+
+  // Guards the slot fields and the poll state; held only while folding
+  // one segment or copying the table
+  std::mutex table_mutex_;
+  // One slot per tracked cookie, allocated up front and never resized
+  std::vector<table_slot> table_;
+  // Stats requests whose final reply segment has not arrived yet
+  int outstanding_replies_;
+};
+
+}  // namespace openflow
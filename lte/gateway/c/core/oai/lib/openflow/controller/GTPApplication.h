@@ -35,6 +35,11 @@ class GTPApplication : public Application {
       uint32_t mtr_port_num, uint32_t internal_sampling_port_num,
       uint32_t internal_sampling_fwd_tbl_num, uint32_t uplink_port_num);
 
+  // Cookie classes stamped on every installed tunnel flow, so stats
+  // requests can be filtered on them
+  static const uint64_t UPLINK_COOKIE   = 1;
+  static const uint64_t DOWNLINK_COOKIE = 2;
+
  private:
   /**
    * Main callback event required by inherited Application class. Whenever
@@ -164,7 +169,7 @@ class GTPApplication : public Application {
   /* cookie is added to identify the rules enforced for the flow controller
    * Initialising with 1
    */
-  const uint64_t cookie = 1;
+  const uint64_t cookie = UPLINK_COOKIE;
 
   const uint32_t uplink_port_num_;
 
@@ -31,16 +31,50 @@ namespace openflow {
  * two bits would be 0b10 and the remaining bits would be 1010000000013 << 3
  */
 uint64_t IMSIEncoder::compact_imsi(const std::string& imsi) {
+  // Direct-mapped per-thread cache: all flow operations of a session
+  // (add/discard/forward/delete tunnel) encode the same IMSI, so after
+  // attach the encoding is looked up instead of re-parsed
+  // IMSI strings have at most fifteen digits
+  const size_t max_imsi_len = 15;
+  struct imsi_cache_entry_s {
+    char imsi[max_imsi_len + 1];
+    uint64_t compacted;
+  };
+  const size_t cache_size = 64;
+  static thread_local imsi_cache_entry_s cache[cache_size] = {};
+
+  imsi_cache_entry_s* entry = NULL;
+  if (imsi.length() <= max_imsi_len) {
+    uint32_t hash = 5381;
+    for (size_t i = 0; i < imsi.length(); i++) {
+      hash = hash * 33 + imsi[i];
+    }
+    entry = &cache[hash & (cache_size - 1)];
+    if (strcmp(entry->imsi, imsi.c_str()) == 0) {
+      return entry->compacted;
+    }
+  }
+
+  // Single pass over the digits; IMSIs are digit-only so this matches
+  // the strtoull-based parse without re-scanning the string
   const char* imsi_cstr = imsi.c_str();
   uint32_t pad          = 0;
-  for (; pad < strlen(imsi_cstr); pad++) {
-    if (imsi_cstr[pad] != '0') {
-      break;
-    }
+  while (imsi_cstr[pad] == '0') {
+    pad++;
+  }
+  uint64_t compacted = 0;
+  for (const char* p = imsi_cstr + pad; *p >= '0' && *p <= '9'; p++) {
+    compacted = compacted * 10 + (*p - '0');
+  }
+  compacted = compacted << 2 | (pad & 0x3);
+  compacted = compacted << 1 | 0x1;  // last bit signifies that IMSI is set
+
+  if (entry != NULL) {
+    strncpy(entry->imsi, imsi_cstr, max_imsi_len);
+    entry->imsi[max_imsi_len] = '\0';
+    entry->compacted          = compacted;
   }
-  uint64_t compacted = strtoull(imsi_cstr + pad, NULL, 10);
-  compacted          = compacted << 2 | (pad & 0x3);
-  return compacted << 1 | 0x1;  // last bit signifies that IMSI is set
+  return compacted;
 }
 
 /**
@@ -15,6 +15,7 @@
  *      contact@openairinterface.org
  */
 
+#include <cinttypes>
 #include <thread>
 #include <mutex>
 #include <chrono>
@@ -32,6 +33,12 @@ using namespace fluid_msg;
 std::condition_variable cv;
 std::mutex cv_mutex;
 
+namespace {
+// Packet-ins beyond this backlog are shed so a flood can never grow the
+// queue without bound
+const size_t MAX_PENDING_PACKET_INS = 1024;
+}  // namespace
+
 namespace openflow {
 
 OpenflowController::OpenflowController(
@@ -44,7 +51,11 @@ OpenflowController::OpenflowController(
               .use_hello_elements(true)          // bitmask version negotiation
               .keep_data_ownership(false)),
       running_(true),
-      messenger_(messenger) {}
+      messenger_(messenger),
+      dropped_packet_ins_(0) {
+  packet_in_worker_ =
+      std::thread(&OpenflowController::packet_in_worker_loop, this);
+}
 
 OpenflowController::OpenflowController(
     const char* address, const int port, const int n_workers, bool secure)
@@ -57,16 +68,54 @@ void OpenflowController::register_for_event(
   event_listeners[event_type].push_back(app);
 }
 
+OpenflowController::~OpenflowController() {
+  stop_packet_in_worker();
+}
+
 void OpenflowController::stop() {
-  running_ = false;
+  stop_packet_in_worker();
   OFServer::stop();
 }
 
+void OpenflowController::stop_packet_in_worker() {
+  {
+    std::lock_guard<std::mutex> lck(packet_in_mutex_);
+    running_ = false;
+  }
+  packet_in_cv_.notify_all();
+  if (packet_in_worker_.joinable()) {
+    packet_in_worker_.join();
+  }
+}
+
 void OpenflowController::message_callback(
     OFConnection* ofconn, uint8_t type, void* data, size_t len) {
   if (type == OFPT_PACKET_IN_TYPE) {
+    if (not running_) {
+      throw std::runtime_error(
+          "Openflow controller needs to be running before handling an "
+          "event\n");
+    }
     OAILOG_DEBUG(LOG_GTPV1U, "Openflow controller got packet-in message\n");
-    dispatch_event(PacketInEvent(ofconn, *this, data, len));
+    // Hand off to the packet-in worker so a burst of packet-ins never
+    // blocks this event loop, which also programs tunnels
+    auto packet_in = std::make_shared<PacketInEvent>(ofconn, *this, data, len);
+    {
+      std::lock_guard<std::mutex> lck(packet_in_mutex_);
+      if (packet_in_queue_.size() >= MAX_PENDING_PACKET_INS) {
+        dropped_packet_ins_++;
+        if ((dropped_packet_ins_ % 1000) == 1) {
+          OAILOG_WARNING(
+              LOG_GTPV1U,
+              "Packet-in queue full, dropped %" PRIu64
+              " packet-in messages so far\n",
+              dropped_packet_ins_);
+        }
+        return;
+      }
+      packet_in_queue_.push(packet_in);
+    }
+    packet_in_cv_.notify_one();
   } else if (type == OFPT_FEATURES_REPLY_TYPE) {
     OAILOG_INFO(LOG_GTPV1U, "Openflow controller connected to switch \n");
     // Save OF connection for external events
@@ -78,6 +127,8 @@ void OpenflowController::message_callback(
         "Send signal that Controller is connected to switch to all waiting "
         "threads \n");
     dispatch_event(SwitchUpEvent(ofconn, *this, data, len));
+  } else if (type == OFPT_MULTIPART_REPLY_TYPE) {
+    dispatch_event(FlowStatsReplyEvent(ofconn, *this, data, len));
   } else if (type == OFPT_ERROR) {
     dispatch_event(
         ErrorEvent(ofconn, reinterpret_cast<struct ofp_error_msg*>(data)));
@@ -100,9 +151,35 @@ void OpenflowController::dispatch_event(const ControllerEvent& ev) {
     return;
   }
   std::vector<Application*> listeners = event_listeners[ev.get_type()];
+  // Coalesce the flow mods every listener sends for this event into one
+  // write, so tunnel churn doesn't pay a syscall per message
+  messenger_->begin_batch();
   for (auto it = listeners.begin(); it != listeners.end(); it++) {
     ((Application*) (*it))->event_callback(ev, *messenger_);
   }
+  messenger_->flush_batch(ev.get_connection());
+}
+
+void OpenflowController::packet_in_worker_loop() {
+  while (true) {
+    std::shared_ptr<PacketInEvent> packet_in;
+    {
+      std::unique_lock<std::mutex> lck(packet_in_mutex_);
+      packet_in_cv_.wait(
+          lck, [this] { return !packet_in_queue_.empty() || !running_; });
+      if (!running_) {
+        return;
+      }
+      packet_in = packet_in_queue_.front();
+      packet_in_queue_.pop();
+    }
+    try {
+      dispatch_event(*packet_in);
+    } catch (const std::runtime_error& e) {
+      // Controller stopped between dequeue and dispatch
+      return;
+    }
+  }
 }
 
 void OpenflowController::inject_external_event(
@@ -18,8 +18,12 @@
 #pragma once
 
 #include <unordered_map>
+#include <condition_variable>
 #include <list>
 #include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
 
 #include <fluid/OFServer.hh>
 
@@ -39,9 +43,10 @@ class Application {
 };
 
 enum OF_MESSAGE_TYPES {
-  OFPT_ERROR               = 1,
-  OFPT_FEATURES_REPLY_TYPE = 6,
-  OFPT_PACKET_IN_TYPE      = 10
+  OFPT_ERROR                = 1,
+  OFPT_FEATURES_REPLY_TYPE  = 6,
+  OFPT_PACKET_IN_TYPE       = 10,
+  OFPT_MULTIPART_REPLY_TYPE = 19
 };
 
 class OpenflowController : public fluid_base::OFServer {
@@ -60,6 +65,8 @@ class OpenflowController : public fluid_base::OFServer {
       const char* address, const int port, const int n_workers, bool secure,
       std::shared_ptr<OpenflowMessenger> messenger);
 
+  ~OpenflowController();
+
   /**
    * Remove all table 0 flows on connection. Right now, all applications
    * modify table 0, so this method is owned by the controller and not the app
@@ -120,10 +127,27 @@ class OpenflowController : public fluid_base::OFServer {
   status_code_e is_controller_connected_to_switch(int conn_timeout);
 
  private:
+  /**
+   * Dispatch loop of the packet-in worker thread. Packet-ins are handed
+   * off from the connection's event loop so bursts of them never delay
+   * tunnel programming; a single worker keeps them ordered per switch
+   */
+  void packet_in_worker_loop();
+
+  /**
+   * Shut down and join the packet-in worker thread; safe to call twice
+   */
+  void stop_packet_in_worker();
+
   std::shared_ptr<OpenflowMessenger> messenger_;
   std::unordered_map<uint32_t, std::vector<Application*>> event_listeners;
   bool running_;
   fluid_base::OFConnection* latest_ofconn_;
+  std::thread packet_in_worker_;
+  std::mutex packet_in_mutex_;
+  std::condition_variable packet_in_cv_;
+  std::queue<std::shared_ptr<PacketInEvent>> packet_in_queue_;
+  uint64_t dropped_packet_ins_;
 };
 
 }  // namespace openflow
@@ -17,6 +17,18 @@
 
 #include "OpenflowMessenger.h"
 
+#include <vector>
+
+namespace {
+// Per-thread batch state: the controller dispatches events from several
+// worker threads, so each thread coalesces only the messages it sends.
+// The buffer keeps its capacity across flushes, so steady-state batching
+// does not allocate
+thread_local std::vector<uint8_t> t_batch_buffer;
+thread_local bool t_batching         = false;
+thread_local size_t t_batch_msg_count = 0;
+}  // namespace
+
 namespace openflow {
 
 fluid_msg::of13::FlowMod DefaultMessenger::create_default_flow_mod(
@@ -43,9 +55,45 @@ void DefaultMessenger::send_of_msg(
     fluid_msg::OFMsg& of_msg, fluid_base::OFConnection* ofconn) const {
   uint8_t* buffer;
   buffer = of_msg.pack();
-  ofconn->send(buffer, of_msg.length());
+  if (t_batching) {
+    t_batch_buffer.insert(
+        t_batch_buffer.end(), buffer, buffer + of_msg.length());
+    t_batch_msg_count++;
+  } else {
+    ofconn->send(buffer, of_msg.length());
+  }
   // TODO OF_ERROR_HANDLING - check if OF message successfully installed
   fluid_msg::OFMsg::free_buffer(buffer);
 }
 
+void DefaultMessenger::begin_batch() const {
+  t_batching        = true;
+  t_batch_msg_count = 0;
+  t_batch_buffer.clear();
+}
+
+void DefaultMessenger::flush_batch(fluid_base::OFConnection* ofconn) const {
+  t_batching = false;
+  if (t_batch_msg_count == 0) {
+    return;
+  }
+  if (ofconn == NULL) {
+    t_batch_buffer.clear();
+    return;
+  }
+  if (t_batch_msg_count > 1) {
+    // A single barrier after the burst forces the switch to finish the
+    // whole batch before processing later messages
+    fluid_msg::of13::BarrierRequest barrier;
+    barrier.xid(1);  // Transaction id, can be anything
+    uint8_t* buffer = barrier.pack();
+    t_batch_buffer.insert(
+        t_batch_buffer.end(), buffer, buffer + barrier.length());
+    fluid_msg::OFMsg::free_buffer(buffer);
+  }
+  // OFConnection::send copies the data, so the buffer can be reused
+  ofconn->send(t_batch_buffer.data(), t_batch_buffer.size());
+  t_batch_buffer.clear();
+}
+
 }  // namespace openflow
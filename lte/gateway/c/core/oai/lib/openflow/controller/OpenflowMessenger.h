@@ -47,6 +47,23 @@ class OpenflowMessenger {
    */
   virtual void send_of_msg(
       fluid_msg::OFMsg& of_msg, fluid_base::OFConnection* ofconn) const {}
+
+  /**
+   * Start coalescing messages sent on this thread. Until flush_batch,
+   * send_of_msg packs into one contiguous buffer instead of writing each
+   * message to the connection separately
+   */
+  virtual void begin_batch() const {}
+
+  /**
+   * Write the coalesced messages of this thread back-to-back in a single
+   * send, followed by one barrier request when more than one message was
+   * batched, so a burst of flow mods reaches the switch at line rate
+   *
+   * @param ofconn - the connection to send the batch to; a null
+   * connection discards the batch
+   */
+  virtual void flush_batch(fluid_base::OFConnection* ofconn) const {}
 };
 
 /**
@@ -60,6 +77,10 @@ class DefaultMessenger : public OpenflowMessenger {
 
   void send_of_msg(
       fluid_msg::OFMsg& of_msg, fluid_base::OFConnection* ofconn) const;
+
+  void begin_batch() const;
+
+  void flush_batch(fluid_base::OFConnection* ofconn) const;
 };
 
 }  // namespace openflow
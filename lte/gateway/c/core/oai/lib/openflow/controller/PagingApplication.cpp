@@ -65,6 +65,12 @@ void PagingApplication::handle_paging_message(
   struct in_addr dest_ip;
   memcpy(&dest_ip, &ip_header->ip_dst, sizeof(struct in_addr));
   char* dest_ip_str = inet_ntoa(dest_ip);
+  if (!register_paging_attempt(dest_ip.s_addr)) {
+    OAILOG_DEBUG(
+        LOG_GTPV1U, "Paging procedure already pending for IP %s\n",
+        dest_ip_str);
+    return;
+  }
   OAILOG_DEBUG(
       LOG_GTPV1U, "Initiating paging procedure for IP %s\n", dest_ip_str);
   sgw_send_paging_request(&dest_ip);
@@ -90,6 +96,39 @@ void PagingApplication::handle_paging_message(
   return;
 }
 
+bool PagingApplication::register_paging_attempt(uint32_t ue_ip) {
+  const auto now = std::chrono::steady_clock::now();
+  const auto clamping_window = std::chrono::seconds(CLAMPING_TIMEOUT);
+
+  auto it = paged_ues_.find(ue_ip);
+  if (it != paged_ues_.end()) {
+    if (now - it->second.first < clamping_window) {
+      return false;
+    }
+    paged_ue_order_.erase(it->second.second);
+    paged_ues_.erase(it);
+  }
+  // All entries share one timeout, so the front of the list expires first
+  while (!paged_ue_order_.empty()) {
+    auto oldest = paged_ues_.find(paged_ue_order_.front());
+    if (now - oldest->second.first < clamping_window) {
+      break;
+    }
+    paged_ues_.erase(oldest);
+    paged_ue_order_.pop_front();
+  }
+  // Drop the oldest pending entry under pressure; its clamping flow stays
+  // installed in OVS, this only allows a fresh paging request sooner
+  if (paged_ues_.size() >= MAX_TRACKED_PAGED_UES) {
+    paged_ues_.erase(paged_ue_order_.front());
+    paged_ue_order_.pop_front();
+  }
+  paged_ue_order_.push_back(ue_ip);
+  paged_ues_.emplace(
+      ue_ip, std::make_pair(now, std::prev(paged_ue_order_.end())));
+  return true;
+}
+
 void PagingApplication::add_paging_flow(
     const AddPagingRuleEvent& ev, const OpenflowMessenger& messenger) {
   of13::FlowMod fm =
@@ -143,6 +182,12 @@ void PagingApplication::delete_paging_flow(
   fm.add_instruction(inst);
 
   messenger.send_of_msg(fm, ev.get_connection());
+  // Paging finished for this UE, stop deduplicating its paging attempts
+  auto it = paged_ues_.find(ue_ip.s_addr);
+  if (it != paged_ues_.end()) {
+    paged_ue_order_.erase(it->second.second);
+    paged_ues_.erase(it);
+  }
   // Convert to string for logging
   char* ip_str = inet_ntoa(ue_ip);
   OAILOG_INFO(LOG_GTPV1U, "Deleted paging flow rule for UE IP %s\n", ip_str);
@@ -17,6 +17,12 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
 #include "OpenflowController.h"
 
 namespace openflow {
@@ -27,6 +33,9 @@ class PagingApplication : public Application {
   static const int MID_PRIORITY = 5;
   // TODO: move to config file
   static const int CLAMPING_TIMEOUT = 30;  // seconds
+  // Upper bound on UEs tracked as recently paged; oldest entries are
+  // dropped first when a downlink burst pages more UEs than this
+  static const size_t MAX_TRACKED_PAGED_UES = 1024;
   /**
    * Main callback event required by inherited Application class. Whenever
    * the controller gets an event like packet in or switch up, it will pass
@@ -61,6 +70,29 @@ class PagingApplication : public Application {
    */
   void delete_paging_flow(
       const DeletePagingRuleEvent& ev, const OpenflowMessenger& messenger);
+
+  /**
+   * Records a paging attempt for the UE IP and reports whether a paging
+   * request should actually be sent. Packets already in flight towards the
+   * controller keep arriving until the clamping flow is installed, and a
+   * broadcast-like downlink event hits many UEs at once; this bounded
+   * table deduplicates those packet-in messages in userspace so each UE
+   * triggers at most one paging request and one clamping flow per
+   * CLAMPING_TIMEOUT window
+   *
+   * @param ue_ip (in) - destination UE IP in network byte order
+   * @return true if no paging attempt is pending for this UE
+   */
+  bool register_paging_attempt(uint32_t ue_ip);
+
+  // Recently paged UEs in insertion order, oldest at the front
+  std::list<uint32_t> paged_ue_order_;
+  // UE IP to paging attempt time and position in paged_ue_order_
+  std::unordered_map<
+      uint32_t, std::pair<
+                    std::chrono::steady_clock::time_point,
+                    std::list<uint32_t>::iterator>>
+      paged_ues_;
 };
 
 }  // namespace openflow
@@ -16,8 +16,11 @@
  */
 
 #include <grpcpp/impl/codegen/status.h>
+#include <cstdio>
 #include <cstring>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <conversions.h>
 #include <common_defs.h>
 
@@ -43,13 +46,72 @@ extern task_zmq_ctx_t grpc_service_task_zmq_ctx;
 
 #define ULI_DATA_SIZE 13
 
+// Most attaches on a given APN share the serving PLMN, SGW address and QoS
+// profile, so the invariant part of the create session request is built once
+// per profile and cached. The per-attach path copies the cached message and
+// patches only the subscriber-specific fields.
+#define SESSION_REQ_TEMPLATE_CACHE_MAX 64
+
+static std::mutex session_req_template_lock;
+static std::unordered_map<std::string, magma::LocalCreateSessionRequest>
+    session_req_templates;
+
+static std::string session_req_template_key(
+    const struct pcef_create_session_data* session_data) {
+  char key[APN_MAX_LENGTH + INET_ADDRSTRLEN + 64];
+  snprintf(
+      key, sizeof(key), "%s|%s|%s|%u|%u|%u|%u|%u|%u", session_data->apn,
+      session_data->mcc_mnc, session_data->sgw_ip, session_data->qci,
+      session_data->pl, session_data->pci, session_data->pvi,
+      session_data->ambr_dl, session_data->ambr_ul);
+  return std::string(key);
+}
+
+static void pcef_fill_session_req_template(
+    const struct pcef_create_session_data* session_data,
+    magma::LocalCreateSessionRequest* tmpl) {
+  auto common_context = tmpl->mutable_common_context();
+  common_context->set_apn(session_data->apn);
+  common_context->set_rat_type(magma::RATType::TGPP_LTE);
+
+  auto lte_context =
+      tmpl->mutable_rat_specific_context()->mutable_lte_context();
+  lte_context->set_spgw_ipv4(session_data->sgw_ip);
+  lte_context->set_plmn_id(session_data->mcc_mnc, session_data->mcc_mnc_len);
+
+  auto qos_info = lte_context->mutable_qos_info();
+  qos_info->set_apn_ambr_dl(session_data->ambr_dl);
+  qos_info->set_apn_ambr_ul(session_data->ambr_ul);
+  qos_info->set_priority_level(session_data->pl);
+  qos_info->set_preemption_capability(session_data->pci);
+  qos_info->set_preemption_vulnerability(session_data->pvi);
+  qos_info->set_qos_class_id(session_data->qci);
+}
+
 // TODO Clean up pcef_create_session_data structure to include
 // imsi/ip/bearer_id etc.
 static void pcef_fill_create_session_req(
     std::string& imsi, std::string& ip4, std::string& ip6, ebi_t eps_bearer_id,
     const struct pcef_create_session_data* session_data,
     magma::LocalCreateSessionRequest* sreq) {
-  // Common Context
+  // Start from the cached profile-invariant template
+  {
+    const std::string key = session_req_template_key(session_data);
+    std::lock_guard<std::mutex> lock(session_req_template_lock);
+    auto it = session_req_templates.find(key);
+    if (it == session_req_templates.end()) {
+      if (session_req_templates.size() >= SESSION_REQ_TEMPLATE_CACHE_MAX) {
+        session_req_templates.clear();
+      }
+      it = session_req_templates
+               .emplace(key, magma::LocalCreateSessionRequest())
+               .first;
+      pcef_fill_session_req_template(session_data, &it->second);
+    }
+    sreq->CopyFrom(it->second);
+  }
+
+  // Subscriber-specific fields
   auto common_context = sreq->mutable_common_context();
   common_context->mutable_sid()->set_id("IMSI" + imsi);
   if (!ip4.empty()) {
@@ -58,16 +120,11 @@ static void pcef_fill_create_session_req(
   if (!ip6.empty()) {
     common_context->set_ue_ipv6(ip6);
   }
-  common_context->set_apn(session_data->apn);
   common_context->set_msisdn(session_data->msisdn, session_data->msisdn_len);
-  common_context->set_rat_type(magma::RATType::TGPP_LTE);
 
-  // LTE Context
   auto lte_context =
       sreq->mutable_rat_specific_context()->mutable_lte_context();
   lte_context->set_bearer_id(eps_bearer_id);
-  lte_context->set_spgw_ipv4(session_data->sgw_ip);
-  lte_context->set_plmn_id(session_data->mcc_mnc, session_data->mcc_mnc_len);
   lte_context->set_imsi_plmn_id(
       session_data->imsi_mcc_mnc, session_data->imsi_mcc_mnc_len);
   auto cc = session_data->charging_characteristics;
@@ -82,16 +139,6 @@ static void pcef_fill_create_session_req(
     OAILOG_DEBUG(LOG_SPGW_APP, "Sending ULI to PCEF");
     lte_context->set_user_location(session_data->uli, ULI_DATA_SIZE);
   }
-
-  // QoS Info
-  magma::QosInformationRequest qos_info;
-  qos_info.set_apn_ambr_dl(session_data->ambr_dl);
-  qos_info.set_apn_ambr_ul(session_data->ambr_ul);
-  qos_info.set_priority_level(session_data->pl);
-  qos_info.set_preemption_capability(session_data->pci);
-  qos_info.set_preemption_vulnerability(session_data->pvi);
-  qos_info.set_qos_class_id(session_data->qci);
-  lte_context->mutable_qos_info()->CopyFrom(qos_info);
 }
 
 /**
@@ -24,8 +24,18 @@
 #include "spgw_types.h"
 #include "common_types.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "intertask_interface.h"
+#ifdef __cplusplus
+}
+#endif
+
 #include "PipelinedServiceClient.h"
 
+extern task_zmq_ctx_t grpc_service_task_zmq_ctx;
+
 using grpc::Channel;
 using grpc::ChannelCredentials;
 using grpc::CreateChannel;
@@ -169,6 +179,36 @@ int upf_classifier_delete_paging_rule(struct in_addr ue) {
   return RETURNok;
 }
 
+/**
+ * Deliver a failed dataplane programming completion into the SPGW task, so
+ * the failure is processed in order with the rest of the bearer work instead
+ * of only being logged on the gRPC completion thread.
+ */
+static void send_upf_classifier_response_to_spgw(
+    const UESessionContextResponse& response) {
+  MessageDef* message_p =
+      itti_alloc_new_message(TASK_GRPC_SERVICE, UPF_CLASSIFIER_RESPONSE);
+  if (!message_p) {
+    OAILOG_ERROR(
+        LOG_UTIL, "Message UPF Classifier Response allocation failed\n");
+    return;
+  }
+  itti_upf_classifier_response_t* resp_p =
+      &message_p->ittiMsg.upf_classifier_response;
+  resp_p->status         = SGI_STATUS_ERROR_SYSTEM_FAILURE;
+  resp_p->operation_type = response.operation_type();
+  resp_p->cause_ie       = response.cause_info().cause_ie();
+  const std::string& ipv4 = response.ue_ipv4_address().address();
+  if (ipv4.size() == sizeof(struct in_addr)) {
+    memcpy(&resp_p->ue_ipv4, ipv4.data(), sizeof(struct in_addr));
+  }
+  const std::string& ipv6 = response.ue_ipv6_address().address();
+  if (ipv6.size() == sizeof(struct in6_addr)) {
+    memcpy(&resp_p->ue_ipv6, ipv6.data(), sizeof(struct in6_addr));
+  }
+  send_msg_to_task(&grpc_service_task_zmq_ctx, TASK_SPGW_APP, message_p);
+}
+
 void handle_upf_classifier_rpc_call_done(
     const grpc::Status& status, UESessionContextResponse response) {
   if (!status.ok()) {
@@ -191,5 +231,6 @@ void handle_upf_classifier_rpc_call_done(
         "causeie=%d",
         ipv4_addr_str.c_str(), ipv6_addr_str.c_str(), oper_type,
         response.cause_info().cause_ie());
+    send_upf_classifier_response_to_spgw(response);
   }
 }
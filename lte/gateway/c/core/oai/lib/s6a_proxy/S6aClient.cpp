@@ -23,6 +23,7 @@
 #include "includes/MConfigLoader.h"
 #include "S6aClient.h"
 #include "includes/ServiceRegistrySingleton.h"
+#include "s6a_client_api.h"
 #include "itti_msg_to_proto_msg.h"
 #include "feg/protos/s6a_proxy.pb.h"
 #include "mme_config.h"
@@ -144,6 +145,14 @@ S6aClient::S6aClient(bool enable_s6a_proxy_channel) {
   resp_loop_thread.detach();
 }
 
+void S6aClient::on_burst_begin() {
+  s6a_client_itti_burst_begin();
+}
+
+void S6aClient::on_burst_end() {
+  s6a_client_itti_burst_end();
+}
+
 void S6aClient::purge_ue(
     const char* imsi, std::function<void(Status, PurgeUEAnswer)> callbk) {
   S6aClient& client = get_client_based_on_fed_mode(imsi);
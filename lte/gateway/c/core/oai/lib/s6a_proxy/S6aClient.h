@@ -79,6 +79,12 @@ class S6aClient : public GRPCReceiver {
   S6aClient(S6aClient const&) = delete;
   void operator=(S6aClient const&) = delete;
 
+ protected:
+  // Coalesce the ITTI answers produced by a burst of responses into a
+  // single send towards MME_APP (see s6a_client_api.cpp)
+  void on_burst_begin() override;
+  void on_burst_end() override;
+
  private:
   S6aClient(bool enable_s6a_proxy_channel);
   static S6aClient& get_instance();
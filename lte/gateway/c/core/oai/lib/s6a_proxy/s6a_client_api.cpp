@@ -24,17 +24,28 @@
 
 #include "s6a_client_api.h"
 #include "S6aClient.h"
+#include "s6a_subscription_cache.h"
+#include "s6a_vector_cache.h"
 #include "proto_msg_to_itti_msg.h"
 #include "common_types.h"
 #include "feg/protos/s6a_proxy.pb.h"
 #include "intertask_interface.h"
 #include "intertask_interface_types.h"
+#include "itti_msg_batch.h"
 #include "itti_types.h"
 
 extern "C" {}
 
 extern task_zmq_ctx_t s6a_task_zmq_ctx;
 
+void s6a_client_itti_burst_begin(void) {
+  itti_batch_window_begin();
+}
+
+void s6a_client_itti_burst_end(void) {
+  itti_batch_window_end(&s6a_task_zmq_ctx);
+}
+
 using namespace magma;
 using namespace magma::feg;
 
@@ -45,6 +56,10 @@ bool s6a_purge_ue(const char* imsi) {
   if (!get_s6a_relay_enabled()) {
     return true;
   }
+  magma::S6aVectorCache::get_instance().invalidate(imsi);
+  // After a purge the HSS expects a fresh ULR on reattach, so the cached
+  // profile must not short-circuit it
+  magma::S6aSubscriptionCache::get_instance().invalidate(imsi);
   magma::S6aClient::purge_ue(
       imsi, [imsiStr = std::string(imsi)](
                 grpc::Status status, feg::PurgeUEAnswer response) {
@@ -69,8 +84,16 @@ static void s6a_handle_authentication_info_ans(
   MessageDef* message_p         = NULL;
   s6a_auth_info_ans_t* itti_msg = NULL;
 
-  message_p = itti_alloc_new_message(TASK_S6A, S6A_AUTH_INFO_ANS);
-  itti_msg  = &message_p->ittiMsg.s6a_auth_info_ans;
+  /* Inside a response burst the answer rides a pooled envelope and is
+   * coalesced with its neighbors into one send; outside of one (cache hits
+   * answer on the caller thread) or with the pool exhausted, fall back to
+   * the regular per-message path */
+  message_p          = itti_batch_alloc_msg(TASK_S6A, S6A_AUTH_INFO_ANS);
+  const bool batched = (message_p != NULL);
+  if (!batched) {
+    message_p = itti_alloc_new_message(TASK_S6A, S6A_AUTH_INFO_ANS);
+  }
+  itti_msg = &message_p->ittiMsg.s6a_auth_info_ans;
   strncpy(itti_msg->imsi, imsi.c_str(), imsi_length);
   itti_msg->imsi_length = imsi_length;
 
@@ -101,20 +124,61 @@ static void s6a_handle_authentication_info_ans(
   }
 
   IMSI_STRING_TO_IMSI64((char*) imsi.c_str(), &message_p->ittiMsgHeader.imsi);
-  send_msg_to_task(&s6a_task_zmq_ctx, TASK_MME_APP, message_p);
+  if (batched) {
+    itti_batch_queue_msg(&s6a_task_zmq_ctx, TASK_MME_APP, message_p);
+  } else {
+    send_msg_to_task(&s6a_task_zmq_ctx, TASK_MME_APP, message_p);
+  }
   return;
 }
 
 bool s6a_authentication_info_req(const s6a_auth_info_req_t* const air_p) {
   auto imsi_len = air_p->imsi_length;
+  auto imsiStr  = std::string(air_p->imsi);
+  auto& cache   = magma::S6aVectorCache::get_instance();
+
+  if (air_p->re_synchronization) {
+    // Vectors fetched before a USIM re-synchronization are stale
+    cache.invalidate(imsiStr);
+  } else {
+    feg::AuthenticationInformationAnswer cached;
+    if (cache.consume(imsiStr, &cached)) {
+      std::cout << "[INFO] Serving S6A authentication vector for IMSI: "
+                << imsiStr << " from prefetch cache" << std::endl;
+      s6a_handle_authentication_info_ans(
+          imsiStr, imsi_len, grpc::Status::OK, cached);
+      return true;
+    }
+  }
+
   std::cout
       << "[INFO] Sending S6A-AUTHENTICATION_INFORMATION_REQUEST with IMSI: "
-      << std::string(air_p->imsi) << std::endl;
+      << imsiStr << std::endl;
+
+  /*
+   * Over-request vectors so repeat authentications can be served from the
+   * cache; only the vectors the requester asked for are handed up, the
+   * surplus belongs to the cache exclusively so no vector is used twice.
+   */
+  s6a_auth_info_req_t air = *air_p;
+  int nb_requested        = air.nb_of_vectors > 0 ? air.nb_of_vectors : 1;
+  if (!air.re_synchronization &&
+      cache.prefetch_count() > (uint32_t) nb_requested) {
+    air.nb_of_vectors = cache.prefetch_count();
+  }
 
   magma::S6aClient::authentication_info_req(
-      air_p,
-      [imsiStr = std::string(air_p->imsi), imsi_len](
+      &air,
+      [imsiStr, imsi_len, nb_requested](
           grpc::Status status, feg::AuthenticationInformationAnswer response) {
+        if (status.ok() &&
+            response.error_code() < feg::ErrorCode::COMMAND_UNSUPORTED &&
+            response.eutran_vectors_size() > nb_requested) {
+          magma::S6aVectorCache::get_instance().store(
+              imsiStr, response, nb_requested);
+          response.mutable_eutran_vectors()->DeleteSubrange(
+              nb_requested, response.eutran_vectors_size() - nb_requested);
+        }
         s6a_handle_authentication_info_ans(imsiStr, imsi_len, status, response);
       });
   return true;
@@ -126,8 +190,13 @@ static void s6a_handle_update_location_ans(
   MessageDef* message_p               = NULL;
   s6a_update_location_ans_t* itti_msg = NULL;
 
-  message_p = itti_alloc_new_message(TASK_S6A, S6A_UPDATE_LOCATION_ANS);
-  itti_msg  = &message_p->ittiMsg.s6a_update_location_ans;
+  // Same batching scheme as the authentication info answer above
+  message_p          = itti_batch_alloc_msg(TASK_S6A, S6A_UPDATE_LOCATION_ANS);
+  const bool batched = (message_p != NULL);
+  if (!batched) {
+    message_p = itti_alloc_new_message(TASK_S6A, S6A_UPDATE_LOCATION_ANS);
+  }
+  itti_msg = &message_p->ittiMsg.s6a_update_location_ans;
 
   strncpy(itti_msg->imsi, imsi.c_str(), imsi_length);
   itti_msg->imsi_length = imsi_length;
@@ -160,18 +229,44 @@ static void s6a_handle_update_location_ans(
   std::cout << "[INFO] sent itti S6A-LOCATION-UPDATE_ANSWER for IMSI: " << imsi
             << std::endl;
   IMSI_STRING_TO_IMSI64((char*) imsi.c_str(), &message_p->ittiMsgHeader.imsi);
-  send_msg_to_task(&s6a_task_zmq_ctx, TASK_MME_APP, message_p);
+  if (batched) {
+    itti_batch_queue_msg(&s6a_task_zmq_ctx, TASK_MME_APP, message_p);
+  } else {
+    send_msg_to_task(&s6a_task_zmq_ctx, TASK_MME_APP, message_p);
+  }
   return;
 }
 
 bool s6a_update_location_req(const s6a_update_location_req_t* const ulr_p) {
   auto imsi_len = ulr_p->imsi_length;
+  auto imsiStr  = std::string(ulr_p->imsi);
+  auto& cache   = magma::S6aSubscriptionCache::get_instance();
+
+  /* A ULR with skip_subscriber_data set would not carry a profile back, so
+   * it neither can be served from the cache nor refresh it */
+  const bool wants_profile = !ulr_p->skip_subscriber_data;
+
+  if (wants_profile) {
+    feg::UpdateLocationAnswer cached;
+    if (cache.lookup(imsiStr, &cached)) {
+      std::cout << "[INFO] Serving S6A subscription data for IMSI: " << imsiStr
+                << " from cache" << std::endl;
+      s6a_handle_update_location_ans(
+          imsiStr, imsi_len, grpc::Status::OK, cached);
+      return true;
+    }
+  }
+
   std::cout << "[DEBUG] Sending S6A-UPDATE_LOCATION_REQUEST with IMSI: "
-            << std::string(ulr_p->imsi) << std::endl;
+            << imsiStr << std::endl;
 
   magma::S6aClient::update_location_request(
-      ulr_p, [imsiStr = std::string(ulr_p->imsi), imsi_len](
+      ulr_p, [imsiStr, imsi_len, wants_profile](
                  grpc::Status status, feg::UpdateLocationAnswer response) {
+        if (wants_profile && status.ok() &&
+            response.error_code() < feg::ErrorCode::COMMAND_UNSUPORTED) {
+          magma::S6aSubscriptionCache::get_instance().store(imsiStr, response);
+        }
         s6a_handle_update_location_ans(imsiStr, imsi_len, status, response);
       });
   return true;
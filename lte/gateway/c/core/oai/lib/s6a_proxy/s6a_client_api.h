@@ -44,6 +44,15 @@ bool s6a_authentication_info_req(const s6a_auth_info_req_t* air_p);
  */
 bool s6a_update_location_req(const s6a_update_location_req_t* const ulr_p);
 
+/**
+ * Bracket a burst of gRPC responses handled on the calling thread: answers
+ * converted to ITTI messages between begin and end are coalesced by the
+ * itti batch bridge and shipped to MME_APP in a single send when the burst
+ * ends. Driven by S6aClient from the response poller threads.
+ */
+void s6a_client_itti_burst_begin(void);
+void s6a_client_itti_burst_end(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,119 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-----------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include <cstdlib>
+
+#include "s6a_subscription_cache.h"
+
+namespace magma {
+
+S6aSubscriptionCache& S6aSubscriptionCache::get_instance() {
+  static S6aSubscriptionCache instance;
+  return instance;
+}
+
+S6aSubscriptionCache::S6aSubscriptionCache()
+    : capacity_(DEFAULT_CAPACITY), ttl_(DEFAULT_TTL_SEC) {
+  const char* size_env = std::getenv("MAGMA_S6A_SUBSCRIPTION_CACHE_SIZE");
+  if (size_env != nullptr) {
+    long val = std::strtol(size_env, nullptr, 10);
+    if (val >= 0) {
+      capacity_ = (size_t) val;
+    }
+  }
+  const char* ttl_env = std::getenv("MAGMA_S6A_SUBSCRIPTION_TTL_SEC");
+  if (ttl_env != nullptr) {
+    long val = std::strtol(ttl_env, nullptr, 10);
+    if (val > 0) {
+      ttl_ = std::chrono::seconds(val);
+    }
+  }
+}
+
+bool S6aSubscriptionCache::is_expired(const CacheEntry& entry) const {
+  return std::chrono::steady_clock::now() - entry.fetched_at > ttl_;
+}
+
+bool S6aSubscriptionCache::lookup(
+    const std::string& imsi, feg::UpdateLocationAnswer* ans_out) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto it = cache_.find(imsi);
+  if (it == cache_.end()) {
+    return false;
+  }
+  if (is_expired(it->second)) {
+    lru_.erase(it->second.lru_pos);
+    cache_.erase(it);
+    return false;
+  }
+
+  lru_.splice(lru_.begin(), lru_, it->second.lru_pos);
+  *ans_out = it->second.answer;
+  return true;
+}
+
+void S6aSubscriptionCache::store(
+    const std::string& imsi, const feg::UpdateLocationAnswer& ans) {
+  if (capacity_ == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto it = cache_.find(imsi);
+  if (it != cache_.end()) {
+    lru_.splice(lru_.begin(), lru_, it->second.lru_pos);
+  } else {
+    if (cache_.size() >= capacity_) {
+      cache_.erase(lru_.back());
+      lru_.pop_back();
+    }
+    lru_.push_front(imsi);
+    it                 = cache_.emplace(imsi, CacheEntry()).first;
+    it->second.lru_pos = lru_.begin();
+  }
+  it->second.answer     = ans;
+  it->second.fetched_at = std::chrono::steady_clock::now();
+}
+
+void S6aSubscriptionCache::invalidate(const std::string& imsi) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = cache_.find(imsi);
+  if (it != cache_.end()) {
+    lru_.erase(it->second.lru_pos);
+    cache_.erase(it);
+  }
+}
+
+void S6aSubscriptionCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_.clear();
+  lru_.clear();
+}
+
+}  // namespace magma
+
+void s6a_subscription_cache_invalidate(const char* imsi) {
+  if (imsi != nullptr) {
+    magma::S6aSubscriptionCache::get_instance().invalidate(imsi);
+  }
+}
+
+void s6a_subscription_cache_clear(void) {
+  magma::S6aSubscriptionCache::get_instance().clear();
+}
@@ -0,0 +1,101 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-----------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "feg/protos/s6a_proxy.pb.h"
+
+namespace magma {
+
+/**
+ * S6aSubscriptionCache keeps the subscription profile (APN configurations,
+ * AMBR, ...) returned by a successful ULA, keyed by IMSI, so the reattach
+ * of a recently seen subscriber is answered locally instead of paying the
+ * FeG round trip again. Entries live in a bounded LRU and are dropped on
+ * Cancel-Location / Delete-Subscriber, on an HSS reset, on purge, or after
+ * a freshness TTL.
+ *
+ * Capacity and TTL can be tuned with the MAGMA_S6A_SUBSCRIPTION_CACHE_SIZE
+ * and MAGMA_S6A_SUBSCRIPTION_TTL_SEC environment variables; a capacity of
+ * 0 disables the cache.
+ */
+class S6aSubscriptionCache {
+ public:
+  static S6aSubscriptionCache& get_instance();
+
+  S6aSubscriptionCache(S6aSubscriptionCache const&) = delete;
+  void operator=(S6aSubscriptionCache const&) = delete;
+
+  /**
+   * Copy the cached answer for imsi into ans_out and mark the entry most
+   * recently used. Returns false on miss, expiry or when caching is
+   * disabled.
+   */
+  bool lookup(const std::string& imsi, feg::UpdateLocationAnswer* ans_out);
+
+  // Store the profile of a successful answer, evicting the LRU entry on
+  // overflow
+  void store(const std::string& imsi, const feg::UpdateLocationAnswer& ans);
+
+  // Drop the cached profile for imsi (CLR, DSR, purge)
+  void invalidate(const std::string& imsi);
+
+  // Drop everything (HSS reset: any profile may have changed)
+  void clear();
+
+ private:
+  S6aSubscriptionCache();
+
+  struct CacheEntry {
+    feg::UpdateLocationAnswer answer;
+    std::chrono::steady_clock::time_point fetched_at;
+    std::list<std::string>::iterator lru_pos;
+  };
+
+  bool is_expired(const CacheEntry& entry) const;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, CacheEntry> cache_;
+  // Most recently used IMSI at the front, eviction happens at the back
+  std::list<std::string> lru_;
+  size_t capacity_;
+  std::chrono::seconds ttl_;
+
+  static const size_t DEFAULT_CAPACITY  = 4096;
+  static const uint32_t DEFAULT_TTL_SEC = 600;
+};
+
+}  // namespace magma
+
+extern "C" {
+#endif
+
+// C entry points for the s6a task's HSS-driven invalidation paths
+void s6a_subscription_cache_invalidate(const char* imsi);
+void s6a_subscription_cache_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
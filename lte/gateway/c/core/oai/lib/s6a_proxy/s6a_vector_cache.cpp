@@ -0,0 +1,113 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-----------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include <cstdlib>
+#include <iostream>
+
+#include "s6a_vector_cache.h"
+
+namespace magma {
+
+S6aVectorCache& S6aVectorCache::get_instance() {
+  static S6aVectorCache instance;
+  return instance;
+}
+
+S6aVectorCache::S6aVectorCache()
+    : prefetch_count_(DEFAULT_PREFETCH_COUNT), ttl_(DEFAULT_TTL_SEC) {
+  const char* prefetch_env = std::getenv("MAGMA_S6A_VECTOR_PREFETCH");
+  if (prefetch_env != nullptr) {
+    long val = std::strtol(prefetch_env, nullptr, 10);
+    if (val >= 1 && val <= (long) MAX_PREFETCH_COUNT) {
+      prefetch_count_ = (uint32_t) val;
+    }
+  }
+  const char* ttl_env = std::getenv("MAGMA_S6A_VECTOR_TTL_SEC");
+  if (ttl_env != nullptr) {
+    long val = std::strtol(ttl_env, nullptr, 10);
+    if (val > 0) {
+      ttl_ = std::chrono::seconds(val);
+    }
+  }
+}
+
+uint32_t S6aVectorCache::prefetch_count() const {
+  return prefetch_count_;
+}
+
+bool S6aVectorCache::is_expired(const CacheEntry& entry) const {
+  return std::chrono::steady_clock::now() - entry.fetched_at > ttl_;
+}
+
+bool S6aVectorCache::consume(
+    const std::string& imsi, feg::AuthenticationInformationAnswer* ans_out) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto it = cache_.find(imsi);
+  if (it == cache_.end()) {
+    return false;
+  }
+  if (is_expired(it->second) || it->second.vectors.empty()) {
+    cache_.erase(it);
+    return false;
+  }
+
+  ans_out->Clear();
+  *ans_out->add_eutran_vectors() = it->second.vectors.front();
+  it->second.vectors.pop_front();
+  if (it->second.vectors.empty()) {
+    cache_.erase(it);
+  }
+  return true;
+}
+
+void S6aVectorCache::store(
+    const std::string& imsi, const feg::AuthenticationInformationAnswer& ans,
+    int nb_consumed) {
+  if (prefetch_count_ <= 1 || ans.eutran_vectors_size() <= nb_consumed) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (cache_.size() >= MAX_CACHED_IMSIS && cache_.count(imsi) == 0) {
+    // Drop expired entries before refusing to grow
+    for (auto it = cache_.begin(); it != cache_.end();) {
+      if (is_expired(it->second)) {
+        it = cache_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    if (cache_.size() >= MAX_CACHED_IMSIS) {
+      return;
+    }
+  }
+
+  CacheEntry& entry = cache_[imsi];
+  entry.vectors.clear();
+  entry.fetched_at = std::chrono::steady_clock::now();
+  for (int i = nb_consumed; i < ans.eutran_vectors_size(); i++) {
+    entry.vectors.push_back(ans.eutran_vectors(i));
+  }
+}
+
+void S6aVectorCache::invalidate(const std::string& imsi) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_.erase(imsi);
+}
+
+}  // namespace magma
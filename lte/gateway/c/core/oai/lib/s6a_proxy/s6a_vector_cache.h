@@ -0,0 +1,92 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-----------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "feg/protos/s6a_proxy.pb.h"
+
+namespace magma {
+
+/**
+ * S6aVectorCache keeps per-IMSI E-UTRAN authentication vectors that were
+ * over-requested on a previous AIR. A repeat authentication for the same
+ * IMSI is then answered from the cache without a FeG round trip. Vectors
+ * are single use: a vector handed out is removed from the cache, and the
+ * whole entry is dropped after a freshness TTL or when the USIM signals
+ * re-synchronization, since cached AUTNs are then stale.
+ *
+ * Prefetch depth and TTL can be tuned with the MAGMA_S6A_VECTOR_PREFETCH
+ * and MAGMA_S6A_VECTOR_TTL_SEC environment variables; a prefetch depth of
+ * 1 disables the cache.
+ */
+class S6aVectorCache {
+ public:
+  static S6aVectorCache& get_instance();
+
+  S6aVectorCache(S6aVectorCache const&) = delete;
+  void operator=(S6aVectorCache const&) = delete;
+
+  // Number of vectors to request per AIR, at least 1
+  uint32_t prefetch_count() const;
+
+  /**
+   * Pop one fresh cached vector for imsi into a synthetic successful
+   * answer. Returns false on miss, expiry or when caching is disabled.
+   */
+  bool consume(
+      const std::string& imsi, feg::AuthenticationInformationAnswer* ans_out);
+
+  /**
+   * Store the vectors of a successful answer beyond the first nb_consumed,
+   * which are being delivered to the requester and must never be reused.
+   */
+  void store(
+      const std::string& imsi,
+      const feg::AuthenticationInformationAnswer& ans, int nb_consumed);
+
+  // Drop all cached vectors for imsi (resync, purge)
+  void invalidate(const std::string& imsi);
+
+ private:
+  S6aVectorCache();
+
+  struct CacheEntry {
+    std::deque<feg::AuthenticationInformationAnswer_EUTRANVector> vectors;
+    std::chrono::steady_clock::time_point fetched_at;
+  };
+
+  bool is_expired(const CacheEntry& entry) const;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, CacheEntry> cache_;
+  uint32_t prefetch_count_;
+  std::chrono::seconds ttl_;
+
+  static const uint32_t DEFAULT_PREFETCH_COUNT = 3;
+  static const uint32_t MAX_PREFETCH_COUNT     = 5;
+  static const uint32_t DEFAULT_TTL_SEC        = 600;
+  // Bound on distinct IMSIs held, entries are small but not free
+  static const size_t MAX_CACHED_IMSIS = 16384;
+};
+
+}  // namespace magma
@@ -31,16 +31,26 @@ S8Client& S8Client::get_instance() {
   return client_instance;
 }
 
-S8Client::S8Client() {
-  // Create channel
-  auto channel = ServiceRegistrySingleton::Instance()->GetGrpcChannel(
-      "s8_proxy", ServiceRegistrySingleton::CLOUD);
-  // Create stub for s8_proxy gRPC service
-  stub_ = S8Proxy::NewStub(channel);
+S8Client::S8Client() : next_stub_index_(0) {
+  // Create a stub per pooled channel; the registry hands out distinct
+  // channels on successive calls, so each stub gets its own connection
+  stubs_.reserve(STUB_POOL_SIZE);
+  for (size_t i = 0; i < STUB_POOL_SIZE; i++) {
+    auto channel = ServiceRegistrySingleton::Instance()->GetGrpcChannel(
+        "s8_proxy", ServiceRegistrySingleton::CLOUD);
+    stubs_.push_back(S8Proxy::NewStub(channel));
+  }
   std::thread resp_loop_thread([&]() { rpc_response_loop(); });
   resp_loop_thread.detach();
 }
 
+S8Proxy::Stub* S8Client::next_stub() {
+  size_t index =
+      next_stub_index_.fetch_add(1, std::memory_order_relaxed) %
+      stubs_.size();
+  return stubs_[index].get();
+}
+
 void S8Client::s8_create_session_request(
     const CreateSessionRequestPgw& csr_req,
     std::function<void(grpc::Status, CreateSessionResponsePgw)> callback) {
@@ -52,7 +62,7 @@ void S8Client::s8_create_session_request(
   // Create a response reader for the `CreateSession` RPC call. This reader
   // stores the client context, the request to pass in, and the queue to add
   // the response to when done
-  auto response_reader = client.stub_->AsyncCreateSession(
+  auto response_reader = client.next_stub()->AsyncCreateSession(
       response->get_context(), csr_req, &client.queue_);
   // Set the reader for the local response. This executes the `CreateSession`
   // response using the response reader. When it is done, the callback stored in
@@ -71,7 +81,7 @@ void S8Client::s8_delete_session_request(
   // Create a response reader for the `DeleteSession` RPC call. This reader
   // stores the client context, the request to pass in, and the queue to add
   // the response to when done
-  auto response_reader = client.stub_->AsyncDeleteSession(
+  auto response_reader = client.next_stub()->AsyncDeleteSession(
       response->get_context(), dsr_req, &client.queue_);
   // Set the reader for the local response. This executes the `DeleteSession`
   // response using the response reader. When it is done, the callback stored in
@@ -17,8 +17,10 @@ limitations under the License.
 #include <grpc++/grpc++.h>
 #include <stdint.h>
 #include <string>
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "includes/GRPCReceiver.h"
 #include "feg/protos/s8_proxy.grpc.pb.h"
@@ -59,7 +61,15 @@ class S8Client : public GRPCReceiver {
  private:
   S8Client();
   static S8Client& get_instance();
-  std::unique_ptr<S8Proxy::Stub> stub_;
+  S8Proxy::Stub* next_stub();
+  // Requests round-robin over a pool of stubs, each on its own channel, so
+  // in-flight roaming attaches are not capped by a single HTTP/2
+  // connection's concurrent stream limit. Responses complete out of order
+  // on the shared completion queue and are matched back to their
+  // transaction in the sgw_s8 task by context TEID.
+  static const size_t STUB_POOL_SIZE = 4;
+  std::vector<std::unique_ptr<S8Proxy::Stub>> stubs_;
+  std::atomic<size_t> next_stub_index_;
   static const uint32_t RESPONSE_TIMEOUT = 10;  // seconds
 };
 
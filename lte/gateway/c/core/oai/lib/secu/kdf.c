@@ -17,22 +17,44 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 #include <nettle/hmac.h>
 
 #include "security_types.h"
 #include "secu_defs.h"
-#include "dynamic_memory_check.h"
+
+/* Single-entry per-thread cache of the keyed HMAC state. Every 33.401 key
+ * derivation is HMAC-SHA256 under the same 256-bit KASME, and a handover
+ * chain derives several keys in a row from one context, so the ipad/opad
+ * key schedule (two SHA256 compressions plus the key setup) is usually
+ * recomputed for a key identical to the previous call's. Caching the keyed
+ * state per thread removes that work without any coordination between the
+ * NAS and mme_app call sites. */
+#define KDF_CACHED_KEY_LEN_MAX 32
+static __thread uint8_t kdf_cached_key[KDF_CACHED_KEY_LEN_MAX];
+static __thread unsigned kdf_cached_key_len = 0;
+static __thread struct hmac_sha256_ctx kdf_cached_ctx;
 
 void kdf(
     const uint8_t* key, const unsigned key_len, uint8_t* s,
     const unsigned s_len, uint8_t* out, const unsigned out_len) {
-  struct hmac_sha256_ctx* ctx = calloc(1, sizeof(struct hmac_sha256_ctx));
+  struct hmac_sha256_ctx ctx;
+
+  if ((key_len == kdf_cached_key_len) &&
+      (memcmp(key, kdf_cached_key, key_len) == 0)) {
+    // Same key as last time: start from the cached ipad/opad state
+    ctx = kdf_cached_ctx;
+  } else {
+    hmac_sha256_set_key(&ctx, key_len, key);
+    if (key_len <= KDF_CACHED_KEY_LEN_MAX) {
+      memcpy(kdf_cached_key, key, key_len);
+      kdf_cached_key_len = key_len;
+      kdf_cached_ctx     = ctx;
+    }
+  }
 
-  // memset (&ctx, 0, sizeof (ctx));
-  hmac_sha256_set_key(ctx, key_len, key);
-  hmac_sha256_update(ctx, s_len, s);
-  hmac_sha256_digest(ctx, out_len, out);
-  free_wrapper((void**) &ctx);
+  hmac_sha256_update(&ctx, s_len, s);
+  hmac_sha256_digest(&ctx, out_len, out);
 }
 
 int derive_keNB(
@@ -19,32 +19,40 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
-#include <nettle/nettle-meta.h>
-#include <nettle/ctr.h>
+#include <openssl/evp.h>
 
 #include "assertions.h"
 #include "conversions.h"
 #include "secu_defs.h"
 #include "dynamic_memory_check.h"
 
+/* Per-thread cache of the cipher context keyed on the last key seen: the NAS
+   ciphering key only changes on security mode control, so the per-message
+   cost is just the CTR block operations. Going through EVP dispatches at
+   runtime to the hardware AES kernels (AES-NI on x86, the crypto extensions
+   on aarch64) with OpenSSL's C implementation as fallback. Thread-local
+   storage keeps the cache lock-free; the context lives for the thread's
+   lifetime. */
+static __thread EVP_CIPHER_CTX* aes_ctx_cache = NULL;
+static __thread uint8_t aes_key_cache[32]     = {0};
+static __thread uint32_t aes_key_length_cache = 0;
+
 int nas_stream_encrypt_eea2(
     nas_stream_cipher_t* const stream_cipher, uint8_t* const out) {
   uint8_t m[16];
   uint32_t local_count;
-  void* ctx;
-  uint8_t* data;
   uint32_t zero_bit = 0;
   uint32_t byte_length;
 
   DevAssert(stream_cipher != NULL);
+  /* EVP_aes_128_ctr takes exactly a 128 bit key */
+  DevAssert(stream_cipher->key_length == 16);
   DevAssert(out != NULL);
   zero_bit    = stream_cipher->blength & 0x7;
   byte_length = stream_cipher->blength >> 3;
 
   if (zero_bit > 0) byte_length += 1;
 
-  ctx         = malloc(nettle_aes128.context_size);
-  data        = calloc(1, byte_length);
   local_count = hton_int32(stream_cipher->count);
   memset(m, 0, sizeof(m));
   memcpy(&m[0], &local_count, 4);
@@ -53,19 +61,30 @@ int nas_stream_encrypt_eea2(
   /*
    * Other bits are 0
    */
-  nettle_aes128.set_encrypt_key(
-      ctx, stream_cipher->key_length, stream_cipher->key);
+  if (aes_ctx_cache == NULL) {
+    aes_ctx_cache = EVP_CIPHER_CTX_new();
+  }
+  if ((aes_key_length_cache != stream_cipher->key_length) ||
+      (memcmp(aes_key_cache, stream_cipher->key, stream_cipher->key_length) !=
+       0)) {
+    EVP_EncryptInit_ex(
+        aes_ctx_cache, EVP_aes_128_ctr(), NULL, stream_cipher->key, m);
+    memcpy(aes_key_cache, stream_cipher->key, stream_cipher->key_length);
+    aes_key_length_cache = stream_cipher->key_length;
+  } else {
+    /* Same key: only load the fresh counter block */
+    EVP_EncryptInit_ex(aes_ctx_cache, NULL, NULL, NULL, m);
+  }
 
-  nettle_ctr_crypt(
-      ctx, nettle_aes128.encrypt, nettle_aes128.block_size, m, byte_length,
-      data, stream_cipher->message);
+  /* CTR mode keystream application writes straight into the caller's
+     buffer; no staging copy of the ciphertext is needed */
+  int data_length = 0;
+  EVP_EncryptUpdate(
+      aes_ctx_cache, out, &data_length, stream_cipher->message, byte_length);
 
   if (zero_bit > 0)
-    data[byte_length - 1] =
-        data[byte_length - 1] & (uint8_t)(0xFF << (8 - zero_bit));
+    out[byte_length - 1] =
+        out[byte_length - 1] & (uint8_t)(0xFF << (8 - zero_bit));
 
-  memcpy(out, data, byte_length);
-  free_wrapper((void**) &data);
-  free_wrapper((void**) &ctx);
   return 0;
 }
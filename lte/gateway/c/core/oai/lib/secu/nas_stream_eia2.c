@@ -29,6 +29,15 @@
 #include "dynamic_memory_check.h"
 #include "log.h"
 
+/* Per-thread cache of the CMAC context keyed on the last key seen: the NAS
+   integrity key only changes on security mode control, so the AES key
+   schedule held inside the context is reused across messages. Thread-local
+   storage keeps the cache lock-free; the context lives for the thread's
+   lifetime. */
+static __thread CMAC_CTX* cmac_ctx_cache       = NULL;
+static __thread uint8_t cmac_key_cache[32]     = {0};
+static __thread uint32_t cmac_key_length_cache = 0;
+
 /*!
    @brief Create integrity cmac t for a given message.
    @param[in] stream_cipher Structure containing various variables to setup
@@ -37,11 +46,10 @@
 */
 int nas_stream_encrypt_eia2(
     nas_stream_cipher_t* const stream_cipher, uint8_t const out[4]) {
-  uint8_t* m               = NULL;
+  uint8_t header[8]        = {0};
   uint32_t local_count     = 0;
   size_t size              = 4;
   uint8_t data[16]         = {0};
-  CMAC_CTX* cmac_ctx       = NULL;
   const EVP_CIPHER* cipher = EVP_aes_128_cbc();
   uint32_t zero_bit        = 0;
   uint32_t m_length;
@@ -49,6 +57,7 @@ int nas_stream_encrypt_eia2(
   DevAssert(stream_cipher != NULL);
   DevAssert(stream_cipher->key != NULL);
   DevAssert(stream_cipher->key_length > 0);
+  DevAssert(stream_cipher->key_length <= sizeof(cmac_key_cache));
   DevAssert(out != NULL);
   zero_bit = stream_cipher->blength & 0x7;
   m_length = stream_cipher->blength >> 3;
@@ -56,15 +65,14 @@ int nas_stream_encrypt_eia2(
   if (zero_bit > 0) m_length += 1;
 
   local_count = hton_int32(stream_cipher->count);
-  m           = calloc(1, m_length + 8);
-  memcpy(&m[0], &local_count, 4);
-  m[4] = ((stream_cipher->bearer & 0x1F) << 3) |
-         ((stream_cipher->direction & 0x01) << 2);
-  memcpy(&m[8], stream_cipher->message, m_length);
+  memcpy(&header[0], &local_count, 4);
+  header[4] = ((stream_cipher->bearer & 0x1F) << 3) |
+              ((stream_cipher->direction & 0x01) << 2);
 
   OAILOG_TRACE(
       LOG_NAS, "Byte length: %u, Zero bits: %u:\n", m_length + 8, zero_bit);
-  OAILOG_STREAM_HEX(OAILOG_LEVEL_TRACE, LOG_NAS, "m:", m, m_length + 8);
+  OAILOG_STREAM_HEX(
+      OAILOG_LEVEL_TRACE, LOG_NAS, "Header:", header, sizeof(header));
   OAILOG_STREAM_HEX(
       OAILOG_LEVEL_TRACE, LOG_NAS, "Key:", stream_cipher->key,
       stream_cipher->key_length);
@@ -72,14 +80,28 @@ int nas_stream_encrypt_eia2(
       OAILOG_LEVEL_TRACE, LOG_NAS, "Message:", stream_cipher->message,
       m_length);
 
-  cmac_ctx = CMAC_CTX_new();
-  CMAC_Init(
-      cmac_ctx, stream_cipher->key, stream_cipher->key_length, cipher, NULL);
-  CMAC_Update(cmac_ctx, m, m_length + 8);
-  CMAC_Final(cmac_ctx, data, &size);
-  CMAC_CTX_free(cmac_ctx);
+  if ((cmac_ctx_cache == NULL) ||
+      (cmac_key_length_cache != stream_cipher->key_length) ||
+      (memcmp(cmac_key_cache, stream_cipher->key, stream_cipher->key_length) !=
+       0)) {
+    if (cmac_ctx_cache == NULL) {
+      cmac_ctx_cache = CMAC_CTX_new();
+    }
+    CMAC_Init(
+        cmac_ctx_cache, stream_cipher->key, stream_cipher->key_length, cipher,
+        NULL);
+    memcpy(cmac_key_cache, stream_cipher->key, stream_cipher->key_length);
+    cmac_key_length_cache = stream_cipher->key_length;
+  } else {
+    /* Same key: reset the running state, keep the expanded key schedule */
+    CMAC_Init(cmac_ctx_cache, NULL, 0, NULL, NULL);
+  }
+  /* Feed the 64 bit count/bearer/direction preamble and then the message
+     in place; no staging copy of the message is needed */
+  CMAC_Update(cmac_ctx_cache, header, sizeof(header));
+  CMAC_Update(cmac_ctx_cache, stream_cipher->message, m_length);
+  CMAC_Final(cmac_ctx_cache, data, &size);
   OAILOG_STREAM_HEX(OAILOG_LEVEL_TRACE, LOG_NAS, "Out:", data, size);
   memcpy((void*) out, data, 4);
-  free_wrapper((void**) &m);
   return 0;
 }
@@ -22,20 +22,34 @@
 
 static uint8_t MULx(uint8_t V, uint8_t c);
 static uint8_t MULxPOW(uint8_t V, uint8_t i, uint8_t c);
-static uint32_t MULalpha(uint8_t c);
-static uint32_t DIValpha(uint8_t c);
-static uint32_t S1(uint32_t w);
-static uint32_t S2(uint32_t w);
+static void snow3g_init_tables(void);
 static void snow3g_clock_LFSR_initialization_mode(
     uint32_t F, snow_3g_context_t* s3g_ctx_pP);
-static void snow3g_clock_LFSR_key_stream_mode(
-    snow_3g_context_t* snow_3g_context_pP);
 static uint32_t snow3g_clock_fsm(snow_3g_context_t* snow_3g_context_pP);
 void snow3g_initialize(
     uint32_t k[4], uint32_t IV[4], snow_3g_context_t* snow_3g_context_pP);
 void snow3g_generate_key_stream(
     uint32_t n, uint32_t* ks, snow_3g_context_t* snow_3g_context_pP);
 
+/* All byte-to-word maps of the cipher are precomputed once, so the per-clock
+  cost in the keystream loop is four table lookups per S-box application and
+  one per feedback multiplication, instead of chains of recursive GF(2^8)
+  multiplications. The tables are a pure function of the spec constants; the
+  lazy init is idempotent, so a racing second initialization is harmless. */
+static uint32_t MULalpha_T[256]; /* MULalpha(c), section 3.2 */
+static uint32_t DIValpha_T[256]; /* DIValpha(c), section 3.2 */
+/* S1/S2 split by input byte position: S1(w) = S1_T0[w0] ^ S1_T1[w1] ^
+  S1_T2[w2] ^ S1_T3[w3], with w0 the most significant byte */
+static uint32_t S1_T0[256];
+static uint32_t S1_T1[256];
+static uint32_t S1_T2[256];
+static uint32_t S1_T3[256];
+static uint32_t S2_T0[256];
+static uint32_t S2_T1[256];
+static uint32_t S2_T2[256];
+static uint32_t S2_T3[256];
+static int tables_initialized = 0;
+
 /* _MULx.
   Input V: an 8-bit input.
   Input c: an 8-bit input.
@@ -66,83 +80,67 @@ static uint8_t MULxPOW(uint8_t V, uint8_t i, uint8_t c) {
     return MULx(MULxPOW(V, i - 1, c), c);
 }
 
-/* The function _MULalpha.
-  Input c: 8-bit input.
-  Output : 32-bit output.
-  maps 8 bits to 32 bits.
+/* Fills the per-byte lookup tables. The S-box tables fold the MixColumn-like
+  linear layer of sections 3.3.1/3.3.2 into one word per input byte, the same
+  trick as AES T-tables; the alpha tables hold the byte-to-word maps of
+  section 3.2 evaluated for every input.
 */
 
-static uint32_t MULalpha(uint8_t c) {
-  return (
-      (((uint32_t) MULxPOW(c, 23, 0xa9)) << 24) |
-      (((uint32_t) MULxPOW(c, 245, 0xa9)) << 16) |
-      (((uint32_t) MULxPOW(c, 48, 0xa9)) << 8) |
-      (((uint32_t) MULxPOW(c, 239, 0xa9))));
+static void snow3g_init_tables(void) {
+  uint32_t c = 0;
+
+  for (c = 0; c < 256; c++) {
+    uint8_t sr = SR[c];
+    uint8_t sq = SQ[c];
+    uint8_t xr = MULx(sr, 0x1b);
+    uint8_t xq = MULx(sq, 0x69);
+
+    MULalpha_T[c] =
+        ((((uint32_t) MULxPOW(c, 23, 0xa9)) << 24) |
+         (((uint32_t) MULxPOW(c, 245, 0xa9)) << 16) |
+         (((uint32_t) MULxPOW(c, 48, 0xa9)) << 8) |
+         (((uint32_t) MULxPOW(c, 239, 0xa9))));
+    DIValpha_T[c] =
+        ((((uint32_t) MULxPOW(c, 16, 0xa9)) << 24) |
+         (((uint32_t) MULxPOW(c, 39, 0xa9)) << 16) |
+         (((uint32_t) MULxPOW(c, 6, 0xa9)) << 8) |
+         (((uint32_t) MULxPOW(c, 64, 0xa9))));
+
+    S1_T0[c] = (((uint32_t) xr) << 24) | (((uint32_t)(xr ^ sr)) << 16) |
+               (((uint32_t) sr) << 8) | ((uint32_t) sr);
+    S1_T1[c] = (((uint32_t) sr) << 24) | (((uint32_t) xr) << 16) |
+               (((uint32_t)(xr ^ sr)) << 8) | ((uint32_t) sr);
+    S1_T2[c] = (((uint32_t) sr) << 24) | (((uint32_t) sr) << 16) |
+               (((uint32_t) xr) << 8) | ((uint32_t)(xr ^ sr));
+    S1_T3[c] = (((uint32_t)(xr ^ sr)) << 24) | (((uint32_t) sr) << 16) |
+               (((uint32_t) sr) << 8) | ((uint32_t) xr);
+
+    S2_T0[c] = (((uint32_t) xq) << 24) | (((uint32_t)(xq ^ sq)) << 16) |
+               (((uint32_t) sq) << 8) | ((uint32_t) sq);
+    S2_T1[c] = (((uint32_t) sq) << 24) | (((uint32_t) xq) << 16) |
+               (((uint32_t)(xq ^ sq)) << 8) | ((uint32_t) sq);
+    S2_T2[c] = (((uint32_t) sq) << 24) | (((uint32_t) sq) << 16) |
+               (((uint32_t) xq) << 8) | ((uint32_t)(xq ^ sq));
+    S2_T3[c] = (((uint32_t)(xq ^ sq)) << 24) | (((uint32_t) sq) << 16) |
+               (((uint32_t) sq) << 8) | ((uint32_t) xq);
+  }
+  tables_initialized = 1;
 }
 
-/* The function DIV alpha.
-  Input c: 8-bit input.
-  Output : 32-bit output.
-  maps 8 bits to 32 bit.
-*/
-
-static uint32_t DIValpha(uint8_t c) {
-  return (
-      (((uint32_t) MULxPOW(c, 16, 0xa9)) << 24) |
-      (((uint32_t) MULxPOW(c, 39, 0xa9)) << 16) |
-      (((uint32_t) MULxPOW(c, 6, 0xa9)) << 8) |
-      (((uint32_t) MULxPOW(c, 64, 0xa9))));
-}
+/* The 32x32-bit S-Box S1 as four lookups, see section 3.3.1. */
+#define SNOW3G_S1(w)                                                           \
+  (S1_T0[((w) >> 24) & 0xff] ^ S1_T1[((w) >> 16) & 0xff] ^                     \
+   S1_T2[((w) >> 8) & 0xff] ^ S1_T3[(w) &0xff])
 
-/* The 32x32-bit S-Box S1
-  Input: a 32-bit input.
-  Output: a 32-bit output of S1 box.
-  The S-Box S1 maps a 32-bit input to a 32-bit output.
-  w = w0 || w1 || w2 || w3 the 32-bit input with w0 the most and w3 the least
-  significant byte. S1(w)= r0 || r1 || r2 || r3 with r0 the most and r3 the
-  least significant byte.
-*/
+/* The 32x32-bit S-Box S2 as four lookups, see section 3.3.2. */
+#define SNOW3G_S2(w)                                                           \
+  (S2_T0[((w) >> 24) & 0xff] ^ S2_T1[((w) >> 16) & 0xff] ^                     \
+   S2_T2[((w) >> 8) & 0xff] ^ S2_T3[(w) &0xff])
 
-static uint32_t S1(uint32_t w) {
-  uint8_t r0 = 0, r1 = 0, r2 = 0, r3 = 0;
-  uint8_t srw0 = SR[(uint8_t)((w >> 24) & 0xff)];
-  uint8_t srw1 = SR[(uint8_t)((w >> 16) & 0xff)];
-  uint8_t srw2 = SR[(uint8_t)((w >> 8) & 0xff)];
-  uint8_t srw3 = SR[(uint8_t)((w) &0xff)];
-
-  r0 = ((MULx(srw0, 0x1b)) ^ (srw1) ^ (srw2) ^ ((MULx(srw3, 0x1b)) ^ srw3));
-  r1 = (((MULx(srw0, 0x1b)) ^ srw0) ^ (MULx(srw1, 0x1b)) ^ (srw2) ^ (srw3));
-  r2 = ((srw0) ^ ((MULx(srw1, 0x1b)) ^ srw1) ^ (MULx(srw2, 0x1b)) ^ (srw3));
-  r3 = ((srw0) ^ (srw1) ^ ((MULx(srw2, 0x1b)) ^ srw2) ^ (MULx(srw3, 0x1b)));
-  return (
-      (((uint32_t) r0) << 24) | (((uint32_t) r1) << 16) |
-      (((uint32_t) r2) << 8) | (((uint32_t) r3)));
-}
-
-/* The 32x32-bit S-Box S2
-  Input: a 32-bit input.
-  Output: a 32-bit output of S2 box.
-  The S-Box S2 maps a 32-bit input to a 32-bit output.
-  Let w = w0 || w1 || w2 || w3 the 32-bit input with w0 the most and w3 the
-  least significant byte. Let S2(w)= r0 || r1 || r2 || r3 with r0 the most and
-  r3 the least significant byte.
-*/
-
-static uint32_t S2(uint32_t w) {
-  uint8_t r0 = 0, r1 = 0, r2 = 0, r3 = 0;
-  uint8_t sqw0 = SQ[(uint8_t)((w >> 24) & 0xff)];
-  uint8_t sqw1 = SQ[(uint8_t)((w >> 16) & 0xff)];
-  uint8_t sqw2 = SQ[(uint8_t)((w >> 8) & 0xff)];
-  uint8_t sqw3 = SQ[(uint8_t)((w) &0xff)];
-
-  r0 = ((MULx(sqw0, 0x69)) ^ (sqw1) ^ (sqw2) ^ ((MULx(sqw3, 0x69)) ^ sqw3));
-  r1 = (((MULx(sqw0, 0x69)) ^ sqw0) ^ (MULx(sqw1, 0x69)) ^ (sqw2) ^ (sqw3));
-  r2 = ((sqw0) ^ ((MULx(sqw1, 0x69)) ^ sqw1) ^ (MULx(sqw2, 0x69)) ^ (sqw3));
-  r3 = ((sqw0) ^ (sqw1) ^ ((MULx(sqw2, 0x69)) ^ sqw2) ^ (MULx(sqw3, 0x69)));
-  return (
-      (((uint32_t) r0) << 24) | (((uint32_t) r1) << 16) |
-      (((uint32_t) r2) << 8) | (((uint32_t) r3)));
-}
+/* LFSR feedback term built from s0 and s11, sections 3.4.4/3.4.5. */
+#define SNOW3G_FEEDBACK(s0, s11)                                               \
+  ((((s0) << 8) & 0xffffff00) ^ MULalpha_T[((s0) >> 24) & 0xff] ^              \
+   (((s11) >> 8) & 0x00ffffff) ^ DIValpha_T[(s11) &0xff])
 
 /* Clocking LFSR in initialization mode.
   LFSR Registers S0 to S15 are updated as the LFSR receives a single clock.
@@ -152,11 +150,8 @@ static uint32_t S2(uint32_t w) {
 
 static void snow3g_clock_LFSR_initialization_mode(
     uint32_t F, snow_3g_context_t* s3g_ctx_pP) {
-  uint32_t v =
-      (((s3g_ctx_pP->LFSR_S0 << 8) & 0xffffff00) ^
-       (MULalpha((uint8_t)((s3g_ctx_pP->LFSR_S0 >> 24) & 0xff))) ^
-       (s3g_ctx_pP->LFSR_S2) ^ ((s3g_ctx_pP->LFSR_S11 >> 8) & 0x00ffffff) ^
-       (DIValpha((uint8_t)((s3g_ctx_pP->LFSR_S11) & 0xff))) ^ (F));
+  uint32_t v = SNOW3G_FEEDBACK(s3g_ctx_pP->LFSR_S0, s3g_ctx_pP->LFSR_S11) ^
+               (s3g_ctx_pP->LFSR_S2) ^ (F);
 
   s3g_ctx_pP->LFSR_S0  = s3g_ctx_pP->LFSR_S1;
   s3g_ctx_pP->LFSR_S1  = s3g_ctx_pP->LFSR_S2;
@@ -176,37 +171,6 @@ static void snow3g_clock_LFSR_initialization_mode(
   s3g_ctx_pP->LFSR_S15 = v;
 }
 
-/* Clocking LFSR in keystream mode.
-  LFSR Registers S0 to S15 are updated as the LFSR receives a single clock.
-  See section 3.4.5.
-*/
-static void snow3g_clock_LFSR_key_stream_mode(
-    snow_3g_context_t* snow_3g_context_pP) {
-  uint32_t v =
-      (((snow_3g_context_pP->LFSR_S0 << 8) & 0xffffff00) ^
-       (MULalpha((uint8_t)((snow_3g_context_pP->LFSR_S0 >> 24) & 0xff))) ^
-       (snow_3g_context_pP->LFSR_S2) ^
-       ((snow_3g_context_pP->LFSR_S11 >> 8) & 0x00ffffff) ^
-       (DIValpha((uint8_t)((snow_3g_context_pP->LFSR_S11) & 0xff))));
-
-  snow_3g_context_pP->LFSR_S0  = snow_3g_context_pP->LFSR_S1;
-  snow_3g_context_pP->LFSR_S1  = snow_3g_context_pP->LFSR_S2;
-  snow_3g_context_pP->LFSR_S2  = snow_3g_context_pP->LFSR_S3;
-  snow_3g_context_pP->LFSR_S3  = snow_3g_context_pP->LFSR_S4;
-  snow_3g_context_pP->LFSR_S4  = snow_3g_context_pP->LFSR_S5;
-  snow_3g_context_pP->LFSR_S5  = snow_3g_context_pP->LFSR_S6;
-  snow_3g_context_pP->LFSR_S6  = snow_3g_context_pP->LFSR_S7;
-  snow_3g_context_pP->LFSR_S7  = snow_3g_context_pP->LFSR_S8;
-  snow_3g_context_pP->LFSR_S8  = snow_3g_context_pP->LFSR_S9;
-  snow_3g_context_pP->LFSR_S9  = snow_3g_context_pP->LFSR_S10;
-  snow_3g_context_pP->LFSR_S10 = snow_3g_context_pP->LFSR_S11;
-  snow_3g_context_pP->LFSR_S11 = snow_3g_context_pP->LFSR_S12;
-  snow_3g_context_pP->LFSR_S12 = snow_3g_context_pP->LFSR_S13;
-  snow_3g_context_pP->LFSR_S13 = snow_3g_context_pP->LFSR_S14;
-  snow_3g_context_pP->LFSR_S14 = snow_3g_context_pP->LFSR_S15;
-  snow_3g_context_pP->LFSR_S15 = v;
-}
-
 /* Clocking FSM.
   Produces a 32-bit word F.
   Updates FSM registers R1, R2, R3.
@@ -221,8 +185,8 @@ static uint32_t snow3g_clock_fsm(snow_3g_context_t* snow_3g_context_pP) {
                 (snow_3g_context_pP->FSM_R3 ^ snow_3g_context_pP->LFSR_S5)) &
                0xffffffff;
 
-  snow_3g_context_pP->FSM_R3 = S2(snow_3g_context_pP->FSM_R2);
-  snow_3g_context_pP->FSM_R2 = S1(snow_3g_context_pP->FSM_R1);
+  snow_3g_context_pP->FSM_R3 = SNOW3G_S2(snow_3g_context_pP->FSM_R2);
+  snow_3g_context_pP->FSM_R2 = SNOW3G_S1(snow_3g_context_pP->FSM_R1);
   snow_3g_context_pP->FSM_R1 = r;
   return F;
 }
@@ -239,6 +203,10 @@ void snow3g_initialize(
   uint8_t i  = 0;
   uint32_t F = 0x0;
 
+  if (!tables_initialized) {
+    snow3g_init_tables();
+  }
+
   snow_3g_context_pP->LFSR_S15 = k[3] ^ IV[0];
   snow_3g_context_pP->LFSR_S14 = k[2];
   snow_3g_context_pP->LFSR_S13 = k[1];
@@ -271,24 +239,86 @@ void snow3g_initialize(
     memory is allocated already.
     output: generated keystream which is filled in z
     See section 4.2.
+
+  The hot loop runs entirely on locals: the LFSR lives in a 16-word circular
+  buffer indexed modulo 16, so one clock is one store plus an index bump
+  instead of sixteen moves through the context struct, and the FSM registers
+  stay in machine registers. The context is written back at the end so
+  repeated calls still stream.
 */
 
 void snow3g_generate_key_stream(
     uint32_t n, uint32_t* ks, snow_3g_context_t* snow_3g_context_pP) {
-  uint32_t t = 0;
-  uint32_t F = 0x0;
-
-  snow3g_clock_fsm(
-      snow_3g_context_pP); /* Clock FSM once. Discard the output. */
-  snow3g_clock_LFSR_key_stream_mode(
-      snow_3g_context_pP); /* Clock LFSR in keystream mode once. */
+  uint32_t s[16];
+  uint32_t R1   = snow_3g_context_pP->FSM_R1;
+  uint32_t R2   = snow_3g_context_pP->FSM_R2;
+  uint32_t R3   = snow_3g_context_pP->FSM_R3;
+  uint32_t base = 0;
+  uint32_t t    = 0;
+  uint32_t F    = 0x0;
+  uint32_t r    = 0x0;
+
+  s[0]  = snow_3g_context_pP->LFSR_S0;
+  s[1]  = snow_3g_context_pP->LFSR_S1;
+  s[2]  = snow_3g_context_pP->LFSR_S2;
+  s[3]  = snow_3g_context_pP->LFSR_S3;
+  s[4]  = snow_3g_context_pP->LFSR_S4;
+  s[5]  = snow_3g_context_pP->LFSR_S5;
+  s[6]  = snow_3g_context_pP->LFSR_S6;
+  s[7]  = snow_3g_context_pP->LFSR_S7;
+  s[8]  = snow_3g_context_pP->LFSR_S8;
+  s[9]  = snow_3g_context_pP->LFSR_S9;
+  s[10] = snow_3g_context_pP->LFSR_S10;
+  s[11] = snow_3g_context_pP->LFSR_S11;
+  s[12] = snow_3g_context_pP->LFSR_S12;
+  s[13] = snow_3g_context_pP->LFSR_S13;
+  s[14] = snow_3g_context_pP->LFSR_S14;
+  s[15] = snow_3g_context_pP->LFSR_S15;
+
+#define LFSR_AT(i) s[(base + (i)) & 15]
+
+  /* Clock FSM once. Discard the output. Then clock the LFSR in keystream
+     mode once. */
+  r  = (R2 + (R3 ^ LFSR_AT(5))) & 0xffffffff;
+  R3 = SNOW3G_S2(R2);
+  R2 = SNOW3G_S1(R1);
+  R1 = r;
+  LFSR_AT(0) = SNOW3G_FEEDBACK(LFSR_AT(0), LFSR_AT(11)) ^ LFSR_AT(2);
+  base++;
 
   for (t = 0; t < n; t++) {
-    F     = snow3g_clock_fsm(snow_3g_context_pP); /* STEP 1 */
-    ks[t] = F ^ snow_3g_context_pP->LFSR_S0;      /* STEP 2 */
+    F     = ((LFSR_AT(15) + R1) & 0xffffffff) ^ R2; /* STEP 1 */
+    ks[t] = F ^ LFSR_AT(0);                         /* STEP 2 */
     /*
      * Note that ks[t] corresponds to z_{t+1} in section 4.2
      */
-    snow3g_clock_LFSR_key_stream_mode(snow_3g_context_pP); /* STEP 3 */
+    r  = (R2 + (R3 ^ LFSR_AT(5))) & 0xffffffff;
+    R3 = SNOW3G_S2(R2);
+    R2 = SNOW3G_S1(R1);
+    R1 = r;
+    LFSR_AT(0) = SNOW3G_FEEDBACK(LFSR_AT(0), LFSR_AT(11)) ^ LFSR_AT(2);
+    base++; /* STEP 3 */
   }
+
+  snow_3g_context_pP->FSM_R1   = R1;
+  snow_3g_context_pP->FSM_R2   = R2;
+  snow_3g_context_pP->FSM_R3   = R3;
+  snow_3g_context_pP->LFSR_S0  = LFSR_AT(0);
+  snow_3g_context_pP->LFSR_S1  = LFSR_AT(1);
+  snow_3g_context_pP->LFSR_S2  = LFSR_AT(2);
+  snow_3g_context_pP->LFSR_S3  = LFSR_AT(3);
+  snow_3g_context_pP->LFSR_S4  = LFSR_AT(4);
+  snow_3g_context_pP->LFSR_S5  = LFSR_AT(5);
+  snow_3g_context_pP->LFSR_S6  = LFSR_AT(6);
+  snow_3g_context_pP->LFSR_S7  = LFSR_AT(7);
+  snow_3g_context_pP->LFSR_S8  = LFSR_AT(8);
+  snow_3g_context_pP->LFSR_S9  = LFSR_AT(9);
+  snow_3g_context_pP->LFSR_S10 = LFSR_AT(10);
+  snow_3g_context_pP->LFSR_S11 = LFSR_AT(11);
+  snow_3g_context_pP->LFSR_S12 = LFSR_AT(12);
+  snow_3g_context_pP->LFSR_S13 = LFSR_AT(13);
+  snow_3g_context_pP->LFSR_S14 = LFSR_AT(14);
+  snow_3g_context_pP->LFSR_S15 = LFSR_AT(15);
+
+#undef LFSR_AT
 }
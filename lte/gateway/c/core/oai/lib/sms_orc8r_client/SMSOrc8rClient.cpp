@@ -59,4 +59,21 @@ void SMSOrc8rClient::send_uplink_unitdata(
   local_response->set_response_reader(std::move(response_reader));
 }
 
+void SMSOrc8rClient::send_uplink_unitdata_batch(
+    const itti_sgsap_uplink_unitdata_t* msgs, size_t num_msgs,
+    std::function<void(grpc::Status, Void)> callback) {
+  SMSOrc8rClient& client = get_instance();
+  // The orc8r relay contract only exposes unary SMOUplink, so the burst is
+  // dispatched as back-to-back async RPCs sharing one channel wakeup
+  for (size_t i = 0; i < num_msgs; i++) {
+    SMOUplinkUnitdata proto_msg =
+        convert_itti_sgsap_uplink_unitdata_to_proto_msg(&msgs[i]);
+    auto local_response =
+        new AsyncLocalResponse<Void>(callback, RESPONSE_TIMEOUT);
+    auto response_reader = client.stub_->AsyncSMOUplink(
+        local_response->get_context(), proto_msg, &client.queue_);
+    local_response->set_response_reader(std::move(response_reader));
+  }
+}
+
 }  // namespace magma
@@ -57,6 +57,14 @@ class SMSOrc8rClient : public GRPCReceiver {
       const itti_sgsap_uplink_unitdata_t* msg,
       std::function<void(grpc::Status, Void)> callback);
 
+  /**
+   * SGsAP-UPLINK-UNITDATA, batched: dispatches a whole burst onto the
+   * shared channel and completion queue in one call
+   */
+  static void send_uplink_unitdata_batch(
+      const itti_sgsap_uplink_unitdata_t* msgs, size_t num_msgs,
+      std::function<void(grpc::Status, Void)> callback);
+
  public:
   SMSOrc8rClient(SMSOrc8rClient const&) = delete;
   void operator=(SMSOrc8rClient const&) = delete;
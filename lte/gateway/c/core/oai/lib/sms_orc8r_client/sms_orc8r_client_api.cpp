@@ -36,3 +36,12 @@ void send_smo_uplink_unitdata(const itti_sgsap_uplink_unitdata_t* msg) {
   magma::SMSOrc8rClient::send_uplink_unitdata(msg, void_callback);
   return;
 }
+
+void send_smo_uplink_unitdata_batch(
+    const itti_sgsap_uplink_unitdata_t* msgs, size_t num_msgs) {
+  OAILOG_DEBUG(
+      LOG_SMS_ORC8R, "Sending batch of %zu UPLINK_UNITDATA\n", num_msgs);
+  magma::SMSOrc8rClient::send_uplink_unitdata_batch(
+      msgs, num_msgs, void_callback);
+  return;
+}
@@ -28,6 +28,9 @@ extern "C" {
 
 void send_smo_uplink_unitdata(const itti_sgsap_uplink_unitdata_t* msg);
 
+void send_smo_uplink_unitdata_batch(
+    const itti_sgsap_uplink_unitdata_t* msgs, size_t num_msgs);
+
 #ifdef __cplusplus
 }
 #endif
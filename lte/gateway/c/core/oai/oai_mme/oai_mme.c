@@ -50,8 +50,10 @@
 #include "pid_file.h"
 #include "service303_message_utils.h"
 #include "bstrlib.h"
+#include "huge_alloc.h"
 #include "intertask_interface.h"
 #include "intertask_interface_types.h"
+#include "itti_shed.h"
 #if EMBEDDED_SGW
 #include "mme_app_embedded_spgw.h"
 #include "spgw_config.h"
@@ -100,6 +102,14 @@ int main(int argc, char* argv[]) {
       TASK_MAX, THREAD_MAX, MESSAGES_ID_MAX, tasks_info, messages_info, NULL,
       NULL));
 
+  // Under overload, paging can be dropped (the UE is re-paged or re-attaches)
+  // while attach and bearer signaling must keep flowing; effective only when
+  // watermark shedding is enabled
+  itti_shed_set_message_class(S1AP_PAGING_REQUEST, ITTI_SHED_CLASS_SHEDDABLE);
+  itti_shed_set_message_class(
+      S1AP_PAGING_REQUEST_BATCH, ITTI_SHED_CLASS_SHEDDABLE);
+  itti_shed_set_message_class(SGSAP_PAGING_REQUEST, ITTI_SHED_CLASS_SHEDDABLE);
+
   // Initialize Sentry error collection (Currently only supported on
   // Ubuntu 20.04)
   // We have to initialize here for now since itti_init asserts on there being
@@ -129,6 +139,28 @@ int main(int argc, char* argv[]) {
   }
   free_wrapper((void**) &pid_file_name);
 
+  // Large hashtables created by the task init calls below pick up hugepage
+  // backing from here on; no-op unless built with USE_HUGEPAGE_ARENA
+  huge_alloc_set_enabled(mme_config.use_hugepage_arena);
+
+  // Register the configured task placement (core pinning, SCHED_FIFO)
+  // before any task thread is created below
+  for (int i = 0; i < mme_config.itti_config.nb_task_placements; i++) {
+    const itti_task_placement_t* placement =
+        &mme_config.itti_config.task_placements[i];
+    task_id_t placed_task_id =
+        itti_get_task_id_by_name(bdata(placement->task_name));
+
+    if (placed_task_id == TASK_UNKNOWN) {
+      OAILOG_ERROR(
+          LOG_CONFIG, "Unknown task name in TASK_PLACEMENT: %s\n",
+          bdata(placement->task_name));
+      continue;
+    }
+    itti_set_task_placement(
+        placed_task_id, placement->core, placement->sched_fifo_prio);
+  }
+
   /*
    * Calling each layer init function
    */
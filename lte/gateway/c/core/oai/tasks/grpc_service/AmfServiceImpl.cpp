@@ -35,6 +35,7 @@ class ServerContext;
 using grpc::ServerContext;
 using grpc::Status;
 using magma::lte::SetSmNotificationContext;
+using magma::lte::SetSmNotificationsContext;
 using magma::lte::SetSMSessionContextAccess;
 using magma::lte::SmContextVoid;
 using magma::lte::SmfPduSessionSmContext;
@@ -52,6 +53,22 @@ Status AmfServiceImpl::SetAmfNotification(
 
   return Status::OK;
 }
+
+Status AmfServiceImpl::SetAmfNotifications(
+    ServerContext* context, const SetSmNotificationsContext* notifs,
+    SmContextVoid* response) {
+  OAILOG_INFO(
+      LOG_UTIL, "Received GRPC batch of %d SetSmNotificationContext\n",
+      notifs->notifications_size());
+  for (const auto& notif : notifs->notifications()) {
+    SmContextVoid notif_response;
+    Status status = SetAmfNotification(context, &notif, &notif_response);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+  return Status::OK;
+}
 // Set message from SessionD received
 Status AmfServiceImpl::SetSmfSessionContext(
     ServerContext* context, const SetSMSessionContextAccess* request,
@@ -26,12 +26,14 @@ namespace magma {
 namespace lte {
 class SetSMSessionContextAccess;
 class SetSmNotificationContext;
+class SetSmNotificationsContext;
 class SmContextVoid;
 }  // namespace lte
 }  // namespace magma
 
 using grpc::ServerContext;
 using magma::lte::SetSmNotificationContext;
+using magma::lte::SetSmNotificationsContext;
 using magma::lte::SetSMSessionContextAccess;
 using magma::lte::SmContextVoid;
 using magma::lte::SmfPduSessionSmContext;
@@ -48,6 +50,13 @@ class AmfServiceImpl final : public SmfPduSessionSmContext::Service {
       ServerContext* context, const SetSmNotificationContext* notif,
       SmContextVoid* response) override;
 
+  /* Batched notifications coalesced by SMF; each entry is processed as
+   * if it had arrived through SetAmfNotification
+   */
+  grpc::Status SetAmfNotifications(
+      ServerContext* context, const SetSmNotificationsContext* notifs,
+      SmContextVoid* response) override;
+
   grpc::Status SetSmfSessionContext(
       ServerContext* context, const SetSMSessionContextAccess* request,
       SmContextVoid* response) override;
@@ -0,0 +1,385 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+/*! \file gtp_netlink.c
+ * \brief rtnetlink route/address/MTU manipulation without fork/exec
+ *
+ * Historically the GTP device and the UE block routes were configured by
+ * shelling out to ip(8), which costs a fork/exec (several milliseconds
+ * plus a page-table copy of the whole process) on every call. Each
+ * operation here is a single netlink request/ack round trip instead, and
+ * route updates triggered from bearer setup are handed to a small worker
+ * thread so tunnel creation never waits on the kernel routing table.
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "log.h"
+#include "common_defs.h"
+#include "gtp_netlink.h"
+
+// Room for the fixed header plus the few attributes these requests carry
+#define RTNL_REQUEST_BUFFER_SIZE 256
+#define RTNL_REPLY_BUFFER_SIZE 4096
+
+struct rtnl_request {
+  struct nlmsghdr nlh;
+  union {
+    struct rtmsg rtm;
+    struct ifaddrmsg ifa;
+  };
+  char attrbuf[RTNL_REQUEST_BUFFER_SIZE];
+};
+
+//------------------------------------------------------------------------------
+static void rtnl_add_attr(
+    struct nlmsghdr* nlh, int type, const void* data, size_t len) {
+  struct rtattr* rta =
+      (struct rtattr*) ((char*) nlh + NLMSG_ALIGN(nlh->nlmsg_len));
+  rta->rta_type = type;
+  rta->rta_len  = RTA_LENGTH(len);
+  memcpy(RTA_DATA(rta), data, len);
+  nlh->nlmsg_len = NLMSG_ALIGN(nlh->nlmsg_len) + RTA_ALIGN(rta->rta_len);
+}
+
+/*
+ * Send one rtnetlink request and wait for its ack.
+ * Returns 0 on success or a negative errno.
+ */
+static int rtnl_transact(struct nlmsghdr* nlh) {
+  static uint32_t seq = 0;
+  char reply[RTNL_REPLY_BUFFER_SIZE];
+  int rc = 0;
+
+  int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+  if (fd < 0) {
+    OAILOG_ERROR(
+        LOG_GTPV1U, "Cannot open rtnetlink socket: %s\n", strerror(errno));
+    return -errno;
+  }
+
+  nlh->nlmsg_flags |= NLM_F_REQUEST | NLM_F_ACK;
+  nlh->nlmsg_seq = ++seq;
+
+  if (send(fd, nlh, nlh->nlmsg_len, 0) < 0) {
+    rc = -errno;
+    OAILOG_ERROR(
+        LOG_GTPV1U, "Cannot send rtnetlink request: %s\n", strerror(errno));
+    close(fd);
+    return rc;
+  }
+
+  ssize_t len = recv(fd, reply, sizeof(reply), 0);
+  close(fd);
+  if (len < 0) {
+    OAILOG_ERROR(
+        LOG_GTPV1U, "Cannot read rtnetlink ack: %s\n", strerror(errno));
+    return -errno;
+  }
+
+  for (struct nlmsghdr* answer = (struct nlmsghdr*) reply;
+       NLMSG_OK(answer, (size_t) len); answer = NLMSG_NEXT(answer, len)) {
+    if (answer->nlmsg_type == NLMSG_ERROR) {
+      // error 0 is the ack
+      rc = ((struct nlmsgerr*) NLMSG_DATA(answer))->error;
+      break;
+    }
+  }
+  return rc;
+}
+
+//------------------------------------------------------------------------------
+int gtp_netlink_route_replace(
+    struct in_addr net, uint32_t mask, const char* dev) {
+  struct rtnl_request req;
+  memset(&req, 0, sizeof(req));
+
+  unsigned int ifindex = if_nametoindex(dev);
+  if (ifindex == 0) {
+    OAILOG_ERROR(LOG_GTPV1U, "Unknown device %s for route replace\n", dev);
+    return -ENODEV;
+  }
+
+  req.nlh.nlmsg_len    = NLMSG_LENGTH(sizeof(struct rtmsg));
+  req.nlh.nlmsg_type   = RTM_NEWROUTE;
+  req.nlh.nlmsg_flags  = NLM_F_CREATE | NLM_F_REPLACE;
+  req.rtm.rtm_family   = AF_INET;
+  req.rtm.rtm_dst_len  = mask;
+  req.rtm.rtm_table    = RT_TABLE_MAIN;
+  req.rtm.rtm_protocol = RTPROT_BOOT;
+  req.rtm.rtm_scope    = RT_SCOPE_LINK;
+  req.rtm.rtm_type     = RTN_UNICAST;
+  rtnl_add_attr(&req.nlh, RTA_DST, &net.s_addr, sizeof(net.s_addr));
+  rtnl_add_attr(&req.nlh, RTA_OIF, &ifindex, sizeof(ifindex));
+
+  int rc = rtnl_transact(&req.nlh);
+  if (rc) {
+    OAILOG_ERROR(
+        LOG_GTPV1U, "Cannot replace route %s/%u dev %s: %s\n", inet_ntoa(net),
+        mask, dev, strerror(-rc));
+  }
+  return rc;
+}
+
+//------------------------------------------------------------------------------
+int gtp_netlink_route_del(struct in_addr net, uint32_t mask) {
+  struct rtnl_request req;
+  memset(&req, 0, sizeof(req));
+
+  req.nlh.nlmsg_len   = NLMSG_LENGTH(sizeof(struct rtmsg));
+  req.nlh.nlmsg_type  = RTM_DELROUTE;
+  req.rtm.rtm_family  = AF_INET;
+  req.rtm.rtm_dst_len = mask;
+  req.rtm.rtm_table   = RT_TABLE_MAIN;
+  req.rtm.rtm_scope   = RT_SCOPE_NOWHERE;
+  rtnl_add_attr(&req.nlh, RTA_DST, &net.s_addr, sizeof(net.s_addr));
+
+  int rc = rtnl_transact(&req.nlh);
+  if (rc) {
+    OAILOG_ERROR(
+        LOG_GTPV1U, "Cannot delete route %s/%u: %s\n", inet_ntoa(net), mask,
+        strerror(-rc));
+  }
+  return rc;
+}
+
+//------------------------------------------------------------------------------
+status_code_e gtp_netlink_link_set_mtu(const char* dev, uint32_t mtu) {
+  struct ifreq ifr;
+  memset(&ifr, 0, sizeof(ifr));
+  strncpy(ifr.ifr_name, dev, IFNAMSIZ - 1);
+  ifr.ifr_mtu = mtu;
+
+  int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    OAILOG_ERROR(
+        LOG_GTPV1U, "Cannot open socket for MTU ioctl: %s\n", strerror(errno));
+    return RETURNerror;
+  }
+  int rc = ioctl(fd, SIOCSIFMTU, &ifr);
+  close(fd);
+  if (rc < 0) {
+    OAILOG_ERROR(
+        LOG_GTPV1U, "Cannot set %s MTU to %u: %s\n", dev, mtu,
+        strerror(errno));
+    return RETURNerror;
+  }
+  return RETURNok;
+}
+
+//------------------------------------------------------------------------------
+status_code_e gtp_netlink_addr_add(
+    struct in_addr addr, uint32_t mask, const char* dev) {
+  struct rtnl_request req;
+  memset(&req, 0, sizeof(req));
+
+  unsigned int ifindex = if_nametoindex(dev);
+  if (ifindex == 0) {
+    OAILOG_ERROR(LOG_GTPV1U, "Unknown device %s for address add\n", dev);
+    return RETURNerror;
+  }
+
+  req.nlh.nlmsg_len     = NLMSG_LENGTH(sizeof(struct ifaddrmsg));
+  req.nlh.nlmsg_type    = RTM_NEWADDR;
+  req.nlh.nlmsg_flags   = NLM_F_CREATE | NLM_F_EXCL;
+  req.ifa.ifa_family    = AF_INET;
+  req.ifa.ifa_prefixlen = mask;
+  req.ifa.ifa_index     = ifindex;
+  rtnl_add_attr(&req.nlh, IFA_LOCAL, &addr.s_addr, sizeof(addr.s_addr));
+  rtnl_add_attr(&req.nlh, IFA_ADDRESS, &addr.s_addr, sizeof(addr.s_addr));
+
+  int rc = rtnl_transact(&req.nlh);
+  if (rc) {
+    OAILOG_ERROR(
+        LOG_GTPV1U, "Cannot add address %s/%u to %s: %s\n", inet_ntoa(addr),
+        mask, dev, strerror(-rc));
+    return RETURNerror;
+  }
+  return RETURNok;
+}
+
+//------------------------------------------------------------------------------
+// Worker thread: a linked list of pending route updates drained in order
+//------------------------------------------------------------------------------
+enum gtp_netlink_op {
+  GTP_NETLINK_ROUTE_REPLACE,
+  GTP_NETLINK_ROUTE_DEL,
+};
+
+struct gtp_netlink_job {
+  enum gtp_netlink_op op;
+  struct in_addr net;
+  uint32_t mask;
+  char dev[IFNAMSIZ];
+  gtp_netlink_done_cb done_cb;
+  void* cb_arg;
+  struct gtp_netlink_job* next;
+};
+
+static struct {
+  bool started;
+  volatile bool stop;
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  struct gtp_netlink_job* head;
+  struct gtp_netlink_job* tail;
+} netlink_worker = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+};
+
+//------------------------------------------------------------------------------
+static void gtp_netlink_run_job(struct gtp_netlink_job* job) {
+  int result;
+  switch (job->op) {
+    case GTP_NETLINK_ROUTE_REPLACE:
+      result = gtp_netlink_route_replace(job->net, job->mask, job->dev);
+      break;
+    case GTP_NETLINK_ROUTE_DEL:
+      result = gtp_netlink_route_del(job->net, job->mask);
+      break;
+    default:
+      result = -EINVAL;
+      break;
+  }
+  if (job->done_cb) {
+    job->done_cb(result, job->cb_arg);
+  }
+}
+
+//------------------------------------------------------------------------------
+static void* gtp_netlink_worker_thread(
+    __attribute__((unused)) void* args_p) {
+  pthread_mutex_lock(&netlink_worker.lock);
+  for (;;) {
+    while (netlink_worker.head == NULL && !netlink_worker.stop) {
+      pthread_cond_wait(&netlink_worker.cond, &netlink_worker.lock);
+    }
+    struct gtp_netlink_job* job = netlink_worker.head;
+    if (job == NULL) {
+      // stop requested and the queue is drained
+      break;
+    }
+    netlink_worker.head = job->next;
+    if (netlink_worker.head == NULL) {
+      netlink_worker.tail = NULL;
+    }
+    pthread_mutex_unlock(&netlink_worker.lock);
+
+    gtp_netlink_run_job(job);
+    free(job);
+
+    pthread_mutex_lock(&netlink_worker.lock);
+  }
+  pthread_mutex_unlock(&netlink_worker.lock);
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+status_code_e gtp_netlink_start_worker(void) {
+  if (netlink_worker.started) {
+    return RETURNok;
+  }
+  netlink_worker.stop = false;
+  if (pthread_create(
+          &netlink_worker.thread, NULL, gtp_netlink_worker_thread, NULL)) {
+    OAILOG_ERROR(
+        LOG_GTPV1U, "Cannot start netlink worker thread: %s\n",
+        strerror(errno));
+    return RETURNerror;
+  }
+  netlink_worker.started = true;
+  return RETURNok;
+}
+
+//------------------------------------------------------------------------------
+void gtp_netlink_stop_worker(void) {
+  if (!netlink_worker.started) {
+    return;
+  }
+  pthread_mutex_lock(&netlink_worker.lock);
+  netlink_worker.stop = true;
+  pthread_cond_signal(&netlink_worker.cond);
+  pthread_mutex_unlock(&netlink_worker.lock);
+  pthread_join(netlink_worker.thread, NULL);
+  netlink_worker.started = false;
+}
+
+//------------------------------------------------------------------------------
+static status_code_e gtp_netlink_submit(struct gtp_netlink_job* job) {
+  if (!netlink_worker.started) {
+    // No worker (early init or failed start): run inline as before
+    gtp_netlink_run_job(job);
+    free(job);
+    return RETURNok;
+  }
+  pthread_mutex_lock(&netlink_worker.lock);
+  if (netlink_worker.tail) {
+    netlink_worker.tail->next = job;
+  } else {
+    netlink_worker.head = job;
+  }
+  netlink_worker.tail = job;
+  pthread_cond_signal(&netlink_worker.cond);
+  pthread_mutex_unlock(&netlink_worker.lock);
+  return RETURNok;
+}
+
+//------------------------------------------------------------------------------
+status_code_e gtp_netlink_route_replace_async(
+    struct in_addr net, uint32_t mask, const char* dev,
+    gtp_netlink_done_cb done_cb, void* cb_arg) {
+  struct gtp_netlink_job* job = calloc(1, sizeof(*job));
+  if (job == NULL) {
+    return RETURNerror;
+  }
+  job->op   = GTP_NETLINK_ROUTE_REPLACE;
+  job->net  = net;
+  job->mask = mask;
+  strncpy(job->dev, dev, IFNAMSIZ - 1);
+  job->done_cb = done_cb;
+  job->cb_arg  = cb_arg;
+  return gtp_netlink_submit(job);
+}
+
+//------------------------------------------------------------------------------
+status_code_e gtp_netlink_route_del_async(
+    struct in_addr net, uint32_t mask, gtp_netlink_done_cb done_cb,
+    void* cb_arg) {
+  struct gtp_netlink_job* job = calloc(1, sizeof(*job));
+  if (job == NULL) {
+    return RETURNerror;
+  }
+  job->op      = GTP_NETLINK_ROUTE_DEL;
+  job->net     = net;
+  job->mask    = mask;
+  job->done_cb = done_cb;
+  job->cb_arg  = cb_arg;
+  return gtp_netlink_submit(job);
+}
@@ -0,0 +1,61 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+/*! \file gtp_netlink.h
+ * \brief Direct rtnetlink replacements for the ip(8) shell-outs used to
+ * configure the GTP device and UE block routes. Synchronous helpers cover
+ * the init path; bearer setup submits route updates to a dedicated worker
+ * thread so no fork/exec or netlink round trip blocks tunnel creation.
+ */
+
+#ifndef FILE_GTP_NETLINK_SEEN
+#define FILE_GTP_NETLINK_SEEN
+
+#include <netinet/in.h>
+#include <stdint.h>
+
+#include "common_defs.h"
+
+// Invoked on the worker thread once a queued route update has been applied;
+// result is 0 on success or a negative errno
+typedef void (*gtp_netlink_done_cb)(int result, void* cb_arg);
+
+status_code_e gtp_netlink_start_worker(void);
+void gtp_netlink_stop_worker(void);
+
+/*
+ * Queue a route update for the worker thread. done_cb may be NULL when the
+ * caller does not need completion; failures are logged either way. Falls
+ * back to executing inline when the worker is not running.
+ */
+status_code_e gtp_netlink_route_replace_async(
+    struct in_addr net, uint32_t mask, const char* dev,
+    gtp_netlink_done_cb done_cb, void* cb_arg);
+status_code_e gtp_netlink_route_del_async(
+    struct in_addr net, uint32_t mask, gtp_netlink_done_cb done_cb,
+    void* cb_arg);
+
+// Synchronous primitives, return 0 on success or a negative errno
+int gtp_netlink_route_replace(struct in_addr net, uint32_t mask,
+                              const char* dev);
+int gtp_netlink_route_del(struct in_addr net, uint32_t mask);
+
+// Init-path helpers for the GTP device itself
+status_code_e gtp_netlink_link_set_mtu(const char* dev, uint32_t mtu);
+status_code_e gtp_netlink_addr_add(
+    struct in_addr addr, uint32_t mask, const char* dev);
+
+#endif /* FILE_GTP_NETLINK_SEEN */
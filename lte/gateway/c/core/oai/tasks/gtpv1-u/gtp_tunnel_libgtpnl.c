@@ -30,6 +30,8 @@
 
 #include "log.h"
 #include "common_defs.h"
+#include "gtp_netlink.h"
+#include "gtp_tunnel_queue.h"
 #include "gtpv1u.h"
 #include "gtpv1u_sgw_defs.h"
 
@@ -96,30 +98,15 @@ status_code_e libgtpnl_init(
       LOG_GTPV1U, "Using the GTP kernel mode (genl ID is %d)\n",
       gtp_nl.genl_id);
 
-  bstring system_cmd = bformat("ip link set dev %s mtu %u", GTP_DEVNAME, mtu);
-  int ret            = system((const char*) system_cmd->data);
-  if (ret) {
-    OAILOG_ERROR(
-        LOG_GTPV1U, "ERROR in system command %s: %d at %s:%u\n",
-        bdata(system_cmd), ret, __FILE__, __LINE__);
-    bdestroy(system_cmd);
+  if (gtp_netlink_link_set_mtu(GTP_DEVNAME, mtu) != RETURNok) {
     return RETURNerror;
   }
-  bdestroy(system_cmd);
 
   struct in_addr ue_gw;
   ue_gw.s_addr = ue_net->s_addr | htonl(1);
-  system_cmd =
-      bformat("ip addr add %s/%u dev %s", inet_ntoa(ue_gw), mask, GTP_DEVNAME);
-  ret = system((const char*) system_cmd->data);
-  if (ret) {
-    OAILOG_ERROR(
-        LOG_GTPV1U, "ERROR in system command %s: %d at %s:%u\n",
-        bdata(system_cmd), ret, __FILE__, __LINE__);
-    bdestroy(system_cmd);
+  if (gtp_netlink_addr_add(ue_gw, mask, GTP_DEVNAME) != RETURNok) {
     return RETURNerror;
   }
-  bdestroy(system_cmd);
 
   OAILOG_DEBUG(
       LOG_GTPV1U, "Setting route to reach UE net %s via %s\n",
@@ -130,6 +117,14 @@ status_code_e libgtpnl_init(
     return RETURNerror;
   }
 
+  // Batched tunnel ops go over their own socket; the synchronous libgtpnl
+  // entry points below stay available for callers needing the result inline
+  if (gtp_tunnel_queue_start(gtp_nl.genl_id, GTP_DEVNAME) != RETURNok) {
+    OAILOG_WARNING(
+        LOG_GTPV1U,
+        "Tunnel command queue unavailable, tunnel ops stay sequential\n");
+  }
+
   OAILOG_NOTICE(LOG_GTPV1U, "GTP kernel configured\n");
 
   return RETURNok;
@@ -138,6 +133,7 @@ status_code_e libgtpnl_init(
 status_code_e libgtpnl_uninit(void) {
   if (!gtp_nl.is_enabled) return -1;
 
+  gtp_tunnel_queue_stop();
   return gtp_dev_destroy(GTP_DEVNAME);
 }
 
@@ -0,0 +1,345 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+/*! \file gtp_tunnel_queue.c
+ * \brief Batched command queue for kernel GTP module tunnel operations
+ *
+ * libgtpnl performs one request/ack round trip per tunnel, so mass-bearer
+ * events (S1 setup after an eNB restart, paging storms) pay tens of
+ * thousands of sequential netlink transactions. This queue accumulates
+ * tunnel adds/deletes and a commit thread drains everything pending in one
+ * pass: all messages of a batch are written to the kernel in a single
+ * send(), then the per-message acks are collected and fanned out to the
+ * queued operations through their completion callbacks. The kernel
+ * processes each nlmsghdr of the send independently, so a failed operation
+ * fails alone and the rest of the batch still commits.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <linux/genetlink.h>
+#include <linux/gtp.h>
+#include <linux/netlink.h>
+#include <net/if.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "log.h"
+#include "common_defs.h"
+#include "gtp_tunnel_queue.h"
+
+// Upper bound on operations committed per send; a drain larger than this
+// simply commits in several consecutive sends
+#define GTP_TUNNEL_BATCH_MAX 64
+// Fixed headers plus the six u32/be32 attributes a v1 tunnel add carries
+#define GTP_TUNNEL_MSG_MAX 128
+#define GTP_TUNNEL_REPLY_BUFFER_SIZE 8192
+
+enum gtp_tunnel_queue_op {
+  GTP_TUNNEL_QUEUE_ADD,
+  GTP_TUNNEL_QUEUE_DEL,
+};
+
+struct gtp_tunnel_queue_job {
+  enum gtp_tunnel_queue_op op;
+  struct in_addr ue;
+  struct in_addr enb;
+  uint32_t i_tei;
+  uint32_t o_tei;
+  uint32_t seq;  // netlink sequence number once the batch is built
+  int result;
+  gtp_tunnel_queue_done_cb done_cb;
+  void* cb_arg;
+  struct gtp_tunnel_queue_job* next;
+};
+
+static struct {
+  bool started;
+  volatile bool stop;
+  int fd;
+  int genl_id;
+  unsigned int ifindex;
+  uint32_t seq;
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  struct gtp_tunnel_queue_job* head;
+  struct gtp_tunnel_queue_job* tail;
+} tunnel_queue = {
+    .fd   = -1,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+};
+
+//------------------------------------------------------------------------------
+static void gtp_tunnel_queue_add_attr(
+    struct nlmsghdr* nlh, int type, const void* data, size_t len) {
+  struct nlattr* nla =
+      (struct nlattr*) ((char*) nlh + NLMSG_ALIGN(nlh->nlmsg_len));
+  nla->nla_type = type;
+  nla->nla_len  = NLA_HDRLEN + len;
+  memcpy((char*) nla + NLA_HDRLEN, data, len);
+  nlh->nlmsg_len = NLMSG_ALIGN(nlh->nlmsg_len) + NLMSG_ALIGN(nla->nla_len);
+}
+
+/*
+ * Append one job as a genetlink message at buf. Returns the aligned size
+ * the message occupies.
+ */
+static size_t gtp_tunnel_queue_build_msg(
+    struct gtp_tunnel_queue_job* job, char* buf) {
+  struct nlmsghdr* nlh   = (struct nlmsghdr*) buf;
+  struct genlmsghdr* gnl = (struct genlmsghdr*) (buf + NLMSG_HDRLEN);
+  uint32_t gtp_version   = 1;
+
+  nlh->nlmsg_len   = NLMSG_LENGTH(GENL_HDRLEN);
+  nlh->nlmsg_type  = tunnel_queue.genl_id;
+  nlh->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
+  nlh->nlmsg_seq   = ++tunnel_queue.seq;
+  nlh->nlmsg_pid   = 0;
+  gnl->cmd =
+      (job->op == GTP_TUNNEL_QUEUE_ADD) ? GTP_CMD_NEWPDP : GTP_CMD_DELPDP;
+  gnl->version = 0;
+
+  gtp_tunnel_queue_add_attr(
+      nlh, GTPA_VERSION, &gtp_version, sizeof(gtp_version));
+  gtp_tunnel_queue_add_attr(
+      nlh, GTPA_LINK, &tunnel_queue.ifindex, sizeof(tunnel_queue.ifindex));
+  gtp_tunnel_queue_add_attr(
+      nlh, GTPA_I_TEI, &job->i_tei, sizeof(job->i_tei));
+  if (job->op == GTP_TUNNEL_QUEUE_ADD) {
+    gtp_tunnel_queue_add_attr(
+        nlh, GTPA_O_TEI, &job->o_tei, sizeof(job->o_tei));
+    gtp_tunnel_queue_add_attr(
+        nlh, GTPA_MS_ADDRESS, &job->ue.s_addr, sizeof(job->ue.s_addr));
+    gtp_tunnel_queue_add_attr(
+        nlh, GTPA_PEER_ADDRESS, &job->enb.s_addr, sizeof(job->enb.s_addr));
+  }
+  job->seq = nlh->nlmsg_seq;
+  return NLMSG_ALIGN(nlh->nlmsg_len);
+}
+
+/*
+ * Commit up to GTP_TUNNEL_BATCH_MAX jobs of the list in one send and
+ * collect their acks. Each job's result is filled from the ack carrying
+ * its sequence number.
+ */
+static void gtp_tunnel_queue_commit(
+    struct gtp_tunnel_queue_job* jobs, size_t count) {
+  char buf[GTP_TUNNEL_BATCH_MAX * GTP_TUNNEL_MSG_MAX];
+  char reply[GTP_TUNNEL_REPLY_BUFFER_SIZE];
+  size_t used = 0;
+
+  for (struct gtp_tunnel_queue_job* job = jobs; job != NULL;
+       job = job->next) {
+    used += gtp_tunnel_queue_build_msg(job, buf + used);
+  }
+
+  if (send(tunnel_queue.fd, buf, used, 0) < 0) {
+    int err = -errno;
+    OAILOG_ERROR(
+        LOG_GTPV1U, "Cannot send GTP tunnel batch of %zu: %s\n", count,
+        strerror(errno));
+    for (struct gtp_tunnel_queue_job* job = jobs; job != NULL;
+         job = job->next) {
+      job->result = err;
+    }
+    return;
+  }
+
+  // One NLMSG_ERROR ack per request, in order but possibly split across
+  // datagrams; stop once every job of the batch has been answered
+  size_t acked = 0;
+  while (acked < count) {
+    ssize_t len = recv(tunnel_queue.fd, reply, sizeof(reply), 0);
+    if (len < 0) {
+      OAILOG_ERROR(
+          LOG_GTPV1U, "Cannot read GTP tunnel batch acks: %s\n",
+          strerror(errno));
+      break;
+    }
+    for (struct nlmsghdr* answer = (struct nlmsghdr*) reply;
+         NLMSG_OK(answer, (size_t) len); answer = NLMSG_NEXT(answer, len)) {
+      if (answer->nlmsg_type != NLMSG_ERROR) {
+        continue;
+      }
+      int err = ((struct nlmsgerr*) NLMSG_DATA(answer))->error;
+      for (struct gtp_tunnel_queue_job* job = jobs; job != NULL;
+           job = job->next) {
+        if (job->seq == answer->nlmsg_seq) {
+          job->result = err;
+          break;
+        }
+      }
+      acked++;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+static void* gtp_tunnel_queue_thread(__attribute__((unused)) void* args_p) {
+  pthread_mutex_lock(&tunnel_queue.lock);
+  for (;;) {
+    while (tunnel_queue.head == NULL && !tunnel_queue.stop) {
+      pthread_cond_wait(&tunnel_queue.cond, &tunnel_queue.lock);
+    }
+    if (tunnel_queue.head == NULL) {
+      // stop requested and the queue is drained
+      break;
+    }
+
+    // Detach up to a batch worth of jobs so submitters never wait on the
+    // kernel round trip
+    struct gtp_tunnel_queue_job* jobs = tunnel_queue.head;
+    struct gtp_tunnel_queue_job* last = jobs;
+    size_t count                      = 1;
+    while (last->next != NULL && count < GTP_TUNNEL_BATCH_MAX) {
+      last = last->next;
+      count++;
+    }
+    tunnel_queue.head = last->next;
+    if (tunnel_queue.head == NULL) {
+      tunnel_queue.tail = NULL;
+    }
+    last->next = NULL;
+    pthread_mutex_unlock(&tunnel_queue.lock);
+
+    gtp_tunnel_queue_commit(jobs, count);
+    while (jobs != NULL) {
+      struct gtp_tunnel_queue_job* job = jobs;
+      jobs                             = jobs->next;
+      if (job->result) {
+        OAILOG_ERROR(
+            LOG_GTPV1U, "GTP tunnel %s (TEI %u) failed: %s\n",
+            job->op == GTP_TUNNEL_QUEUE_ADD ? "add" : "delete", job->i_tei,
+            strerror(-job->result));
+      }
+      if (job->done_cb) {
+        job->done_cb(job->result, job->cb_arg);
+      }
+      free(job);
+    }
+
+    pthread_mutex_lock(&tunnel_queue.lock);
+  }
+  pthread_mutex_unlock(&tunnel_queue.lock);
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+status_code_e gtp_tunnel_queue_start(int genl_id, const char* dev) {
+  if (tunnel_queue.started) {
+    return RETURNok;
+  }
+  tunnel_queue.ifindex = if_nametoindex(dev);
+  if (tunnel_queue.ifindex == 0) {
+    OAILOG_ERROR(
+        LOG_GTPV1U, "Unknown device %s for tunnel command queue\n", dev);
+    return RETURNerror;
+  }
+  tunnel_queue.fd =
+      socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_GENERIC);
+  if (tunnel_queue.fd < 0) {
+    OAILOG_ERROR(
+        LOG_GTPV1U, "Cannot open genetlink socket for tunnel command queue: "
+        "%s\n", strerror(errno));
+    return RETURNerror;
+  }
+  tunnel_queue.genl_id = genl_id;
+  tunnel_queue.stop    = false;
+  if (pthread_create(
+          &tunnel_queue.thread, NULL, gtp_tunnel_queue_thread, NULL)) {
+    OAILOG_ERROR(
+        LOG_GTPV1U, "Cannot start tunnel commit thread: %s\n",
+        strerror(errno));
+    close(tunnel_queue.fd);
+    tunnel_queue.fd = -1;
+    return RETURNerror;
+  }
+  tunnel_queue.started = true;
+  return RETURNok;
+}
+
+//------------------------------------------------------------------------------
+void gtp_tunnel_queue_stop(void) {
+  if (!tunnel_queue.started) {
+    return;
+  }
+  pthread_mutex_lock(&tunnel_queue.lock);
+  tunnel_queue.stop = true;
+  pthread_cond_signal(&tunnel_queue.cond);
+  pthread_mutex_unlock(&tunnel_queue.lock);
+  pthread_join(tunnel_queue.thread, NULL);
+  close(tunnel_queue.fd);
+  tunnel_queue.fd      = -1;
+  tunnel_queue.started = false;
+}
+
+//------------------------------------------------------------------------------
+static status_code_e gtp_tunnel_queue_submit(
+    struct gtp_tunnel_queue_job* job) {
+  if (!tunnel_queue.started) {
+    free(job);
+    return RETURNerror;
+  }
+  pthread_mutex_lock(&tunnel_queue.lock);
+  if (tunnel_queue.tail) {
+    tunnel_queue.tail->next = job;
+  } else {
+    tunnel_queue.head = job;
+  }
+  tunnel_queue.tail = job;
+  pthread_cond_signal(&tunnel_queue.cond);
+  pthread_mutex_unlock(&tunnel_queue.lock);
+  return RETURNok;
+}
+
+//------------------------------------------------------------------------------
+status_code_e gtp_tunnel_queue_add_tunnel(
+    struct in_addr ue, struct in_addr enb, uint32_t i_tei, uint32_t o_tei,
+    gtp_tunnel_queue_done_cb done_cb, void* cb_arg) {
+  struct gtp_tunnel_queue_job* job = calloc(1, sizeof(*job));
+  if (job == NULL) {
+    return RETURNerror;
+  }
+  job->op      = GTP_TUNNEL_QUEUE_ADD;
+  job->ue      = ue;
+  job->enb     = enb;
+  job->i_tei   = i_tei;
+  job->o_tei   = o_tei;
+  job->done_cb = done_cb;
+  job->cb_arg  = cb_arg;
+  return gtp_tunnel_queue_submit(job);
+}
+
+//------------------------------------------------------------------------------
+status_code_e gtp_tunnel_queue_del_tunnel(
+    uint32_t i_tei, gtp_tunnel_queue_done_cb done_cb, void* cb_arg) {
+  struct gtp_tunnel_queue_job* job = calloc(1, sizeof(*job));
+  if (job == NULL) {
+    return RETURNerror;
+  }
+  job->op      = GTP_TUNNEL_QUEUE_DEL;
+  job->i_tei   = i_tei;
+  job->done_cb = done_cb;
+  job->cb_arg  = cb_arg;
+  return gtp_tunnel_queue_submit(job);
+}
@@ -0,0 +1,57 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+/*! \file gtp_tunnel_queue.h
+ * \brief Batched command queue for kernel GTP module tunnel operations
+ */
+
+#ifndef FILE_GTP_TUNNEL_QUEUE_SEEN
+#define FILE_GTP_TUNNEL_QUEUE_SEEN
+
+#include <arpa/inet.h>
+#include <stdint.h>
+
+#include "common_defs.h"
+
+/*
+ * Invoked once per queued operation after its batch commit. result is 0 on
+ * success or a negative errno from the kernel ack for that operation.
+ */
+typedef void (*gtp_tunnel_queue_done_cb)(int result, void* cb_arg);
+
+/*
+ * Start the commit thread. genl_id is the GTP generic netlink family id
+ * resolved at device setup, dev the GTP device the tunnels hang off.
+ */
+status_code_e gtp_tunnel_queue_start(int genl_id, const char* dev);
+
+/* Drain the queue and join the commit thread. */
+void gtp_tunnel_queue_stop(void);
+
+/*
+ * Queue a v1 tunnel add. The operation is committed with every other
+ * operation pending at the next drain in a single netlink send; done_cb
+ * fires with the per-operation kernel ack.
+ */
+status_code_e gtp_tunnel_queue_add_tunnel(
+    struct in_addr ue, struct in_addr enb, uint32_t i_tei, uint32_t o_tei,
+    gtp_tunnel_queue_done_cb done_cb, void* cb_arg);
+
+/* Queue a v1 tunnel delete (the kernel keys v1 tunnels by incoming TEID). */
+status_code_e gtp_tunnel_queue_del_tunnel(
+    uint32_t i_tei, gtp_tunnel_queue_done_cb done_cb, void* cb_arg);
+
+#endif /* FILE_GTP_TUNNEL_QUEUE_SEEN */
@@ -0,0 +1,233 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+/*! \file gtpv1u_echo_responder.c
+ * \brief GTP-U path management fast path for the kernel GTP mode
+ *
+ * The kernel GTP module decapsulates T-PDUs itself but delivers every
+ * other GTP-U message type to the bound S1-U UDP socket. Echo requests
+ * are answered directly in the responder thread from a preformatted
+ * template buffer, without touching ITTI or any MME state; error
+ * indications
+ * are counted and coalesced into one rate-limited log line per second
+ * so a flood of peer probes cannot consume signaling budget.
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+
+#include "log.h"
+#include "service303.h"
+#include "gtpv1u_echo_responder.h"
+
+// GTPv1-U message types (3GPP TS 29.281 table 6.1-1)
+#define GTPU_MSG_ECHO_REQUEST 1
+#define GTPU_MSG_ECHO_RESPONSE 2
+#define GTPU_MSG_ERROR_INDICATION 26
+
+// Mandatory GTPv1-U header: flags, type, length, TEID
+#define GTPU_HEADER_SIZE 8
+// version 1, protocol type GTP, sequence number present
+#define GTPU_FLAGS_V1_PT_S 0x32
+#define GTPU_VERSION_MASK 0xe0
+#define GTPU_VERSION_1 0x20
+#define GTPU_FLAGS_PT 0x10
+#define GTPU_FLAGS_S 0x02
+
+#define GTPU_IE_RECOVERY 14
+
+#define ECHO_RESPONDER_RECV_BUFFER_SIZE 2048
+// Log at most one error indication line per window, count the rest
+#define ERROR_IND_COALESCE_WINDOW_SEC 1
+
+static struct {
+  int fd;
+  bool started;
+  volatile bool stop;
+  pthread_t thread;
+} echo_responder;
+
+//------------------------------------------------------------------------------
+static void gtpv1u_send_echo_response(
+    const uint8_t* request, const struct sockaddr_in* peer, socklen_t peerlen) {
+  /*
+   * Echo response: mandatory header with TEID 0, sequence number echoed
+   * from the request, and a recovery IE (restart counter, unused and set
+   * to 0 per TS 29.281 section 8.2). Only the sequence number changes
+   * between responses.
+   */
+  static uint8_t echo_resp[14] = {
+      GTPU_FLAGS_V1_PT_S,
+      GTPU_MSG_ECHO_RESPONSE,
+      0x00,
+      0x06,  // length: seq + n-pdu + next-ext + recovery IE
+      0x00,
+      0x00,
+      0x00,
+      0x00,  // TEID 0
+      0x00,
+      0x00,  // sequence number, patched per request
+      0x00,  // n-pdu number
+      0x00,  // next extension header type
+      GTPU_IE_RECOVERY,
+      0x00,
+  };
+
+  if (request[0] & GTPU_FLAGS_S) {
+    echo_resp[8] = request[GTPU_HEADER_SIZE];
+    echo_resp[9] = request[GTPU_HEADER_SIZE + 1];
+  } else {
+    echo_resp[8] = 0;
+    echo_resp[9] = 0;
+  }
+
+  if (sendto(
+          echo_responder.fd, echo_resp, sizeof(echo_resp), 0,
+          (const struct sockaddr*) peer, peerlen) < 0) {
+    OAILOG_WARNING(
+        LOG_GTPV1U, "Failed to send GTP echo response to %s: %s\n",
+        inet_ntoa(peer->sin_addr), strerror(errno));
+  }
+}
+
+//------------------------------------------------------------------------------
+static void gtpv1u_coalesce_error_indication(const struct sockaddr_in* peer) {
+  static time_t window_start;
+  static uint32_t window_count;
+  time_t now = time(NULL);
+
+  increment_counter("gtpv1u_error_indication_received", 1, NO_LABELS);
+
+  if (now - window_start >= ERROR_IND_COALESCE_WINDOW_SEC) {
+    if (window_count > 1) {
+      OAILOG_WARNING(
+          LOG_GTPV1U, "Suppressed %u GTP error indication(s) in last window\n",
+          window_count - 1);
+    }
+    OAILOG_WARNING(
+        LOG_GTPV1U, "Received GTP error indication from %s\n",
+        inet_ntoa(peer->sin_addr));
+    window_start = now;
+    window_count = 1;
+  } else {
+    window_count++;
+  }
+}
+
+//------------------------------------------------------------------------------
+static void* gtpv1u_echo_responder_task(void* args) {
+  uint8_t buffer[ECHO_RESPONDER_RECV_BUFFER_SIZE];
+  struct sockaddr_in peer;
+  socklen_t peerlen;
+  ssize_t len;
+  size_t min_len;
+
+  OAILOG_INFO(LOG_GTPV1U, "GTP-U echo responder started\n");
+  while (!echo_responder.stop) {
+    peerlen = sizeof(peer);
+    len     = recvfrom(
+        echo_responder.fd, buffer, sizeof(buffer), 0,
+        (struct sockaddr*) &peer, &peerlen);
+    if (len < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        continue;
+      }
+      OAILOG_ERROR(
+          LOG_GTPV1U, "GTP-U echo responder recv error: %s\n",
+          strerror(errno));
+      break;
+    }
+
+    // Need the mandatory header, plus the sequence field if flagged
+    min_len = GTPU_HEADER_SIZE;
+    if (len >= 1 && (buffer[0] & GTPU_FLAGS_S)) {
+      min_len += 2;
+    }
+    if ((size_t) len < min_len ||
+        (buffer[0] & GTPU_VERSION_MASK) != GTPU_VERSION_1 ||
+        !(buffer[0] & GTPU_FLAGS_PT)) {
+      continue;
+    }
+
+    switch (buffer[1]) {
+      case GTPU_MSG_ECHO_REQUEST:
+        gtpv1u_send_echo_response(buffer, &peer, peerlen);
+        increment_counter("gtpv1u_echo_request_answered", 1, NO_LABELS);
+        break;
+
+      case GTPU_MSG_ERROR_INDICATION:
+        gtpv1u_coalesce_error_indication(&peer);
+        break;
+
+      default:
+        // Other path management messages need no answer
+        break;
+    }
+  }
+  OAILOG_INFO(LOG_GTPV1U, "GTP-U echo responder stopped\n");
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+int gtpv1u_start_echo_responder(int fd1u) {
+  struct timeval rcv_timeout = {.tv_sec = 1, .tv_usec = 0};
+
+  if (echo_responder.started) {
+    return 0;
+  }
+  if (fd1u < 0) {
+    OAILOG_ERROR(
+        LOG_GTPV1U, "Cannot start GTP-U echo responder without S1-U socket\n");
+    return -1;
+  }
+
+  // Bounded recv timeout so the thread notices a stop request
+  if (setsockopt(
+          fd1u, SOL_SOCKET, SO_RCVTIMEO, &rcv_timeout, sizeof(rcv_timeout)) <
+      0) {
+    OAILOG_ERROR(
+        LOG_GTPV1U, "Failed to set S1-U socket receive timeout: %s\n",
+        strerror(errno));
+    return -1;
+  }
+
+  echo_responder.fd   = fd1u;
+  echo_responder.stop = false;
+  if (pthread_create(
+          &echo_responder.thread, NULL, &gtpv1u_echo_responder_task, NULL)) {
+    OAILOG_ERROR(LOG_GTPV1U, "Failed to create GTP-U echo responder thread\n");
+    return -1;
+  }
+  echo_responder.started = true;
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+void gtpv1u_stop_echo_responder(void) {
+  if (!echo_responder.started) {
+    return;
+  }
+  echo_responder.stop = true;
+  pthread_join(echo_responder.thread, NULL);
+  echo_responder.started = false;
+}
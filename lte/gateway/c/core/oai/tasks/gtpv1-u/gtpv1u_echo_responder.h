@@ -0,0 +1,37 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+/*! \file gtpv1u_echo_responder.h
+ * \brief GTP-U path management fast path for the kernel GTP mode
+ */
+
+#ifndef FILE_GTPV1U_ECHO_RESPONDER_SEEN
+#define FILE_GTPV1U_ECHO_RESPONDER_SEEN
+
+/** \brief Start the GTP-U echo responder thread on the S1-U socket.
+ * The kernel GTP module consumes T-PDUs and queues path management
+ * messages (echo requests, error indications) on the socket; the
+ * responder answers echoes in place and coalesces error indications
+ * so peer probe floods never enter the signaling path.
+ *  \param fd1u bound S1-U UDP socket (GTPv1-U port)
+ *  @returns -1 on failure, 0 otherwise
+ **/
+int gtpv1u_start_echo_responder(int fd1u);
+
+/** \brief Stop the GTP-U echo responder thread if it is running */
+void gtpv1u_stop_echo_responder(void);
+
+#endif /* FILE_GTPV1U_ECHO_RESPONDER_SEEN */
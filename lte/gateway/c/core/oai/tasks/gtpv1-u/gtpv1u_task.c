@@ -31,6 +31,8 @@
 #include "intertask_interface.h"
 #include "gtpv1u.h"
 #include "gtpv1u_sgw_defs.h"
+#include "gtpv1u_echo_responder.h"
+#include "gtp_netlink.h"
 #include "gtp_tunnel_upf.h"
 #include "pgw_ue_ip_address_alloc.h"
 #include "intertask_interface_types.h"
@@ -42,46 +44,36 @@ static struct in_addr current_ue_net;
 static int current_ue_net_mask;
 
 //------------------------------------------------------------------------------
+static void add_route_done(int result, __attribute__((unused)) void* cb_arg) {
+  if (result) {
+    // gtp_netlink already logged the failure; drop the cached route so the
+    // next tunnel add retries the update
+    current_ue_net_mask = 0;
+  }
+}
+
 static void add_route_for_ue_block(struct in_addr ue_net, uint32_t mask) {
   if (ue_net.s_addr == htonl(INADDR_ANY) || mask == 0) {
     return;
   }
-  // Use replace to avoid error related to existing routes.
-  bstring system_cmd = bformat(
-      "ip route replace %s/%u dev %s", inet_ntoa(ue_net), mask,
-      gtp_tunnel_ops->get_dev_name());
-  int ret = system((const char*) system_cmd->data);
-  if (ret) {
-    OAILOG_ERROR(
-        LOG_GTPV1U, "ERROR in system command %s: %d at %s:%u\n",
-        bdata(system_cmd), ret, __FILE__, __LINE__);
-    bdestroy(system_cmd);
-    return;
-  }
-
-  OAILOG_DEBUG(LOG_GTPV1U, "route updated: %s\n", bdata(system_cmd));
-  bdestroy(system_cmd);
-  // cache updated route.
+  // Cache the route before the netlink worker confirms it so back-to-back
+  // tunnel adds in the same block do not queue duplicate updates; the
+  // completion callback clears the cache if the kernel rejects it.
   current_ue_net      = ue_net;
   current_ue_net_mask = mask;
+  // Replace rather than add to avoid errors related to existing routes.
+  if (gtp_netlink_route_replace_async(
+          ue_net, mask, gtp_tunnel_ops->get_dev_name(), add_route_done,
+          NULL) != RETURNok) {
+    current_ue_net_mask = 0;
+  }
 }
 
 static void del_route_for_ue_block(struct in_addr ue_net, uint32_t mask) {
   if (ue_net.s_addr == htonl(INADDR_ANY) || mask == 0) {
     return;
   }
-  bstring system_cmd = bformat("ip route del %s/%u", inet_ntoa(ue_net), mask);
-  int ret            = system((const char*) system_cmd->data);
-  if (ret) {
-    OAILOG_ERROR(
-        LOG_GTPV1U, "ERROR in system command %s: %d at %s:%u\n",
-        bdata(system_cmd), ret, __FILE__, __LINE__);
-    bdestroy(system_cmd);
-    return;
-  }
-
-  OAILOG_DEBUG(LOG_GTPV1U, "Deleted route%s\n", bdata(system_cmd));
-  bdestroy(system_cmd);
+  gtp_netlink_route_del_async(ue_net, mask, NULL, NULL);
   current_ue_net_mask = 0;
 }
 
@@ -165,6 +157,23 @@ int gtpv1u_init(
 
   // END-GTP quick integration only for evaluation purpose
 
+#if !ENABLE_OPENFLOW
+  // In kernel GTP mode userspace owns the S1-U socket; answer path
+  // management probes there instead of leaving the queue unread.
+  if (gtpv1u_start_echo_responder(spgw_state_p->gtpv1u_data.fd1u) != 0) {
+    OAILOG_ERROR(LOG_GTPV1U, "Could not start GTP-U echo responder\n");
+  }
+#endif
+
+  // Route updates triggered from tunnel adds run on the netlink worker so
+  // bearer setup does not wait on the kernel; without the worker they are
+  // executed inline as before.
+  if (gtp_netlink_start_worker() != RETURNok) {
+    OAILOG_ERROR(
+        LOG_GTPV1U, "Could not start netlink worker, route updates will "
+                    "run inline\n");
+  }
+
   // Add route to avoid updating routing during UE attach.
   add_route_for_ue_block(netaddr, netmask);
 
@@ -238,5 +247,7 @@ int gtpv1u_del_s8_tunnel(
 
 //------------------------------------------------------------------------------
 void gtpv1u_exit(void) {
+  gtpv1u_stop_echo_responder();
+  gtp_netlink_stop_worker();
   gtp_tunnel_ops->uninit();
 }
@@ -111,8 +111,10 @@ status_code_e select_pdn_type(
 //------------------------------------------------------------------------------
 struct apn_configuration_s* mme_app_select_apn(
     ue_mm_context_t* const ue_context, int* esm_cause) {
+  apn_config_profile_t* apn_config_profile =
+      &ue_context->subscription->apn_config_profile;
   context_identifier_t default_context_identifier =
-      ue_context->apn_config_profile.context_identifier;
+      apn_config_profile->context_identifier;
   int index;
   int rc = RETURNok;
 
@@ -121,16 +123,16 @@ struct apn_configuration_s* mme_app_select_apn(
   esm_proc_pdn_type_t ue_selected_pdn_type =
       ue_context->emm_context.esm_ctx.esm_proc_data->pdn_type;
 
-  for (index = 0; index < ue_context->apn_config_profile.nb_apns; index++) {
+  for (index = 0; index < apn_config_profile->nb_apns; index++) {
     if (!ue_selected_apn) {
       /*
        * OK we got our default APN
        */
-      if (ue_context->apn_config_profile.apn_configuration[index]
+      if (apn_config_profile->apn_configuration[index]
               .context_identifier == default_context_identifier) {
         // Select PDN Type
         rc = select_pdn_type(
-            &ue_context->apn_config_profile.apn_configuration[index],
+            &apn_config_profile->apn_configuration[index],
             ue_selected_pdn_type, esm_cause);
         if (*esm_cause == ESM_CAUSE_UNKNOWN_PDN_TYPE || rc == RETURNerror) {
           return NULL;
@@ -138,11 +140,11 @@ struct apn_configuration_s* mme_app_select_apn(
         OAILOG_INFO(
             LOG_MME_APP,
             "Selected APN <%s>, PDN Type <%d> for UE " IMSI_64_FMT "\n",
-            ue_context->apn_config_profile.apn_configuration[index]
+            apn_config_profile->apn_configuration[index]
                 .service_selection,
-            ue_context->apn_config_profile.apn_configuration[index].pdn_type,
+            apn_config_profile->apn_configuration[index].pdn_type,
             ue_context->emm_context._imsi64);
-        return &ue_context->apn_config_profile.apn_configuration[index];
+        return &apn_config_profile->apn_configuration[index];
       }
     } else {
       /*
@@ -150,13 +152,13 @@ struct apn_configuration_s* mme_app_select_apn(
        */
       if (biseqcaselessblk(
               ue_selected_apn,
-              ue_context->apn_config_profile.apn_configuration[index]
+              apn_config_profile->apn_configuration[index]
                   .service_selection,
-              strlen(ue_context->apn_config_profile.apn_configuration[index]
+              strlen(apn_config_profile->apn_configuration[index]
                          .service_selection)) == 1) {
         // Select PDN Type
         rc = select_pdn_type(
-            &ue_context->apn_config_profile.apn_configuration[index],
+            &apn_config_profile->apn_configuration[index],
             ue_selected_pdn_type, esm_cause);
         if (*esm_cause == ESM_CAUSE_UNKNOWN_PDN_TYPE || rc == RETURNerror) {
           return NULL;
@@ -164,12 +166,12 @@ struct apn_configuration_s* mme_app_select_apn(
         OAILOG_INFO(
             LOG_MME_APP,
             "Selected APN <%s>, PDN Type <%d> for UE " IMSI_64_FMT "\n",
-            ue_context->apn_config_profile.apn_configuration[index]
+            apn_config_profile->apn_configuration[index]
                 .service_selection,
-            ue_context->apn_config_profile.apn_configuration[index].pdn_type,
+            apn_config_profile->apn_configuration[index].pdn_type,
             ue_context->emm_context._imsi64);
 
-        return &ue_context->apn_config_profile.apn_configuration[index];
+        return &apn_config_profile->apn_configuration[index];
       }
     }
   }
@@ -181,12 +183,14 @@ struct apn_configuration_s* mme_app_select_apn(
 struct apn_configuration_s* mme_app_get_apn_config(
     ue_mm_context_t* const ue_context,
     const context_identifier_t context_identifier) {
+  apn_config_profile_t* apn_config_profile =
+      &ue_context->subscription->apn_config_profile;
   int index;
 
-  for (index = 0; index < ue_context->apn_config_profile.nb_apns; index++) {
-    if (ue_context->apn_config_profile.apn_configuration[index]
+  for (index = 0; index < apn_config_profile->nb_apns; index++) {
+    if (apn_config_profile->apn_configuration[index]
             .context_identifier == context_identifier) {
-      return &ue_context->apn_config_profile.apn_configuration[index];
+      return &apn_config_profile->apn_configuration[index];
     }
   }
   return NULL;
@@ -31,6 +31,7 @@
 #include <netinet/in.h>
 
 #include "bstrlib.h"
+#include "bstr_intern.h"
 #include "dynamic_memory_check.h"
 #include "log.h"
 #include "conversions.h"
@@ -92,6 +93,46 @@ static void send_s11_modify_bearer_request(
     ue_mm_context_t* ue_context_p, pdn_context_t* pdn_context_p,
     MessageDef* message_p);
 
+/* Paging aggregation: paging requests are buffered and flushed to the S1AP
+ * task as one batch per tick, so a paging storm costs S1AP one eNB table walk
+ * per batch instead of one per paged UE. The tick can be overridden with the
+ * MAGMA_PAGING_BATCH_TICK_MSEC environment variable; a tick of zero disables
+ * batching and forwards each request on its own. Only touched from the
+ * mme_app task thread. */
+#define MME_APP_PAGING_BATCH_MAX_UES 64
+#define MME_APP_PAGING_BATCH_TICK_MSEC 20
+
+static itti_s1ap_paging_request_t
+    pending_paging_requests[MME_APP_PAGING_BATCH_MAX_UES];
+static uint16_t pending_paging_count = 0;
+static int paging_batch_timer_id     = MME_APP_TIMER_INACTIVE_ID;
+
+static status_code_e mme_app_enqueue_paging_request(
+    const itti_s1ap_paging_request_t* paging_request);
+
+/* Implicit-detach sweep: expired implicit-detach timers are queued and
+ * drained in paced batches instead of each expiry running the full detach
+ * machinery on its own zloop callback. After a transport outage tens of
+ * thousands expire nearly simultaneously; the token bucket caps how many
+ * detaches run per tick so live traffic keeps its latency budget, and the
+ * NAS state write is amortized over each batch. The tick and drain rate
+ * can be overridden with the MAGMA_DETACH_SWEEP_TICK_MSEC and
+ * MAGMA_DETACH_SWEEP_RATE_PER_SEC environment variables; a tick of zero
+ * disables the sweep and detaches each UE on expiry as before. Only
+ * touched from the mme_app task thread. */
+#define MME_APP_DETACH_SWEEP_TICK_MSEC 100
+#define MME_APP_DETACH_SWEEP_RATE_PER_SEC 500
+#define MME_APP_DETACH_SWEEP_BURST 100
+
+static mme_ue_s1ap_id_t* detach_sweep_queue = NULL;
+static uint32_t detach_sweep_capacity       = 0;
+static uint32_t detach_sweep_head           = 0;
+static uint32_t detach_sweep_count          = 0;
+static int detach_sweep_timer_id            = MME_APP_TIMER_INACTIVE_ID;
+static double detach_sweep_tokens           = 0;
+
+static void mme_app_detach_sweep_enqueue(mme_ue_s1ap_id_t ue_id);
+
 status_code_e send_modify_bearer_req(mme_ue_s1ap_id_t ue_id, ebi_t ebi) {
   OAILOG_FUNC_IN(LOG_MME_APP);
 
@@ -423,8 +464,10 @@ void mme_app_handle_conn_est_cnf(
       "UE radio context already cached: %s\n",
       ue_context_p->ue_radio_capability ? "yes" : "no");
   if (ue_context_p->ue_radio_capability) {
+    // Interned blob: another reference instead of a 1-2KB copy per
+    // idle-active transition; the message destructor drops it
     establishment_cnf_p->ue_radio_capability =
-        bstrcpy(ue_context_p->ue_radio_capability);
+        bstr_intern_ref(ue_context_p->ue_radio_capability);
   }
 
   int j = 0;
@@ -461,10 +504,12 @@ void mme_app_handle_conn_est_cnf(
   establishment_cnf_p->no_of_e_rabs = j;
 
   //#pragma message  "Check ue_context_p ambr"
-  establishment_cnf_p->ue_ambr.br_ul = ue_context_p->subscribed_ue_ambr.br_ul;
-  establishment_cnf_p->ue_ambr.br_dl = ue_context_p->subscribed_ue_ambr.br_dl;
+  establishment_cnf_p->ue_ambr.br_ul =
+      ue_context_p->subscription->subscribed_ue_ambr.br_ul;
+  establishment_cnf_p->ue_ambr.br_dl =
+      ue_context_p->subscription->subscribed_ue_ambr.br_dl;
   establishment_cnf_p->ue_ambr.br_unit =
-      ue_context_p->subscribed_ue_ambr.br_unit;
+      ue_context_p->subscription->subscribed_ue_ambr.br_unit;
   establishment_cnf_p->ue_security_capabilities_encryption_algorithms =
       ((uint16_t) emm_context_p->_ue_network_capability.eea & ~(1 << 7)) << 1;
 
@@ -1275,9 +1320,9 @@ status_code_e mme_app_handle_create_sess_resp(
   nas_pdn_cs_respose_success.sgw_s1u_fteid = current_bearer_p->s_gw_fteid_s1u;
   // optional IE
   nas_pdn_cs_respose_success.ambr.br_ul =
-      ue_context_p->subscribed_ue_ambr.br_ul;
+      ue_context_p->subscription->subscribed_ue_ambr.br_ul;
   nas_pdn_cs_respose_success.ambr.br_dl =
-      ue_context_p->subscribed_ue_ambr.br_dl;
+      ue_context_p->subscription->subscribed_ue_ambr.br_dl;
 
   // This IE is not applicable for TAU/RAU/Handover.
   // If PGW decides to return PCO to the UE, PGW shall send PCO to
@@ -1921,8 +1966,8 @@ status_code_e mme_app_handle_implicit_detach_timer_expiry(
 
   ue_context_p->implicit_detach_timer.id           = MME_APP_TIMER_INACTIVE_ID;
   ue_context_p->time_implicit_detach_timer_started = 0;
-  // Initiate Implicit Detach for the UE
-  nas_proc_implicit_detach_ue_ind(mme_ue_s1ap_id);
+  // Initiate Implicit Detach for the UE, paced through the sweep queue
+  mme_app_detach_sweep_enqueue(mme_ue_s1ap_id);
   OAILOG_FUNC_RETURN(LOG_MME_APP, RETURNok);
 }
 
@@ -2083,9 +2128,243 @@ static void notify_s1ap_new_ue_mme_s1ap_id_association(
   OAILOG_FUNC_OUT(LOG_MME_APP);
 }
 
+//------------------------------------------------------------------------------
+static long mme_app_paging_batch_tick_msec(void) {
+  static long tick_msec = -1;
+  if (tick_msec < 0) {
+    const char* env = getenv("MAGMA_PAGING_BATCH_TICK_MSEC");
+    tick_msec = (env != NULL) ? atol(env) : MME_APP_PAGING_BATCH_TICK_MSEC;
+    if (tick_msec < 0) {
+      tick_msec = MME_APP_PAGING_BATCH_TICK_MSEC;
+    }
+  }
+  return tick_msec;
+}
+
+//------------------------------------------------------------------------------
+static void mme_app_flush_paging_batch(void) {
+  MessageDef* message_p = NULL;
+
+  if (pending_paging_count == 0) {
+    return;
+  }
+  message_p = itti_alloc_new_message(TASK_MME_APP, S1AP_PAGING_REQUEST_BATCH);
+  if (message_p) {
+    itti_s1ap_paging_request_batch_t* batch =
+        &message_p->ittiMsg.s1ap_paging_request_batch;
+    batch->paging_requests =
+        calloc(pending_paging_count, sizeof(itti_s1ap_paging_request_t));
+    if (batch->paging_requests) {
+      batch->count = pending_paging_count;
+      memcpy(
+          batch->paging_requests, pending_paging_requests,
+          pending_paging_count * sizeof(itti_s1ap_paging_request_t));
+      if (send_msg_to_task(&mme_app_task_zmq_ctx, TASK_S1AP, message_p) !=
+          RETURNerror) {
+        pending_paging_count = 0;
+        return;
+      }
+      OAILOG_ERROR(LOG_MME_APP, "Failed to send paging batch to S1ap\n");
+      pending_paging_count = 0;
+      return;
+    }
+    free(message_p);
+  }
+
+  // Could not put a batch together; fall back to per-UE paging messages so
+  // no pending page is stranded
+  for (uint16_t i = 0; i < pending_paging_count; i++) {
+    message_p = itti_alloc_new_message(TASK_MME_APP, S1AP_PAGING_REQUEST);
+    if (message_p == NULL) {
+      continue;
+    }
+    S1AP_PAGING_REQUEST(message_p)  = pending_paging_requests[i];
+    message_p->ittiMsgHeader.imsi   = pending_paging_requests[i].imsi64;
+    send_msg_to_task(&mme_app_task_zmq_ctx, TASK_S1AP, message_p);
+  }
+  pending_paging_count = 0;
+}
+
+//------------------------------------------------------------------------------
+static status_code_e mme_app_handle_paging_batch_timer_expiry(
+    zloop_t* loop, int timer_id, void* args) {
+  paging_batch_timer_id = MME_APP_TIMER_INACTIVE_ID;
+  mme_app_flush_paging_batch();
+  return RETURNok;
+}
+
+//------------------------------------------------------------------------------
+static status_code_e mme_app_enqueue_paging_request(
+    const itti_s1ap_paging_request_t* paging_request) {
+  long tick_msec = mme_app_paging_batch_tick_msec();
+
+  if (tick_msec == 0) {
+    // Batching disabled: forward the request on its own
+    MessageDef* message_p =
+        itti_alloc_new_message(TASK_MME_APP, S1AP_PAGING_REQUEST);
+    if (message_p == NULL) {
+      OAILOG_ERROR(
+          LOG_MME_APP,
+          "Failed to allocate the memory for paging request message\n");
+      return RETURNerror;
+    }
+    S1AP_PAGING_REQUEST(message_p) = *paging_request;
+    message_p->ittiMsgHeader.imsi  = paging_request->imsi64;
+    return send_msg_to_task(&mme_app_task_zmq_ctx, TASK_S1AP, message_p);
+  }
+
+  pending_paging_requests[pending_paging_count++] = *paging_request;
+  if (pending_paging_count == MME_APP_PAGING_BATCH_MAX_UES) {
+    if (paging_batch_timer_id != MME_APP_TIMER_INACTIVE_ID) {
+      mme_app_stop_timer(paging_batch_timer_id);
+      paging_batch_timer_id = MME_APP_TIMER_INACTIVE_ID;
+    }
+    mme_app_flush_paging_batch();
+  } else if (paging_batch_timer_id == MME_APP_TIMER_INACTIVE_ID) {
+    paging_batch_timer_id = mme_app_start_timer(
+        tick_msec, TIMER_REPEAT_ONCE, mme_app_handle_paging_batch_timer_expiry,
+        0);
+    if (paging_batch_timer_id == -1) {
+      // No tick available; flush right away rather than strand the entry
+      mme_app_flush_paging_batch();
+    }
+  }
+  return RETURNok;
+}
+
+//------------------------------------------------------------------------------
+static long mme_app_detach_sweep_tick_msec(void) {
+  static long tick_msec = -1;
+  if (tick_msec < 0) {
+    const char* env = getenv("MAGMA_DETACH_SWEEP_TICK_MSEC");
+    tick_msec = (env != NULL) ? atol(env) : MME_APP_DETACH_SWEEP_TICK_MSEC;
+    if (tick_msec < 0) {
+      tick_msec = MME_APP_DETACH_SWEEP_TICK_MSEC;
+    }
+  }
+  return tick_msec;
+}
+
+//------------------------------------------------------------------------------
+static long mme_app_detach_sweep_rate_per_sec(void) {
+  static long rate = -1;
+  if (rate < 0) {
+    const char* env = getenv("MAGMA_DETACH_SWEEP_RATE_PER_SEC");
+    rate = (env != NULL) ? atol(env) : MME_APP_DETACH_SWEEP_RATE_PER_SEC;
+    if (rate <= 0) {
+      rate = MME_APP_DETACH_SWEEP_RATE_PER_SEC;
+    }
+  }
+  return rate;
+}
+
+//------------------------------------------------------------------------------
+static status_code_e mme_app_handle_detach_sweep_timer_expiry(
+    zloop_t* loop, int timer_id, void* args);
+
+static void mme_app_detach_sweep_drain(void) {
+  long tick_msec = mme_app_detach_sweep_tick_msec();
+
+  detach_sweep_tokens +=
+      (double) mme_app_detach_sweep_rate_per_sec() * tick_msec / 1000.0;
+  if (detach_sweep_tokens > MME_APP_DETACH_SWEEP_BURST) {
+    detach_sweep_tokens = MME_APP_DETACH_SWEEP_BURST;
+  }
+
+  uint32_t budget = (uint32_t) detach_sweep_tokens;
+  if (budget > detach_sweep_count) {
+    budget = detach_sweep_count;
+  }
+  for (uint32_t i = 0; i < budget; i++) {
+    nas_proc_implicit_detach_ue_ind(detach_sweep_queue[detach_sweep_head]);
+    detach_sweep_head++;
+    detach_sweep_count--;
+  }
+  detach_sweep_tokens -= budget;
+
+  if (budget > 0) {
+    /* One NAS state write covers the whole batch; the per-UE context
+     * writes still happen on the individual S11/S1AP response paths */
+    put_mme_nas_state();
+    OAILOG_DEBUG(
+        LOG_MME_APP, "Detach sweep drained %u UEs, %u still queued\n", budget,
+        detach_sweep_count);
+  }
+
+  if (detach_sweep_count == 0) {
+    detach_sweep_head = 0;
+    return;
+  }
+  detach_sweep_timer_id = mme_app_start_timer(
+      tick_msec, TIMER_REPEAT_ONCE, mme_app_handle_detach_sweep_timer_expiry,
+      0);
+  if (detach_sweep_timer_id == -1) {
+    // No tick available; drain the rest unpaced rather than strand them
+    while (detach_sweep_count > 0) {
+      nas_proc_implicit_detach_ue_ind(detach_sweep_queue[detach_sweep_head]);
+      detach_sweep_head++;
+      detach_sweep_count--;
+    }
+    detach_sweep_head = 0;
+  }
+}
+
+//------------------------------------------------------------------------------
+static status_code_e mme_app_handle_detach_sweep_timer_expiry(
+    zloop_t* loop, int timer_id, void* args) {
+  detach_sweep_timer_id = MME_APP_TIMER_INACTIVE_ID;
+  mme_app_detach_sweep_drain();
+  return RETURNok;
+}
+
+//------------------------------------------------------------------------------
+static void mme_app_detach_sweep_enqueue(mme_ue_s1ap_id_t ue_id) {
+  long tick_msec = mme_app_detach_sweep_tick_msec();
+
+  if (tick_msec == 0) {
+    // Sweep disabled: run the detach directly on the expiry callback
+    nas_proc_implicit_detach_ue_ind(ue_id);
+    return;
+  }
+
+  if (detach_sweep_head + detach_sweep_count == detach_sweep_capacity) {
+    if (detach_sweep_head > 0) {
+      memmove(
+          detach_sweep_queue, &detach_sweep_queue[detach_sweep_head],
+          detach_sweep_count * sizeof(mme_ue_s1ap_id_t));
+      detach_sweep_head = 0;
+    }
+    if (detach_sweep_count == detach_sweep_capacity) {
+      uint32_t new_capacity =
+          detach_sweep_capacity ? detach_sweep_capacity * 2 : 1024;
+      mme_ue_s1ap_id_t* new_queue = realloc(
+          detach_sweep_queue, new_capacity * sizeof(mme_ue_s1ap_id_t));
+      if (new_queue == NULL) {
+        // Out of memory; better one unpaced detach than a stranded UE
+        nas_proc_implicit_detach_ue_ind(ue_id);
+        return;
+      }
+      detach_sweep_queue    = new_queue;
+      detach_sweep_capacity = new_capacity;
+    }
+  }
+  detach_sweep_queue[detach_sweep_head + detach_sweep_count] = ue_id;
+  detach_sweep_count++;
+
+  if (detach_sweep_timer_id == MME_APP_TIMER_INACTIVE_ID) {
+    detach_sweep_timer_id = mme_app_start_timer(
+        tick_msec, TIMER_REPEAT_ONCE, mme_app_handle_detach_sweep_timer_expiry,
+        0);
+    if (detach_sweep_timer_id == -1) {
+      mme_app_detach_sweep_drain();
+    }
+  }
+}
+
 /**
  * Helper function to send a paging request to S1AP in either the initial case
- * or the retransmission case.
+ * or the retransmission case. Requests are aggregated per flush tick and sent
+ * to S1AP in batches.
  *
  * @param ue_context_p - Pointer to UE context
  * @param set_timer - set true if this is the first attempt at paging and false
@@ -2096,7 +2375,7 @@ static void notify_s1ap_new_ue_mme_s1ap_id_association(
 status_code_e mme_app_paging_request_helper(
     ue_mm_context_t* ue_context_p, bool set_timer, uint8_t paging_id_stmsi,
     s1ap_cn_domain_t domain_indicator) {
-  MessageDef* message_p = NULL;
+  itti_s1ap_paging_request_t paging_req = {0};
   OAILOG_FUNC_IN(LOG_MME_APP);
 
   // First, check if the UE is already connected. If so, stop
@@ -2109,16 +2388,7 @@ status_code_e mme_app_paging_request_helper(
     ue_context_p->time_paging_response_timer_started = 0;
     OAILOG_FUNC_RETURN(LOG_MME_APP, RETURNerror);
   }
-  message_p = itti_alloc_new_message(TASK_MME_APP, S1AP_PAGING_REQUEST);
-  if (message_p == NULL) {
-    OAILOG_ERROR(
-        LOG_MME_APP,
-        "Failed to allocate the memory for paging request message\n");
-    OAILOG_FUNC_RETURN(LOG_MME_APP, RETURNerror);
-  }
-  itti_s1ap_paging_request_t* paging_request =
-      &message_p->ittiMsg.s1ap_paging_request;
-  memset(paging_request, 0, sizeof(itti_s1ap_paging_request_t));
+  itti_s1ap_paging_request_t* paging_request = &paging_req;
 
   // @TODO Check
   IMSI64_TO_STRING(
@@ -2148,9 +2418,8 @@ status_code_e mme_app_paging_request_helper(
         p_tai_list, &tai_list->partial_tai_list[tai_list_idx],
         tai_list->partial_tai_list[tai_list_idx].numberofelements);
   }
-  message_p->ittiMsgHeader.imsi = ue_context_p->emm_context._imsi64;
-  if ((send_msg_to_task(&mme_app_task_zmq_ctx, TASK_S1AP, message_p)) ==
-      RETURNerror) {
+  paging_request->imsi64 = ue_context_p->emm_context._imsi64;
+  if (mme_app_enqueue_paging_request(paging_request) == RETURNerror) {
     OAILOG_ERROR_UE(
         LOG_MME_APP, ue_context_p->emm_context._imsi64,
         "Failed to send Paging Indication to S1ap for "
@@ -3275,6 +3544,7 @@ void mme_app_handle_handover_required(
     OAILOG_ERROR(
         LOG_MME_APP, "UE context doesn't exist for UE " MME_UE_S1AP_ID_FMT "\n",
         handover_required_p->mme_ue_s1ap_id);
+    OAILOG_FUNC_OUT(LOG_MME_APP);
   }
 
   message_p = DEPRECATEDitti_alloc_new_message_fatal(
@@ -3297,11 +3567,13 @@ void mme_app_handle_handover_required(
   ho_request_p->target_enb_id        = handover_required_p->enb_id;
   ho_request_p->cause                = handover_required_p->cause;
   ho_request_p->handover_type        = handover_required_p->handover_type;
-  ho_request_p->src_tgt_container    = bstrcpy(
-      handover_required_p->src_tgt_container);  // ownership passed to receiver
+  /* Steal the transparent container instead of duplicating it; the source
+   * message's content free is a no-op on the NULLed field */
+  ho_request_p->src_tgt_container = handover_required_p->src_tgt_container;
+  handover_required_p->src_tgt_container = NULL;
 
   // get the ambr
-  ho_request_p->ue_ambr = ue_context_p->subscribed_ue_ambr;
+  ho_request_p->ue_ambr = ue_context_p->subscription->subscribed_ue_ambr;
 
   // get the e_rab to be setup list
   int j = 0;
@@ -3320,7 +3592,7 @@ void mme_app_handle_handover_required(
           .pre_emption_capability = bc->preemption_capability;
       item.e_rab_level_qos_parameters.allocation_and_retention_priority
           .pre_emption_vulnerability   = bc->preemption_vulnerability;
-      ho_request_p->e_rab_list.item[i] = item;
+      ho_request_p->e_rab_list.item[j] = item;
       j                                = j + 1;
     }
   }
@@ -3412,9 +3684,10 @@ void mme_app_handle_handover_request_ack(
   ho_command_p->source_enb_id      = handover_request_ack_p->source_enb_id;
   ho_command_p->target_enb_id      = handover_request_ack_p->target_enb_id;
   ho_command_p->handover_type      = handover_request_ack_p->handover_type;
-  ho_command_p->tgt_src_container =
-      bstrcpy(handover_request_ack_p
-                  ->tgt_src_container);  // ownership passed to receiver
+  /* Steal the transparent container instead of duplicating it; the source
+   * message's content free is a no-op on the NULLed field */
+  ho_command_p->tgt_src_container = handover_request_ack_p->tgt_src_container;
+  handover_request_ack_p->tgt_src_container = NULL;
 
   OAILOG_INFO_UE(
       LOG_MME_APP, ue_context_p->emm_context._imsi64,
@@ -3453,25 +3726,15 @@ void mme_app_handle_handover_notify(
   }
 
   // update UE context
-  if (ue_context_p->enb_s1ap_id_key != INVALID_ENB_UE_S1AP_ID_KEY) {
-    // Remove existing enb_s1ap_id_key which is mapped with source eNB
-    hashtable_uint64_ts_remove(
-        mme_app_desc_p->mme_ue_contexts.enb_ue_s1ap_id_ue_context_htbl,
-        (const hash_key_t) ue_context_p->enb_s1ap_id_key);
-    ue_context_p->enb_s1ap_id_key = INVALID_ENB_UE_S1AP_ID_KEY;
-  }
   ue_context_p->enb_ue_s1ap_id = handover_notify_p->target_enb_ue_s1ap_id;
   // regenerate the enb_s1ap_id_key as enb_ue_s1ap_id is changed.
   MME_APP_ENB_S1AP_ID_KEY(
       enb_s1ap_id_key, handover_notify_p->target_enb_id,
       handover_notify_p->target_enb_ue_s1ap_id);
-  // Update enb_s1ap_id_key in hashtable
-  if (!IS_EMM_CTXT_PRESENT_GUTI(&(ue_context_p->emm_context))) {
-    mme_ue_context_update_coll_keys(
-        &mme_app_desc_p->mme_ue_contexts, ue_context_p, enb_s1ap_id_key,
-        ue_context_p->mme_ue_s1ap_id, ue_context_p->emm_context._imsi64,
-        ue_context_p->mme_teid_s11, &ue_context_p->emm_context._guti);
-  }
+  /* Re-key only the eNB-side lookup: all other collection keys are
+   * unchanged by an intra-MME handover */
+  mme_ue_context_update_enb_key_on_handover(
+      &mme_app_desc_p->mme_ue_contexts, ue_context_p, enb_s1ap_id_key);
 
   // Update sctp assoc id and ecgi
   ue_context_p->sctp_assoc_id_key = handover_notify_p->target_sctp_assoc_id;
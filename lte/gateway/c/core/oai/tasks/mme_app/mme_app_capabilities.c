@@ -18,6 +18,7 @@
 #include <stddef.h>
 
 #include "bstrlib.h"
+#include "bstr_intern.h"
 #include "log.h"
 #include "mme_app_ue_context.h"
 #include "mme_app_defs.h"
@@ -53,12 +54,13 @@ status_code_e mme_app_handle_s1ap_ue_capabilities_ind(
   }
 
   if (ue_context_p->ue_radio_capability) {
-    bdestroy_wrapper(&ue_context_p->ue_radio_capability);
+    bstr_intern_release(&ue_context_p->ue_radio_capability);
   }
 
-  // Allocate the radio capabilities memory. Note that this takes care of the
-  // length = 0 case for us quite nicely.
-  ue_context_p->ue_radio_capability = blk2bstr(
+  // Intern the radio capabilities: homogeneous device populations report
+  // identical blobs, so contexts share one refcounted buffer per content.
+  // Note that this takes care of the length = 0 case for us quite nicely.
+  ue_context_p->ue_radio_capability = bstr_intern(
       s1ap_ue_cap_ind_pP->radio_capabilities,
       s1ap_ue_cap_ind_pP->radio_capabilities_length);
   free_wrapper((void**) &s1ap_ue_cap_ind_pP->radio_capabilities);
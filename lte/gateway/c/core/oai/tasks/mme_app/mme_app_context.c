@@ -62,6 +62,7 @@
 #include "3gpp_29.274.h"
 #include "3gpp_36.401.h"
 #include "bstrlib.h"
+#include "bstr_intern.h"
 #include "emm_data.h"
 #include "esm_data.h"
 #include "hashtable.h"
@@ -129,6 +130,13 @@ ue_mm_context_t* mme_create_new_ue_context(void) {
     OAILOG_ERROR(LOG_MME_APP, "Failed to allocate memory for UE context \n");
     return NULL;
   }
+  new_p->subscription = calloc(1, sizeof(ue_subscription_t));
+  if (!new_p->subscription) {
+    OAILOG_ERROR(
+        LOG_MME_APP, "Failed to allocate memory for UE subscription \n");
+    free_wrapper((void**) &new_p);
+    return NULL;
+  }
 
   new_p->mme_ue_s1ap_id  = INVALID_MME_UE_S1AP_ID;
   new_p->enb_s1ap_id_key = INVALID_ENB_UE_S1AP_ID_KEY;
@@ -192,9 +200,12 @@ void mme_app_ue_sgs_context_free_content(
 
 //------------------------------------------------------------------------------
 void mme_app_ue_context_free_content(ue_mm_context_t* const ue_context_p) {
-  bdestroy_wrapper(&ue_context_p->msisdn);
-  bdestroy_wrapper(&ue_context_p->ue_radio_capability);
-  bdestroy_wrapper(&ue_context_p->apn_oi_replacement);
+  if (ue_context_p->subscription) {
+    bdestroy_wrapper(&ue_context_p->subscription->msisdn);
+    bdestroy_wrapper(&ue_context_p->subscription->apn_oi_replacement);
+    free_wrapper((void**) &ue_context_p->subscription);
+  }
+  bstr_intern_release(&ue_context_p->ue_radio_capability);
 
   // Stop Mobile reachability timer,if running
   if (ue_context_p->mobile_reachability_timer.id != MME_APP_TIMER_INACTIVE_ID) {
@@ -297,6 +308,15 @@ ue_mm_context_t* mme_ue_context_exists_mme_ue_s1ap_id(
 
   hashtable_ts_get(
       state_imsi_ht, (const hash_key_t) mme_ue_s1ap_id, (void**) &ue_context_p);
+  if (!ue_context_p) {
+    // A stateless restart restores the id maps eagerly but leaves the
+    // contexts pending in the data store until the background hydration
+    // sweep reaches them; pull this one in on first touch
+    mme_app_hydrate_ue_state_by_ue_id(mme_ue_s1ap_id);
+    hashtable_ts_get(
+        state_imsi_ht, (const hash_key_t) mme_ue_s1ap_id,
+        (void**) &ue_context_p);
+  }
   if (ue_context_p) {
     OAILOG_TRACE(
         LOG_MME_APP,
@@ -380,10 +400,13 @@ void mme_app_move_context(ue_mm_context_t* dst, ue_mm_context_t* src) {
     enb_s1ap_id_key_t enb_s1ap_id_key = dst->enb_s1ap_id_key;
     enb_ue_s1ap_id_t enb_ue_s1ap_id   = dst->enb_ue_s1ap_id;
     mme_ue_s1ap_id_t mme_ue_s1ap_id   = dst->mme_ue_s1ap_id;
+    ue_subscription_t* subscription   = dst->subscription;
     memcpy(dst, src, sizeof(*dst));
     dst->enb_s1ap_id_key = enb_s1ap_id_key;
     dst->enb_ue_s1ap_id  = enb_ue_s1ap_id;
     dst->mme_ue_s1ap_id  = mme_ue_s1ap_id;
+    // Swap the subscription blocks so both contexts keep a valid one
+    src->subscription = subscription;
   }
   OAILOG_FUNC_OUT(LOG_MME_APP);
 }
@@ -563,6 +586,37 @@ void mme_ue_context_update_coll_keys(
   OAILOG_FUNC_OUT(LOG_MME_APP);
 }
 
+//------------------------------------------------------------------------------
+void mme_ue_context_update_enb_key_on_handover(
+    mme_ue_context_t* const mme_ue_context_p,
+    ue_mm_context_t* const ue_context_p,
+    const enb_s1ap_id_key_t enb_s1ap_id_key) {
+  hashtable_rc_t h_rc = HASH_TABLE_OK;
+  OAILOG_FUNC_IN(LOG_MME_APP);
+
+  if (ue_context_p->enb_s1ap_id_key == enb_s1ap_id_key) {
+    OAILOG_FUNC_OUT(LOG_MME_APP);
+  }
+  if (INVALID_ENB_UE_S1AP_ID_KEY != ue_context_p->enb_s1ap_id_key) {
+    hashtable_uint64_ts_remove(
+        mme_ue_context_p->enb_ue_s1ap_id_ue_context_htbl,
+        (const hash_key_t) ue_context_p->enb_s1ap_id_key);
+  }
+  h_rc = hashtable_uint64_ts_insert(
+      mme_ue_context_p->enb_ue_s1ap_id_ue_context_htbl,
+      (const hash_key_t) enb_s1ap_id_key, ue_context_p->mme_ue_s1ap_id);
+  if (HASH_TABLE_OK != h_rc) {
+    OAILOG_ERROR_UE(
+        LOG_MME_APP, ue_context_p->emm_context._imsi64,
+        "Error could not update enb_s1ap_id_key %ld for ue context %p "
+        "mme_ue_s1ap_id " MME_UE_S1AP_ID_FMT " %s\n",
+        enb_s1ap_id_key, ue_context_p, ue_context_p->mme_ue_s1ap_id,
+        hashtable_rc_code2string(h_rc));
+  }
+  ue_context_p->enb_s1ap_id_key = enb_s1ap_id_key;
+  OAILOG_FUNC_OUT(LOG_MME_APP);
+}
+
 //------------------------------------------------------------------------------
 void mme_ue_context_dump_coll_keys(const mme_ue_context_t* mme_ue_contexts_p) {
   bstring tmp                         = bfromcstr(" ");
@@ -1494,7 +1548,7 @@ bool mme_app_dump_ue_context(
        * "Granted" : "Barred");
        */
 #define DISPLAY_BIT_MASK_PRESENT(mASK)                                         \
-  ((ue_mm_context->access_restriction_data & mASK) ? 'X' : 'O')
+  ((ue_mm_context->subscription->access_restriction_data & mASK) ? 'X' : 'O')
       bformata(
           bstr_dump,
           "    (O = allowed, X = !O) |UTRAN|GERAN|GAN|HSDPA EVO|E_UTRAN|HO TO "
@@ -1518,7 +1572,7 @@ bool mme_app_dump_ue_context(
       // (ue_mm_context->msisdn) ? ue_mm_context->msisdn->data:"None");
       bformata(
           bstr_dump, "    - RAU/TAU timer ..: %u\n",
-          ue_mm_context->rau_tau_timer);
+          ue_mm_context->subscription->rau_tau_timer);
       // TODO IMEISV
       // if (IS_EMM_CTXT_PRESENT_IMEISV(&ue_mm_context->nas_emm_context)) {
       //  bformata (bstr_dump, "    - IMEISV .........: %*s\n",
@@ -1535,17 +1589,20 @@ bool mme_app_dump_ue_context(
 
       bformata(bstr_dump, "    - APN config list:\n");
 
-      for (j = 0; j < ue_mm_context->apn_config_profile.nb_apns; j++) {
+      for (j = 0; j < ue_mm_context->subscription->apn_config_profile.nb_apns;
+           j++) {
         struct apn_configuration_s* apn_config_p;
 
-        apn_config_p = &ue_mm_context->apn_config_profile.apn_configuration[j];
+        apn_config_p = &ue_mm_context->subscription->apn_config_profile
+                            .apn_configuration[j];
         /*
          * Default APN ?
          */
         bformata(
             bstr_dump, "        - Default APN ...: %s\n",
             (apn_config_p->context_identifier ==
-             ue_mm_context->apn_config_profile.context_identifier) ?
+             ue_mm_context->subscription->apn_config_profile
+                 .context_identifier) ?
                 "TRUE" :
                 "FALSE");
         bformata(
@@ -2052,7 +2109,7 @@ bool is_mme_ue_context_network_access_mode_packet_only(
     OAILOG_CRITICAL(LOG_MME_APP, "**** Abnormal- UE context is null.****\n");
     OAILOG_FUNC_RETURN(LOG_MME_APP, RETURNerror);
   }
-  if (ue_context_p->network_access_mode == NAM_ONLY_PACKET) {
+  if (ue_context_p->subscription->network_access_mode == NAM_ONLY_PACKET) {
     OAILOG_FUNC_RETURN(LOG_MME_APP, true);
   } else {
     OAILOG_FUNC_RETURN(LOG_MME_APP, false);
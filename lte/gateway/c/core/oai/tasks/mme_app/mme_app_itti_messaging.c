@@ -198,7 +198,7 @@ status_code_e mme_app_send_s11_create_session_req(
     OAILOG_ERROR(LOG_MME_APP, "Invalid UE MM context received\n");
     OAILOG_FUNC_RETURN(LOG_MME_APP, RETURNerror);
   }
-  if (ue_mm_context->subscriber_status != SS_SERVICE_GRANTED) {
+  if (ue_mm_context->subscription->subscriber_status != SS_SERVICE_GRANTED) {
     /*
      * HSS rejected the bearer creation or roaming is not allowed for this
      * UE. This result will trigger an ESM Failure message sent to UE.
@@ -245,11 +245,13 @@ status_code_e mme_app_send_s11_create_session_req(
   /*
    * Copy the MSISDN
    */
-  if (ue_mm_context->msisdn) {
+  if (ue_mm_context->subscription->msisdn) {
     memcpy(
-        session_request_p->msisdn.digit, ue_mm_context->msisdn->data,
-        ue_mm_context->msisdn->slen);
-    session_request_p->msisdn.length = ue_mm_context->msisdn->slen;
+        session_request_p->msisdn.digit,
+        ue_mm_context->subscription->msisdn->data,
+        ue_mm_context->subscription->msisdn->slen);
+    session_request_p->msisdn.length =
+        ue_mm_context->subscription->msisdn->slen;
   } else {
     session_request_p->msisdn.length = 0;
   }
@@ -369,7 +371,7 @@ status_code_e mme_app_send_s11_create_session_req(
   } else {
     memcpy(
         &session_request_p->charging_characteristics,
-        &ue_mm_context->default_charging_characteristics,
+        &ue_mm_context->subscription->default_charging_characteristics,
         sizeof(charging_characteristics_t));
   }
 
@@ -283,9 +283,10 @@ status_code_e mme_app_handle_s6a_update_location_ans(
     OAILOG_FUNC_RETURN(LOG_MME_APP, RETURNerror);
   }
 
+  ue_subscription_t* subscription = ue_mm_context->subscription;
+
   ue_mm_context->subscription_known = SUBSCRIPTION_KNOWN;
-  ue_mm_context->subscriber_status =
-      ula_pP->subscription_data.subscriber_status;
+  subscription->subscriber_status = ula_pP->subscription_data.subscriber_status;
 
   // Verify service area restriction
   if (ula_pP->subscription_data.num_zcs > 0) {
@@ -313,31 +314,31 @@ status_code_e mme_app_handle_s6a_update_location_ans(
       OAILOG_FUNC_RETURN(LOG_MME_APP, RETURNok);
     } else {
       // Store the zone codes in ue_mm_context
-      ue_mm_context->num_reg_sub = ula_pP->subscription_data.num_zcs;
-      for (uint8_t itr = 0; itr < ue_mm_context->num_reg_sub; itr++) {
+      subscription->num_reg_sub = ula_pP->subscription_data.num_zcs;
+      for (uint8_t itr = 0; itr < subscription->num_reg_sub; itr++) {
         memcpy(
-            ue_mm_context->reg_sub[itr].zone_code,
+            subscription->reg_sub[itr].zone_code,
             ula_pP->subscription_data.reg_sub[itr].zone_code,
             strlen((const char*) ula_pP->subscription_data.reg_sub[itr]
                        .zone_code));
       }
     }
   }
-  ue_mm_context->access_restriction_data =
+  subscription->access_restriction_data =
       ula_pP->subscription_data.access_restriction;
   /*
    * Copy the subscribed UE AMBR (comes from data plan) to UE context
    */
   memcpy(
-      &ue_mm_context->subscribed_ue_ambr,
+      &subscription->subscribed_ue_ambr,
       &ula_pP->subscription_data.subscribed_ambr, sizeof(ambr_t));
   OAILOG_DEBUG(
       LOG_MME_APP, "Received UL rate %" PRIu64 " and DL rate %" PRIu64 "\n",
-      ue_mm_context->subscribed_ue_ambr.br_ul,
-      ue_mm_context->subscribed_ue_ambr.br_dl);
+      subscription->subscribed_ue_ambr.br_ul,
+      subscription->subscribed_ue_ambr.br_dl);
 
   if (ula_pP->subscription_data.msisdn_length != 0) {
-    ue_mm_context->msisdn = blk2bstr(
+    subscription->msisdn = blk2bstr(
         ula_pP->subscription_data.msisdn,
         ula_pP->subscription_data.msisdn_length);
   } else {
@@ -346,14 +347,14 @@ status_code_e mme_app_handle_s6a_update_location_ans(
         __FUNCTION__, imsi64);
   }
 
-  ue_mm_context->rau_tau_timer       = ula_pP->subscription_data.rau_tau_timer;
-  ue_mm_context->network_access_mode = ula_pP->subscription_data.access_mode;
+  subscription->rau_tau_timer       = ula_pP->subscription_data.rau_tau_timer;
+  subscription->network_access_mode = ula_pP->subscription_data.access_mode;
   memcpy(
-      &ue_mm_context->apn_config_profile,
+      &subscription->apn_config_profile,
       &ula_pP->subscription_data.apn_config_profile,
       sizeof(apn_config_profile_t));
   memcpy(
-      &ue_mm_context->default_charging_characteristics,
+      &subscription->default_charging_characteristics,
       &ula_pP->subscription_data.default_charging_characteristics,
       sizeof(charging_characteristics_t));
 
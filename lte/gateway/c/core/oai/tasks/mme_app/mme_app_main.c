@@ -32,6 +32,7 @@
 #include "log.h"
 #include "intertask_interface.h"
 #include "itti_free_defined_msg.h"
+#include "itti_msg_batch.h"
 #include "mme_config.h"
 #include "nas_network.h"
 #include "timer.h"
@@ -436,6 +437,42 @@ static int handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
           mme_app_desc_p, &S6A_AUTH_INFO_ANS(received_message_p));
     } break;
 
+    case ITTI_MSG_BATCH: {
+      /*
+       * Several gRPC-origin S6A answers coalesced into one send by the
+       * itti batch bridge; handle each one exactly as if it had arrived
+       * on its own (see itti_msg_batch.h).
+       */
+      itti_msg_batch_t* batch = &received_message_p->ittiMsg.itti_msg_batch;
+      is_task_state_same      = true;
+      for (uint32_t i = 0; i < batch->count; i++) {
+        MessageDef* batched_msg = batch->msgs[i];
+        switch (ITTI_MSG_ID(batched_msg)) {
+          case S6A_AUTH_INFO_ANS: {
+            nas_proc_authentication_info_answer(
+                mme_app_desc_p, &S6A_AUTH_INFO_ANS(batched_msg));
+            is_task_state_same = false;
+          } break;
+
+          case S6A_UPDATE_LOCATION_ANS: {
+            mme_app_handle_s6a_update_location_ans(
+                mme_app_desc_p, &batched_msg->ittiMsg.s6a_update_location_ans);
+          } break;
+
+          default: {
+            OAILOG_ERROR(
+                LOG_MME_APP,
+                "Unexpected batched message (%s) with message Id: %d\n",
+                ITTI_MSG_NAME(batched_msg), ITTI_MSG_ID(batched_msg));
+          } break;
+        }
+        put_mme_ue_state(
+            mme_app_desc_p, itti_get_associated_imsi(batched_msg));
+        itti_free_msg_content(batched_msg);
+        itti_batch_release_msg(batched_msg);
+      }
+    } break;
+
     case MME_APP_DOWNLINK_DATA_CNF: {
       bstring nas_msg = NULL;
       nas_proc_dl_transfer_cnf(
@@ -570,12 +607,8 @@ status_code_e mme_app_init(const mme_config_t* mme_config_p) {
 }
 
 static int handle_stats_timer(zloop_t* loop, int id, void* arg) {
-  mme_app_desc_t* mme_app_desc_p = get_mme_nas_state(false);
   application_mme_app_stats_msg_t stats_msg;
-  stats_msg.nb_ue_attached         = mme_app_desc_p->nb_ue_attached;
-  stats_msg.nb_ue_connected        = mme_app_desc_p->nb_ue_connected;
-  stats_msg.nb_default_eps_bearers = mme_app_desc_p->nb_default_eps_bearers;
-  stats_msg.nb_s1u_bearers         = mme_app_desc_p->nb_s1u_bearers;
+  mme_app_fill_stats_msg(&stats_msg);
   return send_mme_app_stats_to_service303(
       &mme_app_task_zmq_ctx, TASK_MME_APP, &stats_msg);
 }
@@ -396,7 +396,8 @@ status_code_e mme_app_handle_nas_cs_domain_location_update_req(
       mme_app_update_granted_service_for_ue(ue_context_p);
     }
   }
-  if ((ue_context_p->network_access_mode == NAM_PACKET_AND_CIRCUIT) &&
+  if ((ue_context_p->subscription->network_access_mode ==
+       NAM_PACKET_AND_CIRCUIT) &&
       (ue_context_p->sgs_context->ts6_1_timer.id ==
        MME_APP_TIMER_INACTIVE_ID)) {
     if (msg_type == TAU_REQUEST) {
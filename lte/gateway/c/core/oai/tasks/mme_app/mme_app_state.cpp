@@ -57,6 +57,10 @@ void clear_mme_nas_state() {
   MmeNasStateManager::getInstance().free_state();
 }
 
+void mme_app_hydrate_ue_state_by_ue_id(mme_ue_s1ap_id_t mme_ue_s1ap_id) {
+  MmeNasStateManager::getInstance().hydrate_ue_state_by_ue_id(mme_ue_s1ap_id);
+}
+
 hash_table_ts_t* get_mme_ue_state() {
   return MmeNasStateManager::getInstance().get_ue_state_ht();
 }
@@ -509,10 +509,10 @@ void MmeNasStateConverter::proto_to_pdn_context_list(
 
 void MmeNasStateConverter::regional_subscription_to_proto(
     const ue_mm_context_t& state_ue_context, oai::UeContext* ue_context_proto) {
-  for (int itr = 0; itr < state_ue_context.num_reg_sub; itr++) {
+  for (int itr = 0; itr < state_ue_context.subscription->num_reg_sub; itr++) {
     oai::Regional_subscription* reg_sub_proto = ue_context_proto->add_reg_sub();
     reg_sub_proto->set_zone_code(
-        (const char*) state_ue_context.reg_sub[itr].zone_code);
+        (const char*) state_ue_context.subscription->reg_sub[itr].zone_code);
     OAILOG_DEBUG(LOG_MME_APP, "Writing regional_subscription at index %d", itr);
   }
 }
@@ -521,7 +521,7 @@ void MmeNasStateConverter::proto_to_regional_subscription(
     const oai::UeContext& ue_context_proto, ue_mm_context_t* state_ue_context) {
   for (unsigned int itr = 0; itr < ue_context_proto.num_reg_sub(); itr++) {
     memcpy(
-        state_ue_context->reg_sub[itr].zone_code,
+        state_ue_context->subscription->reg_sub[itr].zone_code,
         ue_context_proto.reg_sub(itr).zone_code().c_str(),
         ue_context_proto.reg_sub(itr).zone_code().length());
     OAILOG_DEBUG(LOG_MME_APP, "Reading regional_subscription at index %d", itr);
@@ -533,7 +533,8 @@ void MmeNasStateConverter::ue_context_to_proto(
   OAILOG_FUNC_IN(LOG_MME_APP);
   ue_context_proto->Clear();
 
-  char* msisdn_buffer = bstr2cstr(state_ue_context->msisdn, (char) '?');
+  char* msisdn_buffer =
+      bstr2cstr(state_ue_context->subscription->msisdn, (char) '?');
   if (msisdn_buffer) {
     ue_context_proto->set_msisdn(msisdn_buffer);
     bcstrfree(msisdn_buffer);
@@ -564,19 +565,20 @@ void MmeNasStateConverter::ue_context_to_proto(
   lai_to_bytes(&state_ue_context->lai, lai_bytes);
   ue_context_proto->set_lai(lai_bytes, IE_LENGTH_LAI);
   StateConverter::apn_config_profile_to_proto(
-      state_ue_context->apn_config_profile,
+      state_ue_context->subscription->apn_config_profile,
       ue_context_proto->mutable_apn_config());
-  ue_context_proto->set_subscriber_status(state_ue_context->subscriber_status);
+  ue_context_proto->set_subscriber_status(
+      state_ue_context->subscription->subscriber_status);
   ue_context_proto->set_network_access_mode(
-      state_ue_context->network_access_mode);
+      state_ue_context->subscription->network_access_mode);
   ue_context_proto->set_access_restriction_data(
-      state_ue_context->access_restriction_data);
+      state_ue_context->subscription->access_restriction_data);
   BSTRING_TO_STRING(
-      state_ue_context->apn_oi_replacement,
+      state_ue_context->subscription->apn_oi_replacement,
       ue_context_proto->mutable_apn_oi_replacement());
   ue_context_proto->set_mme_teid_s11(state_ue_context->mme_teid_s11);
   StateConverter::ambr_to_proto(
-      state_ue_context->subscribed_ue_ambr,
+      state_ue_context->subscription->subscribed_ue_ambr,
       ue_context_proto->mutable_subscribed_ue_ambr());
   StateConverter::ambr_to_proto(
       state_ue_context->used_ue_ambr, ue_context_proto->mutable_used_ue_ambr());
@@ -603,7 +605,8 @@ void MmeNasStateConverter::ue_context_to_proto(
   ue_context_proto->set_path_switch_req(state_ue_context->path_switch_req);
   ue_context_proto->set_granted_service(state_ue_context->granted_service);
 
-  ue_context_proto->set_num_reg_sub(state_ue_context->num_reg_sub);
+  ue_context_proto->set_num_reg_sub(
+      state_ue_context->subscription->num_reg_sub);
   regional_subscription_to_proto(*state_ue_context, ue_context_proto);
   ue_context_proto->set_cs_fallback_indicator(
       state_ue_context->cs_fallback_indicator);
@@ -624,7 +627,8 @@ void MmeNasStateConverter::ue_context_to_proto(
   mme_app_timer_to_proto(
       state_ue_context->paging_response_timer,
       ue_context_proto->mutable_paging_response_timer());
-  ue_context_proto->set_rau_tau_timer(state_ue_context->rau_tau_timer);
+  ue_context_proto->set_rau_tau_timer(
+      state_ue_context->subscription->rau_tau_timer);
   mme_app_timer_to_proto(
       state_ue_context->ulr_response_timer,
       ue_context_proto->mutable_ulr_response_timer());
@@ -644,7 +648,12 @@ void MmeNasStateConverter::proto_to_ue_mm_context(
     const oai::UeContext& ue_context_proto,
     ue_mm_context_t* state_ue_mm_context) {
   OAILOG_FUNC_IN(LOG_MME_APP);
-  state_ue_mm_context->msisdn = bfromcstr(ue_context_proto.msisdn().c_str());
+  if (!state_ue_mm_context->subscription) {
+    state_ue_mm_context->subscription =
+        (ue_subscription_t*) calloc(1, sizeof(ue_subscription_t));
+  }
+  state_ue_mm_context->subscription->msisdn =
+      bfromcstr(ue_context_proto.msisdn().c_str());
   state_ue_mm_context->ue_context_rel_cause =
       static_cast<enum s1cause>(ue_context_proto.rel_cause());
   state_ue_mm_context->mm_state =
@@ -665,23 +674,25 @@ void MmeNasStateConverter::proto_to_ue_mm_context(
   bytes_to_lai(ue_context_proto.lai().c_str(), &state_ue_mm_context->lai);
 
   StateConverter::proto_to_apn_config_profile(
-      ue_context_proto.apn_config(), &state_ue_mm_context->apn_config_profile);
+      ue_context_proto.apn_config(),
+      &state_ue_mm_context->subscription->apn_config_profile);
 
-  state_ue_mm_context->subscriber_status =
+  state_ue_mm_context->subscription->subscriber_status =
       (subscriber_status_t) ue_context_proto.subscriber_status();
-  state_ue_mm_context->network_access_mode =
+  state_ue_mm_context->subscription->network_access_mode =
       (network_access_mode_t) ue_context_proto.network_access_mode();
-  state_ue_mm_context->access_restriction_data =
+  state_ue_mm_context->subscription->access_restriction_data =
       ue_context_proto.access_restriction_data();
   if (ue_context_proto.apn_oi_replacement().length() > 0) {
-    state_ue_mm_context->apn_oi_replacement = bfromcstr_with_str_len(
-        ue_context_proto.apn_oi_replacement().c_str(),
-        ue_context_proto.apn_oi_replacement().length());
+    state_ue_mm_context->subscription->apn_oi_replacement =
+        bfromcstr_with_str_len(
+            ue_context_proto.apn_oi_replacement().c_str(),
+            ue_context_proto.apn_oi_replacement().length());
   }
   state_ue_mm_context->mme_teid_s11 = ue_context_proto.mme_teid_s11();
   StateConverter::proto_to_ambr(
       ue_context_proto.subscribed_ue_ambr(),
-      &state_ue_mm_context->subscribed_ue_ambr);
+      &state_ue_mm_context->subscription->subscribed_ue_ambr);
   StateConverter::proto_to_ambr(
       ue_context_proto.used_ue_ambr(), &state_ue_mm_context->used_ue_ambr);
   StateConverter::proto_to_ambr(
@@ -705,7 +716,8 @@ void MmeNasStateConverter::proto_to_ue_mm_context(
   state_ue_mm_context->ppf = ue_context_proto.ppf();
   state_ue_mm_context->subscription_known =
       ue_context_proto.subscription_known();
-  state_ue_mm_context->num_reg_sub = ue_context_proto.num_reg_sub();
+  state_ue_mm_context->subscription->num_reg_sub =
+      ue_context_proto.num_reg_sub();
   proto_to_regional_subscription(ue_context_proto, state_ue_mm_context);
   state_ue_mm_context->path_switch_req = ue_context_proto.path_switch_req();
   state_ue_mm_context->granted_service =
@@ -23,10 +23,24 @@ extern "C" {
 #include "timer.h"
 }
 
+#include <sched.h>
+
+#include <chrono>
+#include <utility>
+#include <vector>
+
 #include "mme_app_state_manager.h"
 
 namespace {
 constexpr char MME_NAS_STATE_KEY[] = "mme_nas_state";
+// UE context blobs at least this large are deflated before the redis write;
+// smaller ones are not worth the cpu
+const size_t MME_STATE_COMPRESS_MIN_BYTES = 256;
+// Flow control for the persistence drain: after this many back-to-back
+// flushes (a mass resync), pause briefly so the redis server and its
+// replication link are not monopolized by state transfer
+const int MME_STATE_FLUSH_BURST_MAX   = 128;
+const int MME_STATE_FLUSH_PAUSE_MSEC  = 10;
 const int NUM_MAX_UE_HTBL_LISTS    = 6;
 constexpr char UE_ID_UE_CTXT_TABLE_NAME[] =
     "mme_app_mme_ue_s1ap_id_ue_context_htbl";
@@ -52,10 +66,17 @@ MmeNasStateManager& MmeNasStateManager::getInstance() {
 
 // Constructor for MME NAS state object
 MmeNasStateManager::MmeNasStateManager()
-    : max_ue_htbl_lists_(NUM_MAX_UE_HTBL_LISTS) {}
+    : max_ue_htbl_lists_(NUM_MAX_UE_HTBL_LISTS),
+      last_sync_signature_(0),
+      has_synced_(false),
+      persistence_running_(false),
+      hydration_running_(false),
+      hydration_active_(false) {}
 
 // Destructor for MME NAS state object
 MmeNasStateManager::~MmeNasStateManager() {
+  stop_hydration_thread();
+  stop_persistence_thread();
   free_state();
 }
 
@@ -73,6 +94,9 @@ int MmeNasStateManager::initialize_state(const mme_config_t* mme_config_p) {
   int rc       = read_state_from_db();
   read_ue_state_from_db();
   is_initialized = true;
+  if (persist_state_enabled) {
+    start_persistence_thread();
+  }
   return rc;
 }
 
@@ -210,37 +234,335 @@ void MmeNasStateManager::free_state() {
   state_cache_p = nullptr;
 }
 
-status_code_e MmeNasStateManager::read_ue_state_from_db() {
-  if (persist_state_enabled) {
-    auto keys = redis_client->get_keys("IMSI*" + task_name + "*");
-    for (const auto& key : keys) {
-      OAILOG_DEBUG(log_task, "Reading UE state from db for %s", key.c_str());
-      oai::UeContext ue_proto = oai::UeContext();
-      auto* ue_context =
-          (ue_mm_context_t*) (calloc(1, sizeof(ue_mm_context_t)));
-      if (redis_client->read_proto(key, ue_proto) != RETURNok) {
-        return RETURNerror;
-      }
-      MmeNasStateConverter::proto_to_ue(ue_proto, ue_context);
-
-      hashtable_rc_t h_rc = hashtable_ts_insert(
-          state_ue_ht, ue_context->mme_ue_s1ap_id, (void*) ue_context);
-      if (HASH_TABLE_OK != h_rc) {
-        OAILOG_ERROR(
-            log_task,
-            "Failed to insert UE state with key mme_ue_s1ap_id "
-            " " MME_UE_S1AP_ID_FMT " (Error Code: %s)\n",
-            ue_context->mme_ue_s1ap_id, hashtable_rc_code2string(h_rc));
-      } else {
-        OAILOG_DEBUG(
-            log_task,
-            "Inserted UE state with key mme_ue_s1ap_id " MME_UE_S1AP_ID_FMT,
-            ue_context->mme_ue_s1ap_id);
+/**
+ * Sum of the monotonic counters covering every mutating path into the
+ * task-wide state: the hashtable mutation counters cover the four UE id
+ * tables (including the NAS call sites), state_version covers the statistics
+ * fields and mme_app_ue_s1ap_id_generator only ever moves forward. As every
+ * term is monotonic, an unchanged sum means no term changed.
+ */
+uint64_t MmeNasStateManager::state_signature() {
+  return state_cache_p->state_version +
+         state_cache_p->mme_app_ue_s1ap_id_generator +
+         state_cache_p->mme_ue_contexts.imsi_mme_ue_id_htbl->mutation_count +
+         state_cache_p->mme_ue_contexts.tun11_ue_context_htbl->mutation_count +
+         state_cache_p->mme_ue_contexts.enb_ue_s1ap_id_ue_context_htbl
+             ->mutation_count +
+         state_cache_p->mme_ue_contexts.guti_ue_context_htbl->mutation_count;
+}
+
+/**
+ * Write the task-wide state to db. The per-UE contexts are written through
+ * write_ue_state_to_db, so this blob only carries the UE id tables and the
+ * statistics; converting it on every sync is wasted work when nothing moved,
+ * which the signature detects without walking the tables.
+ */
+void MmeNasStateManager::write_state_to_db() {
+  AssertFatal(
+      is_initialized,
+      "StateManager init() function should be called to initialize state");
+  AssertFatal(state_cache_p, "mme_nas_state is NULL");
+
+  uint64_t signature = state_signature();
+  if (has_synced_ && (signature == last_sync_signature_)) {
+    state_dirty = false;
+    return;
+  }
+  StateManager::write_state_to_db();
+  last_sync_signature_ = signature;
+  has_synced_          = true;
+}
+
+void MmeNasStateManager::write_ue_state_to_db(
+    const ue_mm_context_t* ue_context, const std::string& imsi_str) {
+  AssertFatal(
+      is_initialized,
+      "StateManager init() function should be called to initialize state");
+
+  if (!persistence_running_) {
+    StateManager::write_ue_state_to_db(ue_context, imsi_str);
+    return;
+  }
+
+  // The proto is a self-contained snapshot of the context: once converted,
+  // the persistence thread no longer touches task-owned memory
+  PendingUeWrite pending = {};
+  pending.is_delete      = false;
+  MmeNasStateConverter::ue_to_proto(ue_context, &pending.ue_proto);
+  {
+    std::lock_guard<std::mutex> lock(pending_lock_);
+    pending_ue_writes_[imsi_str] = std::move(pending);
+  }
+  pending_cv_.notify_one();
+}
+
+void MmeNasStateManager::clear_ue_state_db(const std::string& imsi_str) {
+  AssertFatal(
+      is_initialized,
+      "StateManager init() function should be called to initialize state");
+
+  if (!persistence_running_) {
+    StateManager::clear_ue_state_db(imsi_str);
+    return;
+  }
+
+  PendingUeWrite pending = {};
+  pending.is_delete      = true;
+  {
+    std::lock_guard<std::mutex> lock(pending_lock_);
+    pending_ue_writes_[imsi_str] = std::move(pending);
+  }
+  pending_cv_.notify_one();
+}
+
+void MmeNasStateManager::start_persistence_thread() {
+  // Private connection: the worker's bulk pipelines must never stall a
+  // signaling thread's commit on the shared one
+  persistence_redis_client_ = std::make_unique<RedisClient>(
+      persist_state_enabled, false /* use_shared_connection */);
+  persistence_running_ = true;
+  persistence_thread_ =
+      std::thread(&MmeNasStateManager::persistence_thread_loop, this);
+  // Best effort: redis writes should only consume cycles signaling does not
+  // need, so drop the worker to idle scheduling; keep the default on failure
+  struct sched_param param = {};
+  pthread_setschedparam(
+      persistence_thread_.native_handle(), SCHED_IDLE, &param);
+}
+
+void MmeNasStateManager::stop_persistence_thread() {
+  if (!persistence_thread_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(pending_lock_);
+    persistence_running_ = false;
+  }
+  pending_cv_.notify_one();
+  persistence_thread_.join();
+}
+
+void MmeNasStateManager::persistence_thread_loop() {
+  std::unique_lock<std::mutex> lock(pending_lock_);
+  // Keep flushing until asked to stop AND the queue is drained, so no queued
+  // write is lost on task termination
+  while (persistence_running_ || !pending_ue_writes_.empty()) {
+    if (pending_ue_writes_.empty()) {
+      pending_cv_.wait(lock);
+      continue;
+    }
+    // Drain up to a burst of queued operations, then pipeline them so the
+    // whole burst costs a single round trip to redis
+    std::vector<std::pair<std::string, PendingUeWrite>> batch;
+    const size_t burst_max = MME_STATE_FLUSH_BURST_MAX;
+    while (!pending_ue_writes_.empty() && (batch.size() < burst_max)) {
+      auto it = pending_ue_writes_.begin();
+      batch.emplace_back(it->first, std::move(it->second));
+      pending_ue_writes_.erase(it);
+    }
+    lock.unlock();
+    for (auto& entry : batch) {
+      flush_pending_ue_write(entry.first, entry.second);
+    }
+    if (persistence_redis_client_->commit_pending() != RETURNok) {
+      // Drop the skip hashes so every write of the burst is retried on the
+      // next snapshot instead of being skipped as already stored
+      for (auto& entry : batch) {
+        ue_state_hash.erase(entry.first);
       }
+      OAILOG_ERROR(log_task, "Failed to commit pipelined UE state writes");
+    }
+    if (batch.size() >= burst_max) {
+      std::this_thread::sleep_for(
+          std::chrono::milliseconds(MME_STATE_FLUSH_PAUSE_MSEC));
     }
+    lock.lock();
+  }
+}
+
+void MmeNasStateManager::flush_pending_ue_write(
+    const std::string& imsi_str, PendingUeWrite& pending) {
+  std::string key = "IMSI" + imsi_str + ":" + task_name;
+  if (pending.is_delete) {
+    std::vector<std::string> keys = {key};
+    if (persistence_redis_client_->clear_keys_async(keys) != RETURNok) {
+      OAILOG_ERROR(log_task, "Failed to remove UE state from db");
+      return;
+    }
+    ue_state_version.erase(imsi_str);
+    ue_state_hash.erase(imsi_str);
+    OAILOG_DEBUG(log_task, "Removing UE state for IMSI %s", imsi_str.c_str());
+    return;
+  }
+
+  std::string proto_str;
+  persistence_redis_client_->serialize(pending.ue_proto, proto_str);
+  std::size_t new_hash = std::hash<std::string>{}(proto_str);
+  if (new_hash != ue_state_hash[imsi_str]) {
+    // Deflate larger contexts so re-syncing tens of thousands of UEs moves
+    // less data through redis and its replication link; writes are queued
+    // and committed once per burst by the caller
+    status_code_e write_rc =
+        (proto_str.size() >= MME_STATE_COMPRESS_MIN_BYTES)
+            ? persistence_redis_client_->write_compressed_proto_str_async(
+                  key, proto_str, ue_state_version[imsi_str])
+            : persistence_redis_client_->write_proto_str_async(
+                  key, proto_str, ue_state_version[imsi_str]);
+    if (write_rc != RETURNok) {
+      OAILOG_ERROR(
+          log_task, "Failed to write UE state to db for IMSI %s",
+          imsi_str.c_str());
+      return;
+    }
+    ue_state_version[imsi_str]++;
+    ue_state_hash[imsi_str] = new_hash;
+    OAILOG_DEBUG(
+        log_task, "Finished writing UE state for IMSI %s", imsi_str.c_str());
+  }
+}
+
+status_code_e MmeNasStateManager::read_ue_state_from_db() {
+  if (!persist_state_enabled) {
+    return RETURNok;
+  }
+  // The debug read-from-db path can re-enter while a sweep is running
+  stop_hydration_thread();
+
+  auto keys = redis_client->get_keys("IMSI*" + task_name + "*");
+  if (keys.empty()) {
+    return RETURNok;
+  }
+
+  // Only the key listing happens up front; the contexts themselves are
+  // restored by the background sweep or on first touch, so the task is
+  // serving signaling while hydration proceeds
+  {
+    std::lock_guard<std::mutex> lock(hydration_lock_);
+    hydration_pending_keys_.clear();
+    hydration_pending_keys_.insert(keys.begin(), keys.end());
+  }
+  hydration_active_ = true;
+  OAILOG_INFO(
+      log_task, "Deferred hydration of %lu UE contexts from db", keys.size());
+  start_hydration_thread();
+  return RETURNok;
+}
+
+status_code_e MmeNasStateManager::hydrate_ue_from_db(
+    RedisClient& client, const std::string& key) {
+  OAILOG_DEBUG(log_task, "Reading UE state from db for %s", key.c_str());
+  oai::UeContext ue_proto = oai::UeContext();
+  if (client.read_proto(key, ue_proto) != RETURNok) {
+    OAILOG_ERROR(log_task, "Failed to read UE state for %s", key.c_str());
+    return RETURNerror;
+  }
+  auto* ue_context = (ue_mm_context_t*) (calloc(1, sizeof(ue_mm_context_t)));
+  MmeNasStateConverter::proto_to_ue(ue_proto, ue_context);
+
+  hashtable_rc_t h_rc = hashtable_ts_insert(
+      state_ue_ht, ue_context->mme_ue_s1ap_id, (void*) ue_context);
+  if (HASH_TABLE_OK != h_rc) {
+    OAILOG_ERROR(
+        log_task,
+        "Failed to insert UE state with key mme_ue_s1ap_id "
+        " " MME_UE_S1AP_ID_FMT " (Error Code: %s)\n",
+        ue_context->mme_ue_s1ap_id, hashtable_rc_code2string(h_rc));
+  } else {
+    OAILOG_DEBUG(
+        log_task,
+        "Inserted UE state with key mme_ue_s1ap_id " MME_UE_S1AP_ID_FMT,
+        ue_context->mme_ue_s1ap_id);
   }
   return RETURNok;
 }
 
+void MmeNasStateManager::hydrate_ue_state(imsi64_t imsi64) {
+  if (!hydration_active_) {
+    return;
+  }
+  std::string key = IMSI_PREFIX + get_imsi_str(imsi64) + ":" + task_name;
+  {
+    std::lock_guard<std::mutex> lock(hydration_lock_);
+    if (hydration_pending_keys_.erase(key) == 0) {
+      return;  // already hydrated, or never stored
+    }
+    if (hydration_pending_keys_.empty()) {
+      hydration_active_ = false;
+    }
+  }
+  hydrate_ue_from_db(*redis_client, key);
+}
+
+// Callback for the IMSI => mme_ue_s1ap_id map; stops on the first match
+// and reports the IMSI holding the target id
+static bool mme_app_find_imsi_by_ue_id_cb(
+    const hash_key_t keyP, const uint64_t dataP, void* parameterP,
+    void** resultP) {
+  mme_ue_s1ap_id_t* target_ue_id = (mme_ue_s1ap_id_t*) parameterP;
+  imsi64_t** imsi_pp             = (imsi64_t**) resultP;
+  if ((mme_ue_s1ap_id_t) dataP == *target_ue_id) {
+    **imsi_pp = (imsi64_t) keyP;
+    return true;
+  }
+  return false;
+}
+
+void MmeNasStateManager::hydrate_ue_state_by_ue_id(
+    mme_ue_s1ap_id_t mme_ue_s1ap_id) {
+  if (!hydration_active_ || !state_cache_p) {
+    return;
+  }
+  // The id maps are restored eagerly with the task-wide state, so the
+  // reverse scan only runs while contexts are still pending
+  imsi64_t imsi64         = INVALID_IMSI64;
+  imsi64_t* imsi_result_p = &imsi64;
+  mme_ue_s1ap_id_t ue_id  = mme_ue_s1ap_id;
+  hashtable_uint64_ts_apply_callback_on_elements(
+      state_cache_p->mme_ue_contexts.imsi_mme_ue_id_htbl,
+      mme_app_find_imsi_by_ue_id_cb, &ue_id, (void**) &imsi_result_p);
+  if (imsi64 != INVALID_IMSI64) {
+    hydrate_ue_state(imsi64);
+  }
+}
+
+void MmeNasStateManager::start_hydration_thread() {
+  hydration_running_ = true;
+  hydration_thread_ =
+      std::thread(&MmeNasStateManager::hydration_thread_loop, this);
+}
+
+void MmeNasStateManager::stop_hydration_thread() {
+  {
+    std::lock_guard<std::mutex> lock(hydration_lock_);
+    hydration_running_ = false;
+  }
+  if (hydration_thread_.joinable()) {
+    hydration_thread_.join();
+  }
+}
+
+void MmeNasStateManager::hydration_thread_loop() {
+  // Private connection, so hydration reads never interleave with the
+  // task thread's commands on the shared one
+  auto client =
+      std::make_unique<RedisClient>(true, false /* use_shared_connection */);
+  while (true) {
+    std::string key;
+    {
+      std::lock_guard<std::mutex> lock(hydration_lock_);
+      if (!hydration_running_ || hydration_pending_keys_.empty()) {
+        if (hydration_pending_keys_.empty()) {
+          hydration_active_ = false;
+        }
+        break;
+      }
+      key = *hydration_pending_keys_.begin();
+      hydration_pending_keys_.erase(hydration_pending_keys_.begin());
+    }
+    hydrate_ue_from_db(*client, key);
+  }
+  OAILOG_INFO(log_task, "Background UE state hydration finished");
+}
+
 }  // namespace lte
 }  // namespace magma
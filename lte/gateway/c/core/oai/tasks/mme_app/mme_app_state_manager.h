@@ -21,6 +21,14 @@ extern "C" {
 #include "mme_config.h"
 }
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
 #include <state_manager.h>
 #include "mme_app_state_converter.h"
 #include "includes/ServiceConfigLoader.h"
@@ -61,8 +69,47 @@ class MmeNasStateManager
 
   void free_state() override;
 
+  /**
+   * Write the task-wide state to db, skipping the protobuf conversion
+   * altogether when no mutating operation happened since the last sync
+   */
+  void write_state_to_db() override;
+
+  /**
+   * Snapshot the UE context into its protobuf form on the calling thread and
+   * queue it for the persistence thread, which does the serialization, the
+   * hash comparison and the redis write; signaling never blocks on redis
+   */
+  void write_ue_state_to_db(
+      const ue_mm_context_t* ue_context, const std::string& imsi_str) override;
+
+  /**
+   * Shadows the (non-virtual) base function so deletes go through the
+   * persistence queue and keep their order relative to queued writes for the
+   * same IMSI
+   */
+  void clear_ue_state_db(const std::string& imsi_str);
+
+  /**
+   * On a stateless restart, list the stored UE keys and return without
+   * deserializing them; contexts are hydrated lazily by a background
+   * sweep and by the first-touch hooks below, so signaling resumes
+   * without waiting for a full-state restore
+   */
   status_code_e read_ue_state_from_db() override;
 
+  /**
+   * Restore one pending UE context from the data store right now (first
+   * touch during a stateless restart); no-op once hydration has finished
+   */
+  void hydrate_ue_state(imsi64_t imsi64);
+
+  /**
+   * Same, for lookups that only hold the mme_ue_s1ap_id; the IMSI is
+   * recovered from the restored id maps
+   */
+  void hydrate_ue_state_by_ue_id(mme_ue_s1ap_id_t mme_ue_s1ap_id);
+
   /**
    * Copy constructor and assignment operator are marked as deleted functions.
    * Making them public for better debugging/logging.
@@ -79,6 +126,64 @@ class MmeNasStateManager
 
   int max_ue_htbl_lists_;
 
+  // Signature of the state observed by the last sync, see state_signature()
+  uint64_t last_sync_signature_;
+  bool has_synced_;
+
+  // Sum of the monotonic mutation counters covering mme_app_desc_t; two equal
+  // signatures imply that no counter moved in between
+  uint64_t state_signature();
+
+  /**
+   * One queued persistence operation per IMSI; queuing a newer snapshot or a
+   * delete simply replaces the previous entry, so a UE touched several times
+   * between flushes is written once with its latest state
+   */
+  struct PendingUeWrite {
+    bool is_delete;
+    oai::UeContext ue_proto;
+  };
+
+  std::thread persistence_thread_;
+  std::mutex pending_lock_;
+  std::condition_variable pending_cv_;
+  std::unordered_map<std::string, PendingUeWrite> pending_ue_writes_;
+  bool persistence_running_;
+  // The persistence thread gets its own connection so it never shares the
+  // task thread's redis client
+  std::unique_ptr<RedisClient> persistence_redis_client_;
+
+  // Start/stop the low-priority persistence thread; stop drains the queue
+  void start_persistence_thread();
+  void stop_persistence_thread();
+  void persistence_thread_loop();
+
+  /**
+   * Lazy hydration on stateless restart: stored UE keys wait here until
+   * either the background sweep or a first-touch lookup restores them.
+   * hydration_active_ gates the first-touch hooks so lookups pay nothing
+   * once the sweep is done
+   */
+  std::thread hydration_thread_;
+  std::mutex hydration_lock_;
+  std::unordered_set<std::string> hydration_pending_keys_;
+  bool hydration_running_;
+  std::atomic<bool> hydration_active_;
+
+  void start_hydration_thread();
+  void stop_hydration_thread();
+  void hydration_thread_loop();
+
+  // Read, convert and insert a single UE context; covers the EMM/ESM
+  // sub-contexts through the regular proto_to_ue conversion
+  status_code_e hydrate_ue_from_db(
+      RedisClient& client, const std::string& key);
+
+  // Serialize and queue one pending operation on the persistence thread;
+  // the drain loop commits each burst as a single pipeline
+  void flush_pending_ue_write(
+      const std::string& imsi_str, PendingUeWrite& pending);
+
   // Initialize state that is non-persistent, e.g. mutex locks and timers
   void mme_nas_state_init_local_state();
 
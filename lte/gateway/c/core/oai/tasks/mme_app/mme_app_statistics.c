@@ -22,16 +22,40 @@
 /*********************************** Utility Functions to update
  * Statistics**************************************/
 
+/* The counters are bumped from FSM transition paths and read by the
+ * periodic stats timer and service303 export. Relaxed atomics keep the
+ * bumps safe if transition handlers ever run off the mme_app thread,
+ * without any locking or per-tick walk of the UE contexts. */
+
+static void stats_counter_add(uint32_t* counter) {
+  __atomic_fetch_add(counter, 1, __ATOMIC_RELAXED);
+}
+
+static void stats_counter_sub(uint32_t* counter) {
+  // Clamp at zero: a missed add must not wrap the gauge to 4 billion
+  uint32_t curr = __atomic_load_n(counter, __ATOMIC_RELAXED);
+  while (curr != 0 && !__atomic_compare_exchange_n(
+                          counter, &curr, curr - 1, false, __ATOMIC_RELAXED,
+                          __ATOMIC_RELAXED)) {
+  }
+}
+
+static void stats_version_bump(mme_app_desc_t* mme_app_desc_p) {
+  __atomic_fetch_add(&mme_app_desc_p->state_version, 1, __ATOMIC_RELAXED);
+}
+
 /*****************************************************/
 // Number of Connected UEs
 void update_mme_app_stats_connected_ue_add(void) {
   mme_app_desc_t* mme_app_desc_p = get_mme_nas_state(false);
-  (mme_app_desc_p->nb_ue_connected)++;
+  stats_counter_add(&mme_app_desc_p->nb_ue_connected);
+  stats_version_bump(mme_app_desc_p);
   return;
 }
 void update_mme_app_stats_connected_ue_sub(void) {
   mme_app_desc_t* mme_app_desc_p = get_mme_nas_state(false);
-  if (mme_app_desc_p->nb_ue_connected != 0) (mme_app_desc_p->nb_ue_connected)--;
+  stats_counter_sub(&mme_app_desc_p->nb_ue_connected);
+  stats_version_bump(mme_app_desc_p);
   return;
 }
 
@@ -39,12 +63,14 @@ void update_mme_app_stats_connected_ue_sub(void) {
 // Number of S1U Bearers
 void update_mme_app_stats_s1u_bearer_add(void) {
   mme_app_desc_t* mme_app_desc_p = get_mme_nas_state(false);
-  (mme_app_desc_p->nb_s1u_bearers)++;
+  stats_counter_add(&mme_app_desc_p->nb_s1u_bearers);
+  stats_version_bump(mme_app_desc_p);
   return;
 }
 void update_mme_app_stats_s1u_bearer_sub(void) {
   mme_app_desc_t* mme_app_desc_p = get_mme_nas_state(false);
-  if (mme_app_desc_p->nb_s1u_bearers != 0) (mme_app_desc_p->nb_s1u_bearers)--;
+  stats_counter_sub(&mme_app_desc_p->nb_s1u_bearers);
+  stats_version_bump(mme_app_desc_p);
   return;
 }
 
@@ -52,13 +78,14 @@ void update_mme_app_stats_s1u_bearer_sub(void) {
 // Number of Default EPS Bearers
 void update_mme_app_stats_default_bearer_add(void) {
   mme_app_desc_t* mme_app_desc_p = get_mme_nas_state(false);
-  (mme_app_desc_p->nb_default_eps_bearers)++;
+  stats_counter_add(&mme_app_desc_p->nb_default_eps_bearers);
+  stats_version_bump(mme_app_desc_p);
   return;
 }
 void update_mme_app_stats_default_bearer_sub(void) {
   mme_app_desc_t* mme_app_desc_p = get_mme_nas_state(false);
-  if (mme_app_desc_p->nb_default_eps_bearers != 0)
-    (mme_app_desc_p->nb_default_eps_bearers)--;
+  stats_counter_sub(&mme_app_desc_p->nb_default_eps_bearers);
+  stats_version_bump(mme_app_desc_p);
   return;
 }
 
@@ -66,12 +93,42 @@ void update_mme_app_stats_default_bearer_sub(void) {
 // Number of Attached UEs
 void update_mme_app_stats_attached_ue_add(void) {
   mme_app_desc_t* mme_app_desc_p = get_mme_nas_state(false);
-  (mme_app_desc_p->nb_ue_attached)++;
+  stats_counter_add(&mme_app_desc_p->nb_ue_attached);
+  stats_version_bump(mme_app_desc_p);
   return;
 }
 void update_mme_app_stats_attached_ue_sub(void) {
   mme_app_desc_t* mme_app_desc_p = get_mme_nas_state(false);
-  if (mme_app_desc_p->nb_ue_attached != 0) (mme_app_desc_p->nb_ue_attached)--;
+  stats_counter_sub(&mme_app_desc_p->nb_ue_attached);
+  stats_version_bump(mme_app_desc_p);
   return;
 }
 /*****************************************************/
+
+/*****************************************************/
+// Snapshot for the periodic display and service303 export
+void mme_app_fill_stats_msg(application_mme_app_stats_msg_t* stats_msg) {
+  mme_app_desc_t* mme_app_desc_p = get_mme_nas_state(false);
+  stats_msg->nb_ue_attached =
+      __atomic_load_n(&mme_app_desc_p->nb_ue_attached, __ATOMIC_RELAXED);
+  stats_msg->nb_ue_connected =
+      __atomic_load_n(&mme_app_desc_p->nb_ue_connected, __ATOMIC_RELAXED);
+  stats_msg->nb_default_eps_bearers = __atomic_load_n(
+      &mme_app_desc_p->nb_default_eps_bearers, __ATOMIC_RELAXED);
+  stats_msg->nb_s1u_bearers =
+      __atomic_load_n(&mme_app_desc_p->nb_s1u_bearers, __ATOMIC_RELAXED);
+
+  // Occupancy of the UE context hashtable, so dashboards can spot tables
+  // that outgrew their configured size and are still draining a grow
+  hashtable_stats_t htbl_stats = {0};
+  if (hashtable_ts_get_stats(get_mme_ue_state(), &htbl_stats) ==
+      HASH_TABLE_OK) {
+    stats_msg->nb_ue_context_htbl_buckets  = htbl_stats.size;
+    stats_msg->nb_ue_context_htbl_elements = htbl_stats.num_elements;
+    stats_msg->ue_context_htbl_max_chain   = htbl_stats.max_chain_length;
+  } else {
+    stats_msg->nb_ue_context_htbl_buckets  = 0;
+    stats_msg->nb_ue_context_htbl_elements = 0;
+    stats_msg->ue_context_htbl_max_chain   = 0;
+  }
+}
@@ -0,0 +1,88 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file mme_app_tmsi_alloc.c
+ * \brief Segmented M-TMSI allocator
+ *
+ * GUTI assignment used to draw the M-TMSI from rand(), which serializes
+ * callers on the libc PRNG lock and, worse, can hand the same TMSI to two
+ * subscribers since nothing checked for collisions. The allocator here
+ * walks a 32-bit sequence instead: each thread claims a block of 1024
+ * sequence numbers with one atomic fetch-add and then allocates from the
+ * block privately, so concurrent NAS workers never contend. The sequence
+ * number is pushed through a fixed bijection on 2^32 (odd-constant
+ * multiply and xor with a per-boot salt) so consecutive attaches do not
+ * receive guessably consecutive identities while uniqueness is preserved.
+ *
+ * TMSIs are not explicitly recycled: the sequence only repeats after 2^32
+ * allocations, orders of magnitude beyond the lifetime attach count of a
+ * gateway, and by then the original holders are long detached.
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "mme_app_tmsi_alloc.h"
+
+// Sequence numbers claimed per atomic block grab
+#define TMSI_ALLOC_BLOCK_SIZE 1024
+
+// Shared cursor, counts blocks handed out since start-up
+static uint32_t tmsi_next_block = 0;
+
+// Per-boot whitening salt. All threads must whiten with the same salt or
+// the mapping stops being a bijection, hence the once guard.
+static uint32_t tmsi_salt            = 0;
+static pthread_once_t tmsi_salt_once = PTHREAD_ONCE_INIT;
+
+// Private block of the calling thread
+static __thread uint32_t tmsi_block_next      = 0;
+static __thread uint32_t tmsi_block_remaining = 0;
+
+//------------------------------------------------------------------------------
+static void tmsi_salt_init(void) {
+  // note srand with seed is initialized at main
+  tmsi_salt = ((uint32_t) rand() << 16) ^ (uint32_t) rand();
+}
+
+//------------------------------------------------------------------------------
+static uint32_t tmsi_whiten(uint32_t seq) {
+  // Odd-constant multiplication is a bijection on 2^32 (Knuth's
+  // multiplicative hash constant), so distinct sequence numbers always map
+  // to distinct TMSIs
+  return (seq * 2654435761u) ^ tmsi_salt;
+}
+
+//------------------------------------------------------------------------------
+tmsi_t mme_app_allocate_tmsi(void) {
+  pthread_once(&tmsi_salt_once, tmsi_salt_init);
+  tmsi_t tmsi;
+  do {
+    if (tmsi_block_remaining == 0) {
+      uint32_t block = __atomic_fetch_add(
+          &tmsi_next_block, 1, __ATOMIC_RELAXED);
+      tmsi_block_next      = block * TMSI_ALLOC_BLOCK_SIZE;
+      tmsi_block_remaining = TMSI_ALLOC_BLOCK_SIZE;
+    }
+    tmsi = (tmsi_t) tmsi_whiten(tmsi_block_next++);
+    tmsi_block_remaining--;
+    // The network shall not allocate a TMSI with all bits set (TS 23.003);
+    // skip the single sequence number that whitens to it
+  } while (tmsi == INVALID_M_TMSI);
+  return tmsi;
+}
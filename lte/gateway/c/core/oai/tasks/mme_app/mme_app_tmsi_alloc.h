@@ -0,0 +1,34 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file mme_app_tmsi_alloc.h
+ * \brief Segmented, collision-free M-TMSI allocator for GUTI assignment.
+ * Threads take blocks of sequence numbers from a shared atomic cursor and
+ * then allocate from their private block without any synchronization; the
+ * sequence is whitened through a bijection so TMSIs on air are scattered.
+ */
+
+#ifndef FILE_MME_APP_TMSI_ALLOC_SEEN
+#define FILE_MME_APP_TMSI_ALLOC_SEEN
+
+#include "3gpp_23.003.h"
+
+// Allocate a unique M-TMSI. Never returns INVALID_M_TMSI. Safe to call from
+// any thread; only every 1024th call touches shared state.
+tmsi_t mme_app_allocate_tmsi(void);
+
+#endif /* FILE_MME_APP_TMSI_ALLOC_SEEN */
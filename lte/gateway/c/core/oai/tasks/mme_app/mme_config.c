@@ -54,6 +54,7 @@
 #include "log.h"
 #include "common_defs.h"
 #include "mme_config.h"
+#include "mme_tai_table.h"
 #include "3gpp_33.401.h"
 #include "intertask_interface_conf.h"
 #include "3gpp_23.003.h"
@@ -167,8 +168,14 @@ void s6a_config_init(s6a_config_t* s6a_conf) {
 }
 
 void itti_config_init(itti_config_t* itti_conf) {
-  itti_conf->queue_size = ITTI_QUEUE_MAX_ELEMENTS;
-  itti_conf->log_file   = NULL;
+  itti_conf->queue_size         = ITTI_QUEUE_MAX_ELEMENTS;
+  itti_conf->log_file           = NULL;
+  itti_conf->nb_task_placements = 0;
+  for (int i = 0; i < ITTI_TASK_PLACEMENT_MAX; i++) {
+    itti_conf->task_placements[i].task_name       = NULL;
+    itti_conf->task_placements[i].core            = -1;
+    itti_conf->task_placements[i].sched_fifo_prio = 0;
+  }
 }
 
 void sctp_config_init(sctp_config_t* sctp_conf) {
@@ -287,6 +294,9 @@ void mme_config_exit(void) {
   bdestroy_wrapper(&mme_config.ip.if_name_s11);
   bdestroy_wrapper(&mme_config.s6a_config.conf_file);
   bdestroy_wrapper(&mme_config.itti_config.log_file);
+  for (int i = 0; i < ITTI_TASK_PLACEMENT_MAX; i++) {
+    bdestroy_wrapper(&mme_config.itti_config.task_placements[i].task_name);
+  }
 
   free_wrapper((void**) &mme_config.served_tai.plmn_mcc);
   free_wrapper((void**) &mme_config.served_tai.plmn_mnc);
@@ -535,6 +545,12 @@ int mme_config_parse_file(mme_config_t* config_pP) {
       config_pP->use_stateless = parse_bool(astring);
     }
 
+    if ((config_setting_lookup_string(
+            setting_mme, MME_CONFIG_STRING_USE_HUGEPAGE_ARENA,
+            (const char**) &astring))) {
+      config_pP->use_hugepage_arena = parse_bool(astring);
+    }
+
     if ((config_setting_lookup_string(
             setting_mme, MME_CONFIG_STRING_ENABLE_CONVERGED_CORE,
             (const char**) &astring))) {
@@ -626,6 +642,48 @@ int mme_config_parse_file(mme_config_t* config_pP) {
               &aint))) {
         config_pP->itti_config.queue_size = (uint32_t) aint;
       }
+
+      subsetting = config_setting_get_member(
+          setting, MME_CONFIG_STRING_ITTI_TASK_PLACEMENT);
+
+      if (subsetting != NULL) {
+        num = config_setting_length(subsetting);
+        if (num > ITTI_TASK_PLACEMENT_MAX) {
+          OAILOG_ERROR(
+              LOG_CONFIG, "Too many task placements (%d), only %d are used\n",
+              num, ITTI_TASK_PLACEMENT_MAX);
+          num = ITTI_TASK_PLACEMENT_MAX;
+        }
+        config_pP->itti_config.nb_task_placements = num;
+
+        for (i = 0; i < num; i++) {
+          sub2setting = config_setting_get_elem(subsetting, i);
+
+          if (sub2setting != NULL) {
+            itti_task_placement_t* placement =
+                &config_pP->itti_config.task_placements[i];
+
+            if ((config_setting_lookup_string(
+                    sub2setting, MME_CONFIG_STRING_ITTI_TASK_NAME,
+                    (const char**) &astring))) {
+              if (placement->task_name) {
+                bassigncstr(placement->task_name, astring);
+              } else {
+                placement->task_name = bfromcstr(astring);
+              }
+            }
+            if ((config_setting_lookup_int(
+                    sub2setting, MME_CONFIG_STRING_ITTI_TASK_CORE, &aint))) {
+              placement->core = aint;
+            }
+            if ((config_setting_lookup_int(
+                    sub2setting,
+                    MME_CONFIG_STRING_ITTI_TASK_SCHED_FIFO_PRIORITY, &aint))) {
+              placement->sched_fifo_prio = aint;
+            }
+          }
+        }
+      }
     }
 #if !S6A_OVER_GRPC
     // S6A SETTING
@@ -1581,6 +1639,9 @@ int mme_config_parse_file(mme_config_t* config_pP) {
   }
 
   config_destroy(&cfg);
+  // Derive the read-optimized served PLMN/TAC lookup tables from the list
+  // just parsed; per-message validation consults them lock-free
+  mme_tai_table_rebuild(&config_pP->served_tai);
   return 0;
 }
 
@@ -19,6 +19,7 @@
 
 #include <cstdlib>
 #include <iostream>
+#include <utility>
 #include <folly/Format.h>
 #include <folly/json.h>
 #include <folly/dynamic.h>
@@ -65,9 +66,11 @@ static int report_event(
   event_request.set_stream_name(stream_name);
 
   std::string event_value_string = folly::toJson(event_value);
-  event_request.set_value(event_value_string);
+  event_request.set_value(std::move(event_value_string));
   event_request.set_tag(event_tag);
-  return log_event(event_request);
+  // Moved into the staging buffer; the flusher thread serializes and
+  // sends it off the signaling path
+  return log_event(std::move(event_request));
 }
 
 int attach_success_event(imsi64_t imsi64) {
@@ -0,0 +1,273 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+/*! \file mme_tai_table.c
+ * \brief Read-optimized lookup tables over the served TAI list
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "log.h"
+#include "mme_tai_table.h"
+
+// The served TAI list holds at most 255 entries (nb_tai is a uint8_t), so
+// tables of 1024 slots keep the load factor at or below 1/4 and seed
+// search terminates after a handful of attempts
+#define TAI_TABLE_SLOTS 1024
+#define TAI_TABLE_SLOT_MASK (TAI_TABLE_SLOTS - 1)
+#define TAI_TABLE_BITMAP_WORDS (TAI_TABLE_SLOTS / 64)
+#define TAI_TABLE_SEED_ATTEMPTS 256
+
+/*
+ * All state lives in one static block guarded by its own sequence counter,
+ * following the mme_config seqlock convention: the rebuild path brackets
+ * its writes with two increments and lookups retry when they observe a
+ * rebuild in progress. Empty slots hold 0; occupied slots hold key + 1.
+ */
+static struct {
+  uint64_t seq;
+  // one bit per hashed served PLMN: a clear bit rejects a foreign PLMN
+  // with a single load, before any exact probe
+  uint64_t plmn_bitmap[TAI_TABLE_BITMAP_WORDS];
+  uint64_t plmn_seed;
+  uint64_t tac_seed;
+  uint64_t tai_seed;
+  uint32_t plmn_slots[TAI_TABLE_SLOTS];
+  uint32_t tac_slots[TAI_TABLE_SLOTS];
+  uint64_t tai_slots[TAI_TABLE_SLOTS];
+} tai_table;
+
+//------------------------------------------------------------------------------
+static uint64_t tai_table_mix(uint64_t key, uint64_t seed) {
+  uint64_t x = key ^ seed;
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+// 22-bit PLMN key: the MNC length distinguishes e.g. MNC 01 from MNC 001
+static uint32_t tai_table_plmn_key(
+    uint16_t mcc, uint16_t mnc, uint16_t mnc_len) {
+  return ((uint32_t) mcc << 12) | ((uint32_t) mnc << 2) | (uint32_t) mnc_len;
+}
+
+static uint64_t tai_table_tai_key(uint32_t plmn_key, uint16_t tac) {
+  return ((uint64_t) plmn_key << 16) | (uint64_t) tac;
+}
+
+//------------------------------------------------------------------------------
+/*
+ * Count how many keys collide on their home slot under the given seed.
+ * Duplicate keys (the served TAI arrays repeat the PLMN per TAC) do not
+ * count as collisions.
+ */
+static int tai_table_seed_collisions(
+    const uint64_t* keys, int nb_keys, uint64_t seed) {
+  bool taken[TAI_TABLE_SLOTS] = {false};
+  int collisions              = 0;
+
+  for (int i = 0; i < nb_keys; i++) {
+    bool duplicate = false;
+    for (int j = 0; j < i; j++) {
+      if (keys[j] == keys[i]) {
+        duplicate = true;
+        break;
+      }
+    }
+    if (duplicate) {
+      continue;
+    }
+    uint32_t slot = tai_table_mix(keys[i], seed) & TAI_TABLE_SLOT_MASK;
+    if (taken[slot]) {
+      collisions++;
+    }
+    taken[slot] = true;
+  }
+  return collisions;
+}
+
+/*
+ * Pick the seed with the fewest home-slot collisions (zero for the small
+ * lists of real deployments, so every lookup is a single probe) and fill
+ * the tables by linear probing from the home slot. Lookups probe until
+ * they hit the key or an empty slot; the tables never fill beyond a
+ * quarter, so displaced entries sit within a couple of slots of home.
+ */
+static uint64_t tai_table_pick_seed(const uint64_t* keys, int nb_keys) {
+  uint64_t best_seed = 0x5851f42d4c957f2dULL;
+  int best           = tai_table_seed_collisions(keys, nb_keys, best_seed);
+
+  for (int attempt = 1; attempt < TAI_TABLE_SEED_ATTEMPTS && best > 0;
+       attempt++) {
+    uint64_t seed  = 0x5851f42d4c957f2dULL + attempt;
+    int collisions = tai_table_seed_collisions(keys, nb_keys, seed);
+    if (collisions < best) {
+      best      = collisions;
+      best_seed = seed;
+    }
+  }
+  return best_seed;
+}
+
+static void tai_table_place32(
+    const uint64_t* keys, int nb_keys, uint32_t* slots, uint64_t* seed_out) {
+  uint64_t seed = tai_table_pick_seed(keys, nb_keys);
+
+  memset(slots, 0, TAI_TABLE_SLOTS * sizeof(slots[0]));
+  for (int i = 0; i < nb_keys; i++) {
+    uint32_t slot = tai_table_mix(keys[i], seed) & TAI_TABLE_SLOT_MASK;
+    while (slots[slot] != 0 && slots[slot] != (uint32_t) keys[i] + 1) {
+      slot = (slot + 1) & TAI_TABLE_SLOT_MASK;
+    }
+    slots[slot] = (uint32_t) keys[i] + 1;
+  }
+  *seed_out = seed;
+}
+
+static void tai_table_place64(
+    const uint64_t* keys, int nb_keys, uint64_t* slots, uint64_t* seed_out) {
+  uint64_t seed = tai_table_pick_seed(keys, nb_keys);
+
+  memset(slots, 0, TAI_TABLE_SLOTS * sizeof(slots[0]));
+  for (int i = 0; i < nb_keys; i++) {
+    uint32_t slot = tai_table_mix(keys[i], seed) & TAI_TABLE_SLOT_MASK;
+    while (slots[slot] != 0 && slots[slot] != keys[i] + 1) {
+      slot = (slot + 1) & TAI_TABLE_SLOT_MASK;
+    }
+    slots[slot] = keys[i] + 1;
+  }
+  *seed_out = seed;
+}
+
+//------------------------------------------------------------------------------
+void mme_tai_table_rebuild(const served_tai_t* served_tai) {
+  uint64_t plmn_keys[256];
+  uint64_t tac_keys[256];
+  uint64_t tai_keys[256];
+  int nb = served_tai->nb_tai;
+
+  for (int i = 0; i < nb; i++) {
+    plmn_keys[i] = tai_table_plmn_key(
+        served_tai->plmn_mcc[i], served_tai->plmn_mnc[i],
+        served_tai->plmn_mnc_len[i]);
+    tac_keys[i] = served_tai->tac[i];
+    tai_keys[i] = tai_table_tai_key(plmn_keys[i], served_tai->tac[i]);
+  }
+
+  // Odd sequence marks the rebuild in progress, exactly like a mme_config
+  // write; lookups observing it (or a change across their reads) retry
+  __atomic_add_fetch(&tai_table.seq, 1, __ATOMIC_SEQ_CST);
+
+  memset(tai_table.plmn_bitmap, 0, sizeof(tai_table.plmn_bitmap));
+  for (int i = 0; i < nb; i++) {
+    uint32_t bit = tai_table_mix(plmn_keys[i], 0) & TAI_TABLE_SLOT_MASK;
+    tai_table.plmn_bitmap[bit >> 6] |= 1ULL << (bit & 63);
+  }
+  tai_table_place32(
+      plmn_keys, nb, tai_table.plmn_slots, &tai_table.plmn_seed);
+  tai_table_place32(tac_keys, nb, tai_table.tac_slots, &tai_table.tac_seed);
+  tai_table_place64(tai_keys, nb, tai_table.tai_slots, &tai_table.tai_seed);
+
+  __atomic_add_fetch(&tai_table.seq, 1, __ATOMIC_SEQ_CST);
+}
+
+//------------------------------------------------------------------------------
+static uint64_t tai_table_read_begin(void) {
+  uint64_t seq;
+
+  do {
+    seq = __atomic_load_n(&tai_table.seq, __ATOMIC_ACQUIRE);
+  } while (seq & 1);
+  return seq;
+}
+
+static bool tai_table_read_retry(uint64_t seq) {
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  return __atomic_load_n(&tai_table.seq, __ATOMIC_RELAXED) != seq;
+}
+
+//------------------------------------------------------------------------------
+bool mme_tai_table_plmn_served(
+    uint16_t mcc, uint16_t mnc, uint16_t mnc_len) {
+  uint32_t key = tai_table_plmn_key(mcc, mnc, mnc_len);
+  bool served;
+  uint64_t seq;
+
+  do {
+    seq          = tai_table_read_begin();
+    uint32_t bit = tai_table_mix(key, 0) & TAI_TABLE_SLOT_MASK;
+    if (!(tai_table.plmn_bitmap[bit >> 6] & (1ULL << (bit & 63)))) {
+      served = false;
+    } else {
+      uint32_t slot =
+          tai_table_mix(key, tai_table.plmn_seed) & TAI_TABLE_SLOT_MASK;
+      while (tai_table.plmn_slots[slot] != 0 &&
+             tai_table.plmn_slots[slot] != key + 1) {
+        slot = (slot + 1) & TAI_TABLE_SLOT_MASK;
+      }
+      served = (tai_table.plmn_slots[slot] == key + 1);
+    }
+  } while (tai_table_read_retry(seq));
+
+  return served;
+}
+
+//------------------------------------------------------------------------------
+bool mme_tai_table_tac_served(uint16_t tac) {
+  uint32_t key = tac;
+  bool served;
+  uint64_t seq;
+
+  do {
+    seq = tai_table_read_begin();
+    uint32_t slot =
+        tai_table_mix(key, tai_table.tac_seed) & TAI_TABLE_SLOT_MASK;
+    while (tai_table.tac_slots[slot] != 0 &&
+           tai_table.tac_slots[slot] != key + 1) {
+      slot = (slot + 1) & TAI_TABLE_SLOT_MASK;
+    }
+    served = (tai_table.tac_slots[slot] == key + 1);
+  } while (tai_table_read_retry(seq));
+
+  return served;
+}
+
+//------------------------------------------------------------------------------
+bool mme_tai_table_tai_served(
+    uint16_t mcc, uint16_t mnc, uint16_t mnc_len, uint16_t tac) {
+  uint64_t key = tai_table_tai_key(
+      tai_table_plmn_key(mcc, mnc, mnc_len), tac);
+  bool served;
+  uint64_t seq;
+
+  do {
+    seq = tai_table_read_begin();
+    uint32_t slot =
+        tai_table_mix(key, tai_table.tai_seed) & TAI_TABLE_SLOT_MASK;
+    while (tai_table.tai_slots[slot] != 0 &&
+           tai_table.tai_slots[slot] != key + 1) {
+      slot = (slot + 1) & TAI_TABLE_SLOT_MASK;
+    }
+    served = (tai_table.tai_slots[slot] == key + 1);
+  } while (tai_table_read_retry(seq));
+
+  return served;
+}
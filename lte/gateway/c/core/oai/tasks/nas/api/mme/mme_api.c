@@ -46,6 +46,7 @@
 #include "common_types.h"
 #include "common_defs.h"
 #include "mme_api.h"
+#include "mme_app_tmsi_alloc.h"
 #include "mme_app_ue_context.h"
 #include "mme_config.h"
 #include "emm_data.h"
@@ -71,8 +72,6 @@
 /* Total number of PDN connections (should not exceed MME_API_PDN_MAX) */
 static int mme_api_pdn_id = 0;
 
-static tmsi_t generate_random_TMSI(void);
-
 static int copy_plmn_from_config(
     const served_tai_t* served_tai, int index, plmn_t* plmn);
 
@@ -437,8 +436,9 @@ status_code_e mme_api_new_guti(
       OAILOG_FUNC_RETURN(LOG_NAS, RETURNerror);
     }
 
-    // TODO Find another way to generate m_tmsi
-    guti->m_tmsi = generate_random_TMSI();
+    // Collision-free and contention-free: threads draw from private
+    // blocks of a whitened 32-bit sequence (see mme_app_tmsi_alloc.c)
+    guti->m_tmsi = mme_app_allocate_tmsi();
     if (guti->m_tmsi == INVALID_M_TMSI) {
       OAILOG_FUNC_RETURN(LOG_NAS, RETURNerror);
     }
@@ -629,11 +629,6 @@ status_code_e mme_api_unsubscribe(bstring apn) {
   OAILOG_FUNC_RETURN(LOG_NAS, rc);
 }
 
-static tmsi_t generate_random_TMSI() {
-  // note srand with seed is initialized at main
-  return (tmsi_t) rand();
-}
-
 /****************************************************************************
  **                                                                        **
  ** Name:        copy_plmn_from_config()                                   **
@@ -55,6 +55,7 @@
 #include <stdlib.h>
 
 #include "assertions.h"
+#include "bstr_intern.h"
 #include "bstrlib.h"
 #include "common_types.h"
 #include "conversions.h"
@@ -1804,7 +1805,7 @@ static int emm_send_attach_accept(emm_context_t* emm_context) {
       emm_sap.u.emm_as.u.establish.nas_info = EMM_AS_NAS_INFO_ATTACH;
 
       NO_REQUIREMENT_3GPP_24_301(R10_5_5_1_2_4__3);
-      bdestroy_wrapper(&ue_mm_context_p->ue_radio_capability);
+      bstr_intern_release(&ue_mm_context_p->ue_radio_capability);
       //----------------------------------------
       REQUIREMENT_3GPP_24_301(R10_5_5_1_2_4__4);
       emm_ctx_set_attribute_valid(
@@ -1901,9 +1902,9 @@ static int emm_send_attach_accept(emm_context_t* emm_context) {
      * Delete any preexisting UE radio capabilities, pursuant to
      * GPP 24.310:5.5.1.2.4
      */
-    // Note: this is safe from double-free errors because it sets to NULL
-    // after freeing, which free treats as a no-op.
-    bdestroy_wrapper(&ue_mm_context_p->ue_radio_capability);
+    // Note: the capability may be a shared interned blob; release drops one
+    // reference (or destroys a plain bstring) and sets the field to NULL.
+    bstr_intern_release(&ue_mm_context_p->ue_radio_capability);
 
     /*
      * Setup EPS NAS security data
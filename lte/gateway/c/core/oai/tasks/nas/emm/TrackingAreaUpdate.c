@@ -19,6 +19,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 
+#include "bstr_intern.h"
 #include "dynamic_memory_check.h"
 #include "assertions.h"
 #include "log.h"
@@ -290,9 +291,9 @@ status_code_e emm_proc_tracking_area_update_request(
     OAILOG_DEBUG(
         LOG_NAS_EMM, "UE context exists: %s\n", ue_mm_context ? "yes" : "no");
     if (ue_mm_context) {
-      // Note: this is safe from double-free errors because it sets to NULL
-      // after freeing, which free treats as a no-op.
-      bdestroy_wrapper(&ue_mm_context->ue_radio_capability);
+      // Note: the capability may be a shared interned blob; release drops one
+      // reference (or destroys a plain bstring) and sets the field to NULL.
+      bstr_intern_release(&ue_mm_context->ue_radio_capability);
     }
   }
   /*
@@ -343,10 +344,10 @@ status_code_e emm_proc_tracking_area_update_request(
      * allocate a TAI list that does not span more than one location area.
      */
     // Handle periodic TAU
-    if (ue_mm_context->num_reg_sub > 0) {
+    if (ue_mm_context->subscription->num_reg_sub > 0) {
       if (verify_service_area_restriction(
-              tac, ue_mm_context->reg_sub, ue_mm_context->num_reg_sub) !=
-          RETURNok) {
+              tac, ue_mm_context->subscription->reg_sub,
+              ue_mm_context->subscription->num_reg_sub) != RETURNok) {
         OAILOG_ERROR_UE(
             LOG_MME_APP, ue_mm_context->emm_context._imsi64,
             "No suitable cells found for tac = %d, sending tau_reject "
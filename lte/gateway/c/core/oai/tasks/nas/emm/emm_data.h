@@ -157,6 +157,28 @@ typedef struct new_attach_info_s {
       is_mm_ctx_new; /* Attach request is received in S1ap initial UE message */
   struct emm_attach_request_ies_s* ies;
 } new_attach_info_t;
+
+/*
+ * Recent uplink PDU cache for NAS retransmission filtering: remembers a
+ * digest of the last few secured uplink PDUs so a byte-identical copy
+ * arriving within the replay window is dropped before decryption and
+ * procedure dispatch. A NAS retransmission reuses the sequence number and
+ * produces the same ciphertext, so the byte comparison covers it. Not
+ * persisted: after a restart the cache simply starts empty.
+ */
+#define EMM_UL_PDU_CACHE_SIZE 4
+#define EMM_UL_PDU_REPLAY_WINDOW_SEC 3
+typedef struct emm_ul_pdu_cache_entry_s {
+  uint32_t digest;  /* FNV-1a digest over the secured PDU bytes */
+  uint32_t length;  /* PDU length, cheap first-level filter     */
+  time_t last_seen; /* arrival time of the processed copy       */
+} emm_ul_pdu_cache_entry_t;
+
+typedef struct emm_ul_pdu_cache_s {
+  emm_ul_pdu_cache_entry_t entries[EMM_UL_PDU_CACHE_SIZE];
+  uint8_t next_slot;
+} emm_ul_pdu_cache_t;
+
 /*
  * Structure of the EMM context established by the network for a particular UE
  * ---------------------------------------------------------------------------
@@ -383,6 +405,8 @@ typedef struct emm_context_s {
   new_attach_info_t* new_attach_info;
   bool initiate_identity_after_smc;
   emm_context_state_t emm_context_state;
+  // Uplink retransmission filter, see emm_ul_pdu_cache_t (not persisted)
+  emm_ul_pdu_cache_t ul_pdu_cache;
 } emm_context_t;
 
 /*
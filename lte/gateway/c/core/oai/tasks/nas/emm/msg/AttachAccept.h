@@ -51,6 +51,13 @@
    EPS_NETWORK_FEATURE_SUPPORT_MAXIMUM_LENGTH +                                \
    ADDITIONAL_UPDATE_RESULT_MAXIMUM_LENGTH)
 
+/* Worst-case size of every IE except the variable length ESM message
+   container, folded to a compile time constant so senders can presize the
+   encode buffer in one pass instead of accumulating per-IE maxima while
+   filling in the message */
+#define ATTACH_ACCEPT_NON_ESM_MAXIMUM_LENGTH                                   \
+  (ATTACH_ACCEPT_MAXIMUM_LENGTH - ESM_MESSAGE_CONTAINER_MAXIMUM_LENGTH)
+
 /* If an optional value is present and should be encoded, the corresponding
  * Bit mask should be set to 1.
  */
@@ -19,6 +19,7 @@
 #include <stdbool.h>
 #include <string.h>
 #include <stdlib.h>
+#include <time.h>
 #include <netinet/in.h>
 
 #include "bstrlib.h"
@@ -605,6 +606,56 @@ static int emm_as_recv(
   OAILOG_FUNC_RETURN(LOG_NAS_EMM, rc);
 }
 
+/****************************************************************************
+ **                                                                        **
+ ** Name:    emm_as_filter_duplicate_ul_pdu()                          **
+ **                                                                        **
+ ** Description: Checks the secured uplink PDU against the per-UE cache    **
+ **      of recently processed PDUs. A NAS retransmission reuses   **
+ **      the sequence number and produces the same ciphertext, so  **
+ **      a byte-identical copy within the replay window is a       **
+ **      duplicate: the caller drops it before decryption and      **
+ **      procedure dispatch, and the response sent for the first   **
+ **      copy answers it. A fresh PDU is recorded for comparison;  **
+ **      entries age out so a genuine NAS layer retry (seconds     **
+ **      later, after its timer expiry) is processed in full.      **
+ **                                                                        **
+ ** Inputs:  emm_ctx:   The EMM context of the UE                  **
+ **      msg:       The secured NAS message                    **
+ **                                                                        **
+ ** Outputs:     Return:    true if the PDU is a recent duplicate      **
+ **      Others:    None                                       **
+ **                                                                        **
+ ***************************************************************************/
+static bool emm_as_filter_duplicate_ul_pdu(
+    emm_context_t* emm_ctx, const_bstring msg) {
+  emm_ul_pdu_cache_t* cache = &emm_ctx->ul_pdu_cache;
+  uint32_t digest           = 2166136261u;  // FNV-1a offset basis
+  time_t now                = time(NULL);
+
+  for (int i = 0; i < blength(msg); i++) {
+    digest ^= msg->data[i];
+    digest *= 16777619u;  // FNV-1a prime
+  }
+
+  for (int i = 0; i < EMM_UL_PDU_CACHE_SIZE; i++) {
+    emm_ul_pdu_cache_entry_t* entry = &cache->entries[i];
+    if ((entry->digest == digest) &&
+        (entry->length == (uint32_t) blength(msg)) &&
+        ((now - entry->last_seen) <= EMM_UL_PDU_REPLAY_WINDOW_SEC)) {
+      // Deliberately not refreshing last_seen: continuous retransmission
+      // must not keep a lost response suppressed forever
+      return true;
+    }
+  }
+
+  cache->entries[cache->next_slot].digest    = digest;
+  cache->entries[cache->next_slot].length    = blength(msg);
+  cache->entries[cache->next_slot].last_seen = now;
+  cache->next_slot = (cache->next_slot + 1) % EMM_UL_PDU_CACHE_SIZE;
+  return false;
+}
+
 /****************************************************************************
  **                                                                        **
  ** Name:    _emm_as_data_ind()                                        **
@@ -668,6 +719,24 @@ static int emm_as_data_ind(emm_as_data_t* msg, int* emm_cause) {
               msg->ue_id);
         }
 
+        if (emm_ctx &&
+            emm_as_filter_duplicate_ul_pdu(emm_ctx, msg->nas_msg)) {
+          /*
+           * Retransmission of a PDU processed moments ago: the response
+           * produced for the first copy answers it, skip decryption and
+           * the state machine
+           */
+          OAILOG_INFO(
+              LOG_NAS_EMM,
+              "EMMAS-SAP - Dropping retransmitted uplink NAS message "
+              "(ue_id=" MME_UE_S1AP_ID_FMT ", length=%d)\n",
+              msg->ue_id, blength(msg->nas_msg));
+          increment_counter("nas_ul_duplicate_pdu", 1, NO_LABELS);
+          bdestroy_wrapper(&plain_msg);
+          bdestroy_wrapper(&msg->nas_msg);
+          OAILOG_FUNC_RETURN(LOG_NAS_EMM, RETURNok);
+        }
+
         int bytes = nas_message_decrypt(
             msg->nas_msg->data, plain_msg->data, &header, blength(msg->nas_msg),
             security, &decode_status);
@@ -15,12 +15,15 @@
  *      contact@openairinterface.org
  */
 
+#include <arpa/inet.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
 #include <stdlib.h>
 
 #include "bstrlib.h"
+#include "nas/as_message.h"
+#include "mme_app_defs.h"
 #include "3gpp_24.008.h"
 #include "emm_recv.h"
 #include "common_defs.h"
@@ -1265,6 +1268,36 @@ static int emm_initiate_default_bearer_re_establishment(
   OAILOG_FUNC_IN(LOG_NAS_EMM);
   emm_sap_t emm_sap = {0};
   int rc            = RETURNerror;
+  if (!emm_ctx) {
+    OAILOG_FUNC_RETURN(LOG_NAS_EMM, rc);
+  }
+  /*
+   * Fast path for the plain service request: security context and GUTI are
+   * already validated at this point, so build the AS establish confirmation
+   * directly from the EMM context and hand it to mme_app in one step. This
+   * skips the EMM-AS SAP dispatch and its EMM/UE context re-lookups by
+   * ue_id, which the generic machinery performs twice per transition.
+   */
+  if (IS_EMM_CTXT_PRESENT_SECURITY(emm_ctx) &&
+      IS_EMM_CTXT_PRESENT_GUTI(emm_ctx)) {
+    nas_establish_rsp_t establish_cnf = {0};
+    establish_cnf.ue_id =
+        PARENT_STRUCT(emm_ctx, struct ue_mm_context_s, emm_context)
+            ->mme_ue_s1ap_id;
+    establish_cnf.s_tmsi.mme_code = emm_ctx->_guti.gummei.mme_code;
+    establish_cnf.s_tmsi.m_tmsi   = emm_ctx->_guti.m_tmsi;
+    establish_cnf.nas_msg         = NULL;
+    establish_cnf.selected_encryption_algorithm = (uint16_t) htons(
+        0x10000 >> emm_ctx->_security.selected_algorithms.encryption);
+    establish_cnf.selected_integrity_algorithm = (uint16_t) htons(
+        0x10000 >> emm_ctx->_security.selected_algorithms.integrity);
+    establish_cnf.nas_ul_count = 0x00000000 |
+                                 (emm_ctx->_security.ul_count.overflow << 8) |
+                                 emm_ctx->_security.ul_count.seq_num;
+    establish_cnf.err_code = AS_SUCCESS;
+    mme_app_handle_conn_est_cnf(&establish_cnf);
+    OAILOG_FUNC_RETURN(LOG_NAS_EMM, RETURNok);
+  }
   if (emm_ctx) {
     emm_sap.primitive = EMMAS_ESTABLISH_CNF;
     emm_sap.u.emm_as.u.establish.ue_id =
@@ -209,7 +209,11 @@ status_code_e emm_send_nw_detach_request(
 status_code_e emm_send_attach_accept(
     const emm_as_establish_t* msg, attach_accept_msg* emm_msg) {
   OAILOG_FUNC_IN(LOG_NAS_EMM);
-  int size = EMM_HEADER_MAXIMUM_LENGTH;
+  // Single pass: worst case of every fixed IE folded at compile time plus
+  // the actual ESM container, instead of accumulating per-IE maxima while
+  // filling in the message below
+  int size = EMM_HEADER_MAXIMUM_LENGTH + ATTACH_ACCEPT_NON_ESM_MAXIMUM_LENGTH +
+             ESM_MESSAGE_CONTAINER_MINIMUM_LENGTH + blength(msg->nas_msg);
 
   // Get the UE context
   emm_context_t* emm_ctx = emm_context_get(&_emm_data, msg->ue_id);
@@ -224,8 +228,6 @@ status_code_e emm_send_attach_accept(
       "EMMAS-SAP - Send Attach Accept message, ue_id = " MME_UE_S1AP_ID_FMT
       "\n",
       msg->ue_id);
-  OAILOG_DEBUG(
-      LOG_NAS_EMM, "EMMAS-SAP - size = EMM_HEADER_MAXIMUM_LENGTH(%d)\n", size);
   /*
    * Mandatory - Message type
    */
@@ -233,11 +235,6 @@ status_code_e emm_send_attach_accept(
   /*
    * Mandatory - EPS attach result
    */
-  size += EPS_ATTACH_RESULT_MAXIMUM_LENGTH;
-  OAILOG_DEBUG(
-      LOG_NAS_EMM,
-      "EMMAS-SAP - size += EPS_ATTACH_RESULT_MAXIMUM_LENGTH(%d)  (%d)\n",
-      EPS_ATTACH_RESULT_MAXIMUM_LENGTH, size);
   OAILOG_DEBUG(
       LOG_NAS_EMM,
       "EMMAS-SAP - EMM Context Attach Type (%d) for (ue_id = %u)\n",
@@ -302,7 +299,6 @@ status_code_e emm_send_attach_accept(
   /*
    * Mandatory - T3412 value
    */
-  size += GPRS_TIMER_IE_MAX_LENGTH;
   // Check whether Periodic TAU timer is disabled
   if (mme_config.nas_config.t3412_min == 0) {
     emm_msg->t3412value.unit       = GPRS_TIMER_UNIT_0S;
@@ -315,62 +311,19 @@ status_code_e emm_send_attach_accept(
     emm_msg->t3412value.timervalue = mme_config.nas_config.t3412_min / 6;
   }
   // emm_msg->t3412value.unit = GPRS_TIMER_UNIT_0S;
-  OAILOG_DEBUG(
-      LOG_NAS_EMM,
-      "EMMAS-SAP - size += GPRS_TIMER_IE_MAX_LENGTH(%d)  (%d) for (ue_id = "
-      "%u)\n",
-      GPRS_TIMER_IE_MAX_LENGTH, size, ue_id);
   /*
    * Mandatory - Tracking area identity list
    */
-  size +=
-      TRACKING_AREA_IDENTITY_LIST_MINIMUM_LENGTH * msg->tai_list.numberoflists;
   memcpy(&emm_msg->tailist, &msg->tai_list, sizeof(msg->tai_list));
-  OAILOG_DEBUG(
-      LOG_NAS_EMM,
-      "EMMAS-SAP - size += "
-      "TRACKING_AREA_IDENTITY_LIST_LENGTH(%d*%d)  (%d) for (ue_id = %u)\n",
-      TRACKING_AREA_IDENTITY_LIST_MINIMUM_LENGTH,
-      emm_msg->tailist.numberoflists, size, ue_id);
-
-  for (int p = 0; p < emm_msg->tailist.numberoflists; p++) {
-    if (TRACKING_AREA_IDENTITY_LIST_ONE_PLMN_NON_CONSECUTIVE_TACS ==
-        emm_msg->tailist.partial_tai_list[p].typeoflist) {
-      size = size + (2 * emm_msg->tailist.partial_tai_list[p].numberofelements);
-      OAILOG_DEBUG(
-          LOG_NAS_EMM,
-          "EMMAS-SAP - size += "
-          "TRACKING AREA CODE LENGTH(%d*%d)  (%d) for (ue_id = %u)\n",
-          2, emm_msg->tailist.partial_tai_list[p].numberofelements, size,
-          ue_id);
-    } else if (
-        TRACKING_AREA_IDENTITY_LIST_MANY_PLMNS ==
-        emm_msg->tailist.partial_tai_list[p].typeoflist) {
-      size = size + (5 * emm_msg->tailist.partial_tai_list[p].numberofelements);
-      OAILOG_DEBUG(
-          LOG_NAS_EMM,
-          "EMMAS-SAP - size += "
-          "TRACKING AREA CODE LENGTH(%d*%d)  (%d) for (ue_id = %u)\n",
-          5, emm_msg->tailist.partial_tai_list[p].numberofelements, size,
-          ue_id);
-    }
-  }
   /*
    * Mandatory - ESM message container
    */
-  size += ESM_MESSAGE_CONTAINER_MINIMUM_LENGTH + blength(msg->nas_msg);
   emm_msg->esmmessagecontainer = bstrcpy(msg->nas_msg);
-  OAILOG_DEBUG(
-      LOG_NAS_EMM,
-      "EMMAS-SAP - size += "
-      "ESM_MESSAGE_CONTAINER_MINIMUM_LENGTH(%d)  (%d) for (ue_id = %u)\n",
-      ESM_MESSAGE_CONTAINER_MINIMUM_LENGTH, size, ue_id);
 
   /*
    * Optional - GUTI
    */
   if (msg->new_guti) {
-    size += EPS_MOBILE_IDENTITY_MAXIMUM_LENGTH;
     emm_msg->presencemask |= ATTACH_ACCEPT_GUTI_PRESENT;
     emm_msg->guti.guti.typeofidentity = EPS_MOBILE_IDENTITY_GUTI;
     emm_msg->guti.guti.oddeven        = EPS_MOBILE_IDENTITY_EVEN;
@@ -383,11 +336,6 @@ status_code_e emm_send_attach_accept(
     emm_msg->guti.guti.mnc_digit1     = msg->new_guti->gummei.plmn.mnc_digit1;
     emm_msg->guti.guti.mnc_digit2     = msg->new_guti->gummei.plmn.mnc_digit2;
     emm_msg->guti.guti.mnc_digit3     = msg->new_guti->gummei.plmn.mnc_digit3;
-    OAILOG_DEBUG(
-        LOG_NAS_EMM,
-        "EMMAS-SAP - size += "
-        "EPS_MOBILE_IDENTITY_MAXIMUM_LENGTH(%d)  (%d) for (ue_id = %u)\n",
-        EPS_MOBILE_IDENTITY_MAXIMUM_LENGTH, size, ue_id);
   }
 
   OAILOG_DEBUG(
@@ -396,7 +344,6 @@ status_code_e emm_send_attach_accept(
    * Optional - LAI
    */
   if (msg->location_area_identification) {
-    size += LOCATION_AREA_IDENTIFICATION_IE_MAX_LENGTH;
     emm_msg->presencemask |= ATTACH_ACCEPT_LOCATION_AREA_IDENTIFICATION_PRESENT;
     emm_msg->locationareaidentification.mccdigit2 =
         msg->location_area_identification->mccdigit2;
@@ -419,7 +366,6 @@ status_code_e emm_send_attach_accept(
    * Optional - Mobile Identity
    */
   if (msg->ms_identity) {
-    size += MOBILE_IDENTITY_MAXIMUM_LENGTH;
     emm_msg->presencemask |= ATTACH_ACCEPT_MS_IDENTITY_PRESENT;
     if (msg->ms_identity->imsi.typeofidentity == MOBILE_IDENTITY_IMSI) {
       memcpy(
@@ -454,7 +400,6 @@ status_code_e emm_send_attach_accept(
    * Optional - Additional Update Result
    */
   if (msg->additional_update_result) {
-    size += ADDITIONAL_UPDATE_RESULT_MAXIMUM_LENGTH;
     emm_msg->presencemask |= ATTACH_ACCEPT_ADDITIONAL_UPDATE_RESULT_PRESENT;
     emm_msg->additionalupdateresult = *msg->additional_update_result;
   }
@@ -468,7 +413,6 @@ status_code_e emm_send_attach_accept(
 
   if ((emm_ctx->csfbparams.sgs_loc_updt_status == FAILURE) ||
       (is_mme_ue_context_network_access_mode_packet_only(ue_mm_context_p))) {
-    size += EMM_CAUSE_MAXIMUM_LENGTH;
     emm_msg->presencemask |= ATTACH_ACCEPT_EMM_CAUSE_PRESENT;
     emm_msg->emmcause = emm_ctx->emm_cause;
   }
@@ -480,7 +424,6 @@ status_code_e emm_send_attach_accept(
    * Optional - T3402
    */
   if (msg->t3402) {
-    size += GPRS_TIMER_IE_MAX_LENGTH;
     emm_msg->presencemask |= ATTACH_ACCEPT_T3402_VALUE_PRESENT;
     if (mme_config.nas_config.t3402_min <= 31) {
       emm_msg->t3402value.unit       = GPRS_TIMER_UNIT_60S;
@@ -495,7 +438,6 @@ status_code_e emm_send_attach_accept(
    * Optional - Network feature support
    */
   if (msg->eps_network_feature_support) {
-    size += EPS_NETWORK_FEATURE_SUPPORT_MAXIMUM_LENGTH;
     emm_msg->presencemask |= ATTACH_ACCEPT_EPS_NETWORK_FEATURE_SUPPORT_PRESENT;
     emm_msg->epsnetworkfeaturesupport = *msg->eps_network_feature_support;
   }
@@ -522,7 +464,11 @@ status_code_e emm_send_attach_accept(
 status_code_e emm_send_attach_accept_dl_nas(
     const emm_as_data_t* msg, attach_accept_msg* emm_msg) {
   OAILOG_FUNC_IN(LOG_NAS_EMM);
-  int size = EMM_HEADER_MAXIMUM_LENGTH;
+  // Single pass: worst case of every fixed IE folded at compile time plus
+  // the actual ESM container, instead of accumulating per-IE maxima while
+  // filling in the message below
+  int size = EMM_HEADER_MAXIMUM_LENGTH + ATTACH_ACCEPT_NON_ESM_MAXIMUM_LENGTH +
+             ESM_MESSAGE_CONTAINER_MINIMUM_LENGTH + blength(msg->nas_msg);
 
   // Get the UE context
   emm_context_t* emm_ctx = emm_context_get(&_emm_data, msg->ue_id);
@@ -533,8 +479,6 @@ status_code_e emm_send_attach_accept_dl_nas(
   DevAssert(msg->ue_id == ue_id);
 
   OAILOG_DEBUG(LOG_NAS_EMM, "EMMAS-SAP - Send Attach Accept message\n");
-  OAILOG_DEBUG(
-      LOG_NAS_EMM, "EMMAS-SAP - size = EMM_HEADER_MAXIMUM_LENGTH(%d)\n", size);
   /*
    * Mandatory - Message type
    */
@@ -542,11 +486,6 @@ status_code_e emm_send_attach_accept_dl_nas(
   /*
    * Mandatory - EPS attach result
    */
-  size += EPS_ATTACH_RESULT_MAXIMUM_LENGTH;
-  OAILOG_INFO(
-      LOG_NAS_EMM,
-      "EMMAS-SAP - size += EPS_ATTACH_RESULT_MAXIMUM_LENGTH(%d)  (%d)\n",
-      EPS_ATTACH_RESULT_MAXIMUM_LENGTH, size);
   switch (emm_ctx->attach_type) {
     case EMM_ATTACH_TYPE_COMBINED_EPS_IMSI:
       OAILOG_DEBUG(LOG_NAS_EMM, "EMMAS-SAP - Combined EPS/IMSI attach\n");
@@ -601,7 +540,6 @@ status_code_e emm_send_attach_accept_dl_nas(
   /*
    * Mandatory - T3412 value
    */
-  size += GPRS_TIMER_IE_MAX_LENGTH;
   // Check whether Periodic TAU timer is disabled
   if (mme_config.nas_config.t3412_min == 0) {
     emm_msg->t3412value.unit       = GPRS_TIMER_UNIT_0S;
@@ -614,59 +552,21 @@ status_code_e emm_send_attach_accept_dl_nas(
     emm_msg->t3412value.timervalue = mme_config.nas_config.t3412_min / 6;
   }
   // emm_msg->t3412value.unit = GPRS_TIMER_UNIT_0S;
-  OAILOG_INFO(
-      LOG_NAS_EMM, "EMMAS-SAP - size += GPRS_TIMER_MAXIMUM_LENGTH(%d)  (%d)\n",
-      GPRS_TIMER_IE_MAX_LENGTH, size);
   /*
    * Mandatory - Tracking area identity list
    */
-  size +=
-      TRACKING_AREA_IDENTITY_LIST_MINIMUM_LENGTH * msg->tai_list.numberoflists;
   memcpy(&emm_msg->tailist, &msg->tai_list, sizeof(msg->tai_list));
-  OAILOG_INFO(
-      LOG_NAS_EMM,
-      "EMMAS-SAP - size += "
-      "TRACKING_AREA_IDENTITY_LIST_LENGTH(%d*%d)  (%d)\n",
-      TRACKING_AREA_IDENTITY_LIST_MINIMUM_LENGTH,
-      emm_msg->tailist.numberoflists, size);
   AssertFatal(
       emm_msg->tailist.numberoflists <= 16, "Too many TAIs in TAI list");
-  for (int p = 0; p < emm_msg->tailist.numberoflists; p++) {
-    if (TRACKING_AREA_IDENTITY_LIST_ONE_PLMN_NON_CONSECUTIVE_TACS ==
-        emm_msg->tailist.partial_tai_list[p].typeoflist) {
-      size = size + (2 * emm_msg->tailist.partial_tai_list[p].numberofelements);
-      OAILOG_INFO(
-          LOG_NAS_EMM,
-          "EMMAS-SAP - size += "
-          "TRACKING AREA CODE LENGTH(%d*%d)  (%d)\n",
-          2, emm_msg->tailist.partial_tai_list[p].numberofelements, size);
-    } else if (
-        TRACKING_AREA_IDENTITY_LIST_MANY_PLMNS ==
-        emm_msg->tailist.partial_tai_list[p].typeoflist) {
-      size = size + (5 * emm_msg->tailist.partial_tai_list[p].numberofelements);
-      OAILOG_INFO(
-          LOG_NAS_EMM,
-          "EMMAS-SAP - size += "
-          "TRACKING AREA CODE LENGTH(%d*%d)  (%d)\n",
-          5, emm_msg->tailist.partial_tai_list[p].numberofelements, size);
-    }
-  }
   /*
    * Mandatory - ESM message container
    */
-  size += ESM_MESSAGE_CONTAINER_MINIMUM_LENGTH + blength(msg->nas_msg);
   emm_msg->esmmessagecontainer = bstrcpy(msg->nas_msg);
-  OAILOG_INFO(
-      LOG_NAS_EMM,
-      "EMMAS-SAP - size += "
-      "ESM_MESSAGE_CONTAINER_MINIMUM_LENGTH(%d)  (%d)\n",
-      ESM_MESSAGE_CONTAINER_MINIMUM_LENGTH, size);
 
   /*
    * Optional - GUTI
    */
   if (msg->new_guti) {
-    size += EPS_MOBILE_IDENTITY_MAXIMUM_LENGTH;
     emm_msg->presencemask |= ATTACH_ACCEPT_GUTI_PRESENT;
     emm_msg->guti.guti.typeofidentity = EPS_MOBILE_IDENTITY_GUTI;
     emm_msg->guti.guti.oddeven        = EPS_MOBILE_IDENTITY_EVEN;
@@ -679,18 +579,12 @@ status_code_e emm_send_attach_accept_dl_nas(
     emm_msg->guti.guti.mnc_digit1     = msg->new_guti->gummei.plmn.mnc_digit1;
     emm_msg->guti.guti.mnc_digit2     = msg->new_guti->gummei.plmn.mnc_digit2;
     emm_msg->guti.guti.mnc_digit3     = msg->new_guti->gummei.plmn.mnc_digit3;
-    OAILOG_INFO(
-        LOG_NAS_EMM,
-        "EMMAS-SAP - size += "
-        "EPS_MOBILE_IDENTITY_MAXIMUM_LENGTH(%d)  (%d)\n",
-        EPS_MOBILE_IDENTITY_MAXIMUM_LENGTH, size);
   }
 
   /*
    * Optional - LAI
    */
   if (msg->location_area_identification) {
-    size += LOCATION_AREA_IDENTIFICATION_IE_MAX_LENGTH;
     emm_msg->presencemask |= ATTACH_ACCEPT_LOCATION_AREA_IDENTIFICATION_PRESENT;
     emm_msg->locationareaidentification.mccdigit2 =
         msg->location_area_identification->mccdigit2;
@@ -712,7 +606,6 @@ status_code_e emm_send_attach_accept_dl_nas(
    * Optional - Mobile Identity
    */
   if (msg->ms_identity) {
-    size += MOBILE_IDENTITY_MAXIMUM_LENGTH;
     emm_msg->presencemask |= ATTACH_ACCEPT_MS_IDENTITY_PRESENT;
     if (msg->ms_identity->imsi.typeofidentity == MOBILE_IDENTITY_IMSI) {
       memcpy(
@@ -729,7 +622,6 @@ status_code_e emm_send_attach_accept_dl_nas(
    * Optional - Additional Update Result
    */
   if (msg->additional_update_result) {
-    size += ADDITIONAL_UPDATE_RESULT_MAXIMUM_LENGTH;
     emm_msg->presencemask |= ATTACH_ACCEPT_ADDITIONAL_UPDATE_RESULT_PRESENT;
     emm_msg->additionalupdateresult = SMS_ONLY;
   }
@@ -740,7 +632,6 @@ status_code_e emm_send_attach_accept_dl_nas(
   if (((emm_ctx->csfbparams.sgs_loc_updt_status == FAILURE) ||
        is_mme_ue_context_network_access_mode_packet_only(ue_mm_context_p)) &&
       (msg->emm_cause)) {
-    size += EMM_CAUSE_MAXIMUM_LENGTH;
     emm_msg->presencemask |= ATTACH_ACCEPT_EMM_CAUSE_PRESENT;
     emm_msg->emmcause = *msg->emm_cause;
   }
@@ -748,7 +639,6 @@ status_code_e emm_send_attach_accept_dl_nas(
    * Optional - Network feature support
    */
   if (msg->eps_network_feature_support) {
-    size += EPS_NETWORK_FEATURE_SUPPORT_MAXIMUM_LENGTH;
     emm_msg->presencemask |= ATTACH_ACCEPT_EPS_NETWORK_FEATURE_SUPPORT_PRESENT;
     emm_msg->epsnetworkfeaturesupport = *msg->eps_network_feature_support;
   }
@@ -64,6 +64,89 @@ static nas_emm_proc_t* nas_emm_find_procedure_by_puid(
 
 static uint64_t nas_puid = 1;
 
+////////////////////////////////////////////////////////////////////////////////
+// Procedure object pooling
+////////////////////////////////////////////////////////////////////////////////
+/* EMM procedure objects and their list wrappers are allocated per transaction
+ * and freed at completion, which puts several malloc/free pairs on every
+ * attach and authentication sequence. Recycle them through type segregated
+ * freelists instead: release pushes the block onto the matching freelist up
+ * to a bounded depth, acquire pops and re-zeroes it. All call sites run on
+ * the mme_app task thread, so the freelists are not locked.
+ *
+ * Procedures restored by the NAS state converter are plain calloc'ed blocks
+ * of the same types; they enter the freelists through the same delete paths,
+ * which is safe because each pool only ever recycles one object type.
+ */
+typedef struct nas_proc_pool_s {
+  void* head;      // free blocks, linked through their first word
+  uint32_t depth;  // current number of free blocks
+  const size_t obj_size;
+} nas_proc_pool_t;
+
+#define NAS_PROC_POOL_MAX_DEPTH 32
+
+static nas_proc_pool_t emm_procedures_pool = {NULL, 0,
+                                              sizeof(emm_procedures_t)};
+static nas_proc_pool_t attach_proc_pool = {NULL, 0,
+                                           sizeof(nas_emm_attach_proc_t)};
+static nas_proc_pool_t tau_proc_pool   = {NULL, 0, sizeof(nas_emm_tau_proc_t)};
+static nas_proc_pool_t auth_proc_pool  = {NULL, 0,
+                                          sizeof(nas_emm_auth_proc_t)};
+static nas_proc_pool_t smc_proc_pool   = {NULL, 0, sizeof(nas_emm_smc_proc_t)};
+static nas_proc_pool_t ident_proc_pool = {NULL, 0,
+                                          sizeof(nas_emm_ident_proc_t)};
+static nas_proc_pool_t auth_info_proc_pool = {NULL, 0,
+                                              sizeof(nas_auth_info_proc_t)};
+static nas_proc_pool_t common_wrapper_pool = {
+    NULL, 0, sizeof(nas_emm_common_procedure_t)};
+static nas_proc_pool_t cn_wrapper_pool = {NULL, 0, sizeof(nas_cn_procedure_t)};
+
+//------------------------------------------------------------------------------
+static void* nas_proc_pool_acquire(nas_proc_pool_t* const pool) {
+  if (pool->head) {
+    void* block = pool->head;
+    pool->head  = *(void**) block;
+    pool->depth--;
+    memset(block, 0, pool->obj_size);
+    return block;
+  }
+  return calloc(1, pool->obj_size);
+}
+
+//------------------------------------------------------------------------------
+static void nas_proc_pool_release(nas_proc_pool_t* const pool, void** obj) {
+  if (*obj) {
+    if (pool->depth < NAS_PROC_POOL_MAX_DEPTH) {
+      *(void**) *obj = pool->head;
+      pool->head     = *obj;
+      pool->depth++;
+      *obj = NULL;
+    } else {
+      free_wrapper(obj);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Common procedures are released through paths that only know the base type;
+// route the block to the freelist matching its concrete type
+static void nas_release_common_proc_block(nas_emm_common_proc_t** proc) {
+  switch ((*proc)->type) {
+    case EMM_COMM_PROC_AUTH:
+      nas_proc_pool_release(&auth_proc_pool, (void**) proc);
+      break;
+    case EMM_COMM_PROC_SMC:
+      nas_proc_pool_release(&smc_proc_pool, (void**) proc);
+      break;
+    case EMM_COMM_PROC_IDENT:
+      nas_proc_pool_release(&ident_proc_pool, (void**) proc);
+      break;
+    default:
+      free_wrapper((void**) proc);
+  }
+}
+
 //------------------------------------------------------------------------------
 static nas_emm_common_proc_t* get_nas_common_procedure(
     const struct emm_context_s* const ctxt, emm_common_proc_type_t proc_type) {
@@ -280,7 +363,8 @@ static void nas_emm_procedure_gc(struct emm_context_s* const emm_context) {
       LIST_EMPTY(&emm_context->emm_procedures->cn_procs) &&
       (!emm_context->emm_procedures->emm_con_mngt_proc) &&
       (!emm_context->emm_procedures->emm_specific_proc)) {
-    free_wrapper((void**) &emm_context->emm_procedures);
+    nas_proc_pool_release(
+        &emm_procedures_pool, (void**) &emm_context->emm_procedures);
   }
 }
 //-----------------------------------------------------------------------------
@@ -355,8 +439,8 @@ void nas_delete_common_procedure(
         p2 = LIST_NEXT(p1, entries);
         if (p1->proc == (nas_emm_common_proc_t*) (*proc)) {
           LIST_REMOVE(p1, entries);
-          free_wrapper((void**) &p1->proc);
-          free_wrapper((void**) &p1);
+          nas_release_common_proc_block(&p1->proc);
+          nas_proc_pool_release(&common_wrapper_pool, (void**) &p1);
           return;
         }
         p1 = p2;
@@ -365,7 +449,7 @@ void nas_delete_common_procedure(
     }
     // if not found in list, free it anyway
     if (*proc) {
-      free_wrapper((void**) proc);
+      nas_release_common_proc_block(proc);
     }
   }
 }
@@ -405,8 +489,8 @@ static void nas_delete_common_procedures(struct emm_context_s* emm_context) {
         default:;
       }
 
-      free_wrapper((void**) &p1->proc);
-      free_wrapper((void**) &p1);
+      nas_release_common_proc_block(&p1->proc);
+      nas_proc_pool_release(&common_wrapper_pool, (void**) &p1);
 
       p1 = p2;
     }
@@ -434,7 +518,9 @@ void nas_delete_attach_procedure(struct emm_context_s* emm_context) {
 
     nas_delete_child_procedures(emm_context, (nas_base_proc_t*) proc);
 
-    free_wrapper((void**) &emm_context->emm_procedures->emm_specific_proc);
+    nas_proc_pool_release(
+        &attach_proc_pool,
+        (void**) &emm_context->emm_procedures->emm_specific_proc);
     nas_emm_procedure_gc(emm_context);
   }
 }
@@ -457,7 +543,9 @@ void nas_delete_tau_procedure(struct emm_context_s* emm_context) {
 
     nas_delete_child_procedures(emm_context, (nas_base_proc_t*) proc);
 
-    free_wrapper((void**) &emm_context->emm_procedures->emm_specific_proc);
+    nas_proc_pool_release(
+        &tau_proc_pool,
+        (void**) &emm_context->emm_procedures->emm_specific_proc);
     nas_emm_procedure_gc(emm_context);
   }
 }
@@ -505,7 +593,7 @@ static void nas_delete_auth_info_procedure(
     if ((*auth_info_proc)->cn_proc.base_proc.parent) {
       (*auth_info_proc)->cn_proc.base_proc.parent->child = NULL;
     }
-    free_wrapper((void**) auth_info_proc);
+    nas_proc_pool_release(&auth_info_proc_pool, (void**) auth_info_proc);
   }
 }
 
@@ -531,7 +619,7 @@ void nas_delete_cn_procedure(
           default:;
         }
         LIST_REMOVE(p1, entries);
-        free_wrapper((void**) &p1);
+        nas_proc_pool_release(&cn_wrapper_pool, (void**) &p1);
         return;
       }
       p1 = p2;
@@ -557,7 +645,7 @@ static void nas_delete_cn_procedures(struct emm_context_s* emm_context) {
           free_wrapper((void**) &p1->proc);
       }
       LIST_REMOVE(p1, entries);
-      free_wrapper((void**) &p1);
+      nas_proc_pool_release(&cn_wrapper_pool, (void**) &p1);
       p1 = p2;
     }
     nas_emm_procedure_gc(emm_context);
@@ -576,7 +664,8 @@ void nas_delete_all_emm_procedures(struct emm_context_s* const emm_context) {
     nas_delete_tau_procedure(emm_context);
     // gc
     if (emm_context->emm_procedures) {
-      free_wrapper((void**) &emm_context->emm_procedures);
+      nas_proc_pool_release(
+          &emm_procedures_pool, (void**) &emm_context->emm_procedures);
     }
   }
   OAILOG_FUNC_OUT(LOG_NAS_EMM);
@@ -586,7 +675,7 @@ void nas_delete_all_emm_procedures(struct emm_context_s* const emm_context) {
 static emm_procedures_t* nas_new_emm_procedures(
     struct emm_context_s* const emm_context) {
   emm_procedures_t* emm_procedures =
-      calloc(1, sizeof(*emm_context->emm_procedures));
+      nas_proc_pool_acquire(&emm_procedures_pool);
   LIST_INIT(&emm_procedures->emm_common_procs);
   return emm_procedures;
 }
@@ -606,10 +695,8 @@ nas_emm_attach_proc_t* nas_new_attach_procedure(
             ->mme_ue_s1ap_id);
     return NULL;
   }
-  emm_context->emm_procedures->emm_specific_proc = calloc(
-      1,
-      sizeof(
-          nas_emm_attach_proc_t));  // NOLINT(clang-analyzer-unix.MallocSizeof)
+  emm_context->emm_procedures->emm_specific_proc =
+      nas_proc_pool_acquire(&attach_proc_pool);
   emm_context->emm_procedures->emm_specific_proc->emm_proc.base_proc.nas_puid =
       __sync_fetch_and_add(&nas_puid, 1);
   emm_context->emm_procedures->emm_specific_proc->emm_proc.base_proc.type =
@@ -644,9 +731,8 @@ nas_emm_tau_proc_t* nas_new_tau_procedure(
             ->mme_ue_s1ap_id);
     return NULL;
   }
-  emm_context->emm_procedures->emm_specific_proc = calloc(
-      1,
-      sizeof(nas_emm_tau_proc_t));  // NOLINT(clang-analyzer-unix.MallocSizeof)
+  emm_context->emm_procedures->emm_specific_proc =
+      nas_proc_pool_acquire(&tau_proc_pool);
   emm_context->emm_procedures->emm_specific_proc->emm_proc.base_proc.nas_puid =
       __sync_fetch_and_add(&nas_puid, 1);
   emm_context->emm_procedures->emm_specific_proc->emm_proc.base_proc.type =
@@ -703,7 +789,7 @@ nas_emm_ident_proc_t* nas_new_identification_procedure(
     emm_context->emm_procedures = nas_new_emm_procedures(emm_context);
   }
 
-  nas_emm_ident_proc_t* ident_proc = calloc(1, sizeof(nas_emm_ident_proc_t));
+  nas_emm_ident_proc_t* ident_proc = nas_proc_pool_acquire(&ident_proc_pool);
 
   ident_proc->emm_com_proc.emm_proc.base_proc.nas_puid =
       __sync_fetch_and_add(&nas_puid, 1);
@@ -714,7 +800,8 @@ nas_emm_ident_proc_t* nas_new_identification_procedure(
   ident_proc->T3470.sec = mme_config.nas_config.t3470_sec;
   ident_proc->T3470.id  = NAS_TIMER_INACTIVE_ID;
 
-  nas_emm_common_procedure_t* wrapper = calloc(1, sizeof(*wrapper));
+  nas_emm_common_procedure_t* wrapper =
+      nas_proc_pool_acquire(&common_wrapper_pool);
   if (wrapper) {
     wrapper->proc = &ident_proc->emm_com_proc;
     LIST_INSERT_HEAD(
@@ -722,7 +809,7 @@ nas_emm_ident_proc_t* nas_new_identification_procedure(
     OAILOG_TRACE(LOG_NAS_EMM, "New EMM_COMM_PROC_IDENT\n");
     return ident_proc;
   } else {
-    free_wrapper((void**) &ident_proc);
+    nas_proc_pool_release(&ident_proc_pool, (void**) &ident_proc);
   }
   return ident_proc;
 }
@@ -734,7 +821,7 @@ nas_emm_auth_proc_t* nas_new_authentication_procedure(
     emm_context->emm_procedures = nas_new_emm_procedures(emm_context);
   }
 
-  nas_emm_auth_proc_t* auth_proc = calloc(1, sizeof(nas_emm_auth_proc_t));
+  nas_emm_auth_proc_t* auth_proc = nas_proc_pool_acquire(&auth_proc_pool);
 
   auth_proc->emm_com_proc.emm_proc.base_proc.nas_puid =
       __sync_fetch_and_add(&nas_puid, 1);
@@ -745,7 +832,8 @@ nas_emm_auth_proc_t* nas_new_authentication_procedure(
   auth_proc->T3460.sec = mme_config.nas_config.t3460_sec;
   auth_proc->T3460.id  = NAS_TIMER_INACTIVE_ID;
 
-  nas_emm_common_procedure_t* wrapper = calloc(1, sizeof(*wrapper));
+  nas_emm_common_procedure_t* wrapper =
+      nas_proc_pool_acquire(&common_wrapper_pool);
   if (wrapper) {
     wrapper->proc = &auth_proc->emm_com_proc;
     LIST_INSERT_HEAD(
@@ -753,7 +841,7 @@ nas_emm_auth_proc_t* nas_new_authentication_procedure(
     OAILOG_TRACE(LOG_NAS_EMM, "New EMM_COMM_PROC_AUTH\n");
     return auth_proc;
   } else {
-    free_wrapper((void**) &auth_proc);
+    nas_proc_pool_release(&auth_proc_pool, (void**) &auth_proc);
   }
   return NULL;
 }
@@ -765,7 +853,7 @@ nas_emm_smc_proc_t* nas_new_smc_procedure(
     emm_context->emm_procedures = nas_new_emm_procedures(emm_context);
   }
 
-  nas_emm_smc_proc_t* smc_proc = calloc(1, sizeof(nas_emm_smc_proc_t));
+  nas_emm_smc_proc_t* smc_proc = nas_proc_pool_acquire(&smc_proc_pool);
 
   smc_proc->emm_com_proc.emm_proc.base_proc.nas_puid =
       __sync_fetch_and_add(&nas_puid, 1);
@@ -776,7 +864,8 @@ nas_emm_smc_proc_t* nas_new_smc_procedure(
   smc_proc->T3460.sec = mme_config.nas_config.t3460_sec;
   smc_proc->T3460.id  = NAS_TIMER_INACTIVE_ID;
 
-  nas_emm_common_procedure_t* wrapper = calloc(1, sizeof(*wrapper));
+  nas_emm_common_procedure_t* wrapper =
+      nas_proc_pool_acquire(&common_wrapper_pool);
   if (wrapper) {
     wrapper->proc = &smc_proc->emm_com_proc;
     LIST_INSERT_HEAD(
@@ -784,7 +873,7 @@ nas_emm_smc_proc_t* nas_new_smc_procedure(
     OAILOG_TRACE(LOG_NAS_EMM, "New EMM_COMM_PROC_SMC\n");
     return smc_proc;
   } else {
-    free_wrapper((void**) &smc_proc);
+    nas_proc_pool_release(&smc_proc_pool, (void**) &smc_proc);
   }
   return NULL;
 }
@@ -797,7 +886,7 @@ nas_auth_info_proc_t* nas_new_cn_auth_info_procedure(
   }
 
   nas_auth_info_proc_t* auth_info_proc =
-      calloc(1, sizeof(nas_auth_info_proc_t));
+      nas_proc_pool_acquire(&auth_info_proc_pool);
   auth_info_proc->cn_proc.base_proc.nas_puid =
       __sync_fetch_and_add(&nas_puid, 1);
   auth_info_proc->cn_proc.base_proc.type = NAS_PROC_TYPE_CN;
@@ -805,14 +894,14 @@ nas_auth_info_proc_t* nas_new_cn_auth_info_procedure(
   auth_info_proc->timer_s6a.sec          = S6A_AIR_RESPONSE_TIMER;
   auth_info_proc->timer_s6a.id           = NAS_TIMER_INACTIVE_ID;
 
-  nas_cn_procedure_t* wrapper = calloc(1, sizeof(*wrapper));
+  nas_cn_procedure_t* wrapper = nas_proc_pool_acquire(&cn_wrapper_pool);
   if (wrapper) {
     wrapper->proc = &auth_info_proc->cn_proc;
     LIST_INSERT_HEAD(&emm_context->emm_procedures->cn_procs, wrapper, entries);
     OAILOG_TRACE(LOG_NAS_EMM, "New CN_PROC_AUTH_INFO\n");
     return auth_info_proc;
   } else {
-    free_wrapper((void**) &auth_info_proc);
+    nas_proc_pool_release(&auth_info_proc_pool, (void**) &auth_info_proc);
   }
   return NULL;
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include <arpa/inet.h>
+#include <cstdio>
 #include "common_defs.h"
 #include "magma_logging.h"
 #include "glogwrapper/glog_logging.h"
@@ -66,13 +67,24 @@
 #define IES_DECODE_U32(bUFFER, dECODED, vALUE)                                 \
   DECODE_U32(bUFFER + dECODED, vALUE, dECODED)
 
+/* The whole dump is assembled on the stack and emitted as one MLOG
+ * statement: every MLOG formats to the log stream unconditionally, so
+ * logging byte per byte dominates the cost of decoding a PDU burst.
+ */
+#define BUFFER_PRINT_LOG_MAX_BYTES (64)
 #define BUFFER_PRINT_LOG(bUFFER, lEN)                                          \
   {                                                                            \
-    int iLEN = 0;                                                              \
-    if (bUFFER != NULL) {                                                      \
-      while (iLEN < ((int) lEN)) {                                             \
-        MLOG(MDEBUG) << " 0x" << std::hex << int(*(bUFFER + iLEN));            \
-        iLEN++;                                                                \
+    if ((bUFFER) != NULL) {                                                    \
+      int pRINTlEN = (int) (lEN);                                              \
+      char hEXdUMP[3 * BUFFER_PRINT_LOG_MAX_BYTES + 1] = {0};                  \
+      if (pRINTlEN > BUFFER_PRINT_LOG_MAX_BYTES) {                             \
+        pRINTlEN = BUFFER_PRINT_LOG_MAX_BYTES;                                 \
       }                                                                        \
+      for (int iLEN = 0; iLEN < pRINTlEN; iLEN++) {                            \
+        snprintf(                                                              \
+            hEXdUMP + 3 * iLEN, 4, " %02x",                                    \
+            (unsigned) (0xff & *((bUFFER) + iLEN)));                           \
+      }                                                                        \
+      MLOG(MDEBUG) << " 0x" << hEXdUMP;                                        \
     }                                                                          \
   }
@@ -9,6 +9,8 @@
    limitations under the License.
  */
 
+#include <array>
+#include <cstddef>
 #include <iostream>
 #include <sstream>
 #include "AmfMessage.h"
@@ -20,6 +22,185 @@ namespace magma5g {
 AmfMsg::AmfMsg(){};
 AmfMsg::~AmfMsg(){};
 
+namespace {
+// Message-type-indexed codec dispatch. The mobility management message
+// types are a dense range (0x41..0x68), so both codecs index straight
+// into this table instead of walking a switch per PDU; a null slot is a
+// type the direction does not support.
+typedef int (*AmfMsgCodecFn)(AmfMsg* msg, uint8_t* buffer, uint32_t len);
+
+struct AmfMsgDispatchEntry {
+  AmfMsgCodecFn decode;
+  AmfMsgCodecFn encode;
+};
+
+constexpr uint8_t AMF_MSG_DISPATCH_BASE = REG_REQUEST;
+constexpr size_t AMF_MSG_DISPATCH_SLOTS =
+    DLNASTRANSPORT - REG_REQUEST + 1;
+
+const std::array<AmfMsgDispatchEntry, AMF_MSG_DISPATCH_SLOTS>
+    amf_msg_dispatch = [] {
+      std::array<AmfMsgDispatchEntry, AMF_MSG_DISPATCH_SLOTS> table = {};
+      auto slot = [&table](uint8_t type) -> AmfMsgDispatchEntry& {
+        return table[type - AMF_MSG_DISPATCH_BASE];
+      };
+      slot(REG_REQUEST) = {
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.reg_request.DecodeRegistrationRequestMsg(
+                &m->msg.reg_request, b, l);
+          },
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.reg_request.EncodeRegistrationRequestMsg(
+                &m->msg.reg_request, b, l);
+          }};
+      slot(REG_ACCEPT) = {
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.reg_accept.DecodeRegistrationAcceptMsg(
+                &m->msg.reg_accept, b, l);
+          },
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.reg_accept.EncodeRegistrationAcceptMsg(
+                &m->msg.reg_accept, b, l);
+          }};
+      slot(REG_COMPLETE) = {
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.reg_complete.DecodeRegistrationCompleteMsg(
+                &m->msg.reg_complete, b, l);
+          },
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.reg_complete.EncodeRegistrationCompleteMsg(
+                &m->msg.reg_complete, b, l);
+          }};
+      slot(REG_REJECT) = {
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.reg_reject.DecodeRegistrationRejectMsg(
+                &m->msg.reg_reject, b, l);
+          },
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.reg_reject.EncodeRegistrationRejectMsg(
+                &m->msg.reg_reject, b, l);
+          }};
+      slot(M5G_IDENTITY_REQUEST) = {
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.identity_request.DecodeIdentityRequestMsg(
+                &m->msg.identity_request, b, l);
+          },
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.identity_request.EncodeIdentityRequestMsg(
+                &m->msg.identity_request, b, l);
+          }};
+      slot(M5G_IDENTITY_RESPONSE) = {
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.identity_response.DecodeIdentityResponseMsg(
+                &m->msg.identity_response, b, l);
+          },
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.identity_response.EncodeIdentityResponseMsg(
+                &m->msg.identity_response, b, l);
+          }};
+      slot(AUTH_REQUEST) = {
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.auth_request.DecodeAuthenticationRequestMsg(
+                &m->msg.auth_request, b, l);
+          },
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.auth_request.EncodeAuthenticationRequestMsg(
+                &m->msg.auth_request, b, l);
+          }};
+      slot(AUTH_RESPONSE) = {
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.auth_response.DecodeAuthenticationResponseMsg(
+                &m->msg.auth_response, b, l);
+          },
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.auth_response.EncodeAuthenticationResponseMsg(
+                &m->msg.auth_response, b, l);
+          }};
+      slot(AUTH_REJECT) = {
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.auth_reject.DecodeAuthenticationRejectMsg(
+                &m->msg.auth_reject, b, l);
+          },
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.auth_reject.EncodeAuthenticationRejectMsg(
+                &m->msg.auth_reject, b, l);
+          }};
+      slot(AUTH_FAILURE) = {
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.auth_failure.DecodeAuthenticationFailureMsg(
+                &m->msg.auth_failure, b, l);
+          },
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.auth_failure.EncodeAuthenticationFailureMsg(
+                &m->msg.auth_failure, b, l);
+          }};
+      slot(SEC_MODE_COMMAND) = {
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.sec_mode_command.DecodeSecurityModeCommandMsg(
+                &m->msg.sec_mode_command, b, l);
+          },
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.sec_mode_command.EncodeSecurityModeCommandMsg(
+                &m->msg.sec_mode_command, b, l);
+          }};
+      slot(SEC_MODE_COMPLETE) = {
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.sec_mode_complete.DecodeSecurityModeCompleteMsg(
+                &m->msg.sec_mode_complete, b, l);
+          },
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.sec_mode_complete.EncodeSecurityModeCompleteMsg(
+                &m->msg.sec_mode_complete, b, l);
+          }};
+      slot(SEC_MODE_REJECT) = {
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.sec_mode_reject.DecodeSecurityModeRejectMsg(
+                &m->msg.sec_mode_reject, b, l);
+          },
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.sec_mode_reject.EncodeSecurityModeRejectMsg(
+                &m->msg.sec_mode_reject, b, l);
+          }};
+      slot(DE_REG_REQUEST_UE_ORIGIN) = {
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.de_reg_request.DecodeDeRegistrationRequestUEInitMsg(
+                &m->msg.de_reg_request, b, l);
+          },
+          nullptr};
+      slot(DE_REG_ACCEPT_UE_ORIGIN) = {
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.de_reg_accept.DecodeDeRegistrationAcceptUEInitMsg(
+                &m->msg.de_reg_accept, b, l);
+          },
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.de_reg_accept.EncodeDeRegistrationAcceptUEInitMsg(
+                &m->msg.de_reg_accept, b, l);
+          }};
+      slot(ULNASTRANSPORT) = {
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.ul_nas_transport.DecodeULNASTransportMsg(
+                &m->msg.ul_nas_transport, b, l);
+          },
+          nullptr};
+      slot(DLNASTRANSPORT) = {
+          nullptr,
+          [](AmfMsg* m, uint8_t* b, uint32_t l) {
+            return m->msg.dl_nas_transport.EncodeDLNASTransportMsg(
+                &m->msg.dl_nas_transport, b, l);
+          }};
+      return table;
+    }();
+
+// Table slot for a message type, or nullptr for types outside the range
+const AmfMsgDispatchEntry* amf_msg_dispatch_entry(uint8_t message_type) {
+  if (message_type < AMF_MSG_DISPATCH_BASE ||
+      message_type >= AMF_MSG_DISPATCH_BASE + AMF_MSG_DISPATCH_SLOTS) {
+    return nullptr;
+  }
+  return &amf_msg_dispatch[message_type - AMF_MSG_DISPATCH_BASE];
+}
+}  // namespace
+
 // Decode AMF NAS Header and Message
 int AmfMsg::M5gNasMessageDecodeMsg(AmfMsg* msg, uint8_t* buffer, uint32_t len) {
   int header_result = 0;
@@ -139,76 +320,12 @@ int AmfMsg::AmfMsgDecodeMsg(AmfMsg* msg, uint8_t* buffer, uint32_t len) {
     return (RETURNerror);
   }
   MLOG(MDEBUG) << "msg type = 0x" << hex << int(msg->header.message_type);
-  switch ((unsigned char) msg->header.message_type) {
-    case REG_REQUEST:
-      decode_result = msg->msg.reg_request.DecodeRegistrationRequestMsg(
-          &msg->msg.reg_request, buffer, len);
-      break;
-    case REG_ACCEPT:
-      decode_result = msg->msg.reg_accept.DecodeRegistrationAcceptMsg(
-          &msg->msg.reg_accept, buffer, len);
-      break;
-    case REG_COMPLETE:
-      decode_result = msg->msg.reg_complete.DecodeRegistrationCompleteMsg(
-          &msg->msg.reg_complete, buffer, len);
-      break;
-    case REG_REJECT:
-      decode_result = msg->msg.reg_reject.DecodeRegistrationRejectMsg(
-          &msg->msg.reg_reject, buffer, len);
-      break;
-    case M5G_IDENTITY_REQUEST:
-      decode_result = msg->msg.identity_request.DecodeIdentityRequestMsg(
-          &msg->msg.identity_request, buffer, len);
-      break;
-    case M5G_IDENTITY_RESPONSE:
-      decode_result = msg->msg.identity_response.DecodeIdentityResponseMsg(
-          &msg->msg.identity_response, buffer, len);
-      break;
-    case AUTH_REQUEST:
-      decode_result = msg->msg.auth_request.DecodeAuthenticationRequestMsg(
-          &msg->msg.auth_request, buffer, len);
-      break;
-    case AUTH_RESPONSE:
-      decode_result = msg->msg.auth_response.DecodeAuthenticationResponseMsg(
-          &msg->msg.auth_response, buffer, len);
-      break;
-    case AUTH_REJECT:
-      decode_result = msg->msg.auth_reject.DecodeAuthenticationRejectMsg(
-          &msg->msg.auth_reject, buffer, len);
-      break;
-    case AUTH_FAILURE:
-      decode_result = msg->msg.auth_failure.DecodeAuthenticationFailureMsg(
-          &msg->msg.auth_failure, buffer, len);
-      break;
-    case SEC_MODE_COMMAND:
-      decode_result = msg->msg.sec_mode_command.DecodeSecurityModeCommandMsg(
-          &msg->msg.sec_mode_command, buffer, len);
-      break;
-    case SEC_MODE_COMPLETE:
-      decode_result = msg->msg.sec_mode_complete.DecodeSecurityModeCompleteMsg(
-          &msg->msg.sec_mode_complete, buffer, len);
-      break;
-    case SEC_MODE_REJECT:
-      decode_result = msg->msg.sec_mode_reject.DecodeSecurityModeRejectMsg(
-          &msg->msg.sec_mode_reject, buffer, len);
-      break;
-    case DE_REG_REQUEST_UE_ORIGIN:
-      decode_result =
-          msg->msg.de_reg_request.DecodeDeRegistrationRequestUEInitMsg(
-              &msg->msg.de_reg_request, buffer, len);
-      break;
-    case DE_REG_ACCEPT_UE_ORIGIN:
-      decode_result =
-          msg->msg.de_reg_accept.DecodeDeRegistrationAcceptUEInitMsg(
-              &msg->msg.de_reg_accept, buffer, len);
-      break;
-    case ULNASTRANSPORT:
-      decode_result = msg->msg.ul_nas_transport.DecodeULNASTransportMsg(
-          &msg->msg.ul_nas_transport, buffer, len);
-      break;
-    default:
-      decode_result = TLV_WRONG_MESSAGE_TYPE;
+  const AmfMsgDispatchEntry* entry =
+      amf_msg_dispatch_entry(msg->header.message_type);
+  if (entry == nullptr || entry->decode == nullptr) {
+    return (TLV_WRONG_MESSAGE_TYPE);
   }
+  decode_result = entry->decode(msg, buffer, len);
   return (decode_result);
 }
 
@@ -221,71 +338,12 @@ int AmfMsg::AmfMsgEncodeMsg(AmfMsg* msg, uint8_t* buffer, uint32_t len) {
     MLOG(MERROR) << "Error : Buffer is Empty";
     return (RETURNerror);
   }
-  switch ((unsigned char) msg->header.message_type) {
-    case REG_REQUEST:
-      encode_result = msg->msg.reg_request.EncodeRegistrationRequestMsg(
-          &msg->msg.reg_request, buffer, len);
-      break;
-    case REG_ACCEPT:
-      encode_result = msg->msg.reg_accept.EncodeRegistrationAcceptMsg(
-          &msg->msg.reg_accept, buffer, len);
-      break;
-    case REG_COMPLETE:
-      encode_result = msg->msg.reg_complete.EncodeRegistrationCompleteMsg(
-          &msg->msg.reg_complete, buffer, len);
-      break;
-    case REG_REJECT:
-      encode_result = msg->msg.reg_reject.EncodeRegistrationRejectMsg(
-          &msg->msg.reg_reject, buffer, len);
-      break;
-    case M5G_IDENTITY_REQUEST:
-      encode_result = msg->msg.identity_request.EncodeIdentityRequestMsg(
-          &msg->msg.identity_request, buffer, len);
-      break;
-    case M5G_IDENTITY_RESPONSE:
-      encode_result = msg->msg.identity_response.EncodeIdentityResponseMsg(
-          &msg->msg.identity_response, buffer, len);
-      break;
-    case AUTH_REQUEST:
-      encode_result = msg->msg.auth_request.EncodeAuthenticationRequestMsg(
-          &msg->msg.auth_request, buffer, len);
-      break;
-    case AUTH_RESPONSE:
-      encode_result = msg->msg.auth_response.EncodeAuthenticationResponseMsg(
-          &msg->msg.auth_response, buffer, len);
-      break;
-    case AUTH_REJECT:
-      encode_result = msg->msg.auth_reject.EncodeAuthenticationRejectMsg(
-          &msg->msg.auth_reject, buffer, len);
-      break;
-    case AUTH_FAILURE:
-      encode_result = msg->msg.auth_failure.EncodeAuthenticationFailureMsg(
-          &msg->msg.auth_failure, buffer, len);
-      break;
-    case SEC_MODE_COMMAND:
-      encode_result = msg->msg.sec_mode_command.EncodeSecurityModeCommandMsg(
-          &msg->msg.sec_mode_command, buffer, len);
-      break;
-    case SEC_MODE_COMPLETE:
-      encode_result = msg->msg.sec_mode_complete.EncodeSecurityModeCompleteMsg(
-          &msg->msg.sec_mode_complete, buffer, len);
-      break;
-    case SEC_MODE_REJECT:
-      encode_result = msg->msg.sec_mode_reject.EncodeSecurityModeRejectMsg(
-          &msg->msg.sec_mode_reject, buffer, len);
-      break;
-    case DE_REG_ACCEPT_UE_ORIGIN:
-      encode_result =
-          msg->msg.de_reg_accept.EncodeDeRegistrationAcceptUEInitMsg(
-              &msg->msg.de_reg_accept, buffer, len);
-      break;
-    case DLNASTRANSPORT:
-      encode_result = msg->msg.dl_nas_transport.EncodeDLNASTransportMsg(
-          &msg->msg.dl_nas_transport, buffer, len);
-      break;
-    default:
-      encode_result = TLV_WRONG_MESSAGE_TYPE;
+  const AmfMsgDispatchEntry* entry =
+      amf_msg_dispatch_entry(msg->header.message_type);
+  if (entry == nullptr || entry->encode == nullptr) {
+    return (TLV_WRONG_MESSAGE_TYPE);
   }
+  encode_result = entry->encode(msg, buffer, len);
   return (encode_result);
 }
 }  // namespace magma5g
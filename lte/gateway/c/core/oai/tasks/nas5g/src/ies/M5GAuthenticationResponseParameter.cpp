@@ -39,15 +39,16 @@ int AuthenticationResponseParameterMsg::
   response_parameter->length = *(buffer + decoded);
   MLOG(MDEBUG) << " Length : " << dec << int(response_parameter->length);
   decoded++;
-  response_parameter->response_parameter[0] = 0;
-  for (int i = 0; i < (int) (response_parameter->length); i++) {
-    response_parameter->response_parameter[i] = *(buffer + decoded);
-    decoded++;
-  }
-  for (int i = 0; i < (int) (response_parameter->length); i++) {
-    MLOG(MDEBUG) << " RES : " << hex
-                 << int(response_parameter->response_parameter[i]);
-  }
+  CHECK_LENGTH_DECODER(
+      sizeof(response_parameter->response_parameter),
+      response_parameter->length);
+  memcpy(
+      response_parameter->response_parameter, buffer + decoded,
+      response_parameter->length);
+  decoded += response_parameter->length;
+  MLOG(MDEBUG) << " RES : ";
+  BUFFER_PRINT_LOG(
+      response_parameter->response_parameter, response_parameter->length);
   return (decoded);
 };
 
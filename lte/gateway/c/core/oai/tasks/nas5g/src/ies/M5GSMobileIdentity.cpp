@@ -526,10 +526,8 @@ int M5GSMobileIdentityMsg::EncodeSuciMobileIdentityMsg(
       (const char*) (buffer + encoded), suci->suci_nai.size());
   MLOG(MDEBUG) << "ielen = " << hex << (unsigned char) suci->suci_nai.size();
   MLOG(MDEBUG) << "contents";
-
-  for (size_t i = 0; i < suci->suci_nai.size(); i++) {
-    MLOG(MDEBUG) << hex << int(suci->suci_nai[i]);
-  }
+  BUFFER_PRINT_LOG(
+      (const uint8_t*) suci->suci_nai.data(), suci->suci_nai.size());
 
   return encoded;
 };
@@ -260,7 +260,7 @@ m5g_ue_description_t* ngap_new_ue(
 
   gnb_ref = ngap_state_get_gnb(state, sctp_assoc_id);
   DevAssert(gnb_ref != NULL);
-  ue_ref = calloc(1, sizeof(m5g_ue_description_t));
+  ue_ref = ngap_ue_slab_alloc(get_ngap_ue_slab(), NULL);
 
   /*
    * Something bad happened during malloc...
@@ -281,7 +281,7 @@ m5g_ue_description_t* ngap_new_ue(
     OAILOG_ERROR(
         LOG_NGAP, "Could not insert UE descr in ue_coll: %s\n",
         hashtable_rc_code2string(hashrc));
-    free_wrapper((void**) &ue_ref);
+    ngap_ue_slab_release(get_ngap_ue_slab(), ue_ref);
     return NULL;
   }
   // Increment number of UE
@@ -289,6 +289,28 @@ m5g_ue_description_t* ngap_new_ue(
   return ue_ref;
 }
 
+//------------------------------------------------------------------------------
+void ngap_remove_ue(ngap_state_t* state, m5g_ue_description_t* ue_ref) {
+  gnb_description_t* gnb_ref = NULL;
+
+  // NULL reference...
+  if (ue_ref == NULL) return;
+
+  amf_ue_ngap_id_t amf_ue_ngap_id = ue_ref->amf_ue_ngap_id;
+  gnb_ref = ngap_state_get_gnb(state, ue_ref->sctp_assoc_id);
+  DevAssert(gnb_ref->nb_ue_associated > 0);
+  // Updating number of UE
+  gnb_ref->nb_ue_associated--;
+
+  ue_ref->ng_ue_state = NGAP_UE_INVALID_STATE;
+
+  // Freeing the hashtable entry returns the descriptor to the slab
+  hash_table_ts_t* state_ue_ht = get_ngap_ue_state();
+  hashtable_ts_free(state_ue_ht, ue_ref->comp_ngap_id);
+  hashtable_ts_free(&state->amfid2associd, amf_ue_ngap_id);
+  hashtable_uint64_ts_remove(&gnb_ref->ue_id_coll, amf_ue_ngap_id);
+}
+
 //------------------------------------------------------------------------------
 void ngap_remove_gnb(ngap_state_t* state, gnb_description_t* gnb_ref) {
   if (gnb_ref == NULL) {
@@ -51,27 +51,37 @@ static int ngap_amf_compare_plmn(const Ngap_PLMNIdentity_t* const plmn) {
 
   DevAssert(plmn != NULL);
   TBCD_TO_MCC_MNC(plmn, mcc, mnc, mnc_len);
-  amf_config_read_lock(&amf_config);
-
-  for (i = 0; i < amf_config.served_tai.nb_tai; i++) {
-    OAILOG_TRACE(
-        LOG_NGAP,
-        "Comparing plmn_mcc %d/%d, plmn_mnc %d/%d plmn_mnc_len %d/%d\n",
-        amf_config.served_tai.plmn_mcc[i], mcc,
-        amf_config.served_tai.plmn_mnc[i], mnc,
-        amf_config.served_tai.plmn_mnc_len[i], mnc_len);
-
-    if ((amf_config.served_tai.plmn_mcc[i] == mcc) &&
-        (amf_config.served_tai.plmn_mnc[i] == mnc) &&
-        (amf_config.served_tai.plmn_mnc_len[i] == mnc_len))
-      /*
-       * There is a matching plmn
-       */
-      return TA_LIST_AT_LEAST_ONE_MATCH;
-  }
 
-  amf_config_unlock(&amf_config);
-  return TA_LIST_NO_MATCH;
+  // Lock-free read: this runs for every broadcast plmn of every NG setup,
+  // so it must not take the config rwlock
+  int match = TA_LIST_NO_MATCH;
+  uint64_t seq;
+
+  do {
+    seq   = amf_config_read_begin(&amf_config);
+    match = TA_LIST_NO_MATCH;
+
+    for (i = 0; i < amf_config.served_tai.nb_tai; i++) {
+      OAILOG_TRACE(
+          LOG_NGAP,
+          "Comparing plmn_mcc %d/%d, plmn_mnc %d/%d plmn_mnc_len %d/%d\n",
+          amf_config.served_tai.plmn_mcc[i], mcc,
+          amf_config.served_tai.plmn_mnc[i], mnc,
+          amf_config.served_tai.plmn_mnc_len[i], mnc_len);
+
+      if ((amf_config.served_tai.plmn_mcc[i] == mcc) &&
+          (amf_config.served_tai.plmn_mnc[i] == mnc) &&
+          (amf_config.served_tai.plmn_mnc_len[i] == mnc_len)) {
+        /*
+         * There is a matching plmn
+         */
+        match = TA_LIST_AT_LEAST_ONE_MATCH;
+        break;
+      }
+    }
+  } while (amf_config_read_retry(&amf_config, seq));
+
+  return match;
 }
 
 /* @brief compare a list of broadcasted plmns against the AMF configured.
@@ -104,19 +114,28 @@ static int ngap_amf_compare_tac(const Ngap_TAC_t* tac) {
 
   DevAssert(tac != NULL);
   OCTET_STRING_TO_TAC(tac, tac_value);
-  amf_config_read_lock(&amf_config);
 
-  for (i = 0; i < amf_config.served_tai.nb_tai; i++) {
-    OAILOG_TRACE(
-        LOG_NGAP, "Comparing config tac %d, received tac = %d\n",
-        amf_config.served_tai.tac[i], tac_value);
+  // Lock-free read, see ngap_amf_compare_plmn
+  int match = TA_LIST_NO_MATCH;
+  uint64_t seq;
 
-    if (amf_config.served_tai.tac[i] == tac_value)
-      return TA_LIST_AT_LEAST_ONE_MATCH;
-  }
+  do {
+    seq   = amf_config_read_begin(&amf_config);
+    match = TA_LIST_NO_MATCH;
+
+    for (i = 0; i < amf_config.served_tai.nb_tai; i++) {
+      OAILOG_TRACE(
+          LOG_NGAP, "Comparing config tac %d, received tac = %d\n",
+          amf_config.served_tai.tac[i], tac_value);
+
+      if (amf_config.served_tai.tac[i] == tac_value) {
+        match = TA_LIST_AT_LEAST_ONE_MATCH;
+        break;
+      }
+    }
+  } while (amf_config_read_retry(&amf_config, seq));
 
-  amf_config_unlock(&amf_config);
-  return TA_LIST_NO_MATCH;
+  return match;
 }
 
 /* @brief compare a given ta list against the one provided by amf configuration.
@@ -78,10 +78,17 @@ m5g_ue_description_t* ngap_state_get_ue_gnbid(
 m5g_ue_description_t* ngap_state_get_ue_amfid(amf_ue_ngap_id_t amf_ue_ngap_id) {
   m5g_ue_description_t* ue = nullptr;
 
-  hash_table_ts_t* state_ue_ht = get_ngap_ue_state();
-  hashtable_ts_apply_callback_on_elements(
-      (hash_table_ts_t* const) state_ue_ht, ngap_ue_compare_by_amf_ue_id_cb,
-      &amf_ue_ngap_id, (void**) &ue);
+  // Slab-minted ids resolve in O(1) by index and generation; ids assigned
+  // outside the slab encoding fall back to the linear sweep
+  ue = ngap_ue_slab_get(get_ngap_ue_slab(), amf_ue_ngap_id);
+  if (ue != nullptr && ue->amf_ue_ngap_id == amf_ue_ngap_id) {
+    return ue;
+  }
+  ue = nullptr;
+
+  ngap_ue_slab_apply_callback_on_elements(
+      get_ngap_ue_slab(), ngap_ue_compare_by_amf_ue_id_cb, &amf_ue_ngap_id,
+      (void**) &ue);
 
   return ue;
 }
@@ -89,10 +96,8 @@ m5g_ue_description_t* ngap_state_get_ue_amfid(amf_ue_ngap_id_t amf_ue_ngap_id) {
 m5g_ue_description_t* ngap_state_get_ue_imsi(imsi64_t imsi64) {
   m5g_ue_description_t* ue = nullptr;
 
-  hash_table_ts_t* state_ue_ht = get_ngap_ue_state();
-  hashtable_ts_apply_callback_on_elements(
-      (hash_table_ts_t* const) state_ue_ht, ngap_ue_compare_by_imsi, &imsi64,
-      (void**) &ue);
+  ngap_ue_slab_apply_callback_on_elements(
+      get_ngap_ue_slab(), ngap_ue_compare_by_imsi, &imsi64, (void**) &ue);
 
   return ue;
 }
@@ -149,6 +154,10 @@ hash_table_ts_t* get_ngap_ue_state(void) {
   return NgapStateManager::getInstance().get_ue_state_ht();
 }
 
+ngap_ue_slab_t* get_ngap_ue_slab(void) {
+  return NgapStateManager::getInstance().get_ue_slab();
+}
+
 void put_ngap_ue_state(imsi64_t imsi64) {
   if (NgapStateManager::getInstance().is_persist_state_enabled()) {
     m5g_ue_description_t* ue_ctxt = ngap_state_get_ue_imsi(imsi64);
@@ -28,6 +28,7 @@ extern "C" {
 #include "hashtable.h"
 #include "amf_config.h"
 #include "ngap_types.h"
+#include "ngap_ue_slab.h"
 
 int ngap_state_init(uint32_t max_ues, uint32_t max_gnbs, bool use_stateless);
 
@@ -68,6 +69,8 @@ ngap_imsi_map_t* get_ngap_imsi_map(void);
 
 hash_table_ts_t* get_ngap_ue_state(void);
 
+ngap_ue_slab_t* get_ngap_ue_slab(void);
+
 int read_ngap_ue_state_db(void);
 
 void put_ngap_ue_state(imsi64_t imsi64);
@@ -71,7 +71,11 @@ void NgapStateManager::create_state() {
   hashtable_ts_init(
       &state_cache_p->gnbs, max_gnbs_, nullptr, free_wrapper, ht_name);
 
-  state_ue_ht = hashtable_ts_create(max_ues_, nullptr, free_wrapper, ht_name);
+  // UE descriptors live in the slab; the hashtable keyed by comp_ngap_id
+  // only references them, so freeing an entry returns it to the slab
+  ngap_ue_slab_init(&ue_slab_, max_ues_);
+  state_ue_ht = hashtable_ts_create(
+      max_ues_, nullptr, ngap_ue_slab_release_ht_cb, ht_name);
   bdestroy(ht_name);
 
   ht_name = bfromcstr(NGAP_AMF_ID2ASSOC_ID_COLL);
@@ -122,6 +126,7 @@ void NgapStateManager::free_state() {
   if (hashtable_ts_destroy(state_ue_ht) != HASH_TABLE_OK) {
     OAI_FPRINTF_ERR("An error occurred while destroying assoc_id hash table");
   }
+  ngap_ue_slab_destroy(&ue_slab_);
   free_wrapper((void**) &state_cache_p);
 
   clear_ngap_imsi_map();
@@ -134,10 +139,13 @@ status_code_e NgapStateManager::read_ue_state_from_db() {
   auto keys = redis_client->get_keys("IMSI*" + task_name + "*");
 
   for (const auto& key : keys) {
-    Ngap_UeDescription ue_proto = Ngap_UeDescription();
-    m5g_ue_description_t* ue_context =
-        (m5g_ue_description_t*) calloc(1, sizeof(m5g_ue_description_t));
+    Ngap_UeDescription ue_proto      = Ngap_UeDescription();
+    m5g_ue_description_t* ue_context = ngap_ue_slab_alloc(&ue_slab_, nullptr);
+    if (ue_context == nullptr) {
+      return RETURNerror;
+    }
     if (redis_client->read_proto(key.c_str(), ue_proto) != RETURNok) {
+      ngap_ue_slab_release(&ue_slab_, ue_context);
       return RETURNerror;
     }
 
@@ -177,6 +185,10 @@ ngap_imsi_map_t* NgapStateManager::get_ngap_imsi_map() {
   return ngap_imsi_map_;
 }
 
+ngap_ue_slab_t* NgapStateManager::get_ue_slab() {
+  return &ue_slab_;
+}
+
 void NgapStateManager::put_ngap_imsi_map() {
   if (!persist_state_enabled) {
     return;
@@ -27,6 +27,7 @@ extern "C" {
 
 #include "amf_config.h"
 #include "ngap_types.h"
+#include "ngap_ue_slab.h"
 
 #ifdef __cplusplus
 }
@@ -92,6 +93,11 @@ class NgapStateManager
    */
   ngap_imsi_map_t* get_ngap_imsi_map();
 
+  /**
+   * Returns a pointer to the UE descriptor slab
+   */
+  ngap_ue_slab_t* get_ue_slab();
+
  private:
   NgapStateManager();
   ~NgapStateManager();
@@ -112,5 +118,6 @@ class NgapStateManager
   uint32_t max_gnbs_;
   ngap_imsi_map_t* ngap_imsi_map_;
   std::size_t ngap_imsi_map_hash_;
+  ngap_ue_slab_t ue_slab_;
 };
 }  // namespace magma5g
@@ -0,0 +1,196 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/****************************************************************************
+  Source      ngap_ue_slab.c
+  Subsystem   Access and Mobility Management Function
+  Description Slab store for NGAP UE descriptors with generation-indexed ids
+
+*****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "dynamic_memory_check.h"
+#include "ngap_ue_slab.h"
+
+/* The NGAP task owns a single slab; remember it so hashtable freefunc
+ * adapters, which get no context argument, can find their way back */
+static ngap_ue_slab_t* default_slab;
+
+//------------------------------------------------------------------------------
+static amf_ue_ngap_id_t ngap_ue_slab_make_id(
+    uint16_t generation, uint32_t index) {
+  return ((amf_ue_ngap_id_t) generation << NGAP_UE_SLAB_INDEX_BITS) | index;
+}
+
+//------------------------------------------------------------------------------
+int ngap_ue_slab_init(ngap_ue_slab_t* slab, uint32_t max_ues) {
+  uint32_t i;
+
+  if (max_ues == 0 || max_ues > NGAP_UE_SLAB_MAX_UES) {
+    max_ues = NGAP_UE_SLAB_MAX_UES;
+  }
+
+  memset(slab, 0, sizeof(*slab));
+  slab->entries = calloc(max_ues, sizeof(ngap_ue_slab_entry_t));
+  if (slab->entries == NULL) {
+    OAILOG_ERROR(LOG_NGAP, "Failed to allocate UE slab for %u UEs\n", max_ues);
+    return -1;
+  }
+  slab->capacity  = max_ues;
+  slab->free_head = 0;
+  for (i = 0; i < max_ues; i++) {
+    // Generation 0 is never minted so no valid id equals
+    // INVALID_AMF_UE_NGAP_ID
+    slab->entries[i].generation = 1;
+    slab->entries[i].next_free  = i + 1;
+  }
+  pthread_mutex_init(&slab->lock, NULL);
+
+  if (default_slab == NULL) {
+    default_slab = slab;
+  }
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+void ngap_ue_slab_destroy(ngap_ue_slab_t* slab) {
+  if (default_slab == slab) {
+    default_slab = NULL;
+  }
+  pthread_mutex_destroy(&slab->lock);
+  free_wrapper((void**) &slab->entries);
+  memset(slab, 0, sizeof(*slab));
+}
+
+//------------------------------------------------------------------------------
+m5g_ue_description_t* ngap_ue_slab_alloc(
+    ngap_ue_slab_t* slab, amf_ue_ngap_id_t* ue_id_p) {
+  ngap_ue_slab_entry_t* entry;
+  uint32_t index;
+
+  pthread_mutex_lock(&slab->lock);
+  index = slab->free_head;
+  if (index >= slab->capacity) {
+    pthread_mutex_unlock(&slab->lock);
+    OAILOG_ERROR(
+        LOG_NGAP, "UE slab exhausted (%u descriptors in use)\n",
+        slab->num_used);
+    return NULL;
+  }
+  entry           = &slab->entries[index];
+  slab->free_head = entry->next_free;
+  slab->num_used++;
+  entry->in_use = true;
+  memset(&entry->ue, 0, sizeof(entry->ue));
+  pthread_mutex_unlock(&slab->lock);
+
+  if (ue_id_p) {
+    *ue_id_p = ngap_ue_slab_make_id(entry->generation, index);
+  }
+  return &entry->ue;
+}
+
+//------------------------------------------------------------------------------
+m5g_ue_description_t* ngap_ue_slab_get(
+    ngap_ue_slab_t* slab, amf_ue_ngap_id_t ue_id) {
+  ngap_ue_slab_entry_t* entry;
+  uint32_t index = ue_id & NGAP_UE_SLAB_INDEX_MASK;
+
+  if (index >= slab->capacity) {
+    return NULL;
+  }
+  entry = &slab->entries[index];
+  if (!entry->in_use ||
+      ngap_ue_slab_make_id(entry->generation, index) != ue_id) {
+    return NULL;
+  }
+  return &entry->ue;
+}
+
+//------------------------------------------------------------------------------
+void ngap_ue_slab_release(ngap_ue_slab_t* slab, m5g_ue_description_t* ue) {
+  ngap_ue_slab_entry_t* entry = (ngap_ue_slab_entry_t*) ue;
+  uint32_t index;
+
+  if (entry < slab->entries || entry >= slab->entries + slab->capacity) {
+    OAILOG_ERROR(LOG_NGAP, "UE descriptor %p is not slab-backed\n", ue);
+    return;
+  }
+  index = (uint32_t)(entry - slab->entries);
+
+  pthread_mutex_lock(&slab->lock);
+  if (!entry->in_use) {
+    pthread_mutex_unlock(&slab->lock);
+    OAILOG_ERROR(LOG_NGAP, "Double release of UE slab index %u\n", index);
+    return;
+  }
+  entry->in_use = false;
+  // Invalidate outstanding ids for this slot
+  entry->generation++;
+  if (entry->generation == 0) {
+    entry->generation = 1;
+  }
+  entry->next_free = slab->free_head;
+  slab->free_head  = index;
+  slab->num_used--;
+  pthread_mutex_unlock(&slab->lock);
+}
+
+//------------------------------------------------------------------------------
+void ngap_ue_slab_release_ht_cb(void** elementP) {
+  if (elementP == NULL || *elementP == NULL) {
+    return;
+  }
+  if (default_slab == NULL) {
+    OAILOG_ERROR(LOG_NGAP, "No UE slab registered, leaking descriptor\n");
+    return;
+  }
+  ngap_ue_slab_release(default_slab, (m5g_ue_description_t*) *elementP);
+  *elementP = NULL;
+}
+
+//------------------------------------------------------------------------------
+void ngap_ue_slab_apply_callback_on_elements(
+    ngap_ue_slab_t* slab,
+    bool func_cb(hash_key_t key, void* element, void* parameter, void** result),
+    void* parameter, void** result) {
+  uint32_t index;
+  uint32_t seen = 0;
+
+  pthread_mutex_lock(&slab->lock);
+  for (index = 0; index < slab->capacity && seen < slab->num_used; index++) {
+    ngap_ue_slab_entry_t* entry = &slab->entries[index];
+    if (!entry->in_use) {
+      continue;
+    }
+    seen++;
+    if (func_cb(
+            (hash_key_t) ngap_ue_slab_make_id(entry->generation, index),
+            &entry->ue, parameter, result)) {
+      break;
+    }
+  }
+  pthread_mutex_unlock(&slab->lock);
+}
+
+//------------------------------------------------------------------------------
+uint32_t ngap_ue_slab_count(ngap_ue_slab_t* slab) {
+  uint32_t count;
+
+  pthread_mutex_lock(&slab->lock);
+  count = slab->num_used;
+  pthread_mutex_unlock(&slab->lock);
+  return count;
+}
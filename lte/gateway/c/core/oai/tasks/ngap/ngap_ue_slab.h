@@ -0,0 +1,102 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/****************************************************************************
+  Source      ngap_ue_slab.h
+  Subsystem   Access and Mobility Management Function
+  Description Slab store for NGAP UE descriptors with generation-indexed ids
+
+*****************************************************************************/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hashtable.h"
+#include "amf_config.h"
+#include "ngap_types.h"
+
+/* All UE descriptors live in one preallocated slab. A descriptor is
+ * addressed by an id that packs its slab index in the low bits and a
+ * per-slot generation counter in the high bits, so a stale id from a
+ * released UE never aliases the slot's next occupant. Lookup is a bounds
+ * check plus a generation compare: O(1), pointer-free and allocation-free.
+ * When the AMF mints amf_ue_ngap_id values from the slab, lookup by AMF id
+ * needs no table at all; iteration for periodic sweeps walks the slab
+ * linearly.
+ */
+#define NGAP_UE_SLAB_INDEX_BITS 16
+#define NGAP_UE_SLAB_INDEX_MASK ((1u << NGAP_UE_SLAB_INDEX_BITS) - 1)
+/* Index NGAP_UE_SLAB_INDEX_MASK stays unused so no id is ever 0xFFFFFFFF */
+#define NGAP_UE_SLAB_MAX_UES (NGAP_UE_SLAB_INDEX_MASK - 1)
+
+typedef struct ngap_ue_slab_entry_s {
+  m5g_ue_description_t ue;  ///< Must stay first, descriptors are cast back
+  uint16_t generation;      ///< Bumped when the slot is released
+  bool in_use;
+  uint32_t next_free;  ///< Free list link (index), valid when not in use
+} ngap_ue_slab_entry_t;
+
+typedef struct ngap_ue_slab_s {
+  ngap_ue_slab_entry_t* entries;
+  uint32_t capacity;
+  uint32_t free_head;  ///< First free index, capacity when exhausted
+  uint32_t num_used;
+  pthread_mutex_t lock;
+} ngap_ue_slab_t;
+
+/** \brief Preallocate a slab for up to max_ues UE descriptors
+ *  @returns -1 on failure, 0 otherwise
+ **/
+int ngap_ue_slab_init(ngap_ue_slab_t* slab, uint32_t max_ues);
+
+void ngap_ue_slab_destroy(ngap_ue_slab_t* slab);
+
+/** \brief Take a zeroed descriptor from the slab
+ *  \param ue_id_p set to the generation-indexed id of the new descriptor
+ *  @returns NULL when the slab is exhausted
+ **/
+m5g_ue_description_t* ngap_ue_slab_alloc(
+    ngap_ue_slab_t* slab, amf_ue_ngap_id_t* ue_id_p);
+
+/** \brief Resolve a generation-indexed id, NULL for stale or foreign ids */
+m5g_ue_description_t* ngap_ue_slab_get(
+    ngap_ue_slab_t* slab, amf_ue_ngap_id_t ue_id);
+
+/** \brief Return a descriptor to the slab and invalidate its id */
+void ngap_ue_slab_release(ngap_ue_slab_t* slab, m5g_ue_description_t* ue);
+
+/** \brief Hashtable freefunc adapter releasing descriptors to the slab,
+ * for UE collections that hold slab-backed descriptors as elements
+ **/
+void ngap_ue_slab_release_ht_cb(void** elementP);
+
+/** \brief Walk used slots in index order, stopping when func_cb returns
+ * true; same callback contract as hashtable_ts_apply_callback_on_elements,
+ * keyed by the descriptor's generation-indexed id
+ **/
+void ngap_ue_slab_apply_callback_on_elements(
+    ngap_ue_slab_t* slab,
+    bool func_cb(hash_key_t key, void* element, void* parameter, void** result),
+    void* parameter, void** result);
+
+uint32_t ngap_ue_slab_count(ngap_ue_slab_t* slab);
+
+#ifdef __cplusplus
+}
+#endif
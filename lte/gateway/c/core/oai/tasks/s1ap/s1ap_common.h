@@ -439,4 +439,50 @@ typedef int (*s1ap_message_handler_t)(
  **/
 void s1ap_handle_criticality(S1ap_Criticality_t criticality);
 
+/** \brief Hand a malloc'ed ASN.1 encode buffer over to a bstring without
+ copying: the returned bstring owns the buffer and bdestroy frees it, so the
+ encoded PDU travels by reference through ITTI down to the SCTP write.
+ \param buffer Encode buffer allocated by asn_encode_to_new_buffer
+ \param length Encoded length in bytes
+ @returns the owning bstring, or NULL on bad parameters
+ **/
+static inline bstring s1ap_buffer_to_bstring(
+    uint8_t* const buffer, const uint32_t length) {
+  bstring b = NULL;
+
+  if ((buffer == NULL) || (length == 0)) {
+    return NULL;
+  }
+  b = (bstring) malloc(sizeof(struct tagbstring));
+  if (b == NULL) {
+    return NULL;
+  }
+  b->mlen = length;
+  b->slen = length;
+  b->data = buffer;
+  return b;
+}
+
+/** \brief Move an ASN.1 OCTET STRING payload into a bstring without copying.
+ On success the octet string keeps no reference to its buffer, so freeing the
+ decoded structure afterwards does not touch the adopted storage. Used on the
+ NAS PDU fast path where the payload is forwarded as-is to another task.
+ \param octet_string Decoded OCTET STRING whose buffer is adopted
+ @returns the owning bstring, or NULL when the octet string is empty
+ **/
+static inline bstring s1ap_octet_string_to_bstring_steal(
+    OCTET_STRING_t* const octet_string) {
+  bstring b = NULL;
+
+  if (octet_string == NULL) {
+    return NULL;
+  }
+  b = s1ap_buffer_to_bstring(octet_string->buf, octet_string->size);
+  if (b != NULL) {
+    octet_string->buf  = NULL;
+    octet_string->size = 0;
+  }
+  return b;
+}
+
 #endif /* FILE_S1AP_COMMON_SEEN */
@@ -43,6 +43,7 @@
 #include "s1ap_mme_handlers.h"
 #include "s1ap_mme_nas_procedures.h"
 #include "s1ap_mme_itti_messaging.h"
+#include "s1ap_ue_index.h"
 #include "service303.h"
 #include "service303_message_utils.h"
 #include "dynamic_memory_check.h"
@@ -248,6 +249,16 @@ static int handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
       }
     } break;
 
+    case S1AP_PAGING_REQUEST_BATCH: {
+      is_task_state_same = true;  // the following handler does not modify state
+      is_ue_state_same   = true;
+      if (s1ap_handle_paging_request_batch(
+              state, &S1AP_PAGING_REQUEST_BATCH(received_message_p)) !=
+          RETURNok) {
+        OAILOG_ERROR(LOG_S1AP, "Failed to send paging batch\n");
+      }
+    } break;
+
     case S1AP_UE_CONTEXT_MODIFICATION_REQUEST: {
       is_task_state_same = true;  // the following handler does not modify state
       is_ue_state_same   = true;
@@ -586,14 +597,15 @@ void s1ap_remove_ue(s1ap_state_t* state, ue_description_t* ue_ref) {
   hashtable_ts_free(state_ue_ht, ue_ref->comp_s1ap_id);
   hashtable_ts_free(&state->mmeid2associd, mme_ue_s1ap_id);
   hashtable_uint64_ts_remove(&enb_ref->ue_id_coll, mme_ue_s1ap_id);
+  s1ap_ue_index_remove(mme_ue_s1ap_id);
 
   imsi64_t imsi64                = INVALID_IMSI64;
   s1ap_imsi_map_t* s1ap_imsi_map = get_s1ap_imsi_map();
-  hashtable_uint64_ts_get(
+  hashtable_oa_uint64_ts_get(
       s1ap_imsi_map->mme_ue_id_imsi_htbl, (const hash_key_t) mme_ue_s1ap_id,
       &imsi64);
   delete_s1ap_ue_state(imsi64);
-  hashtable_uint64_ts_remove(
+  hashtable_oa_uint64_ts_remove(
       s1ap_imsi_map->mme_ue_id_imsi_htbl, mme_ue_s1ap_id);
 
   OAILOG_DEBUG(
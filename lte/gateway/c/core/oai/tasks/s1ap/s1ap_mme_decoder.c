@@ -29,6 +29,7 @@
 #include "log.h"
 #include "assertions.h"
 #include "common_defs.h"
+#include "magma_sdt.h"
 #include "s1ap_mme_decoder.h"
 #include "S1ap_S1AP-PDU.h"
 #include "S1ap_InitiatingMessage.h"
@@ -54,6 +55,7 @@ status_code_e s1ap_mme_decode_pdu(
       OAILOG_ERROR(LOG_S1AP, "Failed to decode PDU\n");
       return RETURNerror;
     }
+    MAGMA_USDT2(s1ap_pdu_decode, pdu->present, blength(raw));
     return RETURNok;
   } else {
     OAILOG_DEBUG(LOG_S1AP, "PDU is NULL \n");
@@ -46,6 +46,7 @@
 #include "s1ap_mme.h"
 #include "s1ap_mme_ta.h"
 #include "s1ap_mme_handlers.h"
+#include "s1ap_ue_index.h"
 #include "mme_events.h"
 #include "3gpp_23.003.h"
 #include "3gpp_24.008.h"
@@ -350,8 +351,7 @@ status_code_e s1ap_mme_generate_s1_setup_failure(
     OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
   }
 
-  bstring b = blk2bstr(buffer_p, length);
-  free(buffer_p);
+  bstring b = s1ap_buffer_to_bstring(buffer_p, length);
   rc = s1ap_mme_itti_send_sctp_request(&b, assoc_id, 0, INVALID_MME_UE_S1AP_ID);
   OAILOG_FUNC_RETURN(LOG_S1AP, rc);
 }
@@ -672,6 +672,16 @@ status_code_e s1ap_mme_handle_s1_setup_request(
 }
 
 //------------------------------------------------------------------------------
+/* Cached Aligned-PER encode of the S1 Setup Response. Every IE in the
+ * message (served GUMMEIs, relative MME capacity) is derived from mme_config,
+ * which is fixed once the config file has been loaded, so the encoded bytes
+ * are identical for every eNB. A mass eNB reconnection then costs one memcpy
+ * per setup instead of a full ASN.1 encode. Only touched from the s1ap task
+ * thread.
+ */
+static uint8_t* s1_setup_response_template     = NULL;
+static uint32_t s1_setup_response_template_len = 0;
+
 status_code_e s1ap_generate_s1_setup_response(
     s1ap_state_t* state, enb_description_t* enb_association) {
   S1ap_S1AP_PDU_t pdu;
@@ -689,6 +699,27 @@ status_code_e s1ap_generate_s1_setup_response(
     OAILOG_ERROR(LOG_S1AP, "enb_association is NULL\n");
     return RETURNerror;
   }
+
+  /*
+   * Serve a pooled copy of the cached encode when one exists; the sctp send
+   * path takes ownership of the buffer and frees it, so the template itself
+   * is never handed out
+   */
+  if (s1_setup_response_template != NULL) {
+    buffer = malloc(s1_setup_response_template_len);
+    if (buffer != NULL) {
+      memcpy(
+          buffer, s1_setup_response_template, s1_setup_response_template_len);
+      length                    = s1_setup_response_template_len;
+      enb_association->s1_state = S1AP_READY;
+      bstring b                 = s1ap_buffer_to_bstring(buffer, length);
+      rc                        = s1ap_mme_itti_send_sctp_request(
+          &b, enb_association->sctp_assoc_id, 0, INVALID_MME_UE_S1AP_ID);
+      OAILOG_FUNC_RETURN(LOG_S1AP, rc);
+    }
+    // Allocation failed; fall through to a fresh encode
+  }
+
   memset(&pdu, 0, sizeof(pdu));
   pdu.present = S1ap_S1AP_PDU_PR_successfulOutcome;
   pdu.choice.successfulOutcome.procedureCode = S1ap_ProcedureCode_id_S1Setup;
@@ -775,13 +806,23 @@ status_code_e s1ap_generate_s1_setup_response(
      * Consider the response as sent. S1AP is ready to accept UE contexts
      */
     enb_association->s1_state = S1AP_READY;
+    /*
+     * Memoize the encode for the next eNB; the outgoing buffer is owned by
+     * the bstring below, so the template keeps its own copy
+     */
+    if ((s1_setup_response_template == NULL) && (length > 0)) {
+      s1_setup_response_template = malloc(length);
+      if (s1_setup_response_template != NULL) {
+        memcpy(s1_setup_response_template, buffer, length);
+        s1_setup_response_template_len = length;
+      }
+    }
   }
 
   /*
    * Non-UE signalling -> stream 0
    */
-  bstring b = blk2bstr(buffer, length);
-  free(buffer);
+  bstring b = s1ap_buffer_to_bstring(buffer, length);
   rc = s1ap_mme_itti_send_sctp_request(
       &b, enb_association->sctp_assoc_id, 0, INVALID_MME_UE_S1AP_ID);
 
@@ -827,7 +868,7 @@ status_code_e s1ap_mme_handle_ue_cap_indication(
   }
 
   s1ap_imsi_map_t* s1ap_imsi_map = get_s1ap_imsi_map();
-  hashtable_uint64_ts_get(
+  hashtable_oa_uint64_ts_get(
       s1ap_imsi_map->mme_ue_id_imsi_htbl, (const hash_key_t) mme_ue_s1ap_id,
       &imsi64);
 
@@ -946,7 +987,7 @@ status_code_e s1ap_mme_handle_initial_context_setup_response(
     OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
   }
   s1ap_imsi_map_t* s1ap_imsi_map = get_s1ap_imsi_map();
-  hashtable_uint64_ts_get(
+  hashtable_oa_uint64_ts_get(
       s1ap_imsi_map->mme_ue_id_imsi_htbl, (const hash_key_t) mme_ue_s1ap_id,
       &imsi64);
 
@@ -1222,7 +1263,7 @@ status_code_e s1ap_mme_handle_ue_context_release_request(
        * tunnel mapping for all the bearers.
        */
       s1ap_imsi_map_t* imsi_map = get_s1ap_imsi_map();
-      hashtable_uint64_ts_get(
+      hashtable_oa_uint64_ts_get(
           imsi_map->mme_ue_id_imsi_htbl, (const hash_key_t) mme_ue_s1ap_id,
           &imsi64);
       rc = s1ap_send_mme_ue_context_release(
@@ -1335,8 +1376,7 @@ status_code_e s1ap_mme_generate_ue_context_release_command(
     OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
   }
 
-  bstring b = blk2bstr(buffer, length);
-  free(buffer);
+  bstring b = s1ap_buffer_to_bstring(buffer, length);
   rc = s1ap_mme_itti_send_sctp_request(&b, assoc_id, stream, mme_ue_s1ap_id);
   if (ue_ref_p != NULL) {
     ue_ref_p->s1_ue_state = S1AP_UE_WAITING_CRR;
@@ -1429,8 +1469,7 @@ status_code_e s1ap_mme_generate_ue_context_modification(
     OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
   }
 
-  bstring b = blk2bstr(buffer, length);
-  free(buffer);
+  bstring b = s1ap_buffer_to_bstring(buffer, length);
   rc = s1ap_mme_itti_send_sctp_request(
       &b, ue_ref_p->sctp_assoc_id, ue_ref_p->sctp_stream_send,
       ue_ref_p->mme_ue_s1ap_id);
@@ -1620,7 +1659,7 @@ status_code_e s1ap_mme_handle_initial_context_setup_failure(
   }
 
   s1ap_imsi_map_t* imsi_map = get_s1ap_imsi_map();
-  hashtable_uint64_ts_get(
+  hashtable_oa_uint64_ts_get(
       imsi_map->mme_ue_id_imsi_htbl, (const hash_key_t) mme_ue_s1ap_id,
       &imsi64);
 
@@ -1758,7 +1797,7 @@ status_code_e s1ap_mme_handle_ue_context_modification_response(
        */
 
       s1ap_imsi_map_t* imsi_map = get_s1ap_imsi_map();
-      hashtable_uint64_ts_get(
+      hashtable_oa_uint64_ts_get(
           imsi_map->mme_ue_id_imsi_htbl,
           (const hash_key_t) ie->value.choice.MME_UE_S1AP_ID, &imsi64);
 
@@ -1843,7 +1882,7 @@ status_code_e s1ap_mme_handle_ue_context_modification_failure(
         (ue_ref_p->enb_ue_s1ap_id ==
          (ie_enb->value.choice.ENB_UE_S1AP_ID & ENB_UE_S1AP_ID_MASK))) {
       s1ap_imsi_map_t* imsi_map = get_s1ap_imsi_map();
-      hashtable_uint64_ts_get(
+      hashtable_oa_uint64_ts_get(
           imsi_map->mme_ue_id_imsi_htbl,
           (const hash_key_t) ie->value.choice.MME_UE_S1AP_ID, &imsi64);
 
@@ -2037,7 +2076,7 @@ status_code_e s1ap_mme_handle_handover_request_ack(
   }
 
   // get imsi for logging
-  hashtable_uint64_ts_get(
+  hashtable_oa_uint64_ts_get(
       imsi_map->mme_ue_id_imsi_htbl, (const hash_key_t) mme_ue_s1ap_id,
       &imsi64);
 
@@ -2219,8 +2258,7 @@ status_code_e s1ap_mme_handle_handover_failure(
   if (err) {
     OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
   }
-  bstring b = blk2bstr(buffer_p, length);
-  free(buffer_p);
+  bstring b = s1ap_buffer_to_bstring(buffer_p, length);
 
   OAILOG_DEBUG(
       LOG_S1AP,
@@ -2367,8 +2405,7 @@ status_code_e s1ap_mme_handle_handover_cancel(
   if (err) {
     OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
   }
-  bstring b = blk2bstr(buffer_p, length);
-  free(buffer_p);
+  bstring b = s1ap_buffer_to_bstring(buffer_p, length);
 
   s1ap_mme_itti_send_sctp_request(&b, assoc_id, stream, mme_ue_s1ap_id);
 
@@ -2635,8 +2672,7 @@ status_code_e s1ap_mme_handle_handover_request(
   if (err) {
     OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
   }
-  bstring b = blk2bstr(buffer_p, length);
-  free(buffer_p);
+  bstring b = s1ap_buffer_to_bstring(buffer_p, length);
 
   s1ap_mme_itti_send_sctp_request(
       &b, ho_request_p->target_sctp_assoc_id, stream,
@@ -2827,7 +2863,7 @@ status_code_e s1ap_mme_handle_handover_required(
       cause_value, target_enb_id);
 
   // get imsi for logging
-  hashtable_uint64_ts_get(
+  hashtable_oa_uint64_ts_get(
       imsi_map->mme_ue_id_imsi_htbl, (const hash_key_t) mme_ue_s1ap_id,
       &imsi64);
 
@@ -2953,8 +2989,7 @@ status_code_e s1ap_mme_handle_handover_command(
   if (err) {
     OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
   }
-  bstring b = blk2bstr(buffer_p, length);
-  free(buffer_p);
+  bstring b = s1ap_buffer_to_bstring(buffer_p, length);
 
   s1ap_mme_itti_send_sctp_request(
       &b, ho_command_p->source_assoc_id, stream, ho_command_p->mme_ue_s1ap_id);
@@ -3049,7 +3084,7 @@ status_code_e s1ap_mme_handle_handover_notify(
   TBCD_TO_PLMN_T(&ie->value.choice.TAI.pLMNidentity, &tai.plmn);
 
   // imsi for logging
-  hashtable_uint64_ts_get(
+  hashtable_oa_uint64_ts_get(
       imsi_map->mme_ue_id_imsi_htbl, (const hash_key_t) mme_ue_s1ap_id,
       &imsi64);
 
@@ -3114,6 +3149,8 @@ status_code_e s1ap_mme_handle_handover_notify(
         &target_enb->ue_id_coll,
         (const hash_key_t) new_ue_ref_p->mme_ue_s1ap_id,
         new_ue_ref_p->comp_s1ap_id);
+    s1ap_ue_index_insert(
+        new_ue_ref_p->mme_ue_s1ap_id, new_ue_ref_p->comp_s1ap_id);
 
     OAILOG_DEBUG_UE(
         LOG_S1AP, imsi64,
@@ -3222,8 +3259,7 @@ status_code_e s1ap_mme_handle_enb_status_transfer(
     OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
   }
 
-  bstring b = blk2bstr(buffer, length);
-  free(buffer);
+  bstring b = s1ap_buffer_to_bstring(buffer, length);
 
   s1ap_mme_itti_send_sctp_request(
       &b, target_enb_association->sctp_assoc_id,
@@ -3296,7 +3332,7 @@ status_code_e s1ap_mme_handle_path_switch_request(
       "ID: " ENB_UE_S1AP_ID_FMT "\n",
       enb_ue_s1ap_id);
 
-  hashtable_uint64_ts_get(
+  hashtable_oa_uint64_ts_get(
       imsi_map->mme_ue_id_imsi_htbl, (const hash_key_t) mme_ue_s1ap_id,
       &imsi64);
 
@@ -3375,6 +3411,8 @@ status_code_e s1ap_mme_handle_path_switch_request(
         &enb_association->ue_id_coll,
         (const hash_key_t) new_ue_ref_p->mme_ue_s1ap_id,
         new_ue_ref_p->comp_s1ap_id);
+    s1ap_ue_index_insert(
+        new_ue_ref_p->mme_ue_s1ap_id, new_ue_ref_p->comp_s1ap_id);
 
     OAILOG_DEBUG_UE(
         LOG_S1AP, imsi64,
@@ -3761,7 +3799,7 @@ void s1ap_mme_handle_ue_context_rel_comp_timer_expiry(
   imsi64_t imsi64                        = INVALID_IMSI64;
 
   s1ap_imsi_map_t* imsi_map = get_s1ap_imsi_map();
-  hashtable_uint64_ts_get(
+  hashtable_oa_uint64_ts_get(
       imsi_map->mme_ue_id_imsi_htbl,
       (const hash_key_t) ue_ref_p->mme_ue_s1ap_id, &imsi64);
 
@@ -3893,7 +3931,7 @@ status_code_e s1ap_mme_handle_error_ind_message(
 
   imsi64_t imsi64           = INVALID_IMSI64;
   s1ap_imsi_map_t* imsi_map = get_s1ap_imsi_map();
-  hashtable_uint64_ts_get(
+  hashtable_oa_uint64_ts_get(
       imsi_map->mme_ue_id_imsi_htbl, (const hash_key_t) mme_ue_s1ap_id,
       &imsi64);
 
@@ -4008,7 +4046,7 @@ status_code_e s1ap_mme_handle_erab_setup_response(
   }
 
   s1ap_imsi_map_t* imsi_map = get_s1ap_imsi_map();
-  hashtable_uint64_ts_get(
+  hashtable_oa_uint64_ts_get(
       imsi_map->mme_ue_id_imsi_htbl,
       (const hash_key_t) ue_ref_p->mme_ue_s1ap_id, &imsi64);
 
@@ -4240,7 +4278,7 @@ status_code_e s1ap_mme_handle_enb_reset(
           mme_ue_s1ap_id =
               (mme_ue_s1ap_id_t) * (s1_sig_conn_id_p->mME_UE_S1AP_ID);
           s1ap_imsi_map_t* imsi_map = get_s1ap_imsi_map();
-          hashtable_uint64_ts_get(
+          hashtable_oa_uint64_ts_get(
               imsi_map->mme_ue_id_imsi_htbl, (const hash_key_t) mme_ue_s1ap_id,
               &imsi64);
           if ((ue_ref_p = s1ap_state_get_ue_mmeid(mme_ue_s1ap_id)) != NULL) {
@@ -4409,8 +4447,7 @@ status_code_e s1ap_handle_enb_initiated_reset_ack(
   }
   increment_counter("s1_reset_from_enb", 1, 1, "action", "reset_ack_sent");
   if (buffer) {
-    bstring b = blk2bstr(buffer, length);
-    free_wrapper((void**) &buffer);
+    bstring b = s1ap_buffer_to_bstring(buffer, length);
     rc = s1ap_mme_itti_send_sctp_request(
         &b, enb_reset_ack_p->sctp_assoc_id, enb_reset_ack_p->sctp_stream_id,
         INVALID_MME_UE_S1AP_ID);
@@ -4419,21 +4456,16 @@ status_code_e s1ap_handle_enb_initiated_reset_ack(
 }
 
 //-------------------------------------------------------------------------------
-status_code_e s1ap_handle_paging_request(
-    s1ap_state_t* state, const itti_s1ap_paging_request_t* paging_request,
-    imsi64_t imsi64) {
+/* Builds and encodes the S1AP Paging PDU for one paged UE; the encoded
+ * buffer is allocated by asn.1c and owned by the caller */
+static status_code_e s1ap_encode_paging_message(
+    const itti_s1ap_paging_request_t* paging_request, imsi64_t imsi64,
+    uint8_t** buffer_pp, uint32_t* length_p) {
   OAILOG_FUNC_IN(LOG_S1AP);
 
-  if (paging_request == NULL) {
-    OAILOG_ERROR(LOG_S1AP, "paging_request is NULL\n");
-    return RETURNerror;
-  }
-  int rc                  = RETURNok;
   uint8_t num_of_tac      = 0;
   uint16_t tai_list_count = paging_request->tai_list_count;
 
-  bool is_tai_found    = false;
-  uint32_t idx         = 0;
   uint8_t* buffer_p    = NULL;
   uint32_t length      = 0;
   S1ap_S1AP_PDU_t pdu  = {0};
@@ -4543,16 +4575,44 @@ status_code_e s1ap_handle_paging_request(
     OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
   }
 
+  *buffer_pp = buffer_p;
+  *length_p  = length;
+  OAILOG_FUNC_RETURN(LOG_S1AP, RETURNok);
+}
+
+//-------------------------------------------------------------------------------
+status_code_e s1ap_handle_paging_request(
+    s1ap_state_t* state, const itti_s1ap_paging_request_t* paging_request,
+    imsi64_t imsi64) {
+  OAILOG_FUNC_IN(LOG_S1AP);
+
+  if (paging_request == NULL) {
+    OAILOG_ERROR(LOG_S1AP, "paging_request is NULL\n");
+    return RETURNerror;
+  }
+  int rc            = RETURNok;
+  bool is_tai_found = false;
+  uint32_t idx      = 0;
+  uint8_t* buffer_p = NULL;
+  uint32_t length   = 0;
+
+  if (s1ap_encode_paging_message(paging_request, imsi64, &buffer_p, &length) !=
+      RETURNok) {
+    OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
+  }
+
   /*Fetching eNB list to send paging request message*/
   hashtable_element_array_t* enb_array = NULL;
   enb_description_t* enb_ref_p         = NULL;
   if (state == NULL) {
     OAILOG_ERROR(LOG_S1AP, "eNB Information is NULL!\n");
+    free(buffer_p);
     OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
   }
   enb_array = hashtable_ts_get_elements(&state->enbs);
   if (enb_array == NULL) {
     OAILOG_ERROR(LOG_S1AP, "Could not find eNB hashlist!\n");
+    free(buffer_p);
     OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
   }
   const paging_tai_list_t* p_tai_list = paging_request->paging_tai_list;
@@ -4588,6 +4648,98 @@ status_code_e s1ap_handle_paging_request(
   OAILOG_FUNC_RETURN(LOG_S1AP, rc);
 }
 
+//-------------------------------------------------------------------------------
+status_code_e s1ap_handle_paging_request_batch(
+    s1ap_state_t* state, itti_s1ap_paging_request_batch_t* paging_batch) {
+  OAILOG_FUNC_IN(LOG_S1AP);
+
+  if ((paging_batch == NULL) || (paging_batch->paging_requests == NULL) ||
+      (paging_batch->count == 0)) {
+    OAILOG_ERROR(LOG_S1AP, "paging batch is empty\n");
+    OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
+  }
+  if (state == NULL) {
+    OAILOG_ERROR(LOG_S1AP, "eNB Information is NULL!\n");
+    free_wrapper((void**) &paging_batch->paging_requests);
+    OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
+  }
+
+  int rc            = RETURNok;
+  uint16_t count    = paging_batch->count;
+  uint8_t** buffers = calloc(count, sizeof(uint8_t*));
+  uint32_t* lengths = calloc(count, sizeof(uint32_t));
+  if ((buffers == NULL) || (lengths == NULL)) {
+    OAILOG_ERROR(LOG_S1AP, "Failed to allocate paging batch buffers\n");
+    free(buffers);
+    free(lengths);
+    free_wrapper((void**) &paging_batch->paging_requests);
+    OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
+  }
+
+  // Encode each paged UE once; the buffers are shared across all eNBs the
+  // UE is paged on
+  for (uint16_t i = 0; i < count; i++) {
+    const itti_s1ap_paging_request_t* paging_request =
+        &paging_batch->paging_requests[i];
+    if (s1ap_encode_paging_message(
+            paging_request, paging_request->imsi64, &buffers[i],
+            &lengths[i]) != RETURNok) {
+      buffers[i] = NULL;
+      rc         = RETURNerror;
+    }
+  }
+
+  // One walk of the eNB table covers the whole batch
+  hashtable_element_array_t* enb_array = hashtable_ts_get_elements(&state->enbs);
+  if (enb_array == NULL) {
+    OAILOG_ERROR(LOG_S1AP, "Could not find eNB hashlist!\n");
+    for (uint16_t i = 0; i < count; i++) {
+      free(buffers[i]);
+    }
+    free(buffers);
+    free(lengths);
+    free_wrapper((void**) &paging_batch->paging_requests);
+    OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
+  }
+  for (uint32_t idx = 0; idx < enb_array->num_elements; idx++) {
+    enb_description_t* enb_ref_p =
+        (enb_description_t*) enb_array->elements[idx];
+    if (enb_ref_p->s1_state != S1AP_READY) {
+      continue;
+    }
+    supported_ta_list_t* enb_ta_list = &enb_ref_p->supported_ta_list;
+    for (uint16_t i = 0; i < count; i++) {
+      const itti_s1ap_paging_request_t* paging_request =
+          &paging_batch->paging_requests[i];
+      if (buffers[i] == NULL) {
+        continue;
+      }
+      if (s1ap_paging_compare_ta_lists(
+              enb_ta_list, paging_request->paging_tai_list,
+              paging_request->tai_list_count)) {
+        bstring paging_msg_buffer = blk2bstr(buffers[i], lengths[i]);
+        if (s1ap_mme_itti_send_sctp_request(
+                &paging_msg_buffer, enb_ref_p->sctp_assoc_id,
+                0,   // Stream id 0 for non UE related S1AP message
+                0)   // mme_ue_s1ap_id 0 because UE in idle
+            != RETURNok) {
+          rc = RETURNerror;
+        }
+      }
+    }
+  }
+  free_wrapper((void**) &enb_array->elements);
+  free_wrapper((void**) &enb_array);
+  for (uint16_t i = 0; i < count; i++) {
+    free(buffers[i]);
+  }
+  free(buffers);
+  free(lengths);
+  free_wrapper((void**) &paging_batch->paging_requests);
+
+  OAILOG_FUNC_RETURN(LOG_S1AP, rc);
+}
+
 //------------------------------------------------------------------------------
 status_code_e s1ap_mme_handle_erab_modification_indication(
     s1ap_state_t* state, const sctp_assoc_id_t assoc_id,
@@ -4845,8 +4997,7 @@ void s1ap_mme_generate_erab_modification_confirm(
       "= " MME_UE_S1AP_ID_FMT " eNB_UE_S1AP_ID = " ENB_UE_S1AP_ID_FMT "\n",
       (mme_ue_s1ap_id_t) ue_ref->mme_ue_s1ap_id,
       (enb_ue_s1ap_id_t) ue_ref->enb_ue_s1ap_id);
-  bstring b = blk2bstr(buffer_p, length);
-  free(buffer_p);
+  bstring b = s1ap_buffer_to_bstring(buffer_p, length);
   s1ap_mme_itti_send_sctp_request(
       &b, ue_ref->sctp_assoc_id, ue_ref->sctp_stream_send,
       ue_ref->mme_ue_s1ap_id);
@@ -4951,8 +5102,7 @@ status_code_e s1ap_mme_handle_enb_configuration_transfer(
     OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
   }
 
-  bstring b = blk2bstr(buffer, length);
-  free(buffer);
+  bstring b = s1ap_buffer_to_bstring(buffer, length);
 
   // Send message
   rc = s1ap_mme_itti_send_sctp_request(
@@ -5099,8 +5249,7 @@ status_code_e s1ap_handle_path_switch_req_ack(
         LOG_S1AP, imsi64, "Path Switch Request Ack encoding failed \n");
     OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
   }
-  bstring b = blk2bstr(buffer, length);
-  free_wrapper((void**) &buffer);
+  bstring b = s1ap_buffer_to_bstring(buffer, length);
   OAILOG_DEBUG_UE(
       LOG_S1AP, imsi64,
       "Send PATH_SWITCH_REQUEST_ACK, mme_ue_s1ap_id " MME_UE_S1AP_ID_FMT "\n",
@@ -5157,7 +5306,7 @@ status_code_e s1ap_handle_path_switch_req_failure(
     OAILOG_ERROR(LOG_S1AP, "Path Switch Request Failure encoding failed \n");
     OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
   }
-  bstring b = blk2bstr(buffer, length);
+  bstring b = s1ap_buffer_to_bstring(buffer, length);
   OAILOG_DEBUG_UE(
       LOG_S1AP, imsi64,
       "send PATH_SWITCH_REQUEST_Failure for mme_ue_s1ap_id " MME_UE_S1AP_ID_FMT
@@ -5248,7 +5397,7 @@ status_code_e s1ap_mme_handle_erab_rel_response(
   }
 
   s1ap_imsi_map_t* imsi_map = get_s1ap_imsi_map();
-  hashtable_uint64_ts_get(
+  hashtable_oa_uint64_ts_get(
       imsi_map->mme_ue_id_imsi_htbl,
       (const hash_key_t) ie->value.choice.MME_UE_S1AP_ID, &imsi64);
 
@@ -166,6 +166,9 @@ status_code_e s1ap_handle_paging_request(
     s1ap_state_t* state, const itti_s1ap_paging_request_t* paging_request,
     imsi64_t imsi64);
 
+status_code_e s1ap_handle_paging_request_batch(
+    s1ap_state_t* state, itti_s1ap_paging_request_batch_t* paging_batch);
+
 status_code_e s1ap_mme_handle_ue_context_modification_response(
     s1ap_state_t* state, const sctp_assoc_id_t assoc_id,
     const sctp_stream_id_t stream, S1ap_S1AP_PDU_t* message_p);
@@ -70,7 +70,7 @@ status_code_e s1ap_mme_itti_nas_uplink_ind(
   imsi64_t imsi64       = INVALID_IMSI64;
 
   s1ap_imsi_map_t* imsi_map = get_s1ap_imsi_map();
-  hashtable_uint64_ts_get(
+  hashtable_oa_uint64_ts_get(
       imsi_map->mme_ue_id_imsi_htbl, (const hash_key_t) ue_id, &imsi64);
 
   OAILOG_INFO_UE(
@@ -116,7 +116,7 @@ status_code_e s1ap_mme_itti_nas_downlink_cnf(
   }
 
   s1ap_imsi_map_t* imsi_map = get_s1ap_imsi_map();
-  hashtable_uint64_ts_get(
+  hashtable_oa_uint64_ts_get(
       imsi_map->mme_ue_id_imsi_htbl, (const hash_key_t) ue_id, &imsi64);
   message_p = itti_alloc_new_message(TASK_S1AP, MME_APP_DOWNLINK_DATA_CNF);
   if (message_p == NULL) {
@@ -144,9 +144,8 @@ status_code_e s1ap_mme_itti_nas_downlink_cnf(
 
 void s1ap_mme_itti_s1ap_initial_ue_message(
     const sctp_assoc_id_t assoc_id, const uint32_t enb_id,
-    const enb_ue_s1ap_id_t enb_ue_s1ap_id, const uint8_t* const nas_msg,
-    const size_t nas_msg_length, const tai_t* const tai,
-    const ecgi_t* const ecgi, const long rrc_cause,
+    const enb_ue_s1ap_id_t enb_ue_s1ap_id, STOLEN_REF bstring* nas_msg,
+    const tai_t* const tai, const ecgi_t* const ecgi, const long rrc_cause,
     const s_tmsi_t* const opt_s_tmsi, const csg_id_t* const opt_csg_id,
     const gummei_t* const opt_gummei,
     const void* const opt_cell_access_mode,           // unused
@@ -157,8 +156,8 @@ void s1ap_mme_itti_s1ap_initial_ue_message(
 
   OAILOG_FUNC_IN(LOG_S1AP);
   AssertFatal(
-      (nas_msg_length < 1000), "Bad length for NAS message %lu",
-      nas_msg_length);
+      (blength(*nas_msg) < 1000), "Bad length for NAS message %d",
+      blength(*nas_msg));
   message_p = itti_alloc_new_message(TASK_S1AP, S1AP_INITIAL_UE_MESSAGE);
   if (message_p == NULL) {
     OAILOG_ERROR(
@@ -179,7 +178,10 @@ void s1ap_mme_itti_s1ap_initial_ue_message(
   S1AP_INITIAL_UE_MESSAGE(message_p).enb_ue_s1ap_id = enb_ue_s1ap_id;
   S1AP_INITIAL_UE_MESSAGE(message_p).enb_id         = enb_id;
 
-  S1AP_INITIAL_UE_MESSAGE(message_p).nas = blk2bstr(nas_msg, nas_msg_length);
+  // The NAS PDU was stolen out of the decoded S1AP message by the caller;
+  // pass it along by reference rather than copying it again
+  S1AP_INITIAL_UE_MESSAGE(message_p).nas = *nas_msg;
+  *nas_msg                               = NULL;
 
   S1AP_INITIAL_UE_MESSAGE(message_p).tai = *tai;
 
@@ -57,8 +57,8 @@ status_code_e s1ap_mme_itti_nas_downlink_cnf(
 
 void s1ap_mme_itti_s1ap_initial_ue_message(
     const sctp_assoc_id_t assoc_id, const uint32_t enb_id,
-    const enb_ue_s1ap_id_t enb_ue_s1ap_id, const uint8_t* const nas_msg,
-    const size_t nas_msg_length, const tai_t* const tai,
+    const enb_ue_s1ap_id_t enb_ue_s1ap_id, STOLEN_REF bstring* nas_msg,
+    const tai_t* const tai,
     const ecgi_t* const ecgi, const long rrc_cause,
     const s_tmsi_t* const opt_s_tmsi, const csg_id_t* const opt_csg_id,
     const gummei_t* const opt_gummei,
@@ -38,6 +38,7 @@
 #include "s1ap_mme.h"
 #include "s1ap_mme_nas_procedures.h"
 #include "s1ap_mme_itti_messaging.h"
+#include "s1ap_ue_index.h"
 #include "service303.h"
 #include "3gpp_23.003.h"
 #include "3gpp_24.007.h"
@@ -248,9 +249,12 @@ status_code_e s1ap_mme_handle_initial_ue_message(
     S1AP_FIND_PROTOCOLIE_BY_ID(
         S1ap_InitialUEMessage_IEs_t, ie_cause, container,
         S1ap_ProtocolIE_ID_id_RRC_Establishment_Cause, true);
+    // The NAS PDU buffer moves out of the decoded PDU instead of being
+    // copied; the structure free after handling skips the stolen storage
+    bstring nas_pdu =
+        s1ap_octet_string_to_bstring_steal(&ie->value.choice.NAS_PDU);
     s1ap_mme_itti_s1ap_initial_ue_message(
-        assoc_id, eNB_ref->enb_id, ue_ref->enb_ue_s1ap_id,
-        ie->value.choice.NAS_PDU.buf, ie->value.choice.NAS_PDU.size, &tai,
+        assoc_id, eNB_ref->enb_id, ue_ref->enb_ue_s1ap_id, &nas_pdu, &tai,
         &ecgi, ie_cause->value.choice.RRC_Establishment_Cause,
         ie_e_tmsi ? &s_tmsi : NULL, ie_csg_id ? &csg_id : NULL,
         ie_gummei ? &gummei : NULL,
@@ -262,7 +266,7 @@ status_code_e s1ap_mme_handle_initial_ue_message(
   } else {
     imsi64_t imsi64                = INVALID_IMSI64;
     s1ap_imsi_map_t* s1ap_imsi_map = get_s1ap_imsi_map();
-    hashtable_uint64_ts_get(
+    hashtable_oa_uint64_ts_get(
         s1ap_imsi_map->mme_ue_id_imsi_htbl,
         (const hash_key_t) ue_ref->mme_ue_s1ap_id, &imsi64);
 
@@ -340,7 +344,7 @@ status_code_e s1ap_mme_handle_uplink_nas_transport(
           mme_ue_s1ap_id);
       imsi64_t imsi64                = INVALID_IMSI64;
       s1ap_imsi_map_t* s1ap_imsi_map = get_s1ap_imsi_map();
-      hashtable_uint64_ts_get(
+      hashtable_oa_uint64_ts_get(
           s1ap_imsi_map->mme_ue_id_imsi_htbl, (const hash_key_t) mme_ue_s1ap_id,
           &imsi64);
 
@@ -393,9 +397,8 @@ status_code_e s1ap_mme_handle_uplink_nas_transport(
   ecgi.cell_identity.enb_id = enb_ref->enb_id;
   // TODO optional GW Transport Layer Address
 
-  bstring b = blk2bstr(
-      ie_nas_pdu->value.choice.NAS_PDU.buf,
-      ie_nas_pdu->value.choice.NAS_PDU.size);
+  bstring b =
+      s1ap_octet_string_to_bstring_steal(&ie_nas_pdu->value.choice.NAS_PDU);
   s1ap_mme_itti_nas_uplink_ind(mme_ue_s1ap_id, &b, &tai, &ecgi);
   OAILOG_FUNC_RETURN(LOG_S1AP, RETURNok);
 }
@@ -471,7 +474,7 @@ status_code_e s1ap_mme_handle_nas_non_delivery(
   }
 
   s1ap_imsi_map_t* imsi_map = get_s1ap_imsi_map();
-  hashtable_uint64_ts_get(
+  hashtable_oa_uint64_ts_get(
       imsi_map->mme_ue_id_imsi_htbl, mme_ue_s1ap_id, &imsi64);
 
   if (ue_ref->s1_ue_state != S1AP_UE_CONNECTED) {
@@ -539,7 +542,7 @@ status_code_e s1ap_generate_downlink_nas_transport(
      * * * * Create new IE list message and encode it.
      */
     s1ap_imsi_map_t* imsi_map = get_s1ap_imsi_map();
-    if (hashtable_uint64_ts_insert(
+    if (hashtable_oa_uint64_ts_insert(
             imsi_map->mme_ue_id_imsi_htbl, (const hash_key_t) ue_id, imsi64) ==
         HASH_TABLE_SAME_KEY_VALUE_EXISTS) {
       *is_state_same = true;
@@ -613,8 +616,7 @@ status_code_e s1ap_generate_downlink_nas_transport(
         " MME_UE_S1AP_ID = " MME_UE_S1AP_ID_FMT
         " eNB_UE_S1AP_ID = " ENB_UE_S1AP_ID_FMT "\n",
         ue_id, ue_ref->mme_ue_s1ap_id, enb_ue_s1ap_id);
-    bstring b = blk2bstr(buffer_p, length);
-    free(buffer_p);
+    bstring b = s1ap_buffer_to_bstring(buffer_p, length);
     s1ap_mme_itti_send_sctp_request(
         &b, ue_ref->sctp_assoc_id, ue_ref->sctp_stream_send,
         ue_ref->mme_ue_s1ap_id);
@@ -851,8 +853,7 @@ status_code_e s1ap_generate_s1ap_e_rab_setup_req(
         " eNB_UE_S1AP_ID = " ENB_UE_S1AP_ID_FMT "\n",
         (mme_ue_s1ap_id_t) ue_ref->mme_ue_s1ap_id,
         (enb_ue_s1ap_id_t) ue_ref->enb_ue_s1ap_id);
-    bstring b = blk2bstr(buffer_p, length);
-    free(buffer_p);
+    bstring b = s1ap_buffer_to_bstring(buffer_p, length);
     s1ap_mme_itti_send_sctp_request(
         &b, ue_ref->sctp_assoc_id, ue_ref->sctp_stream_send,
         ue_ref->mme_ue_s1ap_id);
@@ -902,7 +903,7 @@ void s1ap_handle_conn_est_cnf(
 
   imsi64_t imsi64;
   s1ap_imsi_map_t* imsi_map = get_s1ap_imsi_map();
-  hashtable_uint64_ts_get(
+  hashtable_oa_uint64_ts_get(
       imsi_map->mme_ue_id_imsi_htbl, (const hash_key_t) conn_est_cnf_pP->ue_id,
       &imsi64);
 
@@ -1142,8 +1143,7 @@ void s1ap_handle_conn_est_cnf(
       "= " MME_UE_S1AP_ID_FMT " eNB_UE_S1AP_ID = " ENB_UE_S1AP_ID_FMT "\n",
       (mme_ue_s1ap_id_t) ue_ref->mme_ue_s1ap_id,
       (enb_ue_s1ap_id_t) ue_ref->enb_ue_s1ap_id);
-  bstring b = blk2bstr(buffer_p, length);
-  free(buffer_p);
+  bstring b = s1ap_buffer_to_bstring(buffer_p, length);
   s1ap_mme_itti_send_sctp_request(
       &b, ue_ref->sctp_assoc_id, ue_ref->sctp_stream_send,
       ue_ref->mme_ue_s1ap_id);
@@ -1176,6 +1176,7 @@ void s1ap_handle_mme_ue_id_notification(
       hashtable_uint64_ts_insert(
           &enb_ref->ue_id_coll, (const hash_key_t) mme_ue_s1ap_id,
           ue_ref->comp_s1ap_id);
+      s1ap_ue_index_insert(mme_ue_s1ap_id, ue_ref->comp_s1ap_id);
 
       OAILOG_DEBUG(
           LOG_S1AP, "Num elements in ue_id_coll %zu and num ue associated %u",
@@ -1337,8 +1338,7 @@ status_code_e s1ap_generate_s1ap_e_rab_rel_cmd(
         "= " MME_UE_S1AP_ID_FMT " eNB_UE_S1AP_ID = " ENB_UE_S1AP_ID_FMT "\n",
         (mme_ue_s1ap_id_t) ue_ref->mme_ue_s1ap_id,
         (enb_ue_s1ap_id_t) ue_ref->enb_ue_s1ap_id);
-    bstring b = blk2bstr(buffer_p, length);
-    free(buffer_p);
+    bstring b = s1ap_buffer_to_bstring(buffer_p, length);
     s1ap_mme_itti_send_sctp_request(
         &b, ue_ref->sctp_assoc_id, ue_ref->sctp_stream_send,
         ue_ref->mme_ue_s1ap_id);
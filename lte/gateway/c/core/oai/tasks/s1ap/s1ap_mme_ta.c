@@ -29,6 +29,7 @@
 #include "assertions.h"
 #include "conversions.h"
 #include "mme_config.h"
+#include "mme_tai_table.h"
 #include "mme_api.h"
 #include "s1ap_mme_ta.h"
 #include "S1ap_BPLMNs.h"
@@ -39,33 +40,19 @@
 #include "s1ap_types.h"
 
 static int s1ap_mme_compare_plmn(const S1ap_PLMNidentity_t* const plmn) {
-  int i            = 0;
   uint16_t mcc     = 0;
   uint16_t mnc     = 0;
   uint16_t mnc_len = 0;
 
   DevAssert(plmn != NULL);
   TBCD_TO_MCC_MNC(plmn, mcc, mnc, mnc_len);
-  mme_config_read_lock(&mme_config);
-
-  for (i = 0; i < mme_config.served_tai.nb_tai; i++) {
-    OAILOG_TRACE(
-        LOG_S1AP,
-        "Comparing plmn_mcc %d/%d, plmn_mnc %d/%d plmn_mnc_len %d/%d\n",
-        mme_config.served_tai.plmn_mcc[i], mcc,
-        mme_config.served_tai.plmn_mnc[i], mnc,
-        mme_config.served_tai.plmn_mnc_len[i], mnc_len);
-
-    if ((mme_config.served_tai.plmn_mcc[i] == mcc) &&
-        (mme_config.served_tai.plmn_mnc[i] == mnc) &&
-        (mme_config.served_tai.plmn_mnc_len[i] == mnc_len))
-      /*
-       * There is a matching plmn
-       */
-      return TA_LIST_AT_LEAST_ONE_MATCH;
-  }
 
-  mme_config_unlock(&mme_config);
+  // This runs for every broadcast plmn of every S1 setup and eNB
+  // configuration update; the lookup table rejects foreign PLMNs on a
+  // single load and never takes the config lock
+  if (mme_tai_table_plmn_served(mcc, mnc, mnc_len)) {
+    return TA_LIST_AT_LEAST_ONE_MATCH;
+  }
   return TA_LIST_NO_MATCH;
 }
 
@@ -94,23 +81,15 @@ static int s1ap_mme_compare_plmns(S1ap_BPLMNs_t* b_plmns) {
 /* @brief compare a TAC
  */
 static int s1ap_mme_compare_tac(const S1ap_TAC_t* const tac) {
-  int i              = 0;
   uint16_t tac_value = 0;
 
   DevAssert(tac != NULL);
   OCTET_STRING_TO_TAC(tac, tac_value);
-  mme_config_read_lock(&mme_config);
 
-  for (i = 0; i < mme_config.served_tai.nb_tai; i++) {
-    OAILOG_TRACE(
-        LOG_S1AP, "Comparing config tac %d, received tac = %d\n",
-        mme_config.served_tai.tac[i], tac_value);
-
-    if (mme_config.served_tai.tac[i] == tac_value)
-      return TA_LIST_AT_LEAST_ONE_MATCH;
+  // Lock-free table lookup, see s1ap_mme_compare_plmn
+  if (mme_tai_table_tac_served(tac_value)) {
+    return TA_LIST_AT_LEAST_ONE_MATCH;
   }
-
-  mme_config_unlock(&mme_config);
   return TA_LIST_NO_MATCH;
 }
 
@@ -28,6 +28,7 @@ extern "C" {
 #include "assertions.h"
 #include "common_defs.h"
 #include "dynamic_memory_check.h"
+#include "s1ap_ue_index.h"
 }
 
 #include "s1ap_state_manager.h"
@@ -36,6 +37,7 @@ using magma::lte::S1apStateManager;
 
 int s1ap_state_init(uint32_t max_ues, uint32_t max_enbs, bool use_stateless) {
   S1apStateManager::getInstance().init(max_ues, max_enbs, use_stateless);
+  s1ap_ue_index_init(max_ues);
   // remove UEs with unknown IMSI from eNB state
   remove_ues_without_imsi_from_ue_id_coll();
   return RETURNok;
@@ -46,6 +48,7 @@ s1ap_state_t* get_s1ap_state(bool read_from_db) {
 }
 
 void s1ap_state_exit() {
+  s1ap_ue_index_exit();
   S1apStateManager::getInstance().free_state();
 }
 
@@ -78,10 +81,29 @@ ue_description_t* s1ap_state_get_ue_mmeid(mme_ue_s1ap_id_t mme_ue_s1ap_id) {
   ue_description_t* ue = nullptr;
 
   hash_table_ts_t* state_ue_ht = get_s1ap_ue_state();
+
+  // Fast path: the flat index gives the composite id, turning the locked
+  // scan of every association into a single keyed get
+  uint64_t comp_s1ap_id = 0;
+  if (s1ap_ue_index_get(mme_ue_s1ap_id, &comp_s1ap_id)) {
+    hashtable_ts_get(
+        state_ue_ht, (const hash_key_t) comp_s1ap_id, (void**) &ue);
+    if (ue && (ue->mme_ue_s1ap_id == mme_ue_s1ap_id)) {
+      return ue;
+    }
+    // Stale entry, drop it and fall back to the scan
+    s1ap_ue_index_remove(mme_ue_s1ap_id);
+    ue = nullptr;
+  }
+
   hashtable_ts_apply_callback_on_elements(
       (hash_table_ts_t* const) state_ue_ht, s1ap_ue_compare_by_mme_ue_id_cb,
       &mme_ue_s1ap_id, (void**) &ue);
 
+  if (ue) {
+    // Self-heal: index associations created before the index knew them
+    s1ap_ue_index_insert(mme_ue_s1ap_id, ue->comp_s1ap_id);
+  }
   return ue;
 }
 
@@ -127,7 +149,7 @@ bool s1ap_ue_compare_by_imsi(
   ue_description_t* ue_ref = (ue_description_t*) elementP;
 
   s1ap_imsi_map_t* imsi_map = get_s1ap_imsi_map();
-  hashtable_uint64_ts_get(
+  hashtable_oa_uint64_ts_get(
       imsi_map->mme_ue_id_imsi_htbl, (const hash_key_t) ue_ref->mme_ue_s1ap_id,
       &imsi64);
 
@@ -218,7 +240,7 @@ void remove_ues_without_imsi_from_ue_id_coll() {
     for (uint32_t i = 0; i < num_ues_checked; i++) {
       hashtable_uint64_ts_remove(
           &enb_association_p->ue_id_coll, mme_ue_id_no_imsi_list[i]);
-      hashtable_uint64_ts_remove(
+      hashtable_oa_uint64_ts_remove(
           s1ap_imsi_map->mme_ue_id_imsi_htbl, mme_ue_id_no_imsi_list[i]);
       enb_association_p->nb_ue_associated--;
 
@@ -28,11 +28,16 @@ S1apStateConverter::~S1apStateConverter() = default;
 S1apStateConverter::S1apStateConverter()  = default;
 
 void S1apStateConverter::state_to_proto(s1ap_state_t* state, S1apState* proto) {
-  proto->Clear();
+  state_to_proto_without_enbs(state, proto);
 
   // copy over enbs
   hashtable_ts_to_proto<enb_description_t, EnbDescription>(
       &state->enbs, proto->mutable_enbs(), enb_to_proto, LOG_S1AP);
+}
+
+void S1apStateConverter::state_to_proto_without_enbs(
+    s1ap_state_t* state, S1apState* proto) {
+  proto->Clear();
 
   // copy over mmeid2associd
   hashtable_rc_t ht_rc;
@@ -219,13 +224,13 @@ void S1apStateConverter::proto_to_ue(
 
 void S1apStateConverter::s1ap_imsi_map_to_proto(
     const s1ap_imsi_map_t* s1ap_imsi_map, oai::S1apImsiMap* s1ap_imsi_proto) {
-  hashtable_uint64_ts_to_proto(
+  hashtable_oa_uint64_ts_to_proto(
       s1ap_imsi_map->mme_ue_id_imsi_htbl,
       s1ap_imsi_proto->mutable_mme_ue_id_imsi_map());
 }
 void S1apStateConverter::proto_to_s1ap_imsi_map(
     const oai::S1apImsiMap& s1ap_imsi_proto, s1ap_imsi_map_t* s1ap_imsi_map) {
-  proto_to_hashtable_uint64_ts(
+  proto_to_hashtable_oa_uint64_ts(
       s1ap_imsi_proto.mme_ue_id_imsi_map(), s1ap_imsi_map->mme_ue_id_imsi_htbl);
 }
 
@@ -46,6 +46,13 @@ class S1apStateConverter : StateConverter {
 
   static void proto_to_state(const oai::S1apState& proto, s1ap_state_t* state);
 
+  /**
+   * Serializes everything but the eNB map (mmeid2associd, num_enbs), used by
+   * the per-association persistence path where each eNB gets its own record
+   */
+  static void state_to_proto_without_enbs(
+      s1ap_state_t* state, oai::S1apState* proto);
+
   /**
    * Serializes s1ap_imsi_map_t to S1apImsiMap proto
    */
@@ -16,12 +16,17 @@
  */
 
 #include "s1ap_state_manager.h"
+
+#include <unordered_set>
+#include <vector>
+
 #include "common_defs.h"
 
 namespace {
 constexpr char S1AP_ENB_COLL[]             = "s1ap_eNB_coll";
 constexpr char S1AP_MME_ID2ASSOC_ID_COLL[] = "s1ap_mme_id2assoc_id_coll";
 constexpr char S1AP_IMSI_MAP_TABLE_NAME[]  = "s1ap_imsi_map";
+constexpr char S1AP_ENB_ASSOC_INFIX[]      = ":assoc_";
 }  // namespace
 
 using magma::lte::oai::UeDescription;
@@ -127,6 +132,147 @@ void S1apStateManager::free_state() {
   clear_s1ap_imsi_map();
 }
 
+std::string S1apStateManager::enb_assoc_key(sctp_assoc_id_t assoc_id) const {
+  return table_key + S1AP_ENB_ASSOC_INFIX + std::to_string(assoc_id);
+}
+
+status_code_e S1apStateManager::read_state_from_db() {
+  if (!persist_state_enabled) {
+    return RETURNok;
+  }
+
+  // Slim record first: mmeid2associd and num_enbs. Legacy records written
+  // before per-association sharding still carry the full eNB map and restore
+  // through the same proto_to_state call
+  oai::S1apState state_proto = oai::S1apState();
+  if (redis_client->read_proto(table_key, state_proto) != RETURNok) {
+    OAILOG_DEBUG(LOG_S1AP, "Failed to read proto from db \n");
+    return RETURNerror;
+  }
+  this->task_state_version = redis_client->read_version(table_key);
+  S1apStateConverter::proto_to_state(state_proto, state_cache_p);
+
+  // Overlay one record per eNB association
+  auto keys = redis_client->get_keys(table_key + S1AP_ENB_ASSOC_INFIX + "*");
+  for (const auto& key : keys) {
+    OAILOG_DEBUG(log_task, "Reading eNB state from db for %s", key.c_str());
+    oai::EnbDescription enb_proto = oai::EnbDescription();
+    if (redis_client->read_proto(key, enb_proto) != RETURNok) {
+      return RETURNerror;
+    }
+
+    auto* enb = (enb_description_t*) calloc(1, sizeof(enb_description_t));
+    S1apStateConverter::proto_to_enb(enb_proto, enb);
+    hashtable_rc_t ht_rc = hashtable_ts_insert(
+        &state_cache_p->enbs, (hash_key_t) enb->sctp_assoc_id, (void*) enb);
+    if (ht_rc != HASH_TABLE_OK) {
+      OAILOG_ERROR(
+          log_task, "Failed to insert eNB state with assoc_id %u (%s)",
+          enb->sctp_assoc_id, hashtable_rc_code2string(ht_rc));
+      hashtable_uint64_ts_destroy(&enb->ue_id_coll);
+      free_wrapper((void**) &enb);
+      continue;
+    }
+
+    // Remember the stored form so an unchanged association is not rewritten
+    // on the next sync
+    std::string proto_str;
+    redis_client->serialize(enb_proto, proto_str);
+    enb_state_hash_[key]    = std::hash<std::string>{}(proto_str);
+    enb_state_version_[key] = redis_client->read_version(key);
+  }
+
+  hashtable_key_array_t* enb_keys = hashtable_ts_get_keys(&state_cache_p->enbs);
+  state_cache_p->num_enbs         = 0;
+  if (enb_keys) {
+    state_cache_p->num_enbs = enb_keys->num_keys;
+    FREE_HASHTABLE_KEY_ARRAY(enb_keys);
+  }
+  return RETURNok;
+}
+
+void S1apStateManager::write_state_to_db() {
+  AssertFatal(
+      is_initialized,
+      "S1apStateManager init() function should be called to initialize state.");
+
+  if (!state_dirty) {
+    OAILOG_ERROR(log_task, "Tried to put state while it was not in use");
+    return;
+  }
+  if (!persist_state_enabled) {
+    return;
+  }
+
+  // Slim record: everything but the eNB map, which is sharded below so a
+  // change on one association does not reserialize every connected eNB
+  oai::S1apState state_proto = oai::S1apState();
+  S1apStateConverter::state_to_proto_without_enbs(state_cache_p, &state_proto);
+  std::string proto_str;
+  redis_client->serialize(state_proto, proto_str);
+  std::size_t new_hash = std::hash<std::string>{}(proto_str);
+  if (new_hash != this->task_state_hash) {
+    if (redis_client->write_proto_str(
+            table_key, proto_str, this->task_state_version) != RETURNok) {
+      OAILOG_ERROR(log_task, "Failed to write state to db");
+      return;
+    }
+    this->task_state_version++;
+    this->task_state_hash = new_hash;
+  }
+
+  // One record per eNB association, rewritten only when its serialized form
+  // changed since the last sync
+  std::unordered_set<std::string> live_keys;
+  hashtable_key_array_t* keys = hashtable_ts_get_keys(&state_cache_p->enbs);
+  if (keys) {
+    for (int i = 0; i < keys->num_keys; i++) {
+      enb_description_t* enb = nullptr;
+      hashtable_rc_t ht_rc   = hashtable_ts_get(
+          &state_cache_p->enbs, keys->keys[i], (void**) &enb);
+      AssertFatal(ht_rc == HASH_TABLE_OK, "eNB entry not in enbs hashtable");
+
+      oai::EnbDescription enb_proto = oai::EnbDescription();
+      S1apStateConverter::enb_to_proto(enb, &enb_proto);
+      std::string enb_str;
+      redis_client->serialize(enb_proto, enb_str);
+      std::size_t enb_hash = std::hash<std::string>{}(enb_str);
+
+      std::string key = enb_assoc_key(enb->sctp_assoc_id);
+      live_keys.insert(key);
+      auto hash_it = enb_state_hash_.find(key);
+      if (hash_it != enb_state_hash_.end() && hash_it->second == enb_hash) {
+        continue;
+      }
+      if (redis_client->write_proto_str(
+              key, enb_str, enb_state_version_[key]) != RETURNok) {
+        OAILOG_ERROR(
+            log_task, "Failed to write eNB state to db for %s", key.c_str());
+        continue;
+      }
+      enb_state_version_[key]++;
+      enb_state_hash_[key] = enb_hash;
+    }
+    FREE_HASHTABLE_KEY_ARRAY(keys);
+  }
+
+  // Drop records of associations that no longer exist
+  std::vector<std::string> stale_keys;
+  for (const auto& kv : enb_state_hash_) {
+    if (live_keys.find(kv.first) == live_keys.end()) {
+      stale_keys.push_back(kv.first);
+    }
+  }
+  if (!stale_keys.empty()) {
+    redis_client->clear_keys(stale_keys);
+    for (const auto& key : stale_keys) {
+      enb_state_hash_.erase(key);
+      enb_state_version_.erase(key);
+    }
+  }
+  this->state_dirty = false;
+}
+
 status_code_e S1apStateManager::read_ue_state_from_db() {
   if (!persist_state_enabled) {
     return RETURNok;
@@ -170,7 +316,7 @@ void S1apStateManager::create_s1ap_imsi_map() {
   s1ap_imsi_map_ = (s1ap_imsi_map_t*) calloc(1, sizeof(s1ap_imsi_map_t));
 
   s1ap_imsi_map_->mme_ue_id_imsi_htbl =
-      hashtable_uint64_ts_create(max_ues_, nullptr, nullptr);
+      hashtable_oa_uint64_ts_create(max_ues_, nullptr, nullptr);
 
   if (persist_state_enabled) {
     oai::S1apImsiMap imsi_proto = oai::S1apImsiMap();
@@ -184,7 +330,7 @@ void S1apStateManager::clear_s1ap_imsi_map() {
   if (!s1ap_imsi_map_) {
     return;
   }
-  hashtable_uint64_ts_destroy(s1ap_imsi_map_->mme_ue_id_imsi_htbl);
+  hashtable_oa_uint64_ts_destroy(s1ap_imsi_map_->mme_ue_id_imsi_htbl);
 
   free_wrapper((void**) &s1ap_imsi_map_);
 }
@@ -80,6 +80,19 @@ class S1apStateManager
    */
   status_code_e read_ue_state_from_db() override;
 
+  /**
+   * Reads the slim task state record, then overlays one record per eNB
+   * association; legacy whole-state records restore through the same path
+   * @return operation response code
+   */
+  status_code_e read_state_from_db() override;
+
+  /**
+   * Writes the slim task state record plus one record per eNB association,
+   * only rewriting associations whose serialized form changed
+   */
+  void write_state_to_db() override;
+
   /**
    * Serializes s1ap_imsi_map to proto and saves it into data store
    */
@@ -102,10 +115,15 @@ class S1apStateManager
   void create_s1ap_imsi_map();
   void clear_s1ap_imsi_map();
 
+  std::string enb_assoc_key(sctp_assoc_id_t assoc_id) const;
+
   uint32_t max_ues_;
   uint32_t max_enbs_;
   std::size_t s1ap_imsi_map_hash_;
   s1ap_imsi_map_t* s1ap_imsi_map_;
+  // Per-association record bookkeeping, keyed by the redis key
+  std::unordered_map<std::string, std::size_t> enb_state_hash_;
+  std::unordered_map<std::string, uint64_t> enb_state_version_;
 };
 }  // namespace lte
 }  // namespace magma
@@ -0,0 +1,128 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include "s1ap_ue_index.h"
+
+#include <stdlib.h>
+
+#include "dynamic_memory_check.h"
+
+/* Empty slots hold INVALID_MME_UE_S1AP_ID (0); removed slots hold the
+ * tombstone so probe chains across them stay intact. Tombstones are reused
+ * by inserts, which keeps the table from silting up under UE churn. */
+#define S1AP_UE_INDEX_TOMBSTONE 0xFFFFFFFF
+
+typedef struct s1ap_ue_index_entry_s {
+  mme_ue_s1ap_id_t mme_ue_s1ap_id;
+  uint64_t comp_s1ap_id;
+} s1ap_ue_index_entry_t;
+
+static s1ap_ue_index_entry_t* ue_index = NULL;
+static uint32_t ue_index_mask          = 0;
+
+//------------------------------------------------------------------------------
+static uint32_t s1ap_ue_index_hash(mme_ue_s1ap_id_t mme_ue_s1ap_id) {
+  // Fibonacci multiplicative hash; ids are sequential, so spread them.
+  // Fold the high bits down before masking, otherwise ids a multiple of
+  // the capacity apart land in the same slot
+  uint32_t h = mme_ue_s1ap_id * 2654435761u;
+  h ^= h >> 16;
+  return h & ue_index_mask;
+}
+
+//------------------------------------------------------------------------------
+void s1ap_ue_index_init(uint32_t max_ues) {
+  uint32_t capacity = 1;
+
+  while (capacity < (2 * max_ues)) {
+    capacity <<= 1;
+  }
+  s1ap_ue_index_exit();
+  ue_index      = calloc(capacity, sizeof(s1ap_ue_index_entry_t));
+  ue_index_mask = capacity - 1;
+}
+
+//------------------------------------------------------------------------------
+void s1ap_ue_index_exit(void) {
+  if (ue_index) {
+    free_wrapper((void**) &ue_index);
+    ue_index_mask = 0;
+  }
+}
+
+//------------------------------------------------------------------------------
+void s1ap_ue_index_insert(
+    mme_ue_s1ap_id_t mme_ue_s1ap_id, uint64_t comp_s1ap_id) {
+  if ((!ue_index) || (mme_ue_s1ap_id == INVALID_MME_UE_S1AP_ID) ||
+      (mme_ue_s1ap_id == S1AP_UE_INDEX_TOMBSTONE)) {
+    return;
+  }
+  uint32_t slot = s1ap_ue_index_hash(mme_ue_s1ap_id);
+  for (uint32_t probe = 0; probe <= ue_index_mask; probe++) {
+    s1ap_ue_index_entry_t* entry = &ue_index[slot];
+    if ((entry->mme_ue_s1ap_id == INVALID_MME_UE_S1AP_ID) ||
+        (entry->mme_ue_s1ap_id == S1AP_UE_INDEX_TOMBSTONE) ||
+        (entry->mme_ue_s1ap_id == mme_ue_s1ap_id)) {
+      entry->mme_ue_s1ap_id = mme_ue_s1ap_id;
+      entry->comp_s1ap_id   = comp_s1ap_id;
+      return;
+    }
+    slot = (slot + 1) & ue_index_mask;
+  }
+  // Table full: drop the entry, lookups fall back to the scan
+}
+
+//------------------------------------------------------------------------------
+void s1ap_ue_index_remove(mme_ue_s1ap_id_t mme_ue_s1ap_id) {
+  if ((!ue_index) || (mme_ue_s1ap_id == INVALID_MME_UE_S1AP_ID)) {
+    return;
+  }
+  uint32_t slot = s1ap_ue_index_hash(mme_ue_s1ap_id);
+  for (uint32_t probe = 0; probe <= ue_index_mask; probe++) {
+    s1ap_ue_index_entry_t* entry = &ue_index[slot];
+    if (entry->mme_ue_s1ap_id == mme_ue_s1ap_id) {
+      entry->mme_ue_s1ap_id = S1AP_UE_INDEX_TOMBSTONE;
+      entry->comp_s1ap_id   = 0;
+      return;
+    }
+    if (entry->mme_ue_s1ap_id == INVALID_MME_UE_S1AP_ID) {
+      return;  // end of probe chain, id was never indexed
+    }
+    slot = (slot + 1) & ue_index_mask;
+  }
+}
+
+//------------------------------------------------------------------------------
+bool s1ap_ue_index_get(
+    mme_ue_s1ap_id_t mme_ue_s1ap_id, uint64_t* comp_s1ap_id) {
+  if ((!ue_index) || (mme_ue_s1ap_id == INVALID_MME_UE_S1AP_ID)) {
+    return false;
+  }
+  uint32_t slot = s1ap_ue_index_hash(mme_ue_s1ap_id);
+  for (uint32_t probe = 0; probe <= ue_index_mask; probe++) {
+    s1ap_ue_index_entry_t* entry = &ue_index[slot];
+    if (entry->mme_ue_s1ap_id == mme_ue_s1ap_id) {
+      *comp_s1ap_id = entry->comp_s1ap_id;
+      return true;
+    }
+    if (entry->mme_ue_s1ap_id == INVALID_MME_UE_S1AP_ID) {
+      return false;  // end of probe chain
+    }
+    slot = (slot + 1) & ue_index_mask;
+  }
+  return false;
+}
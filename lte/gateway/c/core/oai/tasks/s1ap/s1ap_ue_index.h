@@ -0,0 +1,62 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#ifndef FILE_S1AP_UE_INDEX_SEEN
+#define FILE_S1AP_UE_INDEX_SEEN
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common_types.h"
+
+/* Flat open-addressed index from mme_ue_s1ap_id to the composite UE id,
+ * maintained alongside the per-eNB ue_id_coll tables. It turns
+ * s1ap_state_get_ue_mmeid() from a locked scan of every UE association
+ * into one probe of a flat array followed by one keyed hashtable get.
+ *
+ * The index is owned by the s1ap task thread like the rest of the s1ap
+ * state; no locking is needed. It is advisory only: a missed insert or
+ * remove is self-healed by the caller falling back to the scan and
+ * re-inserting, so entries never need to be exact, just usually right.
+ */
+
+/** \brief Size the index; capacity is rounded up to a power of two holding
+ * at least twice max_ues so probe chains stay short
+ **/
+void s1ap_ue_index_init(uint32_t max_ues);
+
+/** \brief Release the index storage on task termination
+ **/
+void s1ap_ue_index_exit(void);
+
+/** \brief Record the composite UE id under a mme_ue_s1ap_id; a full index
+ * drops the entry silently (lookups then fall back to the scan)
+ **/
+void s1ap_ue_index_insert(
+    mme_ue_s1ap_id_t mme_ue_s1ap_id, uint64_t comp_s1ap_id);
+
+/** \brief Drop the entry for a mme_ue_s1ap_id, if present
+ **/
+void s1ap_ue_index_remove(mme_ue_s1ap_id_t mme_ue_s1ap_id);
+
+/** \brief Look up the composite UE id recorded for a mme_ue_s1ap_id
+ * @returns true and fills comp_s1ap_id on a hit, false otherwise
+ **/
+bool s1ap_ue_index_get(
+    mme_ue_s1ap_id_t mme_ue_s1ap_id, uint64_t* comp_s1ap_id);
+
+#endif /* FILE_S1AP_UE_INDEX_SEEN */
@@ -23,8 +23,12 @@
 #include "itti_types.h"
 #include "s6a_defs.h"
 #include "s6a_messages_types.h"
+#include "s6a_subscription_cache.h"
 
 int delete_subscriber_request(const char* imsi, const uint imsi_len) {
+  // The HSS withdrew or changed this subscription, the cached profile is
+  // stale from here on
+  s6a_subscription_cache_invalidate(imsi);
   // send it to MME module for further processing
   MessageDef* message_p                                = NULL;
   s6a_cancel_location_req_t* s6a_cancel_location_req_p = NULL;
@@ -41,6 +45,8 @@ int delete_subscriber_request(const char* imsi, const uint imsi_len) {
 }
 
 void handle_reset_request(void) {
+  // Any profile may have changed while the HSS was down
+  s6a_subscription_cache_clear();
   // send it to MME module for further processing
   MessageDef* message_p = NULL;
   message_p = DEPRECATEDitti_alloc_new_message_fatal(TASK_S6A, S6A_RESET_REQ);
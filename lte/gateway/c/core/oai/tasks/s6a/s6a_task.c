@@ -41,6 +41,7 @@
 #include "assertions.h"
 #include "intertask_interface.h"
 #include "itti_free_defined_msg.h"
+#include "itti_msg_batch.h"
 #include "common_defs.h"
 #include "s6a_defs.h"
 #include "s6a_messages.h"
@@ -147,9 +148,23 @@ static void* s6a_thread(void* args) {
 }
 
 //------------------------------------------------------------------------------
+// Pooled envelopes backing the batched delivery of gRPC-origin answers to
+// MME_APP (see itti_msg_batch.h); sized so an HSS reconnect flood does not
+// fall back to per-message mallocs right away
+#define S6A_ANSWER_POOL_ITEMS 128
+
 status_code_e s6a_init(const mme_config_t* mme_config_p) {
   OAILOG_DEBUG(LOG_S6A, "Initializing S6a interface\n");
 
+  uint32_t max_answer_size = sizeof(s6a_auth_info_ans_t);
+  if (sizeof(s6a_update_location_ans_t) > max_answer_size) {
+    max_answer_size = sizeof(s6a_update_location_ans_t);
+  }
+  if (itti_batch_init(S6A_ANSWER_POOL_ITEMS, max_answer_size) != RETURNok) {
+    OAILOG_ERROR(LOG_S6A, "Failed to initialize the s6a answer pool\n");
+    return RETURNerror;
+  }
+
   if (itti_create_task(
           TASK_S6A, &s6a_thread, (void*) &mme_config_p->s6a_config) < 0) {
     OAILOG_ERROR(LOG_S6A, "s6a create task\n");
@@ -26,16 +26,20 @@ extern "C" {
 #include "sctp_itti_messaging.h"
 }
 
+#include <atomic>
 #include <memory>
 
 #include <grpcpp/grpcpp.h>
 
 #include <lte/protos/sctpd.grpc.pb.h>
 
+#include "sctp_ul_shm_pool.h"
+
 namespace magma {
 namespace mme {
 
 using grpc::ServerContext;
+using grpc::ServerReader;
 using grpc::Status;
 
 using magma::sctpd::CloseAssocReq;
@@ -52,6 +56,9 @@ class SctpdUplinkImpl final : public SctpdUplink::Service {
 
   Status SendUl(
       ServerContext* context, const SendUlReq* req, SendUlRes* res) override;
+  Status SendUlStream(
+      ServerContext* context, ServerReader<SendUlReq>* reader,
+      SendUlRes* res) override;
   Status NewAssoc(
       ServerContext* context, const NewAssocReq* req,
       NewAssocRes* res) override;
@@ -62,6 +69,57 @@ class SctpdUplinkImpl final : public SctpdUplink::Service {
 
 SctpdUplinkImpl::SctpdUplinkImpl() {}
 
+// Recover the PDU bytes of an uplink request: either from the shm slot the
+// descriptor names (releasing the slot back to sctpd once copied) or from
+// the inline payload field. Returns NULL on allocation failure or a corrupt
+// descriptor.
+static bstring payload_from_ul_req(const SendUlReq& req) {
+  if (req.shm_length() > 0) {
+    // The descriptor implies sctpd created the segment, but the first
+    // descriptors can race its creation; keep retrying the attach instead
+    // of freezing one failed attempt. The geometry check rejects a
+    // mismatched peer.
+    static std::atomic<sctpd::SctpUlShmPool*> ul_shm_pool{nullptr};
+    sctpd::SctpUlShmPool* pool = ul_shm_pool.load(std::memory_order_acquire);
+    if (pool == nullptr) {
+      pool = sctpd::sctp_ul_shm_attach();
+      if (pool == nullptr) {
+        OAILOG_ERROR(LOG_SCTP, "failed to attach the uplink shm pool\n");
+        return NULL;
+      }
+      sctpd::SctpUlShmPool* expected = nullptr;
+      if (!ul_shm_pool.compare_exchange_strong(
+              expected, pool, std::memory_order_release,
+              std::memory_order_acquire)) {
+        // Another handler thread attached first; keep its mapping
+        munmap(pool, sizeof(sctpd::SctpUlShmPool));
+        pool = expected;
+      }
+    }
+
+    uint32_t length     = 0;
+    const uint8_t* data =
+        sctpd::sctp_ul_shm_read(pool, req.shm_index(), &length);
+    if ((data == NULL) || (length != req.shm_length())) {
+      OAILOG_ERROR(
+          LOG_SCTP, "corrupt uplink shm descriptor (slot %u, length %u)\n",
+          req.shm_index(), req.shm_length());
+      // An in-range index still names a claimed slot; hand it back so a
+      // corrupt descriptor does not leak it on the sctpd side
+      if (req.shm_index() < sctpd::SCTP_UL_SHM_SLOTS) {
+        sctpd::sctp_ul_shm_release(pool, req.shm_index());
+      }
+      return NULL;
+    }
+
+    bstring payload = blk2bstr(data, length);
+    sctpd::sctp_ul_shm_release(pool, req.shm_index());
+    return payload;
+  }
+
+  return blk2bstr(req.payload().c_str(), req.payload().size());
+}
+
 Status SctpdUplinkImpl::SendUl(
     ServerContext* context, const SendUlReq* req, SendUlRes* res) {
   bstring payload;
@@ -69,7 +127,7 @@ Status SctpdUplinkImpl::SendUl(
   uint32_t assoc_id;
   uint16_t stream;
 
-  payload = blk2bstr(req->payload().c_str(), req->payload().size());
+  payload = payload_from_ul_req(*req);
   if (payload == NULL) {
     OAILOG_ERROR(LOG_SCTP, "failed to allocate bstr for SendUl\n");
     return Status::OK;
@@ -87,6 +145,27 @@ Status SctpdUplinkImpl::SendUl(
   return Status::OK;
 }
 
+Status SctpdUplinkImpl::SendUlStream(
+    ServerContext* context, ServerReader<SendUlReq>* reader, SendUlRes* res) {
+  SendUlReq req;
+
+  while (reader->Read(&req)) {
+    bstring payload = payload_from_ul_req(req);
+    if (payload == NULL) {
+      OAILOG_ERROR(LOG_SCTP, "failed to allocate bstr for SendUlStream\n");
+      continue;
+    }
+
+    if (sctp_itti_send_new_message_ind(
+            &payload, req.ppid(), req.assoc_id(), req.stream()) < 0) {
+      OAILOG_ERROR(
+          LOG_SCTP, "failed to send new_message_ind for SendUlStream\n");
+    }
+  }
+
+  return Status::OK;
+}
+
 #include <assert.h>
 
 Status SctpdUplinkImpl::NewAssoc(
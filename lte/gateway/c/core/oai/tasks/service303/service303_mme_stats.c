@@ -17,6 +17,12 @@
 #define SERVICE303
 
 #include <stddef.h>
+#include <stdint.h>
+
+#if USE_JEMALLOC
+#include <jemalloc/jemalloc.h>
+#endif
+
 #include "log.h"
 #include "service303.h"
 
@@ -27,6 +33,15 @@ void service303_mme_app_statistics_read(
   set_gauge("ue_connected", stats_msg_p->nb_ue_connected, label);
   set_gauge("default_eps_bearers", stats_msg_p->nb_default_eps_bearers, label);
   set_gauge("s1u_bearers", stats_msg_p->nb_s1u_bearers, label);
+  set_gauge(
+      "ue_context_htbl_buckets", stats_msg_p->nb_ue_context_htbl_buckets,
+      label);
+  set_gauge(
+      "ue_context_htbl_elements", stats_msg_p->nb_ue_context_htbl_elements,
+      label);
+  set_gauge(
+      "ue_context_htbl_max_chain", stats_msg_p->ue_context_htbl_max_chain,
+      label);
 }
 
 void service303_s1ap_statistics_read(
@@ -35,6 +50,24 @@ void service303_s1ap_statistics_read(
   set_gauge("enb_connected", stats_msg_p->nb_enb_connected, label);
 }
 
+void service303_allocator_statistics_read(void) {
+#if USE_JEMALLOC
+  size_t label         = 0;
+  size_t allocated     = 0;
+  size_t resident      = 0;
+  size_t allocated_len = sizeof(allocated);
+  size_t resident_len  = sizeof(resident);
+  uint64_t epoch       = 1;
+
+  // Advance the stats epoch so the merged counters below are current
+  mallctl("epoch", NULL, NULL, &epoch, sizeof(epoch));
+  mallctl("stats.allocated", &allocated, &allocated_len, NULL, 0);
+  mallctl("stats.resident", &resident, &resident_len, NULL, 0);
+  set_gauge("heap_allocated_bytes", allocated, label);
+  set_gauge("heap_resident_bytes", resident, label);
+#endif
+}
+
 void service303_statistics_display(void) {
   size_t label = 0;
   OAILOG_DEBUG(
@@ -25,6 +25,9 @@
 #include "service303.h"
 #include "bstrlib.h"
 #include "intertask_interface_types.h"
+#include "itti_latency.h"
+#include "itti_shed.h"
+#include "itti_watchdog.h"
 #include "itti_types.h"
 #include "itti_free_defined_msg.h"
 
@@ -155,8 +158,31 @@ static void service303_message_exit(void) {
   pthread_exit(NULL);
 }
 
+static void report_itti_latency_quantile(
+    const char* task_name, const char* message_name, const char* stage,
+    const char* quantile, double value_us) {
+  set_gauge(
+      "itti_message_latency_us", value_us, 4, "task", task_name, "message",
+      message_name, "stage", stage, "quantile", quantile);
+}
+
+static void report_itti_queue_stats(
+    const char* task_name, double queue_depth, double shed_total) {
+  set_gauge("itti_queue_depth", queue_depth, 1, "task", task_name);
+  set_gauge("itti_messages_shed", shed_total, 1, "task", task_name);
+}
+
+static void report_itti_stall_stats(
+    const char* task_name, double stall_total) {
+  set_gauge("itti_task_stalls", stall_total, 1, "task", task_name);
+}
+
 static int handle_display_timer(zloop_t* loop, int id, void* arg) {
+  service303_allocator_statistics_read();
   service303_statistics_display();
+  itti_latency_export_stats(report_itti_latency_quantile);
+  itti_shed_export_stats(report_itti_queue_stats);
+  itti_watchdog_export_stats(report_itti_stall_stats);
   return 0;
 }
 
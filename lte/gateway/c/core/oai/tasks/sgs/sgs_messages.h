@@ -34,6 +34,9 @@ int sgs_send_tmsi_reallocation_complete(
 int sgs_send_service_request(
     itti_sgsap_service_request_t* const sgs_service_request_p);
 
+int sgs_enqueue_paging_request(
+    const itti_sgsap_paging_request_t* const sgs_paging_req_p);
+
 int sgs_send_paging_reject(
     itti_sgsap_paging_reject_t* const sgs_paging_reject_p);
 
@@ -25,14 +25,194 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #include "intertask_interface.h"
 #include "log.h"
 #include "assertions.h"
+#include "common_defs.h"
 #include "sgs_messages_types.h"
 #include "sgs_messages.h"
 #include "conversions.h"
 
+/* Paging coalescing: SGs paging indications from the MSC/VLR are buffered,
+ * deduplicated per UE and drained toward mme_app once per tick, with an
+ * optional token bucket pacing the drain so an MT-call burst cannot starve
+ * the nas task. The tick can be overridden with the
+ * MAGMA_SGS_PAGING_BATCH_TICK_MSEC environment variable; a tick of zero
+ * disables coalescing and forwards each page on its own. The pacing rate in
+ * pages per second comes from MAGMA_SGS_PAGING_RATE_PPS; zero or unset
+ * leaves the drain unpaced. Only touched from the sgs task thread. */
+#define SGS_PAGING_BATCH_MAX_UES 64
+#define SGS_PAGING_BATCH_TICK_MSEC 20
+#define SGS_PAGING_TIMER_INACTIVE_ID (-1)
+
+static itti_sgsap_paging_request_t
+    pending_sgs_paging_requests[SGS_PAGING_BATCH_MAX_UES];
+static uint16_t pending_sgs_paging_count = 0;
+static int sgs_paging_tick_timer_id      = SGS_PAGING_TIMER_INACTIVE_ID;
+
+/* Token bucket state, held in thousandths of a page so refills stay exact
+ * for rates below one page per tick */
+static long sgs_paging_tokens_x1000           = 0;
+static struct timespec sgs_paging_last_refill = {0};
+
+//------------------------------------------------------------------------------
+static long sgs_paging_batch_tick_msec(void) {
+  static long tick_msec = -1;
+  if (tick_msec < 0) {
+    const char* env = getenv("MAGMA_SGS_PAGING_BATCH_TICK_MSEC");
+    tick_msec = (env != NULL) ? atol(env) : SGS_PAGING_BATCH_TICK_MSEC;
+    if (tick_msec < 0) {
+      tick_msec = SGS_PAGING_BATCH_TICK_MSEC;
+    }
+  }
+  return tick_msec;
+}
+
+//------------------------------------------------------------------------------
+static long sgs_paging_rate_pps(void) {
+  static long rate_pps = -1;
+  if (rate_pps < 0) {
+    const char* env = getenv("MAGMA_SGS_PAGING_RATE_PPS");
+    rate_pps        = (env != NULL) ? atol(env) : 0;
+    if (rate_pps < 0) {
+      rate_pps = 0;
+    }
+  }
+  return rate_pps;
+}
+
+//------------------------------------------------------------------------------
+static long sgs_paging_token_bucket_take(long wanted) {
+  long rate_pps = sgs_paging_rate_pps();
+  long granted  = wanted;
+  struct timespec now;
+
+  if (rate_pps == 0) {
+    return wanted;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  if ((sgs_paging_last_refill.tv_sec == 0) &&
+      (sgs_paging_last_refill.tv_nsec == 0)) {
+    // First page since startup: start from a full bucket
+    sgs_paging_tokens_x1000 = rate_pps * 1000;
+    sgs_paging_last_refill  = now;
+  }
+  long elapsed_msec =
+      (now.tv_sec - sgs_paging_last_refill.tv_sec) * 1000 +
+      (now.tv_nsec - sgs_paging_last_refill.tv_nsec) / 1000000;
+  if (elapsed_msec > 0) {
+    sgs_paging_tokens_x1000 += rate_pps * elapsed_msec;
+    // Bucket depth is one second worth of pages
+    if (sgs_paging_tokens_x1000 > rate_pps * 1000) {
+      sgs_paging_tokens_x1000 = rate_pps * 1000;
+    }
+    sgs_paging_last_refill = now;
+  }
+  if (granted > sgs_paging_tokens_x1000 / 1000) {
+    granted = sgs_paging_tokens_x1000 / 1000;
+  }
+  sgs_paging_tokens_x1000 -= granted * 1000;
+  return granted;
+}
+
+//------------------------------------------------------------------------------
+static status_code_e sgs_forward_paging_request(
+    const itti_sgsap_paging_request_t* const sgs_paging_req_p) {
+  MessageDef* message_p =
+      DEPRECATEDitti_alloc_new_message_fatal(TASK_SGS, SGSAP_PAGING_REQUEST);
+  SGSAP_PAGING_REQUEST(message_p) = *sgs_paging_req_p;
+  return send_msg_to_task(&sgs_task_zmq_ctx, TASK_MME_APP, message_p);
+}
+
+//------------------------------------------------------------------------------
+static int sgs_handle_paging_tick_expiry(
+    zloop_t* loop, int timer_id, void* arg);
+
+//------------------------------------------------------------------------------
+static void sgs_flush_paging_batch(void) {
+  uint16_t fwd = 0;
+
+  if (pending_sgs_paging_count == 0) {
+    return;
+  }
+  uint16_t allowed =
+      (uint16_t) sgs_paging_token_bucket_take(pending_sgs_paging_count);
+  for (; fwd < allowed; fwd++) {
+    sgs_forward_paging_request(&pending_sgs_paging_requests[fwd]);
+  }
+  if ((fwd > 0) && (fwd < pending_sgs_paging_count)) {
+    memmove(
+        &pending_sgs_paging_requests[0], &pending_sgs_paging_requests[fwd],
+        (pending_sgs_paging_count - fwd) *
+            sizeof(itti_sgsap_paging_request_t));
+  }
+  pending_sgs_paging_count -= fwd;
+  if ((pending_sgs_paging_count > 0) &&
+      (sgs_paging_tick_timer_id == SGS_PAGING_TIMER_INACTIVE_ID)) {
+    // Bucket exhausted: keep the backlog and drain it on the next tick
+    sgs_paging_tick_timer_id = start_timer(
+        &sgs_task_zmq_ctx, (size_t) sgs_paging_batch_tick_msec(),
+        TIMER_REPEAT_ONCE, sgs_handle_paging_tick_expiry, NULL);
+  }
+}
+
+//------------------------------------------------------------------------------
+static int sgs_handle_paging_tick_expiry(
+    zloop_t* loop, int timer_id, void* arg) {
+  sgs_paging_tick_timer_id = SGS_PAGING_TIMER_INACTIVE_ID;
+  sgs_flush_paging_batch();
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+int sgs_enqueue_paging_request(
+    const itti_sgsap_paging_request_t* const sgs_paging_req_p) {
+  long tick_msec = sgs_paging_batch_tick_msec();
+
+  if (tick_msec == 0) {
+    // Coalescing disabled: forward the page on its own
+    return sgs_forward_paging_request(sgs_paging_req_p);
+  }
+  // Drop repeat pages for a UE that already has one pending this tick
+  for (uint16_t i = 0; i < pending_sgs_paging_count; i++) {
+    if (strncmp(
+            pending_sgs_paging_requests[i].imsi, sgs_paging_req_p->imsi,
+            IMSI_BCD_DIGITS_MAX) == 0) {
+      OAILOG_DEBUG(
+          LOG_SGS, "Dropping duplicate SGS paging request for IMSI %s\n",
+          sgs_paging_req_p->imsi);
+      return RETURNok;
+    }
+  }
+  if (pending_sgs_paging_count == SGS_PAGING_BATCH_MAX_UES) {
+    sgs_flush_paging_batch();
+    if (pending_sgs_paging_count == SGS_PAGING_BATCH_MAX_UES) {
+      /* Pacing kept the buffer full; shed the oldest pending page. The
+       * MSC retransmits unanswered pages, so dropping under overload beats
+       * queueing without bound toward mme_app */
+      OAILOG_WARNING(
+          LOG_SGS, "SGS paging backlog full, shedding page for IMSI %s\n",
+          pending_sgs_paging_requests[0].imsi);
+      memmove(
+          &pending_sgs_paging_requests[0], &pending_sgs_paging_requests[1],
+          (SGS_PAGING_BATCH_MAX_UES - 1) *
+              sizeof(itti_sgsap_paging_request_t));
+      pending_sgs_paging_count--;
+    }
+  }
+  pending_sgs_paging_requests[pending_sgs_paging_count++] = *sgs_paging_req_p;
+  if (sgs_paging_tick_timer_id == SGS_PAGING_TIMER_INACTIVE_ID) {
+    sgs_paging_tick_timer_id = start_timer(
+        &sgs_task_zmq_ctx, (size_t) tick_msec, TIMER_REPEAT_ONCE,
+        sgs_handle_paging_tick_expiry, NULL);
+  }
+  return RETURNok;
+}
+
 int sgs_send_paging_reject(
     itti_sgsap_paging_reject_t* const sgs_paging_reject_p) {
   imsi64_t imsi64 = INVALID_IMSI64;
@@ -229,7 +229,8 @@ status_code_e handle_sgs_paging_request(
   OAILOG_FUNC_IN(LOG_SGS);
 
   /* Received SGS Paging Request from FedGW
-   *send it to MME App for further processing
+   *hand it to the sgs task, which coalesces, deduplicates and paces
+   *paging indications before forwarding them to MME App
    */
   message_p =
       DEPRECATEDitti_alloc_new_message_fatal(TASK_SGS, SGSAP_PAGING_REQUEST);
@@ -244,12 +245,12 @@ status_code_e handle_sgs_paging_request(
 
   OAILOG_DEBUG(
       LOG_SGS,
-      "Received SGS Paging Request message from FedGW and send Paging request "
-      "to "
-      "MME app"
+      "Received SGS Paging Request message from FedGW and queued Paging "
+      "request "
+      "on SGS task"
       "for Imsi :%s \n",
       sgs_paging_req_p->imsi);
-  rc = send_msg_to_task(&sgs_task_zmq_ctx, TASK_MME_APP, message_p);
+  rc = send_msg_to_task(&sgs_task_zmq_ctx, TASK_SGS, message_p);
 
   OAILOG_FUNC_RETURN(LOG_NAS_EMM, rc);
 }
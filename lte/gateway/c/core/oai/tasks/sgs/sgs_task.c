@@ -145,6 +145,17 @@ static int handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
       send_service_request(&SGSAP_SERVICE_REQUEST(received_message_p));
     } break;
 
+    case SGSAP_PAGING_REQUEST: {
+      /*
+       * We received a SGs paging request handed off by the FeG service
+       * thread; pages are coalesced per tick, deduplicated per UE and
+       * paced before they reach mme_app
+       */
+      OAILOG_DEBUG(LOG_SGS, "Received SGSAP_PAGING_REQUEST message \n");
+      sgs_enqueue_paging_request(
+          &received_message_p->ittiMsg.sgsap_paging_request);
+    } break;
+
     case SGSAP_PAGING_REJECT: {
       OAILOG_DEBUG(LOG_SGS, "Received  message SGSAP_PAGING_REJECT message \n");
       send_paging_reject(&SGSAP_PAGING_REJECT(received_message_p));
@@ -176,8 +187,11 @@ static void* sgs_thread(__attribute__((unused)) void* args_p) {
   task_zmq_ctx_t* task_zmq_ctx_p = &sgs_task_zmq_ctx;
 
   itti_mark_task_ready(TASK_SGS);
+  // TASK_SGS appears in its own destination list so the FeG service thread
+  // can hand paging requests off to this loop for coalescing
   init_task_context(
-      TASK_SGS, (task_id_t[]){TASK_MME_APP}, 1, handle_message, task_zmq_ctx_p);
+      TASK_SGS, (task_id_t[]){TASK_MME_APP, TASK_SGS}, 2, handle_message,
+      task_zmq_ctx_p);
 
   zloop_start(task_zmq_ctx_p->event_loop);
   sgs_exit();
@@ -183,6 +183,7 @@ sgw_cm_create_bearer_context_information_in_collection(teid_t teid) {
   hash_table_ts_t* state_teid_ht = get_spgw_teid_state();
   hashtable_ts_insert(
       state_teid_ht, (const hash_key_t) teid, new_bearer_context_information);
+  mark_spgw_teid_state_dirty(teid);
 
   OAILOG_DEBUG(
       LOG_SPGW_APP,
@@ -204,6 +205,7 @@ status_code_e sgw_cm_remove_bearer_context_information(
         LOG_SPGW_APP, imsi64, "Failed to free teid from state_teid_ht \n");
     return temp;
   }
+  delete_spgw_teid_state(imsi64, teid);
   spgw_ue_context_t* ue_context_p = NULL;
   hash_table_ts_t* spgw_ue_state  = get_spgw_ue_state();
   hashtable_ts_get(
@@ -339,6 +341,14 @@ s_plus_p_gw_eps_bearer_context_information_t* sgw_cm_get_spgw_context(
   hashtable_ts_get(
       state_teid_ht, (const hash_key_t) teid,
       (void**) &spgw_bearer_context_info);
+  if (spgw_bearer_context_info) {
+    /*
+     * Handlers fetch contexts through here to mutate them in place, so a
+     * successful lookup conservatively dirties the bearer context; the
+     * per-record hash check skips the db write when nothing changed.
+     */
+    mark_spgw_teid_state_dirty(teid);
+  }
   return spgw_bearer_context_info;
 }
 
@@ -44,6 +44,7 @@
 #include "common_types.h"
 #include "sgw_handlers.h"
 #include "sgw_context_manager.h"
+#include "sgw_teid_pool.h"
 #include "pgw_pco.h"
 #include "spgw_config.h"
 #include "gtpv1u.h"
@@ -93,8 +94,9 @@ static teid_t sgw_generate_new_s11_cp_teid(void);
 
 //------------------------------------------------------------------------------
 uint32_t spgw_get_new_s1u_teid(spgw_state_t* state) {
-  __sync_fetch_and_add(&state->gtpv1u_teid, 1);
-  return (state->gtpv1u_teid) % INITIAL_SGW_S8_S1U_TEID;
+  // Block allocation keeps the persisted counter as the single source
+  // of truth while callers on different threads never contend on it
+  return sgw_s1u_teid_pool_alloc(&state->gtpv1u_teid);
 }
 
 //------------------------------------------------------------------------------
@@ -25,6 +25,7 @@
 #define SGW_TASK_C
 
 #include <stdio.h>
+#include <arpa/inet.h>
 #include <netinet/in.h>
 #include <sys/types.h>
 
@@ -189,6 +190,21 @@ static int handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
       }
     } break;
 
+    case UPF_CLASSIFIER_RESPONSE: {
+      itti_upf_classifier_response_t* resp_p =
+          &received_message_p->ittiMsg.upf_classifier_response;
+      char ipv4_str[INET_ADDRSTRLEN]  = {0};
+      char ipv6_str[INET6_ADDRSTRLEN] = {0};
+      inet_ntop(AF_INET, &resp_p->ue_ipv4, ipv4_str, INET_ADDRSTRLEN);
+      inet_ntop(AF_INET6, &resp_p->ue_ipv6, ipv6_str, INET6_ADDRSTRLEN);
+      OAILOG_ERROR(
+          LOG_SPGW_APP,
+          "Pipelined failed to program UE session UEv4:%s UEv6:%s "
+          "operation_type=%u cause_ie=%u \n",
+          ipv4_str, ipv6_str, resp_p->operation_type, resp_p->cause_ie);
+      is_state_same = true;  // task state is not changed
+    } break;
+
     case TERMINATE_MESSAGE: {
       itti_free_msg_content(received_message_p);
       free(received_message_p);
@@ -0,0 +1,107 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file sgw_teid_pool.c
+  \brief Segmented S1-U TEID allocator for the sgw task
+*/
+#define SGW
+#define SGW_TEID_POOL_C
+
+#include <stdint.h>
+#include <time.h>
+
+#include "common_types.h"
+#include "sgw_context_manager.h"
+#include "sgw_teid_pool.h"
+
+/* Allocation never takes a lock: each thread carves TEIDs out of a
+ * private block and only touches the shared cursor once per block, with
+ * a single atomic add. Freed ids go back to the releasing thread's own
+ * freelist, so bearer-setup bursts spread across workers are not
+ * re-serialized on a shared counter or free pool. */
+
+// Number of TEIDs a thread claims from the shared cursor in one shot
+#define SGW_TEID_BLOCK_SIZE 1024
+// Freed TEIDs stay quarantined this long before they can be reissued
+#define SGW_TEID_REUSE_DELAY_SEC 5
+// Bounded per-thread ring of freed ids awaiting reuse
+#define SGW_TEID_FREELIST_SIZE 1024
+
+typedef struct sgw_teid_freed_s {
+  teid_t teid;
+  time_t freed_at;
+} sgw_teid_freed_t;
+
+typedef struct sgw_teid_segment_s {
+  uint32_t next;       // next raw counter value to hand out from the block
+  uint32_t remaining;  // ids left in the block
+  sgw_teid_freed_t freelist[SGW_TEID_FREELIST_SIZE];
+  uint32_t head;  // oldest freed entry
+  uint32_t count;
+} sgw_teid_segment_t;
+
+static __thread sgw_teid_segment_t sgw_teid_segment;
+
+//------------------------------------------------------------------------------
+teid_t sgw_s1u_teid_pool_alloc(uint32_t* cursor) {
+  sgw_teid_segment_t* seg = &sgw_teid_segment;
+
+  // Prefer the oldest freed id once its quarantine has elapsed
+  if (seg->count > 0) {
+    sgw_teid_freed_t* oldest = &seg->freelist[seg->head];
+    if (time(NULL) - oldest->freed_at >= SGW_TEID_REUSE_DELAY_SEC) {
+      teid_t teid = oldest->teid;
+      seg->head   = (seg->head + 1) % SGW_TEID_FREELIST_SIZE;
+      seg->count--;
+      return teid;
+    }
+  }
+
+  for (;;) {
+    if (seg->remaining == 0) {
+      seg->next = __atomic_fetch_add(
+          cursor, SGW_TEID_BLOCK_SIZE, __ATOMIC_RELAXED);
+      seg->remaining = SGW_TEID_BLOCK_SIZE;
+    }
+    teid_t teid = seg->next % INITIAL_SGW_S8_S1U_TEID;
+    seg->next++;
+    seg->remaining--;
+    // The counter wraps through 0 and multiples of the modulus; skip
+    // the values that fold onto INVALID_TEID
+    if (teid != INVALID_TEID) {
+      return teid;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+void sgw_s1u_teid_pool_release(teid_t teid) {
+  sgw_teid_segment_t* seg = &sgw_teid_segment;
+
+  if (teid == INVALID_TEID) {
+    return;
+  }
+  if (seg->count == SGW_TEID_FREELIST_SIZE) {
+    // Ring is full: forget the id rather than stall, the 31 bit TEID
+    // space is cheap compared to a blocked teardown path
+    return;
+  }
+  uint32_t tail = (seg->head + seg->count) % SGW_TEID_FREELIST_SIZE;
+  seg->freelist[tail].teid     = teid;
+  seg->freelist[tail].freed_at = time(NULL);
+  seg->count++;
+}
@@ -0,0 +1,40 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file sgw_teid_pool.h
+  \brief Segmented S1-U TEID allocator for the sgw task
+*/
+
+#ifndef FILE_SGW_TEID_POOL_SEEN
+#define FILE_SGW_TEID_POOL_SEEN
+
+#include <stdint.h>
+
+#include "common_types.h"
+
+/* Hands out the next S1-U TEID from the calling thread's segment,
+ * claiming a fresh block from the shared cursor when the segment runs
+ * dry. The cursor is the persisted spgw_state_t.gtpv1u_teid counter. */
+teid_t sgw_s1u_teid_pool_alloc(uint32_t* cursor);
+
+/* Returns a TEID to the calling thread's segment. The id is quarantined
+ * for a few seconds before sgw_s1u_teid_pool_alloc() may hand it out
+ * again, so late GTP-U traffic for a torn down bearer cannot land on a
+ * freshly created one. */
+void sgw_s1u_teid_pool_release(teid_t teid);
+
+#endif /* FILE_SGW_TEID_POOL_SEEN */
@@ -26,6 +26,7 @@ extern "C" {
 #include "dynamic_memory_check.h"
 #include "pgw_procedures.h"
 #include "sgw_context_manager.h"
+#include "sgw_teid_pool.h"
 }
 
 #include "spgw_state_manager.h"
@@ -84,6 +85,14 @@ void delete_spgw_ue_state(imsi64_t imsi64) {
   SpgwStateManager::getInstance().clear_ue_state_db(imsi_str);
 }
 
+void mark_spgw_teid_state_dirty(teid_t teid) {
+  SpgwStateManager::getInstance().mark_bearer_context_dirty(teid);
+}
+
+void delete_spgw_teid_state(imsi64_t imsi64, teid_t teid) {
+  SpgwStateManager::getInstance().delete_bearer_context_db(imsi64, teid);
+}
+
 void spgw_free_s11_bearer_context_information(
     s_plus_p_gw_eps_bearer_context_information_t** context_p) {
   if (*context_p) {
@@ -115,6 +124,7 @@ void sgw_free_pdn_connection(sgw_pdn_connection_t* pdn_connection_p) {
 
 void sgw_free_eps_bearer_context(sgw_eps_bearer_ctxt_t** sgw_eps_bearer_ctxt) {
   if (*sgw_eps_bearer_ctxt) {
+    sgw_s1u_teid_pool_release((*sgw_eps_bearer_ctxt)->s_gw_teid_S1u_S12_S4_up);
     free_wrapper((void**) sgw_eps_bearer_ctxt);
   }
 }
@@ -69,10 +69,6 @@ class SpgwStateConverter : StateConverter {
   static void proto_to_ue(
       const oai::SpgwUeContext& ue_proto, spgw_ue_context_t* ue_context_p);
 
- private:
-  SpgwStateConverter();
-  ~SpgwStateConverter();
-
   /**
    * Converts spgw bearer context struct to proto, memory is owned by the caller
    * @param spgw_bearer_state
@@ -91,6 +87,10 @@ class SpgwStateConverter : StateConverter {
       const oai::S11BearerContext& spgw_bearer_proto,
       s_plus_p_gw_eps_bearer_context_information_t* spgw_bearer_state);
 
+ private:
+  SpgwStateConverter();
+  ~SpgwStateConverter();
+
   /**
    * Converts sgw eps bearer struct to proto, memory is owned by the caller
    * @param eps_bearer
@@ -20,6 +20,7 @@
 extern "C" {
 #include <dynamic_memory_check.h>
 #include "common_defs.h"
+#include "sgw_context_manager.h"
 }
 
 namespace magma {
@@ -114,18 +115,145 @@ status_code_e SpgwStateManager::read_ue_state_from_db() {
   }
   auto keys = redis_client->get_keys("IMSI*" + task_name + "*");
   for (const auto& key : keys) {
-    oai::SpgwUeContext ue_proto = oai::SpgwUeContext();
-    if (redis_client->read_proto(key, ue_proto) != RETURNok) {
-      return RETURNerror;
-    }
     OAILOG_DEBUG(log_task, "Reading UE state from db for key %s", key.c_str());
-    spgw_ue_context_t* ue_context_p =
-        (spgw_ue_context_t*) calloc(1, sizeof(spgw_ue_context_t));
-    SpgwStateConverter::proto_to_ue(ue_proto, ue_context_p);
+    if (key.find(':') != key.rfind(':')) {
+      // Keyed per-bearer record IMSI<imsi>:SPGW:<teid>
+      oai::S11BearerContext bearer_proto = oai::S11BearerContext();
+      if (redis_client->read_proto(key, bearer_proto) != RETURNok) {
+        return RETURNerror;
+      }
+      s_plus_p_gw_eps_bearer_context_information_t* spgw_context_p = nullptr;
+      hashtable_ts_get(
+          state_teid_ht_,
+          (const hash_key_t)
+              bearer_proto.sgw_eps_bearer_context().sgw_teid_s11_s4(),
+          (void**) &spgw_context_p);
+      if (spgw_context_p) {
+        // Already restored from a legacy whole-UE record
+        continue;
+      }
+      spgw_context_p = (s_plus_p_gw_eps_bearer_context_information_t*) calloc(
+          1, sizeof(s_plus_p_gw_eps_bearer_context_information_t));
+      if (!spgw_context_p) {
+        OAILOG_ERROR(log_task, "Failed to allocate memory for SPGW context");
+        return RETURNerror;
+      }
+      SpgwStateConverter::proto_to_spgw_bearer_context(
+          bearer_proto, spgw_context_p);
+      teid_t teid =
+          spgw_context_p->sgw_eps_bearer_context_information.s_gw_teid_S11_S4;
+      hashtable_ts_insert(
+          state_teid_ht_, (const hash_key_t) teid, (void*) spgw_context_p);
+      spgw_update_teid_in_ue_context(
+          spgw_context_p->sgw_eps_bearer_context_information.imsi64, teid);
+      this->ue_state_version[key] = redis_client->read_version(key);
+    } else {
+      // Legacy whole-UE record written before per-bearer granularity
+      oai::SpgwUeContext ue_proto = oai::SpgwUeContext();
+      if (redis_client->read_proto(key, ue_proto) != RETURNok) {
+        return RETURNerror;
+      }
+      spgw_ue_context_t* ue_context_p =
+          (spgw_ue_context_t*) calloc(1, sizeof(spgw_ue_context_t));
+      SpgwStateConverter::proto_to_ue(ue_proto, ue_context_p);
+      // Migrate to per-bearer records: dirty every restored teid so the
+      // next write replaces this record with keyed ones, then drop it
+      for (int idx = 0; idx < ue_proto.s11_bearer_context_size(); idx++) {
+        dirty_teids_.insert(
+            ue_proto.s11_bearer_context(idx)
+                .sgw_eps_bearer_context()
+                .sgw_teid_s11_s4());
+      }
+      legacy_ue_keys_.insert(key);
+    }
   }
   return RETURNok;
 }
 
+void SpgwStateManager::write_ue_state_to_db(
+    const spgw_ue_context_t* ue_context, const std::string& imsi_str) {
+  AssertFatal(
+      is_initialized,
+      "StateManager init() function should be called to initialize state");
+
+  // Stream out one record per dirty bearer context instead of rebuilding
+  // the whole SpgwUeContext proto on every message.
+  sgw_s11_teid_t* s11_teid_p = nullptr;
+  LIST_FOREACH(s11_teid_p, &ue_context->sgw_s11_teid_list, entries) {
+    if (dirty_teids_.erase(s11_teid_p->sgw_s11_teid) == 0) {
+      continue;
+    }
+    s_plus_p_gw_eps_bearer_context_information_t* spgw_context_p = nullptr;
+    hashtable_ts_get(
+        state_teid_ht_, (const hash_key_t) s11_teid_p->sgw_s11_teid,
+        (void**) &spgw_context_p);
+    if (!spgw_context_p) {
+      continue;
+    }
+
+    oai::S11BearerContext bearer_proto = oai::S11BearerContext();
+    SpgwStateConverter::spgw_bearer_context_to_proto(
+        spgw_context_p, &bearer_proto);
+    std::string proto_str;
+    redis_client->serialize(bearer_proto, proto_str);
+    std::size_t new_hash = std::hash<std::string>{}(proto_str);
+
+    std::string key =
+        get_bearer_context_key(imsi_str, s11_teid_p->sgw_s11_teid);
+    if (new_hash != this->ue_state_hash[key]) {
+      if (redis_client->write_proto_str(
+              key, proto_str, ue_state_version[key]) != RETURNok) {
+        OAILOG_ERROR(
+            log_task, "Failed to write bearer context to db for key %s",
+            key.c_str());
+        continue;
+      }
+      this->ue_state_version[key]++;
+      this->ue_state_hash[key] = new_hash;
+      OAILOG_DEBUG(
+          log_task, "Finished writing bearer context for key %s", key.c_str());
+    }
+  }
+
+  // Drop the legacy whole-UE record once its contexts are stored per bearer
+  std::string legacy_key = "IMSI" + imsi_str + ":" + task_name;
+  if (legacy_ue_keys_.erase(legacy_key)) {
+    std::vector<std::string> keys = {legacy_key};
+    if (redis_client->clear_keys(keys) != RETURNok) {
+      OAILOG_ERROR(
+          log_task, "Failed to remove legacy UE state from db for key %s",
+          legacy_key.c_str());
+    }
+  }
+}
+
+void SpgwStateManager::mark_bearer_context_dirty(teid_t teid) {
+  if (persist_state_enabled) {
+    dirty_teids_.insert(teid);
+  }
+}
+
+void SpgwStateManager::delete_bearer_context_db(imsi64_t imsi64, teid_t teid) {
+  dirty_teids_.erase(teid);
+  if (persist_state_enabled) {
+    std::string key = get_bearer_context_key(get_imsi_str(imsi64), teid);
+    std::vector<std::string> keys = {key};
+    if (redis_client->clear_keys(keys) != RETURNok) {
+      OAILOG_ERROR(
+          log_task, "Failed to remove bearer context from db for key %s",
+          key.c_str());
+      return;
+    }
+    this->ue_state_version.erase(key);
+    this->ue_state_hash.erase(key);
+  }
+}
+
+std::string SpgwStateManager::get_bearer_context_key(
+    const std::string& imsi_str, teid_t teid) const {
+  return "IMSI" + imsi_str + ":" + task_name + ":" + std::to_string(teid);
+}
+
 hash_table_ts_t* SpgwStateManager::get_state_teid_ht() {
   AssertFatal(
       is_initialized,
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <unordered_set>
+
 #include "state_manager.h"
 #include "spgw_state.h"
 #include "spgw_state_converter.h"
@@ -71,6 +73,33 @@ class SpgwStateManager : public StateManager<
 
   status_code_e read_ue_state_from_db() override;
 
+  /**
+   * Writes only the dirty s11_bearer_context_information entries of a UE
+   * to db, one keyed record per S11 teid, so that sync cost is proportional
+   * to the contexts touched since the last write and the whole UE proto is
+   * never materialized.
+   * @param ue_context SPGW UE context pointer
+   * @param imsi_str IMSI of the UE as string
+   */
+  void write_ue_state_to_db(
+      const spgw_ue_context_t* ue_context,
+      const std::string& imsi_str) override;
+
+  /**
+   * Marks the bearer context for an S11 teid as modified, to be written on
+   * the next write_ue_state_to_db() call for its UE.
+   * @param teid S11 teid of the bearer context
+   */
+  void mark_bearer_context_dirty(teid_t teid);
+
+  /**
+   * Removes the keyed db record of a bearer context and drops its dirty
+   * state.
+   * @param imsi64 IMSI of the owning UE
+   * @param teid S11 teid of the bearer context
+   */
+  void delete_bearer_context_db(imsi64_t imsi64, teid_t teid);
+
   hash_table_ts_t* get_state_teid_ht();
 
  private:
@@ -83,8 +112,16 @@ class SpgwStateManager : public StateManager<
    */
   void create_state() override;
 
+  std::string get_bearer_context_key(
+      const std::string& imsi_str, teid_t teid) const;
+
   hash_table_ts_t* state_teid_ht_;
   const spgw_config_t* config_;
+  // S11 teids whose bearer context changed since the last db write
+  std::unordered_set<teid_t> dirty_teids_;
+  // Whole-UE db records restored at startup, removed after their bearer
+  // contexts have been rewritten as keyed per-bearer records
+  std::unordered_set<std::string> legacy_ue_keys_;
 };
 
 }  // namespace lte
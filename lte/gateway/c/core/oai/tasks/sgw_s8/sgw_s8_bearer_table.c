@@ -0,0 +1,142 @@
+/*
+Copyright 2020 The Magma Authors.
+
+This source code is licensed under the BSD-style license found in the
+LICENSE file in the root directory of this source tree.
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <stdlib.h>
+#include <string.h>
+#include "log.h"
+#include "common_defs.h"
+#include "dynamic_memory_check.h"
+#include "sgw_s8_bearer_table.h"
+
+typedef struct sgw_s8_bearer_table_s {
+  uint32_t num_bearers;
+  teid_t context_teid[SGW_S8_BEARER_TABLE_CAPACITY];
+  teid_t sgw_s1u_teid[SGW_S8_BEARER_TABLE_CAPACITY];
+  teid_t enb_s1u_teid[SGW_S8_BEARER_TABLE_CAPACITY];
+  teid_t pgw_s8u_teid[SGW_S8_BEARER_TABLE_CAPACITY];
+  struct in_addr enb_ipv4[SGW_S8_BEARER_TABLE_CAPACITY];
+  struct in_addr pgw_ipv4[SGW_S8_BEARER_TABLE_CAPACITY];
+  uint8_t qci[SGW_S8_BEARER_TABLE_CAPACITY];
+  ebi_t ebi[SGW_S8_BEARER_TABLE_CAPACITY];
+  /* Back pointer per slot to the owning bearer context, needed to patch its
+   * slot handle when compaction moves the last slot into a freed hole.
+   */
+  sgw_eps_bearer_ctxt_t* owner[SGW_S8_BEARER_TABLE_CAPACITY];
+} sgw_s8_bearer_table_t;
+
+static sgw_s8_bearer_table_t* sgw_s8_bearer_table = NULL;
+
+status_code_e sgw_s8_bearer_table_init(void) {
+  OAILOG_FUNC_IN(LOG_SGW_S8);
+  sgw_s8_bearer_table = calloc(1, sizeof(sgw_s8_bearer_table_t));
+  if (!sgw_s8_bearer_table) {
+    OAILOG_ERROR(LOG_SGW_S8, "Failed to allocate sgw_s8 bearer table\n");
+    OAILOG_FUNC_RETURN(LOG_SGW_S8, RETURNerror);
+  }
+  OAILOG_FUNC_RETURN(LOG_SGW_S8, RETURNok);
+}
+
+void sgw_s8_bearer_table_exit(void) {
+  free_wrapper((void**) &sgw_s8_bearer_table);
+}
+
+void sgw_s8_bearer_table_update_bearer(
+    teid_t context_teid, sgw_eps_bearer_ctxt_t* bearer_ctxt_p) {
+  sgw_s8_bearer_table_t* table = sgw_s8_bearer_table;
+  uint32_t slot                = 0;
+
+  if (!table || !bearer_ctxt_p) {
+    return;
+  }
+  /* A slot handle of 0 means unregistered; contexts restored from redis come
+   * back with a zeroed handle and are re-registered here on their first
+   * update. Stale handles (slot no longer owned by this bearer) are treated
+   * the same way.
+   */
+  if (bearer_ctxt_p->bearer_slot &&
+      (bearer_ctxt_p->bearer_slot - 1) < table->num_bearers &&
+      table->owner[bearer_ctxt_p->bearer_slot - 1] == bearer_ctxt_p) {
+    slot = bearer_ctxt_p->bearer_slot - 1;
+  } else {
+    if (table->num_bearers >= SGW_S8_BEARER_TABLE_CAPACITY) {
+      OAILOG_WARNING(
+          LOG_SGW_S8,
+          "sgw_s8 bearer table is full (%u slots), bearer with ebi %u is not "
+          "tracked\n",
+          SGW_S8_BEARER_TABLE_CAPACITY, bearer_ctxt_p->eps_bearer_id);
+      bearer_ctxt_p->bearer_slot = 0;
+      return;
+    }
+    slot                       = table->num_bearers++;
+    table->owner[slot]         = bearer_ctxt_p;
+    bearer_ctxt_p->bearer_slot = slot + 1;
+  }
+  table->context_teid[slot] = context_teid;
+  table->sgw_s1u_teid[slot] = bearer_ctxt_p->s_gw_teid_S1u_S12_S4_up;
+  table->enb_s1u_teid[slot] = bearer_ctxt_p->enb_teid_S1u;
+  table->pgw_s8u_teid[slot] = bearer_ctxt_p->p_gw_teid_S5_S8_up;
+  table->enb_ipv4[slot] =
+      bearer_ctxt_p->enb_ip_address_S1u.address.ipv4_address;
+  table->pgw_ipv4[slot] =
+      bearer_ctxt_p->p_gw_address_in_use_up.address.ipv4_address;
+  table->qci[slot] = bearer_ctxt_p->eps_bearer_qos.qci;
+  table->ebi[slot] = bearer_ctxt_p->eps_bearer_id;
+}
+
+void sgw_s8_bearer_table_release_bearer(sgw_eps_bearer_ctxt_t* bearer_ctxt_p) {
+  sgw_s8_bearer_table_t* table = sgw_s8_bearer_table;
+  uint32_t slot                = 0;
+  uint32_t last                = 0;
+
+  if (!table || !bearer_ctxt_p || !bearer_ctxt_p->bearer_slot) {
+    return;
+  }
+  slot = bearer_ctxt_p->bearer_slot - 1;
+  if ((slot >= table->num_bearers) || (table->owner[slot] != bearer_ctxt_p)) {
+    bearer_ctxt_p->bearer_slot = 0;
+    return;
+  }
+  // Keep the arrays dense: move the last slot into the freed hole.
+  last = --table->num_bearers;
+  if (slot != last) {
+    table->context_teid[slot]       = table->context_teid[last];
+    table->sgw_s1u_teid[slot]       = table->sgw_s1u_teid[last];
+    table->enb_s1u_teid[slot]       = table->enb_s1u_teid[last];
+    table->pgw_s8u_teid[slot]       = table->pgw_s8u_teid[last];
+    table->enb_ipv4[slot]           = table->enb_ipv4[last];
+    table->pgw_ipv4[slot]           = table->pgw_ipv4[last];
+    table->qci[slot]                = table->qci[last];
+    table->ebi[slot]                = table->ebi[last];
+    table->owner[slot]              = table->owner[last];
+    table->owner[slot]->bearer_slot = slot + 1;
+  }
+  table->owner[last]         = NULL;
+  bearer_ctxt_p->bearer_slot = 0;
+}
+
+void sgw_s8_bearer_table_get_view(sgw_s8_bearer_table_view_t* view) {
+  sgw_s8_bearer_table_t* table = sgw_s8_bearer_table;
+
+  memset(view, 0, sizeof(*view));
+  if (!table) {
+    return;
+  }
+  view->num_bearers  = table->num_bearers;
+  view->context_teid = table->context_teid;
+  view->sgw_s1u_teid = table->sgw_s1u_teid;
+  view->enb_s1u_teid = table->enb_s1u_teid;
+  view->pgw_s8u_teid = table->pgw_s8u_teid;
+  view->enb_ipv4     = table->enb_ipv4;
+  view->pgw_ipv4     = table->pgw_ipv4;
+  view->qci          = table->qci;
+  view->ebi          = table->ebi;
+}
@@ -0,0 +1,66 @@
+/*
+Copyright 2020 The Magma Authors.
+
+This source code is licensed under the BSD-style license found in the
+LICENSE file in the root directory of this source tree.
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <netinet/in.h>
+#include "common_defs.h"
+#include "common_types.h"
+#include "3gpp_23.401.h"
+
+/* Struct-of-arrays table over all active sgw_s8 bearers. The hashtable of
+ * sgw_eps_bearer_context_information_t remains the authoritative store; this
+ * table keeps the per-packet fields (TEIDs, QCI, peer addresses) of every
+ * bearer in dense parallel arrays indexed by a compact bearer slot, so that
+ * code walking all bearers streams through cache lines instead of chasing
+ * per-UE context pointers. Slots are kept dense: releasing a bearer moves the
+ * last slot into the hole and updates that bearer's slot handle.
+ */
+
+// Number of bearer slots in the struct-of-arrays bearer table.
+#define SGW_S8_BEARER_TABLE_CAPACITY (32768)
+
+/* Read-only view on the parallel arrays; entries [0, num_bearers) are valid
+ * and contiguous. Pointers stay valid for the lifetime of the task but the
+ * contents change as bearers are created, modified and released.
+ */
+typedef struct sgw_s8_bearer_table_view_s {
+  uint32_t num_bearers;
+  const teid_t* context_teid;      ///< owning context's sgw_s11_teid
+  const teid_t* sgw_s1u_teid;      ///< s_gw_teid_S1u_S12_S4_up
+  const teid_t* enb_s1u_teid;      ///< enb_teid_S1u
+  const teid_t* pgw_s8u_teid;      ///< p_gw_teid_S5_S8_up
+  const struct in_addr* enb_ipv4;  ///< eNB S1-U peer address
+  const struct in_addr* pgw_ipv4;  ///< P-GW S8-U peer address
+  const uint8_t* qci;
+  const ebi_t* ebi;
+} sgw_s8_bearer_table_view_t;
+
+// Allocates the bearer table, called once from sgw_s8 task init.
+status_code_e sgw_s8_bearer_table_init(void);
+
+// Frees the bearer table.
+void sgw_s8_bearer_table_exit(void);
+
+/* Registers the bearer on first call and refreshes its slot from the bearer
+ * context on subsequent calls; invoked wherever the hot fields change
+ * (session creation, create session response, modify bearer, release access
+ * bearers).
+ */
+void sgw_s8_bearer_table_update_bearer(
+    teid_t context_teid, sgw_eps_bearer_ctxt_t* bearer_ctxt_p);
+
+// Releases the bearer's slot, compacting the table.
+void sgw_s8_bearer_table_release_bearer(sgw_eps_bearer_ctxt_t* bearer_ctxt_p);
+
+// Fills view with the current parallel arrays for streaming iteration.
+void sgw_s8_bearer_table_get_view(sgw_s8_bearer_table_view_t* view);
@@ -20,6 +20,7 @@ limitations under the License.
 #include "sgw_context_manager.h"
 #include "spgw_types.h"
 #include "sgw_s8_state.h"
+#include "sgw_s8_bearer_table.h"
 #include "sgw_s8_s11_handlers.h"
 #include "s8_client_api.h"
 #include "gtpv1u.h"
@@ -318,6 +319,8 @@ void sgw_s8_handle_s11_create_session_request(
   csr_bearer_context->s5_s8_u_sgw_fteid.ipv4 = 1;
   csr_bearer_context->s5_s8_u_sgw_fteid.ipv4_address =
       sgw_state->sgw_ip_address_S5S8_up;
+  sgw_s8_bearer_table_update_bearer(
+      new_sgw_eps_context->s_gw_teid_S11_S4, eps_bearer_ctxt_p);
 
   send_s8_create_session_request(
       sgw_s11_tunnel.local_teid, session_req_pP, imsi64);
@@ -359,6 +362,8 @@ static int update_bearer_context_info(
   memcpy(
       &default_bearer_ctx_p->eps_bearer_qos, &s5s8_bearer_context.qos,
       sizeof(bearer_qos_t));
+  sgw_s8_bearer_table_update_bearer(
+      sgw_context_p->s_gw_teid_S11_S4, default_bearer_ctx_p);
   OAILOG_FUNC_RETURN(LOG_SGW_S8, RETURNok);
 }
 
@@ -728,6 +733,8 @@ static void sgw_s8_populate_mbr_bearer_contexts_modified(
 
       // setup GTPv1-U tunnels, both s1-u and s8-u tunnels
       sgw_s8_add_gtp_up_tunnel(eps_bearer_ctxt_p, sgw_context_p);
+      sgw_s8_bearer_table_update_bearer(
+          sgw_context_p->s_gw_teid_S11_S4, eps_bearer_ctxt_p);
       // may be removed TODO rashmi remove after testing
       if (TRAFFIC_FLOW_TEMPLATE_NB_PACKET_FILTERS_MAX >
           eps_bearer_ctxt_p->num_sdf) {
@@ -941,6 +948,7 @@ static void delete_userplane_tunnels(
       } else {
         OAILOG_DEBUG(LOG_SPGW_APP, "Stopped paging for IP Addr: %s\n", ip_str);
       }
+      sgw_s8_bearer_table_release_bearer(bearer_ctxt_p);
     }
   }
   OAILOG_FUNC_OUT(LOG_SGW_S8);
@@ -1102,6 +1110,15 @@ void sgw_s8_handle_release_access_bearers_request(
         sgw_context_p->mme_teid_S11);
     sgw_process_release_access_bearer_request(
         LOG_SGW_S8, imsi64, sgw_context_p);
+    // Re-sync released eNB TEIDs/addresses into the bearer table
+    for (int ebix = 0; ebix < BEARERS_PER_UE; ebix++) {
+      sgw_eps_bearer_ctxt_t* bearer_ctxt_p = sgw_cm_get_eps_bearer_entry(
+          &sgw_context_p->pdn_connection, INDEX_TO_EBI(ebix));
+      if (bearer_ctxt_p) {
+        sgw_s8_bearer_table_update_bearer(
+            sgw_context_p->s_gw_teid_S11_S4, bearer_ctxt_p);
+      }
+    }
   } else {
     sgw_send_release_access_bearer_response(
         LOG_SGW_S8, imsi64, CONTEXT_NOT_FOUND, release_access_bearers_req_pP,
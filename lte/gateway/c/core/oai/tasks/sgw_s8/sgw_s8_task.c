@@ -20,6 +20,7 @@ limitations under the License.
 #include "common_defs.h"
 #include "itti_free_defined_msg.h"
 #include "sgw_s8_defs.h"
+#include "sgw_s8_bearer_table.h"
 #include "sgw_s8_s11_handlers.h"
 #include "sgw_s8_state.h"
 
@@ -45,6 +46,12 @@ status_code_e sgw_s8_init(sgw_config_t* sgw_config_p) {
     return RETURNerror;
   }
 
+  if (sgw_s8_bearer_table_init() != RETURNok) {
+    OAILOG_CRITICAL(
+        LOG_SGW_S8, "Error while initializing SGW_S8 bearer table\n");
+    return RETURNerror;
+  }
+
   if (itti_create_task(TASK_SGW_S8, &sgw_s8_thread, NULL) < 0) {
     OAILOG_ERROR(LOG_SGW_S8, "Failed to create sgw_s8 task\n");
     return RETURNerror;
@@ -113,6 +120,7 @@ static int handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
 
 //------------------------------------------------------------------------------
 static void sgw_s8_exit(void) {
+  sgw_s8_bearer_table_exit();
   destroy_task_context(&sgw_s8_task_zmq_ctx);
   OAILOG_DEBUG(LOG_SGW_S8, "Finished cleaning up SGW_S8 task \n");
   OAI_FPRINTF_INFO("TASK_SGW_S8 terminated\n");
@@ -15,9 +15,14 @@
  *      contact@openairinterface.org
  */
 
+#include <pthread.h>
 #include <string.h>
+#include <time.h>
 
 #include "assertions.h"
+#include "conversions.h"
+#include "dynamic_memory_check.h"
+#include "hashtable.h"
 #include "intertask_interface.h"
 #include "log.h"
 #include "common_defs.h"
@@ -26,7 +31,36 @@
 #include "sms_orc8r_messages.h"
 #include "sgs_messages_types.h"
 
-status_code_e handle_sms_orc8r_downlink_unitdata(
+/* Per-UE pending MT SMS queue: while a downlink for an IMSI is in flight,
+ * follow-up messages for the same UE wait here and are released one at a
+ * time as the UE's acks (uplink unitdata on the live NAS connection) pass
+ * through the task. Sequential SMS to one UE thus ride a single paging
+ * cycle instead of triggering one paging cycle per message. A periodic
+ * sweep releases messages for UEs whose acks never come back through us. */
+
+#define SMS_ORC8R_PENDING_SMS_MAX 32       // per UE, overflow forwards
+#define SMS_ORC8R_PENDING_SMS_STALE_SEC 6  // release if no ack for this long
+#define SMS_ORC8R_PENDING_SMS_HT_SIZE 512
+
+typedef struct sms_orc8r_pending_sms_s {
+  itti_sgsap_downlink_unitdata_t dl_unitdata;
+  struct sms_orc8r_pending_sms_s* next;
+} sms_orc8r_pending_sms_t;
+
+typedef struct sms_orc8r_ue_sms_queue_s {
+  sms_orc8r_pending_sms_t* head;
+  sms_orc8r_pending_sms_t* tail;
+  uint32_t pending_count;
+  time_t last_forward_time;
+} sms_orc8r_ue_sms_queue_t;
+
+// Touched from the grpc service threads (downlink) and the sms_orc8r task
+// thread (uplink drain, stale sweep), hence the lock around the plain table
+static pthread_mutex_t sms_pending_lock   = PTHREAD_MUTEX_INITIALIZER;
+static hash_table_t* sms_pending_by_imsi  = NULL;
+
+//------------------------------------------------------------------------------
+static status_code_e forward_dl_unitdata_to_nas(
     const itti_sgsap_downlink_unitdata_t* sgs_dl_unitdata_p) {
   int rc = RETURNok;
 
@@ -48,3 +82,176 @@ status_code_e handle_sms_orc8r_downlink_unitdata(
   rc = send_msg_to_task(&sms_orc8r_task_zmq_ctx, TASK_MME_APP, message_p);
   OAILOG_FUNC_RETURN(LOG_NAS_EMM, rc);
 }
+
+//------------------------------------------------------------------------------
+// Caller must hold sms_pending_lock
+static sms_orc8r_ue_sms_queue_t* get_ue_sms_queue(imsi64_t imsi64) {
+  sms_orc8r_ue_sms_queue_t* queue = NULL;
+
+  if (!sms_pending_by_imsi) {
+    bstring ht_name     = bfromcstr("sms_orc8r_pending_sms");
+    sms_pending_by_imsi = hashtable_create(
+        SMS_ORC8R_PENDING_SMS_HT_SIZE, NULL, free_wrapper, ht_name);
+    bdestroy(ht_name);
+  }
+  hashtable_get(sms_pending_by_imsi, (hash_key_t) imsi64, (void**) &queue);
+  return queue;
+}
+
+//------------------------------------------------------------------------------
+status_code_e handle_sms_orc8r_downlink_unitdata(
+    const itti_sgsap_downlink_unitdata_t* sgs_dl_unitdata_p) {
+  imsi64_t imsi64 = INVALID_IMSI64;
+
+  IMSI_STRING_TO_IMSI64(sgs_dl_unitdata_p->imsi, &imsi64);
+
+  pthread_mutex_lock(&sms_pending_lock);
+  sms_orc8r_ue_sms_queue_t* queue = get_ue_sms_queue(imsi64);
+  if (!queue) {
+    // Nothing in flight for this UE: forward now and remember the delivery
+    // so follow-ups for the same UE wait for the connection it establishes
+    queue = (sms_orc8r_ue_sms_queue_t*) calloc(
+        1, sizeof(sms_orc8r_ue_sms_queue_t));
+    queue->last_forward_time = time(NULL);
+    hashtable_insert(sms_pending_by_imsi, (hash_key_t) imsi64, queue);
+    pthread_mutex_unlock(&sms_pending_lock);
+    return forward_dl_unitdata_to_nas(sgs_dl_unitdata_p);
+  }
+  if (queue->pending_count >= SMS_ORC8R_PENDING_SMS_MAX) {
+    // Bounded queue: never hold SMS hostage, fall back to direct forwarding
+    pthread_mutex_unlock(&sms_pending_lock);
+    OAILOG_WARNING(
+        LOG_SMS_ORC8R, "Pending SMS queue full for " IMSI_64_FMT
+        ", forwarding directly\n", imsi64);
+    return forward_dl_unitdata_to_nas(sgs_dl_unitdata_p);
+  }
+  sms_orc8r_pending_sms_t* node =
+      (sms_orc8r_pending_sms_t*) calloc(1, sizeof(sms_orc8r_pending_sms_t));
+  node->dl_unitdata = *sgs_dl_unitdata_p;
+  if (queue->tail) {
+    queue->tail->next = node;
+  } else {
+    queue->head = node;
+  }
+  queue->tail = node;
+  queue->pending_count++;
+  pthread_mutex_unlock(&sms_pending_lock);
+  OAILOG_DEBUG(
+      LOG_SMS_ORC8R,
+      "Queued MT SMS for " IMSI_64_FMT " behind in-flight delivery\n", imsi64);
+  return RETURNok;
+}
+
+//------------------------------------------------------------------------------
+void sms_orc8r_notify_ue_activity(const char* imsi, uint8_t imsi_length) {
+  imsi64_t imsi64 = INVALID_IMSI64;
+  char imsi_str[IMSI_BCD_DIGITS_MAX + 1] = {0};
+
+  if (imsi_length > IMSI_BCD_DIGITS_MAX) {
+    return;
+  }
+  strncpy(imsi_str, imsi, imsi_length);
+  IMSI_STRING_TO_IMSI64(imsi_str, &imsi64);
+
+  pthread_mutex_lock(&sms_pending_lock);
+  sms_orc8r_ue_sms_queue_t* queue = NULL;
+  hashtable_get(sms_pending_by_imsi, (hash_key_t) imsi64, (void**) &queue);
+  if (!queue) {
+    pthread_mutex_unlock(&sms_pending_lock);
+    return;
+  }
+  sms_orc8r_pending_sms_t* node = queue->head;
+  if (!node) {
+    // UE acked everything pending: next downlink forwards immediately
+    hashtable_free(sms_pending_by_imsi, (hash_key_t) imsi64);
+    pthread_mutex_unlock(&sms_pending_lock);
+    return;
+  }
+  // The UE has a live NAS connection right now: piggyback the next SMS on
+  // it instead of letting a later delivery trigger a fresh paging cycle
+  queue->head = node->next;
+  if (!queue->head) {
+    queue->tail = NULL;
+  }
+  queue->pending_count--;
+  queue->last_forward_time = time(NULL);
+  pthread_mutex_unlock(&sms_pending_lock);
+
+  OAILOG_DEBUG(
+      LOG_SMS_ORC8R,
+      "Piggybacking queued MT SMS for " IMSI_64_FMT " on live connection\n",
+      imsi64);
+  forward_dl_unitdata_to_nas(&node->dl_unitdata);
+  free(node);
+}
+
+//------------------------------------------------------------------------------
+typedef struct stale_sweep_ctx_s {
+#define SMS_ORC8R_STALE_SWEEP_MAX 64
+  time_t now;
+  int num_stale;
+  hash_key_t stale_keys[SMS_ORC8R_STALE_SWEEP_MAX];
+} stale_sweep_ctx_t;
+
+static bool collect_stale_ue_sms_queues(
+    hash_key_t key, void* element, void* parameter, void** result) {
+  stale_sweep_ctx_t* ctx          = (stale_sweep_ctx_t*) parameter;
+  sms_orc8r_ue_sms_queue_t* queue = (sms_orc8r_ue_sms_queue_t*) element;
+
+  if (ctx->now - queue->last_forward_time < SMS_ORC8R_PENDING_SMS_STALE_SEC) {
+    return false;
+  }
+  if (ctx->num_stale >= SMS_ORC8R_STALE_SWEEP_MAX) {
+    return true;  // stop, next sweep picks up the rest
+  }
+  ctx->stale_keys[ctx->num_stale++] = key;
+  return false;
+}
+
+void sms_orc8r_flush_stale_pending_sms(void) {
+  stale_sweep_ctx_t ctx = {0};
+  ctx.now               = time(NULL);
+
+  pthread_mutex_lock(&sms_pending_lock);
+  if (!sms_pending_by_imsi) {
+    pthread_mutex_unlock(&sms_pending_lock);
+    return;
+  }
+  hashtable_apply_callback_on_elements(
+      sms_pending_by_imsi, collect_stale_ue_sms_queues, &ctx, NULL);
+
+  // Release one message per stale UE per sweep; drop tracking entries of
+  // UEs with nothing left pending
+  sms_orc8r_pending_sms_t* to_forward = NULL;
+  for (int i = 0; i < ctx.num_stale; i++) {
+    sms_orc8r_ue_sms_queue_t* queue = NULL;
+    hashtable_get(sms_pending_by_imsi, ctx.stale_keys[i], (void**) &queue);
+    if (!queue) {
+      continue;
+    }
+    sms_orc8r_pending_sms_t* node = queue->head;
+    if (!node) {
+      hashtable_free(sms_pending_by_imsi, ctx.stale_keys[i]);
+      continue;
+    }
+    queue->head = node->next;
+    if (!queue->head) {
+      queue->tail = NULL;
+    }
+    queue->pending_count--;
+    queue->last_forward_time = ctx.now;
+    node->next               = to_forward;
+    to_forward               = node;
+  }
+  pthread_mutex_unlock(&sms_pending_lock);
+
+  while (to_forward) {
+    sms_orc8r_pending_sms_t* node = to_forward;
+    to_forward                    = node->next;
+    OAILOG_DEBUG(
+        LOG_SMS_ORC8R, "Releasing stale queued MT SMS for %s\n",
+        node->dl_unitdata.imsi);
+    forward_dl_unitdata_to_nas(&node->dl_unitdata);
+    free(node);
+  }
+}
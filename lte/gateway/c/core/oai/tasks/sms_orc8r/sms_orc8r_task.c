@@ -31,13 +31,46 @@
 #include "mme_config.h"
 #include "sgs_messages_types.h"
 #include "sms_orc8r_client_api.h"
+#include "sms_orc8r_service_handler.h"
 #include "common_defs.h"
 #include "intertask_interface_types.h"
 
+// A2P campaigns deliver SMS in bursts: MO uplinks (and their acks) are
+// micro-batched here and flushed towards the orc8r relay in one dispatch
+// when the buffer fills or the flush timer fires, instead of one gRPC
+// exchange per ITTI message
+#define SMS_ORC8R_UPLINK_BATCH_MAX 8
+#define SMS_ORC8R_UPLINK_BATCH_FLUSH_MSEC 10
+#define SMS_ORC8R_PENDING_SWEEP_MSEC 1000
+
 static void sms_orc8r_exit(void);
 
 task_zmq_ctx_t sms_orc8r_task_zmq_ctx;
 
+static itti_sgsap_uplink_unitdata_t uplink_batch[SMS_ORC8R_UPLINK_BATCH_MAX];
+static size_t uplink_batch_count = 0;
+
+//------------------------------------------------------------------------------
+static void flush_uplink_batch(void) {
+  if (uplink_batch_count == 0) {
+    return;
+  }
+  send_smo_uplink_unitdata_batch(uplink_batch, uplink_batch_count);
+  uplink_batch_count = 0;
+}
+
+//------------------------------------------------------------------------------
+static int handle_uplink_batch_timer(zloop_t* loop, int id, void* arg) {
+  flush_uplink_batch();
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+static int handle_pending_sweep_timer(zloop_t* loop, int id, void* arg) {
+  sms_orc8r_flush_stale_pending_sms();
+  return 0;
+}
+
 static int handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
   MessageDef* received_message_p = receive_msg(reader);
 
@@ -50,8 +83,15 @@ static int handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
        * * * *      Mobile terminating SMS - Uplink Nas Transport message
        */
       OAILOG_DEBUG(LOG_SMS_ORC8R, "Received SGSAP_UPLINK_UNITDATA message \n");
-      send_smo_uplink_unitdata(
-          &received_message_p->ittiMsg.sgsap_uplink_unitdata);
+      itti_sgsap_uplink_unitdata_t* ul_unitdata_p =
+          &received_message_p->ittiMsg.sgsap_uplink_unitdata;
+      // The UE is on a live NAS connection: drain its pending MT SMS first
+      sms_orc8r_notify_ue_activity(
+          ul_unitdata_p->imsi, ul_unitdata_p->imsi_length);
+      uplink_batch[uplink_batch_count++] = *ul_unitdata_p;
+      if (uplink_batch_count == SMS_ORC8R_UPLINK_BATCH_MAX) {
+        flush_uplink_batch();
+      }
     } break;
 
     case TERMINATE_MESSAGE: {
@@ -79,6 +119,13 @@ static void* sms_orc8r_thread(__attribute__((unused)) void* args_p) {
       TASK_SMS_ORC8R, (task_id_t[]){TASK_MME_APP}, 1, handle_message,
       task_zmq_ctx_p);
 
+  start_timer(
+      task_zmq_ctx_p, SMS_ORC8R_UPLINK_BATCH_FLUSH_MSEC, TIMER_REPEAT_FOREVER,
+      handle_uplink_batch_timer, NULL);
+  start_timer(
+      task_zmq_ctx_p, SMS_ORC8R_PENDING_SWEEP_MSEC, TIMER_REPEAT_FOREVER,
+      handle_pending_sweep_timer, NULL);
+
   zloop_start(task_zmq_ctx_p->event_loop);
   sms_orc8r_exit();
   return NULL;
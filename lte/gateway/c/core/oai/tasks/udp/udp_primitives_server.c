@@ -22,6 +22,7 @@
   \email: lionel.gauthier@eurecom.fr
 */
 
+#define _GNU_SOURCE /* recvmmsg */
 #include <arpa/inet.h>
 #include <errno.h>
 #include <fcntl.h>
@@ -48,11 +49,16 @@
 
 task_zmq_ctx_t udp_task_zmq_ctx;
 
+/* Number of datagrams drained from a socket with one recvmmsg() call */
+#define UDP_RX_BATCH_SIZE (32)
+/* Upper bound on MAGMA_UDP_NUM_SHARDS */
+#define UDP_MAX_SHARDS (16)
+
 struct udp_socket_desc_s {
-  uint8_t buffer[4096];
   int sd; /* Socket descriptor to use */
 
   pthread_t listener_thread; /* Thread affected to recv */
+  bool sharded;              /* Receive runs on a dedicated shard thread */
 
   struct sockaddr local_addr; /* Local ipv4 or ipv6 address to use */
   uint16_t local_port;        /* Local port to use */
@@ -64,8 +70,28 @@ struct udp_socket_desc_s {
 static STAILQ_HEAD(udp_socket_list_s, udp_socket_desc_s) udp_socket_list;
 static pthread_mutex_t udp_socket_list_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-static void udp_server_receive_and_process(
-    struct udp_socket_desc_s* udp_sock_pP);
+static int udp_server_drain_socket(struct udp_socket_desc_s* udp_sock_pP);
+
+/* @brief Number of SO_REUSEPORT sockets, and receive threads, bound per
+ * endpoint. The kernel hashes GTP-C peers across the shards, so floods from
+ * many peers spread over cores instead of saturating the task loop. Defaults
+ * to 1, which keeps the single socket polled on the task loop.
+ */
+static int udp_num_shards(void) {
+  static int num_shards = 0;
+
+  if (num_shards == 0) {
+    num_shards      = 1;
+    const char* env = getenv("MAGMA_UDP_NUM_SHARDS");
+    if (env) {
+      int val = atoi(env);
+      if (val > 1) {
+        num_shards = (val > UDP_MAX_SHARDS) ? UDP_MAX_SHARDS : val;
+      }
+    }
+  }
+  return num_shards;
+}
 
 /* @brief Retrieve the descriptor associated with the task_id
  */
@@ -114,66 +140,84 @@ static struct udp_socket_desc_s* udp_server_get_socket_desc_by_sd(int sdP) {
   return udp_sock_p;
 }
 
-static void udp_server_receive_and_process(
-    struct udp_socket_desc_s* udp_sock_pP) {
-  OAILOG_DEBUG(
-      LOG_UDP, "Inserting new descriptor for task %d, sd %d\n",
-      udp_sock_pP->task_id, udp_sock_pP->sd);
-  {
-    int bytes_received = 0;
-    socklen_t from_len;
-    struct sockaddr_in addr;
-    struct sockaddr_in6 addr6;
-
-    bool ipv6 = udp_sock_pP->local_addr.sa_family == AF_INET6;
-
-    if (ipv6) {
-      from_len = (socklen_t) sizeof(struct sockaddr_in6);
-      memset(&addr6, 0, sizeof(struct sockaddr_in6));
-    } else {
-      from_len = (socklen_t) sizeof(struct sockaddr_in);
-      memset(&addr, 0, sizeof(struct sockaddr_in));
+/* @brief Drain up to UDP_RX_BATCH_SIZE datagrams from the socket with one
+ * recvmmsg() call and forward each one as an UDP_DATA_IND, repeating while
+ * full batches keep coming. Returns RETURNerror once the socket is dead so
+ * shard receive threads know to exit.
+ */
+static int udp_server_drain_socket(struct udp_socket_desc_s* udp_sock_pP) {
+  static __thread uint8_t rx_bufs[UDP_RX_BATCH_SIZE][UDP_DATA_MAX_MSG_LEN];
+  static __thread struct sockaddr_storage rx_addrs[UDP_RX_BATCH_SIZE];
+  struct mmsghdr msgs[UDP_RX_BATCH_SIZE];
+  struct iovec iovs[UDP_RX_BATCH_SIZE];
+  int num_received = 0;
+
+  do {
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < UDP_RX_BATCH_SIZE; i++) {
+      iovs[i].iov_base            = rx_bufs[i];
+      iovs[i].iov_len             = sizeof(rx_bufs[i]);
+      msgs[i].msg_hdr.msg_iov     = &iovs[i];
+      msgs[i].msg_hdr.msg_iovlen  = 1;
+      msgs[i].msg_hdr.msg_name    = &rx_addrs[i];
+      msgs[i].msg_hdr.msg_namelen = sizeof(rx_addrs[i]);
     }
 
-    if ((bytes_received = recvfrom(
-             udp_sock_pP->sd, udp_sock_pP->buffer, sizeof(udp_sock_pP->buffer),
-             0, ipv6 ? (struct sockaddr*) &addr6 : (struct sockaddr*) &addr,
-             &from_len)) <= 0) {
-      OAILOG_ERROR(LOG_UDP, "Recvfrom failed %s\n", strerror(errno));
-      // break;
-    } else {
-      MessageDef* message_p = NULL;
-      udp_data_ind_t* udp_data_ind_p;
-      AssertFatal(
-          sizeof(udp_sock_pP->buffer) >= bytes_received, "UDP BUFFER OVERFLOW");
-      message_p =
+    num_received = recvmmsg(udp_sock_pP->sd, msgs, UDP_RX_BATCH_SIZE, 0, NULL);
+    if (num_received < 0) {
+      if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)) {
+        return RETURNok;
+      }
+      OAILOG_ERROR(LOG_UDP, "recvmmsg failed %s\n", strerror(errno));
+      return RETURNerror;
+    }
+
+    for (int i = 0; i < num_received; i++) {
+      uint32_t bytes_received = msgs[i].msg_len;
+      bool ipv6               = rx_addrs[i].ss_family == AF_INET6;
+      struct sockaddr_in* addr   = (struct sockaddr_in*) &rx_addrs[i];
+      struct sockaddr_in6* addr6 = (struct sockaddr_in6*) &rx_addrs[i];
+
+      MessageDef* message_p =
           DEPRECATEDitti_alloc_new_message_fatal(TASK_UDP, UDP_DATA_IND);
-      udp_data_ind_p = &message_p->ittiMsg.udp_data_ind;
-      memcpy(udp_data_ind_p->msgBuf, udp_sock_pP->buffer, bytes_received);
+      udp_data_ind_t* udp_data_ind_p = &message_p->ittiMsg.udp_data_ind;
+      memcpy(udp_data_ind_p->msgBuf, rx_bufs[i], bytes_received);
 
       udp_data_ind_p->buffer_length = bytes_received;
       udp_data_ind_p->local_port    = udp_sock_pP->local_port;
       udp_data_ind_p->peer_port =
-          ipv6 ? htons(addr6.sin6_port) : htons(addr.sin_port);
+          ipv6 ? htons(addr6->sin6_port) : htons(addr->sin_port);
       memcpy(
           (void*) &udp_data_ind_p->sock_addr,
-          (ipv6) ? (void*) &addr6 : (void*) &addr,
+          (ipv6) ? (void*) addr6 : (void*) addr,
           (ipv6) ? sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in));
 
       OAILOG_DEBUG(
-          LOG_UDP, "Msg of length %d received from %s:%u\n", bytes_received,
-          (!ipv6) ? inet_ntoa(addr.sin_addr) : "TODO_IPV6",
-          ntohs(addr.sin_port));
+          LOG_UDP, "Msg of length %u received from %s:%u\n", bytes_received,
+          (!ipv6) ? inet_ntoa(addr->sin_addr) : "TODO_IPV6",
+          ntohs(addr->sin_port));
 
       if (send_msg_to_task(&udp_task_zmq_ctx, udp_sock_pP->task_id, message_p) <
           0) {
         OAILOG_DEBUG(
             LOG_UDP, "Failed to send message %d to task %d\n", UDP_DATA_IND,
             udp_sock_pP->task_id);
-        // break;
       }
     }
+  } while (num_received == UDP_RX_BATCH_SIZE);
+  return RETURNok;
+}
+
+/* @brief Receive loop of one SO_REUSEPORT shard: the socket is blocking, so
+ * recvmmsg() sleeps until at least one datagram is available and returns a
+ * whole batch under load.
+ */
+static void* udp_shard_receiver_thread(void* args) {
+  struct udp_socket_desc_s* udp_sock_p = (struct udp_socket_desc_s*) args;
+
+  while (udp_server_drain_socket(udp_sock_p) == RETURNok) {
   }
+  return NULL;
 }
 
 static int udp_socket_handler(zloop_t* loop, zmq_pollitem_t* item, void* arg) {
@@ -183,7 +227,7 @@ static int udp_socket_handler(zloop_t* loop, zmq_pollitem_t* item, void* arg) {
   udp_sock_p = udp_server_get_socket_desc_by_sd(item->fd);
 
   if (udp_sock_p != NULL) {
-    udp_server_receive_and_process(udp_sock_p);
+    udp_server_drain_socket(udp_sock_p);
   } else {
     OAILOG_ERROR(
         LOG_UDP, "Failed to retrieve the udp socket descriptor %d", item->fd);
@@ -199,83 +243,115 @@ static int udp_server_create_socket_v4(
     uint16_t port, struct in_addr* address, task_id_t task_id) {
   struct sockaddr_in addr;
   int sd;
+  int first_sd   = -1;
+  int num_shards = udp_num_shards();
   struct udp_socket_desc_s* socket_desc_p = NULL;
 
-  // OAILOG_INFO();
-  /*
-   * Create UDP socket
-   */
-  if ((sd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)) < 0) {
+  for (int shard = 0; shard < num_shards; shard++) {
     /*
-     * Socket creation has failed...
+     * Create UDP socket
      */
-    OAILOG_ERROR(
-        LOG_UDP, "IPv4 socket creation failed (%s)\n", strerror(errno));
-    return sd;
-  }
+    if ((sd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)) < 0) {
+      /*
+       * Socket creation has failed...
+       */
+      OAILOG_ERROR(
+          LOG_UDP, "IPv4 socket creation failed (%s)\n", strerror(errno));
+      return sd;
+    }
 
-  memset(&addr, 0, sizeof(struct sockaddr_in));
-  addr.sin_family = AF_INET;
-  addr.sin_port   = htons(port);
-  addr.sin_addr   = *address;
+    if (num_shards > 1) {
+      int on = 1;
+      if (setsockopt(sd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) < 0) {
+        OAILOG_ERROR(
+            LOG_UDP, "setsockopt SO_REUSEPORT failed for IPv4: %s\n",
+            strerror(errno));
+        close(sd);
+        return -1;
+      }
+    }
 
-  char ipv4[INET_ADDRSTRLEN];
-  inet_ntop(AF_INET, (void*) &addr.sin_addr, ipv4, INET_ADDRSTRLEN);
-  OAILOG_DEBUG(
-      LOG_UDP,
-      "Creating new listen socket on IPv4 address %s and port %" PRIu16 "\n",
-      ipv4, port);
+    memset(&addr, 0, sizeof(struct sockaddr_in));
+    addr.sin_family = AF_INET;
+    addr.sin_port   = htons(port);
+    addr.sin_addr   = *address;
+
+    char ipv4[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, (void*) &addr.sin_addr, ipv4, INET_ADDRSTRLEN);
+    OAILOG_DEBUG(
+        LOG_UDP,
+        "Creating new listen socket on IPv4 address %s and port %" PRIu16 "\n",
+        ipv4, port);
+
+    if (bind(sd, (struct sockaddr*) &addr, sizeof(struct sockaddr_in)) < 0) {
+      /*
+       * Bind failed
+       */
+      OAILOG_ERROR(
+          LOG_UDP,
+          "Socket bind failed (%s) for IPv4 address %s and port %" PRIu16 "\n",
+          strerror(errno), ipv4, port);
+      close(sd);
+      return -1;
+    }
+    struct sockaddr_in addr_check;
+    socklen_t len = sizeof(addr_check);
+    if (getsockname(sd, (struct sockaddr*) &addr_check, &len) != -1)
+      OAILOG_DEBUG(
+          LOG_UDP, "Listened on port %" PRIu16 " for IPv4. \n",
+          ntohs(addr_check.sin_port));
 
-  if (bind(sd, (struct sockaddr*) &addr, sizeof(struct sockaddr_in)) < 0) {
     /*
-     * Bind failed
+     * A single shard is polled on the task loop and must not block; shards
+     * of a multi-socket endpoint each get a blocking receive thread
      */
-    OAILOG_ERROR(
-        LOG_UDP,
-        "Socket bind failed (%s) for IPv4 address %s and port %" PRIu16 "\n",
-        strerror(errno), ipv4, port);
-    close(sd);
-    return -1;
-  }
-  struct sockaddr_in addr_check;
-  socklen_t len = sizeof(addr_check);
-  if (getsockname(sd, (struct sockaddr*) &addr_check, &len) != -1)
-    OAILOG_DEBUG(
-        LOG_UDP, "Listened on port %" PRIu16 " for IPv4. \n",
-        ntohs(addr_check.sin_port));
-
-  /*
-   * Add the socket to list of fd monitored by ITTI
-   */
-  /*
-   * Mark the socket as non-blocking
-   */
-  if (fcntl(sd, F_SETFL, O_NONBLOCK) < 0) {
-    OAILOG_ERROR(
-        LOG_UDP, "fcntl F_SETFL O_NONBLOCK failed for IPv4: %s\n",
-        strerror(errno));
-    close(sd);
-    return -1;
-  }
+    if (num_shards == 1) {
+      if (fcntl(sd, F_SETFL, O_NONBLOCK) < 0) {
+        OAILOG_ERROR(
+            LOG_UDP, "fcntl F_SETFL O_NONBLOCK failed for IPv4: %s\n",
+            strerror(errno));
+        close(sd);
+        return -1;
+      }
+    }
 
-  socket_desc_p = calloc(1, sizeof(struct udp_socket_desc_s));
-  DevAssert(socket_desc_p != NULL);
-  socket_desc_p->sd                                            = sd;
-  ((struct sockaddr_in*) &socket_desc_p->local_addr)->sin_addr = *address;
-  socket_desc_p->local_addr.sa_family                          = AF_INET;
-  socket_desc_p->local_port = ntohs(addr_check.sin_port);
-  socket_desc_p->task_id    = task_id;
-  OAILOG_DEBUG(
-      LOG_UDP, "(IPv4) Inserting new descriptor for task %d, sd %d\n",
-      socket_desc_p->task_id, socket_desc_p->sd);
-  pthread_mutex_lock(&udp_socket_list_mutex);
-  STAILQ_INSERT_TAIL(&udp_socket_list, socket_desc_p, entries);
-  pthread_mutex_unlock(&udp_socket_list_mutex);
+    socket_desc_p = calloc(1, sizeof(struct udp_socket_desc_s));
+    DevAssert(socket_desc_p != NULL);
+    socket_desc_p->sd                                            = sd;
+    ((struct sockaddr_in*) &socket_desc_p->local_addr)->sin_addr = *address;
+    socket_desc_p->local_addr.sa_family                          = AF_INET;
+    socket_desc_p->local_port = ntohs(addr_check.sin_port);
+    socket_desc_p->task_id    = task_id;
+    OAILOG_DEBUG(
+        LOG_UDP, "(IPv4) Inserting new descriptor for task %d, sd %d\n",
+        socket_desc_p->task_id, socket_desc_p->sd);
+    pthread_mutex_lock(&udp_socket_list_mutex);
+    STAILQ_INSERT_TAIL(&udp_socket_list, socket_desc_p, entries);
+    pthread_mutex_unlock(&udp_socket_list_mutex);
+
+    if (num_shards == 1) {
+      zmq_pollitem_t item = {0, sd, ZMQ_POLLIN, 0};
+      zloop_poller(
+          udp_task_zmq_ctx.event_loop, &item, udp_socket_handler, NULL);
+    } else {
+      socket_desc_p->sharded = true;
+      if (pthread_create(
+              &socket_desc_p->listener_thread, NULL, udp_shard_receiver_thread,
+              socket_desc_p) != 0) {
+        OAILOG_ERROR(
+            LOG_UDP, "pthread_create failed for IPv4 shard %d: %s\n", shard,
+            strerror(errno));
+        close(sd);
+        return -1;
+      }
+    }
 
-  zmq_pollitem_t item = {0, sd, ZMQ_POLLIN, 0};
-  zloop_poller(udp_task_zmq_ctx.event_loop, &item, udp_socket_handler, NULL);
+    if (shard == 0) {
+      first_sd = sd;
+    }
+  }
 
-  return sd;
+  return first_sd;
 }
 
 //------------------------------------------------------------------------------
@@ -283,81 +359,115 @@ static int udp_server_create_socket_v6(
     uint16_t port, struct in6_addr* address, task_id_t task_id) {
   struct sockaddr_in6 addr;
   int sd;
+  int first_sd   = -1;
+  int num_shards = udp_num_shards();
   struct udp_socket_desc_s* socket_desc_p = NULL;
 
-  /*
-   * Create UDP socket
-   */
-  if ((sd = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP)) < 0) {
+  for (int shard = 0; shard < num_shards; shard++) {
     /*
-     * Socket creation has failed...
+     * Create UDP socket
      */
-    OAILOG_ERROR(
-        LOG_UDP, "IPv6 socket creation failed (%s)\n", strerror(errno));
-    return sd;
-  }
+    if ((sd = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP)) < 0) {
+      /*
+       * Socket creation has failed...
+       */
+      OAILOG_ERROR(
+          LOG_UDP, "IPv6 socket creation failed (%s)\n", strerror(errno));
+      return sd;
+    }
 
-  memset(&addr, 0, sizeof(struct sockaddr_in6));
-  addr.sin6_family = AF_INET6;
-  addr.sin6_port   = htons(port);
-  addr.sin6_addr   = *address;
+    if (num_shards > 1) {
+      int on = 1;
+      if (setsockopt(sd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) < 0) {
+        OAILOG_ERROR(
+            LOG_UDP, "setsockopt SO_REUSEPORT failed for IPv6: %s\n",
+            strerror(errno));
+        close(sd);
+        return -1;
+      }
+    }
 
-  char ipv6[INET6_ADDRSTRLEN];
-  inet_ntop(AF_INET6, (void*) &addr, ipv6, INET6_ADDRSTRLEN);
-  OAILOG_DEBUG(
-      LOG_UDP,
-      "Creating new listen socket on IPv6 address %s and port %" PRIu16 "\n",
-      ipv6, port);
+    memset(&addr, 0, sizeof(struct sockaddr_in6));
+    addr.sin6_family = AF_INET6;
+    addr.sin6_port   = htons(port);
+    addr.sin6_addr   = *address;
+
+    char ipv6[INET6_ADDRSTRLEN];
+    inet_ntop(AF_INET6, (void*) &addr, ipv6, INET6_ADDRSTRLEN);
+    OAILOG_DEBUG(
+        LOG_UDP,
+        "Creating new listen socket on IPv6 address %s and port %" PRIu16 "\n",
+        ipv6, port);
+
+    if (bind(sd, (struct sockaddr*) &addr, sizeof(struct sockaddr_in6)) < 0) {
+      /*
+       * Bind failed
+       */
+      //    OAILOG_ERROR (LOG_UDP, "Socket bind failed (%s) for address %s and
+      //    port %" PRIu16 "\n", strerror (errno), ipv4, port);
+      close(sd);
+      return -1;
+    }
+    struct sockaddr_in addr_check;
+    socklen_t len = sizeof(addr_check);
+    if (getsockname(sd, (struct sockaddr*) &addr_check, &len) != -1)
+      OAILOG_DEBUG(
+          LOG_UDP, "Listened on port %" PRIu16 " for IPv6. \n",
+          ntohs(addr_check.sin_port));
 
-  if (bind(sd, (struct sockaddr*) &addr, sizeof(struct sockaddr_in6)) < 0) {
     /*
-     * Bind failed
+     * A single shard is polled on the task loop and must not block; shards
+     * of a multi-socket endpoint each get a blocking receive thread
      */
-    //    OAILOG_ERROR (LOG_UDP, "Socket bind failed (%s) for address %s and
-    //    port %" PRIu16 "\n", strerror (errno), ipv4, port);
-    close(sd);
-    return -1;
-  }
-  struct sockaddr_in addr_check;
-  socklen_t len = sizeof(addr_check);
-  if (getsockname(sd, (struct sockaddr*) &addr_check, &len) != -1)
-    OAILOG_DEBUG(
-        LOG_UDP, "Listened on port %" PRIu16 " for IPv6. \n",
-        ntohs(addr_check.sin_port));
-
-  /*
-   * Add the socket to list of fd monitored by ITTI
-   */
-  /*
-   * Mark the socket as non-blocking
-   */
-  if (fcntl(sd, F_SETFL, O_NONBLOCK) < 0) {
-    OAILOG_ERROR(
-        LOG_UDP, "fcntl F_SETFL O_NONBLOCK failed: %s\n", strerror(errno));
-    close(sd);
-    return -1;
-  }
+    if (num_shards == 1) {
+      if (fcntl(sd, F_SETFL, O_NONBLOCK) < 0) {
+        OAILOG_ERROR(
+            LOG_UDP, "fcntl F_SETFL O_NONBLOCK failed: %s\n", strerror(errno));
+        close(sd);
+        return -1;
+      }
+    }
 
-  socket_desc_p = calloc(1, sizeof(struct udp_socket_desc_s));
-  DevAssert(socket_desc_p != NULL);
-  socket_desc_p->sd                                              = sd;
-  ((struct sockaddr_in6*) &socket_desc_p->local_addr)->sin6_addr = *address;
-  socket_desc_p->local_addr.sa_family                            = AF_INET6;
-
-  //  ((struct sockaddr_in6*)&socket_desc_p->local_addr)->sin6_family = AF_INET;
-  socket_desc_p->local_port = ntohs(addr_check.sin_port);
-  socket_desc_p->task_id    = task_id;
-  OAILOG_DEBUG(
-      LOG_UDP, "(IPv6) Inserting new descriptor for task %d, sd %d\n",
-      socket_desc_p->task_id, socket_desc_p->sd);
-  pthread_mutex_lock(&udp_socket_list_mutex);
-  STAILQ_INSERT_TAIL(&udp_socket_list, socket_desc_p, entries);
-  pthread_mutex_unlock(&udp_socket_list_mutex);
+    socket_desc_p = calloc(1, sizeof(struct udp_socket_desc_s));
+    DevAssert(socket_desc_p != NULL);
+    socket_desc_p->sd                                              = sd;
+    ((struct sockaddr_in6*) &socket_desc_p->local_addr)->sin6_addr = *address;
+    socket_desc_p->local_addr.sa_family                            = AF_INET6;
 
-  zmq_pollitem_t item = {0, sd, ZMQ_POLLIN, 0};
-  zloop_poller(udp_task_zmq_ctx.event_loop, &item, udp_socket_handler, NULL);
+    //  ((struct sockaddr_in6*)&socket_desc_p->local_addr)->sin6_family =
+    //  AF_INET;
+    socket_desc_p->local_port = ntohs(addr_check.sin_port);
+    socket_desc_p->task_id    = task_id;
+    OAILOG_DEBUG(
+        LOG_UDP, "(IPv6) Inserting new descriptor for task %d, sd %d\n",
+        socket_desc_p->task_id, socket_desc_p->sd);
+    pthread_mutex_lock(&udp_socket_list_mutex);
+    STAILQ_INSERT_TAIL(&udp_socket_list, socket_desc_p, entries);
+    pthread_mutex_unlock(&udp_socket_list_mutex);
+
+    if (num_shards == 1) {
+      zmq_pollitem_t item = {0, sd, ZMQ_POLLIN, 0};
+      zloop_poller(
+          udp_task_zmq_ctx.event_loop, &item, udp_socket_handler, NULL);
+    } else {
+      socket_desc_p->sharded = true;
+      if (pthread_create(
+              &socket_desc_p->listener_thread, NULL, udp_shard_receiver_thread,
+              socket_desc_p) != 0) {
+        OAILOG_ERROR(
+            LOG_UDP, "pthread_create failed for IPv6 shard %d: %s\n", shard,
+            strerror(errno));
+        close(sd);
+        return -1;
+      }
+    }
+
+    if (shard == 0) {
+      first_sd = sd;
+    }
+  }
 
-  return sd;
+  return first_sd;
 }
 
 static int handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
@@ -531,6 +641,8 @@ int udp_init(void) {
 void udp_exit(void) {
   struct udp_socket_desc_s* socket_desc_p = NULL;
   while ((socket_desc_p = STAILQ_FIRST(&udp_socket_list))) {
+    // Wake any shard receive thread blocked in recvmmsg
+    shutdown(socket_desc_p->sd, SHUT_RDWR);
     close(socket_desc_p->sd);
     pthread_mutex_destroy(&udp_socket_list_mutex);
     STAILQ_REMOVE_HEAD(&udp_socket_list, entries);
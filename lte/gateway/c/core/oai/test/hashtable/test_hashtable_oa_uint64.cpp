@@ -0,0 +1,154 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "hashtable.h"
+#include "hashtable_oa_uint64.h"
+}
+
+// The value stored under every key in these tests; a torn read can only
+// surface as a key paired with another key's value
+static uint64_t value_of(uint64_t key) {
+  return key * 2654435761ULL + 1;
+}
+
+TEST(TestHashtableOaUint64, InsertGetRemove) {
+  hash_table_oa_uint64_ts_t* htbl =
+      hashtable_oa_uint64_ts_create(16, nullptr, nullptr);
+  ASSERT_NE(htbl, nullptr);
+
+  uint64_t data = 0;
+  EXPECT_EQ(
+      hashtable_oa_uint64_ts_get(htbl, 42, &data), HASH_TABLE_KEY_NOT_EXISTS);
+
+  EXPECT_EQ(hashtable_oa_uint64_ts_insert(htbl, 42, 1001), HASH_TABLE_OK);
+  EXPECT_EQ(hashtable_oa_uint64_ts_get(htbl, 42, &data), HASH_TABLE_OK);
+  EXPECT_EQ(data, 1001);
+  EXPECT_EQ(hashtable_oa_uint64_ts_is_key_exists(htbl, 42), HASH_TABLE_OK);
+
+  EXPECT_EQ(
+      hashtable_oa_uint64_ts_insert(htbl, 42, 1001),
+      HASH_TABLE_SAME_KEY_VALUE_EXISTS);
+  EXPECT_EQ(
+      hashtable_oa_uint64_ts_insert(htbl, 42, 1002),
+      HASH_TABLE_INSERT_OVERWRITTEN_DATA);
+  EXPECT_EQ(hashtable_oa_uint64_ts_get(htbl, 42, &data), HASH_TABLE_OK);
+  EXPECT_EQ(data, 1002);
+
+  EXPECT_EQ(hashtable_oa_uint64_ts_remove(htbl, 42), HASH_TABLE_OK);
+  EXPECT_EQ(
+      hashtable_oa_uint64_ts_remove(htbl, 42), HASH_TABLE_KEY_NOT_EXISTS);
+  EXPECT_EQ(
+      hashtable_oa_uint64_ts_get(htbl, 42, &data), HASH_TABLE_KEY_NOT_EXISTS);
+
+  EXPECT_EQ(hashtable_oa_uint64_ts_destroy(htbl), HASH_TABLE_OK);
+}
+
+TEST(TestHashtableOaUint64, GrowKeepsAllEntries) {
+  // Start at the minimum capacity so insertion has to grow several times
+  hash_table_oa_uint64_ts_t* htbl =
+      hashtable_oa_uint64_ts_create(1, nullptr, nullptr);
+  ASSERT_NE(htbl, nullptr);
+
+  const uint64_t num_keys = 10000;
+  for (uint64_t key = 1; key <= num_keys; key++) {
+    ASSERT_EQ(
+        hashtable_oa_uint64_ts_insert(htbl, key, value_of(key)),
+        HASH_TABLE_OK);
+  }
+  for (uint64_t key = 1; key <= num_keys; key++) {
+    uint64_t data = 0;
+    ASSERT_EQ(hashtable_oa_uint64_ts_get(htbl, key, &data), HASH_TABLE_OK);
+    ASSERT_EQ(data, value_of(key));
+  }
+
+  // Remove the even keys; the odd ones must survive the backward shifts
+  for (uint64_t key = 2; key <= num_keys; key += 2) {
+    ASSERT_EQ(hashtable_oa_uint64_ts_remove(htbl, key), HASH_TABLE_OK);
+  }
+  for (uint64_t key = 1; key <= num_keys; key++) {
+    uint64_t data       = 0;
+    hashtable_rc_t rc   = hashtable_oa_uint64_ts_get(htbl, key, &data);
+    hashtable_rc_t want =
+        (key & 1) ? HASH_TABLE_OK : HASH_TABLE_KEY_NOT_EXISTS;
+    ASSERT_EQ(rc, want);
+    if (rc == HASH_TABLE_OK) {
+      ASSERT_EQ(data, value_of(key));
+    }
+  }
+
+  EXPECT_EQ(hashtable_oa_uint64_ts_destroy(htbl), HASH_TABLE_OK);
+}
+
+TEST(TestHashtableOaUint64, LockFreeReadersSeeConsistentEntries) {
+  // Readers probe lock-free under the seqlock while a writer churns the
+  // table through inserts, removals and grows; a key must never come back
+  // paired with another key's value
+  hash_table_oa_uint64_ts_t* htbl =
+      hashtable_oa_uint64_ts_create(1, nullptr, nullptr);
+  ASSERT_NE(htbl, nullptr);
+
+  const uint64_t stable_keys = 512;
+  for (uint64_t key = 1; key <= stable_keys; key++) {
+    ASSERT_EQ(
+        hashtable_oa_uint64_ts_insert(htbl, key, value_of(key)),
+        HASH_TABLE_OK);
+  }
+
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> mismatches{0};
+
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; t++) {
+    readers.emplace_back([&] {
+      uint64_t key = 1;
+      while (!stop.load(std::memory_order_relaxed)) {
+        uint64_t data = 0;
+        if (hashtable_oa_uint64_ts_get(htbl, key, &data) == HASH_TABLE_OK) {
+          if (data != value_of(key)) {
+            mismatches.fetch_add(1, std::memory_order_relaxed);
+          }
+        } else if (key <= stable_keys) {
+          // stable keys are never removed
+          mismatches.fetch_add(1, std::memory_order_relaxed);
+        }
+        key = (key % (2 * stable_keys)) + 1;
+      }
+    });
+  }
+
+  // Writer: churn keys above the stable range so the table keeps growing
+  // and shrinking while the readers probe
+  for (int round = 0; round < 200; round++) {
+    for (uint64_t key = stable_keys + 1; key <= 2 * stable_keys; key++) {
+      ASSERT_EQ(
+          hashtable_oa_uint64_ts_insert(htbl, key, value_of(key)),
+          HASH_TABLE_OK);
+    }
+    for (uint64_t key = stable_keys + 1; key <= 2 * stable_keys; key++) {
+      ASSERT_EQ(hashtable_oa_uint64_ts_remove(htbl, key), HASH_TABLE_OK);
+    }
+  }
+
+  stop = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(mismatches.load(), 0);
+  EXPECT_EQ(hashtable_oa_uint64_ts_destroy(htbl), HASH_TABLE_OK);
+}
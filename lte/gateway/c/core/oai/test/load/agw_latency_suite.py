@@ -0,0 +1,273 @@
+#!/usr/bin/env python3
+#
+# Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.
+# The OpenAirInterface Software Alliance licenses this file to You under
+# the terms found in the LICENSE file in the root of this source tree.
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#-------------------------------------------------------------------------------
+# For more information about the OpenAirInterface (OAI) Software Alliance:
+#      contact@openairinterface.org
+#
+"""AGW latency conformance suite.
+
+Runs the standardized load scenarios against the benchmark drivers built
+in this tree and emits one machine-readable JSON report per run, so a
+nightly job can answer "did this release make the gateway slower" by
+diffing two reports:
+
+    agw_latency_suite.py --output tonight.json --baseline lastnight.json
+
+Scenarios whose driver is not built (e.g. session_manager_bench lives in
+the sessiond build tree; point AGW_SESSIOND_BENCH or --sessiond-bench at
+it) are recorded as skipped rather than failing the run. Regression
+thresholds come from agw_latency_thresholds.json next to this script and
+can be overridden per scenario. Exit code is non-zero when any metric
+regresses past its threshold against the baseline.
+"""
+
+import argparse
+import datetime
+import json
+import os
+import platform
+import re
+import subprocess
+import sys
+import threading
+import time
+
+# done: 20000 messages in 10.001 s (2000 msg/s), 0 decode failures
+ATTACH_DONE_RE = re.compile(
+    r'done: (\d+) messages in ([\d.]+) s \((\d+) msg/s\), (\d+) decode')
+# "  TASK_TEST_1  S1AP_INITIAL_UE_MESSAGE  handler  p99   123.4 us"
+ITTI_QUANTILE_RE = re.compile(
+    r'^\s+\S+\s+\S+\s+\S+\s+(p\d+)\s+([\d.]+) us\s*$')
+# [    30s] 41231 ops (1374.4/s) p50=12us p99=840us sessions=4983 rss=...
+SESSIOND_REPORT_RE = re.compile(
+    r'\[\s*(\d+)s\] (\d+) ops \(([\d.]+)/s\) p50=(\d+)us p99=(\d+)us '
+    r'sessions=(\d+) rss=(\d+)KB')
+# done: 412310 ops total, 4983 sessions active, rss 81234 KB (started at ...
+SESSIOND_DONE_RE = re.compile(
+    r'done: (\d+) ops total, (\d+) sessions active, rss (\d+) KB')
+
+
+def sample_peak_rss_kb(pid, stop_event, result):
+    """Polls VmHWM of the child so its high-water mark survives exit."""
+    path = '/proc/%d/status' % pid
+    while not stop_event.is_set():
+        try:
+            with open(path) as f:
+                for line in f:
+                    if line.startswith('VmHWM:'):
+                        result['peak_rss_kb'] = int(line.split()[1])
+                        break
+        except OSError:
+            return
+        time.sleep(0.2)
+
+
+def run_driver(cmd, env_extra=None, timeout_secs=600):
+    """Runs one driver, returning (exit code, stdout, peak RSS in KB)."""
+    env = dict(os.environ)
+    if env_extra:
+        env.update(env_extra)
+    proc = subprocess.Popen(
+        cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, env=env,
+        universal_newlines=True)
+    rss = {'peak_rss_kb': 0}
+    stop = threading.Event()
+    sampler = threading.Thread(
+        target=sample_peak_rss_kb, args=(proc.pid, stop, rss))
+    sampler.start()
+    try:
+        out, _ = proc.communicate(timeout=timeout_secs)
+    except subprocess.TimeoutExpired:
+        proc.kill()
+        out, _ = proc.communicate()
+        return -1, out, rss['peak_rss_kb']
+    finally:
+        stop.set()
+        sampler.join()
+    return proc.returncode, out, rss['peak_rss_kb']
+
+
+def parse_attach_storm(out):
+    metrics = {}
+    m = ATTACH_DONE_RE.search(out)
+    if not m:
+        return None
+    metrics['throughput_per_sec'] = float(m.group(3))
+    metrics['failures'] = int(m.group(4))
+    # Worst per-stage quantiles across the ITTI pipeline
+    for quantile in ('p50', 'p99'):
+        values = [
+            float(q.group(2)) for q in
+            (ITTI_QUANTILE_RE.match(line) for line in out.splitlines())
+            if q and q.group(1) == quantile]
+        if values:
+            metrics[quantile + '_us'] = max(values)
+    return metrics
+
+
+def parse_sessiond_bench(out):
+    metrics = {}
+    reports = [SESSIOND_REPORT_RE.search(l) for l in out.splitlines()]
+    reports = [m for m in reports if m]
+    if not reports:
+        return None
+    # Skip the warmup interval when there is more than one report
+    steady = reports[1:] if len(reports) > 1 else reports
+    metrics['throughput_per_sec'] = sum(
+        float(m.group(3)) for m in steady) / len(steady)
+    metrics['p50_us'] = max(int(m.group(4)) for m in steady)
+    metrics['p99_us'] = max(int(m.group(5)) for m in steady)
+    done = SESSIOND_DONE_RE.search(out)
+    if done:
+        metrics['rss_end_kb'] = int(done.group(3))
+    return metrics
+
+
+# One entry per standardized scenario. 'driver' names the CLI/env handle
+# the binary comes from; scenarios for drivers that are not present are
+# reported as skipped so partial trees still produce comparable reports.
+SCENARIOS = [
+    {
+        'name': 'attach_storm',
+        'driver': 'attach_storm_bench',
+        'args': ['--rate', '2000', '--count', '20000'],
+        'env': {'MAGMA_ITTI_LATENCY_SAMPLE_RATE': '1'},
+        'parse': parse_attach_storm,
+    },
+    {
+        # Handover-wave stand-in: heavy session reconfiguration churn
+        'name': 'handover_wave',
+        'driver': 'sessiond_bench',
+        'args': ['--duration=30', '--subscribers=2000', '--mix=25:50:25'],
+        'env': {},
+        'parse': parse_sessiond_bench,
+    },
+    {
+        'name': 'poll_stats_50k',
+        'driver': 'sessiond_bench',
+        'args': ['--duration=60', '--subscribers=50000', '--mix=5:90:5',
+                 '--report-interval=15'],
+        'env': {},
+        'parse': parse_sessiond_bench,
+    },
+]
+
+
+def run_scenarios(drivers):
+    results = {}
+    for scenario in SCENARIOS:
+        name = scenario['name']
+        driver = drivers.get(scenario['driver'])
+        if not driver or not os.access(driver, os.X_OK):
+            print('%-16s skipped (%s not built)' % (name, scenario['driver']))
+            results[name] = {'status': 'skipped'}
+            continue
+        print('%-16s running...' % name)
+        code, out, peak_rss_kb = run_driver(
+            [driver] + scenario['args'], scenario['env'])
+        metrics = scenario['parse'](out) if code == 0 else None
+        if metrics is None:
+            print('%-16s FAILED (exit %d)' % (name, code))
+            results[name] = {'status': 'failed', 'exit_code': code}
+            continue
+        if peak_rss_kb:
+            metrics['peak_rss_kb'] = peak_rss_kb
+        results[name] = {'status': 'ok', 'metrics': metrics}
+        print('%-16s %s' % (name, json.dumps(metrics)))
+    return results
+
+
+# Metrics where larger is better; everything else regresses by growing
+HIGHER_IS_BETTER = frozenset(['throughput_per_sec'])
+
+
+def compare_to_baseline(results, baseline, thresholds):
+    """Returns a list of human-readable regression descriptions."""
+    regressions = []
+    for name, result in sorted(results.items()):
+        if result.get('status') != 'ok':
+            continue
+        base = baseline.get('scenarios', {}).get(name, {})
+        if base.get('status') != 'ok':
+            continue
+        limits = dict(thresholds.get('default', {}))
+        limits.update(thresholds.get(name, {}))
+        for metric, value in sorted(result['metrics'].items()):
+            if metric not in limits or metric not in base['metrics']:
+                continue
+            base_value = base['metrics'][metric]
+            if base_value <= 0:
+                continue
+            if metric in HIGHER_IS_BETTER:
+                change_pct = 100.0 * (base_value - value) / base_value
+            else:
+                change_pct = 100.0 * (value - base_value) / base_value
+            allowed = limits[metric]
+            if change_pct > allowed:
+                regressions.append(
+                    '%s: %s regressed %.1f%% (%.1f -> %.1f, allowed %.1f%%)'
+                    % (name, metric, change_pct, base_value, value, allowed))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='AGW latency conformance suite')
+    parser.add_argument(
+        '--attach-storm-bench',
+        default=os.environ.get('AGW_ATTACH_STORM_BENCH'))
+    parser.add_argument(
+        '--sessiond-bench', default=os.environ.get('AGW_SESSIOND_BENCH'))
+    parser.add_argument('--output', required=True)
+    parser.add_argument('--baseline')
+    parser.add_argument(
+        '--thresholds',
+        default=os.path.join(
+            os.path.dirname(os.path.abspath(__file__)),
+            'agw_latency_thresholds.json'))
+    args = parser.parse_args()
+
+    drivers = {
+        'attach_storm_bench': args.attach_storm_bench,
+        'sessiond_bench': args.sessiond_bench,
+    }
+    report = {
+        'suite': 'agw_latency_suite',
+        'timestamp': datetime.datetime.utcnow().isoformat() + 'Z',
+        'host': platform.node(),
+        'scenarios': run_scenarios(drivers),
+    }
+    with open(args.output, 'w') as f:
+        json.dump(report, f, indent=2, sort_keys=True)
+        f.write('\n')
+    print('report written to %s' % args.output)
+
+    if not args.baseline:
+        return 0
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    with open(args.thresholds) as f:
+        thresholds = json.load(f)
+    regressions = compare_to_baseline(
+        report['scenarios'], baseline, thresholds)
+    for regression in regressions:
+        print('REGRESSION %s' % regression)
+    if regressions:
+        return 1
+    print('no regressions against %s' % args.baseline)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
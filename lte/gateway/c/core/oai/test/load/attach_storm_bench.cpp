@@ -0,0 +1,207 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Attach storm load driver.
+ *
+ * Reproduces the eNB-reboot storm profile without an eNB or SCTP: a driver
+ * thread injects synthetic S1AP_INITIAL_UE_MESSAGE messages carrying a real
+ * attach request NAS payload straight into the ITTI layer at a configurable
+ * rate, and a sink task decodes each payload the way the mme_app front end
+ * would. Per-stage latencies (queue wait and handler duration) come from the
+ * ITTI latency histograms; run with MAGMA_ITTI_LATENCY_SAMPLE_RATE=1 to
+ * sample every message.
+ *
+ * Usage: attach_storm_bench [--rate MSGS_PER_SEC] [--count MESSAGES]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+extern "C" {
+#define CHECK_PROTOTYPE_ONLY
+#include "intertask_interface_init.h"
+#undef CHECK_PROTOTYPE_ONLY
+#include "AttachRequest.h"
+#include "bstrlib.h"
+#include "dynamic_memory_check.h"
+#include "intertask_interface.h"
+#include "intertask_interface_types.h"
+#include "itti_free_defined_msg.h"
+#include "itti_latency.h"
+}
+
+const task_info_t tasks_info[] = {
+    {THREAD_NULL, "TASK_UNKNOWN", "ipc://IPC_TASK_UNKNOWN"},
+#define TASK_DEF(tHREADiD)                                                     \
+  {THREAD_##tHREADiD, #tHREADiD, "ipc://IPC_" #tHREADiD},
+#include <tasks_def.h>
+#undef TASK_DEF
+};
+
+/* Map message id to message information */
+const message_info_t messages_info[] = {
+#define MESSAGE_DEF(iD, sTRUCT, fIELDnAME) {iD, sizeof(sTRUCT), #iD},
+#include <messages_def.h>
+#undef MESSAGE_DEF
+};
+
+/* Combined attach request captured from a Pixel 4, the same payload the
+ * mme_app decode tests use */
+static const uint8_t attach_request_payload[] = {
+    0x72, 0x08, 0x39, 0x51, 0x10, 0x00, 0x30, 0x09, 0x01, 0x07, 0x07, 0xf0,
+    0x70, 0xc0, 0x40, 0x19, 0x00, 0x80, 0x00, 0x34, 0x02, 0x0c, 0xd0, 0x11,
+    0xd1, 0x27, 0x2d, 0x80, 0x80, 0x21, 0x10, 0x01, 0x00, 0x00, 0x10, 0x81,
+    0x06, 0x00, 0x00, 0x00, 0x00, 0x83, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x0d, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x05, 0x00, 0x00, 0x10, 0x00, 0x00,
+    0x11, 0x00, 0x00, 0x1a, 0x01, 0x01, 0x00, 0x23, 0x00, 0x00, 0x24, 0x00,
+    0x5c, 0x0a, 0x01, 0x31, 0x04, 0x65, 0xe0, 0x3e, 0x00, 0x90, 0x11, 0x03,
+    0x57, 0x58, 0xa6, 0x20, 0x0d, 0x60, 0x14, 0x04, 0xef, 0x65, 0x23, 0x3b,
+    0x88, 0x00, 0x92, 0xf2, 0x00, 0x00, 0x40, 0x08, 0x04, 0x02, 0x60, 0x04,
+    0x00, 0x02, 0x1f, 0x00, 0x5d, 0x01, 0x03, 0xc1};
+
+static task_zmq_ctx_t task_zmq_ctx_main, task_zmq_ctx_sink;
+
+static std::atomic<uint64_t> messages_received(0);
+static std::atomic<uint64_t> decode_failures(0);
+
+static int sink_handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
+  MessageDef* received_message_p = receive_msg(reader);
+
+  switch (ITTI_MSG_ID(received_message_p)) {
+    case TERMINATE_MESSAGE:
+      break;
+
+    case S1AP_INITIAL_UE_MESSAGE: {
+      // Decode the NAS payload the way the mme_app front end would
+      itti_s1ap_initial_ue_message_t* initial_pP =
+          &received_message_p->ittiMsg.s1ap_initial_ue_message;
+      attach_request_msg attach_request;
+      int rc = decode_attach_request(
+          &attach_request, initial_pP->nas->data, initial_pP->nas->slen);
+      if (rc < 0) {
+        decode_failures++;
+      } else {
+        bdestroy_wrapper(&attach_request.esmmessagecontainer);
+      }
+      messages_received++;
+    } break;
+
+    default:
+      break;
+  }
+  itti_free_msg_content(received_message_p);
+  free(received_message_p);
+  return 0;
+}
+
+static void* sink_thread(void* arg) {
+  task_id_t task_id_list[1] = {TASK_MAIN};
+  init_task_context(
+      TASK_TEST_1, task_id_list, 1, sink_handle_message, &task_zmq_ctx_sink);
+  zloop_start(task_zmq_ctx_sink.event_loop);
+  return NULL;
+}
+
+static void print_latency_stat(
+    const char* task_name, const char* message_name, const char* stage,
+    const char* quantile, double value_us) {
+  printf(
+      "  %-12s %-26s %-10s %-5s %10.1f us\n", task_name, message_name, stage,
+      quantile, value_us);
+}
+
+int main(int argc, char** argv) {
+  uint64_t rate  = 1000;   // messages per second
+  uint64_t count = 10000;  // total messages
+
+  for (int i = 1; i < argc - 1; i++) {
+    if (strcmp(argv[i], "--rate") == 0) {
+      rate = strtoull(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--count") == 0) {
+      count = strtoull(argv[++i], NULL, 10);
+    }
+  }
+  if (rate == 0 || count == 0) {
+    fprintf(stderr, "usage: %s [--rate MSGS_PER_SEC] [--count MESSAGES]\n",
+            argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (!getenv("MAGMA_ITTI_LATENCY_SAMPLE_RATE")) {
+    printf(
+        "note: MAGMA_ITTI_LATENCY_SAMPLE_RATE is unset, no per-stage "
+        "latency histograms will be collected\n");
+  }
+
+  itti_init(
+      TASK_MAX, THREAD_MAX, MESSAGES_ID_MAX, tasks_info, messages_info, NULL,
+      NULL);
+
+  task_id_t task_id_list[1] = {TASK_TEST_1};
+  init_task_context(TASK_MAIN, task_id_list, 1, NULL, &task_zmq_ctx_main);
+
+  std::thread sink(sink_thread, nullptr);
+  sink.detach();
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  printf(
+      "injecting %lu attach initial UE messages at %lu/s\n",
+      (unsigned long) count, (unsigned long) rate);
+
+  const auto interval =
+      std::chrono::nanoseconds(std::chrono::seconds(1)) / rate;
+  const auto start = std::chrono::steady_clock::now();
+
+  for (uint64_t i = 0; i < count; i++) {
+    MessageDef* message_p = DEPRECATEDitti_alloc_new_message_fatal(
+        TASK_MAIN, S1AP_INITIAL_UE_MESSAGE);
+    itti_s1ap_initial_ue_message_t* initial_pP =
+        &message_p->ittiMsg.s1ap_initial_ue_message;
+    initial_pP->sctp_assoc_id  = 1;
+    initial_pP->enb_id         = 1;
+    initial_pP->enb_ue_s1ap_id = (enb_ue_s1ap_id_t)(i & 0x00FFFFFF);
+    initial_pP->nas            = blk2bstr(
+        attach_request_payload, sizeof(attach_request_payload));
+    initial_pP->rrc_establishment_cause = MO_SIGNALLING;
+    send_msg_to_task(&task_zmq_ctx_main, TASK_TEST_1, message_p);
+
+    std::this_thread::sleep_until(start + (i + 1) * interval);
+  }
+
+  // Drain: the sink counts every injected message
+  while (messages_received.load() < count) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  printf(
+      "done: %lu messages in %.3f s (%.0f msg/s), %lu decode failures\n",
+      (unsigned long) messages_received.load(), elapsed.count() / 1e6,
+      messages_received.load() * 1e6 / elapsed.count(),
+      (unsigned long) decode_failures.load());
+
+  if (itti_latency_enabled()) {
+    printf("per-stage latency quantiles:\n");
+    itti_latency_export_stats(print_latency_stat);
+  }
+
+  send_terminate_message_fatal(&task_zmq_ctx_main);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  destroy_task_context(&task_zmq_ctx_main);
+  destroy_task_context(&task_zmq_ctx_sink);
+  return decode_failures.load() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,54 @@
+#!/bin/bash
+# Copyright 2020 The Magma Authors.
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Two-pass profile-guided build of the MME tree.
+#
+# Pass 1 configures with PGO_GENERATE and runs the attach storm bench as
+# the representative workload, writing gcda profiles into
+# $MAGMA_ROOT/.pgo-profiles/oai. Pass 2 reconfigures with PGO_USE so the
+# optimizer consumes them. When llvm-bolt and a perf.data recorded
+# against the pass-2 oai_mme are available, the binary is additionally
+# laid out by BOLT (pass the perf.data path as $2).
+#
+# usage: pgo_build.sh <source-dir> [perf.data]
+
+set -e
+
+SRC_DIR="${1:?usage: pgo_build.sh <source-dir> [perf.data]}"
+PERF_DATA="${2:-}"
+PROFILE_DIR="${MAGMA_ROOT:?MAGMA_ROOT must be set}/.pgo-profiles/oai"
+BUILD_DIR="${SRC_DIR}/build-pgo"
+BENCH_COUNT="${PGO_BENCH_COUNT:-200000}"
+
+rm -rf "${PROFILE_DIR}"
+mkdir -p "${PROFILE_DIR}"
+
+# Pass 1: instrumented build, exercised by the attach storm bench
+cmake -S "${SRC_DIR}" -B "${BUILD_DIR}" -DCMAKE_BUILD_TYPE=Release \
+      -DBUILD_TESTS=1 -DPGO_GENERATE=1 -DPGO_USE=0
+cmake --build "${BUILD_DIR}" -j"$(nproc)"
+"${BUILD_DIR}/test/load/attach_storm_bench" --count "${BENCH_COUNT}"
+
+# Pass 2: optimized build consuming the recorded profiles
+cmake -S "${SRC_DIR}" -B "${BUILD_DIR}" -DCMAKE_BUILD_TYPE=Release \
+      -DBUILD_TESTS=0 -DPGO_GENERATE=0 -DPGO_USE=1
+cmake --build "${BUILD_DIR}" -j"$(nproc)"
+
+MME_BIN="${BUILD_DIR}/oai_mme/mme"
+
+# Optional BOLT pass: needs a perf record (-e cycles:u -j any,u) taken
+# while the pass-2 binary served load
+if [ -n "${PERF_DATA}" ] && command -v llvm-bolt > /dev/null; then
+  perf2bolt -p "${PERF_DATA}" -o "${MME_BIN}.fdata" "${MME_BIN}"
+  llvm-bolt "${MME_BIN}" -o "${MME_BIN}.bolt" -data "${MME_BIN}.fdata" \
+            -reorder-blocks=ext-tsp -reorder-functions=hfsort \
+            -split-functions -split-all-cold
+  echo "BOLT-optimized binary written to ${MME_BIN}.bolt"
+fi
@@ -0,0 +1,123 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <check.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "mme_tai_table.h"
+
+static uint16_t test_mcc[]     = {1, 1, 310};
+static uint16_t test_mnc[]     = {1, 1, 410};
+static uint16_t test_mnc_len[] = {2, 2, 3};
+static uint16_t test_tac[]     = {1, 2, 7};
+
+static void rebuild_test_table(void) {
+  served_tai_t served_tai = {
+      .list_type    = TRACKING_AREA_IDENTITY_LIST_TYPE_MANY_PLMNS,
+      .nb_tai       = 3,
+      .plmn_mcc     = test_mcc,
+      .plmn_mnc     = test_mnc,
+      .plmn_mnc_len = test_mnc_len,
+      .tac          = test_tac,
+  };
+  mme_tai_table_rebuild(&served_tai);
+}
+
+START_TEST(plmn_membership_test) {
+  rebuild_test_table();
+
+  ck_assert(mme_tai_table_plmn_served(1, 1, 2) == true);
+  ck_assert(mme_tai_table_plmn_served(310, 410, 3) == true);
+  /* A foreign PLMN must be rejected */
+  ck_assert(mme_tai_table_plmn_served(208, 94, 2) == false);
+  /* The MNC length is part of the identity: MNC 01 is not MNC 001 */
+  ck_assert(mme_tai_table_plmn_served(1, 1, 3) == false);
+}
+END_TEST
+
+START_TEST(tac_membership_test) {
+  rebuild_test_table();
+
+  ck_assert(mme_tai_table_tac_served(1) == true);
+  ck_assert(mme_tai_table_tac_served(2) == true);
+  ck_assert(mme_tai_table_tac_served(7) == true);
+  ck_assert(mme_tai_table_tac_served(3) == false);
+  ck_assert(mme_tai_table_tac_served(0xFFFF) == false);
+}
+END_TEST
+
+START_TEST(tai_membership_test) {
+  rebuild_test_table();
+
+  ck_assert(mme_tai_table_tai_served(1, 1, 2, 1) == true);
+  ck_assert(mme_tai_table_tai_served(310, 410, 3, 7) == true);
+  /* Served PLMN with a TAC it does not serve */
+  ck_assert(mme_tai_table_tai_served(310, 410, 3, 1) == false);
+  /* Served TAC under a foreign PLMN */
+  ck_assert(mme_tai_table_tai_served(208, 94, 2, 1) == false);
+}
+END_TEST
+
+START_TEST(rebuild_replaces_table_test) {
+  rebuild_test_table();
+  ck_assert(mme_tai_table_tac_served(7) == true);
+
+  uint16_t mcc[]          = {262};
+  uint16_t mnc[]          = {2};
+  uint16_t mnc_len[]      = {2};
+  uint16_t tac[]          = {42};
+  served_tai_t served_tai = {
+      .list_type =
+          TRACKING_AREA_IDENTITY_LIST_TYPE_ONE_PLMN_NON_CONSECUTIVE_TACS,
+      .nb_tai       = 1,
+      .plmn_mcc     = mcc,
+      .plmn_mnc     = mnc,
+      .plmn_mnc_len = mnc_len,
+      .tac          = tac,
+  };
+  mme_tai_table_rebuild(&served_tai);
+
+  ck_assert(mme_tai_table_plmn_served(262, 2, 2) == true);
+  ck_assert(mme_tai_table_tac_served(42) == true);
+  /* Entries of the previous configuration are gone */
+  ck_assert(mme_tai_table_plmn_served(1, 1, 2) == false);
+  ck_assert(mme_tai_table_tac_served(7) == false);
+}
+END_TEST
+
+Suite* mme_tai_table_suite(void) {
+  Suite* s  = suite_create("mme_tai_table");
+  TCase* tc = tcase_create("lookup");
+
+  tcase_add_test(tc, plmn_membership_test);
+  tcase_add_test(tc, tac_membership_test);
+  tcase_add_test(tc, tai_membership_test);
+  tcase_add_test(tc, rebuild_replaces_table_test);
+  suite_add_tcase(s, tc);
+  return s;
+}
+
+int main(void) {
+  int number_failed;
+  Suite* s    = mme_tai_table_suite();
+  SRunner* sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
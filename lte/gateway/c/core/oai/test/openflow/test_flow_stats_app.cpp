@@ -0,0 +1,185 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fluid/of13msg.hh>
+#include <memory>
+#include <vector>
+#include "ControllerEvents.h"
+#include "FlowStatsApplication.h"
+#include "OpenflowController.h"
+#include "gmock/gmock-matchers.h"
+#include "gmock/gmock-spec-builders.h"
+#include "openflow_mocks.h"
+
+using ::testing::_;
+using ::testing::Test;
+using namespace fluid_msg;
+using namespace openflow;
+
+namespace {
+
+/**
+ * Test fixture that wires a flow stats application into a controller.
+ */
+class FlowStatsApplicationTest : public ::testing::Test {
+ protected:
+  static const uint64_t TEST_UPLINK_COOKIE   = 1;
+  static const uint64_t TEST_DOWNLINK_COOKIE = 2;
+
+ protected:
+  virtual void SetUp() {
+    flow_stats_app = new FlowStatsApplication(std::vector<uint64_t>{
+        TEST_UPLINK_COOKIE, TEST_DOWNLINK_COOKIE});
+    messenger      = std::shared_ptr<MockMessenger>(new MockMessenger());
+
+    controller = std::unique_ptr<OpenflowController>(
+        new OpenflowController("127.0.0.1", 6666, 2, false, messenger));
+    controller->register_for_event(flow_stats_app, openflow::EVENT_SWITCH_UP);
+    controller->register_for_event(
+        flow_stats_app, openflow::EVENT_POLL_FLOW_STATS);
+    controller->register_for_event(
+        flow_stats_app, openflow::EVENT_FLOW_STATS_REPLY);
+  }
+
+  virtual void TearDown() {
+    controller = NULL;
+    messenger  = NULL;
+    delete flow_stats_app;
+  }
+
+  void dispatch_poll() {
+    PollFlowStatsEvent poll;
+    controller->dispatch_event(poll);
+  }
+
+  /**
+   * Packs the reply into a heap buffer owned by the event, the same way
+   * libfluid hands reply data to message_callback
+   */
+  void dispatch_reply(of13::MultipartReplyFlow& reply) {
+    uint8_t* packed = reply.pack();
+    size_t len      = reply.length();
+    void* data      = malloc(len);
+    memcpy(data, packed, len);
+    OFMsg::free_buffer(packed);
+    FlowStatsReplyEvent ev(NULL, *controller, data, len);
+    controller->dispatch_event(ev);
+  }
+
+  static of13::FlowStats make_flow_stats(
+      uint64_t cookie, uint64_t packets, uint64_t bytes) {
+    return of13::FlowStats(0, 0, 0, 0, 0, 0, 0, cookie, packets, bytes);
+  }
+
+ protected:
+  std::unique_ptr<OpenflowController> controller;
+  std::shared_ptr<MockMessenger> messenger;
+  FlowStatsApplication* flow_stats_app;
+};
+
+MATCHER_P(CheckStatsRequestCookie, cookie, "") {
+  if (arg.type() != of13::OFPT_MULTIPART_REQUEST) {
+    return false;
+  }
+  auto msg = static_cast<of13::MultipartRequestFlow*>(&arg);
+  return msg->cookie() == cookie;
+}
+
+/*
+ * Test that a poll sends one cookie-filtered stats request per tracked
+ * cookie, and that polls arriving while replies are outstanding get
+ * coalesced instead of re-requesting
+ */
+TEST_F(FlowStatsApplicationTest, TestPollRequestsAndCoalescing) {
+  EXPECT_CALL(
+      *messenger,
+      send_of_msg(CheckStatsRequestCookie(TEST_UPLINK_COOKIE), _))
+      .Times(1);
+  EXPECT_CALL(
+      *messenger,
+      send_of_msg(CheckStatsRequestCookie(TEST_DOWNLINK_COOKIE), _))
+      .Times(1);
+
+  dispatch_poll();
+  // Still two outstanding replies, so this poll must not send anything
+  dispatch_poll();
+}
+
+/*
+ * Test that reply segments are folded into per-cookie counters, that
+ * deltas accumulate between polls, and that a snapshot resets them
+ */
+TEST_F(FlowStatsApplicationTest, TestReplyFoldingAndSnapshot) {
+  EXPECT_CALL(*messenger, send_of_msg(_, _)).Times(4);
+
+  dispatch_poll();
+  // Uplink reply streams in two segments; downlink in one
+  of13::MultipartReplyFlow segment1(1, of13::OFPMPF_REPLY_MORE);
+  segment1.add_flow_stats(make_flow_stats(TEST_UPLINK_COOKIE, 10, 100));
+  dispatch_reply(segment1);
+  of13::MultipartReplyFlow segment2(1, 0);
+  segment2.add_flow_stats(make_flow_stats(TEST_UPLINK_COOKIE, 5, 50));
+  dispatch_reply(segment2);
+  of13::MultipartReplyFlow segment3(2, 0);
+  segment3.add_flow_stats(make_flow_stats(TEST_DOWNLINK_COOKIE, 7, 70));
+  dispatch_reply(segment3);
+
+  std::vector<flow_stats_entry> entries;
+  flow_stats_app->take_snapshot(&entries);
+  ASSERT_EQ(entries.size(), 2);
+  EXPECT_EQ(entries[0].cookie, TEST_UPLINK_COOKIE);
+  EXPECT_EQ(entries[0].packets, 15);
+  EXPECT_EQ(entries[0].bytes, 150);
+  EXPECT_EQ(entries[0].delta_packets, 15);
+  EXPECT_EQ(entries[0].delta_bytes, 150);
+  EXPECT_EQ(entries[1].cookie, TEST_DOWNLINK_COOKIE);
+  EXPECT_EQ(entries[1].packets, 7);
+  EXPECT_EQ(entries[1].delta_packets, 7);
+
+  // Next poll only advances the uplink counters
+  dispatch_poll();
+  of13::MultipartReplyFlow segment4(3, 0);
+  segment4.add_flow_stats(make_flow_stats(TEST_UPLINK_COOKIE, 40, 400));
+  dispatch_reply(segment4);
+  of13::MultipartReplyFlow segment5(4, 0);
+  segment5.add_flow_stats(make_flow_stats(TEST_DOWNLINK_COOKIE, 7, 70));
+  dispatch_reply(segment5);
+
+  flow_stats_app->take_snapshot(&entries);
+  EXPECT_EQ(entries[0].packets, 40);
+  EXPECT_EQ(entries[0].delta_packets, 25);
+  EXPECT_EQ(entries[0].delta_bytes, 250);
+  EXPECT_EQ(entries[1].packets, 7);
+  EXPECT_EQ(entries[1].delta_packets, 0);
+
+  // The previous snapshot consumed the deltas
+  flow_stats_app->take_snapshot(&entries);
+  EXPECT_EQ(entries[0].delta_packets, 0);
+  EXPECT_EQ(entries[1].delta_packets, 0);
+  EXPECT_EQ(entries[0].packets, 40);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  ::testing::InitGoogleMock(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+}  // namespace
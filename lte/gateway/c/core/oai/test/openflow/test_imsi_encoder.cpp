@@ -47,6 +47,18 @@ INSTANTIATE_TEST_CASE_P(
     TestDifferentLengths, IMSIEncoderTest,
     Values("001010000000013", "01010000000013", "28950000000013"));
 
+/*
+ * Repeated encodes of the same IMSI hit the encoder's cache; make sure
+ * cached and freshly parsed encodings agree
+ */
+TEST(IMSIEncoderCacheTest, TestRepeatedCompact) {
+  uint64_t first = IMSIEncoder::compact_imsi("001010000000013");
+  ASSERT_EQ(first, IMSIEncoder::compact_imsi("001010000000013"));
+  uint64_t other = IMSIEncoder::compact_imsi("111010000000013");
+  ASSERT_NE(first, other);
+  ASSERT_EQ(first, IMSIEncoder::compact_imsi("001010000000013"));
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
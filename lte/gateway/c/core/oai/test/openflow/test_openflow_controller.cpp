@@ -24,6 +24,8 @@
 #include <memory>                   // for unique_ptr
 // TODO: Once #5146 is resolved this can be re-ordered above <memory>
 #include <fluid/OFConnection.hh>        // for OFConnection, OFConnection::E...
+#include <chrono>                       // for seconds
+#include <future>                       // for promise, future
 #include <stdexcept>                    // for runtime_error
 #include "ControllerEvents.h"           // for EVENT_PACKET_IN, EVENT_SWITCH...
 #include "OpenflowController.h"         // for OpenflowController, OFPT_PACK...
@@ -34,6 +36,7 @@
 
 using ::testing::_;
 using ::testing::InSequence;
+using ::testing::InvokeWithoutArgs;
 using ::testing::Test;
 using namespace openflow;
 using namespace fluid_msg;
@@ -69,13 +72,19 @@ class ControllerTest : public ::testing::Test {
   std::unique_ptr<OpenflowController> controller;
 };
 
-// Test simple registration and see if application received event
+// Test simple registration and see if application received event.
+// Packet-ins are dispatched from a worker thread, so wait for delivery
 TEST_F(ControllerTest, TestRegistration) {
   MockApplication app;
-  EXPECT_CALL(app, event_callback(_, _)).Times(1);
+  std::promise<void> dispatched;
+  EXPECT_CALL(app, event_callback(_, _))
+      .WillOnce(InvokeWithoutArgs([&dispatched]() { dispatched.set_value(); }));
 
   controller->register_for_event((Application*) &app, EVENT_PACKET_IN);
   default_message_callback(OFPT_PACKET_IN_TYPE);
+  ASSERT_EQ(
+      dispatched.get_future().wait_for(std::chrono::seconds(5)),
+      std::future_status::ready);
 }
 
 // Ensure controller can only handle events if it's running
@@ -87,21 +96,28 @@ TEST_F(ControllerTest, TestRunningAssertion) {
 }
 
 // Test that with multiple apps registered, the correct apps receive the
-// correct events in order.
+// correct events. Switch up/down stay ordered on the event loop;
+// packet-ins are delivered from the worker thread, so they are only
+// ordered relative to each other
 TEST_F(ControllerTest, TestMultipleApplications) {
   MockApplication app1, app2, app3;
   controller->register_for_event(&app1, openflow::EVENT_PACKET_IN);
   controller->register_for_event(&app2, openflow::EVENT_SWITCH_UP);
   controller->register_for_event(&app3, openflow::EVENT_SWITCH_DOWN);
+  std::promise<void> dispatched;
   {
     InSequence dummy;
     // Initial flow
     EXPECT_CALL(app2, event_callback(_, _)).Times(1);
-    EXPECT_CALL(app1, event_callback(_, _)).Times(1);
     EXPECT_CALL(app3, event_callback(_, _)).Times(1);
   }
+  EXPECT_CALL(app1, event_callback(_, _))
+      .WillOnce(InvokeWithoutArgs([&dispatched]() { dispatched.set_value(); }));
   default_message_callback(OFPT_FEATURES_REPLY_TYPE);
   default_message_callback(OFPT_PACKET_IN_TYPE);
+  ASSERT_EQ(
+      dispatched.get_future().wait_for(std::chrono::seconds(5)),
+      std::future_status::ready);
   default_connection_callback(OFConnection::EVENT_CLOSED);
 }
 
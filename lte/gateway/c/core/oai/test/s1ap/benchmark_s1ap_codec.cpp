@@ -0,0 +1,228 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "bstrlib.h"
+#include "log.h"
+#include "s1ap_mme_decoder.h"
+#include "s1ap_mme_encoder.h"
+#include "S1ap_S1AP-PDU.h"
+}
+
+/**
+ * Replays captured/representative S1AP PDUs through s1ap_mme_decode_pdu and
+ * s1ap_mme_encode_pdu and reports ns/op, cycles/op and mallocs/op for each
+ * procedure, so the APER codec cost of the hottest s1ap procedures is
+ * quantified in the test output and codec regressions show up before release.
+ *
+ * Encode is only benchmarked for MME-originated procedures (Paging, Handover
+ * Preparation); s1ap_mme_encode_pdu rejects eNB-originated ones by design.
+ */
+
+// Allocation counter: the benchmark binary overrides the allocating entry
+// points and forwards to glibc, so every allocation the asn.1c codec makes
+// inside the timed loops is counted. free() is left alone on purpose.
+extern "C" {
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t nmemb, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+}
+
+static std::atomic<uint64_t> g_malloc_count(0);
+
+extern "C" void* malloc(size_t size) {
+  g_malloc_count.fetch_add(1, std::memory_order_relaxed);
+  return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t nmemb, size_t size) {
+  g_malloc_count.fetch_add(1, std::memory_order_relaxed);
+  return __libc_calloc(nmemb, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+  g_malloc_count.fetch_add(1, std::memory_order_relaxed);
+  return __libc_realloc(ptr, size);
+}
+
+namespace {
+constexpr int BENCH_ITERATIONS = 10000;
+
+// Serializing cycle counter where available; ns/op is always reported so the
+// numbers stay comparable on other architectures
+inline uint64_t bench_cycles(void) {
+#if defined(__x86_64__)
+  unsigned int lo, hi;
+  __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+  return ((uint64_t) hi << 32) | lo;
+#else
+  return 0;
+#endif
+}
+
+struct s1ap_pdu_sample_t {
+  const char* name;
+  const uint8_t* pdu;
+  size_t length;
+  // Only MME-originated procedures pass the encoder's procedure allowlist
+  bool benchmark_encode;
+};
+
+// InitialUEMessage for PLMN 001/01, TAC 1, carrying the s1ap tester combined
+// attach request as NAS PDU
+const uint8_t initial_ue_message[] = {
+    0x00, 0x0c, 0x40, 0x48, 0x00, 0x00, 0x05, 0x00, 0x08, 0x00, 0x02, 0x00,
+    0x01, 0x00, 0x1a, 0x00, 0x20, 0x1f, 0x07, 0x41, 0x72, 0x08, 0x09, 0x10,
+    0x10, 0x00, 0x00, 0x00, 0x00, 0x10, 0x02, 0xe0, 0xe0, 0x00, 0x04, 0x02,
+    0x01, 0xd0, 0x11, 0x40, 0x08, 0x04, 0x02, 0x60, 0x04, 0x00, 0x02, 0x1c,
+    0x00, 0x00, 0x43, 0x00, 0x06, 0x00, 0x00, 0xf1, 0x10, 0x00, 0x01, 0x00,
+    0x64, 0x40, 0x08, 0x00, 0x00, 0xf1, 0x10, 0x00, 0x00, 0x10, 0x10, 0x00,
+    0x86, 0x40, 0x01, 0x30};
+
+// UplinkNASTransport for the same UE, carrying a TAU request
+const uint8_t uplink_nas_transport[] = {
+    0x00, 0x0d, 0x40, 0x39, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x02,
+    0x00, 0x01, 0x00, 0x08, 0x00, 0x02, 0x00, 0x01, 0x00, 0x1a, 0x00,
+    0x10, 0x0f, 0x07, 0x48, 0x70, 0x0b, 0xf6, 0x00, 0xf1, 0x10, 0x00,
+    0x01, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x64, 0x40, 0x08, 0x00,
+    0x00, 0xf1, 0x10, 0x00, 0x00, 0x10, 0x10, 0x00, 0x43, 0x40, 0x06,
+    0x00, 0x00, 0xf1, 0x10, 0x00, 0x01};
+
+// S-TMSI paging towards one TAI
+const uint8_t paging[] = {0x00, 0x0a, 0x40, 0x27, 0x00, 0x00, 0x04, 0x00,
+                          0x50, 0x40, 0x02, 0x01, 0x40, 0x00, 0x2b, 0x40,
+                          0x06, 0x00, 0x10, 0x00, 0x00, 0x00, 0x01, 0x00,
+                          0x6d, 0x40, 0x01, 0x00, 0x00, 0x2e, 0x40, 0x0b,
+                          0x00, 0x00, 0x2f, 0x40, 0x06, 0x00, 0x00, 0xf1,
+                          0x10, 0x00, 0x01};
+
+// Intra-LTE HandoverRequired towards macro eNB 2 with a 32 byte RRC
+// source-to-target transparent container
+const uint8_t handover_required[] = {
+    0x00, 0x00, 0x00, 0x51, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x02, 0x00,
+    0x01, 0x00, 0x08, 0x00, 0x02, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00,
+    0x00, 0x02, 0x40, 0x02, 0x00, 0x20, 0x00, 0x04, 0x00, 0x0e, 0x00, 0x00,
+    0xf1, 0x10, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0xf1, 0x10, 0x00, 0x01,
+    0x00, 0x68, 0x00, 0x21, 0x20, 0x40, 0x0b, 0xd0, 0x01, 0x00, 0x14, 0x00,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b,
+    0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+    0x18};
+
+const s1ap_pdu_sample_t s1ap_pdu_corpus[] = {
+    {"initial_ue_message", initial_ue_message, sizeof(initial_ue_message),
+     false},
+    {"uplink_nas_transport", uplink_nas_transport, sizeof(uplink_nas_transport),
+     false},
+    {"paging", paging, sizeof(paging), true},
+    {"handover_required", handover_required, sizeof(handover_required), true},
+};
+}  // namespace
+
+class S1APCodecBenchmark : public ::testing::Test {
+  virtual void SetUp() {}
+  virtual void TearDown() {}
+};
+
+TEST_F(S1APCodecBenchmark, BenchmarkDecode) {
+  for (const auto& sample : s1ap_pdu_corpus) {
+    bstring raw = blk2bstr(sample.pdu, sample.length);
+
+    // Correctness first: the capture must decode cleanly
+    S1ap_S1AP_PDU_t pdu = {};
+    ASSERT_EQ(s1ap_mme_decode_pdu(&pdu, raw), RETURNok)
+        << "decode failed for " << sample.name;
+    ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_S1ap_S1AP_PDU, &pdu);
+
+    uint64_t mallocs_before = g_malloc_count.load();
+    uint64_t cycles_before  = bench_cycles();
+    auto start              = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+      S1ap_S1AP_PDU_t bench_pdu = {};
+      s1ap_mme_decode_pdu(&bench_pdu, raw);
+      ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_S1ap_S1AP_PDU, &bench_pdu);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+    uint64_t cycles  = bench_cycles() - cycles_before;
+    uint64_t mallocs = g_malloc_count.load() - mallocs_before;
+    printf(
+        "[ BENCH    ] %-22s decode: %6ld ns/op %8ld cycles/op %4ld "
+        "mallocs/op (%zu bytes)\n",
+        sample.name, (long) (elapsed.count() / BENCH_ITERATIONS),
+        (long) (cycles / BENCH_ITERATIONS), (long) (mallocs / BENCH_ITERATIONS),
+        sample.length);
+    bdestroy(raw);
+  }
+}
+
+TEST_F(S1APCodecBenchmark, BenchmarkEncodeRoundTrip) {
+  for (const auto& sample : s1ap_pdu_corpus) {
+    if (!sample.benchmark_encode) {
+      continue;
+    }
+    bstring raw = blk2bstr(sample.pdu, sample.length);
+
+    // Correctness first: the re-encoded PDU must decode again.
+    // s1ap_mme_encode_pdu frees the PDU contents, so each round trip decodes
+    // a fresh structure; the reported cost is decode + encode per op
+    S1ap_S1AP_PDU_t pdu = {};
+    ASSERT_EQ(s1ap_mme_decode_pdu(&pdu, raw), RETURNok)
+        << "decode failed for " << sample.name;
+    uint8_t* buffer = NULL;
+    uint32_t length = 0;
+    ASSERT_EQ(s1ap_mme_encode_pdu(&pdu, &buffer, &length), RETURNok)
+        << "encode failed for " << sample.name;
+    ASSERT_GT(length, 0u) << "empty encode for " << sample.name;
+    bstring reencoded         = blk2bstr(buffer, length);
+    S1ap_S1AP_PDU_t check_pdu = {};
+    ASSERT_EQ(s1ap_mme_decode_pdu(&check_pdu, reencoded), RETURNok)
+        << "round trip failed for " << sample.name;
+    ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_S1ap_S1AP_PDU, &check_pdu);
+    bdestroy(reencoded);
+    free(buffer);
+
+    uint64_t mallocs_before = g_malloc_count.load();
+    uint64_t cycles_before  = bench_cycles();
+    auto start              = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+      S1ap_S1AP_PDU_t bench_pdu = {};
+      uint8_t* bench_buffer     = NULL;
+      uint32_t bench_length     = 0;
+      s1ap_mme_decode_pdu(&bench_pdu, raw);
+      s1ap_mme_encode_pdu(&bench_pdu, &bench_buffer, &bench_length);
+      free(bench_buffer);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+    uint64_t cycles  = bench_cycles() - cycles_before;
+    uint64_t mallocs = g_malloc_count.load() - mallocs_before;
+    printf(
+        "[ BENCH    ] %-22s decode+encode: %6ld ns/op %8ld cycles/op %4ld "
+        "mallocs/op (%zu bytes)\n",
+        sample.name, (long) (elapsed.count() / BENCH_ITERATIONS),
+        (long) (cycles / BENCH_ITERATIONS), (long) (mallocs / BENCH_ITERATIONS),
+        sample.length);
+    bdestroy(raw);
+  }
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  OAILOG_INIT("MME", OAILOG_LEVEL_ERROR, MAX_LOG_PROTOS);
+  return RUN_ALL_TESTS();
+}
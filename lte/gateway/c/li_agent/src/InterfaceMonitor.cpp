@@ -12,6 +12,7 @@
  */
 
 #include <stdio.h>
+#include <unistd.h>
 #include <utility>
 
 #include "InterfaceMonitor.h"
@@ -22,25 +23,76 @@ namespace lte {
 
 InterfaceMonitor::InterfaceMonitor(
     const std::string& iface_name, std::unique_ptr<PDUGenerator> pkt_gen)
-    : pcap_(nullptr), iface_name_(iface_name), pkt_gen_(std::move(pkt_gen)) {}
+    : pcap_(nullptr),
+      iface_name_(iface_name),
+      pkt_gen_(std::move(pkt_gen)),
+      ring_(PKT_RING_SIZE),
+      ring_head_(0),
+      ring_tail_(0),
+      running_(false),
+      dropped_packets_(0) {}
 
-static void packet_handler(
+void packet_handler(
     u_char* user, const struct pcap_pkthdr* phdr, const u_char* pdata) {
-  reinterpret_cast<PDUGenerator*>(user)->process_packet(phdr, pdata);
+  reinterpret_cast<InterfaceMonitor*>(user)->ring_push(phdr, pdata);
+}
+
+bool InterfaceMonitor::ring_push(
+    const struct pcap_pkthdr* phdr, const u_char* pdata) {
+  size_t head = ring_head_.load(std::memory_order_relaxed);
+  if (head - ring_tail_.load(std::memory_order_acquire) >= PKT_RING_SIZE) {
+    dropped_packets_++;
+    if ((dropped_packets_ % 1000) == 1) {
+      MLOG(MWARNING) << "Packet ring full, dropped " << dropped_packets_
+                     << " intercepted packets so far";
+    }
+    return false;
+  }
+  captured_packet_s& slot = ring_[head & (PKT_RING_SIZE - 1)];
+  slot.hdr                = *phdr;
+  // assign() reuses the slot's capacity, so a warm ring does not allocate
+  slot.data.assign(pdata, pdata + phdr->caplen);
+  ring_head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+void InterfaceMonitor::process_loop() {
+  while (running_.load(std::memory_order_relaxed)) {
+    size_t tail = ring_tail_.load(std::memory_order_relaxed);
+    if (tail == ring_head_.load(std::memory_order_acquire)) {
+      // Idle: push out batched records and reap stale intercept state
+      pkt_gen_->flush_export_buffer();
+      pkt_gen_->delete_inactive_tasks();
+      usleep(100);
+      continue;
+    }
+    captured_packet_s& slot = ring_[tail & (PKT_RING_SIZE - 1)];
+    pkt_gen_->process_packet(&slot.hdr, slot.data.data());
+    ring_tail_.store(tail + 1, std::memory_order_release);
+  }
 }
 
 int InterfaceMonitor::init_interface_monitor() {
   char errbuf[PCAP_ERRBUF_SIZE];
   int ret;
 
-  pcap_ = pcap_open_live(
-      iface_name_.c_str(), MAX_PKT_SIZE, PROMISCUOUS_MODE,
-      PKT_BUF_READ_TIMEOUT_MS, errbuf);
+  pcap_ = pcap_create(iface_name_.c_str(), errbuf);
   if (pcap_ == nullptr) {
     MLOG(MFATAL) << "Could not capture packets on " << iface_name_
                  << ", exiting";
     return -1;
   }
+  pcap_set_snaplen(pcap_, MAX_PKT_SIZE);
+  pcap_set_promisc(pcap_, PROMISCUOUS_MODE);
+  pcap_set_timeout(pcap_, PKT_BUF_READ_TIMEOUT_MS);
+  // A large kernel buffer absorbs capture bursts while records of
+  // earlier packets are still being exported
+  pcap_set_buffer_size(pcap_, PCAP_BUFFER_SIZE);
+  if (pcap_activate(pcap_) < 0) {
+    MLOG(MFATAL) << "Could not activate capture on " << iface_name_ << ": "
+                 << pcap_geterr(pcap_) << ", exiting";
+    return -1;
+  }
 
   ret = pcap_setnonblock(pcap_, 1, errbuf);
   if (ret == -1) {
@@ -53,18 +105,21 @@ int InterfaceMonitor::init_interface_monitor() {
 
 int InterfaceMonitor::start_capture() {
   int ret;
+  running_.store(true);
+  process_thread_ = std::thread(&InterfaceMonitor::process_loop, this);
   while (true) {
     ret = pcap_dispatch(
-        pcap_, -1, packet_handler, reinterpret_cast<u_char*>(pkt_gen_.get()));
+        pcap_, -1, packet_handler, reinterpret_cast<u_char*>(this));
     if (ret == -1) {
       MLOG(MERROR) << "Could not capture packets";
       if (pcap_ != nullptr) {
         pcap_close(pcap_);
         pcap_ = nullptr;
       }
+      running_.store(false);
+      process_thread_.join();
       return -1;
     } else if (ret == 0) {
-      pkt_gen_->delete_inactive_tasks();
       usleep(100);
     }
   }
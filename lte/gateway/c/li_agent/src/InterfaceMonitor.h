@@ -14,8 +14,11 @@
 
 #include <pcap.h>
 
-#include <string>
+#include <atomic>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "PDUGenerator.h"
 
@@ -25,6 +28,11 @@ namespace lte {
 #define MAX_PKT_SIZE 2048
 #define PROMISCUOUS_MODE 0
 #define PKT_BUF_READ_TIMEOUT_MS 1000
+// Kernel-side capture buffer; sized to ride out processing stalls
+#define PCAP_BUFFER_SIZE (16 * 1024 * 1024)
+
+void packet_handler(
+    u_char* user, const struct pcap_pkthdr* phdr, const u_char* pdata);
 
 class InterfaceMonitor {
  public:
@@ -37,12 +45,50 @@ class InterfaceMonitor {
    * @return return positif integer if interface monitoring starts successfully.
    */
   int init_interface_monitor();
+
+  /**
+   * start_capture pulls packets from pcap on the calling thread and hands
+   * them through a lock-free ring to a processing thread, so per-packet
+   * record generation and TLS export never stall the capture loop.
+   */
   int start_capture();
 
  private:
+  // Single-producer single-consumer ring between the capture thread and
+  // the processing thread; must be a power of two
+  static const size_t PKT_RING_SIZE = 8192;
+
+  struct captured_packet_s {
+    struct pcap_pkthdr hdr;
+    std::vector<u_char> data;
+  };
+
+  /**
+   * process_loop drains the packet ring, generating and exporting x3
+   * records; when idle it flushes the export buffer and reaps inactive
+   * intercept tasks.
+   */
+  void process_loop();
+
+  friend void packet_handler(
+      u_char* user, const struct pcap_pkthdr* phdr, const u_char* pdata);
+
+  /**
+   * ring_push copies a captured packet into the ring; packets are shed
+   * when the processing thread cannot keep up.
+   * @return true if the packet was queued
+   */
+  bool ring_push(const struct pcap_pkthdr* phdr, const u_char* pdata);
+
   pcap_t* pcap_;
   std::string iface_name_;
   std::unique_ptr<PDUGenerator> pkt_gen_;
+  std::vector<captured_packet_s> ring_;
+  std::atomic<size_t> ring_head_;
+  std::atomic<size_t> ring_tail_;
+  std::atomic<bool> running_;
+  uint64_t dropped_packets_;
+  std::thread process_thread_;
 };
 
 }  // namespace lte
@@ -20,6 +20,16 @@
 
 using grpc::Status;
 
+namespace {
+// Resolution cache bounds; positive entries live long because an
+// allocated address maps to the same IMSI for the session's lifetime,
+// negative entries live short so a newly attached subscriber is seen
+// promptly
+const size_t SUBSCRIBER_CACHE_CAPACITY = 4096;
+const std::chrono::seconds POSITIVE_CACHE_TTL(300);
+const std::chrono::seconds NEGATIVE_CACHE_TTL(10);
+}  // namespace
+
 namespace magma {
 namespace lte {
 
@@ -42,8 +52,77 @@ AsyncMobilitydClient::AsyncMobilitydClient()
 void AsyncMobilitydClient::get_subscriber_id_from_ip(
     const struct in_addr& ip,
     std::function<void(Status, SubscriberID)> callback) {
+  bool found;
+  std::string subscriber_id;
+  if (cache_lookup(ip.s_addr, &found, &subscriber_id)) {
+    if (found) {
+      SubscriberID resp;
+      resp.set_id(subscriber_id);
+      callback(Status::OK, resp);
+    } else {
+      callback(
+          Status(grpc::StatusCode::NOT_FOUND, "cached negative resolution"),
+          SubscriberID());
+    }
+    return;
+  }
+
   IPAddress req = create_get_subscriber_id_from_ip_req(ip);
-  get_subscriber_id_from_ip_rpc(req, callback);
+  uint32_t addr = ip.s_addr;
+  get_subscriber_id_from_ip_rpc(
+      req, [this, addr, callback](Status status, SubscriberID resp) {
+        if (status.ok()) {
+          cache_insert(addr, true, resp.id());
+        } else if (status.error_code() == grpc::StatusCode::NOT_FOUND) {
+          // Only a definitive miss is cached; transient RPC failures are
+          // retried on the next packet
+          cache_insert(addr, false, "");
+        }
+        callback(status, resp);
+      });
+}
+
+bool AsyncMobilitydClient::cache_lookup(
+    uint32_t addr, bool* found, std::string* subscriber_id) {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  auto it = cache_.find(addr);
+  if (it == cache_.end()) {
+    return false;
+  }
+  if (std::chrono::steady_clock::now() >= it->second.expiry) {
+    lru_.erase(it->second.lru_it);
+    cache_.erase(it);
+    return false;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+  *found         = it->second.found;
+  *subscriber_id = it->second.subscriber_id;
+  return true;
+}
+
+void AsyncMobilitydClient::cache_insert(
+    uint32_t addr, bool found, const std::string& id) {
+  auto ttl = found ? POSITIVE_CACHE_TTL : NEGATIVE_CACHE_TTL;
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  auto it = cache_.find(addr);
+  if (it != cache_.end()) {
+    lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+    it->second.subscriber_id = id;
+    it->second.found         = found;
+    it->second.expiry        = std::chrono::steady_clock::now() + ttl;
+    return;
+  }
+  if (cache_.size() >= SUBSCRIBER_CACHE_CAPACITY) {
+    cache_.erase(lru_.back());
+    lru_.pop_back();
+  }
+  lru_.push_front(addr);
+  subscriber_cache_entry_s entry;
+  entry.subscriber_id = id;
+  entry.found         = found;
+  entry.expiry        = std::chrono::steady_clock::now() + ttl;
+  entry.lru_it        = lru_.begin();
+  cache_[addr]        = entry;
 }
 
 void AsyncMobilitydClient::get_subscriber_id_from_ip_rpc(
@@ -14,8 +14,12 @@
 
 #include <grpc++/grpc++.h>
 #include <arpa/inet.h>
+#include <chrono>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 #include "lte/protos/mobilityd.pb.h"
 #include "lte/protos/mobilityd.grpc.pb.h"
@@ -45,7 +49,9 @@ class MobilitydClient {
 
 /**
  * AsyncMobilitydClient sends asynchronous calls to mobilityd to retrieve
- * UE information.
+ * UE information. Resolutions are held in a small LRU cache (including
+ * negative results) so steady-state interception answers from the cache
+ * instead of paying a round trip per new flow.
  */
 class AsyncMobilitydClient : public GRPCReceiver, public MobilitydClient {
  public:
@@ -61,10 +67,35 @@ class AsyncMobilitydClient : public GRPCReceiver, public MobilitydClient {
   static const uint32_t RESPONSE_TIMEOUT_SECONDS = 6;
   std::unique_ptr<MobilityService::Stub> stub_;
 
+  struct subscriber_cache_entry_s {
+    std::string subscriber_id;
+    bool found;
+    std::chrono::steady_clock::time_point expiry;
+    std::list<uint32_t>::iterator lru_it;
+  };
+  std::unordered_map<uint32_t, subscriber_cache_entry_s> cache_;
+  std::list<uint32_t> lru_;
+  std::mutex cache_mutex_;
+
  private:
   void get_subscriber_id_from_ip_rpc(
       const IPAddress& request,
       std::function<void(Status, SubscriberID)> callback);
+
+  /**
+   * cache_lookup retrieves a non-expired cached resolution and refreshes
+   * its LRU position.
+   * @return true on a cache hit; found tells whether the hit was a
+   * positive or a negative entry
+   */
+  bool cache_lookup(uint32_t addr, bool* found, std::string* subscriber_id);
+
+  /**
+   * cache_insert stores a resolution, evicting the least recently used
+   * entry at capacity. Negative entries carry a short TTL so released
+   * and reassigned addresses are re-resolved quickly.
+   */
+  void cache_insert(uint32_t addr, bool found, const std::string& id);
 };
 
 }  // namespace lte
@@ -65,12 +65,25 @@ FlowInformation extract_flow_information(const u_char* packet) {
 static InterceptState build_new_intercept_state(
     std::string subid, const magma::mconfig::NProbeTask& task) {
   MLOG(MDEBUG) << "Create new intercept state for task " << task.task_id();
-  InterceptState state;
+  InterceptState state{};
   state.target_id       = subid;
   state.task_id         = task.task_id();
   state.domain_id       = task.domain_id();
   state.correlation_id  = task.correlation_id();
   state.sequence_number = 0;
+
+  // Precompute every header field that is constant for this task; the
+  // fast path only patches lengths, direction, timestamp and sequence
+  X3Header* pdu       = &state.header_template;
+  pdu->version        = htons(PDU_VERSION);
+  pdu->pdu_type       = htons(PDU_TYPE);
+  pdu->header_length  = htonl(sizeof(X3Header));
+  pdu->payload_format = htons(IP_PAYLOAD_FORMAT);
+  pdu->correlation_id = htobe64(task.correlation_id());
+  state.xid_valid     = (uuid_parse(task.task_id().c_str(), pdu->xid) == 0);
+  if (!state.xid_valid) {
+    MLOG(MERROR) << "Failed to parse task_id " << task.task_id();
+  }
   return state;
 }
 
@@ -124,7 +137,6 @@ bool PDUGenerator::process_packet(
   auto exported = export_record(record, rlen, MAX_EXPORT_RETRIES);
   MLOG(MDEBUG) << "Exported packet " << state_map_[idx].sequence_number
                << " with length " << rlen;
-  free(record);
   return exported;
 }
 
@@ -147,30 +159,34 @@ void PDUGenerator::delete_inactive_tasks() {
   return;
 }
 
+void PDUGenerator::flush_export_buffer() {
+  proxy_connector_->flush_data();
+}
+
 void* PDUGenerator::generate_record(
     const struct pcap_pkthdr* phdr, const u_char* pdata, std::string idx,
     uint16_t direction, uint32_t* record_len) {
-  auto& state      = state_map_[idx];
+  auto& state = state_map_[idx];
+  if (!state.xid_valid) {
+    *record_len = 0;
+    return nullptr;
+  }
   uint32_t hdr_len = sizeof(X3Header);
   uint32_t pld_len =
       phdr->len -
       ETHERNET_HDR_LEN;  // Skip eth layer as defined in ETSI 103 221-2.
 
-  *record_len     = hdr_len + pld_len;
-  uint8_t* record = static_cast<uint8_t*>(calloc(1, *record_len));
-  if (record == nullptr) {
-    MLOG(MERROR) << "Failed to allocate memory " << *record_len;
-    *record_len = 0;
-    return nullptr;
+  *record_len = hdr_len + pld_len;
+  if (record_buffer_.size() < *record_len) {
+    record_buffer_.resize(*record_len);
   }
+  uint8_t* record = record_buffer_.data();
 
+  // Stamp the precomputed per-task template and patch the per-packet
+  // fields
+  memcpy(record, &state.header_template, hdr_len);
   X3Header* pdu          = reinterpret_cast<X3Header*>(record);
-  pdu->version           = htons(PDU_VERSION);
-  pdu->pdu_type          = htons(PDU_TYPE);
-  pdu->header_length     = htonl(hdr_len);
   pdu->payload_length    = htonl(pld_len);
-  pdu->payload_format    = htons(IP_PAYLOAD_FORMAT);
-  pdu->correlation_id    = htobe64(state.correlation_id);
   pdu->payload_direction = htons(direction);
 
   uint64_t tm = (uint64_t) phdr->ts.tv_sec << 32 | phdr->ts.tv_usec;
@@ -179,14 +195,6 @@ void* PDUGenerator::generate_record(
   SET_INT64_TLV(
       &pdu->attrs.sequence_number, SEQNBR_ATTRID, state.sequence_number);
 
-  auto ret = uuid_parse(state.task_id.c_str(), pdu->xid);
-  if (ret != 0) {
-    MLOG(MERROR) << "Failed to parse task_id " << state.task_id.c_str();
-    free(record);
-    *record_len = 0;
-    return nullptr;
-  }
-
   memcpy(record + hdr_len, pdata + ETHERNET_HDR_LEN, pld_len);
   state.last_exported = phdr->ts.tv_sec;
   state.sequence_number++;
@@ -17,6 +17,7 @@
 
 #include <unordered_map>
 #include <string>
+#include <vector>
 
 #include "includes/MConfigLoader.h"
 #include <lte/protos/mconfig/mconfigs.pb.h>
@@ -65,6 +66,11 @@ typedef struct {
   uint64_t last_exported;
   uint64_t correlation_id;
   uint64_t sequence_number;
+  // Header with all per-task constant fields (version, XID, correlation
+  // id, ...) precomputed at state creation; per packet only lengths,
+  // direction, timestamp and sequence number are patched
+  X3Header header_template;
+  bool xid_valid;
 } InterceptState;
 
 typedef std::unordered_map<std::string, InterceptState> InterceptStateMap;
@@ -96,6 +102,13 @@ class PDUGenerator {
    */
   void delete_inactive_tasks();
 
+  /**
+   * flush_export_buffer pushes any records batched in the proxy
+   * connector to the remote server; called when capture goes idle.
+   * @return void
+   */
+  void flush_export_buffer();
+
  private:
   std::string iface_name_;
   std::string pkt_dst_mac_;
@@ -105,6 +118,9 @@ class PDUGenerator {
   uint64_t prev_sync_time_;
   Tins::NetworkInterface iface_;
   InterceptStateMap state_map_;
+  // Reused record buffer; the processing path is single threaded and the
+  // record is copied into the proxy write buffer before the next packet
+  std::vector<uint8_t> record_buffer_;
   std::unique_ptr<ProxyConnector> proxy_connector_;
   std::unique_ptr<MobilitydClient> mobilityd_client_;
   magma::mconfig::LIAgentD mconfig_;
@@ -117,7 +133,8 @@ class PDUGenerator {
    * @param state - intercept state
    * @param direction - direction of packet
    * @param record_len - output record length
-   * @return true if the operation was successful
+   * @return pointer into the generator-owned record buffer, valid until
+   * the next call; nullptr on failure
    */
   void* generate_record(
       const struct pcap_pkthdr* phdr, const u_char* pdata, std::string idx,
@@ -13,12 +13,25 @@
 
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <stdlib.h>
+#include <unistd.h>
 #include <openssl/ssl.h>
 #include <openssl/err.h>
 
+#include <chrono>
+
 #include "ProxyConnector.h"
 #include "magma_logging.h"
 
+namespace {
+// Records are batched into one SSL_write of up to this many bytes
+const size_t PROXY_WRITE_BATCH_BYTES = 64 * 1024;
+// Records beyond this backlog are shed rather than stalling capture
+const size_t MAX_PENDING_WRITE_BYTES = 8 * 1024 * 1024;
+// Pause between reconnect attempts while the proxy is unreachable
+const std::chrono::seconds RECONNECT_DELAY(1);
+}  // namespace
+
 namespace magma {
 namespace lte {
 
@@ -28,7 +41,14 @@ ProxyConnectorImpl::ProxyConnectorImpl(
     : proxy_addr_(proxy_addr),
       proxy_port_(proxy_port),
       cert_file_(cert_file),
-      key_file_(key_file) {}
+      key_file_(key_file),
+      ssl_(NULL),
+      ctx_(NULL),
+      proxy_(-1),
+      session_(NULL),
+      writer_running_(false),
+      flush_requested_(false),
+      dropped_bytes_(0) {}
 
 int ProxyConnectorImpl::setup_proxy_socket() {
   SSL_library_init();
@@ -54,6 +74,12 @@ int ProxyConnectorImpl::setup_proxy_socket() {
     ERR_print_errors_fp(stderr);
     return -1;
   }
+  session_ = SSL_get1_session(ssl_);
+
+  if (!writer_thread_.joinable()) {
+    writer_running_ = true;
+    writer_thread_  = std::thread(&ProxyConnectorImpl::writer_loop, this);
+  }
 
   return 0;
 }
@@ -86,6 +112,13 @@ SSL_CTX* ProxyConnectorImpl::init_ctx(void) {
     ERR_print_errors_fp(stderr);
     return NULL;
   }
+#ifdef SSL_OP_ENABLE_KTLS
+  // Opt-in kernel TLS offload; record encryption then happens in the
+  // kernel and SSL_write becomes a plain send
+  if (getenv("MAGMA_LI_KTLS") != NULL) {
+    SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS);
+  }
+#endif
   return ctx;
 }
 
@@ -112,13 +145,121 @@ int ProxyConnectorImpl::open_connection() {
 }
 
 int ProxyConnectorImpl::send_data(void* data, uint32_t size) {
-  return SSL_write(ssl_, data, size);
+  bool notify = false;
+  {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (write_buffer_.size() + size > MAX_PENDING_WRITE_BYTES) {
+      dropped_bytes_ += size;
+      if ((dropped_bytes_ / size) % 1000 == 1) {
+        MLOG(MWARNING) << "Proxy write backlog full, dropped "
+                       << dropped_bytes_ << " bytes of records so far";
+      }
+      return size;
+    }
+    write_buffer_.insert(
+        write_buffer_.end(), (uint8_t*) data, (uint8_t*) data + size);
+    notify = write_buffer_.size() >= PROXY_WRITE_BATCH_BYTES;
+  }
+  if (notify) {
+    write_cv_.notify_one();
+  }
+  return size;
+}
+
+int ProxyConnectorImpl::flush_data() {
+  {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    flush_requested_ = true;
+  }
+  write_cv_.notify_one();
+  return 0;
+}
+
+void ProxyConnectorImpl::writer_loop() {
+  std::vector<uint8_t> out;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(write_mutex_);
+      write_cv_.wait(lock, [this] {
+        return !writer_running_ || flush_requested_ ||
+               write_buffer_.size() >= PROXY_WRITE_BATCH_BYTES;
+      });
+      flush_requested_ = false;
+      if (write_buffer_.empty()) {
+        if (!writer_running_) {
+          return;
+        }
+        continue;
+      }
+      out.swap(write_buffer_);
+    }
+    // Write the batch out, rebuilding the connection if the write fails;
+    // the batch is retried after every reconnect so records are not lost
+    while (SSL_write(ssl_, out.data(), out.size()) <= 0) {
+      MLOG(MWARNING) << "Proxy write failed, reconnecting";
+      while (reconnect() < 0) {
+        if (!writer_running_) {
+          return;
+        }
+        std::this_thread::sleep_for(RECONNECT_DELAY);
+      }
+    }
+    out.clear();
+  }
+}
+
+int ProxyConnectorImpl::reconnect() {
+  if (ssl_ != NULL) {
+    SSL_free(ssl_);
+    ssl_ = NULL;
+  }
+  if (proxy_ >= 0) {
+    close(proxy_);
+    proxy_ = -1;
+  }
+  proxy_ = open_connection();
+  if (proxy_ < 0) {
+    return -1;
+  }
+  ssl_ = SSL_new(ctx_);
+  if (ssl_ == NULL) {
+    return -1;
+  }
+  SSL_set_options(ssl_, SSL_OP_DONT_INSERT_EMPTY_FRAGMENTS);
+  SSL_set_fd(ssl_, proxy_);
+  if (session_ != NULL) {
+    // Offer the previous session so the server can resume instead of
+    // doing a full handshake
+    SSL_set_session(ssl_, session_);
+  }
+  if (SSL_connect(ssl_) == -1) {
+    ERR_print_errors_fp(stderr);
+    return -1;
+  }
+  if (session_ != NULL) {
+    SSL_SESSION_free(session_);
+  }
+  session_ = SSL_get1_session(ssl_);
+  return 0;
 }
 
 void ProxyConnectorImpl::cleanup() {
+  if (writer_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(write_mutex_);
+      writer_running_  = false;
+      flush_requested_ = true;
+    }
+    write_cv_.notify_one();
+    writer_thread_.join();
+  }
   SSL_free(ssl_);
   close(proxy_);
   SSL_CTX_free(ctx_);
+  if (session_ != NULL) {
+    SSL_SESSION_free(session_);
+    session_ = NULL;
+  }
 }
 
 }  // namespace lte
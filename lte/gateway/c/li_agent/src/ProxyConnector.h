@@ -12,7 +12,11 @@
  */
 #pragma once
 
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 #include <openssl/ssl.h>
 
 namespace magma {
@@ -23,7 +27,10 @@ class ProxyConnector {
   virtual int send_data(void* data, uint32_t size) = 0;
   virtual int setup_proxy_socket()                 = 0;
   virtual void cleanup()                           = 0;
-  virtual ~ProxyConnector()                        = default;
+  // Write out any buffered records; implementations that do not batch
+  // have nothing to flush
+  virtual int flush_data() { return 0; }
+  virtual ~ProxyConnector() = default;
 };
 
 class ProxyConnectorImpl : public ProxyConnector {
@@ -39,13 +46,23 @@ class ProxyConnectorImpl : public ProxyConnector {
   int setup_proxy_socket();
 
   /**
-   * export_record exports the x3 record over tls to a remote server.
+   * send_data queues an x3 record for the writer thread, so a slow
+   * mediation server never backpressures record generation. The queue
+   * is bounded; records beyond the bound are shed with a rate-limited
+   * warning.
    * @param data - x3 record packet
    * @param size - x3 record length
    * @return return positif integer if sending data successeds.
    */
   int send_data(void* data, uint32_t size);
 
+  /**
+   * flush_data asks the writer thread to push out the batched records
+   * without waiting for a full batch.
+   * @return 0; delivery failures are handled by the writer reconnecting
+   */
+  int flush_data();
+
   /**
    * cleanup cleans up all allocated ressources in proxy connector
    * @return void
@@ -60,10 +77,33 @@ class ProxyConnectorImpl : public ProxyConnector {
   SSL* ssl_;
   SSL_CTX* ctx_;
   int proxy_;
+  // Cached TLS session for resumption on reconnect
+  SSL_SESSION* session_;
+  std::vector<uint8_t> write_buffer_;
+  std::thread writer_thread_;
+  std::mutex write_mutex_;
+  std::condition_variable write_cv_;
+  bool writer_running_;
+  bool flush_requested_;
+  uint64_t dropped_bytes_;
 
   int open_connection();
   int load_certificates(SSL_CTX* ctx);
   SSL_CTX* init_ctx();
+
+  /**
+   * writer_loop drains the record queue and writes it to the proxy in
+   * batches; on write failure it rebuilds the connection (resuming the
+   * TLS session) and re-sends the batch.
+   */
+  void writer_loop();
+
+  /**
+   * reconnect rebuilds the TCP connection and TLS state, offering the
+   * cached session for resumption.
+   * @return 0 on success, -1 on failure
+   */
+  int reconnect();
 };
 
 }  // namespace lte
@@ -24,6 +24,9 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <chrono>
+#include <stdexcept>
+
 #include "sctpd.h"
 #include "util.h"
 
@@ -31,23 +34,46 @@ namespace magma {
 namespace sctpd {
 
 const int NUM_EPOLL_EVENTS = 10;
+// Number of receive worker threads; each association maps to exactly one
+// worker (assoc_id modulo), which keeps per-association ordering while a
+// blocking uplink call for one eNB no longer stalls the others
+const int NUM_RECV_WORKERS = 4;
+// Number of messages pulled off a client socket per syscall; a burst of
+// small S1AP messages drains in one recvmmsg instead of one recvmsg each
+const int NUM_RECV_BATCH = 8;
+// How long a departed peer's negotiated stream state is retained; long
+// enough to cover an eNB reboot during a mass power-restore event
+const std::chrono::seconds REASSOC_CACHE_GRACE{300};
 
 SctpConnection::SctpConnection(const InitReq& req, SctpEventHandler& handler)
     : _done(false),
       _handler(handler),
       _ppid(req.ppid()),
       _sctp_desc(0),
-      _thread(nullptr) {
+      _thread(nullptr),
+      _ul_shm_pool(nullptr) {
   int sock = create_sctp_sock(req);
   if (sock < 0) throw std::exception();
 
   _sctp_desc = SctpDesc(sock);
+
+  _ul_shm_pool = sctp_ul_shm_create();
+  if (_ul_shm_pool == nullptr) {
+    MLOG(MERROR) << "failed to create uplink shm pool, payloads go inline";
+  }
 }
 
 void SctpConnection::Start() {
   assert(_done == false);
   assert(_thread == nullptr);
 
+  for (int i = 0; i < NUM_RECV_WORKERS; i++) {
+    auto worker    = std::make_unique<RecvWorker>();
+    worker->thread = std::make_unique<std::thread>(
+        &SctpConnection::RecvWorkerLoop, this, worker.get());
+    _recv_workers.push_back(std::move(worker));
+  }
+
   _thread = std::make_unique<std::thread>(&SctpConnection::Listen, this);
 }
 
@@ -58,6 +84,12 @@ void SctpConnection::Close() {
   _done = true;
   _thread->join();
 
+  for (auto& worker : _recv_workers) {
+    worker->cv.notify_one();
+    worker->thread->join();
+  }
+  _recv_workers.clear();
+
   for (auto kv : _sctp_desc) {
     auto assoc = kv.second;
     shutdown(assoc.sd, SHUT_RDWR);
@@ -166,17 +198,64 @@ SctpStatus SctpConnection::HandleClientSock(int sd) {
 
   MLOG(MDEBUG) << "HandleClientSock sd = " << std::to_string(sd);
 
-  char msg[SCTP_RECV_BUFFER_SIZE];
-  struct sctp_sndrcvinfo sinfo;
-  int flags;
+  char bufs[NUM_RECV_BATCH][SCTP_RECV_BUFFER_SIZE];
+  char cmsgs[NUM_RECV_BATCH][CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))];
+  struct iovec iovs[NUM_RECV_BATCH];
+  struct mmsghdr hdrs[NUM_RECV_BATCH];
+
+  memset(hdrs, 0, sizeof(hdrs));
+  for (int i = 0; i < NUM_RECV_BATCH; i++) {
+    iovs[i].iov_base               = bufs[i];
+    iovs[i].iov_len                = SCTP_RECV_BUFFER_SIZE;
+    hdrs[i].msg_hdr.msg_iov        = &iovs[i];
+    hdrs[i].msg_hdr.msg_iovlen     = 1;
+    hdrs[i].msg_hdr.msg_control    = cmsgs[i];
+    hdrs[i].msg_hdr.msg_controllen = sizeof(cmsgs[i]);
+  }
 
-  int n = sctp_recvmsg(sd, msg, sizeof(msg), nullptr, nullptr, &sinfo, &flags);
+  int n = recvmmsg(sd, hdrs, NUM_RECV_BATCH, MSG_DONTWAIT, nullptr);
 
   if (n < 0) {
-    MLOG_perror("sctp_recvmsg");
+    // Another readiness event may have raced ahead of us; not an error
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+      return SctpStatus::OK;
+    }
+    MLOG_perror("recvmmsg");
     return SctpStatus::FAILURE;
   }
 
+  auto status = SctpStatus::OK;
+
+  for (int i = 0; i < n; i++) {
+    // Recover what sctp_recvmsg would have parsed out of the ancillary data
+    struct sctp_sndrcvinfo sinfo;
+    memset(&sinfo, 0, sizeof(sinfo));
+    for (auto cmsg = CMSG_FIRSTHDR(&hdrs[i].msg_hdr); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&hdrs[i].msg_hdr, cmsg)) {
+      if ((cmsg->cmsg_level == IPPROTO_SCTP) &&
+          (cmsg->cmsg_type == SCTP_SNDRCV)) {
+        memcpy(&sinfo, CMSG_DATA(cmsg), sizeof(sinfo));
+      }
+    }
+
+    auto msg_status = HandleMessage(
+        sd, bufs[i], hdrs[i].msg_len, hdrs[i].msg_hdr.msg_flags, sinfo);
+
+    // Keep draining the batch, but report association-level events up to the
+    // listener so it can update its epoll set
+    if ((msg_status == SctpStatus::DISCONNECT) ||
+        (msg_status == SctpStatus::NEW_ASSOC_NOTIF_FAILED) ||
+        (status == SctpStatus::OK && msg_status != SctpStatus::OK)) {
+      status = msg_status;
+    }
+  }
+
+  return status;
+}
+
+SctpStatus SctpConnection::HandleMessage(
+    int sd, char* msg, size_t n, int flags,
+    const struct sctp_sndrcvinfo& sinfo) {
   if (flags & MSG_NOTIFICATION) {
     auto notif = (union sctp_notification*) msg;
 
@@ -222,14 +301,74 @@ SctpStatus SctpConnection::HandleClientSock(int sd) {
                  << std::to_string(sinfo.sinfo_assoc_id) << ":"
                  << std::to_string(sinfo.sinfo_stream);
 
-    _handler.HandleRecv(
-        ntohl(sinfo.sinfo_ppid), sinfo.sinfo_assoc_id, sinfo.sinfo_stream,
-        std::string(msg, n));
+    RecvWork work  = {};
+    work.is_close  = false;
+    work.ppid      = ntohl(sinfo.sinfo_ppid);
+    work.assoc_id  = sinfo.sinfo_assoc_id;
+    work.stream    = sinfo.sinfo_stream;
+    work.shm_index = -1;
+
+    // Park the payload in the uplink shm pool so only a slot descriptor
+    // travels over gRPC; oversized payloads and pool exhaustion fall back
+    // to the inline path
+    if (_ul_shm_pool != nullptr) {
+      work.shm_index = sctp_ul_shm_alloc(_ul_shm_pool, n);
+    }
+    if (work.shm_index >= 0) {
+      memcpy(_ul_shm_pool->slots[work.shm_index].data, msg, n);
+      sctp_ul_shm_commit(_ul_shm_pool, work.shm_index, n);
+      work.shm_length = n;
+    } else {
+      work.payload = std::string(msg, n);
+    }
+    DispatchRecvWork(std::move(work));
 
     return SctpStatus::OK;
   }
 }
 
+void SctpConnection::DispatchRecvWork(RecvWork&& work) {
+  RecvWorker* worker =
+      _recv_workers[work.assoc_id % _recv_workers.size()].get();
+  {
+    std::lock_guard<std::mutex> lock(worker->lock);
+    worker->queue.push_back(std::move(work));
+  }
+  worker->cv.notify_one();
+}
+
+void SctpConnection::RecvWorkerLoop(RecvWorker* worker) {
+  std::unique_lock<std::mutex> lock(worker->lock);
+  // Drain the queue before exiting so no received message is dropped on close
+  while (!_done || !worker->queue.empty()) {
+    if (worker->queue.empty()) {
+      worker->cv.wait_for(lock, std::chrono::milliseconds(100));
+      continue;
+    }
+    RecvWork work = std::move(worker->queue.front());
+    worker->queue.pop_front();
+    lock.unlock();
+    if (work.is_new_assoc) {
+      // Delivered ahead of any data queued for the association, so the
+      // ordering upstream matches the synchronous path
+      if (_handler.HandleNewAssoc(
+              work.ppid, work.assoc_id, work.instreams, work.outstreams,
+              work.peer_ipaddr) < 0) {
+        MLOG(MERROR) << "New assoc notification failed for re-associating "
+                     << "peer " << work.peer_ipaddr << ", assoc_id "
+                     << std::to_string(work.assoc_id);
+      }
+    } else if (work.is_close) {
+      _handler.HandleCloseAssoc(work.ppid, work.assoc_id, work.reset);
+    } else {
+      _handler.HandleRecv(
+          work.ppid, work.assoc_id, work.stream, work.payload, work.shm_index,
+          work.shm_length);
+    }
+    lock.lock();
+  }
+}
+
 SctpStatus SctpConnection::HandleAssocChange(
     int sd, struct sctp_assoc_change* change) {
   switch (change->sac_state) {
@@ -261,10 +400,32 @@ SctpStatus SctpConnection::HandleComUp(
   assoc.instreams  = change->sac_inbound_streams;
   assoc.outstreams = change->sac_outbound_streams;
 
-  _sctp_desc.addAssoc(assoc);
-
   std::string ran_cp_ipaddr;
   pull_peer_ipaddr(sd, change->sac_assoc_id, ran_cp_ipaddr);
+  assoc.peer_ipaddr = ran_cp_ipaddr;
+
+  if (TryFastReassoc(assoc)) {
+    // Known peer back within the grace period with the same negotiated
+    // streams: notify upstream through the association's worker queue so
+    // a mass reconnect is not serialized on per-assoc gRPC round trips
+    MLOG(MINFO) << "Fast re-association for peer " << ran_cp_ipaddr
+                << " assoc_id " << std::to_string(assoc.assoc_id);
+    _sctp_desc.addAssoc(assoc);
+
+    RecvWork work     = {};
+    work.is_new_assoc = true;
+    work.ppid         = assoc.ppid;
+    work.assoc_id     = assoc.assoc_id;
+    work.instreams    = assoc.instreams;
+    work.outstreams   = assoc.outstreams;
+    work.peer_ipaddr  = ran_cp_ipaddr;
+    work.shm_index    = -1;
+    DispatchRecvWork(std::move(work));
+
+    return SctpStatus::OK;
+  }
+
+  _sctp_desc.addAssoc(assoc);
 
   if (_handler.HandleNewAssoc(
           assoc.ppid, change->sac_assoc_id, change->sac_inbound_streams,
@@ -276,13 +437,64 @@ SctpStatus SctpConnection::HandleComUp(
   return SctpStatus::OK;
 }
 
+void SctpConnection::CacheDepartedAssoc(const SctpAssoc& assoc) {
+  if (assoc.peer_ipaddr.empty()) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  // The cache only holds peers of one gateway; a linear sweep is cheap
+  for (auto it = _reassoc_cache.begin(); it != _reassoc_cache.end();) {
+    it = it->second.expires < now ? _reassoc_cache.erase(it) : ++it;
+  }
+  ReassocCacheEntry entry;
+  entry.instreams              = assoc.instreams;
+  entry.outstreams             = assoc.outstreams;
+  entry.messages_recv          = assoc.messages_recv;
+  entry.messages_sent          = assoc.messages_sent;
+  entry.expires                = now + REASSOC_CACHE_GRACE;
+  _reassoc_cache[assoc.peer_ipaddr] = entry;
+}
+
+bool SctpConnection::TryFastReassoc(SctpAssoc& assoc) {
+  auto it = _reassoc_cache.find(assoc.peer_ipaddr);
+  if (it == _reassoc_cache.end()) {
+    return false;
+  }
+  const ReassocCacheEntry& entry = it->second;
+  if (entry.expires < std::chrono::steady_clock::now() ||
+      entry.instreams != assoc.instreams ||
+      entry.outstreams != assoc.outstreams) {
+    // Stale, or the peer renegotiated its streams: take the full path
+    _reassoc_cache.erase(it);
+    return false;
+  }
+  // Carry the message counters across the flap so per-peer stats survive
+  assoc.messages_recv = entry.messages_recv;
+  assoc.messages_sent = entry.messages_sent;
+  _reassoc_cache.erase(it);
+  return true;
+}
+
 SctpStatus SctpConnection::HandleComDown(uint32_t assoc_id) {
   MLOG(MDEBUG) << "Sending close connection for assoc_id "
                << std::to_string(assoc_id);
 
+  try {
+    CacheDepartedAssoc(_sctp_desc.getAssoc(assoc_id));
+  } catch (std::out_of_range&) {
+    // Never completed COM_UP; nothing worth retaining
+  }
+
   _sctp_desc.delAssoc(assoc_id);
 
-  _handler.HandleCloseAssoc(_ppid, assoc_id, false);
+  // Close events travel on the association's receive queue so they are
+  // delivered upstream after any data still queued for that association
+  RecvWork work = {};
+  work.is_close = true;
+  work.reset    = false;
+  work.ppid     = _ppid;
+  work.assoc_id = assoc_id;
+  DispatchRecvWork(std::move(work));
 
   return SctpStatus::DISCONNECT;
 }
@@ -290,7 +502,12 @@ SctpStatus SctpConnection::HandleComDown(uint32_t assoc_id) {
 SctpStatus SctpConnection::HandleReset(uint32_t assoc_id) {
   MLOG(MDEBUG) << "Handling sctp reset";
 
-  _handler.HandleCloseAssoc(_ppid, assoc_id, true);
+  RecvWork work = {};
+  work.is_close = true;
+  work.reset    = true;
+  work.ppid     = _ppid;
+  work.assoc_id = assoc_id;
+  DispatchRecvWork(std::move(work));
 
   return SctpStatus::OK;
 }
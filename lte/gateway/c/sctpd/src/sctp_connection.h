@@ -14,15 +14,23 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include <lte/protos/sctpd.grpc.pb.h>
 
 #include "sctp_desc.h"
+#include "sctp_ul_shm_pool.h"
 
 struct sctp_assoc_change;
+struct sctp_sndrcvinfo;
 
 namespace magma {
 namespace sctpd {
@@ -47,10 +55,11 @@ class SctpEventHandler {
   virtual void HandleCloseAssoc(
       uint32_t ppid, uint32_t assoc_id, bool reset) = 0;
 
-  // Specification for Recv handler function
+  // Specification for Recv handler function; the payload is either inline
+  // or a claimed slot of the uplink shm pool (shm_index >= 0)
   virtual void HandleRecv(
       uint32_t ppid, uint32_t assoc_id, uint32_t stream,
-      const std::string& payload) = 0;
+      const std::string& payload, int shm_index, uint32_t shm_length) = 0;
 };
 
 // Manages Sctp connection including setup/teardown and send/recv
@@ -68,10 +77,46 @@ class SctpConnection {
   void Send(uint32_t assoc_id, uint32_t stream, const std::string& msg);
 
  private:
+  // One upstream event bound for a receive worker; close events travel on the
+  // same queue as data so the order seen upstream matches the socket order
+  struct RecvWork {
+    bool is_close;
+    bool reset;
+    // New-assoc notification for a re-associating peer; travels the worker
+    // queue so the listener does not block on the uplink gRPC call
+    bool is_new_assoc;
+    uint32_t ppid;
+    uint32_t assoc_id;
+    uint32_t stream;
+    uint16_t instreams;
+    uint16_t outstreams;
+    std::string peer_ipaddr;
+    std::string payload;  // inline payload, used when shm_index is -1
+    int shm_index;        // claimed uplink shm pool slot, or -1
+    uint32_t shm_length;
+  };
+
+  // Queue state of one receive worker; associations are sharded by assoc_id
+  // so one slow uplink call only stalls its own shard
+  struct RecvWorker {
+    std::mutex lock;
+    std::condition_variable cv;
+    std::deque<RecvWork> queue;
+    std::unique_ptr<std::thread> thread;
+  };
+
   // Listener loop run in separate thread by Start
   void Listen();
-  // Handle an event on a client socket
+  // Receive worker loop - relays queued events upstream in order
+  void RecvWorkerLoop(RecvWorker* worker);
+  // Queue an upstream event on the worker owning its association
+  void DispatchRecvWork(RecvWork&& work);
+  // Handle an event on a client socket - drains a batch of messages
   SctpStatus HandleClientSock(int sd);
+  // Handle a single received message or notification on a client socket
+  SctpStatus HandleMessage(
+      int sd, char* msg, size_t len, int flags,
+      const struct sctp_sndrcvinfo& sinfo);
   // Handle an association change event for an association sd/change
   SctpStatus HandleAssocChange(int sd, struct sctp_assoc_change* change);
   // Handle a comup event on an association sd/change
@@ -81,6 +126,22 @@ class SctpConnection {
   // Handle a reset event on an association keyed by assoc_id
   SctpStatus HandleReset(uint32_t assoc_id);
 
+  // Stream state retained for a departed peer so its reconnect can skip
+  // the blocking new-assoc round trip to MME/AMF
+  struct ReassocCacheEntry {
+    uint16_t instreams;
+    uint16_t outstreams;
+    uint32_t messages_recv;
+    uint32_t messages_sent;
+    std::chrono::steady_clock::time_point expires;
+  };
+
+  // Retain assoc's negotiated state in the re-association cache
+  void CacheDepartedAssoc(const SctpAssoc& assoc);
+  // Restore cached state into assoc if its peer departed within the grace
+  // period with the same negotiated stream counts; true on a cache hit
+  bool TryFastReassoc(SctpAssoc& assoc);
+
   // Flag is set to true when the connection is closing
   std::atomic<bool> _done;
   // Concrete handler instance to handle upstream events
@@ -91,6 +152,14 @@ class SctpConnection {
   SctpDesc _sctp_desc;
   // Thread for sctp listener to run on
   std::unique_ptr<std::thread> _thread;
+  // Receive workers the associations are sharded across
+  std::vector<std::unique_ptr<RecvWorker>> _recv_workers;
+  // Shared-memory pool carrying uplink payloads to MME; nullptr when the
+  // segment could not be created, in which case payloads travel inline
+  SctpUlShmPool* _ul_shm_pool;
+  // Recently departed peers keyed by control-plane address; only touched
+  // from the listener thread, which handles all association notifications
+  std::map<std::string, ReassocCacheEntry> _reassoc_cache;
 };
 
 }  // namespace sctpd
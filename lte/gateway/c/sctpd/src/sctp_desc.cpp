@@ -13,34 +13,138 @@
 
 #include "sctp_desc.h"
 
+#include <stdexcept>
+
 #include "assert.h"
 
 namespace magma {
 namespace sctpd {
 
-SctpDesc::SctpDesc(int sd) : _sd(sd) {
+// Pre-warmed table size; covers every deployment we have seen without a
+// grow, so attaching eNBs never allocates on the message path
+static const size_t INITIAL_ASSOC_SLOTS = 64;
+
+SctpDesc::SctpDesc(int sd)
+    : _slots(INITIAL_ASSOC_SLOTS), _count(0), _used(0), _sd(sd) {
   assert(sd >= 0);
 }
 
+size_t SctpDesc::find_slot(uint32_t assoc_id) const {
+  size_t mask = _slots.size() - 1;
+  for (size_t i = assoc_id & mask;; i = (i + 1) & mask) {
+    const AssocSlot& slot = _slots[i];
+    if (slot.state == SLOT_EMPTY) {
+      return _slots.size();
+    }
+    if (slot.state == SLOT_OCCUPIED && slot.kv.first == assoc_id) {
+      return i;
+    }
+  }
+}
+
+void SctpDesc::grow() {
+  std::vector<AssocSlot> old_slots(_slots.size() * 2);
+  old_slots.swap(_slots);
+  _count = 0;
+  _used  = 0;
+  for (const auto& slot : old_slots) {
+    if (slot.state == SLOT_OCCUPIED) {
+      addAssoc(slot.kv.second);
+    }
+  }
+}
+
 void SctpDesc::addAssoc(const SctpAssoc& assoc) {
-  _assocs[assoc.assoc_id] = assoc;
+  // Probe chains stay short only while the table is mostly empty
+  if (_used + 1 > (_slots.size() * 3) / 4) {
+    grow();
+  }
+  size_t mask      = _slots.size() - 1;
+  size_t insert_at = _slots.size();
+  for (size_t i = assoc.assoc_id & mask;; i = (i + 1) & mask) {
+    AssocSlot& slot = _slots[i];
+    if (slot.state == SLOT_OCCUPIED && slot.kv.first == assoc.assoc_id) {
+      slot.kv.second = assoc;  // overwrite, matching the old map behavior
+      return;
+    }
+    if (slot.state == SLOT_TOMBSTONE && insert_at == _slots.size()) {
+      insert_at = i;  // reclaim, but keep probing in case the key exists
+    }
+    if (slot.state == SLOT_EMPTY) {
+      if (insert_at == _slots.size()) {
+        insert_at = i;
+        _used++;
+      }
+      break;
+    }
+  }
+  AssocSlot& slot = _slots[insert_at];
+  slot.state      = SLOT_OCCUPIED;
+  slot.kv.first   = assoc.assoc_id;
+  slot.kv.second  = assoc;
+  _count++;
 }
 
 SctpAssoc& SctpDesc::getAssoc(uint32_t assoc_id) {
-  return _assocs.at(assoc_id);  // throws std::out_of_range
+  size_t i = find_slot(assoc_id);
+  if (i == _slots.size()) {
+    throw std::out_of_range("assoc_id not found");
+  }
+  return _slots[i].kv.second;
 }
 
 int SctpDesc::delAssoc(uint32_t assoc_id) {
-  auto num_removed = _assocs.erase(assoc_id);
-  return num_removed == 1 ? 0 : -1;
+  size_t i = find_slot(assoc_id);
+  if (i == _slots.size()) {
+    return -1;
+  }
+  _slots[i].state = SLOT_TOMBSTONE;
+  _count--;
+  return 0;
+}
+
+SctpDesc::const_iterator::const_iterator(const SctpDesc* desc, size_t index)
+    : _desc(desc), _index(index) {
+  skip_to_occupied();
+}
+
+void SctpDesc::const_iterator::skip_to_occupied() {
+  while (_index < _desc->_slots.size() &&
+         _desc->_slots[_index].state != SLOT_OCCUPIED) {
+    _index++;
+  }
+}
+
+const std::pair<uint32_t, SctpAssoc>& SctpDesc::const_iterator::operator*()
+    const {
+  return _desc->_slots[_index].kv;
+}
+
+const std::pair<uint32_t, SctpAssoc>* SctpDesc::const_iterator::operator->()
+    const {
+  return &_desc->_slots[_index].kv;
+}
+
+SctpDesc::const_iterator& SctpDesc::const_iterator::operator++() {
+  _index++;
+  skip_to_occupied();
+  return *this;
+}
+
+bool SctpDesc::const_iterator::operator==(const const_iterator& other) const {
+  return _desc == other._desc && _index == other._index;
+}
+
+bool SctpDesc::const_iterator::operator!=(const const_iterator& other) const {
+  return !(*this == other);
 }
 
-AssocMap::const_iterator SctpDesc::begin() const {
-  return _assocs.cbegin();
+SctpDesc::const_iterator SctpDesc::begin() const {
+  return const_iterator(this, 0);
 }
 
-AssocMap::const_iterator SctpDesc::end() const {
-  return _assocs.cend();
+SctpDesc::const_iterator SctpDesc::end() const {
+  return const_iterator(this, _slots.size());
 }
 
 int SctpDesc::sd() const {
@@ -48,9 +152,8 @@ int SctpDesc::sd() const {
 }
 
 void SctpDesc::dump() const {
-  for (auto const& kv : _assocs) {
-    auto assoc = kv.second;
-    assoc.dump();
+  for (auto const& kv : *this) {
+    kv.second.dump();
   }
 }
 
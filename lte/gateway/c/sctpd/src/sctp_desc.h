@@ -13,18 +13,24 @@
 
 #pragma once
 
-#include <map>
 #include <memory>
 #include <stdint.h>
+#include <utility>
+#include <vector>
 
 #include "sctp_assoc.h"
 
 namespace magma {
 namespace sctpd {
 
-using AssocMap = std::map<uint32_t, SctpAssoc>;
-
-// Models the state of an SCTP connection and its assocations
+// Models the state of an SCTP connection and its assocations.
+//
+// Associations live in an open-addressed table probed linearly from
+// assoc_id, so resolving the association for a received message is a
+// single probe in the common case (kernel assoc ids are small and
+// sequential). Slots freed by a disconnect are reused in place on the
+// next addAssoc, so an eNB flapping does not allocate; the table only
+// grows past its pre-warmed size when the number of associations does.
 class SctpDesc {
  public:
   // Construct a SCTP assocation on socket, sd
@@ -37,10 +43,29 @@ class SctpDesc {
   // Remove assoc keyed by assoc_id from assoc list, returns 0/-1 on ok/fail
   int delAssoc(uint32_t assoc_id);
 
+  // Forward iterator over the occupied slots, yielding (assoc_id, assoc)
+  // pairs like the std::map this table replaced
+  class const_iterator {
+   public:
+    const_iterator(const SctpDesc* desc, size_t index);
+
+    const std::pair<uint32_t, SctpAssoc>& operator*() const;
+    const std::pair<uint32_t, SctpAssoc>* operator->() const;
+    const_iterator& operator++();
+    bool operator==(const const_iterator& other) const;
+    bool operator!=(const const_iterator& other) const;
+
+   private:
+    void skip_to_occupied();
+
+    const SctpDesc* _desc;
+    size_t _index;
+  };
+
   // Return the starting const_iterator of associations in the SCTP connection
-  AssocMap::const_iterator begin() const;
+  const_iterator begin() const;
   // Return the ending const_iterator of associations in the SCTP connection
-  AssocMap::const_iterator end() const;
+  const_iterator end() const;
 
   // Return the socket descriptor for the SCTP connection
   int sd() const;
@@ -49,10 +74,34 @@ class SctpDesc {
   void dump() const;
 
  private:
-  // List (map) of assocations for the SCTP connection
-  AssocMap _assocs;
+  enum SlotState : uint8_t {
+    SLOT_EMPTY = 0,
+    SLOT_OCCUPIED,
+    // Freed by delAssoc; keeps probe chains intact and is reclaimed by
+    // the next insert that walks over it
+    SLOT_TOMBSTONE,
+  };
+
+  struct AssocSlot {
+    uint8_t state = SLOT_EMPTY;
+    std::pair<uint32_t, SctpAssoc> kv;
+  };
+
+  // Index of the slot holding assoc_id, or _slots.size() if absent
+  size_t find_slot(uint32_t assoc_id) const;
+  // Rebuild the table with twice the capacity, dropping tombstones
+  void grow();
+
+  // Open-addressed association table; capacity is a power of two
+  std::vector<AssocSlot> _slots;
+  // Occupied slots
+  size_t _count;
+  // Occupied plus tombstoned slots, bounds probe lengths and triggers grow
+  size_t _used;
   // Socket descriptor for the SCTP connection
   int _sd;
+
+  friend class const_iterator;
 };
 
 }  // namespace sctpd
@@ -0,0 +1,181 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Shared-memory pool carrying uplink SCTP payloads from sctpd to the MME
+// sctp task. sctpd copies each received payload into a free slot and sends
+// only a slot descriptor over the uplink gRPC, so the PDU bytes stop
+// traveling through protobuf serialization on both sides of the socket.
+// The MME copies the slot into its bstring and releases the slot at once.
+//
+// This header is the single source of truth for the segment layout; the MME
+// build includes it straight from the sctpd source tree. Both sides must be
+// built from the same revision, which the magic/version/geometry check in
+// sctp_ul_shm_attach enforces at run time.
+//
+// Concurrency: slots move FREE -> IN_USE under a CAS by any sctpd thread
+// and back with a release store by the MME reader. The descriptor travels
+// over gRPC after the payload is committed with a release store, so the
+// reader's acquire load of the length sees the full payload. A slot whose
+// descriptor is lost (dropped uplink message) stays IN_USE until sctpd
+// restarts and reclaims the whole pool, bounding the leak to the pool size.
+
+namespace magma {
+namespace sctpd {
+
+constexpr char SCTP_UL_SHM_NAME[]        = "/magma_sctpd_ul_pool";
+constexpr uint32_t SCTP_UL_SHM_MAGIC     = 0x53435550;  // "SCUP"
+constexpr uint32_t SCTP_UL_SHM_VERSION   = 1;
+constexpr uint32_t SCTP_UL_SHM_SLOT_SIZE = 4096;
+constexpr uint32_t SCTP_UL_SHM_SLOTS     = 1024;
+
+enum SctpUlShmSlotState : uint32_t {
+  SCTP_UL_SHM_SLOT_FREE   = 0,
+  SCTP_UL_SHM_SLOT_IN_USE = 1,
+};
+
+struct SctpUlShmSlot {
+  uint32_t state;  // SctpUlShmSlotState, accessed with atomic builtins
+  uint32_t length;
+  uint8_t data[SCTP_UL_SHM_SLOT_SIZE];
+};
+
+struct SctpUlShmPool {
+  uint32_t magic;  // written last by the creator, with release ordering
+  uint32_t version;
+  uint32_t slot_size;
+  uint32_t slot_count;
+  uint32_t alloc_hint;  // round-robin cursor for the next allocation scan
+  SctpUlShmSlot slots[SCTP_UL_SHM_SLOTS];
+};
+
+// Create (or take over) the segment and reset every slot; sctpd side, once
+// at start-up before any descriptor is sent. Returns nullptr on failure, in
+// which case the caller keeps sending payloads inline.
+inline SctpUlShmPool* sctp_ul_shm_create(void) {
+  int fd = shm_open(SCTP_UL_SHM_NAME, O_CREAT | O_RDWR, 0600);
+  if (fd < 0) {
+    return nullptr;
+  }
+  if (ftruncate(fd, sizeof(SctpUlShmPool)) < 0) {
+    close(fd);
+    return nullptr;
+  }
+  void* mem = mmap(
+      nullptr, sizeof(SctpUlShmPool), PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+      0);
+  close(fd);
+  if (mem == MAP_FAILED) {
+    return nullptr;
+  }
+
+  SctpUlShmPool* pool = static_cast<SctpUlShmPool*>(mem);
+  // Fresh start: reclaim whatever a previous run left in flight
+  for (uint32_t i = 0; i < SCTP_UL_SHM_SLOTS; i++) {
+    pool->slots[i].state  = SCTP_UL_SHM_SLOT_FREE;
+    pool->slots[i].length = 0;
+  }
+  pool->version    = SCTP_UL_SHM_VERSION;
+  pool->slot_size  = SCTP_UL_SHM_SLOT_SIZE;
+  pool->slot_count = SCTP_UL_SHM_SLOTS;
+  pool->alloc_hint = 0;
+  __atomic_store_n(&pool->magic, SCTP_UL_SHM_MAGIC, __ATOMIC_RELEASE);
+  return pool;
+}
+
+// Map the segment created by sctpd; MME side, on the first descriptor.
+// Returns nullptr when the segment is missing or its layout disagrees.
+inline SctpUlShmPool* sctp_ul_shm_attach(void) {
+  int fd = shm_open(SCTP_UL_SHM_NAME, O_RDWR, 0);
+  if (fd < 0) {
+    return nullptr;
+  }
+  void* mem = mmap(
+      nullptr, sizeof(SctpUlShmPool), PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+      0);
+  close(fd);
+  if (mem == MAP_FAILED) {
+    return nullptr;
+  }
+
+  SctpUlShmPool* pool = static_cast<SctpUlShmPool*>(mem);
+  if ((__atomic_load_n(&pool->magic, __ATOMIC_ACQUIRE) !=
+       SCTP_UL_SHM_MAGIC) ||
+      (pool->version != SCTP_UL_SHM_VERSION) ||
+      (pool->slot_size != SCTP_UL_SHM_SLOT_SIZE) ||
+      (pool->slot_count != SCTP_UL_SHM_SLOTS)) {
+    munmap(mem, sizeof(SctpUlShmPool));
+    return nullptr;
+  }
+  return pool;
+}
+
+// Claim a free slot for a payload of the given length. Returns the slot
+// index, or -1 when the payload does not fit or the pool is exhausted; the
+// caller then falls back to the inline payload path.
+inline int sctp_ul_shm_alloc(SctpUlShmPool* pool, uint32_t length) {
+  if (length > SCTP_UL_SHM_SLOT_SIZE) {
+    return -1;
+  }
+  uint32_t hint = __atomic_fetch_add(&pool->alloc_hint, 1, __ATOMIC_RELAXED);
+  for (uint32_t i = 0; i < SCTP_UL_SHM_SLOTS; i++) {
+    uint32_t idx      = (hint + i) % SCTP_UL_SHM_SLOTS;
+    uint32_t expected = SCTP_UL_SHM_SLOT_FREE;
+    if (__atomic_compare_exchange_n(
+            &pool->slots[idx].state, &expected, SCTP_UL_SHM_SLOT_IN_USE,
+            false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+      return static_cast<int>(idx);
+    }
+  }
+  return -1;
+}
+
+// Publish the payload written into the slot; call after the memcpy and
+// before sending the descriptor
+inline void sctp_ul_shm_commit(
+    SctpUlShmPool* pool, uint32_t index, uint32_t length) {
+  __atomic_store_n(&pool->slots[index].length, length, __ATOMIC_RELEASE);
+}
+
+// Validate and read a descriptor on the MME side. Returns the payload
+// pointer and stores its length, or nullptr for a corrupt descriptor. The
+// slot stays claimed until sctp_ul_shm_release.
+inline const uint8_t* sctp_ul_shm_read(
+    SctpUlShmPool* pool, uint32_t index, uint32_t* length) {
+  if (index >= SCTP_UL_SHM_SLOTS) {
+    return nullptr;
+  }
+  uint32_t len = __atomic_load_n(&pool->slots[index].length, __ATOMIC_ACQUIRE);
+  if (len > SCTP_UL_SHM_SLOT_SIZE) {
+    return nullptr;
+  }
+  *length = len;
+  return pool->slots[index].data;
+}
+
+// Hand a slot back to sctpd once its payload has been consumed
+inline void sctp_ul_shm_release(SctpUlShmPool* pool, uint32_t index) {
+  __atomic_store_n(
+      &pool->slots[index].state, SCTP_UL_SHM_SLOT_FREE, __ATOMIC_RELEASE);
+}
+
+}  // namespace sctpd
+}  // namespace magma
@@ -15,6 +15,8 @@
 
 #include <lte/protos/sctpd.grpc.pb.h>
 
+#include "magma_sdt.h"
+
 namespace magma {
 namespace sctpd {
 
@@ -50,14 +52,23 @@ void SctpdEventHandler::HandleCloseAssoc(
 
 void SctpdEventHandler::HandleRecv(
     uint32_t ppid, uint32_t assoc_id, uint32_t stream,
-    const std::string& payload) {
+    const std::string& payload, int shm_index, uint32_t shm_length) {
   SendUlReq req;
   SendUlRes res;
 
+  MAGMA_USDT3(
+      sctpd_recv, assoc_id, stream,
+      shm_index >= 0 ? shm_length : payload.size());
+
   req.set_ppid(ppid);
   req.set_assoc_id(assoc_id);
   req.set_stream(stream);
-  req.set_payload(payload);
+  if (shm_index >= 0) {
+    req.set_shm_index(shm_index);
+    req.set_shm_length(shm_length);
+  } else {
+    req.set_payload(payload);
+  }
 
   _client.sendUl(req, &res);
 }
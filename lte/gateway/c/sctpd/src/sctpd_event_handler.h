@@ -34,10 +34,11 @@ class SctpdEventHandler : public SctpEventHandler {
   // Relay close assocation to MME/AMF over GRPC
   void HandleCloseAssoc(uint32_t ppid, uint32_t assoc_id, bool reset) override;
 
-  // Relay new message to MME over GRPC
+  // Relay new message to MME over GRPC, either inline or as a shm slot
+  // descriptor (shm_index >= 0)
   void HandleRecv(
       uint32_t ppid, uint32_t assoc_id, uint32_t stream,
-      const std::string& payload) override;
+      const std::string& payload, int shm_index, uint32_t shm_length) override;
 
  private:
   SctpdUplinkClient& _client;
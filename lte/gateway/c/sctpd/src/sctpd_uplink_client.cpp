@@ -18,21 +18,46 @@
 namespace magma {
 namespace sctpd {
 
-using grpc::ClientContext;
+SctpdUplinkClient::SctpdUplinkClient(std::shared_ptr<Channel> channel)
+    : _ul_done(false), _ul_inflight(false) {
+  _stub      = SctpdUplink::NewStub(channel);
+  _ul_thread =
+      std::make_unique<std::thread>(&SctpdUplinkClient::sendUlLoop, this);
+}
 
-SctpdUplinkClient::SctpdUplinkClient(std::shared_ptr<Channel> channel) {
-  _stub = SctpdUplink::NewStub(channel);
+SctpdUplinkClient::~SctpdUplinkClient() {
+  _ul_done = true;
+  _ul_cv.notify_all();
+  if (_ul_thread != nullptr) _ul_thread->join();
+  closeUlStream();
 }
 
 int SctpdUplinkClient::sendUl(const SendUlReq& req, SendUlRes* res) {
   assert(res != nullptr);
 
+  std::unique_lock<std::mutex> lock(_ul_lock);
+  // Block while the queue is full - this is the backpressure path; the
+  // calling receive worker stops draining its shard, which in turn pushes
+  // back on the peer through the sctp receive window
+  while (_ul_queue.size() >= MAX_UL_QUEUE_DEPTH && !_ul_done) {
+    _ul_cv.wait_for(lock, std::chrono::milliseconds(100));
+  }
+  if (_ul_done) return -1;
+  _ul_queue.push_back(req);
+  lock.unlock();
+  _ul_cv.notify_all();
+
+  return 0;
+}
+
+int SctpdUplinkClient::sendUlUnary(const SendUlReq& req) {
+  SendUlRes res;
   ClientContext context;
   auto deadline = std::chrono::system_clock::now() +
                   std::chrono::milliseconds(1000 * RESPONSE_TIMEOUT);
   context.set_deadline(deadline);
 
-  auto status = _stub->SendUl(&context, req, res);
+  auto status = _stub->SendUl(&context, req, &res);
 
   if (!status.ok()) {
     MLOG(MERROR) << "sctpul.sendul error";
@@ -42,6 +67,78 @@ int SctpdUplinkClient::sendUl(const SendUlReq& req, SendUlRes* res) {
   return status.ok() ? 0 : -1;
 }
 
+bool SctpdUplinkClient::openUlStream() {
+  _ul_context = std::make_unique<ClientContext>();
+  _ul_writer  = _stub->SendUlStream(_ul_context.get(), &_ul_stream_res);
+  if (_ul_writer == nullptr) {
+    _ul_context = nullptr;
+    return false;
+  }
+  return true;
+}
+
+void SctpdUplinkClient::closeUlStream() {
+  if (_ul_writer != nullptr) {
+    _ul_writer->WritesDone();
+    auto status = _ul_writer->Finish();
+    if (!status.ok()) {
+      MLOG(MERROR) << "sctpul.sendulstream error";
+      MLOG_grpcerr(status);
+    }
+    _ul_writer  = nullptr;
+    _ul_context = nullptr;
+  }
+}
+
+void SctpdUplinkClient::sendUlLoop() {
+  std::unique_lock<std::mutex> lock(_ul_lock);
+
+  // Drain the queue before exiting so no received message is dropped on close
+  while (!_ul_done || !_ul_queue.empty()) {
+    if (_ul_queue.empty()) {
+      _ul_cv.wait_for(lock, std::chrono::milliseconds(100));
+      continue;
+    }
+
+    // Take whatever accumulated since the last flush as one batch and write
+    // it without holding the lock, so enqueuers are not serialized behind
+    // the stream writes
+    std::deque<SendUlReq> batch;
+    batch.swap(_ul_queue);
+    _ul_inflight = true;
+    lock.unlock();
+    _ul_cv.notify_all();
+
+    for (auto& req : batch) {
+      if (_ul_writer == nullptr && !openUlStream()) {
+        // Stream could not be opened - fall back to one-off unary calls so
+        // the batch still reaches MME
+        sendUlUnary(req);
+        continue;
+      }
+      if (!_ul_writer->Write(req)) {
+        // The stream broke mid-batch; collect its final status, then retry
+        // this packet on a fresh stream or the unary fallback
+        closeUlStream();
+        if (openUlStream() && _ul_writer->Write(req)) continue;
+        closeUlStream();
+        sendUlUnary(req);
+      }
+    }
+
+    lock.lock();
+    _ul_inflight = false;
+    _ul_cv.notify_all();
+  }
+}
+
+void SctpdUplinkClient::flushUlQueue() {
+  std::unique_lock<std::mutex> lock(_ul_lock);
+  while ((!_ul_queue.empty() || _ul_inflight) && !_ul_done) {
+    _ul_cv.wait_for(lock, std::chrono::milliseconds(10));
+  }
+}
+
 int SctpdUplinkClient::newAssoc(const NewAssocReq& req, NewAssocRes* res) {
   assert(res != nullptr);
 
@@ -64,6 +161,10 @@ int SctpdUplinkClient::closeAssoc(
     const CloseAssocReq& req, CloseAssocRes* res) {
   assert(res != nullptr);
 
+  // Make sure data queued before the close has been written, so MME never
+  // observes the close ahead of messages received on the association
+  flushUlQueue();
+
   ClientContext context;
   // Not putting a timeout event for closeAssoc events
   auto status = _stub->CloseAssoc(&context, req, res);
@@ -13,7 +13,12 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 #include <grpcpp/grpcpp.h>
 
@@ -23,12 +28,15 @@ namespace magma {
 namespace sctpd {
 
 using grpc::Channel;
+using grpc::ClientContext;
+using grpc::ClientWriter;
 
 // Grpc uplink client to allow sctpd to signal MME
 class SctpdUplinkClient {
  public:
   // Construct SctpdUplinkClient with the specified channel
   explicit SctpdUplinkClient(std::shared_ptr<Channel> channel);
+  virtual ~SctpdUplinkClient();
 
   // Send an uplink packet to MME (see sctpd.proto for more info)
   virtual int sendUl(const SendUlReq& req, SendUlRes* res);
@@ -38,10 +46,47 @@ class SctpdUplinkClient {
   virtual int closeAssoc(const CloseAssocReq& req, CloseAssocRes* res);
 
  private:
+  // Send an uplink packet with a one-off unary call - fallback path used
+  // when the long-lived stream is down
+  int sendUlUnary(const SendUlReq& req);
+  // Writer loop run by _ul_thread - flushes queued uplink packets onto the
+  // long-lived SendUlStream call, batching whatever accumulated per wakeup
+  void sendUlLoop();
+  // Block until every queued uplink packet has been written - keeps close
+  // notifications from overtaking data queued before them
+  void flushUlQueue();
+  // Open the long-lived uplink stream; returns true on success
+  bool openUlStream();
+  // Tear down the long-lived uplink stream after a write failure
+  void closeUlStream();
+
   // Stub used for client to communicate with server
   std::unique_ptr<SctpdUplink::Stub> _stub;
   // GRPC call timeout
   static const uint32_t RESPONSE_TIMEOUT = 2;  // seconds
+  // Bound on queued uplink packets - when reached sendUl blocks, which stalls
+  // the sctp receive workers and pushes back on the peer's send window
+  static const size_t MAX_UL_QUEUE_DEPTH = 1024;
+
+  // Uplink packets waiting to be written onto the stream
+  std::deque<SendUlReq> _ul_queue;
+  // Guards _ul_queue
+  std::mutex _ul_lock;
+  // Signals the writer thread on enqueue and sendUl callers on dequeue
+  std::condition_variable _ul_cv;
+  // Set to true when the client is shutting down
+  std::atomic<bool> _ul_done;
+  // True while the writer thread is flushing a batch it already dequeued
+  bool _ul_inflight;
+  // Thread owning the long-lived stream - single writer, so per-association
+  // ordering established by the enqueue order is preserved on the wire
+  std::unique_ptr<std::thread> _ul_thread;
+  // Call context of the long-lived stream - must outlive _ul_writer
+  std::unique_ptr<ClientContext> _ul_context;
+  // Writer end of the long-lived stream, null when the stream is down
+  std::unique_ptr<ClientWriter<SendUlReq>> _ul_writer;
+  // Response object for the long-lived stream, filled in at Finish
+  SendUlRes _ul_stream_res;
 };
 
 }  // namespace sctpd
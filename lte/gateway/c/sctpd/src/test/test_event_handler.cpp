@@ -135,7 +135,22 @@ TEST_F(EventHandlerTest, test_event_handler_send_ul) {
 
   _handler->HandleRecv(
       send_ul_req.ppid(), send_ul_req.assoc_id(), send_ul_req.stream(),
-      send_ul_req.payload());
+      send_ul_req.payload(), -1, 0);
+}
+
+TEST_F(EventHandlerTest, test_event_handler_send_ul_shm) {
+  // With a claimed shm slot only the descriptor travels, payload stays empty
+  auto correct_shm_index   = Property(&SendUlReq::shm_index, Eq(7u));
+  auto correct_shm_length  = Property(&SendUlReq::shm_length, Eq(42u));
+  auto empty_payload       = Property(&SendUlReq::payload, Eq(""));
+  auto correct_send_ul_req =
+      AllOf(correct_shm_index, correct_shm_length, empty_payload);
+
+  EXPECT_CALL(*_uplink_client, sendUl(correct_send_ul_req, NotNull())).Times(1);
+
+  _handler->HandleRecv(
+      send_ul_req.ppid(), send_ul_req.assoc_id(), send_ul_req.stream(), "", 7,
+      42);
 }
 
 }  // namespace sctpd
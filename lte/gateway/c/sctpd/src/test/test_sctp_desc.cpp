@@ -99,6 +99,39 @@ TEST_F(SctpdDescTest, test_sctpd_desc) {
   EXPECT_THROW(desc.getAssoc(ASSOC_2_ASSOC_ID), std::out_of_range);
 }
 
+TEST_F(SctpdDescTest, test_sctpd_desc_grow_and_reuse) {
+  SctpDesc desc(DESC_SD);
+
+  // grow well past the pre-warmed table size
+  for (uint32_t id = 1; id <= 200; id++) {
+    SctpAssoc assoc;
+    assoc.assoc_id = id;
+    assoc.sd       = id + 10;
+    desc.addAssoc(assoc);
+  }
+  for (uint32_t id = 1; id <= 200; id++) {
+    EXPECT_EQ(id + 10, desc.getAssoc(id).sd);
+  }
+
+  // a flapping association reuses its slot in place
+  for (int round = 0; round < 1000; round++) {
+    EXPECT_EQ(0, desc.delAssoc(42));
+    SctpAssoc assoc;
+    assoc.assoc_id = 42;
+    assoc.sd       = round;
+    desc.addAssoc(assoc);
+  }
+  EXPECT_EQ(999, desc.getAssoc(42).sd);
+
+  // iteration still sees every association exactly once
+  int count = 0;
+  for (auto kv : desc) {
+    EXPECT_EQ(kv.first, kv.second.assoc_id);
+    count++;
+  }
+  EXPECT_EQ(200, count);
+}
+
 }  // namespace sctpd
 }  // namespace magma
 
@@ -11,6 +11,7 @@
  * limitations under the License.
  */
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <utility>
@@ -64,17 +65,126 @@ aaa::add_sessions_request create_add_sessions_req(
 
 namespace aaa {
 
+uint32_t AsyncAAAClient::BATCH_WINDOW_MS    = 50;
+uint32_t AsyncAAAClient::BATCH_MAX_SESSIONS = 256;
+
 AsyncAAAClient::AsyncAAAClient(std::shared_ptr<grpc::Channel> channel)
-    : stub_(accounting::NewStub(channel)) {}
+    : stub_(accounting::NewStub(channel)), flusher_running_(true) {
+  flusher_thread_ = std::thread([this]() { flusher_loop(); });
+}
 
 AsyncAAAClient::AsyncAAAClient()
     : AsyncAAAClient(
           magma::ServiceRegistrySingleton::Instance()->GetGrpcChannel(
               "aaa_server", magma::ServiceRegistrySingleton::LOCAL)) {}
 
+AsyncAAAClient::~AsyncAAAClient() {
+  {
+    std::lock_guard<std::mutex> lock(pending_lock_);
+    flusher_running_ = false;
+  }
+  pending_cv_.notify_all();
+  flusher_thread_.join();
+}
+
 bool AsyncAAAClient::terminate_session(
     const std::string& radius_session_id, const std::string& imsi) {
-  auto req = create_deactivate_req(radius_session_id, imsi);
+  if (BATCH_WINDOW_MS == 0) {
+    auto req = create_deactivate_req(radius_session_id, imsi);
+    send_terminate_rpc(req);
+    return true;
+  }
+  {
+    std::lock_guard<std::mutex> lock(pending_lock_);
+    // A queued add for the same Radius session is superseded; repeated
+    // terminates collapse into one
+    pending_adds_.erase(radius_session_id);
+    pending_terminates_[radius_session_id] = imsi;
+  }
+  pending_cv_.notify_one();
+  return true;
+}
+
+bool AsyncAAAClient::add_sessions(const magma::lte::SessionMap& session_map) {
+  auto req = create_add_sessions_req(session_map);
+  if (req.sessions().size() == 0) {
+    MLOG(MINFO) << "Not sending add_sessions request to AAA server. No AAA "
+                << "sessions found";
+    return true;
+  }
+  if (BATCH_WINDOW_MS == 0) {
+    send_add_batch(req);
+    return true;
+  }
+  {
+    std::lock_guard<std::mutex> lock(pending_lock_);
+    for (context& ctx : *req.mutable_sessions()) {
+      // Keyed by Radius session ID, so re-adding an already-queued session
+      // replaces it rather than duplicating it in the batch
+      pending_adds_[ctx.session_id()].Swap(&ctx);
+    }
+  }
+  pending_cv_.notify_one();
+  return true;
+}
+
+void AsyncAAAClient::flusher_loop() {
+  std::unique_lock<std::mutex> lock(pending_lock_);
+  while (flusher_running_) {
+    pending_cv_.wait(lock, [this]() {
+      return !flusher_running_ || !pending_terminates_.empty() ||
+             !pending_adds_.empty();
+    });
+    if (!flusher_running_) {
+      break;
+    }
+    // Let the window fill so churn bursts coalesce, unless the batch is
+    // already at capacity
+    if (pending_adds_.size() < BATCH_MAX_SESSIONS &&
+        pending_terminates_.size() < BATCH_MAX_SESSIONS) {
+      pending_cv_.wait_for(lock, std::chrono::milliseconds(BATCH_WINDOW_MS));
+    }
+    auto terminates = std::move(pending_terminates_);
+    auto adds       = std::move(pending_adds_);
+    pending_terminates_ = {};
+    pending_adds_       = {};
+    lock.unlock();
+    flush_pending_ops(std::move(terminates), std::move(adds));
+    lock.lock();
+  }
+}
+
+void AsyncAAAClient::flush_pending_ops(
+    std::unordered_map<std::string, std::string> terminates,
+    std::unordered_map<std::string, context> adds) {
+  if (terminates.size() + adds.size() > 1) {
+    MLOG(MDEBUG) << "Flushing " << terminates.size() << " terminates and "
+                 << adds.size() << " adds to aaa_server";
+  }
+  // Terminates go out first: a session that was terminated and re-added
+  // within the same window holds its key in both maps and must end up
+  // active on the AAA side
+  for (const auto& it : terminates) {
+    auto req = create_deactivate_req(it.first, it.second);
+    send_terminate_rpc(req);
+  }
+  add_sessions_request req;
+  for (auto& it : adds) {
+    req.mutable_sessions()->Add()->Swap(&it.second);
+    if (static_cast<uint32_t>(req.sessions().size()) >= BATCH_MAX_SESSIONS) {
+      send_add_batch(req);
+      req.clear_sessions();
+    }
+  }
+  if (req.sessions().size() > 0) {
+    send_add_batch(req);
+  }
+}
+
+void AsyncAAAClient::send_terminate_rpc(
+    const terminate_session_request& req) {
+  const std::string radius_session_id = req.radius_session_id();
+  const std::string imsi              = req.imsi();
   terminate_session_rpc(
       req, [radius_session_id, imsi](Status status, acct_resp resp) {
         if (status.ok()) {
@@ -86,17 +196,10 @@ bool AsyncAAAClient::terminate_session(
                        << ", Error: " << status.error_message();
         }
       });
-  return true;
 }
 
-bool AsyncAAAClient::add_sessions(const magma::lte::SessionMap& session_map) {
-  auto req = create_add_sessions_req(session_map);
-  if (req.sessions().size() == 0) {
-    MLOG(MINFO) << "Not sending add_sessions request to AAA server. No AAA "
-                << "sessions found";
-    return true;
-  }
-  add_sessions_rpc(req, [this](Status status, acct_resp resp) {
+void AsyncAAAClient::send_add_batch(const add_sessions_request& req) {
+  add_sessions_rpc(req, [](Status status, acct_resp resp) {
     if (status.ok()) {
       MLOG(MINFO) << "Successfully added all existing sessions to AAA server";
     } else {
@@ -104,7 +207,6 @@ bool AsyncAAAClient::add_sessions(const magma::lte::SessionMap& session_map) {
                    << " Error: " << status.error_message();
     }
   });
-  return true;
 }
 
 void AsyncAAAClient::add_sessions_rpc(
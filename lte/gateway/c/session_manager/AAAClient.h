@@ -14,8 +14,12 @@
 
 #include <feg/gateway/services/aaa/protos/accounting.grpc.pb.h>
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 
 #include "includes/GRPCReceiver.h"
 #include "SessionState.h"
@@ -42,13 +46,35 @@ class AAAClient {
 /**
  * AsyncAAAClient implements AAAClient and sends call
  * asynchronously to AAA service.
+ *
+ * Session lifecycle calls are coalesced: pending operations are keyed by
+ * Radius session ID so carrier-wifi churn (device sleep cycles re-adding and
+ * terminating the same session) collapses into a single operation, with a
+ * terminate superseding a pending add. A flusher thread drains the pending
+ * set every BATCH_WINDOW_MS, so callers on the enforcer event loop only pay
+ * for a map insert, and adds go out through the bulk add_sessions RPC in
+ * batches of at most BATCH_MAX_SESSIONS.
  */
 class AsyncAAAClient : public magma::GRPCReceiver, public AAAClient {
  public:
+  /**
+   * Time pending operations are allowed to accumulate before a flush.
+   * 0 disables coalescing and sends each RPC inline.
+   */
+  static uint32_t BATCH_WINDOW_MS;
+
+  /**
+   * Maximum sessions per bulk add_sessions request; reaching it triggers an
+   * immediate flush
+   */
+  static uint32_t BATCH_MAX_SESSIONS;
+
   AsyncAAAClient();
 
   explicit AsyncAAAClient(std::shared_ptr<grpc::Channel> aaa_channel);
 
+  ~AsyncAAAClient();
+
   bool terminate_session(
       const std::string& radius_session_id, const std::string& imsi);
 
@@ -57,8 +83,27 @@ class AsyncAAAClient : public magma::GRPCReceiver, public AAAClient {
  private:
   static const uint32_t RESPONSE_TIMEOUT = 6;  // seconds
   std::unique_ptr<accounting::Stub> stub_;
+  // Pending coalesced operations, keyed by Radius session ID. Guarded by
+  // pending_lock_; the flusher thread swaps them out and sends the RPCs off
+  // the caller's thread.
+  std::mutex pending_lock_;
+  std::condition_variable pending_cv_;
+  std::unordered_map<std::string, std::string> pending_terminates_;
+  std::unordered_map<std::string, context> pending_adds_;
+  bool flusher_running_;
+  std::thread flusher_thread_;
 
  private:
+  void flusher_loop();
+
+  void flush_pending_ops(
+      std::unordered_map<std::string, std::string> terminates,
+      std::unordered_map<std::string, context> adds);
+
+  void send_terminate_rpc(const terminate_session_request& req);
+
+  void send_add_batch(const add_sessions_request& req);
+
   void terminate_session_rpc(
       const terminate_session_request& request,
       std::function<void(Status, acct_resp)> callback);
@@ -1,3 +1,6 @@
+#include <chrono>
+#include <utility>
+
 #include "AmfServiceClient.h"
 #include "includes/ServiceRegistrySingleton.h"
 #include "magma_logging.h"
@@ -12,13 +15,24 @@ void call_back_void_amf(grpc::Status, magma::SmContextVoid respvoid) {
 std::function<void(grpc::Status, magma::SmContextVoid)> callback =
     call_back_void_amf;
 
+// Coalescing window for notifications toward the AMF; kept short since
+// paging and state notifications are latency sensitive
+const size_t NOTIF_BATCH_MAX_SIZE = 64;
+const std::chrono::milliseconds NOTIF_BATCH_MAX_DELAY(20);
+
 }  // namespace
 
 namespace magma {
 
 AsyncAmfServiceClient::AsyncAmfServiceClient(
     std::shared_ptr<grpc::Channel> channel)
-    : stub_(SmfPduSessionSmContext::NewStub(channel)) {}
+    : stub_(SmfPduSessionSmContext::NewStub(channel)) {
+  notif_batcher_.reset(new GRPCBatcher<SetSmNotificationContext>(
+      [this](std::vector<SetSmNotificationContext> notifications) {
+        send_notifications_to_access(std::move(notifications));
+      },
+      NOTIF_BATCH_MAX_SIZE, NOTIF_BATCH_MAX_DELAY));
+}
 
 AsyncAmfServiceClient::AsyncAmfServiceClient()
     : AsyncAmfServiceClient(
@@ -37,12 +51,31 @@ bool AsyncAmfServiceClient::handle_response_to_access(
 
 bool AsyncAmfServiceClient::handle_notification_to_access(
     const magma::SetSmNotificationContext& notif) {
-  MLOG(MDEBUG) << "Sending Set SM Session Notification from SMF ";
+  notif_batcher_->Enqueue(notif);
+  return true;
+}
+
+void AsyncAmfServiceClient::send_notifications_to_access(
+    std::vector<SetSmNotificationContext> notifications) {
+  if (notifications.empty()) {
+    return;
+  }
+  MLOG(MDEBUG) << "Sending " << notifications.size()
+               << " Set SM Session Notification(s) from SMF ";
   auto local_resp = new AsyncLocalResponse<SmContextVoid>(
       std::move(callback), RESPONSE_TIMEOUT);
-  local_resp->set_response_reader(std::move(stub_->AsyncSetAmfNotification(
-      local_resp->get_context(), notif, &queue_)));
-  return true;
+  if (notifications.size() == 1) {
+    // Keep the unary RPC for the common single-notification case
+    local_resp->set_response_reader(std::move(stub_->AsyncSetAmfNotification(
+        local_resp->get_context(), notifications.front(), &queue_)));
+    return;
+  }
+  SetSmNotificationsContext batch;
+  for (auto& notif : notifications) {
+    batch.add_notifications()->Swap(&notif);
+  }
+  local_resp->set_response_reader(std::move(stub_->AsyncSetAmfNotifications(
+      local_resp->get_context(), batch, &queue_)));
 }
 
 }  // namespace magma
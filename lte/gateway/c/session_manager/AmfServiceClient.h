@@ -12,7 +12,9 @@
  */
 #pragma once
 
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include <grpc++/grpc++.h>
 #include <lte/protos/session_manager.pb.h>
@@ -49,12 +51,22 @@ class AsyncAmfServiceClient : public GRPCReceiver, public AmfServiceClient {
   bool handle_response_to_access(
       const magma::SetSMSessionContextAccess& response);
 
+  /* Notifications are coalesced within a short window and delivered with
+   * one SetAmfNotifications RPC, so the N-session burst after a UPF
+   * restoration costs the AMF one call per batch instead of per session.
+   * A batch of one still goes out over the unary RPC.
+   */
   bool handle_notification_to_access(
       const magma::SetSmNotificationContext& req);
 
  private:
   static const uint32_t RESPONSE_TIMEOUT = 6;  // seconds
   std::unique_ptr<SmfPduSessionSmContext::Stub> stub_;
+  std::unique_ptr<GRPCBatcher<SetSmNotificationContext>> notif_batcher_;
+
+  // Send one batch of coalesced notifications toward the AMF
+  void send_notifications_to_access(
+      std::vector<SetSmNotificationContext> notifications);
 };
 
 }  // namespace magma
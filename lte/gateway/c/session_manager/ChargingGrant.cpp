@@ -407,4 +407,38 @@ PolicyRule ChargingGrant::make_redirect_rule() {
   redirect_info->set_server_address(redirect_server.redirect_server_address());
   return redirect_rule;
 }
+
+void ChargingGrant::precompile_final_action_rules(
+    StaticRuleStore& static_rules) {
+  final_action_rules.clear();
+  if (!is_final_grant) {
+    return;
+  }
+  switch (final_action_info.final_action) {
+    case ChargingCredit_FinalAction_REDIRECT:
+      final_action_rules.push_back(make_redirect_rule());
+      break;
+    case ChargingCredit_FinalAction_RESTRICT_ACCESS:
+      for (const std::string& rule_id : final_action_info.restrict_rules) {
+        PolicyRule rule;
+        if (!static_rules.get_rule(rule_id, &rule)) {
+          MLOG(MWARNING) << "Static rule " << rule_id
+                         << " requested as a restrict rule is not found.";
+          continue;
+        }
+        final_action_rules.push_back(rule);
+      }
+      break;
+    default:  // TERMINATE installs no rules
+      break;
+  }
+}
+
+const std::vector<PolicyRule>& ChargingGrant::get_final_action_rules(
+    StaticRuleStore& static_rules) {
+  if (final_action_rules.empty()) {
+    precompile_final_action_rules(static_rules);
+  }
+  return final_action_rules;
+}
 }  // namespace magma
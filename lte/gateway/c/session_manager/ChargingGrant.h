@@ -13,6 +13,7 @@
 #pragma once
 
 #include "DiameterCodes.h"
+#include "RuleStore.h"
 #include "ServiceAction.h"
 #include "SessionCredit.h"
 #include "StoredState.h"
@@ -48,6 +49,11 @@ struct ChargingGrant {
   ReAuthState reauth_state;
   // indicates the rules have been removed from pipelined
   bool suspended;
+  // Precompiled redirect/restrict PolicyRules for the final unit action.
+  // Built at grant receipt so a quota-exhaustion wave installs cached protos
+  // instead of rebuilding them per fire. Not marshaled; compiled again on
+  // first use after a restart.
+  std::vector<PolicyRule> final_action_rules;
 
   const uint32_t REDIRECT_FLOW_PRIORITY = 2000;
 
@@ -138,6 +144,15 @@ struct ChargingGrant {
   void log_received_grant(const CreditUpdateResponse& update);
 
   PolicyRule make_redirect_rule();
+
+  // (Re)build final_action_rules from final_action_info. Restrict rule IDs
+  // are resolved against the static rule store once, at receipt.
+  void precompile_final_action_rules(StaticRuleStore& static_rules);
+
+  // Return the precompiled final-unit-action rules, compiling them first
+  // when the grant was restored from storage and has none yet.
+  const std::vector<PolicyRule>& get_final_action_rules(
+      StaticRuleStore& static_rules);
 };
 
 }  // namespace magma
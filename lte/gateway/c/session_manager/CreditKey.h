@@ -24,10 +24,19 @@ using namespace lte;
 struct CreditKey {
   uint32_t rating_group;
   uint32_t service_identifier;
-  CreditKey() : rating_group(0), service_identifier(0) {}
-  CreditKey(uint32_t rg) : rating_group(rg), service_identifier(0) {}
+  // Mixed 64-bit hash of the two ids, computed once here so the credit
+  // maps consulted on every usage update do not rehash per lookup. Kept in
+  // sync by the constructors and setters; assign whole keys rather than
+  // the individual fields.
+  uint64_t hash;
+  CreditKey() : rating_group(0), service_identifier(0) { update_hash(); }
+  CreditKey(uint32_t rg) : rating_group(rg), service_identifier(0) {
+    update_hash();
+  }
   CreditKey(uint32_t rg, uint32_t si)
-      : rating_group(rg), service_identifier(si) {}
+      : rating_group(rg), service_identifier(si) {
+    update_hash();
+  }
   CreditKey(const PolicyRule* rule) { set(rule); }
   CreditKey(const PolicyRule& rule) { set(&rule); }
   CreditKey(const CreditUsage* usage) { set(usage); }
@@ -43,6 +52,7 @@ struct CreditKey {
       service_identifier = rule->has_service_identifier() ?
                                rule->service_identifier().value() :
                                0;
+      update_hash();
     }
     return this;
   }
@@ -62,6 +72,7 @@ struct CreditKey {
       service_identifier = usage->has_service_identifier() ?
                                usage->service_identifier().value() :
                                0;
+      update_hash();
     }
     return this;
   }
@@ -81,6 +92,7 @@ struct CreditKey {
       service_identifier = update->has_service_identifier() ?
                                update->service_identifier().value() :
                                0;
+      update_hash();
     }
     return this;
   }
@@ -90,9 +102,26 @@ struct CreditKey {
       service_identifier = reath->has_service_identifier() ?
                                reath->service_identifier().value() :
                                0;
+      update_hash();
     }
     return this;
   }
+
+  // splitmix64 finalizer over the packed ids: full avalanche, so
+  // consecutive rating groups spread across buckets instead of clustering
+  // into the probe chains the old shift-and-add combiner produced. A zero
+  // service identifier contributes nothing, matching the wildcard
+  // semantics of ccEqual.
+  void update_hash() {
+    uint64_t x = (static_cast<uint64_t>(rating_group) << 32) |
+                 static_cast<uint64_t>(service_identifier);
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    hash = x;
+  }
 };
 
 inline std::ostream& operator<<(std::ostream& s, const CreditKey& k) {
@@ -104,12 +133,7 @@ inline std::ostream& operator<<(std::ostream& s, const CreditKey& k) {
 }
 
 inline size_t ccHash(const CreditKey& k) {
-  static const int ccHashShift = sizeof(size_t) > sizeof(uint32_t) ? 32 : 1;
-  size_t res = std::hash<uint32_t>()(k.rating_group) << ccHashShift;
-  if (k.service_identifier) {
-    res += std::hash<uint32_t>()(k.service_identifier);
-  }
-  return res;
+  return static_cast<size_t>(k.hash);
 };
 
 inline bool ccEqual(const CreditKey& l, const CreditKey& r) {
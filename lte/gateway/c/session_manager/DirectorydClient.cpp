@@ -11,8 +11,12 @@
  * limitations under the License.
  */
 
+#include <chrono>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "DirectorydClient.h"
 #include "magma_logging.h"
@@ -20,11 +24,53 @@
 
 using grpc::Status;
 
+namespace {
+// Coalesce record updates for up to half a second or 64 records
+const size_t RECORD_BATCH_MAX_SIZE = 64;
+const std::chrono::milliseconds RECORD_BATCH_MAX_DELAY(500);
+// The dedup cache holds one entry per active session; a runaway size
+// means stale entries, so it is simply reset
+const size_t RECORD_CACHE_MAX_ENTRIES = 16384;
+// Records parked for replay during a directoryd brown-out are keyed per
+// IMSI, so this bound is only hit under sustained outage plus churn
+const size_t MAX_REPLAY_RECORDS = 8192;
+}  // namespace
+
 namespace magma {
 
 AsyncDirectorydClient::AsyncDirectorydClient(
     std::shared_ptr<grpc::Channel> channel)
-    : stub_(GatewayDirectoryService::NewStub(channel)) {}
+    : stub_(GatewayDirectoryService::NewStub(channel)) {
+  update_batcher_.reset(new GRPCBatcher<UpdateRecordRequest>(
+      [this](std::vector<UpdateRecordRequest> updates) {
+        // Merge replayed records and this tick's updates per IMSI,
+        // last write wins per field
+        std::unordered_map<std::string, UpdateRecordRequest> merged;
+        {
+          std::lock_guard<std::mutex> lock(cache_mutex_);
+          merged.swap(replay_records_);
+        }
+        for (auto& update : updates) {
+          auto it = merged.find(update.id());
+          if (it == merged.end()) {
+            merged[update.id()] = std::move(update);
+            continue;
+          }
+          if (!update.location().empty()) {
+            it->second.set_location(update.location());
+          }
+          for (const auto& field : update.fields()) {
+            (*it->second.mutable_fields())[field.first] = field.second;
+          }
+        }
+        UpdateRecordsRequest batch;
+        for (auto& record : merged) {
+          batch.add_records()->Swap(&record.second);
+        }
+        update_directoryd_records(std::move(batch));
+      },
+      RECORD_BATCH_MAX_SIZE, RECORD_BATCH_MAX_DELAY));
+}
 
 AsyncDirectorydClient::AsyncDirectorydClient()
     : AsyncDirectorydClient(
@@ -34,15 +80,86 @@ AsyncDirectorydClient::AsyncDirectorydClient()
 void AsyncDirectorydClient::update_directoryd_record(
     const UpdateRecordRequest& request,
     std::function<void(Status status, Void)> callback) {
-  auto local_response =
-      new AsyncLocalResponse<Void>(std::move(callback), RESPONSE_TIMEOUT);
-  local_response->set_response_reader(std::move(stub_->AsyncUpdateRecord(
-      local_response->get_context(), request, &queue_)));
+  if (!is_cached_record_current(request)) {
+    update_batcher_->Enqueue(request);
+  }
+  // The update is owned by the cache/batcher from here on; ack the
+  // caller so session setup never waits on directoryd
+  callback(Status::OK, Void());
+}
+
+bool AsyncDirectorydClient::is_cached_record_current(
+    const UpdateRecordRequest& request) {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  auto it = record_cache_.find(request.id());
+  if (it != record_cache_.end()) {
+    bool current = it->second.location() == request.location() &&
+                   it->second.fields().size() == request.fields().size();
+    if (current) {
+      for (const auto& field : request.fields()) {
+        auto cached = it->second.fields().find(field.first);
+        if (cached == it->second.fields().end() ||
+            cached->second != field.second) {
+          current = false;
+          break;
+        }
+      }
+    }
+    if (current) {
+      return true;
+    }
+    it->second = request;
+    return false;
+  }
+  if (record_cache_.size() >= RECORD_CACHE_MAX_ENTRIES) {
+    record_cache_.clear();
+  }
+  record_cache_[request.id()] = request;
+  return false;
+}
+
+void AsyncDirectorydClient::update_directoryd_records(
+    UpdateRecordsRequest batch) {
+  if (batch.records_size() == 0) {
+    return;
+  }
+  auto local_response = new AsyncLocalResponse<Void>(
+      [this, batch](Status status, Void) {
+        if (status.ok()) {
+          return;
+        }
+        MLOG(MERROR) << "Could not update batch of " << batch.records_size()
+                     << " directory records, Error Message: "
+                     << status.error_message()
+                     << ". Records parked for replay";
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        for (const auto& record : batch.records()) {
+          if (replay_records_.size() >= MAX_REPLAY_RECORDS &&
+              replay_records_.find(record.id()) == replay_records_.end()) {
+            MLOG(MWARNING) << "Directory replay backlog full, dropping "
+                           << "update for " << record.id();
+            continue;
+          }
+          replay_records_[record.id()] = record;
+          // Forget the cached state so the next update for this IMSI is
+          // pushed even if it matches what we failed to deliver
+          record_cache_.erase(record.id());
+        }
+      },
+      RESPONSE_TIMEOUT);
+  local_response->set_response_reader(std::move(stub_->AsyncUpdateRecords(
+      local_response->get_context(), batch, &queue_)));
 }
 
 void AsyncDirectorydClient::delete_directoryd_record(
     const DeleteRecordRequest& request,
     std::function<void(Status status, Void)> callback) {
+  {
+    // A deleted record must be re-pushed in full if the session returns
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    record_cache_.erase(request.id());
+    replay_records_.erase(request.id());
+  }
   auto local_response =
       new AsyncLocalResponse<Void>(std::move(callback), RESPONSE_TIMEOUT);
   local_response->set_response_reader(std::move(stub_->AsyncDeleteRecord(
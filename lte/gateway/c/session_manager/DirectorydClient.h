@@ -56,7 +56,10 @@ class DirectorydClient {
 
 /**
  * AsyncDirectorydClient sends asynchronous calls to DirectoryD to retrieve
- * UE information.
+ * UE information. Record updates go through a write-through cache: updates
+ * are acknowledged immediately, coalesced per IMSI within a tick, sent as
+ * one batched RPC and replayed if directoryd is temporarily unavailable,
+ * so directoryd never sits on the call-setup critical path.
  */
 class AsyncDirectorydClient : public GRPCReceiver, public DirectorydClient {
  public:
@@ -67,6 +70,10 @@ class AsyncDirectorydClient : public GRPCReceiver, public DirectorydClient {
   /**
    * Update the DirectoryD record
    * @param update_request - request used to update the record
+   *
+   * The callback is invoked with OK as soon as the update is accepted
+   * into the write-through cache; delivery to directoryd happens in the
+   * background with batching and replay on failure.
    */
   void update_directoryd_record(
       const UpdateRecordRequest& request,
@@ -88,6 +95,25 @@ class AsyncDirectorydClient : public GRPCReceiver, public DirectorydClient {
  private:
   static const uint32_t RESPONSE_TIMEOUT = 6;  // seconds
   std::unique_ptr<GatewayDirectoryService::Stub> stub_;
+
+  // Last state pushed per IMSI; identical re-pushes are suppressed
+  std::unordered_map<std::string, UpdateRecordRequest> record_cache_;
+  // Records from failed batches, merged into the next flush
+  std::unordered_map<std::string, UpdateRecordRequest> replay_records_;
+  std::mutex cache_mutex_;
+  std::unique_ptr<GRPCBatcher<UpdateRecordRequest>> update_batcher_;
+
+  /**
+   * Send one batched UpdateRecords RPC; failed batches are parked in
+   * replay_records_ and retried with the next flush
+   */
+  void update_directoryd_records(UpdateRecordsRequest batch);
+
+  /**
+   * @return true if the cached record for request.id already carries the
+   * requested location and fields
+   */
+  bool is_cached_record_current(const UpdateRecordRequest& request);
 };
 
 }  // namespace magma
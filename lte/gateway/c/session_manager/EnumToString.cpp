@@ -11,13 +11,10 @@
  * limitations under the License.
  */
 
-#include <sstream>
-#include <string>
-
 #include "EnumToString.h"
 
 namespace magma {
-std::string reauth_state_to_str(ReAuthState state) {
+const char* reauth_state_to_str(ReAuthState state) {
   switch (state) {
     case REAUTH_NOT_NEEDED:
       return "REAUTH_NOT_NEEDED";
@@ -30,7 +27,7 @@ std::string reauth_state_to_str(ReAuthState state) {
   }
 }
 
-std::string service_state_to_str(ServiceState state) {
+const char* service_state_to_str(ServiceState state) {
   switch (state) {
     case SERVICE_ENABLED:
       return "SERVICE_ENABLED";
@@ -51,7 +48,7 @@ std::string service_state_to_str(ServiceState state) {
   }
 }
 
-std::string final_action_to_str(ChargingCredit_FinalAction final_action) {
+const char* final_action_to_str(ChargingCredit_FinalAction final_action) {
   switch (final_action) {
     case ChargingCredit_FinalAction_TERMINATE:
       return "TERMINATE";
@@ -64,7 +61,7 @@ std::string final_action_to_str(ChargingCredit_FinalAction final_action) {
   }
 }
 
-std::string grant_type_to_str(GrantTrackingType grant_type) {
+const char* grant_type_to_str(GrantTrackingType grant_type) {
   switch (grant_type) {
     case TRACKING_UNSET:
       return "TRACKING_UNSET";
@@ -83,7 +80,7 @@ std::string grant_type_to_str(GrantTrackingType grant_type) {
   }
 }
 
-std::string session_fsm_state_to_str(SessionFsmState state) {
+const char* session_fsm_state_to_str(SessionFsmState state) {
   switch (state) {
     case SESSION_ACTIVE:
     case ACTIVE:
@@ -104,7 +101,7 @@ std::string session_fsm_state_to_str(SessionFsmState state) {
   }
 }
 
-std::string credit_update_type_to_str(CreditUsage::UpdateType update) {
+const char* credit_update_type_to_str(CreditUsage::UpdateType update) {
   switch (update) {
     case CreditUsage::THRESHOLD:
       return "THRESHOLD";
@@ -129,7 +126,7 @@ std::string credit_update_type_to_str(CreditUsage::UpdateType update) {
   }
 }
 
-std::string raa_result_to_str(ReAuthResult res) {
+const char* raa_result_to_str(ReAuthResult res) {
   switch (res) {
     case UPDATE_INITIATED:
       return "UPDATE_INITIATED";
@@ -144,7 +141,7 @@ std::string raa_result_to_str(ReAuthResult res) {
   }
 }
 
-std::string asr_result_to_str(AbortSessionResult_Code res) {
+const char* asr_result_to_str(AbortSessionResult_Code res) {
   switch (res) {
     case AbortSessionResult_Code_SESSION_REMOVED:
       return "SESSION_REMOVED";
@@ -161,7 +158,7 @@ std::string asr_result_to_str(AbortSessionResult_Code res) {
   }
 }
 
-std::string wallet_state_to_str(SubscriberQuotaUpdate_Type state) {
+const char* wallet_state_to_str(SubscriberQuotaUpdate_Type state) {
   switch (state) {
     case SubscriberQuotaUpdate_Type_VALID_QUOTA:
       return "VALID_QUOTA";
@@ -174,7 +171,7 @@ std::string wallet_state_to_str(SubscriberQuotaUpdate_Type state) {
   }
 }
 
-std::string service_action_type_to_str(ServiceActionType action) {
+const char* service_action_type_to_str(ServiceActionType action) {
   switch (action) {
     case CONTINUE_SERVICE:
       return "CONTINUE_SERVICE";
@@ -191,7 +188,7 @@ std::string service_action_type_to_str(ServiceActionType action) {
   }
 }
 
-std::string credit_validity_to_str(CreditValidity validity) {
+const char* credit_validity_to_str(CreditValidity validity) {
   switch (validity) {
     case VALID_CREDIT:
       return "VALID_CREDIT";
@@ -204,7 +201,7 @@ std::string credit_validity_to_str(CreditValidity validity) {
   }
 }
 
-std::string event_trigger_to_str(EventTrigger event_trigger) {
+const char* event_trigger_to_str(EventTrigger event_trigger) {
   switch (event_trigger) {
     case USAGE_REPORT:
       return "USAGE_REPORT";
@@ -217,7 +214,7 @@ std::string event_trigger_to_str(EventTrigger event_trigger) {
   }
 }
 
-std::string request_origin_type_to_str(
+const char* request_origin_type_to_str(
     RequestOriginType_OriginType request_type) {
   switch (request_type) {
     case RequestOriginType_OriginType_GX:
@@ -15,35 +15,35 @@
 #include <lte/protos/abort_session.pb.h>
 #include <lte/protos/session_manager.pb.h>
 
-#include <string>
-
 #include "ChargingGrant.h"
 #include "ServiceAction.h"
 #include "StoredState.h"
 
 namespace magma {
-std::string reauth_state_to_str(ReAuthState state);
+/* Enum-to-name helpers return pointers to string literals so log lines and
+ * event payloads do not allocate per call */
+const char* reauth_state_to_str(ReAuthState state);
 
-std::string service_state_to_str(ServiceState state);
+const char* service_state_to_str(ServiceState state);
 
-std::string final_action_to_str(ChargingCredit_FinalAction final_action);
+const char* final_action_to_str(ChargingCredit_FinalAction final_action);
 
-std::string grant_type_to_str(GrantTrackingType grant_type);
+const char* grant_type_to_str(GrantTrackingType grant_type);
 
-std::string session_fsm_state_to_str(SessionFsmState state);
+const char* session_fsm_state_to_str(SessionFsmState state);
 
-std::string credit_update_type_to_str(CreditUsage::UpdateType update);
+const char* credit_update_type_to_str(CreditUsage::UpdateType update);
 
-std::string raa_result_to_str(ReAuthResult res);
+const char* raa_result_to_str(ReAuthResult res);
 
-std::string asr_result_to_str(AbortSessionResult_Code res);
+const char* asr_result_to_str(AbortSessionResult_Code res);
 
-std::string wallet_state_to_str(SubscriberQuotaUpdate_Type state);
+const char* wallet_state_to_str(SubscriberQuotaUpdate_Type state);
 
-std::string service_action_type_to_str(ServiceActionType action);
+const char* service_action_type_to_str(ServiceActionType action);
 
-std::string event_trigger_to_str(EventTrigger event_trigger);
+const char* event_trigger_to_str(EventTrigger event_trigger);
 
-std::string request_origin_type_to_str(
+const char* request_origin_type_to_str(
     RequestOriginType_OriginType request_type);
 }  // namespace magma
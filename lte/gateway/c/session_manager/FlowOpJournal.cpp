@@ -0,0 +1,183 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "FlowOpJournal.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "magma_logging.h"
+
+namespace {
+constexpr uint64_t JOURNAL_MAGIC   = 0x4c4e524a504f4c46;  // "FLOPJRNL"
+constexpr uint64_t JOURNAL_VERSION = 1;
+// Whole record including its header; requests larger than the payload
+// that remains are not replayable and are skipped at record time
+constexpr size_t RECORD_SIZE = 2048;
+}  // namespace
+
+namespace magma {
+namespace lte {
+
+struct FlowOpJournal::Record {
+  uint64_t seq;  // 0 while the slot is empty or mid-write
+  uint32_t type;
+  uint32_t acked;
+  uint32_t len;
+  uint32_t reserved;
+  char payload[RECORD_SIZE - 24];
+} __attribute__((packed));
+
+std::unique_ptr<FlowOpJournal> FlowOpJournal::open(
+    const std::string& path, uint64_t record_capacity) {
+  size_t file_size = sizeof(Header) + record_capacity * sizeof(Record);
+
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0600);
+  if (fd < 0) {
+    MLOG(MERROR) << "Could not open flow op journal " << path;
+    return nullptr;
+  }
+  if (ftruncate(fd, file_size) != 0) {
+    MLOG(MERROR) << "Could not size flow op journal " << path;
+    close(fd);
+    return nullptr;
+  }
+  void* base =
+      mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED) {
+    MLOG(MERROR) << "Could not map flow op journal " << path;
+    close(fd);
+    return nullptr;
+  }
+
+  auto journal = std::unique_ptr<FlowOpJournal>(
+      new FlowOpJournal(fd, base, record_capacity));
+
+  Header* header = reinterpret_cast<Header*>(base);
+  if (header->magic != JOURNAL_MAGIC || header->capacity != record_capacity) {
+    // Fresh file, or the capacity changed: start over
+    memset(base, 0, file_size);
+    header->magic    = JOURNAL_MAGIC;
+    header->version  = JOURNAL_VERSION;
+    header->capacity = record_capacity;
+    header->next_seq = 1;
+    return journal;
+  }
+
+  // Recover the write position from the records themselves, like the
+  // usage journal does: a crash can leave the header one behind
+  uint64_t max_seq = 0;
+  for (uint64_t i = 0; i < record_capacity; i++) {
+    uint64_t seq = journal->slot_for(i + 1)->seq;
+    if (seq > max_seq) {
+      max_seq = seq;
+    }
+  }
+  if (max_seq + 1 > header->next_seq) {
+    header->next_seq = max_seq + 1;
+  }
+  MLOG(MINFO) << "Flow op journal " << path << " resuming at sequence "
+              << header->next_seq;
+  return journal;
+}
+
+FlowOpJournal::FlowOpJournal(int fd, void* base, uint64_t record_capacity)
+    : fd_(fd), base_(base), capacity_(record_capacity) {}
+
+FlowOpJournal::~FlowOpJournal() {
+  size_t file_size = sizeof(Header) + capacity_ * sizeof(Record);
+  msync(base_, file_size, MS_SYNC);
+  munmap(base_, file_size);
+  close(fd_);
+}
+
+FlowOpJournal::Record* FlowOpJournal::slot_for(uint64_t seq) const {
+  auto* records =
+      reinterpret_cast<Record*>(static_cast<char*>(base_) + sizeof(Header));
+  return &records[(seq - 1) % capacity_];
+}
+
+uint64_t FlowOpJournal::record(
+    OpType type, const std::string& serialized_request) {
+  if (serialized_request.size() > sizeof(Record::payload)) {
+    MLOG(MWARNING) << "Flow op of " << serialized_request.size()
+                   << " bytes does not fit a journal record, not replayable";
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(journal_lock_);
+  Header* header = reinterpret_cast<Header*>(base_);
+  uint64_t seq   = header->next_seq;
+
+  Record* record = slot_for(seq);
+  // Invalidate the slot first so a reader never sees the old sequence
+  // paired with the new payload
+  __atomic_store_n(&record->seq, 0, __ATOMIC_RELEASE);
+  record->type  = type;
+  record->acked = 0;
+  record->len   = serialized_request.size();
+  memcpy(record->payload, serialized_request.data(),
+         serialized_request.size());
+  // The stamp publishes the record; everything above lands before it
+  __atomic_store_n(&record->seq, seq, __ATOMIC_RELEASE);
+
+  header->next_seq = seq + 1;
+  return seq;
+}
+
+void FlowOpJournal::ack(uint64_t seq) {
+  if (seq == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(journal_lock_);
+  Record* record = slot_for(seq);
+  if (__atomic_load_n(&record->seq, __ATOMIC_ACQUIRE) == seq) {
+    record->acked = 1;
+  }
+}
+
+std::vector<FlowOpJournal::FlowOp> FlowOpJournal::unacked() const {
+  // Collected under the lock and returned by value so callers can re-send
+  // (and thereby re-record) the operations without re-entering the journal
+  std::vector<FlowOp> ops;
+  std::lock_guard<std::mutex> lock(journal_lock_);
+
+  uint64_t next  = reinterpret_cast<Header*>(base_)->next_seq;
+  uint64_t start = 1;
+  if (next > capacity_ + 1) {
+    start = next - capacity_;
+  }
+  for (uint64_t seq = start; seq < next; seq++) {
+    const Record* record = slot_for(seq);
+    if (__atomic_load_n(&record->seq, __ATOMIC_ACQUIRE) != seq) {
+      continue;  // torn by a crash, or overwritten
+    }
+    if (record->acked || record->len == 0) {
+      continue;
+    }
+    FlowOp op;
+    op.type    = record->type;
+    op.payload = std::string(record->payload, record->len);
+    ops.push_back(std::move(op));
+  }
+  return ops;
+}
+
+uint64_t FlowOpJournal::next_seq() const {
+  std::lock_guard<std::mutex> lock(journal_lock_);
+  return reinterpret_cast<Header*>(base_)->next_seq;
+}
+
+}  // namespace lte
+}  // namespace magma
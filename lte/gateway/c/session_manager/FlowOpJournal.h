@@ -0,0 +1,107 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace magma {
+namespace lte {
+
+/**
+ * Sequence-numbered ring journal of flow operations sent to PipelineD,
+ * backed by an mmap'd file like the usage journal.
+ *
+ * Every activate/deactivate request is recorded before it goes on the
+ * wire and marked acknowledged when its response arrives. After a
+ * PipelineD outage the unacknowledged suffix is exactly the set of
+ * operations the dataplane may have missed, so reconciliation can replay
+ * those instead of re-installing every session. Records survive a
+ * sessiond crash through the shared mapping; a half-written record is
+ * detectable through its sequence stamp and skipped.
+ */
+class FlowOpJournal {
+ public:
+  enum OpType : uint32_t {
+    ACTIVATE   = 1,
+    DEACTIVATE = 2,
+  };
+
+  // One journaled operation handed back by unacked()
+  struct FlowOp {
+    uint32_t type;  // OpType
+    std::string payload;  // serialized request proto
+  };
+
+  /**
+   * Map the ring file at `path`, creating and sizing it on first use.
+   * Re-opening an existing file recovers the write position from the
+   * stored records. Returns nullptr when the file cannot be mapped.
+   */
+  static std::unique_ptr<FlowOpJournal> open(
+      const std::string& path, uint64_t record_capacity);
+
+  ~FlowOpJournal();
+
+  FlowOpJournal(const FlowOpJournal&) = delete;
+  FlowOpJournal& operator=(const FlowOpJournal&) = delete;
+
+  /**
+   * Record one operation about to be sent; never blocks on disk.
+   * @return the sequence assigned, or 0 when the serialized request does
+   * not fit a slot (the op is then simply not replayable)
+   */
+  uint64_t record(OpType type, const std::string& serialized_request);
+
+  /**
+   * Mark the operation as acknowledged by PipelineD. Acknowledged
+   * operations are excluded from replay.
+   */
+  void ack(uint64_t seq);
+
+  /**
+   * @return every recorded, unacknowledged operation still in the ring,
+   * oldest first. Torn or overwritten records are skipped.
+   */
+  std::vector<FlowOp> unacked() const;
+
+  // Sequence the next record will be stamped with
+  uint64_t next_seq() const;
+
+  uint64_t capacity() const { return capacity_; }
+
+ private:
+  struct Header {
+    uint64_t magic;
+    uint64_t version;
+    uint64_t capacity;
+    uint64_t next_seq;
+  };
+
+  struct Record;
+
+  FlowOpJournal(int fd, void* base, uint64_t record_capacity);
+
+  Record* slot_for(uint64_t seq) const;
+
+  int fd_;
+  void* base_;
+  uint64_t capacity_;
+  mutable std::mutex journal_lock_;
+};
+
+}  // namespace lte
+}  // namespace magma
@@ -16,6 +16,7 @@
 #include <google/protobuf/message.h>     // for Message
 #include <stdlib.h>                      // for getenv, NULL
 
+#include <atomic>   // for atomic
 #include <sstream>  // for operator<<, basic_ostream
 #include <string>   // for string, operator<<, operator==
 
@@ -24,20 +25,20 @@
 
 #define MAGMA_PRINT_GRPC_PAYLOAD "MAGMA_PRINT_GRPC_PAYLOAD"
 
-bool grpcLoggingEnabled = false;
+std::atomic<bool> grpc_logging_enabled(false);
 
 // set_grpc_logging_level will only change the level in case
 // MAGMA_PRINT_GRPC_PAYLOAD envar is not set
 void set_grpc_logging_level(bool enable) {
   std::string val = get_env_var(MAGMA_PRINT_GRPC_PAYLOAD);
   if (val == "") {
-    grpcLoggingEnabled = enable;
+    grpc_logging_enabled.store(enable);
   } else if (val == "1") {
-    grpcLoggingEnabled = true;
+    grpc_logging_enabled.store(true);
   } else {
-    grpcLoggingEnabled = false;
+    grpc_logging_enabled.store(false);
   }
-  MLOG(MINFO) << "print_grpc_payload set at: " << grpcLoggingEnabled;
+  MLOG(MINFO) << "print_grpc_payload set at: " << grpc_logging_enabled.load();
 }
 
 std::string get_env_var(std::string const& key) {
@@ -51,14 +52,12 @@ std::string get_env_var(std::string const& key) {
   return std::string(retval);
 }
 
-void PrintGrpcMessage(const google::protobuf::Message& msg) {
-  if (grpcLoggingEnabled) {
-    // Lazy log strategy
-    const google::protobuf::Descriptor* desc = msg.GetDescriptor();
-    MLOG(MINFO) << "\n"
-                << "  " << desc->full_name().c_str() << " {\n"
-                << indentText(msg.DebugString(), 6) << "  }";
-  }
+void PrintGrpcMessageInternal(const google::protobuf::Message& msg) {
+  // The enabled check already happened inline at the call site
+  const google::protobuf::Descriptor* desc = msg.GetDescriptor();
+  MLOG(MINFO) << "\n"
+              << "  " << desc->full_name().c_str() << " {\n"
+              << indentText(msg.DebugString(), 6) << "  }";
 }
 
 std::string indentText(std::string basicString, int indent) {
@@ -12,6 +12,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <string>  // for string
 
 namespace google {
@@ -24,6 +25,23 @@ void set_grpc_logging_level(bool enable);
 
 std::string get_env_var(std::string const& key);
 
-void PrintGrpcMessage(const google::protobuf::Message& message);
+// Cached verbosity flag, written once at startup and on config refresh;
+// print sites read it with a relaxed load
+extern std::atomic<bool> grpc_logging_enabled;
+
+// Out-of-line slow path: formats and logs the message unconditionally
+void PrintGrpcMessageInternal(const google::protobuf::Message& message);
+
+/**
+ * Log the message when gRPC payload printing is enabled. Inline so the
+ * disabled case costs the call site a single predictable branch on the
+ * cached atomic; the DebugString machinery is only reached when printing
+ * is on.
+ */
+inline void PrintGrpcMessage(const google::protobuf::Message& message) {
+  if (grpc_logging_enabled.load(std::memory_order_relaxed)) {
+    PrintGrpcMessageInternal(message);
+  }
+}
 
 std::string indentText(std::string basicString, int indent);
@@ -18,6 +18,7 @@
 #include <lte/protos/session_manager.pb.h>
 #include <time.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -28,16 +29,30 @@
 #include "EnumToString.h"
 #include "LocalEnforcer.h"
 #include "magma_logging.h"
+#include "magma_sdt.h"
+#include "includes/MetricsHelpers.h"
 #include "includes/ServiceRegistrySingleton.h"
 #include "Utilities.h"
 #include "GrpcMagmaUtils.h"
 
 namespace magma {
-bool LocalEnforcer::SEND_ACCESS_TIMEZONE   = false;
-bool LocalEnforcer::CLEANUP_DANGLING_FLOWS = true;
-bool LocalEnforcer::SEND_IPFIX             = true;
+bool LocalEnforcer::SEND_ACCESS_TIMEZONE            = false;
+bool LocalEnforcer::CLEANUP_DANGLING_FLOWS          = true;
+bool LocalEnforcer::SEND_IPFIX                      = true;
+uint32_t LocalEnforcer::SETUP_BATCH_SIZE            = 0;
+uint32_t LocalEnforcer::SETUP_MAX_IN_FLIGHT         = 4;
+uint32_t LocalEnforcer::BEARER_RULE_BATCH_WINDOW_MS = 15;
+
+// Every Nth stats poll requests the full rule record table instead of just
+// the changed records, so a delta lost between polls is repaired quickly
+static const uint32_t STATS_FULL_POLL_EVERY = 10;
+// Interval adjustments applied by get_stats_poll_interval around the
+// configured poll_stats_interval
+static const uint32_t STATS_POLL_TIGHTEN_DIVISOR  = 4;
+static const uint32_t STATS_POLL_RELAX_MULTIPLIER = 4;
 
 using google::protobuf::RepeatedPtrField;
+using magma::service303::set_gauge;
 
 using namespace std::placeholders;
 
@@ -86,6 +101,12 @@ void LocalEnforcer::start() {
 
 void LocalEnforcer::attachEventBase(folly::EventBase* evb) {
   evb_ = evb;
+  timer_wheel_.attach(evb);
+  task_queue_.attach(evb);
+}
+
+void LocalEnforcer::post_task(std::function<void()> task) {
+  task_queue_.post(std::move(task));
 }
 
 void LocalEnforcer::stop() {
@@ -143,8 +164,84 @@ void LocalEnforcer::setup(
     pipelined_client_->setup_cwf(
         session_infos, quota_updates, ue_mac_addrs, msisdns, apn_mac_addrs,
         apn_names, pdp_start_times, epoch, callback);
-  } else {
+  } else if (SETUP_BATCH_SIZE == 0 || session_infos.size() <= SETUP_BATCH_SIZE) {
     pipelined_client_->setup_lte(session_infos, epoch, callback);
+  } else {
+    setup_lte_in_batches(std::move(session_infos), epoch, callback);
+  }
+}
+
+void LocalEnforcer::replay_journaled_flow_ops() {
+  pipelined_client_->replay_unacked_flow_ops();
+}
+
+void LocalEnforcer::setup_lte_in_batches(
+    std::vector<SessionState::SessionInfo> session_infos,
+    const std::uint64_t epoch,
+    std::function<void(Status status, SetupFlowsResult)> callback) {
+  auto state   = std::make_shared<SetupBatchState>();
+  state->total = session_infos.size();
+  for (size_t offset = 0; offset < session_infos.size();
+       offset += SETUP_BATCH_SIZE) {
+    const size_t end =
+        std::min(offset + SETUP_BATCH_SIZE, session_infos.size());
+    state->batches.emplace_back(
+        std::make_move_iterator(session_infos.begin() + offset),
+        std::make_move_iterator(session_infos.begin() + end));
+  }
+  MLOG(MINFO) << "Restoring " << state->total << " sessions in PipelineD with "
+              << state->batches.size() << " setup batches of up to "
+              << SETUP_BATCH_SIZE << " sessions, at most "
+              << SETUP_MAX_IN_FLIGHT << " in flight";
+  set_gauge("restored_sessions", 0, size_t(0));
+  launch_next_setup_batches(state, epoch, callback);
+}
+
+void LocalEnforcer::launch_next_setup_batches(
+    std::shared_ptr<SetupBatchState> state, const std::uint64_t epoch,
+    std::function<void(Status status, SetupFlowsResult)> callback) {
+  while (state->in_flight < SETUP_MAX_IN_FLIGHT &&
+         state->next_batch < state->batches.size()) {
+    auto batch = std::move(state->batches[state->next_batch]);
+    state->next_batch++;
+    state->in_flight++;
+    const size_t batch_size = batch.size();
+    pipelined_client_->setup_lte(
+        batch, epoch,
+        [this, state, epoch, callback, batch_size](
+            Status status, SetupFlowsResult resp) {
+          // Aggregate on the event base thread since the batch state is
+          // shared across callbacks
+          task_queue_.post([=] {
+            state->in_flight--;
+            if (!status.ok() || resp.result() != SetupFlowsResult::SUCCESS) {
+              if (!state->failed) {
+                state->failed        = true;
+                state->failed_status = status;
+                state->failed_result = resp;
+              }
+            } else {
+              state->restored += batch_size;
+              set_gauge("restored_sessions", state->restored, size_t(0));
+            }
+            const bool more_batches =
+                state->next_batch < state->batches.size();
+            if (!state->failed && more_batches) {
+              launch_next_setup_batches(state, epoch, callback);
+            } else if (state->in_flight == 0) {
+              if (state->failed) {
+                callback(state->failed_status, state->failed_result);
+                return;
+              }
+              MLOG(MINFO) << "Successfully restored " << state->restored
+                          << " sessions in PipelineD across "
+                          << state->batches.size() << " setup batches";
+              SetupFlowsResult result;
+              result.set_result(SetupFlowsResult::SUCCESS);
+              callback(Status::OK, result);
+            }
+          });
+        });
   }
 }
 
@@ -212,9 +309,10 @@ void LocalEnforcer::handle_session_update_response(
 
 void LocalEnforcer::check_usage_for_reporting(
     SessionMap& session_map, SessionUpdate& session_uc) {
-  std::vector<std::unique_ptr<ServiceAction>> actions;
-  auto request = collect_updates(session_map, actions, session_uc);
-  execute_actions(session_map, actions, session_uc);
+  service_action_batch_.clear();
+  auto request =
+      collect_updates(session_map, service_action_batch_, session_uc);
+  execute_actions(session_map, service_action_batch_, session_uc);
   if (request.updates_size() == 0 && request.usage_monitors_size() == 0) {
     auto update_success = session_store_.update_sessions(session_uc);
     if (update_success) {
@@ -259,16 +357,51 @@ void LocalEnforcer::handle_pipelined_response(
     aggregate_records(session_map, resp, update);
 
     check_usage_for_reporting(session_map, update);
+
+    // Remember what this poll looked like so the stats poller can size its
+    // next sleep: how many records actually moved, and whether any session
+    // is close enough to its quota to warrant tighter polling
+    last_poll_record_count_ = resp.records_size();
+    session_near_quota_ = has_session_near_quota(session_map);
   }
 }
 
+bool LocalEnforcer::has_session_near_quota(SessionMap& session_map) const {
+  for (auto& session_pair : session_map) {
+    for (auto& session : session_pair.second) {
+      if (session->is_credit_near_exhaustion(
+              SessionCredit::USAGE_REPORTING_THRESHOLD)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+uint32_t LocalEnforcer::get_stats_poll_interval(
+    uint32_t configured_interval_s) const {
+  if (session_near_quota_.load()) {
+    uint32_t tightened = configured_interval_s / STATS_POLL_TIGHTEN_DIVISOR;
+    return std::max(tightened, 1u);
+  }
+  if (last_poll_record_count_.load() == 0) {
+    return configured_interval_s * STATS_POLL_RELAX_MULTIPLIER;
+  }
+  return configured_interval_s;
+}
+
 void LocalEnforcer::poll_stats_enforcer(int cookie, int cookie_mask) {
+  // Most polls only ask PipelineD for records whose counters moved since
+  // the previous poll. Every STATS_FULL_POLL_EVERY polls the full table is
+  // requested anyway so a missed delta cannot go unnoticed for long.
+  const bool changed_only =
+      (stats_poll_count_++ % STATS_FULL_POLL_EVERY) != 0;
   // we need to pass in a function pointer. Binding is required because
   // the function is part of the LocalEnforcer class and has arguments
   // so we bind to the object and the two arguments the function needs
   // which are the status and RuleRecordTable response
   pipelined_client_->poll_stats(
-      cookie, cookie_mask,
+      cookie, cookie_mask, changed_only,
       std::bind(&LocalEnforcer::handle_pipelined_response, this, _1, _2));
 }
 
@@ -449,19 +582,26 @@ void LocalEnforcer::complete_termination_for_released_sessions(
 }
 
 void LocalEnforcer::execute_actions(
-    SessionMap& session_map,
-    const std::vector<std::unique_ptr<ServiceAction>>& actions,
+    SessionMap& session_map, const ServiceActionBatch& actions,
     SessionUpdate& session_update) {
-  for (const auto& action_p : actions) {
-    auto imsi       = action_p->get_imsi();
-    auto session_id = action_p->get_session_id();
-    switch (action_p->get_type()) {
+  // Gy final unit actions of one session are merged into a single
+  // bearer-batched activate call, so a quota-exhaustion wave costs one
+  // pipelined request per session rather than one per rating group
+  std::unordered_map<std::string, const ServiceAction*> fua_by_session;
+  std::unordered_map<std::string, RulesToProcess> fua_rules_by_session;
+  for (const ServiceAction& action : actions) {
+    auto imsi       = action.get_imsi();
+    auto session_id = action.get_session_id();
+    switch (action.get_type()) {
       case ACTIVATE_SERVICE:
-        handle_activate_service_action(action_p);
+        handle_activate_service_action(action);
         break;
       case REDIRECT:
       case RESTRICT_ACCESS: {
-        install_final_unit_action_flows(action_p);
+        const RulesToProcess to_install = action.get_gy_rules_to_install();
+        RulesToProcess& batched         = fua_rules_by_session[session_id];
+        batched.insert(batched.end(), to_install.begin(), to_install.end());
+        fua_by_session.emplace(session_id, &action);
         break;
       }
       case TERMINATE_SERVICE: {
@@ -477,18 +617,22 @@ void LocalEnforcer::execute_actions(
         break;
     }
   }
+  for (const auto& session_pair : fua_by_session) {
+    install_final_unit_action_flows(
+        *session_pair.second, fua_rules_by_session[session_pair.first]);
+  }
 }
 
 // TODO look into whether we need to re-install all Gx rules on activation
 void LocalEnforcer::handle_activate_service_action(
-    const std::unique_ptr<ServiceAction>& action_p) {
-  const std::string imsi      = action_p->get_imsi(),
-                    msisdn    = action_p->get_msisdn(),
-                    ip_addr   = action_p->get_ip_addr(),
-                    ipv6_addr = action_p->get_ipv6_addr();
-  const Teids teids           = action_p->get_teids();
-  const auto ambr             = action_p->get_ambr();
-  RulesToProcess to_process   = action_p->get_gx_rules_to_install();
+    const ServiceAction& action) {
+  const std::string imsi      = action.get_imsi(),
+                    msisdn    = action.get_msisdn(),
+                    ip_addr   = action.get_ip_addr(),
+                    ipv6_addr = action.get_ipv6_addr();
+  const Teids teids           = action.get_teids();
+  const auto ambr             = action.get_ambr();
+  RulesToProcess to_process   = action.get_gx_rules_to_install();
   pipelined_client_->activate_flows_for_rules(
       imsi, ip_addr, ipv6_addr, teids, msisdn, ambr, to_process,
       std::bind(
@@ -534,7 +678,7 @@ void LocalEnforcer::start_session_termination(
   // terminate the session.
   MLOG(MDEBUG) << "Scheduling a force termination timeout for " << session_id
                << " in " << session_force_termination_timeout_ms_ << "ms";
-  evb_->runAfterDelay(
+  timer_wheel_.schedule(
       [this, imsi, session_id] {
         handle_force_termination_timeout(imsi, session_id);
       },
@@ -625,26 +769,24 @@ void LocalEnforcer::handle_subscriber_quota_state_change(
 }
 
 void LocalEnforcer::install_final_unit_action_flows(
-    const std::unique_ptr<ServiceAction>& action_p) {
-  const std::string imsi       = action_p->get_imsi(),
-                    msisdn     = action_p->get_msisdn(),
-                    ip_addr    = action_p->get_ip_addr(),
-                    ipv6_addr  = action_p->get_ipv6_addr(),
-                    session_id = action_p->get_session_id();
-  const Teids teids            = action_p->get_teids();
-  const auto fua_type          = action_p->get_type();
+    const ServiceAction& action, const RulesToProcess& to_process) {
+  const std::string imsi       = action.get_imsi(),
+                    msisdn     = action.get_msisdn(),
+                    ip_addr    = action.get_ip_addr(),
+                    ipv6_addr  = action.get_ipv6_addr(),
+                    session_id = action.get_session_id();
+  const Teids teids            = action.get_teids();
+  const auto fua_type          = action.get_type();
 
   MLOG(MINFO) << "Installing final unit action "
               << service_action_type_to_str(fua_type) << " flows for "
               << session_id;
-  RulesToProcess to_process = action_p->get_gy_rules_to_install();
   pipelined_client_->add_gy_final_action_flow(
       imsi, ip_addr, ipv6_addr, teids, msisdn, to_process);
 }
 
 UpdateSessionRequest LocalEnforcer::collect_updates(
-    SessionMap& session_map,
-    std::vector<std::unique_ptr<ServiceAction>>& actions,
+    SessionMap& session_map, ServiceActionBatch& actions,
     SessionUpdate& session_update) const {
   UpdateSessionRequest request;
   for (const auto& session_pair : session_map) {
@@ -738,7 +880,7 @@ void LocalEnforcer::schedule_static_rule_activation(
   MLOG(MDEBUG) << "Scheduling " << session_id << " static rule " << rule_id
                << " activation in " << (delta.count() / 1000) << " secs";
 
-  evb_->runAfterDelay(
+  timer_wheel_.schedule(
       [=] {
         auto session_map = session_store_.read_sessions(SessionRead{imsi});
         auto session_update =
@@ -796,7 +938,7 @@ void LocalEnforcer::schedule_dynamic_rule_activation(
   auto delta = magma::time_difference_from_now(activation_time);
   MLOG(MDEBUG) << "Scheduling " << session_id << " dynamic rule " << rule_id
                << " activation in " << (delta.count() / 1000) << " secs";
-  evb_->runAfterDelay(
+  timer_wheel_.schedule(
       [=] {
         auto session_map = session_store_.read_sessions(SessionRead{imsi});
         auto session_update =
@@ -856,7 +998,7 @@ void LocalEnforcer::schedule_static_rule_deactivation(
   auto delta = magma::time_difference_from_now(deactivation_time);
   MLOG(MDEBUG) << "Scheduling " << session_id << " static rule " << rule_id
                << " deactivation in " << (delta.count() / 1000) << " secs";
-  evb_->runAfterDelay(
+  timer_wheel_.schedule(
       [=] {
         auto session_map = session_store_.read_sessions(SessionRead{imsi});
         auto session_update =
@@ -907,7 +1049,7 @@ void LocalEnforcer::schedule_dynamic_rule_deactivation(
   auto delta = magma::time_difference_from_now(deactivation_time);
   MLOG(MDEBUG) << "Scheduling " << session_id << " dynamic rule " << rule_id
                << " deactivation in " << (delta.count() / 1000) << " secs";
-  evb_->runAfterDelay(
+  timer_wheel_.schedule(
       [=] {
         auto session_map = session_store_.read_sessions(SessionRead{imsi});
         auto session_update =
@@ -1076,7 +1218,7 @@ bool LocalEnforcer::update_tunnel_ids(
 
       // schedule the removal of rules to avoid problems with install-unistall
       // order
-      evb_->runAfterDelay(
+      timer_wheel_.schedule(
           [this, imsi, session_id, credit] {
             auto session_map = session_store_.read_sessions({imsi});
             SessionSearchCriteria criteria(
@@ -1153,7 +1295,7 @@ void LocalEnforcer::handle_session_activate_subscriber_quota_state(
 
 void LocalEnforcer::schedule_termination(
     std::unordered_set<ImsiAndSessionID>& sessions) {
-  evb_->runAfterDelay(
+  timer_wheel_.schedule(
       [this, sessions] {
         SessionRead req;
         for (auto& imsi_and_session_id : sessions) {
@@ -1723,6 +1865,9 @@ void LocalEnforcer::propagate_rule_updates_to_pipelined(
     const SessionConfig& config, const RulesToProcess& pending_activation,
     const RulesToProcess& pending_deactivation, bool always_send_activate) {
   const std::string& imsi = config.get_imsi();
+  MAGMA_USDT3(
+      enforcer_rule_activation, magma_sdt_imsi_hash(imsi.c_str()),
+      pending_activation.size(), pending_deactivation.size());
   const auto ip_addr      = config.common_context.ue_ipv4();
   const auto ipv6_addr    = config.common_context.ue_ipv6();
   const Teids teids       = config.common_context.teids();
@@ -1836,7 +1981,7 @@ void LocalEnforcer::schedule_revalidation(
   auto delta = magma::time_difference_from_now(revalidation_time);
   MLOG(MINFO) << "Scheduling revalidation in " << delta.count() << "ms for "
               << session_id;
-  evb_->runAfterDelay(
+  timer_wheel_.schedule(
       [=] {
         MLOG(MINFO) << "Revalidation timeout! for " << session_id;
         auto session_map = session_store_.read_sessions(req);
@@ -1881,7 +2026,7 @@ void LocalEnforcer::handle_activate_ue_flows_callback(
   const std::string session_id = session->get_session_id();
 
   // start_session_termination
-  evb_->runInEventBaseThread([this, imsi, session_id] {
+  task_queue_.post([this, imsi, session_id] {
     auto session_map = session_store_.read_sessions({imsi});
     auto update      = SessionStore::get_default_session_update(session_map);
     bool success =
@@ -1910,7 +2055,7 @@ void LocalEnforcer::handle_add_ue_mac_flow_callback(
     MLOG(MWARNING) << "Pipelined add ue mac flow failed, retrying...";
   }
 
-  evb_->runAfterDelay(
+  timer_wheel_.schedule(
       [=] {
         MLOG(MERROR) << "Could not activate ue mac flows for subscriber "
                      << sid.id() << ": " << status.error_message()
@@ -2058,12 +2203,47 @@ void LocalEnforcer::install_rule_after_bearer_creation(
                    << session.get_session_id();
     return;
   }
-  MLOG(MINFO) << "Installing " << request.policy_rule_id()
-              << " into PipelineD for " << session.get_session_id()
-              << " after allocating a dedicated bearer";
-  RulesToProcess pending_activation{session.make_rule_to_process(*op_rule)};
+  if (BEARER_RULE_BATCH_WINDOW_MS == 0) {
+    MLOG(MINFO) << "Installing " << request.policy_rule_id()
+                << " into PipelineD for " << session.get_session_id()
+                << " after allocating a dedicated bearer";
+    RulesToProcess pending_activation{session.make_rule_to_process(*op_rule)};
+    propagate_rule_updates_to_pipelined(
+        session.get_config(), pending_activation, {}, false);
+    return;
+  }
+  // VoLTE setup binds several rules to the same bearer in quick succession,
+  // one BindPolicy2Bearer call each. Queue the install and let the flush
+  // send all of them in a single activate_flows request.
+  const std::string key =
+      session.get_session_id() + "-" + std::to_string(request.bearer_id());
+  auto it = pending_bearer_installs_.find(key);
+  if (it == pending_bearer_installs_.end()) {
+    PendingBearerInstall pending;
+    pending.config = session.get_config();
+    pending.pending_activation.push_back(
+        session.make_rule_to_process(*op_rule));
+    pending_bearer_installs_[key] = pending;
+    evb_->runAfterDelay(
+        [this, key] { flush_pending_bearer_installs(key); },
+        BEARER_RULE_BATCH_WINDOW_MS);
+  } else {
+    it->second.pending_activation.push_back(
+        session.make_rule_to_process(*op_rule));
+  }
+}
+
+void LocalEnforcer::flush_pending_bearer_installs(const std::string& key) {
+  auto it = pending_bearer_installs_.find(key);
+  if (it == pending_bearer_installs_.end()) {
+    return;
+  }
+  MLOG(MINFO) << "Installing " << it->second.pending_activation.size()
+              << " rule(s) into PipelineD for bearer " << key
+              << " in one batch after allocating a dedicated bearer";
   propagate_rule_updates_to_pipelined(
-      session.get_config(), pending_activation, {}, false);
+      it->second.config, it->second.pending_activation, {}, false);
+  pending_bearer_installs_.erase(it);
 }
 
 void LocalEnforcer::remove_rule_due_to_bearer_creation_failure(
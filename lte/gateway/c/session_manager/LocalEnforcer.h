@@ -18,6 +18,7 @@
 #include <lte/protos/policydb.pb.h>
 #include <lte/protos/session_manager.grpc.pb.h>
 
+#include <atomic>
 #include <iomanip>
 #include <memory>
 #include <string>
@@ -34,7 +35,9 @@
 #include "SessionReporter.h"
 #include "SessionState.h"
 #include "SessionStore.h"
+#include "MpscTaskQueue.h"
 #include "SpgwServiceClient.h"
+#include "TimerWheel.h"
 
 namespace magma {
 using std::experimental::optional;
@@ -131,6 +134,13 @@ class LocalEnforcer {
 
   folly::EventBase& get_event_base();
 
+  /**
+   * Run a task on the enforcement event base thread through the lock-free
+   * task queue, so bursts of gRPC callbacks batch into a single event base
+   * wakeup instead of serializing on the EventBase notification lock
+   */
+  void post_task(std::function<void()> task);
+
   /**
    * Setup rules for all sessions in pipelined, used whenever pipelined
    * restarts and needs to recover state
@@ -139,6 +149,12 @@ class LocalEnforcer {
       SessionMap& session_map, const std::uint64_t& epoch,
       std::function<void(Status status, SetupFlowsResult)> callback);
 
+  /**
+   * Replay journaled flow ops PipelineD never acknowledged, covering ops
+   * lost in flight around a restart. No-op without a flow op journal.
+   */
+  void replay_journaled_flow_ops();
+
   /**
    * Updates rules to be activated/deactivated based on the current time.
    * Also schedules future rule activation and deactivation callbacks to run
@@ -176,8 +192,7 @@ class LocalEnforcer {
    * @param updates_out (out) - vector to add usage updates to, if they exist
    */
   UpdateSessionRequest collect_updates(
-      SessionMap& session_map,
-      std::vector<std::unique_ptr<ServiceAction>>& actions,
+      SessionMap& session_map, ServiceActionBatch& actions,
       SessionUpdate& session_update) const;
 
   /**
@@ -268,8 +283,7 @@ class LocalEnforcer {
    * just continue
    */
   void execute_actions(
-      SessionMap& session_map,
-      const std::vector<std::unique_ptr<ServiceAction>>& actions,
+      SessionMap& session_map, const ServiceActionBatch& actions,
       SessionUpdate& session_update);
 
   /**
@@ -316,6 +330,17 @@ class LocalEnforcer {
       UpdateSessionResponse response);
 
   void poll_stats_enforcer(int cookie, int cookie_mask);
+
+  /**
+   * Recommend how long the stats poller should sleep before the next poll.
+   * The configured interval is the steady-state value; it is tightened when
+   * any session is close to its granted quota and relaxed when the last
+   * poll saw no counter movement at all.
+   * @param configured_interval_s poll_stats_interval from sessiond.yml
+   * @return the number of seconds to sleep before the next poll
+   */
+  uint32_t get_stats_poll_interval(uint32_t configured_interval_s) const;
+
   /**
    * Sends enb_teid and agw_teid for a specific bearer to a flow for a specific
    * UE on pipelined. UE will be identified by pipelined using its IP
@@ -337,6 +362,16 @@ class LocalEnforcer {
   static bool CLEANUP_DANGLING_FLOWS;
   // If true, send ipfix related updates to PipelineD
   static bool SEND_IPFIX;
+  // Number of sessions to include in each PipelineD setup call when
+  // restoring state after a restart. 0 disables batching and restores all
+  // sessions in a single call.
+  static uint32_t SETUP_BATCH_SIZE;
+  // Maximum number of concurrent batched PipelineD setup calls in flight
+  static uint32_t SETUP_MAX_IN_FLIGHT;
+  // How long to wait for further policy->bearer bindings on the same
+  // dedicated bearer before installing their rules into PipelineD in one
+  // activate_flows request. 0 installs each rule as it binds.
+  static uint32_t BEARER_RULE_BATCH_WINDOW_MS;
 
  private:
   std::shared_ptr<SessionReporter> reporter_;
@@ -347,6 +382,22 @@ class LocalEnforcer {
   std::shared_ptr<aaa::AAAClient> aaa_client_;
   SessionStore& session_store_;
   folly::EventBase* evb_;
+  // Hashed timer wheel for credit validity, revalidation, rule
+  // activation/deactivation and retry timers so bulk timeouts don't churn
+  // the event base timer heap
+  TimerWheel timer_wheel_;
+  // Lock-free queue feeding callback work from gRPC response threads into
+  // the enforcement loop
+  MpscTaskQueue task_queue_;
+  // Rule installs waiting for sibling policy->bearer bindings on the same
+  // dedicated bearer; keyed by session id + bearer id and only touched on
+  // the event base thread
+  struct PendingBearerInstall {
+    SessionConfig config;
+    RulesToProcess pending_activation;
+  };
+  std::unordered_map<std::string, PendingBearerInstall>
+      pending_bearer_installs_;
   long session_force_termination_timeout_ms_;
   // [CWF-ONLY] This configures how long we should wait before terminating a
   // session after it is created without any monitoring quota
@@ -354,8 +405,59 @@ class LocalEnforcer {
   std::chrono::milliseconds retry_timeout_;
   magma::mconfig::SessionD mconfig_;
   std::unique_ptr<Timezone> access_timezone_;
+  // Counts poll_stats_enforcer invocations so a periodic full poll can be
+  // interleaved with the cheaper changed-only polls; only touched on the
+  // stats poller thread
+  uint32_t stats_poll_count_ = 0;
+  // Observations from the last completed stats poll, written on the
+  // pipelined response thread and read by the stats poller when sizing its
+  // next sleep. The record count starts at 1 so startup polls run at the
+  // configured rate until the dataplane proves quiet.
+  std::atomic<size_t> last_poll_record_count_{1};
+  std::atomic<bool> session_near_quota_{false};
+  // Action batch recycled across stats polls; only touched on the event
+  // base thread, so the slots filled by one poll are free for the next
+  ServiceActionBatch service_action_batch_;
 
  private:
+  /**
+   * Shared bookkeeping for a batched PipelineD setup restoration: the
+   * remaining batches, how many requests are currently in flight, and the
+   * first failure seen so it can be reported once every batch has completed.
+   */
+  struct SetupBatchState {
+    std::vector<std::vector<SessionState::SessionInfo>> batches;
+    size_t next_batch = 0;
+    size_t in_flight  = 0;
+    size_t restored   = 0;
+    size_t total      = 0;
+    bool failed       = false;
+    Status failed_status;
+    SetupFlowsResult failed_result;
+  };
+
+  /**
+   * Partitions session_infos into batches of SETUP_BATCH_SIZE and issues
+   * concurrent setup_lte calls to PipelineD, keeping at most
+   * SETUP_MAX_IN_FLIGHT requests outstanding. The callback fires once with
+   * the aggregated result after the last batch completes.
+   */
+  void setup_lte_in_batches(
+      std::vector<SessionState::SessionInfo> session_infos,
+      const std::uint64_t epoch,
+      std::function<void(Status status, SetupFlowsResult)> callback);
+
+  void launch_next_setup_batches(
+      std::shared_ptr<SetupBatchState> state, const std::uint64_t epoch,
+      std::function<void(Status status, SetupFlowsResult)> callback);
+
+  /**
+   * Returns true if any session in session_map has a charging credit close
+   * enough to its granted quota that the stats poller should tighten its
+   * interval.
+   */
+  bool has_session_near_quota(SessionMap& session_map) const;
+
   /**
    * complete_termination_for_released_sessions completes the termination
    * process for sessions whose flows have been removed in PipelineD. Since
@@ -634,19 +736,20 @@ class LocalEnforcer {
           unsuspended_credits,
       SessionUpdate& session_update);
 
-  void handle_activate_service_action(
-      const std::unique_ptr<ServiceAction>& action_p);
+  void handle_activate_service_action(const ServiceAction& action);
 
   /**
-   * Install final action flows through pipelined
+   * Install final action flows through pipelined. to_process carries the
+   * merged Gy rules of every final unit action of the session, so one call
+   * covers all rating groups that fired in the same update pass.
    */
   void install_final_unit_action_flows(
-      const std::unique_ptr<ServiceAction>& action);
+      const ServiceAction& action, const RulesToProcess& to_process);
 
   /**
    * Create redirection rule
    */
-  PolicyRule create_redirect_rule(const std::unique_ptr<ServiceAction>& action);
+  PolicyRule create_redirect_rule(const ServiceAction& action);
 
   void report_subscriber_state_to_pipelined(
       const std::string& imsi, const std::string& ue_mac_addr,
@@ -684,7 +787,10 @@ class LocalEnforcer {
 
   /**
    * @brief Activate the rule after successfully binding it to a dedicated
-   * bearer
+   * bearer. Rules bound to the same bearer arrive as separate
+   * BindPolicy2Bearer calls, so the install is queued and flushed by
+   * flush_pending_bearer_installs after BEARER_RULE_BATCH_WINDOW_MS in a
+   * single activate_flows request.
    *
    * @param session
    * @param request
@@ -692,6 +798,12 @@ class LocalEnforcer {
   void install_rule_after_bearer_creation(
       SessionState& session, const PolicyBearerBindingRequest& request);
 
+  /**
+   * @brief Send every rule install queued for the given session+bearer to
+   * PipelineD in one activate_flows request. Runs on the event base thread.
+   */
+  void flush_pending_bearer_installs(const std::string& key);
+
   static std::unique_ptr<Timezone> compute_access_timezone();
 
   void remove_rules_for_suspended_credit(
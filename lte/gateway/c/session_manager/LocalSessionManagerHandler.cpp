@@ -53,7 +53,7 @@ void LocalSessionManagerHandlerImpl::ReportRuleStats(
     PrintGrpcMessage(
         static_cast<const google::protobuf::Message&>(request_cpy));
   }
-  enforcer_->get_event_base().runInEventBaseThread([this, request_cpy]() {
+  enforcer_->post_task([this, request_cpy]() {
     if (!session_store_.is_ready()) {
       // Since PipelineD reports a delta value for usage, this could lead to
       // SessionD missing some usage if Redis becomes unavailable. However,
@@ -87,9 +87,10 @@ void LocalSessionManagerHandlerImpl::ReportRuleStats(
 
 void LocalSessionManagerHandlerImpl::check_usage_for_reporting(
     SessionMap session_map, SessionUpdate& session_uc) {
-  std::vector<std::unique_ptr<ServiceAction>> actions;
-  auto request = enforcer_->collect_updates(session_map, actions, session_uc);
-  enforcer_->execute_actions(session_map, actions, session_uc);
+  service_action_batch_.clear();
+  auto request = enforcer_->collect_updates(
+      session_map, service_action_batch_, session_uc);
+  enforcer_->execute_actions(session_map, service_action_batch_, session_uc);
   if (request.updates_size() == 0 && request.usage_monitors_size() == 0) {
     auto update_success = session_store_.update_sessions(session_uc);
     if (update_success) {
@@ -137,10 +138,13 @@ void LocalSessionManagerHandlerImpl::handle_setup_callback(
     const std::uint64_t& epoch, Status status, SetupFlowsResult resp) {
   // Run everything in the event base thread since we asynchronously
   // read/modify pipelined_state_
-  enforcer_->get_event_base().runInEventBaseThread([=] {
+  enforcer_->post_task([=] {
     if (status.ok() && resp.result() == resp.SUCCESS) {
       MLOG(MINFO) << "Successfully setup PipelineD with epoch: " << epoch;
       pipelined_state_ = PipelineDState::READY;
+      // Ops in flight around the restart were not part of the setup
+      // snapshot; re-send the ones PipelineD never acknowledged
+      enforcer_->replay_journaled_flow_ops();
       return;
     }
     pipelined_state_ = PipelineDState::NOT_READY;
@@ -244,14 +248,97 @@ grpc::Status LocalSessionManagerHandlerImpl::validate_create_session_request(
   return check_sessiond_is_ready();
 }
 
+std::string LocalSessionManagerHandlerImpl::create_session_fingerprint(
+    const LocalCreateSessionRequest& request) {
+  const CommonSessionContext& common = request.common_context();
+  uint32_t pdu_id                    = 0;
+  if (request.rat_specific_context().has_lte_context()) {
+    pdu_id = request.rat_specific_context().lte_context().bearer_id();
+  }
+  const size_t content_hash =
+      std::hash<std::string>()(request.SerializeAsString());
+  return common.sid().id() + "|" + common.apn() + "|" +
+         std::to_string(pdu_id) + "|" + std::to_string(content_hash);
+}
+
+bool LocalSessionManagerHandlerImpl::deduplicate_create_session(
+    const std::string& fingerprint,
+    std::function<void(Status, LocalCreateSessionResponse)>
+        response_callback) {
+  const auto now = std::chrono::steady_clock::now();
+  const auto ttl = std::chrono::seconds(CREATE_SESSION_DEDUP_TTL_SEC);
+
+  std::lock_guard<std::mutex> lock(create_session_dedup_lock_);
+  // Completed entries only matter for the retry window, drop the stale ones
+  for (auto it = create_session_dedup_.begin();
+       it != create_session_dedup_.end();) {
+    if (it->second.completed && now - it->second.completed_at > ttl) {
+      it = create_session_dedup_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  auto it = create_session_dedup_.find(fingerprint);
+  if (it == create_session_dedup_.end()) {
+    create_session_dedup_[fingerprint];  // mark in flight, no waiters yet
+    return false;
+  }
+  if (it->second.completed) {
+    MLOG(MINFO) << "Answering duplicate CreateSession from the recently "
+                << "completed response for session "
+                << it->second.session_id;
+    send_local_create_session_response(
+        it->second.status, it->second.session_id, response_callback);
+    return true;
+  }
+  MLOG(MINFO) << "Attaching duplicate CreateSession to the in-flight "
+              << "original (" << it->second.waiters.size() + 1
+              << " waiting)";
+  it->second.waiters.push_back(response_callback);
+  return true;
+}
+
+void LocalSessionManagerHandlerImpl::complete_create_session_dedup(
+    const std::string& fingerprint, Status status,
+    const std::string& session_id) {
+  std::vector<std::function<void(Status, LocalCreateSessionResponse)>> waiters;
+  {
+    std::lock_guard<std::mutex> lock(create_session_dedup_lock_);
+    CreateSessionDedupEntry& entry = create_session_dedup_[fingerprint];
+    entry.completed                = true;
+    entry.status                   = status;
+    entry.session_id               = session_id;
+    entry.completed_at             = std::chrono::steady_clock::now();
+    waiters.swap(entry.waiters);
+  }
+  for (auto& waiter : waiters) {
+    send_local_create_session_response(status, session_id, waiter);
+  }
+}
+
 void LocalSessionManagerHandlerImpl::CreateSession(
     ServerContext* context, const LocalCreateSessionRequest* request,
     std::function<void(Status, LocalCreateSessionResponse)> response_callback) {
   set_sentry_transaction("CreateSession");
   auto& request_cpy = *request;
   PrintGrpcMessage(static_cast<const google::protobuf::Message&>(request_cpy));
+
+  /* Retry storms during overload: identical requests ride on the first
+   * one instead of each running policy setup before conflict detection */
+  const std::string fingerprint = create_session_fingerprint(request_cpy);
+  if (deduplicate_create_session(fingerprint, response_callback)) {
+    return;
+  }
+  auto dedup_callback = [this, fingerprint, response_callback](
+                            Status status, LocalCreateSessionResponse resp) {
+    complete_create_session_dedup(fingerprint, status, resp.session_id());
+    response_callback(status, resp);
+  };
+
   enforcer_->get_event_base().runInEventBaseThread([this, context,
-                                                    response_callback,
+                                                    response_callback =
+                                                        dedup_callback,
                                                     request_cpy]() {
     SessionConfig cfg(request_cpy);
     const std::string& imsi           = cfg.get_imsi();
@@ -592,6 +679,47 @@ void LocalSessionManagerHandlerImpl::UpdateTunnelIds(
   });
 }
 
+void LocalSessionManagerHandlerImpl::BulkUpdateTunnelIds(
+    ServerContext* context, UpdateTunnelIdsBatchRequest* request,
+    std::function<void(Status, UpdateTunnelIdsBatchResponse)>
+        response_callback) {
+  set_sentry_transaction("BulkUpdateTunnelIds");
+  auto& request_cpy = *request;
+  PrintGrpcMessage(static_cast<const google::protobuf::Message&>(request_cpy));
+  MLOG(MINFO) << "Received a BulkUpdateTunnelIds request with "
+              << request->requests_size() << " tunnel updates";
+  enforcer_->post_task([this, request_cpy, response_callback]() {
+    SessionRead req = {};
+    for (const auto& tunnel_update : request_cpy.requests()) {
+      req.insert(tunnel_update.sid().id());
+    }
+    // One read/write cycle covers the whole batch, so an eNB flap pays for
+    // a single store transaction per shard instead of one per bearer
+    auto session_map      = session_store_.read_sessions(req);
+    uint32_t failed_count = 0;
+    for (const auto& tunnel_update : request_cpy.requests()) {
+      if (!enforcer_->update_tunnel_ids(session_map, tunnel_update)) {
+        MLOG(MDEBUG) << "Failed to UpdateTunnelIds for imsi "
+                     << tunnel_update.sid().id() << " and bearer "
+                     << tunnel_update.bearer_id();
+        failed_count++;
+      }
+    }
+    bool update_success =
+        session_store_.raw_write_sessions(std::move(session_map));
+    if (!update_success) {
+      MLOG(MERROR) << "Failed in updating SessionStore after processing "
+                      "BulkUpdateTunnelIds";
+      auto err_status = Status(grpc::ABORTED, "Failed to store tunnel Ids");
+      response_callback(err_status, UpdateTunnelIdsBatchResponse());
+      return;
+    }
+    UpdateTunnelIdsBatchResponse response;
+    response.set_failed_count(failed_count);
+    response_callback(Status::OK, response);
+  });
+}
+
 void LocalSessionManagerHandlerImpl::SetSessionRules(
     ServerContext* context, const SessionRules* request,
     std::function<void(Status, Void)> response_callback) {
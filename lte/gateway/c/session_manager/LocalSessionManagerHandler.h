@@ -15,9 +15,13 @@
 #include <grpc++/grpc++.h>
 #include <lte/protos/session_manager.grpc.pb.h>
 
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "LocalEnforcer.h"
 #include "SessionID.h"
@@ -119,6 +123,14 @@ class LocalSessionManagerHandler {
       std::function<void(Status, UpdateTunnelIdsResponse)>
           response_callback) = 0;
 
+  /**
+   * Updates tunnel ids for a batch of sessions in one store transaction
+   */
+  virtual void BulkUpdateTunnelIds(
+      ServerContext* context, UpdateTunnelIdsBatchRequest* request,
+      std::function<void(Status, UpdateTunnelIdsBatchResponse)>
+          response_callback) = 0;
+
   /**
    * Update active rules for session
    */
@@ -179,6 +191,16 @@ class LocalSessionManagerHandlerImpl : public LocalSessionManagerHandler {
       ServerContext* context, UpdateTunnelIdsRequest* request,
       std::function<void(Status, UpdateTunnelIdsResponse)> response_callback);
 
+  /**
+   * Updates eNB and AGW tunnel ids for a batch of default bearers, reading
+   * and writing all touched subscribers in a single store transaction. Used
+   * by the MME when an eNB restart re-attaches many UEs at once.
+   */
+  void BulkUpdateTunnelIds(
+      ServerContext* context, UpdateTunnelIdsBatchRequest* request,
+      std::function<void(Status, UpdateTunnelIdsBatchResponse)>
+          response_callback);
+
   /**
    * Update active rules for session
    * Get the SessionMap for the updates, apply the set rules and update the
@@ -202,6 +224,10 @@ class LocalSessionManagerHandlerImpl : public LocalSessionManagerHandler {
   static const std::string hex_digit_;
 
  private:
+  // Action batch recycled across reporting passes; only touched on the
+  // enforcer's event base thread
+  ServiceActionBatch service_action_batch_;
+
   void check_usage_for_reporting(
       SessionMap session_map, SessionUpdate& session_uc);
   bool is_pipelined_restarted();
@@ -287,6 +313,54 @@ class LocalSessionManagerHandlerImpl : public LocalSessionManagerHandler {
 
   void log_create_session(const SessionConfig& cfg);
 
+  /**
+   * Dedup of identical CreateSession requests. When the access side retries
+   * a slow CreateSession, the duplicate is attached to the in-flight
+   * original (and answered together with it) or served the just-completed
+   * response, instead of running policy setup again.
+   */
+  struct CreateSessionDedupEntry {
+    bool completed = false;
+    // Response of the original request, valid once completed
+    grpc::Status status = grpc::Status::OK;
+    std::string session_id;
+    std::chrono::steady_clock::time_point completed_at;
+    // Callbacks of duplicates that arrived while the original was in flight
+    std::vector<std::function<void(Status, LocalCreateSessionResponse)>>
+        waiters;
+  };
+
+  // Guards create_session_dedup_: requests are deduplicated before the hop
+  // onto the event base thread and completed from reporter callbacks
+  std::mutex create_session_dedup_lock_;
+  std::unordered_map<std::string, CreateSessionDedupEntry>
+      create_session_dedup_;
+  // How long a completed response keeps answering duplicates
+  static const uint32_t CREATE_SESSION_DEDUP_TTL_SEC = 10;
+
+  /**
+   * Fingerprint of a LocalCreateSessionRequest: (IMSI, APN, bearer/PDU id)
+   * plus a hash of the full request, so only byte-identical retries
+   * collide and a genuine re-attach (new TEIDs) never matches.
+   */
+  static std::string create_session_fingerprint(
+      const LocalCreateSessionRequest& request);
+
+  /**
+   * @return true when the request is a duplicate and response_callback has
+   * been answered or queued on the original; false when the request is new
+   * and has been recorded as in flight.
+   */
+  bool deduplicate_create_session(
+      const std::string& fingerprint,
+      std::function<void(Status, LocalCreateSessionResponse)>
+          response_callback);
+
+  // Record the response of the original request and flush its waiters
+  void complete_create_session_dedup(
+      const std::string& fingerprint, Status status,
+      const std::string& session_id);
+
   /**
    * @param cfg
    * @return status::OK if the request can be processed, otherwise the status
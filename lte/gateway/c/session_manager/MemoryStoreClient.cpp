@@ -32,10 +32,11 @@ SessionMap MemoryStoreClient::read_sessions(
   auto session_map = SessionMap{};
   for (const auto& subscriber_id : subscriber_ids) {
     auto sessions = SessionVector{};
-    if (session_map_.find(subscriber_id) != session_map_.end()) {
-      for (auto& stored_session : session_map_[subscriber_id]) {
-        auto session = SessionState::unmarshal(stored_session, *rule_store_);
-        sessions.push_back(std::move(session));
+    auto it       = session_map_.find(subscriber_id);
+    if (it != session_map_.end()) {
+      for (auto& session : it->second) {
+        sessions.push_back(
+            SessionState::unmarshal(session->marshal(), *rule_store_));
       }
     }
     session_map[subscriber_id] = std::move(sessions);
@@ -47,9 +48,9 @@ SessionMap MemoryStoreClient::read_all_sessions() {
   auto session_map = SessionMap{};
   for (auto& it : session_map_) {
     auto sessions = SessionVector{};
-    for (auto& stored_session : it.second) {
-      auto session = SessionState::unmarshal(stored_session, *rule_store_);
-      sessions.push_back(std::move(session));
+    for (auto& session : it.second) {
+      sessions.push_back(
+          SessionState::unmarshal(session->marshal(), *rule_store_));
     }
     session_map[it.first] = std::move(sessions);
   }
@@ -58,20 +59,43 @@ SessionMap MemoryStoreClient::read_all_sessions() {
 
 bool MemoryStoreClient::write_sessions(SessionMap session_map) {
   for (auto& it : session_map) {
-    auto sessions = std::vector<StoredSessionState>{};
-    for (auto const& session : it.second) {
-      auto stored_session = session->marshal();
-      sessions.push_back(stored_session);
-    }
-    if (sessions.empty()) {
+    if (it.second.empty()) {
       // if session is empty that means subs should be deleted from the map
       session_map_.erase(it.first);
       continue;
     }
-    session_map_[it.first] = std::move(sessions);
+    session_map_[it.first] = std::move(it.second);
   }
+  commit_version_++;
   return true;
 }
 
+SessionMap MemoryStoreClient::borrow_sessions(
+    std::set<std::string> subscriber_ids) {
+  auto session_map = SessionMap{};
+  for (const auto& subscriber_id : subscriber_ids) {
+    auto sessions = SessionVector{};
+    auto it       = session_map_.find(subscriber_id);
+    if (it != session_map_.end()) {
+      sessions = std::move(it->second);
+      session_map_.erase(it);
+    }
+    session_map[subscriber_id] = std::move(sessions);
+  }
+  return session_map;
+}
+
+void MemoryStoreClient::return_borrowed_sessions(SessionMap session_map) {
+  // Hand the live sessions back without bumping the commit version; any
+  // mutations made before the cycle failed are kept, since the borrowed
+  // objects are the store's own
+  for (auto& it : session_map) {
+    if (it.second.empty()) {
+      continue;
+    }
+    session_map_[it.first] = std::move(it.second);
+  }
+}
+
 }  // namespace lte
 }  // namespace magma
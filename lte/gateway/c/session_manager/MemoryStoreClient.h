@@ -21,13 +21,18 @@
 #include <vector>
 
 #include "StoreClient.h"
-#include "StoredState.h"
 
 namespace magma {
 namespace lte {
 
 /**
- * Non-persistent StoreClient used as intermediate stage in development
+ * Non-persistent StoreClient used as intermediate stage in development.
+ *
+ * Sessions are stored live rather than marshaled, since sessiond is the only
+ * accessor. Writes are therefore a move, and callers running a
+ * read-modify-write cycle under the SessionStore shard locks can borrow the
+ * stored sessions outright, skipping the copy in both directions; a commit
+ * is then just the move back plus a version bump.
  */
 class MemoryStoreClient final : public StoreClient {
  public:
@@ -44,9 +49,20 @@ class MemoryStoreClient final : public StoreClient {
 
   bool write_sessions(SessionMap session_map);
 
+  SessionMap borrow_sessions(std::set<std::string> subscriber_ids);
+
+  void return_borrowed_sessions(SessionMap session_map);
+
+  /**
+   * @return Counter bumped on every committed write, so callers can tell
+   * whether the store changed between two observations
+   */
+  uint64_t get_commit_version() const { return commit_version_; }
+
  private:
-  std::unordered_map<std::string, std::vector<StoredSessionState>> session_map_;
+  std::unordered_map<std::string, SessionVector> session_map_;
   std::shared_ptr<StaticRuleStore> rule_store_;
+  uint64_t commit_version_ = 0;
 };
 
 }  // namespace lte
@@ -17,7 +17,9 @@
 #include "MeteringReporter.h"
 #include "includes/MetricsHelpers.h"
 
-using magma::service303::increment_counter;
+using magma::service303::get_counter_series;
+using magma::service303::get_counter_series_epoch;
+using magma::service303::increment_counter_series;
 
 namespace magma {
 namespace lte {
@@ -29,30 +31,44 @@ const char* LABEL_DIRECTION  = "direction";
 const char* DIRECTION_UP     = "up";
 const char* DIRECTION_DOWN   = "down";
 
+static uint64_t get_bucket_delta(
+    const SessionCreditUpdateCriteria& credit_uc, Bucket bucket) {
+  auto it = credit_uc.bucket_deltas.find(bucket);
+  return it == credit_uc.bucket_deltas.end() ? 0 : it->second;
+}
+
 MeteringReporter::MeteringReporter() {}
 
 void MeteringReporter::report_usage(
     const std::string& imsi, const std::string& session_id,
-    SessionStateUpdateCriteria& update_criteria) {
+    const SessionStateUpdateCriteria& update_criteria) {
   double total_tx = 0;
   double total_rx = 0;
 
   // Charging credit
   for (const auto& it : update_criteria.charging_credit_map) {
-    auto credit_update = it.second;
-    total_tx += (double) credit_update.bucket_deltas[USED_TX];
-    total_rx += (double) credit_update.bucket_deltas[USED_RX];
+    total_tx += (double) get_bucket_delta(it.second, USED_TX);
+    total_rx += (double) get_bucket_delta(it.second, USED_RX);
   }
 
   // Monitoring credit
   for (const auto& it : update_criteria.monitor_credit_map) {
-    auto credit_update = it.second;
-    total_tx += (double) credit_update.bucket_deltas[USED_TX];
-    total_rx += (double) credit_update.bucket_deltas[USED_RX];
+    total_tx += (double) get_bucket_delta(it.second, USED_TX);
+    total_rx += (double) get_bucket_delta(it.second, USED_RX);
+  }
+
+  TrafficSeries& series = get_series(imsi, session_id);
+  increment_counter_series(series.up, total_tx);
+  increment_counter_series(series.down, total_rx);
+
+  if (journal_ && (total_tx > 0 || total_rx > 0)) {
+    journal_->append(
+        imsi, session_id, (uint64_t) total_tx, (uint64_t) total_rx);
   }
+}
 
-  report_traffic(imsi, session_id, DIRECTION_UP, total_tx);
-  report_traffic(imsi, session_id, DIRECTION_DOWN, total_rx);
+void MeteringReporter::attach_journal(std::shared_ptr<UsageJournal> journal) {
+  journal_ = journal;
 }
 
 void MeteringReporter::initialize_usage(
@@ -60,17 +76,32 @@ void MeteringReporter::initialize_usage(
     TotalCreditUsage usage) {
   auto tx = usage.monitoring_tx + usage.charging_tx;
   auto rx = usage.monitoring_rx + usage.charging_rx;
-  report_traffic(imsi, session_id, DIRECTION_UP, tx);
-  report_traffic(imsi, session_id, DIRECTION_DOWN, rx);
+
+  TrafficSeries& series = get_series(imsi, session_id);
+  increment_counter_series(series.up, tx);
+  increment_counter_series(series.down, rx);
 }
 
-void MeteringReporter::report_traffic(
-    const std::string& imsi, const std::string& session_id,
-    const std::string& traffic_direction, double unreported_usage_bytes) {
-  increment_counter(
-      COUNTER_NAME, unreported_usage_bytes, size_t(3), LABEL_IMSI, imsi.c_str(),
-      LABEL_SESSION_ID, session_id.c_str(), LABEL_DIRECTION,
-      traffic_direction.c_str());
+void MeteringReporter::remove_session(const std::string& session_id) {
+  series_by_session_.erase(session_id);
+}
+
+MeteringReporter::TrafficSeries& MeteringReporter::get_series(
+    const std::string& imsi, const std::string& session_id) {
+  TrafficSeries& series = series_by_session_[session_id];
+  // Capture the epoch before resolving: a removal racing the resolution
+  // then leaves the stored epoch stale and forces a re-resolution
+  const uint64_t epoch = get_counter_series_epoch();
+  if (series.up == nullptr || series.epoch != epoch) {
+    series.up = get_counter_series(
+        COUNTER_NAME, size_t(3), LABEL_IMSI, imsi.c_str(), LABEL_SESSION_ID,
+        session_id.c_str(), LABEL_DIRECTION, DIRECTION_UP);
+    series.down = get_counter_series(
+        COUNTER_NAME, size_t(3), LABEL_IMSI, imsi.c_str(), LABEL_SESSION_ID,
+        session_id.c_str(), LABEL_DIRECTION, DIRECTION_DOWN);
+    series.epoch = epoch;
+  }
+  return series;
 }
 
 }  // namespace lte
@@ -12,10 +12,15 @@
  */
 #pragma once
 
+#include <stdint.h>
+
+#include <memory>
 #include <string>
+#include <unordered_map>
 
 #include "StoredState.h"
 #include "SessionCredit.h"
+#include "UsageJournal.h"
 
 namespace magma {
 namespace lte {
@@ -30,7 +35,7 @@ class MeteringReporter {
    */
   void report_usage(
       const std::string& imsi, const std::string& session_id,
-      SessionStateUpdateCriteria& update_criteria);
+      const SessionStateUpdateCriteria& update_criteria);
 
   /**
    * Reports the usage as described in TotalCreditUsage
@@ -42,13 +47,37 @@ class MeteringReporter {
       const std::string& imsi, const std::string& session_id,
       TotalCreditUsage usage);
 
+  /**
+   * Additionally journal every reported delta to the given local ring
+   * file for billing-grade capture; the metrics path is unaffected.
+   */
+  void attach_journal(std::shared_ptr<UsageJournal> journal);
+
+  /**
+   * Drop the cached metric handles of a terminated session. Called when the
+   * session leaves the store; a fresh session resolves its own handles.
+   */
+  void remove_session(const std::string& session_id);
+
  private:
   /**
-   * Report traffic usage for a session
+   * The up/down counter timeseries of one session, resolved through
+   * MetricsSingleton once and reused for every poll-cycle report. The
+   * epoch guards against counters removed elsewhere: when it moved, the
+   * pointers may dangle and are resolved again.
    */
-  void report_traffic(
-      const std::string& imsi, const std::string& session_id,
-      const std::string& traffic_direction, double unreported_usage_bytes);
+  struct TrafficSeries {
+    void* up       = nullptr;
+    void* down     = nullptr;
+    uint64_t epoch = 0;
+  };
+
+  // Resolve (or revalidate) the cached series of a session
+  TrafficSeries& get_series(
+      const std::string& imsi, const std::string& session_id);
+
+  std::unordered_map<std::string, TrafficSeries> series_by_session_;
+  std::shared_ptr<UsageJournal> journal_;
 };
 
 }  // namespace lte
@@ -0,0 +1,77 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <utility>
+
+#include "MpscTaskQueue.h"
+
+namespace magma {
+
+MpscTaskQueue::MpscTaskQueue() : evb_(nullptr), pending_(0) {
+  // The queue starts with a consumed stub node so producers always have a
+  // predecessor to link behind
+  Node* stub = new Node{nullptr, {nullptr}};
+  head_.store(stub, std::memory_order_relaxed);
+  tail_ = stub;
+}
+
+MpscTaskQueue::~MpscTaskQueue() {
+  Node* node = tail_;
+  while (node != nullptr) {
+    Node* next = node->next.load(std::memory_order_relaxed);
+    delete node;
+    node = next;
+  }
+}
+
+void MpscTaskQueue::attach(folly::EventBase* evb) {
+  evb_ = evb;
+}
+
+void MpscTaskQueue::post(std::function<void()> task) {
+  Node* node = new Node{std::move(task), {nullptr}};
+  Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+  prev->next.store(node, std::memory_order_release);
+  // Only the post that makes the queue non-empty pays for an event base
+  // wakeup; the rest of the burst rides along in the same drain
+  if (pending_.fetch_add(1, std::memory_order_acq_rel) == 0) {
+    evb_->runInEventBaseThread([this] { drain(); });
+  }
+}
+
+void MpscTaskQueue::drain() {
+  size_t drained = 0;
+  while (true) {
+    Node* next = tail_->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      if (drained == 0) {
+        return;
+      }
+      size_t remaining =
+          pending_.fetch_sub(drained, std::memory_order_acq_rel) - drained;
+      drained = 0;
+      if (remaining == 0) {
+        return;
+      }
+      // A producer has incremented pending_ but has not finished linking
+      // its node yet; spin until the node becomes visible
+      continue;
+    }
+    delete tail_;
+    tail_ = next;
+    tail_->task();
+    tail_->task = nullptr;
+    drained++;
+  }
+}
+
+}  // namespace magma
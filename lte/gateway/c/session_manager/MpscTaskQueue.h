@@ -0,0 +1,66 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/io/async/EventBase.h>
+
+#include <atomic>
+#include <functional>
+
+namespace magma {
+
+/**
+ * MpscTaskQueue is a lock-free multi-producer single-consumer queue for
+ * handing tasks from gRPC response threads to the enforcement event base.
+ * Posting through runInEventBaseThread takes the EventBase notification
+ * lock once per callback; this queue links tasks with atomic exchanges and
+ * only wakes the event base when the queue transitions from empty to
+ * non-empty, so a burst of acks is drained as one batch. Tasks run on the
+ * attached event base thread in post order.
+ */
+class MpscTaskQueue {
+ public:
+  MpscTaskQueue();
+  ~MpscTaskQueue();
+
+  /**
+   * Attach the event base that drains the queue. Must be called before the
+   * first post, mirroring LocalEnforcer::attachEventBase.
+   */
+  void attach(folly::EventBase* evb);
+
+  /**
+   * Enqueue a task from any thread
+   */
+  void post(std::function<void()> task);
+
+ private:
+  struct Node {
+    std::function<void()> task;
+    std::atomic<Node*> next;
+  };
+
+  /**
+   * Run every queued task on the event base thread
+   */
+  void drain();
+
+  folly::EventBase* evb_;
+  // Producers push onto head_, the consumer follows next pointers from
+  // tail_; tail_ always points at an already-consumed stub node
+  std::atomic<Node*> head_;
+  Node* tail_;
+  std::atomic<size_t> pending_;
+};
+
+}  // namespace magma
@@ -28,21 +28,14 @@ namespace magma {
 
 OpState get_operational_states(magma::SessionStore* session_store) {
   std::list<std::map<std::string, std::string>> states;
-  auto session_map = session_store->read_all_sessions();
-  for (auto& it : session_map) {
+  // Serve the commit-time snapshot so a magmad poll neither locks the live
+  // store nor re-serializes sessions that have not changed
+  auto snapshot = session_store->get_op_state_snapshot();
+  for (auto& it : snapshot) {
     std::map<std::string, std::string> state;
-    state[TYPE]                    = SUBSCRIBER_STATE_TYPE;
-    state[DEVICE_ID]               = it.first;
-    folly::dynamic sessions_by_apn = folly::dynamic::object;
-
-    for (auto& session : it.second) {
-      const auto apn = session->get_config().common_context.apn();
-      if (sessions_by_apn[apn].empty()) {
-        sessions_by_apn[apn] = folly::dynamic::array;
-      }
-      sessions_by_apn[apn].push_back(get_dynamic_session_state(session));
-    }
-    state[VALUE] = folly::toJson(sessions_by_apn);
+    state[TYPE]      = SUBSCRIBER_STATE_TYPE;
+    state[DEVICE_ID] = it.first;
+    state[VALUE]     = std::move(it.second);
     states.push_back(state);
   }
   return states;
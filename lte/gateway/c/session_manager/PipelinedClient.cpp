@@ -12,6 +12,9 @@
  */
 
 #include <google/protobuf/util/time_util.h>
+#include <grpcpp/create_channel.h>
+#include <grpcpp/security/credentials.h>
+#include <unistd.h>
 
 #include <memory>
 #include <string>
@@ -30,6 +33,25 @@ using grpc::Status;
 namespace {  // anonymous
 using std::experimental::optional;
 
+// Unix socket pipelined exposes when grpc_unix_socket is configured in
+// pipelined.yml. Matches the path configured there.
+constexpr char PIPELINED_GRPC_UNIX_SOCKET[] =
+    "/var/run/magma_pipelined_grpc.sock";
+
+// Prefer the Unix socket transport to pipelined when it is present:
+// flow programming calls then skip the loopback TCP stack, which is most
+// of the per-rule latency during bearer setup bursts. Fall back to the
+// registry's TCP address when pipelined does not expose the socket.
+std::shared_ptr<grpc::Channel> get_pipelined_channel() {
+  if (access(PIPELINED_GRPC_UNIX_SOCKET, F_OK) == 0) {
+    return grpc::CreateChannel(
+        std::string("unix://") + PIPELINED_GRPC_UNIX_SOCKET,
+        grpc::InsecureChannelCredentials());
+  }
+  return magma::ServiceRegistrySingleton::Instance()->GetGrpcChannel(
+      "pipelined", magma::ServiceRegistrySingleton::LOCAL);
+}
+
 // Preparation of Set Session request to UPF
 magma::SessionSet create_session_set_req(
     magma::SessionState::SessionInfo info) {
@@ -40,6 +62,8 @@ magma::SessionSet create_session_set_req(
   req.mutable_node_id()->set_node_id(info.nodeId.node_id);
   req.mutable_node_id()->set_node_id_type(magma::NodeID::IPv4);
   req.mutable_state()->set_state(info.state);
+  req.set_base_version(info.upf_base_version);
+  req.set_state_checksum(info.state_checksum);
 
   for (const auto& final_req : info.pdr_rules) {
     req.mutable_set_gr_pdr()->Add()->CopyFrom(final_req);
@@ -63,10 +87,12 @@ magma::DeactivateFlowsRequest make_deactivate_req(
   return req;
 }
 
-magma::GetStatsRequest make_stat_req(int cookie, int cookie_mask) {
+magma::GetStatsRequest make_stat_req(
+    int cookie, int cookie_mask, bool changed_only) {
   magma::GetStatsRequest req;
   req.set_cookie(cookie);
   req.set_cookie_mask(cookie_mask);
+  req.set_changed_only(changed_only);
   return req;
 }
 
@@ -282,8 +308,7 @@ AsyncPipelinedClient::AsyncPipelinedClient(
 }
 
 AsyncPipelinedClient::AsyncPipelinedClient()
-    : AsyncPipelinedClient(ServiceRegistrySingleton::Instance()->GetGrpcChannel(
-          "pipelined", ServiceRegistrySingleton::LOCAL)) {}
+    : AsyncPipelinedClient(get_pipelined_channel()) {}
 
 void AsyncPipelinedClient::setup_cwf(
     const std::vector<SessionState::SessionInfo>& infos,
@@ -432,14 +457,12 @@ void AsyncPipelinedClient::update_subscriber_quota_state(
 }
 
 void AsyncPipelinedClient::poll_stats(
-    int cookie, int cookie_mask,
+    int cookie, int cookie_mask, bool changed_only,
     std::function<void(Status, RuleRecordTable)> callback) {
-  auto req = make_stat_req(cookie, cookie_mask);
-  poll_stats_rpc(req, [](Status status, RuleRecordTable table) {
-    if (!status.ok()) {
-      MLOG(MERROR) << "Could not poll stats " << status.error_message();
-    }
-  });
+  auto req = make_stat_req(cookie, cookie_mask, changed_only);
+  // Hand the response to the caller; LocalEnforcer both aggregates the
+  // records and logs poll failures
+  poll_stats_rpc(req, std::move(callback));
 }
 
 void AsyncPipelinedClient::add_gy_final_action_flow(
@@ -506,6 +529,18 @@ void AsyncPipelinedClient::setup_ue_mac_rpc(
 void AsyncPipelinedClient::deactivate_flows_rpc(
     const DeactivateFlowsRequest& request,
     std::function<void(Status, DeactivateFlowsResult)> callback) {
+  if (flow_op_journal_) {
+    auto journal = flow_op_journal_;
+    uint64_t seq = journal->record(lte::FlowOpJournal::DEACTIVATE,
+                                   request.SerializeAsString());
+    callback = [journal, seq, callback](Status status,
+                                        DeactivateFlowsResult resp) {
+      if (status.ok()) {
+        journal->ack(seq);
+      }
+      callback(status, resp);
+    };
+  }
   auto local_resp = new AsyncLocalResponse<DeactivateFlowsResult>(
       std::move(callback), RESPONSE_TIMEOUT);
   PrintGrpcMessage(static_cast<const google::protobuf::Message&>(request));
@@ -516,6 +551,18 @@ void AsyncPipelinedClient::deactivate_flows_rpc(
 void AsyncPipelinedClient::activate_flows_rpc(
     const ActivateFlowsRequest& request,
     std::function<void(Status, ActivateFlowsResult)> callback) {
+  if (flow_op_journal_) {
+    auto journal = flow_op_journal_;
+    uint64_t seq = journal->record(lte::FlowOpJournal::ACTIVATE,
+                                   request.SerializeAsString());
+    callback = [journal, seq, callback](Status status,
+                                        ActivateFlowsResult resp) {
+      if (status.ok()) {
+        journal->ack(seq);
+      }
+      callback(status, resp);
+    };
+  }
   auto local_resp = new AsyncLocalResponse<ActivateFlowsResult>(
       std::move(callback), RESPONSE_TIMEOUT);
   PrintGrpcMessage(static_cast<const google::protobuf::Message&>(request));
@@ -523,6 +570,51 @@ void AsyncPipelinedClient::activate_flows_rpc(
       stub_->AsyncActivateFlows(local_resp->get_context(), request, &queue_)));
 }
 
+void AsyncPipelinedClient::set_flow_op_journal(
+    std::shared_ptr<lte::FlowOpJournal> journal) {
+  flow_op_journal_ = journal;
+}
+
+void AsyncPipelinedClient::replay_unacked_flow_ops() {
+  if (!flow_op_journal_) {
+    return;
+  }
+  auto ops = flow_op_journal_->unacked();
+  if (ops.empty()) {
+    return;
+  }
+  MLOG(MINFO) << "Replaying " << ops.size()
+              << " journaled flow ops PipelineD did not acknowledge";
+  for (auto& op : ops) {
+    // Re-sending goes through the normal rpc paths, so each replayed op
+    // is journaled again under a fresh sequence and acked on its response
+    if (op.type == lte::FlowOpJournal::ACTIVATE) {
+      ActivateFlowsRequest request;
+      if (!request.ParseFromString(op.payload)) {
+        continue;
+      }
+      activate_flows_rpc(request, [](Status status, ActivateFlowsResult resp) {
+        if (!status.ok()) {
+          MLOG(MERROR) << "Could not replay activate flows, rpc failed: "
+                       << status.error_message();
+        }
+      });
+    } else if (op.type == lte::FlowOpJournal::DEACTIVATE) {
+      DeactivateFlowsRequest request;
+      if (!request.ParseFromString(op.payload)) {
+        continue;
+      }
+      deactivate_flows_rpc(
+          request, [](Status status, DeactivateFlowsResult resp) {
+            if (!status.ok()) {
+              MLOG(MERROR) << "Could not replay deactivate flows, rpc failed: "
+                           << status.error_message();
+            }
+          });
+    }
+  }
+}
+
 void AsyncPipelinedClient::add_ue_mac_flow_rpc(
     const UEMacFlowRequest& request,
     std::function<void(Status, FlowResponse)> callback) {
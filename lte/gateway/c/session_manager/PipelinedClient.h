@@ -23,6 +23,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "FlowOpJournal.h"
 #include "includes/GRPCReceiver.h"
 #include "SessionState.h"
 #include "Types.h"
@@ -210,8 +211,14 @@ class PipelinedClient {
   virtual uint32_t get_current_teid() = 0;
 
   virtual void poll_stats(
-      int cookie, int cookie_mask,
+      int cookie, int cookie_mask, bool changed_only,
       std::function<void(Status, RuleRecordTable)> callback) = 0;
+
+  /**
+   * @brief Re-send every journaled flow op PipelineD has not acknowledged.
+   * No-op unless a flow op journal is attached to the client.
+   */
+  virtual void replay_unacked_flow_ops() {}
 };
 
 /**
@@ -298,18 +305,30 @@ class AsyncPipelinedClient : public GRPCReceiver, public PipelinedClient {
    *
    * @param cookie require matching entries to contain the cookie value
    * @param cookie_mask mask that restricts the cookie bits that must match
+   * @param changed_only only return records whose counters moved since the
+   * previous poll
    */
   void poll_stats(
-      int cookie, int cookie_mask,
+      int cookie, int cookie_mask, bool changed_only,
       std::function<void(Status, RuleRecordTable)> callback);
 
   uint32_t get_next_teid();
   uint32_t get_current_teid();
 
+  /**
+   * @brief Attach the flow op journal. Every activate/deactivate request
+   * is then recorded before it is sent and acknowledged on its response,
+   * making replay_unacked_flow_ops available after a PipelineD outage.
+   */
+  void set_flow_op_journal(std::shared_ptr<lte::FlowOpJournal> journal);
+
+  void replay_unacked_flow_ops();
+
  private:
   static const uint32_t RESPONSE_TIMEOUT = 6;  // seconds
   std::unique_ptr<Pipelined::Stub> stub_;
   uint32_t teid;
+  std::shared_ptr<lte::FlowOpJournal> flow_op_journal_;
 
  private:
   void setup_default_controllers_rpc(
@@ -20,12 +20,16 @@
 #include <stddef.h>                   // for size_t
 #include <stdint.h>                   // for uint32_t
 #include <yaml-cpp/yaml.h>            // IWYU pragma: keep
+#include <zstd.h>                     // for ZSTD_compress_usingCDict, ZSTD_...
+#include <fstream>                    // for ifstream
 #include <algorithm>                  // for max
 #include <cpp_redis/core/client.hpp>  // for client, client::connect_state
 #include <cpp_redis/core/reply.hpp>   // for reply
 #include <cpp_redis/misc/error.hpp>   // for redis_error
 #include <future>                     // for future
+#include <mutex>                      // for lock_guard, unique_lock, mutex
 #include <ostream>                    // for operator<<, basic_ostream, size_t
+#include <thread>                     // for thread
 #include <unordered_map>              // for _Node_iterator, unordered_map
 #include <utility>                    // for move, pair
 #include <vector>                     // for vector
@@ -40,10 +44,77 @@ class StaticRuleStore;
 namespace magma {
 namespace lte {
 
+// Leading byte identifying a binary-serialized session vector; the JSON
+// format always starts with '['
+static constexpr uint8_t SESSION_VEC_BINARY_MAGIC   = 0xBE;
+static constexpr uint8_t SESSION_VEC_BINARY_VERSION = 1;
+
+// Leading byte identifying a zstd-compressed blob wrapping either inner
+// serialization; followed by a version byte, the 4-byte little-endian
+// uncompressed length and the zstd frame itself
+static constexpr uint8_t SESSION_VEC_ZSTD_MAGIC   = 0xBD;
+static constexpr uint8_t SESSION_VEC_ZSTD_VERSION = 1;
+
+// Session blobs are small and highly repetitive, so a mid-range level
+// already gets most of the ratio without measurable CPU on the write path
+static constexpr int SESSION_VEC_ZSTD_LEVEL = 9;
+
+bool RedisStoreClient::WRITE_BEHIND                = false;
+uint32_t RedisStoreClient::WRITE_BEHIND_MAX_PENDING = 1024;
+
 RedisStoreClient::RedisStoreClient(
     std::shared_ptr<cpp_redis::client> client, const std::string& redis_table,
-    std::shared_ptr<StaticRuleStore> rule_store)
-    : client_(client), redis_table_(redis_table), rule_store_(rule_store) {}
+    std::shared_ptr<StaticRuleStore> rule_store, bool serialize_as_binary,
+    bool compress_sessions, const std::string& compression_dict_path)
+    : client_(client),
+      redis_table_(redis_table),
+      rule_store_(rule_store),
+      serialize_as_binary_(serialize_as_binary),
+      compress_sessions_(compress_sessions),
+      compression_cdict_(nullptr),
+      compression_ddict_(nullptr),
+      flusher_running_(false),
+      flush_in_flight_(false),
+      shutdown_(false) {
+  if (compression_dict_path.empty()) {
+    return;
+  }
+  std::ifstream dict_file(compression_dict_path, std::ios::binary);
+  if (!dict_file) {
+    MLOG(MERROR) << "Could not open compression dictionary "
+                 << compression_dict_path << ", using plain zstd frames";
+    return;
+  }
+  std::string dict(
+      (std::istreambuf_iterator<char>(dict_file)),
+      std::istreambuf_iterator<char>());
+  compression_cdict_ =
+      ZSTD_createCDict(dict.data(), dict.size(), SESSION_VEC_ZSTD_LEVEL);
+  compression_ddict_ = ZSTD_createDDict(dict.data(), dict.size());
+  if (compression_cdict_ && compression_ddict_) {
+    MLOG(MINFO) << "Loaded session compression dictionary "
+                << compression_dict_path << " (id "
+                << ZSTD_getDictID_fromDDict(
+                       static_cast<ZSTD_DDict*>(compression_ddict_))
+                << ")";
+  } else {
+    MLOG(MERROR) << "Invalid compression dictionary " << compression_dict_path
+                 << ", using plain zstd frames";
+  }
+}
+
+RedisStoreClient::~RedisStoreClient() {
+  {
+    std::lock_guard<std::mutex> lock(journal_lock_);
+    shutdown_ = true;
+  }
+  journal_cv_.notify_one();
+  if (flusher_.joinable()) {
+    flusher_.join();
+  }
+  ZSTD_freeCDict(static_cast<ZSTD_CDict*>(compression_cdict_));
+  ZSTD_freeDDict(static_cast<ZSTD_DDict*>(compression_ddict_));
+}
 
 bool RedisStoreClient::try_redis_connect() {
   ServiceConfigLoader loader;
@@ -79,25 +150,48 @@ SessionMap RedisStoreClient::read_sessions(
     }
   }
 
-  std::unordered_map<std::string, std::future<cpp_redis::reply>> futures;
-  for (const std::string& key : subscriber_ids) {
-    futures[key] = client_->hget(redis_table_, key);
+  if (subscriber_ids.empty()) {
+    return SessionMap{};
   }
 
+  // Bulk-read all subscribers in a single HMGET (plus one MGET for pending
+  // delta records), so resolving a SessionRead set of N IMSIs costs O(1)
+  // round trips regardless of N. This matters most when RestartHandler
+  // re-syncs tens of thousands of sessions after a restart.
+  std::vector<std::string> keys(subscriber_ids.begin(), subscriber_ids.end());
+  std::vector<std::string> delta_keys;
+  delta_keys.reserve(keys.size());
+  for (const std::string& key : keys) {
+    delta_keys.push_back(delta_key(key));
+  }
+  auto hmget_future = client_->hmget(redis_table_, keys);
+  auto mget_future  = client_->mget(delta_keys);
+
   client_->sync_commit();
 
+  auto reply       = hmget_future.get();
+  auto delta_reply = mget_future.get();
+  if (reply.is_error() || !reply.is_array()) {
+    MLOG(MERROR) << "RedisStoreClient: Unable to bulk-read sessions";
+    throw RedisReadFailed();
+  }
+  auto values       = reply.as_array();
+  bool deltas_valid = !delta_reply.is_error() && delta_reply.is_array();
+
   SessionMap session_map;
-  for (const std::string& key : subscriber_ids) {
-    auto reply = futures[key].get();
-    if (reply.is_error()) {
-      MLOG(MERROR) << "RedisStoreClient: Unable to get value for key " << key;
-      throw RedisReadFailed();
-    }
-    if (reply.is_null() || !reply.is_string()) {
+  for (size_t i = 0; i < keys.size(); i++) {
+    const std::string& key = keys[i];
+    if (i >= values.size() || values[i].is_null() || !values[i].is_string()) {
       // value just doesn't exist
       session_map[key] = SessionVector{};
     } else {
-      session_map[key] = std::move(deserialize_session_vec(reply.as_string()));
+      session_map[key] =
+          std::move(deserialize_session_vec(values[i].as_string()));
+      if (deltas_valid && i < delta_reply.as_array().size() &&
+          delta_reply.as_array()[i].is_string()) {
+        apply_session_deltas(
+            session_map[key], delta_reply.as_array()[i].as_string());
+      }
     }
   }
   return session_map;
@@ -136,10 +230,115 @@ SessionMap RedisStoreClient::read_all_sessions() {
           std::move(deserialize_session_vec(value_reply.as_string()));
     }
   }
+
+  // Replay any pending delta records on top of the deserialized sessions,
+  // fetched with a single MGET round trip
+  std::vector<std::string> imsis;
+  std::vector<std::string> delta_keys;
+  for (auto& it : session_map) {
+    imsis.push_back(it.first);
+    delta_keys.push_back(delta_key(it.first));
+  }
+  if (imsis.empty()) {
+    return session_map;
+  }
+  auto mget_future = client_->mget(delta_keys);
+  client_->sync_commit();
+  auto delta_reply = mget_future.get();
+  if (!delta_reply.is_error() && delta_reply.is_array()) {
+    auto deltas = delta_reply.as_array();
+    for (size_t i = 0; i < imsis.size() && i < deltas.size(); i++) {
+      if (deltas[i].is_string()) {
+        apply_session_deltas(session_map[imsis[i]], deltas[i].as_string());
+      }
+    }
+  }
   return session_map;
 }
 
 bool RedisStoreClient::write_sessions(SessionMap session_map) {
+  if (!WRITE_BEHIND) {
+    return commit_sessions(std::move(session_map));
+  }
+  // Termination writes delete state that must not be resurrected by a crash,
+  // so they take the synchronous-flush escape hatch below
+  bool has_termination = false;
+  for (auto& it : session_map) {
+    if (it.second.empty()) {
+      has_termination = true;
+      break;
+    }
+  }
+  enqueue_write_behind(std::move(session_map));
+  if (has_termination) {
+    flush_write_behind_journal();
+  }
+  return true;
+}
+
+void RedisStoreClient::enqueue_write_behind(SessionMap session_map) {
+  std::unique_lock<std::mutex> lock(journal_lock_);
+  if (!flusher_running_) {
+    flusher_running_ = true;
+    flusher_         = std::thread([this]() { write_behind_loop(); });
+  }
+  // Bounded-lag watermark: once the journal backs up this far, callers wait
+  // for the flusher rather than growing the lag without limit
+  journal_drained_cv_.wait(lock, [this]() {
+    return journal_.size() < WRITE_BEHIND_MAX_PENDING;
+  });
+  for (auto& it : session_map) {
+    // A later write for the same subscriber supersedes the journaled one
+    journal_[it.first] = std::move(it.second);
+  }
+  journal_cv_.notify_one();
+}
+
+void RedisStoreClient::write_behind_loop() {
+  std::unique_lock<std::mutex> lock(journal_lock_);
+  while (true) {
+    journal_cv_.wait(
+        lock, [this]() { return shutdown_ || !journal_.empty(); });
+    if (journal_.empty()) {
+      return;  // shutdown with nothing left to flush
+    }
+    SessionMap batch;
+    for (auto& it : journal_) {
+      batch[it.first] = std::move(it.second);
+    }
+    journal_.clear();
+    flush_in_flight_ = true;
+    lock.unlock();
+    journal_drained_cv_.notify_all();
+
+    bool success = false;
+    try {
+      success = commit_sessions(std::move(batch));
+    } catch (std::exception const& e) {
+      MLOG(MERROR) << "Exception " << e.what()
+                   << " during write-behind flush to Redis";
+    }
+    if (!success) {
+      MLOG(MERROR) << "Write-behind flush to Redis failed";
+    }
+
+    lock.lock();
+    flush_in_flight_ = false;
+    journal_drained_cv_.notify_all();
+  }
+}
+
+void RedisStoreClient::flush_write_behind_journal() {
+  std::unique_lock<std::mutex> lock(journal_lock_);
+  if (!flusher_running_) {
+    return;
+  }
+  journal_cv_.notify_one();
+  journal_drained_cv_.wait(
+      lock, [this]() { return journal_.empty() && !flush_in_flight_; });
+}
+
+bool RedisStoreClient::commit_sessions(SessionMap session_map) {
   // Writes should happen via a transaction, otherwise the state inside in
   // Redis may not be recoverable or consistent.
   // For reference, see https://redis.io/topics/transactions
@@ -167,7 +366,15 @@ bool RedisStoreClient::write_sessions(SessionMap session_map) {
   // Queue up HSET commands after we've set up some sort of safety
   // guarantees.
   std::vector<std::string> keys_to_delete;
+  std::vector<std::string> delta_keys_to_delete;
+  {
+    std::lock_guard<std::mutex> lock(journal_lock_);
+    for (auto& it : session_map) {
+      delta_write_counts_.erase(it.first);
+    }
+  }
   for (auto& it : session_map) {
+    delta_keys_to_delete.push_back(delta_key(it.first));
     if (it.second.empty()) {
       // if session is empty we shouldn't write back this subs anymore
       keys_to_delete.push_back(it.first);
@@ -178,6 +385,11 @@ bool RedisStoreClient::write_sessions(SessionMap session_map) {
   if (!keys_to_delete.empty()) {
     client_->hdel(redis_table_, keys_to_delete);
   }
+  if (!delta_keys_to_delete.empty()) {
+    // A full write compacts the sessions, so pending deltas must not be
+    // replayed on top of the fresh blobs
+    client_->del(delta_keys_to_delete);
+  }
   auto exec_future = client_->exec();
   client_->sync_commit();
 
@@ -189,20 +401,325 @@ bool RedisStoreClient::write_sessions(SessionMap session_map) {
   return true;
 }
 
+// Maximum number of delta records appended per subscriber before a full
+// write is forced to compact them
+static constexpr uint32_t kMaxPendingDeltaWrites = 128;
+
+static bool is_delta_only_update(const SessionStateUpdateCriteria& uc) {
+  return !uc.is_session_ended && !uc.is_config_updated && !uc.is_fsm_updated &&
+         !uc.is_current_version_updated &&
+         !uc.is_pending_event_triggers_updated &&
+         !uc.is_session_level_key_updated && !uc.is_bearer_mapping_updated &&
+         !uc.clear_pdr_list && uc.updated_pdp_end_time == 0 &&
+         uc.static_rules_to_install.empty() &&
+         uc.static_rules_to_uninstall.empty() &&
+         uc.new_scheduled_static_rules.empty() &&
+         uc.dynamic_rules_to_install.empty() &&
+         uc.gy_dynamic_rules_to_install.empty() &&
+         uc.dynamic_rules_to_uninstall.empty() &&
+         uc.gy_dynamic_rules_to_uninstall.empty() &&
+         uc.new_scheduled_dynamic_rules.empty() && uc.pdrs_to_install.empty() &&
+         uc.new_rule_lifetimes.empty() &&
+         uc.charging_credit_to_install.empty() &&
+         uc.monitor_credit_to_install.empty();
+}
+
+static std::string serialize_session_delta_record(
+    const std::string& session_id, const SessionStateUpdateCriteria& uc) {
+  folly::dynamic marshaled      = folly::dynamic::object;
+  marshaled["session_id"]       = session_id;
+  marshaled["request_number_increment"] =
+      std::to_string(uc.request_number_increment);
+
+  folly::dynamic charging_keys = folly::dynamic::array;
+  folly::dynamic charging_map  = folly::dynamic::object;
+  for (const auto& credit_pair : uc.charging_credit_map) {
+    const CreditKey& credit_key = credit_pair.first;
+    folly::dynamic key          = folly::dynamic::object;
+    key["rating_group"]         = std::to_string(credit_key.rating_group);
+    key["service_identifier"]   = std::to_string(credit_key.service_identifier);
+    charging_keys.push_back(key);
+
+    std::string map_key = std::to_string(credit_key.rating_group) + ":" +
+                          std::to_string(credit_key.service_identifier);
+    charging_map[map_key] =
+        serialize_session_credit_update_criteria(credit_pair.second);
+  }
+  marshaled["charging_keys"] = charging_keys;
+  marshaled["charging_map"]  = charging_map;
+
+  folly::dynamic monitor_keys = folly::dynamic::array;
+  folly::dynamic monitor_map  = folly::dynamic::object;
+  for (const auto& monitor_pair : uc.monitor_credit_map) {
+    monitor_keys.push_back(monitor_pair.first);
+    monitor_map[monitor_pair.first] =
+        serialize_session_credit_update_criteria(monitor_pair.second);
+  }
+  marshaled["monitor_keys"] = monitor_keys;
+  marshaled["monitor_map"]  = monitor_map;
+
+  if (uc.policy_version_and_stats) {
+    marshaled["policy_version_and_stats"] =
+        serialize_policy_stats_map(*uc.policy_version_and_stats);
+  }
+
+  std::string serialized = folly::toJson(marshaled);
+  return serialized;
+}
+
+bool RedisStoreClient::write_session_updates(
+    SessionMap& session_map, const SessionUpdate& update_criteria) {
+  if (!client_->is_connected()) {
+    auto connected = try_redis_connect();
+    if (!connected) {
+      throw RedisWriteFailed();
+    }
+  }
+
+  SessionMap full_write_map;
+  for (auto& it : session_map) {
+    const std::string& imsi = it.first;
+    auto criteria_it        = update_criteria.find(imsi);
+    bool delta_only = !it.second.empty() && criteria_it != update_criteria.end();
+    if (delta_only) {
+      for (const auto& session_pair : criteria_it->second) {
+        if (!is_delta_only_update(session_pair.second)) {
+          delta_only = false;
+          break;
+        }
+      }
+    }
+    if (delta_only) {
+      std::lock_guard<std::mutex> lock(journal_lock_);
+      if (delta_write_counts_[imsi] >= kMaxPendingDeltaWrites) {
+        // Bound delta replay cost on reads by periodically compacting with
+        // a full write
+        delta_only = false;
+      }
+    }
+    if (!delta_only) {
+      full_write_map[imsi] = std::move(it.second);
+      continue;
+    }
+
+    std::string payload;
+    for (const auto& session_pair : criteria_it->second) {
+      payload +=
+          serialize_session_delta_record(
+              session_pair.first, session_pair.second) +
+          "\n";
+    }
+    client_->append(delta_key(imsi), payload);
+    {
+      std::lock_guard<std::mutex> lock(journal_lock_);
+      delta_write_counts_[imsi]++;
+    }
+  }
+  client_->sync_commit();
+
+  if (full_write_map.empty()) {
+    return true;
+  }
+  return write_sessions(std::move(full_write_map));
+}
+
+std::string RedisStoreClient::delta_key(const std::string& subscriber_id) {
+  return redis_table_ + ":delta:" + subscriber_id;
+}
+
+void RedisStoreClient::apply_session_deltas(
+    SessionVector& session_vec, const std::string& serialized_deltas) {
+  size_t start = 0;
+  while (start < serialized_deltas.size()) {
+    size_t end = serialized_deltas.find('\n', start);
+    if (end == std::string::npos) {
+      end = serialized_deltas.size();
+    }
+    std::string record = serialized_deltas.substr(start, end - start);
+    start              = end + 1;
+    if (record.empty()) {
+      continue;
+    }
+    try {
+      folly::dynamic marshaled = folly::parseJson(folly::StringPiece(record));
+      const std::string session_id = marshaled["session_id"].getString();
+
+      auto uc = get_default_update_criteria();
+      for (auto& key : marshaled["charging_keys"]) {
+        auto credit_key = CreditKey(
+            static_cast<uint32_t>(std::stoul(key["rating_group"].getString())),
+            static_cast<uint32_t>(
+                std::stoul(key["service_identifier"].getString())));
+        std::string map_key = key["rating_group"].getString() + ":" +
+                              key["service_identifier"].getString();
+        uc.charging_credit_map[credit_key] =
+            deserialize_session_credit_update_criteria(
+                marshaled["charging_map"][map_key].getString());
+      }
+      for (auto& key : marshaled["monitor_keys"]) {
+        uc.monitor_credit_map[key.getString()] =
+            deserialize_session_credit_update_criteria(
+                marshaled["monitor_map"][key].getString());
+      }
+      if (marshaled.find("policy_version_and_stats") != marshaled.items().end()) {
+        std::string serialized_stats =
+            marshaled["policy_version_and_stats"].getString();
+        uc.policy_version_and_stats =
+            deserialize_policy_stats_map(serialized_stats);
+      }
+
+      for (auto& session : session_vec) {
+        if (session->get_session_id() == session_id) {
+          session->apply_update_criteria(uc);
+          auto request_number_increment = static_cast<uint32_t>(
+              std::stoul(marshaled["request_number_increment"].getString()));
+          if (request_number_increment > 0) {
+            session->increment_request_number(request_number_increment);
+          }
+          break;
+        }
+      }
+    } catch (std::exception const& e) {
+      MLOG(MERROR) << "Exception " << e.what()
+                   << " applying serialized session delta, skipping record";
+    }
+  }
+}
+
+std::string RedisStoreClient::compress_blob(const std::string& serialized) {
+  std::string blob;
+  blob.reserve(6 + ZSTD_compressBound(serialized.size()));
+  blob.push_back(static_cast<char>(SESSION_VEC_ZSTD_MAGIC));
+  blob.push_back(static_cast<char>(SESSION_VEC_ZSTD_VERSION));
+  uint32_t raw_length = serialized.size();
+  for (int i = 0; i < 4; i++) {
+    blob.push_back(static_cast<char>((raw_length >> (8 * i)) & 0xff));
+  }
+
+  size_t bound = ZSTD_compressBound(serialized.size());
+  std::string frame(bound, '\0');
+  ZSTD_CCtx* cctx = ZSTD_createCCtx();
+  size_t written;
+  if (compression_cdict_) {
+    written = ZSTD_compress_usingCDict(
+        cctx, &frame[0], bound, serialized.data(), serialized.size(),
+        static_cast<ZSTD_CDict*>(compression_cdict_));
+  } else {
+    written = ZSTD_compressCCtx(
+        cctx, &frame[0], bound, serialized.data(), serialized.size(),
+        SESSION_VEC_ZSTD_LEVEL);
+  }
+  ZSTD_freeCCtx(cctx);
+  if (ZSTD_isError(written)) {
+    MLOG(MERROR) << "zstd compression failed: "
+                 << ZSTD_getErrorName(written)
+                 << ", writing the blob uncompressed";
+    return serialized;
+  }
+  frame.resize(written);
+  blob.append(frame);
+  return blob;
+}
+
+std::string RedisStoreClient::decompress_blob(const std::string& blob) {
+  if (blob.size() < 6 ||
+      static_cast<uint8_t>(blob[0]) != SESSION_VEC_ZSTD_MAGIC) {
+    return blob;
+  }
+  uint32_t raw_length = 0;
+  for (int i = 0; i < 4; i++) {
+    raw_length |= static_cast<uint32_t>(static_cast<uint8_t>(blob[2 + i]))
+                  << (8 * i);
+  }
+  std::string serialized(raw_length, '\0');
+  ZSTD_DCtx* dctx = ZSTD_createDCtx();
+  size_t written;
+  if (compression_ddict_) {
+    written = ZSTD_decompress_usingDDict(
+        dctx, &serialized[0], raw_length, blob.data() + 6, blob.size() - 6,
+        static_cast<ZSTD_DDict*>(compression_ddict_));
+  } else {
+    written = ZSTD_decompressDCtx(
+        dctx, &serialized[0], raw_length, blob.data() + 6, blob.size() - 6);
+  }
+  ZSTD_freeDCtx(dctx);
+  if (ZSTD_isError(written) || written != raw_length) {
+    // Wrong or missing dictionary, or a truncated frame; surfaced like any
+    // other undecodable record so the session is rebuilt from signaling
+    MLOG(MERROR) << "zstd decompression failed: "
+                 << (ZSTD_isError(written) ? ZSTD_getErrorName(written)
+                                           : "short output");
+    return "";
+  }
+  return serialized;
+}
+
 std::string RedisStoreClient::serialize_session_vec(
     SessionVector& session_vec) {
+  if (serialize_as_binary_) {
+    std::string serialized;
+    serialized.push_back(static_cast<char>(SESSION_VEC_BINARY_MAGIC));
+    serialized.push_back(static_cast<char>(SESSION_VEC_BINARY_VERSION));
+    uint32_t count = session_vec.size();
+    for (int i = 0; i < 4; i++) {
+      serialized.push_back(static_cast<char>((count >> (8 * i)) & 0xff));
+    }
+    for (auto& session_ptr : session_vec) {
+      auto stored_session = session_ptr->marshal();
+      std::string session = serialize_stored_session_binary(stored_session);
+      uint32_t length     = session.size();
+      for (int i = 0; i < 4; i++) {
+        serialized.push_back(static_cast<char>((length >> (8 * i)) & 0xff));
+      }
+      serialized.append(session);
+    }
+    return compress_sessions_ ? compress_blob(serialized) : serialized;
+  }
   folly::dynamic marshaled = folly::dynamic::array;
   for (auto& session_ptr : session_vec) {
     auto stored_session = session_ptr->marshal();
     marshaled.push_back(serialize_stored_session(stored_session));
   }
   std::string serialized = folly::toJson(marshaled);
-  return serialized;
+  return compress_sessions_ ? compress_blob(serialized) : serialized;
 }
 
 SessionVector RedisStoreClient::deserialize_session_vec(
     std::string serialized) {
   SessionVector session_vec;
+  // Unwrap compressed blobs first; the inner serialization is then
+  // format-detected as usual. Reads never depend on compress_sessions_, so
+  // mixed stores deserialize correctly while the flag is being rolled out
+  serialized = decompress_blob(serialized);
+  if (!serialized.empty() &&
+      static_cast<uint8_t>(serialized[0]) == SESSION_VEC_BINARY_MAGIC) {
+    try {
+      size_t offset   = 2;  // skip magic and version
+      uint32_t count  = 0;
+      for (int i = 0; i < 4; i++) {
+        count |= static_cast<uint32_t>(
+                     static_cast<uint8_t>(serialized.at(offset++)))
+                 << (8 * i);
+      }
+      for (uint32_t s = 0; s < count; s++) {
+        uint32_t length = 0;
+        for (int i = 0; i < 4; i++) {
+          length |= static_cast<uint32_t>(
+                        static_cast<uint8_t>(serialized.at(offset++)))
+                    << (8 * i);
+        }
+        std::string session = serialized.substr(offset, length);
+        offset += length;
+        auto stored_session = deserialize_stored_session(session);
+        session_vec.push_back(
+            SessionState::unmarshal(stored_session, *rule_store_));
+      }
+    } catch (std::exception const& e) {
+      MLOG(MERROR) << "Exception " << e.what()
+                   << " parsing binary serialized states";
+    }
+    return session_vec;
+  }
   auto folly_serialized = folly::StringPiece(serialized);
   try {
     folly::dynamic marshaled = folly::parseJson(folly_serialized);
@@ -14,11 +14,15 @@
 #pragma once
 
 #include <cpp_redis/cpp_redis>
-#include <exception>      // IWYU pragma: keep
-#include <memory>         // for shared_ptr
-#include <set>            // for set
-#include <string>         // for string
-#include "StoreClient.h"  // for SessionMap, SessionVector, StoreClient
+#include <condition_variable>  // for condition_variable
+#include <exception>           // IWYU pragma: keep
+#include <memory>              // for shared_ptr
+#include <mutex>               // for mutex
+#include <set>                 // for set
+#include <string>              // for string
+#include <thread>              // for thread
+#include <unordered_map>       // for unordered_map
+#include "StoreClient.h"       // for SessionMap, SessionVector, StoreClient
 namespace magma {
 class StaticRuleStore;
 }
@@ -41,13 +45,23 @@ class RedisWriteFailed : public std::exception {
  */
 class RedisStoreClient final : public StoreClient {
  public:
+  // When true, write_sessions appends to an in-memory journal drained by a
+  // dedicated flusher thread, so a slow Redis commit does not stall the
+  // gRPC handler. Termination writes still flush synchronously.
+  static bool WRITE_BEHIND;
+  // Maximum subscribers allowed in the write-behind journal before
+  // write_sessions blocks until the flusher catches up
+  static uint32_t WRITE_BEHIND_MAX_PENDING;
+
   RedisStoreClient(
       std::shared_ptr<cpp_redis::client> client, const std::string& redis_table,
-      std::shared_ptr<StaticRuleStore> rule_store);
+      std::shared_ptr<StaticRuleStore> rule_store,
+      bool serialize_as_binary = false, bool compress_sessions = false,
+      const std::string& compression_dict_path = "");
 
   RedisStoreClient(RedisStoreClient const&) = delete;
-  RedisStoreClient(RedisStoreClient&&)      = default;
-  ~RedisStoreClient()                       = default;
+  RedisStoreClient(RedisStoreClient&&)      = delete;
+  ~RedisStoreClient();
 
   bool try_redis_connect();
 
@@ -59,15 +73,81 @@ class RedisStoreClient final : public StoreClient {
 
   bool write_sessions(SessionMap session_map);
 
+  /**
+   * Write back sessions, persisting delta-only updates as compact
+   * update-criteria records appended to a per-subscriber delta key, instead
+   * of re-serializing the full session vector. Subscribers with structural
+   * updates (rule changes, config changes, terminations, etc.) fall back to
+   * a full write, which also compacts away any pending deltas.
+   */
+  bool write_session_updates(
+      SessionMap& session_map, const SessionUpdate& update_criteria);
+
+  /**
+   * Block until the write-behind journal has been fully committed to Redis.
+   * No-op when write-behind is disabled or nothing is pending.
+   */
+  void flush_write_behind_journal();
+
  private:
   std::shared_ptr<cpp_redis::client> client_;
   std::string redis_table_;
   std::shared_ptr<StaticRuleStore> rule_store_;
+  // When set, sessions are written with the compact binary codec instead of
+  // JSON. Reads auto-detect the stored format, so the flag can be flipped
+  // without a state migration.
+  bool serialize_as_binary_;
+  // When set, serialized session vectors are wrapped in a zstd frame before
+  // the Redis write, optionally against a pre-trained dictionary. Reads
+  // auto-detect compressed blobs by their codec tag, so this too can be
+  // flipped without a state migration.
+  bool compress_sessions_;
+  // Pre-trained dictionary shared by all compressed blobs; null when no
+  // dictionary was configured (plain zstd frames). The dictionary id zstd
+  // embeds in every frame guards against decompressing with the wrong one.
+  void* compression_cdict_;
+  void* compression_ddict_;
+  // Number of delta records appended per subscriber since the last full
+  // write, used to bound how much replay work reads have to do. Guarded by
+  // journal_lock_ since the flusher thread compacts it on full writes.
+  std::unordered_map<std::string, uint32_t> delta_write_counts_;
+  // Write-behind journal of the latest pending session vector per
+  // subscriber; later writes for a subscriber supersede earlier ones
+  std::mutex journal_lock_;
+  std::condition_variable journal_cv_;
+  std::condition_variable journal_drained_cv_;
+  std::unordered_map<std::string, SessionVector> journal_;
+  std::thread flusher_;
+  bool flusher_running_;
+  bool flush_in_flight_;
+  bool shutdown_;
 
  private:
+  /**
+   * Commit the given sessions to Redis in a single WATCH/MULTI/EXEC
+   * transaction. This is the synchronous tail of write_sessions; the
+   * write-behind flusher calls it off the handler threads.
+   */
+  bool commit_sessions(SessionMap session_map);
+
+  void enqueue_write_behind(SessionMap session_map);
+
+  void write_behind_loop();
+
   std::string serialize_session_vec(SessionVector& session_vec);
 
+  // Wrap serialized in a tagged zstd frame / unwrap a tagged frame back to
+  // the inner serialization. decompress_blob returns the input unchanged
+  // when the blob does not carry the compression tag.
+  std::string compress_blob(const std::string& serialized);
+  std::string decompress_blob(const std::string& blob);
+
   SessionVector deserialize_session_vec(std::string serialized);
+
+  std::string delta_key(const std::string& subscriber_id);
+
+  void apply_session_deltas(
+      SessionVector& session_vec, const std::string& serialized_deltas);
 };
 
 }  // namespace lte
@@ -23,8 +23,9 @@
 namespace magma {
 namespace sessiond {
 
-const uint RestartHandler::max_cleanup_retries_  = 3;
-const uint RestartHandler::rpc_retry_interval_s_ = 5;
+const uint RestartHandler::max_cleanup_retries_        = 3;
+const uint RestartHandler::rpc_retry_interval_s_       = 5;
+const uint RestartHandler::max_terminations_in_flight_ = 64;
 
 RestartHandler::RestartHandler(
     std::shared_ptr<DirectorydClient> directoryd_client,
@@ -46,7 +47,7 @@ void RestartHandler::cleanup_previous_sessions() {
     return;
   }
 
-  bool all_terminated = launch_threads_to_terminate_with_retries();
+  bool all_terminated = terminate_with_retries();
   if (all_terminated) {
     MLOG(MINFO) << "Successfully terminated all old sessions";
   } else {
@@ -59,12 +60,9 @@ void RestartHandler::setup_aaa_sessions() {
   aaa_client_->add_sessions(session_map);
 }
 
-// For each session that still need to be terminated, launch a thread to
-// run terminate_previous_session. Retry up to max_cleanup_retries_, with
-// sleeps in between.
-// We must lock access to sessions_to_terminate while iterating and launching
-// threads, so that elements are not removed during iteration.
-bool RestartHandler::launch_threads_to_terminate_with_retries() {
+// Sweep all sessions that still need to be terminated. Retry up to
+// max_cleanup_retries_, with sleeps in between.
+bool RestartHandler::terminate_with_retries() {
   if (sessions_to_terminate_.empty()) {
     return true;
   }
@@ -72,29 +70,11 @@ bool RestartHandler::launch_threads_to_terminate_with_retries() {
   uint termination_try = 0;
   while (!sessions_to_terminate_.empty() &&
          termination_try < max_cleanup_retries_) {
-    std::vector<std::future<void>> termination_futures;
-    {
-      // Modify sessions_to_terminate_
-      std::lock_guard<std::mutex> map_guard(sessions_to_terminate_lock_);
-
-      for (const auto& iter : sessions_to_terminate_) {
-        termination_futures.push_back(std::async(
-            std::launch::async,
-            &magma::sessiond::RestartHandler::terminate_previous_session, this,
-            iter.first, iter.second));
-      }
-      // sessions_to_terminate_lock_ released
-    }
-
+    run_termination_sweep();
     termination_try++;
-    // Retrieve all thread results
-    for (auto&& fut : termination_futures) {
-      fut.get();
-    }
-    termination_futures.clear();
 
     // Check whether all sessions have successfully terminated before sleeping
-    // There are no active terminate threads, so no locking is necessary.
+    // There are no in-flight terminations, so no locking is necessary.
     if (sessions_to_terminate_.empty()) {
       return true;
     }
@@ -104,6 +84,60 @@ bool RestartHandler::launch_threads_to_terminate_with_retries() {
   return false;
 }
 
+// Terminate a snapshot of the remaining sessions with up to
+// max_terminations_in_flight_ concurrent RPC chains instead of one blocking
+// thread per session; each completion launches the next pending session.
+// Blocks until every session in the snapshot has been attempted once.
+void RestartHandler::run_termination_sweep() {
+  auto sweep = std::make_shared<TerminationSweepState>();
+  {
+    std::lock_guard<std::mutex> map_guard(sessions_to_terminate_lock_);
+    sweep->pending.assign(
+        sessions_to_terminate_.begin(), sessions_to_terminate_.end());
+  }
+  if (sweep->pending.empty()) {
+    return;
+  }
+  std::future<void> sweep_done = sweep->done.get_future();
+  std::vector<std::pair<std::string, std::string>> to_launch;
+  {
+    std::lock_guard<std::mutex> sweep_guard(sweep->lock);
+    while (sweep->in_flight < max_terminations_in_flight_ &&
+           sweep->next < sweep->pending.size()) {
+      to_launch.push_back(sweep->pending[sweep->next++]);
+      sweep->in_flight++;
+    }
+  }
+  // Launch outside the sweep lock so a client that completes inline cannot
+  // deadlock against on_sweep_request_done
+  for (const auto& entry : to_launch) {
+    terminate_previous_session(sweep, entry.first, entry.second);
+  }
+  sweep_done.get();
+}
+
+// Called on the RPC response threads whenever one termination chain
+// finishes, successfully or not: refill the in-flight window and fulfill
+// the sweep promise once the last chain completes.
+void RestartHandler::on_sweep_request_done(
+    std::shared_ptr<TerminationSweepState> sweep) {
+  const std::pair<std::string, std::string>* entry = nullptr;
+  {
+    std::lock_guard<std::mutex> sweep_guard(sweep->lock);
+    sweep->in_flight--;
+    if (sweep->next < sweep->pending.size()) {
+      entry = &sweep->pending[sweep->next++];
+      sweep->in_flight++;
+    } else if (sweep->in_flight == 0) {
+      sweep->done.set_value();
+      return;
+    }
+  }
+  if (entry) {
+    terminate_previous_session(sweep, entry->first, entry->second);
+  }
+}
+
 // This function is executed in the main thread before multiple terminate
 // threads are launched. So no locking is necessary here.
 bool RestartHandler::populate_sessions_to_terminate_with_retries() {
@@ -145,47 +179,45 @@ bool RestartHandler::populate_sessions_to_terminate_with_retries() {
 }
 
 void RestartHandler::terminate_previous_session(
-    const std::string& sid, const std::string& session_id) {
+    std::shared_ptr<TerminationSweepState> sweep, const std::string& sid,
+    const std::string& session_id) {
   SessionTerminateRequest term_req;
   term_req.mutable_common_context()->mutable_sid()->set_id(sid);
   term_req.set_session_id(session_id);
-  std::promise<bool> termination_res;
-  std::future<bool> termination_future = termination_res.get_future();
   (*reporter_)
       .report_terminate_session(
           term_req,
-          [this, &termination_res, sid, session_id](
+          [this, sweep, sid, session_id](
               Status status, const SessionTerminateResponse& response) {
             if (!status.ok()) {
               MLOG(MERROR) << "CCR-T cleanup for subscriber " << sid
                            << ", session id: " << session_id << " failed";
-              termination_res.set_value(false);
+              on_sweep_request_done(sweep);
               return;
             }
             DeleteRecordRequest del_request;
             del_request.set_id(response.sid());
             directoryd_client_->delete_directoryd_record(
-                del_request, [this, &del_request, &termination_res, sid](
-                                 Status status, const Void&) {
+                del_request,
+                [this, sweep, sid](Status status, const Void&) {
                   if (!status.ok()) {
                     MLOG(MERROR) << "DirectoryD DeleteRecord failed to remove "
                                  << "subscriber " << sid << " from DirectoryD";
-                    termination_res.set_value(false);
+                    on_sweep_request_done(sweep);
                     return;
                   }
                   MLOG(MDEBUG)
                       << "Successfully terminated previous session for "
                       << "subscriber " << sid;
-                  termination_res.set_value(true);
+                  {
+                    std::lock_guard<std::mutex> map_guard(
+                        sessions_to_terminate_lock_);
+                    sessions_to_terminate_.erase(sid);
+                    // sessions_to_terminate_lock_ released
+                  }
+                  on_sweep_request_done(sweep);
                 });
           });
-  // Block until Termination call is complete
-  bool should_erase = termination_future.get();
-  if (should_erase) {
-    std::lock_guard<std::mutex> map_guard(sessions_to_terminate_lock_);
-    sessions_to_terminate_.erase(sid);
-    // sessions_to_terminate_lock_ released
-  }
 }
 }  // namespace sessiond
 }  // namespace magma
@@ -14,8 +14,11 @@
 
 #include <future>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "AAAClient.h"
 #include "DirectorydClient.h"
@@ -47,10 +50,26 @@ class RestartHandler {
   void setup_aaa_sessions();
 
  private:
+  /**
+   * Shared bookkeeping for one termination sweep: the snapshot of sessions
+   * to terminate, a cursor into it, how many terminate RPCs are in flight
+   * and a promise fulfilled once the last one completes.
+   */
+  struct TerminationSweepState {
+    std::vector<std::pair<std::string, std::string>> pending;
+    size_t next      = 0;
+    size_t in_flight = 0;
+    std::mutex lock;
+    std::promise<void> done;
+  };
+
   void terminate_previous_session(
-      const std::string& sid, const std::string& session_id);
+      std::shared_ptr<TerminationSweepState> sweep, const std::string& sid,
+      const std::string& session_id);
+  void on_sweep_request_done(std::shared_ptr<TerminationSweepState> sweep);
+  void run_termination_sweep();
   bool populate_sessions_to_terminate_with_retries();
-  bool launch_threads_to_terminate_with_retries();
+  bool terminate_with_retries();
 
  private:
   std::shared_ptr<DirectorydClient> directoryd_client_;
@@ -63,6 +82,9 @@ class RestartHandler {
   std::unordered_map<std::string, std::string> sessions_to_terminate_;
   static const uint max_cleanup_retries_;
   static const uint rpc_retry_interval_s_;
+  // Upper bound on concurrent terminate RPCs per sweep; keeps the cleanup
+  // pipelined without spawning a thread per stale session
+  static const uint max_terminations_in_flight_;
 };
 }  // namespace sessiond
 }  // namespace magma
@@ -12,6 +12,7 @@
  */
 #include <glog/logging.h>
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -86,6 +87,54 @@ uint32_t PoliciesByKeyMap<KeyType, hash, equal>::policy_count() {
   return count;
 }
 
+// Reclaim expired arena slots at most once per this many interns, bounding
+// both the garbage left behind by departed sessions and the sweep cost paid
+// on the rule-installation path
+static constexpr size_t ARENA_SWEEP_INTERVAL = 4096;
+
+PolicyRuleArena& PolicyRuleArena::instance() {
+  static PolicyRuleArena instance;
+  return instance;
+}
+
+std::shared_ptr<PolicyRule> PolicyRuleArena::intern(const PolicyRule& rule) {
+  std::string def;
+  rule.SerializeToString(&def);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& slot  = rules_by_def_[def];
+  auto rule_p = slot.lock();
+  if (rule_p == nullptr) {
+    rule_p = std::make_shared<PolicyRule>(rule);
+    slot   = rule_p;
+  }
+  if (++interns_since_sweep_ >= ARENA_SWEEP_INTERVAL) {
+    sweep_expired();
+    interns_since_sweep_ = 0;
+  }
+  return rule_p;
+}
+
+size_t PolicyRuleArena::live_definition_count() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t live = 0;
+  for (auto const& kv : rules_by_def_) {
+    if (!kv.second.expired()) {
+      live++;
+    }
+  }
+  return live;
+}
+
+void PolicyRuleArena::sweep_expired() {
+  for (auto it = rules_by_def_.begin(); it != rules_by_def_.end();) {
+    if (it->second.expired()) {
+      it = rules_by_def_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 static bool should_track_charging_key(PolicyRule::TrackingType tracking_type) {
   return tracking_type == PolicyRule::ONLY_OCS ||
          tracking_type == PolicyRule::OCS_AND_PCRF;
@@ -97,6 +146,20 @@ static bool should_track_monitoring_key(
          tracking_type == PolicyRule::OCS_AND_PCRF;
 }
 
+void PolicyRuleBiMap::publish_read_view() {
+  // Readers hold shared_ptr references into the previous view, so the old
+  // map stays alive until the last in-flight lookup drops it
+  auto view = std::make_shared<RulesById>(rules_by_rule_id_);
+  std::atomic_store_explicit(
+      &read_view_, std::shared_ptr<const RulesById>(std::move(view)),
+      std::memory_order_release);
+}
+
+std::shared_ptr<const PolicyRuleBiMap::RulesById>
+PolicyRuleBiMap::get_read_view() {
+  return std::atomic_load_explicit(&read_view_, std::memory_order_acquire);
+}
+
 void PolicyRuleBiMap::sync_rules(const std::vector<PolicyRule>& rules) {
   std::lock_guard<std::mutex> lock(map_mutex_);
   rules_by_rule_id_.clear();
@@ -105,7 +168,7 @@ void PolicyRuleBiMap::sync_rules(const std::vector<PolicyRule>& rules) {
           &ccHash, &ccEqual);
   rules_by_monitoring_key_ = PoliciesByKeyMap<std::string>();
   for (const auto& rule : rules) {
-    auto rule_p                  = std::make_shared<PolicyRule>(rule);
+    auto rule_p                  = PolicyRuleArena::instance().intern(rule);
     rules_by_rule_id_[rule.id()] = rule_p;
     if (should_track_charging_key(rule.tracking_type())) {
       rules_by_charging_key_.insert(CreditKey(rule), rule_p);
@@ -114,10 +177,11 @@ void PolicyRuleBiMap::sync_rules(const std::vector<PolicyRule>& rules) {
       rules_by_monitoring_key_.insert(rule.monitoring_key(), rule_p);
     }
   }
+  publish_read_view();
 }
 
 void PolicyRuleBiMap::insert_rule(const PolicyRule& rule) {
-  auto rule_p = std::make_shared<PolicyRule>(rule);
+  auto rule_p = PolicyRuleArena::instance().intern(rule);
   std::lock_guard<std::mutex> lock(map_mutex_);
   rules_by_rule_id_[rule.id()] = rule_p;
   if (should_track_charging_key(rule.tracking_type())) {
@@ -126,13 +190,14 @@ void PolicyRuleBiMap::insert_rule(const PolicyRule& rule) {
   if (should_track_monitoring_key(rule.tracking_type())) {
     rules_by_monitoring_key_.insert(rule.monitoring_key(), rule_p);
   }
+  publish_read_view();
 }
 
 bool PolicyRuleBiMap::get_rule(
     const std::string& rule_id, PolicyRule* rule_out) {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  auto it = rules_by_rule_id_.find(rule_id);
-  if (it == rules_by_rule_id_.end()) {
+  auto view = get_read_view();
+  auto it   = view->find(rule_id);
+  if (it == view->end()) {
     return false;
   }
   if (rule_out != NULL) {
@@ -144,10 +209,10 @@ bool PolicyRuleBiMap::get_rule(
 bool PolicyRuleBiMap::get_rules_by_ids(
     const std::vector<std::string>& rule_ids,
     std::vector<PolicyRule>& rules_out) {
-  std::lock_guard<std::mutex> lock(map_mutex_);
+  auto view = get_read_view();
   for (const std::string rule_id : rule_ids) {
-    auto it = rules_by_rule_id_.find(rule_id);
-    if (it == rules_by_rule_id_.end()) {
+    auto it = view->find(rule_id);
+    if (it == view->end()) {
       return false;
     }
     rules_out.push_back(*it->second);
@@ -176,15 +241,16 @@ bool PolicyRuleBiMap::remove_rule(
   if (should_track_monitoring_key(rule_ptr->tracking_type())) {
     rules_by_monitoring_key_.remove(rule_ptr->monitoring_key(), rule_ptr);
   }
+  publish_read_view();
 
   return true;
 }
 
 bool PolicyRuleBiMap::get_charging_key_for_rule_id(
     const std::string& rule_id, CreditKey* charging_key) {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  auto it = rules_by_rule_id_.find(rule_id);
-  if (it == rules_by_rule_id_.end()) {
+  auto view = get_read_view();
+  auto it   = view->find(rule_id);
+  if (it == view->end()) {
     return false;
   }
   if (should_track_charging_key(it->second->tracking_type())) {
@@ -196,9 +262,9 @@ bool PolicyRuleBiMap::get_charging_key_for_rule_id(
 
 bool PolicyRuleBiMap::get_monitoring_key_for_rule_id(
     const std::string& rule_id, std::string* monitoring_key) {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  auto it = rules_by_rule_id_.find(rule_id);
-  if (it == rules_by_rule_id_.end() ||
+  auto view = get_read_view();
+  auto it   = view->find(rule_id);
+  if (it == view->end() ||
       !should_track_monitoring_key(it->second->tracking_type())) {
     return false;
   }
@@ -231,16 +297,16 @@ uint32_t PolicyRuleBiMap::monitored_rules_count() {
 }
 
 bool PolicyRuleBiMap::get_rule_ids(std::vector<std::string>& rules_ids_out) {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  for (auto kv : rules_by_rule_id_) {
+  auto view = get_read_view();
+  for (const auto& kv : *view) {
     rules_ids_out.push_back(kv.first);
   }
   return true;
 }
 
 bool PolicyRuleBiMap::get_rules(std::vector<PolicyRule>& rules_out) {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  for (auto kv : rules_by_rule_id_) {
+  auto view = get_read_view();
+  for (const auto& kv : *view) {
     rules_out.push_back(*kv.second);
   }
   return true;
@@ -58,13 +58,61 @@ class PoliciesByKeyMap {
       rules_by_key_;
 };
 
+/**
+ * Process-wide content-addressed arena of PolicyRule definitions. Dynamic
+ * rules instantiated from PCRF templates are byte-identical across
+ * subscribers, yet every per-session DynamicRuleStore used to hold its own
+ * copy of each proto. The arena hands out one canonical shared_ptr per
+ * distinct definition so all stores referencing the same definition share a
+ * single object.
+ *
+ * Entries are held weakly: when the last session referencing a definition
+ * terminates the rule is freed, and the expired slot is reclaimed by a
+ * periodic sweep on the intern path.
+ */
+class PolicyRuleArena {
+ public:
+  static PolicyRuleArena& instance();
+
+  /**
+   * @return the canonical shared rule for this definition, interning a copy
+   * on first sight. Keyed on the serialized proto bytes, so rules differing
+   * in any field get distinct entries.
+   */
+  std::shared_ptr<PolicyRule> intern(const PolicyRule& rule);
+
+  /**
+   * @return the number of live (non-expired) definitions in the arena
+   */
+  size_t live_definition_count();
+
+ private:
+  PolicyRuleArena() {}
+
+  // Erase slots whose definitions are no longer referenced by any store.
+  // Must be called with mutex_ held.
+  void sweep_expired();
+
+  std::mutex mutex_;
+  // serialized definition -> canonical rule object
+  std::unordered_map<std::string, std::weak_ptr<PolicyRule>> rules_by_def_;
+  size_t interns_since_sweep_ = 0;
+};
+
 /**
  * RuleChargingKeyMapper is a class for querying a bi-directional map of
  * rule_id <-> charging_key
  */
 class PolicyRuleBiMap {
  public:
-  PolicyRuleBiMap() : rules_by_charging_key_(&ccHash, &ccEqual) {}
+  // rule_id -> PolicyRule map type shared between the writable state and the
+  // published read view
+  using RulesById =
+      std::unordered_map<std::string, std::shared_ptr<PolicyRule>>;
+
+  PolicyRuleBiMap()
+      : rules_by_charging_key_(&ccHash, &ccEqual),
+        read_view_(std::make_shared<RulesById>()) {}
   /**
    * Clear the maps and add in the given rules
    */
@@ -119,12 +167,29 @@ class PolicyRuleBiMap {
 
   virtual bool get_rules(std::vector<PolicyRule>& rules_out);
 
+ protected:
+  /**
+   * Publish an immutable copy of rules_by_rule_id_ for lock-free readers.
+   * Must be called with map_mutex_ held after any rule-set change.
+   */
+  void publish_read_view();
+
+  /**
+   * @return the current immutable rule snapshot. The snapshot is swapped
+   * wholesale on rule-set changes (RCU-style), so rule lookups on the stats
+   * hot path never take map_mutex_.
+   */
+  std::shared_ptr<const RulesById> get_read_view();
+
  protected:
   // guards all three maps below
   std::mutex map_mutex_;
   // rule_id -> PolicyRule
   std::unordered_map<std::string, std::shared_ptr<PolicyRule>>
       rules_by_rule_id_;
+  // Immutable snapshot of rules_by_rule_id_ swapped atomically on writes;
+  // read through std::atomic_load so lookups never block on map_mutex_
+  std::shared_ptr<const RulesById> read_view_;
   // charging key -> [PolicyRule]
   PoliciesByKeyMap<CreditKey, decltype(&ccHash), decltype(&ccEqual)>
       rules_by_charging_key_;
@@ -12,7 +12,8 @@
  */
 #pragma once
 
-#include <memory>
+#include <string>
+#include <vector>
 
 #include <lte/protos/session_manager.grpc.pb.h>
 #include <experimental/optional>
@@ -35,36 +36,56 @@ enum ServiceActionType {
 /**
  * ServiceAction is the base class for any action that needs to be taken on
  * a subscriber's service. This could be terminate, redirect data, or just
- * continue.
+ * continue. Fields are held by value so an action slot can be reused across
+ * update passes without reallocating.
  */
 class ServiceAction {
  public:
   ServiceAction(ServiceActionType action_type) : action_type_(action_type) {}
 
+  /**
+   * reset re-types the action and clears its fields for reuse. The capacity
+   * of the string fields and rule vectors is retained, so filling a recycled
+   * action does not allocate in steady state.
+   */
+  void reset(ServiceActionType action_type) {
+    action_type_ = action_type;
+    imsi_.clear();
+    session_id_.clear();
+    ip_addr_.clear();
+    ipv6_addr_.clear();
+    msisdn_.clear();
+    teids_.Clear();
+    credit_key_ = CreditKey();
+    ambr_       = {};
+    gx_to_install_.clear();
+    gy_to_install_.clear();
+  }
+
   ServiceActionType get_type() const { return action_type_; }
 
   ServiceAction& set_imsi(const std::string& imsi) {
-    imsi_ = std::make_unique<std::string>(imsi);
+    imsi_ = imsi;
     return *this;
   }
 
   ServiceAction& set_session_id(const std::string& session_id) {
-    session_id_ = std::make_unique<std::string>(session_id);
+    session_id_ = session_id;
     return *this;
   }
 
   ServiceAction& set_ip_addr(const std::string& ip_addr) {
-    ip_addr_ = std::make_unique<std::string>(ip_addr);
+    ip_addr_ = ip_addr;
     return *this;
   }
 
   ServiceAction& set_ipv6_addr(const std::string& ipv6_addr) {
-    ipv6_addr_ = std::make_unique<std::string>(ipv6_addr);
+    ipv6_addr_ = ipv6_addr;
     return *this;
   }
 
   ServiceAction& set_teids(const Teids& teids) {
-    teids_ = std::make_unique<Teids>(teids);
+    teids_ = teids;
     return *this;
   }
 
@@ -79,37 +100,25 @@ class ServiceAction {
   }
 
   ServiceAction& set_msisdn(const std::string& msisdn) {
-    msisdn_ = std::make_unique<std::string>(msisdn);
+    msisdn_ = msisdn;
     return *this;
   }
 
-  /**
-   * get_imsi returns the associated IMSI for the action, or throws a nullptr
-   * exception if there is none stored
-   */
-  const std::string& get_imsi() const { return *imsi_; }
+  const std::string& get_imsi() const { return imsi_; }
 
-  /**
-   * get_imsi returns the associated IMSI for the action, or throws a nullptr
-   * exception if there is none stored
-   */
-  const std::string& get_session_id() const { return *session_id_; }
+  const std::string& get_session_id() const { return session_id_; }
 
-  /**
-   * get_ip_addr returns the associated subscriber's ip_addr for the action,
-   * or throws a nullptr exception if there is none stored
-   */
-  const std::string& get_ip_addr() const { return *ip_addr_; }
+  const std::string& get_ip_addr() const { return ip_addr_; }
 
-  const std::string& get_ipv6_addr() const { return *ipv6_addr_; }
+  const std::string& get_ipv6_addr() const { return ipv6_addr_; }
 
-  const Teids& get_teids() const { return *teids_; }
+  const Teids& get_teids() const { return teids_; }
 
   const CreditKey& get_credit_key() const { return credit_key_; }
 
   const optional<AggregatedMaximumBitrate> get_ambr() const { return ambr_; }
 
-  const std::string& get_msisdn() const { return *msisdn_; }
+  const std::string& get_msisdn() const { return msisdn_; }
 
   // RulesToProcess
   RulesToProcess get_gx_rules_to_install() const { return gx_to_install_; }
@@ -120,16 +129,59 @@ class ServiceAction {
 
  private:
   ServiceActionType action_type_;
-  std::unique_ptr<std::string> imsi_;
-  std::unique_ptr<std::string> session_id_;
-  std::unique_ptr<std::string> ip_addr_;
-  std::unique_ptr<std::string> ipv6_addr_;
-  std::unique_ptr<Teids> teids_;
-  std::unique_ptr<std::string> msisdn_;
+  std::string imsi_;
+  std::string session_id_;
+  std::string ip_addr_;
+  std::string ipv6_addr_;
+  Teids teids_;
+  std::string msisdn_;
   CreditKey credit_key_;
   optional<AggregatedMaximumBitrate> ambr_;
   RulesToProcess gx_to_install_;
   RulesToProcess gy_to_install_;
 };
 
+/**
+ * ServiceActionBatch holds the actions produced by one update pass as a flat
+ * vector of ServiceAction values. clear() releases the actions without
+ * destroying them, so the next pass refills the same slots and steady-state
+ * polling does not allocate per action.
+ */
+class ServiceActionBatch {
+ public:
+  /**
+   * emplace_back returns a fresh action of the given type, reusing a
+   * previously cleared slot when one is available.
+   */
+  ServiceAction& emplace_back(ServiceActionType action_type) {
+    if (used_ < actions_.size()) {
+      actions_[used_].reset(action_type);
+    } else {
+      actions_.emplace_back(action_type);
+    }
+    return actions_[used_++];
+  }
+
+  size_t size() const { return used_; }
+
+  const ServiceAction& operator[](size_t index) const {
+    return actions_[index];
+  }
+
+  std::vector<ServiceAction>::const_iterator begin() const {
+    return actions_.begin();
+  }
+
+  std::vector<ServiceAction>::const_iterator end() const {
+    return actions_.begin() + used_;
+  }
+
+  // Release all actions for reuse; the slots and their capacity are kept
+  void clear() { used_ = 0; }
+
+ private:
+  std::vector<ServiceAction> actions_;
+  size_t used_ = 0;
+};
+
 }  // namespace magma
@@ -41,7 +41,9 @@ SessionCredit::SessionCredit(
       grant_tracking_type_(TRACKING_UNSET),
       report_last_credit_(false),
       time_of_first_usage_(0),
-      time_of_last_usage_(0) {}
+      time_of_last_usage_(0) {
+  update_exhaustion_watermarks();
+}
 
 SessionCredit::SessionCredit(const StoredSessionCredit& marshaled) {
   reporting_              = marshaled.reporting;
@@ -59,6 +61,7 @@ SessionCredit::SessionCredit(const StoredSessionCredit& marshaled) {
       buckets_[bucket] = marshaled.buckets.find(bucket)->second;
     }
   }
+  update_exhaustion_watermarks();
 }
 
 StoredSessionCredit SessionCredit::marshal() const {
@@ -206,6 +209,8 @@ void SessionCredit::receive_credit(
   buckets_[REPORTED_RX] += buckets_[REPORTING_RX];
   buckets_[REPORTED_TX] += buckets_[REPORTING_TX];
 
+  update_exhaustion_watermarks();
+
   if (credit_uc) {
     credit_uc->received_granted_units = gsu;
     credit_uc->grant_tracking_type    = grant_tracking_type_;
@@ -267,20 +272,76 @@ uint64_t SessionCredit::calculate_delta_allowed(
   }
 }
 
+// The exhaustion check for a leg reduces to a single compare against a
+// watermark precomputed on grant receipt (see
+// calculate_exhaustion_watermark); the arithmetic fallback only runs for
+// ad-hoc thresholds that were not precomputed.
+uint64_t SessionCredit::calculate_exhaustion_watermark(
+    Bucket allowed, Bucket floor, float threshold) const {
+  const uint64_t allowed_v = buckets_[allowed];
+  const uint64_t floor_v   = buckets_[floor];
+  if (floor_v > allowed_v) {
+    // should never happen because floor is always a previous allowed value;
+    // a zero watermark marks the leg permanently exhausted, matching
+    // compute_quota_exhausted
+    MLOG(MERROR) << "Error: Floor value is higher than allowed value "
+                 << floor_v << ">" << allowed_v;
+    return 0;
+  }
+  // same integer math as compute_quota_exhausted: remaining <= margin
+  // is equivalent to used >= allowed - margin
+  const int ratio       = 100 - static_cast<int>(threshold * 100);
+  const uint64_t margin = ((allowed_v - floor_v) * ratio) / 100;
+  return sat_sub(allowed_v, margin);
+}
+
+void SessionCredit::update_exhaustion_watermarks() {
+  const float report = SessionCredit::USAGE_REPORTING_THRESHOLD;
+
+  report_watermarks_.tx =
+      calculate_exhaustion_watermark(ALLOWED_TX, ALLOWED_FLOOR_TX, report);
+  report_watermarks_.rx =
+      calculate_exhaustion_watermark(ALLOWED_RX, ALLOWED_FLOOR_RX, report);
+  report_watermarks_.total = calculate_exhaustion_watermark(
+      ALLOWED_TOTAL, ALLOWED_FLOOR_TOTAL, report);
+
+  full_watermarks_.tx =
+      calculate_exhaustion_watermark(ALLOWED_TX, ALLOWED_FLOOR_TX, 1);
+  full_watermarks_.rx =
+      calculate_exhaustion_watermark(ALLOWED_RX, ALLOWED_FLOOR_RX, 1);
+  full_watermarks_.total =
+      calculate_exhaustion_watermark(ALLOWED_TOTAL, ALLOWED_FLOOR_TOTAL, 1);
+}
+
 bool SessionCredit::is_quota_exhausted(float threshold) const {
   if (credit_limit_type_ != FINITE) {
     return false;
   }
 
-  bool rx_exhausted = compute_quota_exhausted(
-      buckets_[ALLOWED_RX], buckets_[USED_RX], threshold,
-      buckets_[ALLOWED_FLOOR_RX]);
-  bool tx_exhausted = compute_quota_exhausted(
-      buckets_[ALLOWED_TX], buckets_[USED_TX], threshold,
-      buckets_[ALLOWED_FLOOR_TX]);
-  bool total_exhausted = compute_quota_exhausted(
-      buckets_[ALLOWED_TOTAL], buckets_[USED_TX] + buckets_[USED_RX], threshold,
-      buckets_[ALLOWED_FLOOR_TOTAL]);
+  const uint64_t used_tx    = buckets_[USED_TX];
+  const uint64_t used_rx    = buckets_[USED_RX];
+  const uint64_t used_total = used_tx + used_rx;
+
+  bool rx_exhausted;
+  bool tx_exhausted;
+  bool total_exhausted;
+  if (threshold == 1) {
+    tx_exhausted    = used_tx >= full_watermarks_.tx;
+    rx_exhausted    = used_rx >= full_watermarks_.rx;
+    total_exhausted = used_total >= full_watermarks_.total;
+  } else if (threshold == SessionCredit::USAGE_REPORTING_THRESHOLD) {
+    tx_exhausted    = used_tx >= report_watermarks_.tx;
+    rx_exhausted    = used_rx >= report_watermarks_.rx;
+    total_exhausted = used_total >= report_watermarks_.total;
+  } else {
+    rx_exhausted = compute_quota_exhausted(
+        buckets_[ALLOWED_RX], used_rx, threshold, buckets_[ALLOWED_FLOOR_RX]);
+    tx_exhausted = compute_quota_exhausted(
+        buckets_[ALLOWED_TX], used_tx, threshold, buckets_[ALLOWED_FLOOR_TX]);
+    total_exhausted = compute_quota_exhausted(
+        buckets_[ALLOWED_TOTAL], used_total, threshold,
+        buckets_[ALLOWED_FLOOR_TOTAL]);
+  }
 
   bool is_exhausted = false;
   switch (grant_tracking_type_) {
@@ -417,14 +478,10 @@ uint64_t SessionCredit::calculate_requested_unit(
 
 Usage SessionCredit::get_unreported_usage() const {
   Usage usage = {0, 0};
-  auto report = buckets_[REPORTED_TX] + buckets_[REPORTING_TX];
-  if (buckets_[USED_TX] > report) {
-    usage.bytes_tx = buckets_[USED_TX] - report;
-  }
-  report = buckets_[REPORTED_RX] - buckets_[REPORTING_RX];
-  if (buckets_[USED_RX] > report) {
-    usage.bytes_rx = buckets_[USED_RX] - report;
-  }
+  usage.bytes_tx = sat_sub(
+      buckets_[USED_TX], buckets_[REPORTED_TX] + buckets_[REPORTING_TX]);
+  usage.bytes_rx = sat_sub(
+      buckets_[USED_RX], buckets_[REPORTED_RX] - buckets_[REPORTING_RX]);
   MLOG(MDEBUG) << "===> Data usage since last report is tx=" << usage.bytes_tx
                << " rx=" << usage.bytes_rx;
   return usage;
@@ -499,6 +556,7 @@ void SessionCredit::apply_update_criteria(
     auto credit   = credit_uc.bucket_deltas.find(bucket)->second;
     buckets_[bucket] += credit;
   }
+  update_exhaustion_watermarks();
 }
 
 // Determine the grant's tracking type by looking at which values are valid.
@@ -168,7 +168,20 @@ class SessionCredit {
   static uint64_t DEFAULT_REQUESTED_UNITS;
 
  private:
+  // Usage level at which a leg counts as exhausted, precomputed whenever the
+  // ALLOWED/ALLOWED_FLOOR buckets change so the per-record check in
+  // is_quota_exhausted is a plain compare per leg
+  struct ExhaustionWatermarks {
+    uint64_t tx;
+    uint64_t rx;
+    uint64_t total;
+  };
+
   uint64_t buckets_[BUCKET_ENUM_MAX_VALUE];
+  // Watermarks for the USAGE_REPORTING_THRESHOLD ratio and for full (100%)
+  // exhaustion, the only two thresholds used on the polling path
+  ExhaustionWatermarks report_watermarks_;
+  ExhaustionWatermarks full_watermarks_;
   bool reporting_;
   CreditLimitType credit_limit_type_;
   GrantTrackingType grant_tracking_type_;
@@ -204,6 +217,16 @@ class SessionCredit {
       const uint64_t allowed, const uint64_t used, float threshold_ratio,
       const uint64_t grantedUnits) const;
 
+  // Branchless saturating subtraction: returns a - b, or 0 if b > a
+  static uint64_t sat_sub(uint64_t a, uint64_t b) {
+    return (a - b) & -static_cast<uint64_t>(a >= b);
+  }
+
+  uint64_t calculate_exhaustion_watermark(
+      Bucket allowed, Bucket floor, float threshold) const;
+
+  void update_exhaustion_watermarks();
+
   uint64_t calculate_delta_allowed_floor(
       CreditUnit cu, Bucket allowed, Bucket floor, uint64_t volume_used) const;
 
@@ -107,13 +107,8 @@ void EventsReporterImpl::session_created(
   std::string event_value_string = folly::toJson(event_value);
   event.set_value(event_value_string);
 
-  eventd_client_.log_event(event, [=](Status status, Void v) {
-    if (!status.ok()) {
-      MLOG(MERROR) << "Could not log " << SESSION_CREATED_EV << " event "
-                   << event_value_string
-                   << ", Error Message: " << status.error_message();
-    }
-  });
+  // billing relevant: batched and spooled to disk on delivery failure
+  eventd_client_.log_event_with_qos(event, EVENT_QOS_MUST_DELIVER);
 }
 
 void EventsReporterImpl::session_create_failure(
@@ -133,13 +128,7 @@ void EventsReporterImpl::session_create_failure(
   std::string event_value_string = folly::toJson(event_value);
   event.set_value(event_value_string);
 
-  eventd_client_.log_event(event, [=](Status status, Void v) {
-    if (!status.ok()) {
-      MLOG(MERROR) << "Could not log " << SESSION_CREATE_FAILURE_EV << " event "
-                   << event_value_string
-                   << ", Error Message: " << status.error_message();
-    }
-  });
+  eventd_client_.log_event_with_qos(event, EVENT_QOS_DROP_ELIGIBLE);
 }
 
 void EventsReporterImpl::session_updated(
@@ -164,13 +153,7 @@ void EventsReporterImpl::session_updated(
   std::string event_value_string = folly::toJson(event_value);
   event.set_value(event_value_string);
 
-  eventd_client_.log_event(event, [=](Status status, Void v) {
-    if (!status.ok()) {
-      MLOG(MERROR) << "Could not log " << SESSION_UPDATED_EV << " event "
-                   << event_value_string
-                   << ", Error Message: " << status.error_message();
-    }
-  });
+  eventd_client_.log_event_with_qos(event, EVENT_QOS_DROP_ELIGIBLE);
 }
 
 void EventsReporterImpl::session_update_failure(
@@ -195,13 +178,7 @@ void EventsReporterImpl::session_update_failure(
   std::string event_value_string = folly::toJson(event_value);
   event.set_value(event_value_string);
 
-  eventd_client_.log_event(event, [=](Status status, Void v) {
-    if (!status.ok()) {
-      MLOG(MERROR) << "Could not log " << SESSION_UPDATE_FAILURE_EV << " event "
-                   << event_value_string
-                   << ", Error Message: " << status.error_message();
-    }
-  });
+  eventd_client_.log_event_with_qos(event, EVENT_QOS_DROP_ELIGIBLE);
 }
 
 void EventsReporterImpl::session_terminated(
@@ -267,13 +244,8 @@ void EventsReporterImpl::session_terminated(
   std::string event_value_string = folly::toJson(event_value);
   event.set_value(event_value_string);
 
-  eventd_client_.log_event(event, [=](Status status, Void v) {
-    if (!status.ok()) {
-      MLOG(MERROR) << "Could not log " << SESSION_TERMINATED_EV << " event "
-                   << event_value_string
-                   << ", Error Message: " << status.error_message();
-    }
-  });
+  // billing relevant: batched and spooled to disk on delivery failure
+  eventd_client_.log_event_with_qos(event, EVENT_QOS_MUST_DELIVER);
 }
 
 folly::dynamic EventsReporterImpl::get_update_summary(
@@ -28,13 +28,33 @@ auto timenow = chrono::system_clock::to_time_t(chrono::system_clock::now());
 AsyncService::AsyncService(std::unique_ptr<ServerCompletionQueue> cq)
     : cq_(std::move(cq)) {}
 
+void AsyncService::add_completion_queue(
+    std::unique_ptr<ServerCompletionQueue> cq) {
+  extra_cqs_.push_back(std::move(cq));
+}
+
 void AsyncService::wait_for_requests() {
-  init_call_data();
+  init_call_data(cq_.get());
+  for (auto& extra_cq : extra_cqs_) {
+    init_call_data(extra_cq.get());
+  }
+  running_ = true;
+  for (auto& extra_cq : extra_cqs_) {
+    pollers_.emplace_back(
+        [this, cq = extra_cq.get()]() { drain_queue(cq); });
+  }
+  drain_queue(cq_.get());
+  for (auto& poller : pollers_) {
+    poller.join();
+  }
+  pollers_.clear();
+}
+
+void AsyncService::drain_queue(ServerCompletionQueue* cq) {
   void* tag;
   bool ok;
-  running_ = true;
   while (running_) {
-    if (cq_ == nullptr || !cq_->Next(&tag, &ok)) {
+    if (cq == nullptr || !cq->Next(&tag, &ok)) {
       // queue shut down
       MLOG(MINFO) << "sessiond request completion queue shutting down";
       return;
@@ -42,21 +62,29 @@ void AsyncService::wait_for_requests() {
     if (!ok) {
       MLOG(MINFO)
           << "sessiond server encountered error while processing request";
-      continue;
     }
-    static_cast<CallData*>(tag)->proceed();
+    // Streaming call data needs the ok flag to detect end-of-stream; for
+    // unary call data a failed event is dropped as before
+    static_cast<CallData*>(tag)->proceed_with_status(ok);
   }
 }
 
 void AsyncService::stop() {
   running_ = false;
   cq_->Shutdown();
-  // Pop all items in the queue until it is empty
+  for (auto& extra_cq : extra_cqs_) {
+    extra_cq->Shutdown();
+  }
+  // Pop all items in the queues until they are empty
   // https://github.com/grpc/grpc/issues/8610
   void* tag;
   bool ok;
   while (cq_->Next(&tag, &ok)) {
   }
+  for (auto& extra_cq : extra_cqs_) {
+    while (extra_cq->Next(&tag, &ok)) {
+    }
+  }
 }
 
 LocalSessionManagerAsyncService::LocalSessionManagerAsyncService(
@@ -64,13 +92,16 @@ LocalSessionManagerAsyncService::LocalSessionManagerAsyncService(
     std::unique_ptr<LocalSessionManagerHandler> handler)
     : AsyncService(std::move(cq)), handler_(std::move(handler)) {}
 
-void LocalSessionManagerAsyncService::init_call_data() {
-  new ReportRuleStatsCallData(cq_.get(), *this, *handler_);
-  new CreateSessionCallData(cq_.get(), *this, *handler_);
-  new EndSessionCallData(cq_.get(), *this, *handler_);
-  new BindPolicy2BearerCallData(cq_.get(), *this, *handler_);
-  new SetSessionRulesCallData(cq_.get(), *this, *handler_);
-  new UpdateTunnelIdsCallData(cq_.get(), *this, *handler_);
+void LocalSessionManagerAsyncService::init_call_data(
+    ServerCompletionQueue* cq) {
+  new ReportRuleStatsCallData(cq, *this, *handler_);
+  new ReportRuleStatsStreamCallData(cq, *this, *handler_);
+  new CreateSessionCallData(cq, *this, *handler_);
+  new EndSessionCallData(cq, *this, *handler_);
+  new BindPolicy2BearerCallData(cq, *this, *handler_);
+  new SetSessionRulesCallData(cq, *this, *handler_);
+  new UpdateTunnelIdsCallData(cq, *this, *handler_);
+  new BulkUpdateTunnelIdsCallData(cq, *this, *handler_);
 }
 
 /*Landing object invocation object call for 5G*/
@@ -79,8 +110,9 @@ AmfPduSessionSmContextAsyncService::AmfPduSessionSmContextAsyncService(
     std::unique_ptr<SetMessageManager> handler)
     : AsyncService(std::move(cq)), handler_(std::move(handler)) {}
 
-void AmfPduSessionSmContextAsyncService::init_call_data() {
-  new SetAmfSessionContextCallData(cq_.get(), *this, *handler_);
+void AmfPduSessionSmContextAsyncService::init_call_data(
+    ServerCompletionQueue* cq) {
+  new SetAmfSessionContextCallData(cq, *this, *handler_);
   MLOG(MINFO) << "Initializing new call data for SetAmfSessionContext";
 }
 
@@ -90,11 +122,12 @@ SetInterfaceForUserPlaneAsyncService::SetInterfaceForUserPlaneAsyncService(
     std::unique_ptr<UpfMsgManageHandler> handler)
     : AsyncService(std::move(cq)), handler_(std::move(handler)) {}
 
-void SetInterfaceForUserPlaneAsyncService::init_call_data() {
+void SetInterfaceForUserPlaneAsyncService::init_call_data(
+    ServerCompletionQueue* cq) {
   MLOG(MINFO) << "Initializing new call data for SetUpfNodeStateCallData";
-  new SetUPFNodeStateCallData(cq_.get(), *this, *handler_);
+  new SetUPFNodeStateCallData(cq, *this, *handler_);
   MLOG(MINFO) << "Initializing new call data for SendPagingRequest";
-  new SendPagingRequestCallData(cq_.get(), *this, *handler_);
+  new SendPagingRequestCallData(cq, *this, *handler_);
 }
 
 SessionProxyResponderAsyncService::SessionProxyResponderAsyncService(
@@ -102,9 +135,10 @@ SessionProxyResponderAsyncService::SessionProxyResponderAsyncService(
     std::shared_ptr<SessionProxyResponderHandler> handler)
     : AsyncService(std::move(cq)), handler_(handler) {}
 
-void SessionProxyResponderAsyncService::init_call_data() {
-  new ChargingReAuthCallData(cq_.get(), *this, *handler_);
-  new PolicyReAuthCallData(cq_.get(), *this, *handler_);
+void SessionProxyResponderAsyncService::init_call_data(
+    ServerCompletionQueue* cq) {
+  new ChargingReAuthCallData(cq, *this, *handler_);
+  new PolicyReAuthCallData(cq, *this, *handler_);
 }
 
 AbortSessionResponderAsyncService::AbortSessionResponderAsyncService(
@@ -112,14 +146,40 @@ AbortSessionResponderAsyncService::AbortSessionResponderAsyncService(
     std::shared_ptr<SessionProxyResponderHandler> handler)
     : AsyncService(std::move(cq)), handler_(handler) {}
 
-void AbortSessionResponderAsyncService::init_call_data() {
-  new AbortSessionCallData(cq_.get(), *this, *handler_);
+void AbortSessionResponderAsyncService::init_call_data(
+    ServerCompletionQueue* cq) {
+  new AbortSessionCallData(cq, *this, *handler_);
+}
+
+thread_local std::vector<char*> ArenaBlockPool::free_blocks_;
+
+char* ArenaBlockPool::acquire() {
+  if (free_blocks_.empty()) {
+    return new char[BLOCK_SIZE];
+  }
+  char* block = free_blocks_.back();
+  free_blocks_.pop_back();
+  return block;
+}
+
+void ArenaBlockPool::release(char* block) {
+  if (free_blocks_.size() >= MAX_FREE_BLOCKS) {
+    delete[] block;
+    return;
+  }
+  free_blocks_.push_back(block);
 }
 
 template<class GRPCService, class RequestType, class ResponseType>
 AsyncGRPCRequest<GRPCService, RequestType, ResponseType>::AsyncGRPCRequest(
     ServerCompletionQueue* cq, GRPCService& service)
-    : cq_(cq), status_(PROCESS), responder_(&ctx_), service_(service) {}
+    : cq_(cq),
+      status_(PROCESS),
+      arena_(arena_block_.options()),
+      request_(
+          google::protobuf::Arena::CreateMessage<RequestType>(&arena_)),
+      responder_(&ctx_),
+      service_(service) {}
 
 // Internal state management logic for AsyncGRPCRequest
 // Once a request has started processing, create a new AsyncGRPCRequest to
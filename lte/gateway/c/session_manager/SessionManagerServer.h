@@ -11,12 +11,15 @@
  * limitations under the License.
  */
 #pragma once
+#include <google/protobuf/arena.h>
 #include <grpc++/grpc++.h>
 #include <lte/protos/abort_session.grpc.pb.h>
 #include <lte/protos/session_manager.grpc.pb.h>
 
 #include <memory>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "LocalSessionManagerHandler.h"
 #include "SessionProxyResponderHandler.h"
@@ -52,23 +55,40 @@ class AsyncService {
   virtual ~AsyncService() = default;
 
   /**
-   * Start the server, blocks
+   * Register an additional completion queue drained by its own poller
+   * thread, so RPCs for this service are serviced on several cores. Must be
+   * called before wait_for_requests. Per-IMSI ordering is preserved by the
+   * sharded SessionStore rather than by the queue itself.
+   */
+  void add_completion_queue(std::unique_ptr<ServerCompletionQueue> cq);
+
+  /**
+   * Start the server, blocks. Drains the first completion queue on the
+   * calling thread and spawns one poller thread per additional queue.
    */
   void wait_for_requests();
 
   /**
-   * Stop the server and shutdown the completion queue
+   * Stop the server and shutdown all completion queues
    */
   void stop();
 
  protected:
   /**
    * Initialize request handlers for report rule stats, end/create session
+   * on the given completion queue
+   */
+  virtual void init_call_data(ServerCompletionQueue* cq) = 0;
+
+  /**
+   * Pull requests off one completion queue until it shuts down
    */
-  virtual void init_call_data() = 0;
+  void drain_queue(ServerCompletionQueue* cq);
 
  protected:
   std::unique_ptr<ServerCompletionQueue> cq_;
+  std::vector<std::unique_ptr<ServerCompletionQueue>> extra_cqs_;
+  std::vector<std::thread> pollers_;
   std::atomic<bool> running_;
 };
 
@@ -85,7 +105,7 @@ class LocalSessionManagerAsyncService final
       std::unique_ptr<LocalSessionManagerHandler> handler);
 
  protected:
-  void init_call_data();
+  void init_call_data(ServerCompletionQueue* cq);
 
  private:
   std::unique_ptr<LocalSessionManagerHandler> handler_;
@@ -101,7 +121,7 @@ class AmfPduSessionSmContextAsyncService final
       std::unique_ptr<SetMessageManager> handler);
 
  protected:
-  void init_call_data();
+  void init_call_data(ServerCompletionQueue* cq);
 
  private:
   std::unique_ptr<SetMessageManager> handler_;
@@ -117,7 +137,7 @@ class SetInterfaceForUserPlaneAsyncService final
       std::unique_ptr<UpfMsgManageHandler> handler);
 
  protected:
-  void init_call_data();
+  void init_call_data(ServerCompletionQueue* cq);
 
  private:
   std::unique_ptr<UpfMsgManageHandler> handler_;
@@ -135,7 +155,7 @@ class SessionProxyResponderAsyncService final
       std::shared_ptr<SessionProxyResponderHandler> handler);
 
  protected:
-  void init_call_data();
+  void init_call_data(ServerCompletionQueue* cq);
 
  private:
   std::shared_ptr<SessionProxyResponderHandler> handler_;
@@ -150,12 +170,54 @@ class AbortSessionResponderAsyncService final
       std::shared_ptr<SessionProxyResponderHandler> handler);
 
  protected:
-  void init_call_data();
+  void init_call_data(ServerCompletionQueue* cq);
 
  private:
   std::shared_ptr<SessionProxyResponderHandler> handler_;
 };
 
+/**
+ * Fixed-size scratch blocks recycled on a per-thread free list. Each call
+ * data seeds its protobuf arena with one block, so the request trees of the
+ * high-rate RPCs are carved out of memory recycled on the completion-queue
+ * thread instead of being heap-allocated node by node.
+ */
+class ArenaBlockPool {
+ public:
+  static const size_t BLOCK_SIZE      = 16 * 1024;
+  static const size_t MAX_FREE_BLOCKS = 32;
+
+  // Take a block from the calling thread's free list, growing it on demand
+  static char* acquire();
+
+  // Return a block to the calling thread's free list; blocks beyond
+  // MAX_FREE_BLOCKS are freed to bound idle memory
+  static void release(char* block);
+
+ private:
+  static thread_local std::vector<char*> free_blocks_;
+};
+
+/**
+ * Holds one pooled block for the lifetime of an arena. Declared before the
+ * arena it seeds so the block outlives it.
+ */
+struct RecycledArenaBlock {
+  char* block;
+
+  RecycledArenaBlock() : block(ArenaBlockPool::acquire()) {}
+  ~RecycledArenaBlock() { ArenaBlockPool::release(block); }
+  RecycledArenaBlock(const RecycledArenaBlock&) = delete;
+  RecycledArenaBlock& operator=(const RecycledArenaBlock&) = delete;
+
+  google::protobuf::ArenaOptions options() const {
+    google::protobuf::ArenaOptions opts;
+    opts.initial_block      = block;
+    opts.initial_block_size = ArenaBlockPool::BLOCK_SIZE;
+    return opts;
+  }
+};
+
 /**
  * Interface for capturing request call processing. This is required because
  * a templated class cannot be declared without knowing the type. Using this
@@ -169,7 +231,19 @@ class CallData {
    * the queue
    */
   virtual void proceed() = 0;
-  virtual ~CallData()    = default;
+
+  /**
+   * proceed_with_status additionally receives the completion queue's ok flag,
+   * which streaming call data needs to observe to detect end-of-stream. The
+   * default drops failed events, matching the unary behavior.
+   */
+  virtual void proceed_with_status(bool ok) {
+    if (ok) {
+      proceed();
+    }
+  }
+
+  virtual ~CallData() = default;
 };
 
 /**
@@ -198,7 +272,11 @@ class AsyncGRPCRequest : public CallData {
   enum CallStatus { PROCESS, FINISH };
   CallStatus status_;
 
-  RequestType request_;
+  // Arena backing the request tree, seeded with a block recycled on the
+  // completion-queue thread
+  RecycledArenaBlock arena_block_;
+  google::protobuf::Arena arena_;
+  RequestType* request_;
   grpc::ServerAsyncResponseWriter<ResponseType> responder_;
 
   GRPCService& service_;
@@ -236,7 +314,7 @@ class ReportRuleStatsCallData
     // of this instance. When the request is completed, it will be added to
     // cq_ again to be finished
     service_.RequestReportRuleStats(
-        &ctx_, &request_, &responder_, cq_, cq_, (void*) this);
+        &ctx_, request_, &responder_, cq_, cq_, (void*) this);
   }
 
  protected:
@@ -248,12 +326,88 @@ class ReportRuleStatsCallData
 
   void process() override {
     // Get a response from a handler and call the finish callback
-    handler_.ReportRuleStats(&ctx_, &request_, get_finish_callback());
+    handler_.ReportRuleStats(&ctx_, request_, get_finish_callback());
+  }
+
+ private:
+  LocalSessionManagerHandler& handler_;
+};
+
+/**
+ * Class to handle the client-streaming ReportRuleStatsStream RPC. Each
+ * streamed RuleRecordTable chunk is dispatched to the handler as it arrives
+ * and commits its own SessionStore transaction, so peak memory is bounded by
+ * the chunk size instead of the full flow count.
+ */
+class ReportRuleStatsStreamCallData : public CallData {
+ public:
+  ReportRuleStatsStreamCallData(
+      ServerCompletionQueue* cq, LocalSessionManager::AsyncService& service,
+      LocalSessionManagerHandler& handler)
+      : cq_(cq),
+        service_(service),
+        handler_(handler),
+        reader_(&ctx_),
+        status_(REQUEST),
+        arena_(arena_block_.options()),
+        chunk_(google::protobuf::Arena::CreateMessage<RuleRecordTable>(
+            &arena_)) {
+    service_.RequestReportRuleStatsStream(
+        &ctx_, &reader_, cq_, cq_, (void*) this);
+  }
+
+  void proceed() override { proceed_with_status(true); }
+
+  void proceed_with_status(bool ok) override {
+    switch (status_) {
+      case REQUEST:
+        if (!ok) {
+          // Server shutting down before a stream arrived
+          delete this;
+          return;
+        }
+        // Stand by for the next stream while this one is serviced
+        new ReportRuleStatsStreamCallData(cq_, service_, handler_);
+        status_ = READ;
+        reader_.Read(chunk_, (void*) this);
+        break;
+      case READ:
+        if (ok) {
+          // Reuse the unary processing path; the handler copies the chunk
+          // into its event base task
+          handler_.ReportRuleStats(&ctx_, chunk_, [](Status, Void) {});
+          // Drop the whole record tree in one shot and carve the next chunk
+          // out of the same recycled block
+          arena_.Reset();
+          chunk_ =
+              google::protobuf::Arena::CreateMessage<RuleRecordTable>(&arena_);
+          reader_.Read(chunk_, (void*) this);
+        } else {
+          // Client closed the stream
+          status_ = FINISH;
+          reader_.Finish(Void(), Status::OK, (void*) this);
+        }
+        break;
+      case FINISH:
+        delete this;
+        break;
+    }
   }
 
  private:
+  enum StreamStatus { REQUEST, READ, FINISH };
+
+  ServerCompletionQueue* cq_;
+  LocalSessionManager::AsyncService& service_;
   LocalSessionManagerHandler& handler_;
+  ServerContext ctx_;
+  grpc::ServerAsyncReader<Void, RuleRecordTable> reader_;
+  StreamStatus status_;
+  RecycledArenaBlock arena_block_;
+  google::protobuf::Arena arena_;
+  RuleRecordTable* chunk_;
 };
+
 /*Set RPC calldata to invoke first first function of landing object for 5G */
 // AmfPduSessionSmContextToSmf
 class SetAmfSessionContextCallData : public AsyncGRPCRequest<
@@ -265,7 +419,7 @@ class SetAmfSessionContextCallData : public AsyncGRPCRequest<
       SetMessageManager& handler)
       : AsyncGRPCRequest(cq, service), handler_(handler) {
     service_.RequestSetAmfSessionContext(
-        &ctx_, &request_, &responder_, cq_, cq_, (void*) this);
+        &ctx_, request_, &responder_, cq_, cq_, (void*) this);
   }
 
  protected:
@@ -274,7 +428,7 @@ class SetAmfSessionContextCallData : public AsyncGRPCRequest<
   }
 
   void process() override {
-    handler_.SetAmfSessionContext(&ctx_, &request_, get_finish_callback());
+    handler_.SetAmfSessionContext(&ctx_, request_, get_finish_callback());
   }
 
  private:
@@ -294,7 +448,7 @@ class SetUPFNodeStateCallData
       UpfMsgManageHandler& handler)
       : AsyncGRPCRequest(cq, service), handler_(handler) {
     service_.RequestSetUPFNodeState(
-        &ctx_, &request_, &responder_, cq_, cq_, reinterpret_cast<void*>(this));
+        &ctx_, request_, &responder_, cq_, cq_, reinterpret_cast<void*>(this));
   }
 
  protected:
@@ -303,7 +457,7 @@ class SetUPFNodeStateCallData
   }
 
   void process() override {
-    handler_.SetUPFNodeState(&ctx_, &request_, get_finish_callback());
+    handler_.SetUPFNodeState(&ctx_, request_, get_finish_callback());
   }
 
  private:
@@ -323,7 +477,7 @@ class SetUPFSessionsConfigCallData : public AsyncGRPCRequest<
       UpfMsgManageHandler& handler)
       : AsyncGRPCRequest(cq, service), handler_(handler) {
     service_.RequestSetUPFSessionsConfig(
-        &ctx_, &request_, &responder_, cq_, cq_, (void*) this);
+        &ctx_, request_, &responder_, cq_, cq_, (void*) this);
   }
 
  protected:
@@ -332,7 +486,7 @@ class SetUPFSessionsConfigCallData : public AsyncGRPCRequest<
   }
 
   void process() override {
-    handler_.SetUPFSessionsConfig(&ctx_, &request_, get_finish_callback());
+    handler_.SetUPFSessionsConfig(&ctx_, request_, get_finish_callback());
   }
 
  private:
@@ -352,14 +506,14 @@ class CreateSessionCallData
       LocalSessionManagerHandler& handler)
       : AsyncGRPCRequest(cq, service), handler_(handler) {
     service_.RequestCreateSession(
-        &ctx_, &request_, &responder_, cq_, cq_, (void*) this);
+        &ctx_, request_, &responder_, cq_, cq_, (void*) this);
   }
 
  protected:
   void clone() override { new CreateSessionCallData(cq_, service_, handler_); }
 
   void process() override {
-    handler_.CreateSession(&ctx_, &request_, get_finish_callback());
+    handler_.CreateSession(&ctx_, request_, get_finish_callback());
   }
 
  private:
@@ -379,14 +533,14 @@ class EndSessionCallData
       LocalSessionManagerHandler& handler)
       : AsyncGRPCRequest(cq, service), handler_(handler) {
     service_.RequestEndSession(
-        &ctx_, &request_, &responder_, cq_, cq_, (void*) this);
+        &ctx_, request_, &responder_, cq_, cq_, (void*) this);
   }
 
  protected:
   void clone() override { new EndSessionCallData(cq_, service_, handler_); }
 
   void process() override {
-    handler_.EndSession(&ctx_, &request_, get_finish_callback());
+    handler_.EndSession(&ctx_, request_, get_finish_callback());
   }
 
  private:
@@ -406,7 +560,7 @@ class BindPolicy2BearerCallData
       LocalSessionManagerHandler& handler)
       : AsyncGRPCRequest(cq, service), handler_(handler) {
     service_.RequestBindPolicy2Bearer(
-        &ctx_, &request_, &responder_, cq_, cq_, (void*) this);
+        &ctx_, request_, &responder_, cq_, cq_, (void*) this);
   }
 
  protected:
@@ -415,7 +569,7 @@ class BindPolicy2BearerCallData
   }
 
   void process() override {
-    handler_.BindPolicy2Bearer(&ctx_, &request_, get_finish_callback());
+    handler_.BindPolicy2Bearer(&ctx_, request_, get_finish_callback());
   }
 
  private:
@@ -436,7 +590,7 @@ class UpdateTunnelIdsCallData
       LocalSessionManagerHandler& handler)
       : AsyncGRPCRequest(cq, service), handler_(handler) {
     service_.RequestUpdateTunnelIds(
-        &ctx_, &request_, &responder_, cq_, cq_, (void*) this);
+        &ctx_, request_, &responder_, cq_, cq_, (void*) this);
   }
 
  protected:
@@ -445,7 +599,36 @@ class UpdateTunnelIdsCallData
   }
 
   void process() override {
-    handler_.UpdateTunnelIds(&ctx_, &request_, get_finish_callback());
+    handler_.UpdateTunnelIds(&ctx_, request_, get_finish_callback());
+  }
+
+ private:
+  LocalSessionManagerHandler& handler_;
+};
+
+/**
+ * Class to handle BulkUpdateTunnelIds requests
+ */
+class BulkUpdateTunnelIdsCallData
+    : public AsyncGRPCRequest<
+          LocalSessionManager::AsyncService, UpdateTunnelIdsBatchRequest,
+          UpdateTunnelIdsBatchResponse> {
+ public:
+  BulkUpdateTunnelIdsCallData(
+      ServerCompletionQueue* cq, LocalSessionManager::AsyncService& service,
+      LocalSessionManagerHandler& handler)
+      : AsyncGRPCRequest(cq, service), handler_(handler) {
+    service_.RequestBulkUpdateTunnelIds(
+        &ctx_, request_, &responder_, cq_, cq_, (void*) this);
+  }
+
+ protected:
+  void clone() override {
+    new BulkUpdateTunnelIdsCallData(cq_, service_, handler_);
+  }
+
+  void process() override {
+    handler_.BulkUpdateTunnelIds(&ctx_, request_, get_finish_callback());
   }
 
  private:
@@ -464,7 +647,7 @@ class SetSessionRulesCallData
       LocalSessionManagerHandler& handler)
       : AsyncGRPCRequest(cq, service), handler_(handler) {
     service_.RequestSetSessionRules(
-        &ctx_, &request_, &responder_, cq_, cq_, (void*) this);
+        &ctx_, request_, &responder_, cq_, cq_, (void*) this);
   }
 
  protected:
@@ -473,7 +656,7 @@ class SetSessionRulesCallData
   }
 
   void process() override {
-    handler_.SetSessionRules(&ctx_, &request_, get_finish_callback());
+    handler_.SetSessionRules(&ctx_, request_, get_finish_callback());
   }
 
  private:
@@ -492,14 +675,14 @@ class AbortSessionCallData : public AsyncGRPCRequest<
       SessionProxyResponderHandler& handler)
       : AsyncGRPCRequest(cq, service), handler_(handler) {
     service_.RequestAbortSession(
-        &ctx_, &request_, &responder_, cq_, cq_, (void*) this);
+        &ctx_, request_, &responder_, cq_, cq_, (void*) this);
   }
 
  protected:
   void clone() override { new AbortSessionCallData(cq_, service_, handler_); }
 
   void process() override {
-    handler_.AbortSession(&ctx_, &request_, get_finish_callback());
+    handler_.AbortSession(&ctx_, request_, get_finish_callback());
   }
 
  private:
@@ -519,14 +702,14 @@ class ChargingReAuthCallData
       SessionProxyResponderHandler& handler)
       : AsyncGRPCRequest(cq, service), handler_(handler) {
     service_.RequestChargingReAuth(
-        &ctx_, &request_, &responder_, cq_, cq_, (void*) this);
+        &ctx_, request_, &responder_, cq_, cq_, (void*) this);
   }
 
  protected:
   void clone() override { new ChargingReAuthCallData(cq_, service_, handler_); }
 
   void process() override {
-    handler_.ChargingReAuth(&ctx_, &request_, get_finish_callback());
+    handler_.ChargingReAuth(&ctx_, request_, get_finish_callback());
   }
 
  private:
@@ -545,14 +728,14 @@ class PolicyReAuthCallData : public AsyncGRPCRequest<
       SessionProxyResponderHandler& handler)
       : AsyncGRPCRequest(cq, service), handler_(handler) {
     service_.RequestPolicyReAuth(
-        &ctx_, &request_, &responder_, cq_, cq_, (void*) this);
+        &ctx_, request_, &responder_, cq_, cq_, (void*) this);
   }
 
  protected:
   void clone() override { new PolicyReAuthCallData(cq_, service_, handler_); }
 
   void process() override {
-    handler_.PolicyReAuth(&ctx_, &request_, get_finish_callback());
+    handler_.PolicyReAuth(&ctx_, request_, get_finish_callback());
   }
 
  private:
@@ -572,7 +755,7 @@ class SendPagingRequestCallData : public AsyncGRPCRequest<
       UpfMsgManageHandler& handler)
       : AsyncGRPCRequest(cq, service), handler_(handler) {
     service_.RequestSendPagingRequest(
-        &ctx_, &request_, &responder_, cq_, cq_, (void*) this);
+        &ctx_, request_, &responder_, cq_, cq_, (void*) this);
   }
 
  protected:
@@ -581,7 +764,7 @@ class SendPagingRequestCallData : public AsyncGRPCRequest<
   }
 
   void process() override {
-    handler_.SendPagingRequest(&ctx_, &request_, get_finish_callback());
+    handler_.SendPagingRequest(&ctx_, request_, get_finish_callback());
   }
 
  private:
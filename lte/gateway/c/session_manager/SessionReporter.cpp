@@ -51,13 +51,100 @@ SessionReporter::get_terminate_logging_cb(
   };
 }
 
+uint32_t SessionReporterImpl::REPORT_COALESCING_WINDOW_MS = 0;
+
 SessionReporterImpl::SessionReporterImpl(
     folly::EventBase* base, std::shared_ptr<grpc::Channel> channel)
-    : base_(base), stub_(CentralSessionController::NewStub(channel)) {}
+    : base_(base),
+      stub_(CentralSessionController::NewStub(channel)),
+      flush_scheduled_(false) {}
 
 void SessionReporterImpl::report_updates(
     const UpdateSessionRequest& request,
     ReporterCallbackFn<UpdateSessionResponse> callback) {
+  if (REPORT_COALESCING_WINDOW_MS == 0) {
+    send_update_request(request, callback);
+    return;
+  }
+  // Merge into the pending batch on the event base thread, which also
+  // serializes access to the batch state
+  base_->runInEventBaseThread([this, request, callback]() {
+    PendingUpdate pending;
+    pending.callback = callback;
+    for (const auto& update : request.updates()) {
+      pending.session_ids.insert(update.session_id());
+      pending_request_.add_updates()->CopyFrom(update);
+    }
+    for (const auto& monitor : request.usage_monitors()) {
+      pending.session_ids.insert(monitor.session_id());
+      pending_request_.add_usage_monitors()->CopyFrom(monitor);
+    }
+    pending_updates_.push_back(std::move(pending));
+    if (has_final_unit_update(request)) {
+      // Final-unit actions have to reach the OCS right away
+      flush_pending_updates();
+      return;
+    }
+    if (!flush_scheduled_) {
+      flush_scheduled_ = true;
+      base_->runAfterDelay(
+          [this]() { flush_pending_updates(); }, REPORT_COALESCING_WINDOW_MS);
+    }
+  });
+}
+
+void SessionReporterImpl::flush_pending_updates() {
+  flush_scheduled_ = false;
+  if (pending_updates_.empty()) {
+    return;
+  }
+  UpdateSessionRequest batched = std::move(pending_request_);
+  pending_request_.Clear();
+  auto pending = std::move(pending_updates_);
+  pending_updates_.clear();
+  MLOG(MDEBUG) << "Reporting " << batched.updates_size()
+               << " credit updates and " << batched.usage_monitors_size()
+               << " monitor updates batched from " << pending.size()
+               << " coalesced reports";
+  send_update_request(
+      batched,
+      [pending](grpc::Status status, UpdateSessionResponse response) {
+        // Each coalesced caller only gets the responses for its own sessions
+        for (const auto& entry : pending) {
+          UpdateSessionResponse filtered;
+          for (const auto& credit : response.responses()) {
+            if (entry.session_ids.count(credit.session_id()) > 0) {
+              filtered.add_responses()->CopyFrom(credit);
+            }
+          }
+          for (const auto& monitor : response.usage_monitor_responses()) {
+            if (entry.session_ids.count(monitor.session_id()) > 0) {
+              filtered.add_usage_monitor_responses()->CopyFrom(monitor);
+            }
+          }
+          entry.callback(status, filtered);
+        }
+      });
+}
+
+bool SessionReporterImpl::has_final_unit_update(
+    const UpdateSessionRequest& request) {
+  for (const auto& update : request.updates()) {
+    switch (update.usage().type()) {
+      case CreditUsage::TERMINATED:
+      case CreditUsage::QUOTA_EXHAUSTED:
+      case CreditUsage::REAUTH_REQUIRED:
+        return true;
+      default:
+        break;
+    }
+  }
+  return false;
+}
+
+void SessionReporterImpl::send_update_request(
+    const UpdateSessionRequest& request,
+    ReporterCallbackFn<UpdateSessionResponse> callback) {
   PrintGrpcMessage(static_cast<const google::protobuf::Message&>(request));
 
   auto controller_response = new AsyncEvbResponse<UpdateSessionResponse>(
@@ -18,6 +18,9 @@
 
 #include <functional>
 #include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "includes/GRPCReceiver.h"
 
@@ -102,9 +105,42 @@ class SessionReporterImpl : public SessionReporter {
       const SessionTerminateRequest& request,
       std::function<void(grpc::Status, SessionTerminateResponse)> callback);
 
+  // Coalescing window for report_updates in milliseconds. While a window is
+  // open, further updates are merged into a single batched
+  // UpdateSessionRequest that is sent when the window closes. Updates that
+  // carry final-unit actions flush the batch immediately. 0 disables
+  // coalescing and sends every request as-is.
+  static uint32_t REPORT_COALESCING_WINDOW_MS;
+
+ private:
+  // Tracks one coalesced report_updates call so the batched response can be
+  // fanned back out to the original callback with only its sessions
+  struct PendingUpdate {
+    std::set<std::string> session_ids;
+    ReporterCallbackFn<UpdateSessionResponse> callback;
+  };
+
+  /**
+   * Send a single UpdateSessionRequest upstream without coalescing
+   */
+  void send_update_request(
+      const UpdateSessionRequest& request,
+      ReporterCallbackFn<UpdateSessionResponse> callback);
+
+  /**
+   * Send all updates accumulated in the current window as one batched
+   * request and fan the response out to the coalesced callbacks
+   */
+  void flush_pending_updates();
+
+  static bool has_final_unit_update(const UpdateSessionRequest& request);
+
  private:
   folly::EventBase* base_;
   std::unique_ptr<CentralSessionController::Stub> stub_;
+  UpdateSessionRequest pending_request_;
+  std::vector<PendingUpdate> pending_updates_;
+  bool flush_scheduled_;
   static const uint32_t RESPONSE_TIMEOUT = 6;  // seconds
 };
 
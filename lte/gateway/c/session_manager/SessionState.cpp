@@ -15,6 +15,7 @@
 #include <google/protobuf/util/time_util.h>
 
 #include <functional>
+#include <mutex>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -43,6 +44,14 @@ const char* DIRECTION_DOWN          = "down";
 // TODO(@themarwhal): SessionD should own the naming of the drop all rule so
 // that we never regress here
 const char* DROP_ALL_RULE = "internal_default_drop_flow_rule";
+
+// Free list of recycled SessionState blocks. Every request materializes its
+// sessions from the store and frees them after the commit, so without the
+// pool that is a malloc/free pair per session per request. The cap keeps an
+// occasional burst of sessions from pinning memory forever.
+const size_t MAX_POOLED_SESSION_BLOCKS = 4096;
+std::mutex session_block_lock;
+std::vector<void*> free_session_blocks;
 }  // namespace
 
 using magma::service303::increment_counter;
@@ -57,6 +66,29 @@ void remove_from_vec_by_value(std::vector<T>& vec, T value) {
   vec.erase(std::remove(vec.begin(), vec.end(), value), vec.end());
 }
 
+void* SessionState::operator new(size_t size) {
+  if (size == sizeof(SessionState)) {
+    std::lock_guard<std::mutex> guard(session_block_lock);
+    if (!free_session_blocks.empty()) {
+      void* block = free_session_blocks.back();
+      free_session_blocks.pop_back();
+      return block;
+    }
+  }
+  return ::operator new(size);
+}
+
+void SessionState::operator delete(void* ptr, size_t size) {
+  if (size == sizeof(SessionState)) {
+    std::lock_guard<std::mutex> guard(session_block_lock);
+    if (free_session_blocks.size() < MAX_POOLED_SESSION_BLOCKS) {
+      free_session_blocks.push_back(ptr);
+      return;
+    }
+  }
+  ::operator delete(ptr);
+}
+
 std::unique_ptr<SessionState> SessionState::unmarshal(
     const StoredSessionState& marshaled, StaticRuleStore& rule_store) {
   return std::make_unique<SessionState>(marshaled, rule_store);
@@ -92,9 +124,8 @@ StoredSessionState SessionState::marshal() {
 
   marshaled.credit_map = StoredChargingCreditMap(4, &ccHash, &ccEqual);
   for (auto& credit_pair : credit_map_) {
-    auto key                  = CreditKey();
-    key.rating_group          = credit_pair.first.rating_group;
-    key.service_identifier    = credit_pair.first.service_identifier;
+    auto key = CreditKey(
+        credit_pair.first.rating_group, credit_pair.first.service_identifier);
     marshaled.credit_map[key] = credit_pair.second->marshal();
   }
 
@@ -158,6 +189,8 @@ SessionState::SessionState(
     monitor.level  = it.second.level;
 
     monitor_map_[it.first] = std::make_unique<Monitor>(monitor);
+    // The pending-update index is derived state; rebuild it on unmarshal
+    mark_monitor_if_reportable(it.first, monitor_map_[it.first].get());
   }
 
   for (const auto& it : marshaled.credit_map) {
@@ -247,6 +280,12 @@ void SessionState::insert_pdr(
     SetGroupPDR* rule, SessionStateUpdateCriteria* session_uc) {
   // Check if it already exists
   int32_t Pdr_index;
+  /* Stamp the rule with the version it was (re)configured at, so only
+   * rules newer than the UPF acknowledged version need to be resent.
+   * The session version is bumped once the whole update is assembled,
+   * hence the +1.
+   */
+  rule->set_pdr_version(get_current_version() + 1);
   Pdr_index = get_pdr_index(rule->pdr_id());
   if (Pdr_index != -1) {
     // Update the existing value
@@ -264,7 +303,11 @@ void SessionState::insert_pdr(
 /* method to change the PDR state */
 void SessionState::set_all_pdrs(PdrState pdr_state) {
   for (auto& rule : pdr_list_) {
-    rule.set_pdr_state(pdr_state);
+    if (rule.pdr_state() != pdr_state) {
+      rule.set_pdr_state(pdr_state);
+      // Restamp only rules that actually changed state
+      rule.set_pdr_version(get_current_version() + 1);
+    }
   }
 }
 
@@ -342,6 +385,8 @@ void SessionState::sess_infocopy(struct SessionInfo* info) {
   info->local_f_teid        = get_upf_local_teid();
   info->nodeId.node_id_type = SessionInfo::IPv4;
   info->pdr_rules           = get_all_pdr_rules();
+  info->upf_base_version    = 0;
+  info->state_checksum      = 0;
   if (!info->pdr_rules.empty()) {
     // Get the UE ip address from first rule
     auto& rule    = info->pdr_rules.front();
@@ -385,7 +430,7 @@ SessionCreditUpdateCriteria* SessionState::get_credit_uc(
 }
 
 bool SessionState::apply_update_criteria(
-    SessionStateUpdateCriteria session_uc) {
+    const SessionStateUpdateCriteria& session_uc) {
   if (session_uc.is_fsm_updated) {
     curr_state_ = session_uc.updated_fsm_state;
   }
@@ -434,7 +479,7 @@ bool SessionState::apply_update_criteria(
     }
     if (session_uc.new_rule_lifetimes.find(rule_id) !=
         session_uc.new_rule_lifetimes.end()) {
-      rule_lifetimes_[rule_id] = session_uc.new_rule_lifetimes[rule_id];
+      rule_lifetimes_[rule_id] = session_uc.new_rule_lifetimes.at(rule_id);
     }
     if (is_static_rule_scheduled(rule_id)) {
       scheduled_static_rules_.erase(rule_id);
@@ -446,7 +491,7 @@ bool SessionState::apply_update_criteria(
     }
     if (session_uc.new_rule_lifetimes.find(rule_id) !=
         session_uc.new_rule_lifetimes.end()) {
-      rule_lifetimes_[rule_id] = session_uc.new_rule_lifetimes[rule_id];
+      rule_lifetimes_[rule_id] = session_uc.new_rule_lifetimes.at(rule_id);
     }
     scheduled_static_rules_.insert(rule_id);
   }
@@ -460,7 +505,7 @@ bool SessionState::apply_update_criteria(
   for (const auto& rule : session_uc.dynamic_rules_to_install) {
     if (session_uc.new_rule_lifetimes.find(rule.id()) !=
         session_uc.new_rule_lifetimes.end()) {
-      rule_lifetimes_[rule.id()] = session_uc.new_rule_lifetimes[rule.id()];
+      rule_lifetimes_[rule.id()] = session_uc.new_rule_lifetimes.at(rule.id());
     }
     dynamic_rules_.insert_rule(rule);
     scheduled_dynamic_rules_.remove_rule(rule.id(), nullptr);
@@ -468,7 +513,7 @@ bool SessionState::apply_update_criteria(
   for (const auto& rule : session_uc.new_scheduled_dynamic_rules) {
     if (session_uc.new_rule_lifetimes.find(rule.id()) !=
         session_uc.new_rule_lifetimes.end()) {
-      rule_lifetimes_[rule.id()] = session_uc.new_rule_lifetimes[rule.id()];
+      rule_lifetimes_[rule.id()] = session_uc.new_rule_lifetimes.at(rule.id());
     }
     scheduled_dynamic_rules_.insert_rule(rule);
   }
@@ -477,7 +522,7 @@ bool SessionState::apply_update_criteria(
   for (const auto& rule : session_uc.gy_dynamic_rules_to_install) {
     if (session_uc.new_rule_lifetimes.find(rule.id()) !=
         session_uc.new_rule_lifetimes.end()) {
-      rule_lifetimes_[rule.id()] = session_uc.new_rule_lifetimes[rule.id()];
+      rule_lifetimes_[rule.id()] = session_uc.new_rule_lifetimes.at(rule.id());
     }
     gy_dynamic_rules_.insert_rule(rule);
   }
@@ -501,14 +546,10 @@ bool SessionState::apply_update_criteria(
 
   // Charging credit
   for (const auto& it : session_uc.charging_credit_map) {
-    auto key           = it.first;
-    auto credit_update = it.second;
-    apply_charging_credit_update(key, credit_update);
+    apply_charging_credit_update(it.first, it.second);
   }
   for (const auto& it : session_uc.charging_credit_to_install) {
-    auto key           = it.first;
-    auto stored_credit = it.second;
-    credit_map_[key]   = std::make_unique<ChargingGrant>(stored_credit);
+    credit_map_[it.first] = std::make_unique<ChargingGrant>(it.second);
   }
 
   // Monitoring credit
@@ -516,14 +557,11 @@ bool SessionState::apply_update_criteria(
     session_level_key_ = session_uc.updated_session_level_key;
   }
   for (const auto& it : session_uc.monitor_credit_map) {
-    auto key           = it.first;
-    auto credit_update = it.second;
-    apply_monitor_updates(key, credit_update);
+    apply_monitor_updates(it.first, it.second);
   }
   for (const auto& it : session_uc.monitor_credit_to_install) {
-    auto key            = it.first;
-    auto stored_monitor = it.second;
-    monitor_map_[key]   = std::make_unique<Monitor>(stored_monitor);
+    monitor_map_[it.first] = std::make_unique<Monitor>(it.second);
+    mark_monitor_if_reportable(it.first, monitor_map_[it.first].get());
   }
 
   if (session_uc.updated_pdp_end_time > 0) {
@@ -594,10 +632,17 @@ optional<RuleStats> SessionState::get_rule_delta(
   policy_version_and_stats_[rule_id].stats_map[rule_version] =
       RuleStats(used_tx, used_rx, dropped_tx, dropped_rx);
 
-  // When policy_version_and_stats_ is updated, we update the whole map in UC
-  // for now
+  // The UC carries the full map, but only copy it wholesale on the first
+  // touched rule. Subsequent reports in the same batch only refresh their own
+  // entry, so absorbing a large RuleRecordTable does not copy the whole map
+  // once per record.
   if (session_uc) {
-    session_uc->policy_version_and_stats = policy_version_and_stats_;
+    if (session_uc->policy_version_and_stats) {
+      (*session_uc->policy_version_and_stats)[rule_id] =
+          policy_version_and_stats_[rule_id];
+    } else {
+      session_uc->policy_version_and_stats = policy_version_and_stats_;
+    }
   }
   return ret;
 }
@@ -624,9 +669,11 @@ void SessionState::add_rule_usage(
 
   if (dynamic_rules_.get_charging_key_for_rule_id(rule_id, &charging_key) ||
       static_rules_.get_charging_key_for_rule_id(rule_id, &charging_key)) {
-    MLOG(MINFO) << "Updating used charging credit for Rule=" << rule_id
-                << " Rating Group=" << charging_key.rating_group
-                << " Service Identifier=" << charging_key.service_identifier;
+    // This is the hottest path in sessiond during usage reporting; keep
+    // per-record logging at debug level
+    MLOG(MDEBUG) << "Updating used charging credit for Rule=" << rule_id
+                 << " Rating Group=" << charging_key.rating_group
+                 << " Service Identifier=" << charging_key.service_identifier;
     auto it = credit_map_.find(charging_key);
     if (it != credit_map_.end()) {
       SessionCreditUpdateCriteria* credit_uc =
@@ -640,11 +687,14 @@ void SessionState::add_rule_usage(
                    << " not found, not adding the usage";
     }
   }
-  std::string monitoring_key;
+  // Reused scratch buffer so absorbing a large RuleRecordTable does not
+  // allocate a fresh monitoring key string per record
+  std::string& monitoring_key = scratch_monitoring_key_;
+  monitoring_key.clear();
   if (dynamic_rules_.get_monitoring_key_for_rule_id(rule_id, &monitoring_key) ||
       static_rules_.get_monitoring_key_for_rule_id(rule_id, &monitoring_key)) {
-    MLOG(MINFO) << "Updating used monitoring credit for Rule=" << rule_id
-                << " Monitoring Key=" << monitoring_key;
+    MLOG(MDEBUG) << "Updating used monitoring credit for Rule=" << rule_id
+                 << " Monitoring Key=" << monitoring_key;
     add_to_monitor(monitoring_key, delta.tx, delta.rx, session_uc);
   }
   if (session_level_key_ != "" && monitoring_key != session_level_key_) {
@@ -776,13 +826,21 @@ bool SessionState::is_terminating() {
 void SessionState::get_monitor_updates(
     UpdateSessionRequest* update_request_out,
     SessionStateUpdateCriteria* session_uc) {
-  for (auto& monitor_pair : monitor_map_) {
-    if (!monitor_pair.second->should_send_update()) {
-      continue;  // no update
+  // Only monitors flagged at accounting time are visited; with 10+ monitors
+  // per session this replaces a full map walk per report cycle. Each flag is
+  // a hint and is revalidated against the live monitor before reporting.
+  auto pending_it = monitors_pending_update_.begin();
+  while (pending_it != monitors_pending_update_.end()) {
+    const std::string mkey = *pending_it;
+    auto monitor_it        = monitor_map_.find(mkey);
+    if (monitor_it == monitor_map_.end() ||
+        !monitor_it->second->should_send_update()) {
+      // The monitor was deleted or re-credited since it was flagged
+      pending_it = monitors_pending_update_.erase(pending_it);
+      continue;
     }
 
-    auto mkey      = monitor_pair.first;
-    auto& credit   = monitor_pair.second->credit;
+    auto& credit   = monitor_it->second->credit;
     auto credit_uc = get_monitor_uc(mkey, session_uc);
 
     if (curr_state_ == SESSION_RELEASED) {
@@ -791,6 +849,8 @@ void SessionState::get_monitor_updates(
           << " is in Session Released state. Not sending update to the core"
              "for monitor "
           << mkey;
+      // Keep the flag so the report goes out if the session leaves RELEASED
+      ++pending_it;
       continue;  // no update
     }
 
@@ -809,7 +869,7 @@ void SessionState::get_monitor_updates(
 
     auto usage = credit.get_usage_for_reporting(credit_uc);
     auto update =
-        make_usage_monitor_update(usage, mkey, monitor_pair.second->level);
+        make_usage_monitor_update(usage, mkey, monitor_it->second->level);
     auto new_req = update_request_out->mutable_usage_monitors()->Add();
 
     add_common_fields_to_usage_monitor_update(new_req);
@@ -819,6 +879,7 @@ void SessionState::get_monitor_updates(
     if (session_uc) {
       session_uc->request_number_increment++;
     }
+    pending_it = monitors_pending_update_.erase(pending_it);
   }
 }
 
@@ -840,8 +901,7 @@ void SessionState::add_common_fields_to_usage_monitor_update(
 }
 
 void SessionState::get_updates(
-    UpdateSessionRequest* update_request_out,
-    std::vector<std::unique_ptr<ServiceAction>>* actions_out,
+    UpdateSessionRequest* update_request_out, ServiceActionBatch* actions_out,
     SessionStateUpdateCriteria* session_uc) {
   if (curr_state_ != SESSION_ACTIVE) return;
   get_charging_updates(update_request_out, actions_out, session_uc);
@@ -1682,6 +1742,15 @@ std::vector<PolicyRule> SessionState::get_all_final_unit_rules() {
   return rules;
 }
 
+bool SessionState::is_credit_near_exhaustion(float threshold) const {
+  for (const auto& credit_pair : credit_map_) {
+    if (credit_pair.second->credit.is_quota_exhausted(threshold)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void SessionState::handle_update_failure(
     const UpdateRequests& failed_requests,
     SessionStateUpdateCriteria* session_uc) {
@@ -1739,6 +1808,7 @@ bool SessionState::receive_charging_credit(
     grant->credit.mark_failure(update.result_code(), credit_uc);
   }
   grant->receive_charging_grant(update, credit_uc);
+  grant->precompile_final_action_rules(static_rules_);
 
   if (grant->reauth_state == REAUTH_PROCESSING) {
     grant->set_reauth_state(REAUTH_NOT_NEEDED, credit_uc);
@@ -1768,6 +1838,7 @@ bool SessionState::init_charging_credit(
   ChargingGrant charging_grant;
   charging_grant.credit = SessionCredit(SERVICE_ENABLED, update.limit_type());
   charging_grant.receive_charging_grant(update);
+  charging_grant.precompile_final_action_rules(static_rules_);
   if (session_uc) {
     session_uc->charging_credit_to_install[CreditKey(update)] =
         charging_grant.marshal();
@@ -1952,8 +2023,7 @@ CreditUsageUpdate SessionState::make_credit_usage_update_req(
 }
 
 void SessionState::get_charging_updates(
-    UpdateSessionRequest* update_request_out,
-    std::vector<std::unique_ptr<ServiceAction>>* actions_out,
+    UpdateSessionRequest* update_request_out, ServiceActionBatch* actions_out,
     SessionStateUpdateCriteria* session_uc) {
   for (auto& credit_pair : credit_map_) {
     auto& key                              = credit_pair.first;
@@ -1961,7 +2031,6 @@ void SessionState::get_charging_updates(
     SessionCreditUpdateCriteria* credit_uc = get_credit_uc(key, session_uc);
 
     auto action_type = grant->get_action(credit_uc);
-    auto action      = std::make_unique<ServiceAction>(action_type);
     switch (action_type) {
       case CONTINUE_SERVICE: {
         optional<CreditUsageUpdate> op_update =
@@ -1979,11 +2048,13 @@ void SessionState::get_charging_updates(
         }
         grant->set_service_state(SERVICE_REDIRECTED, credit_uc);
 
-        PolicyRule redirect_rule = grant->make_redirect_rule();
-        if (!is_gy_dynamic_rule_installed(redirect_rule.id())) {
+        const std::vector<PolicyRule>& fua_rules =
+            grant->get_final_action_rules(static_rules_);
+        if (!fua_rules.empty() &&
+            !is_gy_dynamic_rule_installed(fua_rules.front().id())) {
+          ServiceAction& action = actions_out->emplace_back(action_type);
           fill_service_action_for_redirect(
-              action, key, grant, redirect_rule, session_uc);
-          actions_out->push_back(std::move(action));
+              &action, key, grant, fua_rules.front(), session_uc);
         }
 
         break;
@@ -1995,19 +2066,21 @@ void SessionState::get_charging_updates(
         }
         grant->set_service_state(SERVICE_RESTRICTED, credit_uc);
 
-        fill_service_action_for_restrict(action, key, grant, session_uc);
-        actions_out->push_back(std::move(action));
+        ServiceAction& action = actions_out->emplace_back(action_type);
+        fill_service_action_for_restrict(&action, key, grant, session_uc);
         break;
       }
-      case ACTIVATE_SERVICE:
-        fill_service_action_for_activate(action, key, session_uc);
-        actions_out->push_back(std::move(action));
+      case ACTIVATE_SERVICE: {
+        ServiceAction& action = actions_out->emplace_back(action_type);
+        fill_service_action_for_activate(&action, key, session_uc);
         grant->set_suspended(false, credit_uc);
         break;
-      case TERMINATE_SERVICE:
-        fill_service_action_with_context(action, action_type, key);
-        actions_out->push_back(std::move(action));
+      }
+      case TERMINATE_SERVICE: {
+        ServiceAction& action = actions_out->emplace_back(action_type);
+        fill_service_action_with_context(&action, action_type, key);
         break;
+      }
       default:
         MLOG(MWARNING) << "Unexpected action type "
                        << service_action_type_to_str(action_type) << " for "
@@ -2059,7 +2132,7 @@ optional<CreditUsageUpdate> SessionState::get_update_for_continue_service(
 }
 
 void SessionState::fill_service_action_for_activate(
-    std::unique_ptr<ServiceAction>& action_p, const CreditKey& key,
+    ServiceAction* action_p, const CreditKey& key,
     SessionStateUpdateCriteria* session_uc) {
   std::vector<PolicyRule> static_rules, dynamic_rules;
   fill_service_action_with_context(action_p, ACTIVATE_SERVICE, key);
@@ -2079,27 +2152,21 @@ void SessionState::fill_service_action_for_activate(
 }
 
 void SessionState::fill_service_action_for_restrict(
-    std::unique_ptr<ServiceAction>& action_p, const CreditKey& key,
+    ServiceAction* action_p, const CreditKey& key,
     std::unique_ptr<ChargingGrant>& grant,
     SessionStateUpdateCriteria* session_uc) {
   fill_service_action_with_context(action_p, RESTRICT_ACCESS, key);
 
   RulesToProcess* gy_to_install = action_p->get_mutable_gy_rules_to_install();
-  for (auto& rule_id : grant->final_action_info.restrict_rules) {
-    PolicyRule rule;
-    if (!static_rules_.get_rule(rule_id, &rule)) {
-      MLOG(MWARNING) << "Static rule " << rule_id
-                     << " requested as a restrict rule is not found.";
-      continue;
-    }
+  for (const PolicyRule& rule : grant->get_final_action_rules(static_rules_)) {
     RuleLifetime lifetime;
     gy_to_install->push_back(insert_gy_rule(rule, lifetime, session_uc));
   }
 }
 
 void SessionState::fill_service_action_for_redirect(
-    std::unique_ptr<ServiceAction>& action_p, const CreditKey& key,
-    std::unique_ptr<ChargingGrant>& grant, PolicyRule redirect_rule,
+    ServiceAction* action_p, const CreditKey& key,
+    std::unique_ptr<ChargingGrant>& grant, const PolicyRule& redirect_rule,
     SessionStateUpdateCriteria* session_uc) {
   fill_service_action_with_context(action_p, REDIRECT, key);
 
@@ -2109,7 +2176,7 @@ void SessionState::fill_service_action_for_redirect(
 }
 
 void SessionState::fill_service_action_with_context(
-    std::unique_ptr<ServiceAction>& action, ServiceActionType action_type,
+    ServiceAction* action, ServiceActionType action_type,
     const CreditKey& key) {
   MLOG(MDEBUG) << "Subscriber " << get_imsi() << " rating group " << key
                << " action type " << service_action_type_to_str(action_type);
@@ -2183,6 +2250,7 @@ bool SessionState::receive_monitor(
     const auto& gsu = update.credit().granted_units();
     it->second->credit.receive_credit(gsu, credit_uc);
   }
+  mark_monitor_if_reportable(mkey, it->second.get());
 
   return true;
 }
@@ -2203,6 +2271,7 @@ void SessionState::apply_monitor_updates(
     }
     MLOG(MINFO) << session_id_ << " Erasing monitor " << key;
     monitor_map_.erase(key);
+    monitors_pending_update_.erase(key);
     return;
   }
 
@@ -2211,6 +2280,7 @@ void SessionState::apply_monitor_updates(
 
   // Credit merging
   credit.apply_update_criteria(credit_uc);
+  mark_monitor_if_reportable(key, charging_grant.get());
 }
 
 uint64_t SessionState::get_monitor(
@@ -2260,6 +2330,9 @@ bool SessionState::add_to_monitor(
                 << ". Will remove monitor after update is sent";
     it->second->credit.set_report_last_credit(true, credit_uc);
   }
+  // Threshold crossing is detected here, in the accounting pass, so the
+  // report cycle does not have to walk every monitor looking for it
+  mark_monitor_if_reportable(key, it->second.get());
   return true;
 }
 
@@ -2300,9 +2373,19 @@ bool SessionState::init_new_monitor(
         monitor->marshal();
   }
   monitor_map_[update.credit().monitoring_key()] = std::move(monitor);
+  mark_monitor_if_reportable(
+      update.credit().monitoring_key(),
+      monitor_map_[update.credit().monitoring_key()].get());
   return true;
 }
 
+void SessionState::mark_monitor_if_reportable(
+    const std::string& key, Monitor* monitor) {
+  if (monitor->should_send_update()) {
+    monitors_pending_update_.insert(key);
+  }
+}
+
 void SessionState::update_session_level_key(
     const UsageMonitoringUpdateResponse& update,
     SessionStateUpdateCriteria* session_uc) {
@@ -31,19 +31,26 @@
 #include "RuleStore.h"
 #include "SessionCredit.h"
 #include "SessionReporter.h"
+#include "SmallMap.h"
 #include "StoredState.h"
 #include "Types.h"
 
 namespace magma {
 using std::experimental::optional;
-typedef std::unordered_map<
-    CreditKey, std::unique_ptr<ChargingGrant>, decltype(&ccHash),
-    decltype(&ccEqual)>
+// Almost all sessions carry one or two charging/monitoring keys, so the
+// per-session credit maps use the inline small-map container instead of a
+// full hash map
+constexpr size_t SESSION_CREDIT_MAP_INLINE_ENTRIES = 4;
+typedef SmallMap<
+    CreditKey, std::unique_ptr<ChargingGrant>,
+    SESSION_CREDIT_MAP_INLINE_ENTRIES, decltype(&ccHash), decltype(&ccEqual)>
     CreditMap;
 typedef std::unordered_map<
     CreditKey, SessionCredit::Summary, decltype(&ccHash), decltype(&ccEqual)>
     ChargingCreditSummaries;
-typedef std::unordered_map<std::string, std::unique_ptr<Monitor>> MonitorMap;
+typedef SmallMap<
+    std::string, std::unique_ptr<Monitor>, SESSION_CREDIT_MAP_INLINE_ENTRIES>
+    MonitorMap;
 
 // Used to transform the proto message RuleSet into a more useful structure
 struct RuleSetToApply {
@@ -121,6 +128,12 @@ class SessionState {
     uint32_t ver_no;
     NodeId nodeId;
     FSid Seid;
+    /* Incremental UPF sync: version the carried rule set is based on
+     * (0 = full state) and checksum over the full (pdr_id, pdr_version)
+     * set for the UPF-side audit. Filled by SessionStateEnforcer.
+     */
+    uint32_t upf_base_version;
+    uint64_t state_checksum;
     // 5G specific extension routines
   };
 
@@ -144,6 +157,15 @@ class SessionState {
   static std::unique_ptr<SessionState> unmarshal(
       const StoredSessionState& marshaled, StaticRuleStore& rule_store);
 
+  /**
+   * Session objects are materialized from the store and torn down again on
+   * every request, so allocation goes through a recycling block pool
+   * instead of hitting malloc/free for each session. See SessionState.cpp
+   * for the pool implementation.
+   */
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size);
+
   StoredSessionState marshal();
 
   // 5G processing constructor without response contxt as set-interface msg
@@ -212,8 +234,7 @@ class SessionState {
    */
   void get_updates(
       UpdateSessionRequest* update_request_out,
-      std::vector<std::unique_ptr<ServiceAction>>* actions_out,
-      SessionStateUpdateCriteria* session_uc);
+      ServiceActionBatch* actions_out, SessionStateUpdateCriteria* session_uc);
 
   bool is_terminating();
 
@@ -255,6 +276,14 @@ class SessionState {
 
   std::vector<PolicyRule> get_all_final_unit_rules();
 
+  /**
+   * is_credit_near_exhaustion returns true if any charging credit of the
+   * session has used at least the given fraction of its granted quota.
+   * Used by the stats poller to tighten polling for sessions that are
+   * about to run out.
+   */
+  bool is_credit_near_exhaustion(float threshold) const;
+
   /**
    * get_total_credit_usage returns the tx and rx of the session,
    * accounting for all unique keys (charging and monitoring) used by all
@@ -560,7 +589,7 @@ class SessionState {
 
   std::string& get_session_level_key() { return session_level_key_; }
 
-  bool apply_update_criteria(SessionStateUpdateCriteria session_uc);
+  bool apply_update_criteria(const SessionStateUpdateCriteria& session_uc);
 
   StatsPerPolicy get_policy_stats(std::string rule_id);
 
@@ -793,9 +822,19 @@ class SessionState {
   MonitorMap monitor_map_;
   std::string session_level_key_;
 
+  // Monitoring keys that may need a usage report, flagged at accounting time
+  // so get_monitor_updates visits only monitors that crossed their threshold
+  // instead of walking the whole map on every report cycle. Entries are
+  // hints and are revalidated against the live monitor before reporting.
+  std::set<std::string> monitors_pending_update_;
+
   // PolicyID->DedicatedBearerID used for 4G bearer/QoS management
   BearerIDByPolicyID bearer_id_by_policy_;
 
+  // Scratch buffer reused by add_rule_usage to avoid a per-record monitoring
+  // key allocation while absorbing rule record tables
+  std::string scratch_monitoring_key_;
+
  private:
   /**
    * For this session, add the CreditUsageUpdate to the UpdateSessionRequest.
@@ -806,8 +845,7 @@ class SessionState {
    */
   void get_charging_updates(
       UpdateSessionRequest* update_request_out,
-      std::vector<std::unique_ptr<ServiceAction>>* actions_out,
-      SessionStateUpdateCriteria* session_uc);
+      ServiceActionBatch* actions_out, SessionStateUpdateCriteria* session_uc);
 
   /**
    * @brief Get a CreditUsageUpdate for the case where we want to continue
@@ -822,21 +860,21 @@ class SessionState {
       SessionStateUpdateCriteria* session_uc);
 
   void fill_service_action_for_activate(
-      std::unique_ptr<ServiceAction>& action, const CreditKey& key,
+      ServiceAction* action, const CreditKey& key,
       SessionStateUpdateCriteria* session_uc);
 
   void fill_service_action_for_restrict(
-      std::unique_ptr<ServiceAction>& action_p, const CreditKey& key,
+      ServiceAction* action_p, const CreditKey& key,
       std::unique_ptr<ChargingGrant>& grant,
       SessionStateUpdateCriteria* session_uc);
 
   void fill_service_action_for_redirect(
-      std::unique_ptr<ServiceAction>& action_p, const CreditKey& key,
-      std::unique_ptr<ChargingGrant>& grant, PolicyRule redirect_rule,
+      ServiceAction* action_p, const CreditKey& key,
+      std::unique_ptr<ChargingGrant>& grant, const PolicyRule& redirect_rule,
       SessionStateUpdateCriteria* session_uc);
 
   void fill_service_action_with_context(
-      std::unique_ptr<ServiceAction>& action, ServiceActionType action_type,
+      ServiceAction* action, ServiceActionType action_type,
       const CreditKey& key);
 
   void apply_charging_credit_update(
@@ -903,6 +941,10 @@ class SessionState {
   SessionCreditUpdateCriteria* get_monitor_uc(
       const std::string& key, SessionStateUpdateCriteria* session_uc);
 
+  // Flag the key for the next report cycle when its monitor just became
+  // reportable; called wherever monitor accounting mutates credit
+  void mark_monitor_if_reportable(const std::string& key, Monitor* monitor);
+
   void fill_protos_tgpp_context(magma::lte::TgppContext* tgpp_context) const;
 
   void get_event_trigger_updates(
@@ -20,6 +20,7 @@
   Description 	Objects run in main thread context invoked by folly event
 *****************************************************************************/
 
+#include <algorithm>
 #include <string>
 #include <time.h>
 #include <utility>
@@ -49,12 +50,21 @@ void call_back_upf(grpc::Status, magma::UPFSessionContextState response) {
   const std::string session_id = response.session_snapshot().subscriber_id();
   MLOG(MDEBUG) << " Async Response received from UPF: imsi " << imsi
                << " local fteid : " << fteid;
-  conv_session_enforcer->get_event_base().runInEventBaseThread([imsi, fteid,
-                                                                version]() {
-    /* Update the state change, and notifiy to AMF */
-    // For now fteid will be zero in all cases
-    conv_session_enforcer->m5g_process_response_from_upf(imsi, fteid, version);
-  });
+  if (response.cause_info().cause_ie() ==
+      magma::CauseIE::STATE_CHECKSUM_MISMATCH) {
+    conv_session_enforcer->get_event_base(imsi).runInEventBaseThread(
+        [imsi, fteid]() {
+          conv_session_enforcer->m5g_handle_upf_checksum_mismatch(imsi, fteid);
+        });
+    return;
+  }
+  conv_session_enforcer->get_event_base(imsi).runInEventBaseThread(
+      [imsi, fteid, version]() {
+        /* Update the state change, and notifiy to AMF */
+        // For now fteid will be zero in all cases
+        conv_session_enforcer->m5g_process_response_from_upf(
+            imsi, fteid, version);
+      });
 }
 
 /*constructor*/
@@ -83,7 +93,26 @@ void SessionStateEnforcer::attachEventBase(folly::EventBase* evb) {
   evb_ = evb;
 }
 
+void SessionStateEnforcer::start_session_shards(uint32_t num_shards) {
+  for (uint32_t i = 0; i < num_shards; i++) {
+    auto shard_evb = std::make_unique<folly::EventBase>();
+    shard_threads_.emplace_back(
+        [evb = shard_evb.get()]() { evb->loopForever(); });
+    shard_evbs_.push_back(std::move(shard_evb));
+  }
+  if (num_shards) {
+    MLOG(MINFO) << "Started " << num_shards
+                << " event loop shards for 5G session processing";
+  }
+}
+
 void SessionStateEnforcer::stop() {
+  for (auto& shard_evb : shard_evbs_) {
+    shard_evb->terminateLoopSoon();
+  }
+  for (auto& shard_thread : shard_threads_) {
+    shard_thread.join();
+  }
   evb_->terminateLoopSoon();
 }
 
@@ -91,6 +120,14 @@ folly::EventBase& SessionStateEnforcer::get_event_base() {
   return *evb_;
 }
 
+folly::EventBase& SessionStateEnforcer::get_event_base(
+    const std::string& imsi) {
+  if (shard_evbs_.empty()) {
+    return *evb_;
+  }
+  return *shard_evbs_[std::hash<std::string>{}(imsi) % shard_evbs_.size()];
+}
+
 bool SessionStateEnforcer::m5g_init_session_credit(
     SessionMap& session_map, const std::string& imsi,
     const std::string& session_id, const SessionConfig& cfg) {
@@ -312,7 +349,7 @@ void SessionStateEnforcer::m5g_start_session_termination(
                << session_id << " in " << session_force_termination_timeout_ms_
                << "ms";
 
-  evb_->runAfterDelay(
+  get_event_base(imsi).runAfterDelay(
       [this, imsi, session_id] {
         m5g_handle_termination_on_timeout(imsi, session_id);
       },
@@ -384,6 +421,11 @@ void SessionStateEnforcer::m5g_complete_termination(
   session_uc.is_session_ended = true;
   /*Removing session from map*/
   session_map[imsi].erase(*session_it);
+  {
+    std::lock_guard<std::mutex> lock(upf_sync_state_lock_);
+    upf_acked_version_.erase(session_id);
+    upf_sync_count_.erase(session_id);
+  }
   MLOG(MDEBUG) << session_id << " deleted from SessionMap";
   /* If it is last session terminated and no session left for this IMSI
    * remove the imsi as well
@@ -446,6 +488,29 @@ void SessionStateEnforcer::m5g_pdr_rules_change_and_update_upf(
   return;
 }
 
+/* FNV-1a over the (pdr_id, pdr_version) pairs in pdr_id order. The UPF
+ * computes the same checksum over its mirrored rule ledger, which is how
+ * drift in the incremental sync gets detected.
+ */
+static uint64_t pdr_state_checksum(const std::vector<SetGroupPDR>& rules) {
+  std::vector<std::pair<uint32_t, uint32_t>> entries;
+  entries.reserve(rules.size());
+  for (const auto& rule : rules) {
+    entries.emplace_back(rule.pdr_id(), rule.pdr_version());
+  }
+  std::sort(entries.begin(), entries.end());
+  uint64_t checksum = 14695981039346656037ULL;
+  for (const auto& entry : entries) {
+    uint64_t word =
+        (static_cast<uint64_t>(entry.first) << 32) | entry.second;
+    for (int shift = 0; shift < 64; shift += 8) {
+      checksum ^= (word >> shift) & 0xff;
+      checksum *= 1099511628211ULL;
+    }
+  }
+  return checksum;
+}
+
 void SessionStateEnforcer::m5g_send_session_request_to_upf(
     const std::unique_ptr<SessionState>& session) {
   // Update to UPF
@@ -453,6 +518,38 @@ void SessionStateEnforcer::m5g_send_session_request_to_upf(
   session->sess_infocopy(&sess_info);
   // Set the node Id
   sess_info.nodeId.node_id = get_upf_node_id();
+  // Checksum always covers the full rule set so the UPF can audit its
+  // mirrored state even when only a delta is carried
+  sess_info.state_checksum = pdr_state_checksum(sess_info.pdr_rules);
+  const std::string session_id = session->get_session_id();
+  uint32_t acked_version       = 0;
+  bool audit_due               = false;
+  {
+    std::lock_guard<std::mutex> lock(upf_sync_state_lock_);
+    auto it = upf_acked_version_.find(session_id);
+    if (it != upf_acked_version_.end()) {
+      acked_version = it->second;
+    }
+    audit_due =
+        (++upf_sync_count_[session_id] % UPF_FULL_SYNC_AUDIT_INTERVAL) == 0;
+  }
+  if (acked_version && !audit_due) {
+    // Send only the rules changed since the version the UPF acknowledged
+    std::vector<SetGroupPDR> delta;
+    for (const auto& rule : sess_info.pdr_rules) {
+      if (rule.pdr_version() > static_cast<int32_t>(acked_version)) {
+        delta.push_back(rule);
+      }
+    }
+    /* An empty rule set would be rejected by the UPF as a mandatory IE
+     * miss, so push the full state when nothing newer exists; a delta as
+     * big as the full set gains nothing either
+     */
+    if (!delta.empty() && delta.size() < sess_info.pdr_rules.size()) {
+      sess_info.pdr_rules        = std::move(delta);
+      sess_info.upf_base_version = acked_version;
+    }
+  }
   pipelined_client_->set_upf_session(sess_info, call_back_upf);
   return;
 }
@@ -495,6 +592,13 @@ void SessionStateEnforcer::m5g_process_response_from_upf(
   auto session_update = SessionStore::get_default_session_update(session_map);
   auto session_id     = session->get_session_id();
   SessionStateUpdateCriteria& session_uc = session_update[imsi][session_id];
+  /* UPF is now in sync up to this version; subsequent pushes only need
+   * to carry rules changed after it
+   */
+  {
+    std::lock_guard<std::mutex> lock(upf_sync_state_lock_);
+    upf_acked_version_[session_id] = version;
+  }
   switch (session->get_state()) {
     case CREATED:
       session->set_fsm_state(ACTIVE, &session_uc);
@@ -527,6 +631,33 @@ void SessionStateEnforcer::m5g_process_response_from_upf(
   }
 }
 
+/* UPF detected drift between its mirrored rule ledger and our full-state
+ * checksum. Drop the acknowledged version so the next push carries the
+ * full rule set, and resend right away.
+ */
+void SessionStateEnforcer::m5g_handle_upf_checksum_mismatch(
+    const std::string& imsi, uint32_t teid) {
+  auto session_map = session_store_.read_sessions({imsi});
+  SessionSearchCriteria criteria(imsi, IMSI_AND_TEID, teid);
+  auto session_it = session_store_.find_session(session_map, criteria);
+  if (!session_it) {
+    MLOG(MERROR) << "No session found in SessionMap for IMSI " << imsi
+                 << " with teid " << teid;
+    return;
+  }
+  auto& session = **session_it;
+  MLOG(MWARNING) << "UPF state checksum mismatch for session "
+                 << session->get_session_id()
+                 << ", resending the full rule set";
+  {
+    std::lock_guard<std::mutex> lock(upf_sync_state_lock_);
+    upf_acked_version_.erase(session->get_session_id());
+  }
+  if (inc_rtx_counter(session)) {
+    m5g_send_session_request_to_upf(session);
+  }
+}
+
 /* To prepare response back to AMF
  * Fill the response structure from session context message
  * and call rpc of AmfServiceClient.
@@ -22,8 +22,11 @@ limitations under the License.
 
 #pragma once
 
+#include <memory>
 #include <unordered_map>
 #include <map>
+#include <mutex>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 
@@ -40,6 +43,9 @@ limitations under the License.
 #define DEFAULT_PDR_VERSION 1
 #define DEFAULT_PDR_ID 0
 #define DEFAULT_PDR_PRECEDENCE 32
+// Every Nth push to the UPF carries the full rule set instead of a delta,
+// so checksum drift is bounded even if an audit response is lost
+#define UPF_FULL_SYNC_AUDIT_INTERVAL 16
 
 namespace magma {
 
@@ -60,10 +66,23 @@ class SessionStateEnforcer {
 
   void attachEventBase(folly::EventBase* evb);
 
+  /* Spawn dedicated event loops for 5G session processing. Work for a
+   * SUPI is always queued on the shard selected by its hash, so
+   * per-session ordering is preserved while sessions on different shards
+   * proceed in parallel instead of queueing behind 4G traffic on the
+   * main event base. A count of 0 leaves all work on the main base.
+   */
+  void start_session_shards(uint32_t num_shards);
+
   void stop();
 
   folly::EventBase& get_event_base();
 
+  /* Event base owning all processing for the given SUPI; falls back to
+   * the main event base when sharding is not enabled.
+   */
+  folly::EventBase& get_event_base(const std::string& imsi);
+
   /*Member functions*/
   bool m5g_init_session_credit(
       SessionMap& session_map, const std::string& imsi,
@@ -99,6 +118,12 @@ class SessionStateEnforcer {
   void m5g_process_response_from_upf(
       const std::string& imsi, uint32_t teid, uint32_t version);
 
+  /* UPF reported drift between its mirrored rule ledger and our
+   * full-state checksum; resend the full rule set for the session
+   */
+  void m5g_handle_upf_checksum_mismatch(
+      const std::string& imsi, uint32_t teid);
+
   /* Send session requst to upf */
   void m5g_send_session_request_to_upf(
       const std::unique_ptr<SessionState>& session);
@@ -196,10 +221,20 @@ class SessionStateEnforcer {
   long session_force_termination_timeout_ms_;
   uint32_t session_max_rtx_count_;
   folly::EventBase* evb_;
+  // Per-SUPI event loop shards, empty unless start_session_shards ran
+  std::vector<std::unique_ptr<folly::EventBase>> shard_evbs_;
+  std::vector<std::thread> shard_threads_;
   std::chrono::seconds retry_timeout_;
   std::string upf_node_id_;
   uint32_t teid_counter_;
   std::string upf_node_ip_addr_;
+  /* Incremental UPF sync bookkeeping keyed by session id: last version
+   * the UPF acknowledged and a push counter driving the periodic full
+   * audit. Guarded by a lock since shard loops touch it concurrently.
+   */
+  std::mutex upf_sync_state_lock_;
+  std::unordered_map<std::string, uint32_t> upf_acked_version_;
+  std::unordered_map<std::string, uint32_t> upf_sync_count_;
 
   bool default_and_static_rule_init();
 
@@ -11,9 +11,16 @@
  * limitations under the License.
  */
 
+#include <arpa/inet.h>
+#include <folly/dynamic.h>
+#include <folly/json.h>
+
+#include <cstring>
 #include <utility>
 
 #include "magma_logging.h"
+#include "magma_sdt.h"
+#include "OperationalStatesHandler.h"
 #include "SessionState.h"
 #include "SessionStore.h"
 #include "StoredState.h"
@@ -21,6 +28,23 @@
 namespace magma {
 namespace lte {
 
+SessionStoreShardLock::SessionStoreShardLock(
+    std::array<std::mutex, SESSION_STORE_SHARD_COUNT>& locks,
+    std::set<size_t> shards)
+    : locks_(locks), shards_(std::move(shards)) {
+  // std::set iteration is ordered, so overlapping shard sets are always
+  // acquired in the same order
+  for (size_t shard : shards_) {
+    locks_[shard].lock();
+  }
+}
+
+SessionStoreShardLock::~SessionStoreShardLock() {
+  for (size_t shard : shards_) {
+    locks_[shard].unlock();
+  }
+}
+
 SessionStore::SessionStore(
     std::shared_ptr<StaticRuleStore> rule_store,
     std::shared_ptr<magma::MeteringReporter> metering_reporter)
@@ -37,15 +61,31 @@ SessionStore::SessionStore(
       metering_reporter_(metering_reporter) {}
 
 bool SessionStore::raw_write_sessions(SessionMap session_map) {
-  // return true;
+  auto subscriber_ids = SessionRead{};
+  for (const auto& it : session_map) {
+    subscriber_ids.insert(it.first);
+  }
+  SessionStoreShardLock lock(shard_locks_, shards_of(subscriber_ids));
+  for (const auto& it : session_map) {
+    update_index_for_subscriber(it.first, it.second);
+    update_op_state_snapshot(it.first, it.second);
+    update_session_snapshot(it.first, it.second);
+  }
   return store_client_->write_sessions(std::move(session_map));
 }
 
 SessionMap SessionStore::read_sessions(const SessionRead& req) {
+  SessionStoreShardLock lock(shard_locks_, shards_of(req));
+  return store_client_->read_sessions(req);
+}
+
+SessionMap SessionStore::read_sessions_for_update(const SessionRead& req) {
+  SessionStoreShardLock lock(shard_locks_, shards_of(req));
   return store_client_->read_sessions(req);
 }
 
 SessionMap SessionStore::read_all_sessions() {
+  SessionStoreShardLock lock(shard_locks_, all_shards());
   return store_client_->read_all_sessions();
 }
 
@@ -53,7 +93,17 @@ void SessionStore::set_and_save_reporting_flag(
     bool value, const UpdateSessionRequest& update_session_request,
     SessionUpdate& session_uc) {
   MLOG(MDEBUG) << "saving flag is_reporting = " << value << " on session store";
-  auto session_map = store_client_->read_all_sessions();
+  auto subscriber_ids = SessionRead{};
+  for (const CreditUsageUpdate& credit_update :
+       update_session_request.updates()) {
+    subscriber_ids.insert(credit_update.common_context().sid().id());
+  }
+  for (const UsageMonitoringUpdateRequest& monitor_update :
+       update_session_request.usage_monitors()) {
+    subscriber_ids.insert(monitor_update.sid());
+  }
+  SessionStoreShardLock lock(shard_locks_, shards_of(subscriber_ids));
+  auto session_map = store_client_->borrow_sessions(subscriber_ids);
 
   for (const CreditUsageUpdate& credit_update :
        update_session_request.updates()) {
@@ -114,7 +164,8 @@ void SessionStore::sync_request_numbers(const SessionUpdate& update_criteria) {
   for (const auto& it : update_criteria) {
     subscriber_ids.insert(it.first);
   }
-  auto session_map = store_client_->read_sessions(subscriber_ids);
+  SessionStoreShardLock lock(shard_locks_, shards_of(subscriber_ids));
+  auto session_map = store_client_->borrow_sessions(subscriber_ids);
 
   // Sync stored state so that subsequent reads have the right request_number
   MLOG(MDEBUG) << "Syncing request numbers into existing sessions";
@@ -136,8 +187,9 @@ void SessionStore::sync_request_numbers(const SessionUpdate& update_criteria) {
 }
 
 SessionMap SessionStore::read_sessions_for_deletion(const SessionRead& req) {
+  SessionStoreShardLock lock(shard_locks_, shards_of(req));
   auto session_map   = store_client_->read_sessions(req);
-  auto session_map_2 = store_client_->read_sessions(req);
+  auto session_map_2 = store_client_->borrow_sessions(req);
   // For all sessions of the subscriber, increment the request numbers
   for (const std::string& imsi : req) {
     for (auto& session : session_map_2[imsi]) {
@@ -152,6 +204,10 @@ bool SessionStore::create_sessions(
     const std::string& subscriber_id, SessionVector sessions) {
   auto session_map           = SessionMap{};
   session_map[subscriber_id] = std::move(sessions);
+  SessionStoreShardLock lock(shard_locks_, {shard_of(subscriber_id)});
+  update_index_for_subscriber(subscriber_id, session_map[subscriber_id]);
+  update_op_state_snapshot(subscriber_id, session_map[subscriber_id]);
+  update_session_snapshot(subscriber_id, session_map[subscriber_id]);
   store_client_->write_sessions(std::move(session_map));
   return true;
 }
@@ -162,20 +218,33 @@ bool SessionStore::update_sessions(const SessionUpdate& update_criteria) {
   for (const auto& it : update_criteria) {
     subscriber_ids.insert(it.first);
   }
-  auto session_map = store_client_->read_sessions(subscriber_ids);
+  SessionStoreShardLock lock(shard_locks_, shards_of(subscriber_ids));
+  auto session_map = store_client_->borrow_sessions(subscriber_ids);
   // Now attempt to modify the state
   for (auto& it : session_map) {
     auto imsi = it.first;
-    auto it2  = it.second.begin();
+    MAGMA_USDT2(
+        session_store_commit, magma_sdt_imsi_hash(imsi.c_str()),
+        it.second.size());
+    auto it2 = it.second.begin();
     while (it2 != it.second.end()) {
-      auto updates    = update_criteria.find(it.first)->second;
-      auto session_id = (*it2)->get_session_id();
-      if (updates.find(session_id) != updates.end()) {
-        auto update = updates[session_id];
+      // Look up the per-session criteria by reference so the credit maps
+      // inside are not copied on every commit
+      const auto& updates = update_criteria.find(it.first)->second;
+      auto session_id     = (*it2)->get_session_id();
+      auto update_it      = updates.find(session_id);
+      if (update_it != updates.end()) {
+        const SessionStateUpdateCriteria& update = update_it->second;
         if (!(*it2)->apply_update_criteria(update)) {
+          // A borrowed map must always be handed back to the store before
+          // bailing out, or the sessions would be lost with it
+          store_client_->return_borrowed_sessions(std::move(session_map));
           return false;
         }
         if (update.is_session_ended) {
+          // The session's ue_traffic counters were removed with it; drop
+          // the reporter's cached handles so they cannot go stale
+          metering_reporter_->remove_session(session_id);
           // TODO: Instead of deleting from session_map, mark as ended and
           //       no longer mark on read
           it2 = it.second.erase(it2);
@@ -194,10 +263,16 @@ bool SessionStore::update_sessions(const SessionUpdate& update_criteria) {
       ++it2;
     }
   }
-  return store_client_->write_sessions(std::move(session_map));
+  for (const auto& it : session_map) {
+    update_index_for_subscriber(it.first, it.second);
+    update_op_state_snapshot(it.first, it.second);
+    update_session_snapshot(it.first, it.second);
+  }
+  return store_client_->write_session_updates(session_map, update_criteria);
 }
 
 void SessionStore::initialize_metering_counter() {
+  SessionStoreShardLock lock(shard_locks_, all_shards());
   auto session_map = store_client_->read_all_sessions();
   for (auto& sessions_by_imsi : session_map) {
     const std::string imsi = sessions_by_imsi.first;
@@ -215,6 +290,217 @@ void SessionStore::initialize_metering_counter() {
   }
 }
 
+size_t SessionStore::shard_of(const std::string& subscriber_id) const {
+  return std::hash<std::string>{}(subscriber_id) % SESSION_STORE_SHARD_COUNT;
+}
+
+std::set<size_t> SessionStore::shards_of(
+    const SessionRead& subscriber_ids) const {
+  std::set<size_t> shards;
+  for (const std::string& subscriber_id : subscriber_ids) {
+    shards.insert(shard_of(subscriber_id));
+  }
+  return shards;
+}
+
+std::set<size_t> SessionStore::all_shards() const {
+  std::set<size_t> shards;
+  for (size_t shard = 0; shard < SESSION_STORE_SHARD_COUNT; shard++) {
+    shards.insert(shard);
+  }
+  return shards;
+}
+
+static std::string ip_index_key(
+    const std::string& imsi, const std::string& ip) {
+  return "ip|" + imsi + "|" + ip;
+}
+
+static std::string teid_index_key(const std::string& imsi, uint32_t teid) {
+  return "teid|" + imsi + "|" + std::to_string(teid);
+}
+
+static std::string bearer_index_key(
+    const std::string& imsi, uint32_t bearer_id) {
+  return "bearer|" + imsi + "|" + std::to_string(bearer_id);
+}
+
+bool SessionStore::parse_ue_ip(const std::string& ip, UeIpAddr* ip_out) {
+  memset(ip_out->addr, 0, sizeof(ip_out->addr));
+  if (inet_pton(AF_INET, ip.c_str(), ip_out->addr) == 1) {
+    ip_out->family = AF_INET;
+    return true;
+  }
+  if (inet_pton(AF_INET6, ip.c_str(), ip_out->addr) == 1) {
+    ip_out->family = AF_INET6;
+    return true;
+  }
+  return false;
+}
+
+void SessionStore::update_index_for_subscriber(
+    const std::string& subscriber_id, const SessionVector& sessions) {
+  std::lock_guard<std::mutex> lock(index_lock_);
+  // Replace all entries for the subscriber so stale keys from previous
+  // writes do not linger
+  auto keys_it = index_keys_by_imsi_.find(subscriber_id);
+  if (keys_it != index_keys_by_imsi_.end()) {
+    for (const std::string& key : keys_it->second) {
+      secondary_index_.erase(key);
+    }
+    keys_it->second.clear();
+  }
+  auto& keys       = index_keys_by_imsi_[subscriber_id];
+  auto& ip_entries = ue_ip_index_[subscriber_id];
+  ip_entries.clear();
+  for (const auto& session : sessions) {
+    const std::string session_id = session->get_session_id();
+    const auto& config           = session->get_config();
+    const auto& context          = config.common_context;
+    const size_t first_new_key   = keys.size();
+    // Index UE IPs in binary form so record lookups compare fixed-size
+    // keys; addresses that are not plain literals keep the string key
+    auto index_ue_ip = [&](const std::string& ip) {
+      UeIpAddr binary_ip;
+      if (parse_ue_ip(ip, &binary_ip)) {
+        ip_entries.emplace_back(binary_ip, session_id);
+      } else {
+        keys.push_back(ip_index_key(subscriber_id, ip));
+      }
+    };
+    if (!context.ue_ipv4().empty()) {
+      index_ue_ip(context.ue_ipv4());
+    }
+    if (!context.ue_ipv6().empty()) {
+      index_ue_ip(context.ue_ipv6());
+    }
+    if (context.teids().enb_teid() != 0) {
+      keys.push_back(
+          teid_index_key(subscriber_id, context.teids().enb_teid()));
+    }
+    if (context.teids().agw_teid() != 0) {
+      keys.push_back(
+          teid_index_key(subscriber_id, context.teids().agw_teid()));
+    }
+    if (context.rat_type() == RATType::TGPP_NR &&
+        session->get_upf_local_teid() != 0) {
+      keys.push_back(
+          teid_index_key(subscriber_id, session->get_upf_local_teid()));
+    }
+    if (context.rat_type() == RATType::TGPP_LTE && session->is_active()) {
+      keys.push_back(bearer_index_key(
+          subscriber_id,
+          config.rat_specific_context.lte_context().bearer_id()));
+    }
+    for (size_t i = first_new_key; i < keys.size(); i++) {
+      secondary_index_[keys[i]] = session_id;
+    }
+  }
+  if (ip_entries.empty()) {
+    ue_ip_index_.erase(subscriber_id);
+  }
+}
+
+void SessionStore::update_op_state_snapshot(
+    const std::string& subscriber_id, const SessionVector& sessions) {
+  if (sessions.empty()) {
+    std::lock_guard<std::mutex> lock(op_state_lock_);
+    op_state_snapshot_.erase(subscriber_id);
+    return;
+  }
+  folly::dynamic sessions_by_apn = folly::dynamic::object;
+  for (const auto& session : sessions) {
+    const auto apn = session->get_config().common_context.apn();
+    if (sessions_by_apn[apn].empty()) {
+      sessions_by_apn[apn] = folly::dynamic::array;
+    }
+    sessions_by_apn[apn].push_back(get_dynamic_session_state(session));
+  }
+  // Serialize outside the lock so concurrent commits only contend on the
+  // final map insert
+  std::string serialized = folly::toJson(sessions_by_apn);
+  std::lock_guard<std::mutex> lock(op_state_lock_);
+  op_state_snapshot_[subscriber_id] = std::move(serialized);
+}
+
+std::unordered_map<std::string, std::string>
+SessionStore::get_op_state_snapshot() {
+  std::lock_guard<std::mutex> lock(op_state_lock_);
+  return op_state_snapshot_;
+}
+
+void SessionStore::update_session_snapshot(
+    const std::string& subscriber_id, const SessionVector& sessions) {
+  if (sessions.empty()) {
+    std::lock_guard<std::mutex> lock(snapshot_lock_);
+    session_snapshots_.erase(subscriber_id);
+    snapshot_version_++;
+    return;
+  }
+  // Marshal outside the lock; the published vector is never touched again,
+  // so pinned readers dereference it without synchronization
+  auto version = std::make_shared<std::vector<StoredSessionState>>();
+  version->reserve(sessions.size());
+  for (const auto& session : sessions) {
+    version->push_back(session->marshal());
+  }
+  std::lock_guard<std::mutex> lock(snapshot_lock_);
+  session_snapshots_[subscriber_id] = std::move(version);
+  snapshot_version_++;
+}
+
+SessionStoreSnapshot SessionStore::get_sessions_snapshot() {
+  std::lock_guard<std::mutex> lock(snapshot_lock_);
+  return session_snapshots_;
+}
+
+uint64_t SessionStore::get_snapshot_version() {
+  std::lock_guard<std::mutex> lock(snapshot_lock_);
+  return snapshot_version_;
+}
+
+optional<std::string> SessionStore::find_session_id_in_index(
+    const SessionSearchCriteria& criteria) {
+  std::string key;
+  switch (criteria.search_type) {
+    case IMSI_AND_UE_IPV4:
+    case IMSI_AND_UE_IPV4_OR_IPV6: {
+      // Boundary parse of the textual record address; everything past this
+      // point compares the fixed-size binary form without allocating
+      UeIpAddr binary_ip;
+      if (!parse_ue_ip(criteria.secondary_key, &binary_ip)) {
+        key = ip_index_key(criteria.imsi, criteria.secondary_key);
+        break;
+      }
+      std::lock_guard<std::mutex> lock(index_lock_);
+      auto bucket = ue_ip_index_.find(criteria.imsi);
+      if (bucket == ue_ip_index_.end()) {
+        return {};
+      }
+      for (const auto& entry : bucket->second) {
+        if (entry.first == binary_ip) {
+          return entry.second;
+        }
+      }
+      return {};
+    }
+    case IMSI_AND_TEID:
+      key = teid_index_key(criteria.imsi, criteria.secondary_key_unit32);
+      break;
+    case IMSI_AND_BEARER:
+      key = bearer_index_key(criteria.imsi, criteria.secondary_key_unit32);
+      break;
+    default:
+      return {};
+  }
+  std::lock_guard<std::mutex> lock(index_lock_);
+  auto it = secondary_index_.find(key);
+  if (it == secondary_index_.end()) {
+    return {};
+  }
+  return it->second;
+}
+
 optional<SessionVector::iterator> SessionStore::find_session(
     SessionMap& session_map, SessionSearchCriteria criteria) {
   auto sm_it = session_map.find(criteria.imsi);
@@ -222,6 +508,19 @@ optional<SessionVector::iterator> SessionStore::find_session(
     return {};
   }
   auto& sessions = sm_it->second;
+
+  // Fast path: resolve the secondary key through the index maintained on
+  // writes, leaving only a session_id comparison per session. On a miss we
+  // fall back to evaluating the criteria against each session, which also
+  // covers the RAT-specific special cases below.
+  auto indexed_session_id = find_session_id_in_index(criteria);
+  if (indexed_session_id) {
+    for (auto it = sessions.begin(); it != sessions.end(); ++it) {
+      if ((*it)->get_session_id() == *indexed_session_id) {
+        return it;
+      }
+    }
+  }
   for (auto it = sessions.begin(); it != sessions.end(); ++it) {
     const auto& context = (*it)->get_config().common_context;
     switch (criteria.search_type) {
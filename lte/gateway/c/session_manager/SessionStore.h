@@ -16,10 +16,14 @@
 #include <folly/io/async/EventBaseManager.h>
 #include <lte/protos/session_manager.grpc.pb.h>
 
+#include <array>
+#include <cstring>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <utility>
 
 #include "MemoryStoreClient.h"
 #include "MeteringReporter.h"
@@ -33,9 +37,15 @@ namespace lte {
 using std::experimental::optional;
 
 // Value int represents the request numbers needed for requests to PCRF
-using SessionRead   = std::set<std::string>;
-using SessionUpdate = std::unordered_map<
-    std::string, std::unordered_map<std::string, SessionStateUpdateCriteria>>;
+using SessionRead = std::set<std::string>;
+// SessionUpdate is defined in StoreClient.h
+
+// Immutable commit-published view of the store: IMSI -> the marshaled
+// sessions written by that subscriber's last commit. The pointed-to vectors
+// are never mutated after publication, so holders can read them without any
+// locking.
+using SessionStoreSnapshot = std::unordered_map<
+    std::string, std::shared_ptr<const std::vector<StoredSessionState>>>;
 
 enum SessionSearchCriteriaType {
   IMSI_AND_APN             = 0,
@@ -66,6 +76,29 @@ struct SessionSearchCriteria {
         secondary_key_unit32(secondary_key_unit32) {}
 };
 
+// Number of IMSI hash shards guarding concurrent SessionStore access
+constexpr size_t SESSION_STORE_SHARD_COUNT = 64;
+
+/**
+ * RAII holder for a set of SessionStore shard locks. Shards are tracked in
+ * an ordered set, so locks are always acquired in increasing shard order to
+ * avoid deadlocks between callers touching overlapping shard sets.
+ */
+class SessionStoreShardLock {
+ public:
+  SessionStoreShardLock(
+      std::array<std::mutex, SESSION_STORE_SHARD_COUNT>& locks,
+      std::set<size_t> shards);
+  ~SessionStoreShardLock();
+
+  SessionStoreShardLock(SessionStoreShardLock const&) = delete;
+  SessionStoreShardLock& operator=(SessionStoreShardLock const&) = delete;
+
+ private:
+  std::array<std::mutex, SESSION_STORE_SHARD_COUNT>& locks_;
+  std::set<size_t> shards_;
+};
+
 /**
  * SessionStore acts as a broker to storage of sessiond state.
  *
@@ -78,6 +111,11 @@ struct SessionSearchCriteria {
  * should make a single read from SessionStore, and make a single write after
  * the request is serviced. The transactional nature of how requests should be
  * handled is intended to keep sessiond restartable in case of crashes.
+ *
+ * Concurrency is managed with hash-sharded per-IMSI locks. Each storage
+ * operation only holds the locks for the shards covering the touched
+ * subscribers, so requests for different subscribers can be serviced
+ * concurrently from different threads.
  */
 class SessionStore {
  public:
@@ -98,6 +136,32 @@ class SessionStore {
    */
   bool is_ready() { return store_client_->is_ready(); };
 
+  /**
+   * @brief Return a copy of the cached operational state snapshot
+   * (IMSI -> serialized per-APN session state JSON). The snapshot is
+   * refreshed at commit time for just the subscribers that were written, so
+   * serving it does not scan the store or re-serialize unchanged sessions.
+   */
+  std::unordered_map<std::string, std::string> get_op_state_snapshot();
+
+  /**
+   * @brief Return the latest commit-published version of every subscriber's
+   * sessions. The returned map holds shared pointers into immutable
+   * per-subscriber versions; copying the map pins those versions, so the
+   * caller can iterate a consistent view for as long as it likes without
+   * blocking writers, which keep publishing newer versions in the meantime.
+   * A pinned version is reclaimed when its last holder releases it.
+   * Intended for heavy read-only workloads (audits, analytics) that would
+   * otherwise serialize behind every shard lock via read_all_sessions.
+   */
+  SessionStoreSnapshot get_sessions_snapshot();
+
+  /**
+   * @return Monotonic counter incremented on every commit, so snapshot
+   * consumers can tell whether the store changed between two reads
+   */
+  uint64_t get_snapshot_version();
+
   /**
    * Writes the session map directly to the store. Note that the existing map
    * will be overwriten
@@ -115,6 +179,19 @@ class SessionStore {
    */
   SessionMap read_sessions(const SessionRead& req);
 
+  /**
+   * Read the last written values for the requested sessions ahead of a
+   * read-modify-write cycle. Only the shards covering the requested
+   * subscribers are locked for the duration of the read; the subsequent
+   * update_sessions call re-acquires the same shards when applying the
+   * update criteria, so concurrent requests for other subscribers are not
+   * serialized behind this one.
+   * @param req
+   * @return Last written values for requested sessions. Returns an empty
+   *         vector for subscribers that do not have active sessions.
+   */
+  SessionMap read_sessions_for_update(const SessionRead& req);
+
   /**
    * Read the last written values for all existing sessions through the
    * storage interface.
@@ -206,10 +283,107 @@ class SessionStore {
    */
   void initialize_metering_counter();
 
+ private:
+  /**
+   * Binary form of a UE IP address, used as a secondary-index key so
+   * per-record session lookups hash the subscriber once and compare
+   * fixed-size bytes instead of building and hashing a concatenated
+   * string key.
+   */
+  struct UeIpAddr {
+    uint8_t family;  // AF_INET or AF_INET6
+    uint8_t addr[16];
+
+    bool operator==(const UeIpAddr& other) const {
+      return family == other.family &&
+             memcmp(addr, other.addr, sizeof(addr)) == 0;
+    }
+  };
+
+  /**
+   * Parse a textual UE IP into its binary form. The protos keep textual
+   * addresses on the wire, so this runs once per record at the boundary.
+   * @return False when the text is not a plain IPv4/IPv6 literal; such
+   * addresses stay reachable through the string index instead
+   */
+  static bool parse_ue_ip(const std::string& ip, UeIpAddr* ip_out);
+
+  /**
+   * Re-index the secondary lookup keys (UE IP, TEID, bearer ID) for a
+   * subscriber from their current session vector. Called whenever a
+   * subscriber's sessions are written back, so the index always reflects
+   * the last committed state.
+   */
+  void update_index_for_subscriber(
+      const std::string& subscriber_id, const SessionVector& sessions);
+
+  /**
+   * @return The session_id indexed under the criteria's secondary key, if
+   * one was recorded by the last write for that subscriber
+   */
+  optional<std::string> find_session_id_in_index(
+      const SessionSearchCriteria& criteria);
+
+  /**
+   * Re-serialize the operational state entry for a subscriber from their
+   * current session vector. Called at commit time alongside
+   * update_index_for_subscriber; empty session vectors drop the entry.
+   */
+  void update_op_state_snapshot(
+      const std::string& subscriber_id, const SessionVector& sessions);
+
+  /**
+   * Publish a fresh immutable version of a subscriber's sessions for
+   * get_sessions_snapshot readers. Called at commit time alongside
+   * update_op_state_snapshot; empty session vectors drop the entry.
+   */
+  void update_session_snapshot(
+      const std::string& subscriber_id, const SessionVector& sessions);
+
+  /**
+   * @return Shard index that guards the given subscriber's sessions
+   */
+  size_t shard_of(const std::string& subscriber_id) const;
+
+  /**
+   * @return Ordered set of shard indices covering the given subscribers
+   */
+  std::set<size_t> shards_of(const SessionRead& subscriber_ids) const;
+
+  /**
+   * @return Ordered set of all shard indices, used by whole-store operations
+   */
+  std::set<size_t> all_shards() const;
+
  private:
   std::shared_ptr<StaticRuleStore> rule_store_;
   std::shared_ptr<StoreClient> store_client_;
   std::shared_ptr<MeteringReporter> metering_reporter_;
+  std::array<std::mutex, SESSION_STORE_SHARD_COUNT> shard_locks_;
+  // Secondary index from namespaced lookup keys (UE IP, TEID, bearer ID) to
+  // session_id, so criteria searches do not have to evaluate per-session
+  // protobuf fields. Entries are replaced wholesale per subscriber on write.
+  std::mutex index_lock_;
+  std::unordered_map<std::string, std::string> secondary_index_;
+  std::unordered_map<std::string, std::vector<std::string>>
+      index_keys_by_imsi_;
+  // Binary UE IP -> session_id entries per subscriber, guarded by
+  // index_lock_ alongside secondary_index_. Subscribers rarely hold more
+  // than a few sessions, so once the IMSI bucket is found a short scan of
+  // fixed-size keys beats hashing a per-record concatenated string.
+  std::unordered_map<std::string, std::vector<std::pair<UeIpAddr, std::string>>>
+      ue_ip_index_;
+  // Commit-time snapshot of per-subscriber operational state served to
+  // magmad polls without touching the live store
+  std::mutex op_state_lock_;
+  std::unordered_map<std::string, std::string> op_state_snapshot_;
+  // Multi-version view for read-only consumers: commits swap in a freshly
+  // marshaled version for just the written subscriber, and a held
+  // shared_ptr keeps the old version alive until its last reader drops it.
+  // The lock only guards the pointer map, never the versions themselves.
+  std::mutex snapshot_lock_;
+  SessionStoreSnapshot session_snapshots_;
+  uint64_t snapshot_version_ = 0;
 };
 
 }  // namespace lte
@@ -79,66 +79,69 @@ void SetMessageManagerHandler::SetAmfSessionContext(
   // Print the message from AMF
   PrintGrpcMessage(static_cast<const google::protobuf::Message&>(request_cpy));
 
-  // Requested message from AMF to release the session
-  m5g_enforcer_->get_event_base().runInEventBaseThread([this, response_callback,
-                                                        request_cpy]() {
-    // extract values from proto
-    std::string imsi = request_cpy.common_context().sid().id();
-    std::string dnn  = request_cpy.common_context().apn();
-    // Fetch PDU session ID from rat_specific_context and
-    // pdu_id is unique to IMSI
-    uint32_t pdu_id = request_cpy.rat_specific_context()
-                          .m5gsm_session_context()
-                          .pdu_session_id();
-    // Fetch complete message from proto message
-    SessionConfig cfg = m5g_build_session_config(request_cpy);
-
-    /* Read the proto message and check for state. Get the config out of proto.
-     * Code for relase state, then creating
-     */
-    // Requested message from AMF to release the session
-    if (cfg.common_context.sm_session_state() == RELEASED_4) {
-      if (cfg.common_context.sm_session_version() == 0) {
-        MLOG(MERROR) << "Wrong version received from AMF for IMSI " << imsi
-                     << " but continuing release request";
-        Status status(grpc::OUT_OF_RANGE, "Version number Out of Range");
-        response_callback(status, SmContextVoid());
-        return;
-      }
-      MLOG(MINFO) << "Release request for session from IMSI: " << imsi
-                  << " pdu_id " << pdu_id;
-      /* Read the SessionMap from global session_store,
-       * if it is not found, it will be added w.r.t imsi
-       */
-      auto session_map = session_store_.read_sessions({imsi});
-      initiate_release_session(session_map, pdu_id, imsi);
-      response_callback(Status::OK, SmContextVoid());
-    } else {
-      // The Event Based main_thread invocation and runs to handle session state
-      MLOG(MDEBUG) << "Requested session from UE with IMSI: " << imsi
-                   << " PDU ID " << pdu_id;
+  // Requested message from AMF to release the session; processed on the
+  // event base shard owning this SUPI
+  const std::string shard_key = request_cpy.common_context().sid().id();
+  m5g_enforcer_->get_event_base(shard_key)
+      .runInEventBaseThread([this, response_callback, request_cpy]() {
+        // extract values from proto
+        std::string imsi = request_cpy.common_context().sid().id();
+        std::string dnn  = request_cpy.common_context().apn();
+        // Fetch PDU session ID from rat_specific_context and
+        // pdu_id is unique to IMSI
+        uint32_t pdu_id = request_cpy.rat_specific_context()
+                              .m5gsm_session_context()
+                              .pdu_session_id();
+        // Fetch complete message from proto message
+        SessionConfig cfg = m5g_build_session_config(request_cpy);
 
-      /* Message may be intial or modification message. Only taken care
-       * intial message. Check if it's initial message
-       */
-      if ((cfg.rat_specific_context.m5gsm_session_context().request_type() ==
-           INITIAL_REQUEST) &&
-          (cfg.common_context.sm_session_state() == CREATING_0)) {
-        /* it's new UE establisment request and need to create the session
-         * context
+        /* Read the proto message and check for state. Get the config out of
+         * proto. Code for relase state, then creating
          */
-        auto session_map = session_store_.read_sessions({imsi});
-        send_create_session(session_map, imsi, cfg, pdu_id);
-        response_callback(Status::OK, SmContextVoid());
-        return;
-      }
-      MLOG(MERROR)
-          << "AMF request type- Unhandled request type:"
-          << cfg.rat_specific_context.m5gsm_session_context().request_type();
-      Status status(grpc::UNKNOWN, "Unknown session state or request");
-      response_callback(status, SmContextVoid());
-    }
-  });
+        // Requested message from AMF to release the session
+        if (cfg.common_context.sm_session_state() == RELEASED_4) {
+          if (cfg.common_context.sm_session_version() == 0) {
+            MLOG(MERROR) << "Wrong version received from AMF for IMSI " << imsi
+                         << " but continuing release request";
+            Status status(grpc::OUT_OF_RANGE, "Version number Out of Range");
+            response_callback(status, SmContextVoid());
+            return;
+          }
+          MLOG(MINFO) << "Release request for session from IMSI: " << imsi
+                      << " pdu_id " << pdu_id;
+          /* Read the SessionMap from global session_store,
+           * if it is not found, it will be added w.r.t imsi
+           */
+          auto session_map = session_store_.read_sessions({imsi});
+          initiate_release_session(session_map, pdu_id, imsi);
+          response_callback(Status::OK, SmContextVoid());
+        } else {
+          // The Event Based main_thread invocation and runs to handle session
+          // state
+          MLOG(MDEBUG) << "Requested session from UE with IMSI: " << imsi
+                       << " PDU ID " << pdu_id;
+
+          /* Message may be intial or modification message. Only taken care
+           * intial message. Check if it's initial message
+           */
+          if ((cfg.rat_specific_context.m5gsm_session_context()
+                   .request_type() == INITIAL_REQUEST) &&
+              (cfg.common_context.sm_session_state() == CREATING_0)) {
+            /* it's new UE establisment request and need to create the session
+             * context
+             */
+            auto session_map = session_store_.read_sessions({imsi});
+            send_create_session(session_map, imsi, cfg, pdu_id);
+            response_callback(Status::OK, SmContextVoid());
+            return;
+          }
+          MLOG(MERROR) << "AMF request type- Unhandled request type:"
+                       << cfg.rat_specific_context.m5gsm_session_context()
+                              .request_type();
+          Status status(grpc::UNKNOWN, "Unknown session state or request");
+          response_callback(status, SmContextVoid());
+        }
+      });
 }
 
 /* Handling set message from AMF
@@ -154,29 +157,32 @@ void SetMessageManagerHandler::SetSmfNotification(
   PrintGrpcMessage(static_cast<const google::protobuf::Message&>(*notif));
   // Read the event type from the proto message
   auto& noti = *notif;
-  m5g_enforcer_->get_event_base().runInEventBaseThread([this, response_callback,
-                                                        noti]() {
-    NotifyUeEvents Uevent = noti.rat_specific_notification().notify_ue_event();
-    MLOG(MINFO) << "Notification of imsi: " << noti.common_context().sid().id()
-                << " from AMF  Event value:" << Uevent;
-    switch (Uevent) {
-      case PDU_SESSION_INACTIVE_NOTIFY:
-        pdu_session_inactive(noti, response_callback);
-        return;
-      case UE_IDLE_MODE_NOTIFY:
-        idle_mode_change_sessions_handle(noti, response_callback);
-        return;
-      case UE_PAGING_NOTIFY:
-        return;
-      case UE_PERIODIC_REG_ACTIVE_MODE_NOTIFY:
-        return;
-      case UE_SERVICE_REQUEST_ON_PAGING:
-        service_handle_request_on_paging(noti, response_callback);
-        return;
-      default:
-        return;
-    }
-  });
+  const std::string shard_key = noti.common_context().sid().id();
+  m5g_enforcer_->get_event_base(shard_key)
+      .runInEventBaseThread([this, response_callback, noti]() {
+        NotifyUeEvents Uevent =
+            noti.rat_specific_notification().notify_ue_event();
+        MLOG(MINFO) << "Notification of imsi: "
+                    << noti.common_context().sid().id()
+                    << " from AMF  Event value:" << Uevent;
+        switch (Uevent) {
+          case PDU_SESSION_INACTIVE_NOTIFY:
+            pdu_session_inactive(noti, response_callback);
+            return;
+          case UE_IDLE_MODE_NOTIFY:
+            idle_mode_change_sessions_handle(noti, response_callback);
+            return;
+          case UE_PAGING_NOTIFY:
+            return;
+          case UE_PERIODIC_REG_ACTIVE_MODE_NOTIFY:
+            return;
+          case UE_SERVICE_REQUEST_ON_PAGING:
+            service_handle_request_on_paging(noti, response_callback);
+            return;
+          default:
+            return;
+        }
+      });
 }
 /* Creeate respective SessionState and context*/
 void SetMessageManagerHandler::send_create_session(
@@ -0,0 +1,229 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace magma {
+
+/**
+ * Associative container optimized for maps that almost always hold a handful
+ * of entries, like the per-session charging and monitoring credit maps.
+ * Up to N entries are kept inline in a vector and looked up with a linear
+ * scan, so small maps cost one contiguous allocation instead of a bucket
+ * array plus a heap node per entry. Once the size exceeds N the entries
+ * spill into a std::unordered_map and stay there, so iterator and lookup
+ * behavior degrade gracefully for the rare large session.
+ *
+ * Only the subset of the std::unordered_map interface used by SessionState
+ * is provided. Inline entries live in a vector, so unlike unordered_map,
+ * references and iterators are invalidated by inserts and erases.
+ */
+template<
+    typename Key, typename T, std::size_t N,
+    typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class SmallMap {
+ public:
+  using value_type = std::pair<const Key, T>;
+  using Overflow   = std::unordered_map<Key, T, Hash, KeyEqual>;
+
+  class iterator {
+   public:
+    explicit iterator(value_type* pos) : in_inline_(true), pos_(pos) {}
+    explicit iterator(typename Overflow::iterator it)
+        : in_inline_(false), pos_(nullptr), overflow_it_(it) {}
+
+    value_type& operator*() { return in_inline_ ? *pos_ : *overflow_it_; }
+    value_type* operator->() {
+      return in_inline_ ? pos_ : &(*overflow_it_);
+    }
+    iterator& operator++() {
+      if (in_inline_) {
+        ++pos_;
+      } else {
+        ++overflow_it_;
+      }
+      return *this;
+    }
+    bool operator==(const iterator& other) const {
+      if (in_inline_ != other.in_inline_) {
+        return false;
+      }
+      return in_inline_ ? pos_ == other.pos_ :
+                          overflow_it_ == other.overflow_it_;
+    }
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+
+   private:
+    bool in_inline_;
+    value_type* pos_;
+    typename Overflow::iterator overflow_it_;
+  };
+
+  class const_iterator {
+   public:
+    explicit const_iterator(const value_type* pos)
+        : in_inline_(true), pos_(pos) {}
+    explicit const_iterator(typename Overflow::const_iterator it)
+        : in_inline_(false), pos_(nullptr), overflow_it_(it) {}
+
+    const value_type& operator*() const {
+      return in_inline_ ? *pos_ : *overflow_it_;
+    }
+    const value_type* operator->() const {
+      return in_inline_ ? pos_ : &(*overflow_it_);
+    }
+    const_iterator& operator++() {
+      if (in_inline_) {
+        ++pos_;
+      } else {
+        ++overflow_it_;
+      }
+      return *this;
+    }
+    bool operator==(const const_iterator& other) const {
+      if (in_inline_ != other.in_inline_) {
+        return false;
+      }
+      return in_inline_ ? pos_ == other.pos_ :
+                          overflow_it_ == other.overflow_it_;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return !(*this == other);
+    }
+
+   private:
+    bool in_inline_;
+    const value_type* pos_;
+    typename Overflow::const_iterator overflow_it_;
+  };
+
+  SmallMap() : SmallMap(N, Hash(), KeyEqual()) {}
+
+  // Mirrors the unordered_map (bucket_count, hash, equal) constructor so the
+  // CreditKey maps can keep passing &ccHash / &ccEqual
+  SmallMap(std::size_t bucket_count, Hash hasher, KeyEqual key_eq)
+      : key_eq_(key_eq),
+        overflow_(bucket_count, hasher, key_eq),
+        spilled_(false) {
+    entries_.reserve(N);
+  }
+
+  iterator begin() {
+    return spilled_ ? iterator(overflow_.begin()) :
+                      iterator(entries_.data());
+  }
+  iterator end() {
+    return spilled_ ? iterator(overflow_.end()) :
+                      iterator(entries_.data() + entries_.size());
+  }
+  const_iterator begin() const {
+    return spilled_ ? const_iterator(overflow_.begin()) :
+                      const_iterator(entries_.data());
+  }
+  const_iterator end() const {
+    return spilled_ ? const_iterator(overflow_.end()) :
+                      const_iterator(entries_.data() + entries_.size());
+  }
+
+  std::size_t size() const {
+    return spilled_ ? overflow_.size() : entries_.size();
+  }
+
+  bool empty() const { return size() == 0; }
+
+  iterator find(const Key& key) {
+    if (spilled_) {
+      return iterator(overflow_.find(key));
+    }
+    for (auto& entry : entries_) {
+      if (key_eq_(entry.first, key)) {
+        return iterator(&entry);
+      }
+    }
+    return end();
+  }
+
+  const_iterator find(const Key& key) const {
+    if (spilled_) {
+      return const_iterator(overflow_.find(key));
+    }
+    for (const auto& entry : entries_) {
+      if (key_eq_(entry.first, key)) {
+        return const_iterator(&entry);
+      }
+    }
+    return end();
+  }
+
+  T& operator[](const Key& key) {
+    if (spilled_) {
+      return overflow_[key];
+    }
+    for (auto& entry : entries_) {
+      if (key_eq_(entry.first, key)) {
+        return entry.second;
+      }
+    }
+    if (entries_.size() >= N) {
+      spill();
+      return overflow_[key];
+    }
+    entries_.emplace_back(key, T());
+    return entries_.back().second;
+  }
+
+  std::size_t erase(const Key& key) {
+    if (spilled_) {
+      return overflow_.erase(key);
+    }
+    // pair<const Key, T> is not move-assignable, so rebuild the inline
+    // vector without the erased entry; N is small enough that this is still
+    // cheaper than hash-map node churn
+    for (std::size_t i = 0; i < entries_.size(); i++) {
+      if (key_eq_(entries_[i].first, key)) {
+        std::vector<value_type> remaining;
+        remaining.reserve(N);
+        for (std::size_t j = 0; j < entries_.size(); j++) {
+          if (j != i) {
+            remaining.emplace_back(
+                entries_[j].first, std::move(entries_[j].second));
+          }
+        }
+        entries_ = std::move(remaining);
+        return 1;
+      }
+    }
+    return 0;
+  }
+
+ private:
+  void spill() {
+    for (auto& entry : entries_) {
+      overflow_.emplace(entry.first, std::move(entry.second));
+    }
+    entries_.clear();
+    spilled_ = true;
+  }
+
+  KeyEqual key_eq_;
+  std::vector<value_type> entries_;
+  Overflow overflow_;
+  bool spilled_;
+};
+
+}  // namespace magma
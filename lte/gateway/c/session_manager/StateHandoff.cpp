@@ -0,0 +1,178 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "StateHandoff.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "magma_logging.h"
+#include "SessionState.h"
+#include "StoredState.h"
+
+namespace magma {
+namespace lte {
+
+uint32_t StateHandoff::RESTORE_TIMEOUT_MS = 1000;
+
+// Wire format, host byte order (both ends always run on the same host):
+// uint32_t session count, then per session a uint32_t length followed by
+// the serialized StoredSessionState
+
+static bool write_full(int fd, const void* buf, size_t len) {
+  const char* p = static_cast<const char*>(buf);
+  while (len > 0) {
+    ssize_t n = write(fd, p, len);
+    if (n <= 0) {
+      return false;
+    }
+    p += n;
+    len -= n;
+  }
+  return true;
+}
+
+static bool read_full(int fd, void* buf, size_t len) {
+  char* p = static_cast<char*>(buf);
+  while (len > 0) {
+    ssize_t n = read(fd, p, len);
+    if (n <= 0) {
+      return false;
+    }
+    p += n;
+    len -= n;
+  }
+  return true;
+}
+
+static void serve_one_handoff(int conn_fd, SessionStore* store) {
+  SessionStoreSnapshot snapshot = store->get_sessions_snapshot();
+  uint32_t count                = 0;
+  for (const auto& it : snapshot) {
+    count += it.second->size();
+  }
+  if (!write_full(conn_fd, &count, sizeof(count))) {
+    return;
+  }
+  for (const auto& it : snapshot) {
+    for (const StoredSessionState& stored : *it.second) {
+      // serialize_stored_session takes a mutable reference, and the pinned
+      // snapshot version must stay untouched, so serialize a copy
+      StoredSessionState copy = stored;
+      std::string serialized  = serialize_stored_session(copy);
+      uint32_t len            = serialized.size();
+      if (!write_full(conn_fd, &len, sizeof(len)) ||
+          !write_full(conn_fd, serialized.data(), len)) {
+        return;
+      }
+    }
+  }
+  MLOG(MINFO) << "Handed off " << count << " sessions to successor";
+}
+
+void StateHandoff::serve(const std::string& socket_path, SessionStore* store) {
+  int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd < 0) {
+    MLOG(MERROR) << "Could not create state handoff socket: "
+                 << strerror(errno);
+    return;
+  }
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+  // Take over the socket name; the predecessor's listener becomes orphaned,
+  // which is fine since it is about to exit
+  unlink(socket_path.c_str());
+  if (bind(listen_fd, reinterpret_cast<struct sockaddr*>(&addr),
+           sizeof(addr)) < 0 ||
+      listen(listen_fd, 1) < 0) {
+    MLOG(MERROR) << "Could not listen on state handoff socket " << socket_path
+                 << ": " << strerror(errno);
+    close(listen_fd);
+    return;
+  }
+  MLOG(MINFO) << "Serving state handoff on " << socket_path;
+  std::thread([listen_fd, store]() {
+    for (;;) {
+      int conn_fd = accept(listen_fd, nullptr, nullptr);
+      if (conn_fd < 0) {
+        break;
+      }
+      serve_one_handoff(conn_fd, store);
+      close(conn_fd);
+    }
+    close(listen_fd);
+  }).detach();
+}
+
+bool StateHandoff::try_restore(
+    const std::string& socket_path, SessionStore* store,
+    std::shared_ptr<StaticRuleStore> rule_store) {
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return false;
+  }
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+  if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) <
+      0) {
+    // No predecessor listening -> cold start
+    close(fd);
+    return false;
+  }
+  struct timeval timeout;
+  timeout.tv_sec  = RESTORE_TIMEOUT_MS / 1000;
+  timeout.tv_usec = (RESTORE_TIMEOUT_MS % 1000) * 1000;
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  uint32_t count = 0;
+  if (!read_full(fd, &count, sizeof(count))) {
+    MLOG(MWARNING) << "Predecessor on " << socket_path
+                   << " did not complete the handoff, starting cold";
+    close(fd);
+    return false;
+  }
+  SessionMap session_map;
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t len = 0;
+    if (!read_full(fd, &len, sizeof(len))) {
+      close(fd);
+      return false;
+    }
+    std::string serialized(len, '\0');
+    if (!read_full(fd, &serialized[0], len)) {
+      close(fd);
+      return false;
+    }
+    StoredSessionState stored = deserialize_stored_session(serialized);
+    std::string imsi          = stored.imsi;
+    session_map[imsi].push_back(SessionState::unmarshal(stored, *rule_store));
+  }
+  close(fd);
+  store->raw_write_sessions(std::move(session_map));
+  MLOG(MINFO) << "Restored " << count << " sessions from predecessor on "
+              << socket_path;
+  return true;
+}
+
+}  // namespace lte
+}  // namespace magma
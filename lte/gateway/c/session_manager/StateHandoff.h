@@ -0,0 +1,63 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "RuleStore.h"
+#include "SessionStore.h"
+
+namespace magma {
+namespace lte {
+
+/**
+ * StateHandoff transfers committed session state from an outgoing sessiond
+ * process to an incoming one over a unix socket, so upgrades of the
+ * memory-backed deployment restore their sessions immediately instead of
+ * waiting for the RestartHandler sweep. The outgoing side serves the latest
+ * commit-published snapshot (SessionStore::get_sessions_snapshot), so a
+ * handoff never blocks call processing.
+ *
+ * The incoming binary calls try_restore at startup; if a predecessor is
+ * listening it seeds the store with the received sessions, otherwise this is
+ * a cold start. It then calls serve to take over the socket name and stand
+ * ready for the next upgrade.
+ */
+class StateHandoff {
+ public:
+  /**
+   * Socket receive timeout for the incoming side, so a wedged predecessor
+   * degrades into a cold start instead of stalling startup
+   */
+  static uint32_t RESTORE_TIMEOUT_MS;
+
+  /**
+   * Listen on socket_path (replacing any stale socket file) and serve one
+   * serialized copy of the store per connection, on a detached thread that
+   * runs until process exit.
+   */
+  static void serve(const std::string& socket_path, SessionStore* store);
+
+  /**
+   * Attempt to pull session state from a predecessor listening on
+   * socket_path and write it into the store.
+   * @return true if a predecessor was found and its sessions were restored
+   */
+  static bool try_restore(
+      const std::string& socket_path, SessionStore* store,
+      std::shared_ptr<StaticRuleStore> rule_store);
+};
+
+}  // namespace lte
+}  // namespace magma
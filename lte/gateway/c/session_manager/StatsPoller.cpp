@@ -24,7 +24,11 @@ void StatsPoller::start_loop(
     uint32_t loop_interval_seconds) {
   while (true) {
     local_enforcer->poll_stats_enforcer(COOKIE, COOKIE_MASK);
-    std::this_thread::sleep_for(std::chrono::seconds(loop_interval_seconds));
+    // Ask the enforcer how long to sleep: the configured interval is the
+    // steady-state value, tightened when sessions run close to quota and
+    // relaxed when the dataplane is idle
+    std::this_thread::sleep_for(std::chrono::seconds(
+        local_enforcer->get_stats_poll_interval(loop_interval_seconds)));
   }
 }
 
@@ -19,9 +19,10 @@ namespace magma {
 class StatsPoller {
  public:
   /**
-   * start_loop is the main function to call to initiate a loop. Based
-   * on the given loop interval length, this function will poll stats from
-   * Pipelined every loop_interval_seconds
+   * start_loop is the main function to call to initiate a loop. This
+   * function polls stats from Pipelined roughly every
+   * loop_interval_seconds; the enforcer shortens or stretches each sleep
+   * based on observed counter churn and how close sessions are to quota
    */
   void start_loop(
       std::shared_ptr<LocalEnforcer> local_enforcer,
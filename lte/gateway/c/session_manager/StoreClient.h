@@ -27,6 +27,8 @@ namespace lte {
 
 using SessionVector = std::vector<std::unique_ptr<SessionState>>;
 using SessionMap    = std::unordered_map<std::string, SessionVector>;
+using SessionUpdate = std::unordered_map<
+    std::string, std::unordered_map<std::string, SessionStateUpdateCriteria>>;
 
 /**
  * StoreClient is responsible for reading/writing sessions to/from storage.
@@ -68,6 +70,44 @@ class StoreClient {
    * @return True if writes have completed successfully for all sessions.
    */
   virtual bool write_sessions(SessionMap sessions) = 0;
+
+  /**
+   * Write back sessions that were modified with the given update criteria.
+   *
+   * The sessions in the map are expected to already have the criteria applied.
+   * Clients that support it may persist only the delta described by the
+   * criteria instead of re-serializing every session. The default behavior is
+   * a full write of the map.
+   * @param sessions Sessions to write into storage, with updates applied
+   * @param update_criteria Criteria that was applied to the sessions
+   * @return True if writes have completed successfully for all sessions.
+   */
+  virtual bool write_session_updates(
+      SessionMap& sessions, const SessionUpdate& update_criteria) {
+    return write_sessions(std::move(sessions));
+  }
+
+  /**
+   * Borrow the subscribers' sessions for a read-modify-write cycle that
+   * stays under the SessionStore shard locks covering the subscribers.
+   * Single-accessor clients may hand out their live stored sessions here
+   * instead of copies; every borrowed map must be handed back through
+   * write_sessions/write_session_updates before the shard locks are
+   * released. The default behavior is a copying read.
+   * @param subscriber_ids typically in IMSI
+   * @return All sessions for the subscribers
+   */
+  virtual SessionMap borrow_sessions(std::set<std::string> subscriber_ids) {
+    return read_sessions(subscriber_ids);
+  }
+
+  /**
+   * Hand back a borrowed session map without publishing it as a commit.
+   * Used on failed read-modify-write cycles; for copying clients the
+   * borrowed map is itself a copy and is simply dropped.
+   * @param sessions Sessions previously obtained from borrow_sessions
+   */
+  virtual void return_borrowed_sessions(SessionMap sessions) {}
 };
 
 }  // namespace lte
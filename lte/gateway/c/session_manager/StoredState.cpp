@@ -16,6 +16,7 @@
 #include <lte/protos/pipelined.grpc.pb.h>
 #include <lte/protos/session_manager.grpc.pb.h>
 
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 
@@ -244,6 +245,77 @@ StoredSessionCredit deserialize_stored_session_credit(
   return stored;
 }
 
+std::string serialize_session_credit_update_criteria(
+    const SessionCreditUpdateCriteria& stored) {
+  folly::dynamic marshaled = folly::dynamic::object;
+  marshaled["is_final"]    = stored.is_final;
+  marshaled["final_action_info"] =
+      serialize_stored_final_action_info(stored.final_action_info);
+  marshaled["reauth_state"]  = static_cast<int>(stored.reauth_state);
+  marshaled["service_state"] = static_cast<int>(stored.service_state);
+  marshaled["expiry_time"]   = std::to_string(stored.expiry_time);
+  marshaled["reporting"]     = stored.reporting;
+  marshaled["grant_tracking_type"] =
+      static_cast<int>(stored.grant_tracking_type);
+  marshaled["received_granted_units"] =
+      stored.received_granted_units.SerializeAsString();
+  marshaled["deleted"]             = stored.deleted;
+  marshaled["report_last_credit"]  = stored.report_last_credit;
+  marshaled["time_of_first_usage"] = std::to_string(stored.time_of_first_usage);
+  marshaled["time_of_last_usage"]  = std::to_string(stored.time_of_last_usage);
+  marshaled["suspended"]           = stored.suspended;
+
+  folly::dynamic bucket_deltas = folly::dynamic::object;
+  for (const auto& bucket_pair : stored.bucket_deltas) {
+    bucket_deltas[std::to_string(static_cast<int>(bucket_pair.first))] =
+        std::to_string(bucket_pair.second);
+  }
+  marshaled["bucket_deltas"] = bucket_deltas;
+
+  std::string serialized = folly::toJson(marshaled);
+  return serialized;
+}
+
+SessionCreditUpdateCriteria deserialize_session_credit_update_criteria(
+    const std::string& serialized) {
+  auto folly_serialized    = folly::StringPiece(serialized);
+  folly::dynamic marshaled = folly::parseJson(folly_serialized);
+
+  auto stored              = SessionCreditUpdateCriteria{};
+  stored.is_final          = marshaled["is_final"].getBool();
+  stored.final_action_info = deserialize_stored_final_action_info(
+      marshaled["final_action_info"].getString());
+  stored.reauth_state =
+      static_cast<ReAuthState>(marshaled["reauth_state"].getInt());
+  stored.service_state =
+      static_cast<ServiceState>(marshaled["service_state"].getInt());
+  stored.expiry_time = static_cast<std::time_t>(
+      std::stoul(marshaled["expiry_time"].getString()));
+  stored.reporting = marshaled["reporting"].getBool();
+  stored.grant_tracking_type =
+      static_cast<GrantTrackingType>(marshaled["grant_tracking_type"].getInt());
+
+  GrantedUnits received_granted_units;
+  received_granted_units.ParseFromString(
+      marshaled["received_granted_units"].getString());
+  stored.received_granted_units = received_granted_units;
+
+  stored.deleted            = marshaled["deleted"].getBool();
+  stored.report_last_credit = marshaled["report_last_credit"].getBool();
+  stored.time_of_first_usage = static_cast<uint64_t>(
+      std::stoul(marshaled["time_of_first_usage"].getString()));
+  stored.time_of_last_usage = static_cast<uint64_t>(
+      std::stoul(marshaled["time_of_last_usage"].getString()));
+  stored.suspended = marshaled["suspended"].getBool();
+
+  for (const auto& bucket_pair : marshaled["bucket_deltas"].items()) {
+    Bucket bucket = static_cast<Bucket>(std::stoi(bucket_pair.first.getString()));
+    stored.bucket_deltas[bucket] =
+        static_cast<uint64_t>(std::stoul(bucket_pair.second.getString()));
+  }
+  return stored;
+}
+
 std::string serialize_stored_monitor(StoredMonitor& stored) {
   folly::dynamic marshaled = folly::dynamic::object;
 
@@ -563,7 +635,387 @@ std::string serialize_stored_session(StoredSessionState& stored) {
   return serialized;
 }
 
+namespace {
+
+// Little-endian primitive accessors for the compact binary session codec.
+// Readers throw std::out_of_range on truncated input, which callers of
+// deserialize_stored_session already guard against.
+void write_uint8(std::string* out, uint8_t value) {
+  out->push_back(static_cast<char>(value));
+}
+
+void write_uint32(std::string* out, uint32_t value) {
+  for (int i = 0; i < 4; i++) {
+    out->push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+void write_uint64(std::string* out, uint64_t value) {
+  for (int i = 0; i < 8; i++) {
+    out->push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+void write_string(std::string* out, const std::string& value) {
+  write_uint32(out, static_cast<uint32_t>(value.size()));
+  out->append(value);
+}
+
+uint8_t read_uint8(const std::string& in, size_t* offset) {
+  if (*offset + 1 > in.size()) {
+    throw std::out_of_range("truncated binary session");
+  }
+  return static_cast<uint8_t>(in[(*offset)++]);
+}
+
+uint32_t read_uint32(const std::string& in, size_t* offset) {
+  if (*offset + 4 > in.size()) {
+    throw std::out_of_range("truncated binary session");
+  }
+  uint32_t value = 0;
+  for (int i = 0; i < 4; i++) {
+    value |= static_cast<uint32_t>(static_cast<uint8_t>(in[(*offset)++]))
+             << (8 * i);
+  }
+  return value;
+}
+
+uint64_t read_uint64(const std::string& in, size_t* offset) {
+  if (*offset + 8 > in.size()) {
+    throw std::out_of_range("truncated binary session");
+  }
+  uint64_t value = 0;
+  for (int i = 0; i < 8; i++) {
+    value |= static_cast<uint64_t>(static_cast<uint8_t>(in[(*offset)++]))
+             << (8 * i);
+  }
+  return value;
+}
+
+std::string read_string(const std::string& in, size_t* offset) {
+  uint32_t length = read_uint32(in, offset);
+  if (*offset + length > in.size()) {
+    throw std::out_of_range("truncated binary session");
+  }
+  std::string value = in.substr(*offset, length);
+  *offset += length;
+  return value;
+}
+
+template <typename ProtoType>
+void write_proto(std::string* out, const ProtoType& proto) {
+  std::string serialized;
+  proto.SerializeToString(&serialized);
+  write_string(out, serialized);
+}
+
+template <typename ProtoType>
+void read_proto(const std::string& in, size_t* offset, ProtoType* proto) {
+  proto->ParseFromString(read_string(in, offset));
+}
+
+void write_final_action_info(std::string* out, const FinalActionInfo& stored) {
+  write_uint8(out, static_cast<uint8_t>(stored.final_action));
+  write_proto(out, stored.redirect_server);
+  write_uint32(out, static_cast<uint32_t>(stored.restrict_rules.size()));
+  for (const auto& rule_id : stored.restrict_rules) {
+    write_string(out, rule_id);
+  }
+}
+
+FinalActionInfo read_final_action_info(
+    const std::string& in, size_t* offset) {
+  auto stored = FinalActionInfo{};
+  stored.final_action =
+      static_cast<ChargingCredit_FinalAction>(read_uint8(in, offset));
+  read_proto(in, offset, &stored.redirect_server);
+  uint32_t rule_count = read_uint32(in, offset);
+  for (uint32_t i = 0; i < rule_count; i++) {
+    stored.restrict_rules.push_back(read_string(in, offset));
+  }
+  return stored;
+}
+
+void write_session_credit(std::string* out, const StoredSessionCredit& stored) {
+  write_uint8(out, stored.reporting);
+  write_uint8(out, static_cast<uint8_t>(stored.credit_limit_type));
+  write_uint8(out, static_cast<uint8_t>(stored.grant_tracking_type));
+  write_proto(out, stored.received_granted_units);
+  write_uint8(out, stored.report_last_credit);
+  write_uint64(out, stored.time_of_first_usage);
+  write_uint64(out, stored.time_of_last_usage);
+  write_uint8(out, BUCKET_ENUM_MAX_VALUE);
+  for (int bucket_int = USED_TX; bucket_int != BUCKET_ENUM_MAX_VALUE;
+       bucket_int++) {
+    auto bucket_it = stored.buckets.find(static_cast<Bucket>(bucket_int));
+    write_uint64(
+        out, bucket_it == stored.buckets.end() ? 0 : bucket_it->second);
+  }
+}
+
+StoredSessionCredit read_session_credit(
+    const std::string& in, size_t* offset) {
+  auto stored      = StoredSessionCredit{};
+  stored.reporting = read_uint8(in, offset);
+  stored.credit_limit_type =
+      static_cast<CreditLimitType>(read_uint8(in, offset));
+  stored.grant_tracking_type =
+      static_cast<GrantTrackingType>(read_uint8(in, offset));
+  read_proto(in, offset, &stored.received_granted_units);
+  stored.report_last_credit  = read_uint8(in, offset);
+  stored.time_of_first_usage = read_uint64(in, offset);
+  stored.time_of_last_usage  = read_uint64(in, offset);
+  uint8_t bucket_count       = read_uint8(in, offset);
+  for (uint8_t bucket_int = 0; bucket_int < bucket_count; bucket_int++) {
+    uint64_t value = read_uint64(in, offset);
+    if (bucket_int < BUCKET_ENUM_MAX_VALUE) {
+      stored.buckets[static_cast<Bucket>(bucket_int)] = value;
+    }
+  }
+  return stored;
+}
+
+void write_charging_grant(std::string* out, const StoredChargingGrant& stored) {
+  write_session_credit(out, stored.credit);
+  write_uint8(out, stored.is_final);
+  write_final_action_info(out, stored.final_action_info);
+  write_uint8(out, static_cast<uint8_t>(stored.reauth_state));
+  write_uint8(out, static_cast<uint8_t>(stored.service_state));
+  write_uint64(out, static_cast<uint64_t>(stored.expiry_time));
+  write_uint8(out, stored.suspended);
+}
+
+StoredChargingGrant read_charging_grant(
+    const std::string& in, size_t* offset) {
+  auto stored              = StoredChargingGrant{};
+  stored.credit            = read_session_credit(in, offset);
+  stored.is_final          = read_uint8(in, offset);
+  stored.final_action_info = read_final_action_info(in, offset);
+  stored.reauth_state      = static_cast<ReAuthState>(read_uint8(in, offset));
+  stored.service_state = static_cast<ServiceState>(read_uint8(in, offset));
+  stored.expiry_time   = static_cast<std::time_t>(read_uint64(in, offset));
+  stored.suspended     = read_uint8(in, offset);
+  return stored;
+}
+
+void write_policy_stats_map(std::string* out, const PolicyStatsMap& stats_map) {
+  write_uint32(out, static_cast<uint32_t>(stats_map.size()));
+  for (const auto& policy_pair : stats_map) {
+    write_string(out, policy_pair.first);
+    write_uint32(out, policy_pair.second.current_version);
+    write_uint32(out, policy_pair.second.last_reported_version);
+    write_uint32(out, static_cast<uint32_t>(policy_pair.second.stats_map.size()));
+    for (const auto& stat : policy_pair.second.stats_map) {
+      write_uint64(out, stat.first);
+      write_uint64(out, stat.second.tx);
+      write_uint64(out, stat.second.rx);
+      write_uint64(out, stat.second.dropped_tx);
+      write_uint64(out, stat.second.dropped_rx);
+    }
+  }
+}
+
+PolicyStatsMap read_policy_stats_map(const std::string& in, size_t* offset) {
+  auto stored          = PolicyStatsMap{};
+  uint32_t policy_count = read_uint32(in, offset);
+  for (uint32_t i = 0; i < policy_count; i++) {
+    std::string rule_id = read_string(in, offset);
+    StatsPerPolicy stats;
+    stats.current_version       = read_uint32(in, offset);
+    stats.last_reported_version = read_uint32(in, offset);
+    uint32_t stat_count         = read_uint32(in, offset);
+    for (uint32_t j = 0; j < stat_count; j++) {
+      uint64_t version = read_uint64(in, offset);
+      RuleStats rule_stats;
+      rule_stats.tx               = read_uint64(in, offset);
+      rule_stats.rx               = read_uint64(in, offset);
+      rule_stats.dropped_tx       = read_uint64(in, offset);
+      rule_stats.dropped_rx       = read_uint64(in, offset);
+      stats.stats_map[version]    = rule_stats;
+    }
+    stored[rule_id] = stats;
+  }
+  return stored;
+}
+
+}  // namespace
+
+std::string serialize_stored_session_binary(StoredSessionState& stored) {
+  std::string out;
+  // Large sessions serialize to tens of kilobytes; reserve up front to avoid
+  // repeated growth
+  out.reserve(4096);
+  write_uint8(&out, SESSION_BINARY_MAGIC);
+  write_uint8(&out, SESSION_BINARY_VERSION);
+
+  write_uint8(&out, static_cast<uint8_t>(stored.fsm_state));
+  write_proto(&out, stored.config.common_context);
+  write_proto(&out, stored.config.rat_specific_context);
+
+  write_uint32(&out, static_cast<uint32_t>(stored.credit_map.size()));
+  for (const auto& credit_pair : stored.credit_map) {
+    write_uint32(&out, credit_pair.first.rating_group);
+    write_uint32(&out, credit_pair.first.service_identifier);
+    write_charging_grant(&out, credit_pair.second);
+  }
+
+  write_uint32(&out, static_cast<uint32_t>(stored.monitor_map.size()));
+  for (const auto& monitor_pair : stored.monitor_map) {
+    write_string(&out, monitor_pair.first);
+    write_session_credit(&out, monitor_pair.second.credit);
+    write_uint8(&out, static_cast<uint8_t>(monitor_pair.second.level));
+  }
+
+  write_string(&out, stored.session_level_key);
+  write_string(&out, stored.imsi);
+  write_string(&out, stored.session_id);
+  write_uint8(&out, static_cast<uint8_t>(stored.subscriber_quota_state));
+  write_proto(&out, stored.create_session_response);
+  write_proto(&out, stored.tgpp_context);
+  write_uint64(&out, stored.pdp_start_time);
+  write_uint64(&out, stored.pdp_end_time);
+
+  write_uint32(&out, static_cast<uint32_t>(stored.pending_event_triggers.size()));
+  for (const auto& trigger_pair : stored.pending_event_triggers) {
+    write_uint32(&out, static_cast<uint32_t>(trigger_pair.first));
+    write_uint8(&out, static_cast<uint8_t>(trigger_pair.second));
+  }
+  write_proto(&out, stored.revalidation_time);
+
+  write_uint32(&out, static_cast<uint32_t>(stored.bearer_id_by_policy.size()));
+  for (const auto& bearer_pair : stored.bearer_id_by_policy) {
+    write_uint8(&out, static_cast<uint8_t>(bearer_pair.first.policy_type));
+    write_string(&out, bearer_pair.first.rule_id);
+    write_uint32(&out, bearer_pair.second.bearer_id);
+    write_uint32(&out, bearer_pair.second.teids.agw_teid());
+    write_uint32(&out, bearer_pair.second.teids.enb_teid());
+  }
+
+  write_policy_stats_map(&out, stored.policy_version_and_stats);
+
+  write_uint32(&out, static_cast<uint32_t>(stored.static_rule_ids.size()));
+  for (const auto& rule_id : stored.static_rule_ids) {
+    write_string(&out, rule_id);
+  }
+  write_uint32(&out, static_cast<uint32_t>(stored.dynamic_rules.size()));
+  for (const auto& rule : stored.dynamic_rules) {
+    write_proto(&out, rule);
+  }
+  write_uint32(&out, static_cast<uint32_t>(stored.gy_dynamic_rules.size()));
+  for (const auto& rule : stored.gy_dynamic_rules) {
+    write_proto(&out, rule);
+  }
+  write_uint32(&out, static_cast<uint32_t>(stored.pdr_list.size()));
+  for (const auto& rule : stored.pdr_list) {
+    write_proto(&out, rule);
+  }
+
+  write_uint32(&out, stored.request_number);
+  return out;
+}
+
+static StoredSessionState deserialize_stored_session_binary(
+    const std::string& serialized) {
+  size_t offset = 0;
+  read_uint8(serialized, &offset);  // magic, checked by the caller
+  uint8_t version = read_uint8(serialized, &offset);
+  if (version != SESSION_BINARY_VERSION) {
+    MLOG(MERROR) << "Unknown binary session version " << int(version)
+                 << ", expected " << int(SESSION_BINARY_VERSION);
+    throw std::out_of_range("unknown binary session version");
+  }
+
+  auto stored      = StoredSessionState{};
+  stored.fsm_state = SessionFsmState(read_uint8(serialized, &offset));
+  read_proto(serialized, &offset, &stored.config.common_context);
+  read_proto(serialized, &offset, &stored.config.rat_specific_context);
+
+  stored.credit_map     = StoredChargingCreditMap(4, &ccHash, &ccEqual);
+  uint32_t credit_count = read_uint32(serialized, &offset);
+  for (uint32_t i = 0; i < credit_count; i++) {
+    uint32_t rating_group       = read_uint32(serialized, &offset);
+    uint32_t service_identifier = read_uint32(serialized, &offset);
+    stored.credit_map[CreditKey(rating_group, service_identifier)] =
+        read_charging_grant(serialized, &offset);
+  }
+
+  uint32_t monitor_count = read_uint32(serialized, &offset);
+  for (uint32_t i = 0; i < monitor_count; i++) {
+    std::string monitor_key = read_string(serialized, &offset);
+    StoredMonitor monitor;
+    monitor.credit = read_session_credit(serialized, &offset);
+    monitor.level =
+        static_cast<MonitoringLevel>(read_uint8(serialized, &offset));
+    stored.monitor_map[monitor_key] = monitor;
+  }
+
+  stored.session_level_key = read_string(serialized, &offset);
+  stored.imsi              = read_string(serialized, &offset);
+  stored.session_id        = read_string(serialized, &offset);
+  stored.subscriber_quota_state =
+      static_cast<magma::lte::SubscriberQuotaUpdate_Type>(
+          read_uint8(serialized, &offset));
+  read_proto(serialized, &offset, &stored.create_session_response);
+  read_proto(serialized, &offset, &stored.tgpp_context);
+  stored.pdp_start_time = read_uint64(serialized, &offset);
+  stored.pdp_end_time   = read_uint64(serialized, &offset);
+
+  uint32_t trigger_count = read_uint32(serialized, &offset);
+  for (uint32_t i = 0; i < trigger_count; i++) {
+    auto trigger =
+        magma::lte::EventTrigger(read_uint32(serialized, &offset));
+    stored.pending_event_triggers[trigger] =
+        EventTriggerState(read_uint8(serialized, &offset));
+  }
+  read_proto(serialized, &offset, &stored.revalidation_time);
+
+  uint32_t bearer_count = read_uint32(serialized, &offset);
+  for (uint32_t i = 0; i < bearer_count; i++) {
+    PolicyType policy_type = PolicyType(read_uint8(serialized, &offset));
+    std::string rule_id    = read_string(serialized, &offset);
+    auto policy_id         = PolicyID(policy_type, rule_id);
+    BearerIDAndTeid bearer;
+    bearer.bearer_id = read_uint32(serialized, &offset);
+    bearer.teids.set_agw_teid(read_uint32(serialized, &offset));
+    bearer.teids.set_enb_teid(read_uint32(serialized, &offset));
+    stored.bearer_id_by_policy[policy_id] = bearer;
+  }
+
+  stored.policy_version_and_stats =
+      read_policy_stats_map(serialized, &offset);
+
+  uint32_t static_rule_count = read_uint32(serialized, &offset);
+  for (uint32_t i = 0; i < static_rule_count; i++) {
+    stored.static_rule_ids.push_back(read_string(serialized, &offset));
+  }
+  uint32_t dynamic_rule_count = read_uint32(serialized, &offset);
+  for (uint32_t i = 0; i < dynamic_rule_count; i++) {
+    PolicyRule rule;
+    read_proto(serialized, &offset, &rule);
+    stored.dynamic_rules.push_back(rule);
+  }
+  uint32_t gy_rule_count = read_uint32(serialized, &offset);
+  for (uint32_t i = 0; i < gy_rule_count; i++) {
+    PolicyRule rule;
+    read_proto(serialized, &offset, &rule);
+    stored.gy_dynamic_rules.push_back(rule);
+  }
+  uint32_t pdr_count = read_uint32(serialized, &offset);
+  for (uint32_t i = 0; i < pdr_count; i++) {
+    SetGroupPDR rule;
+    read_proto(serialized, &offset, &rule);
+    stored.pdr_list.push_back(rule);
+  }
+
+  stored.request_number = read_uint32(serialized, &offset);
+  return stored;
+}
+
 StoredSessionState deserialize_stored_session(std::string& serialized) {
+  if (!serialized.empty() &&
+      static_cast<uint8_t>(serialized[0]) == SESSION_BINARY_MAGIC) {
+    return deserialize_stored_session_binary(serialized);
+  }
   auto folly_serialized    = folly::StringPiece(serialized);
   folly::dynamic marshaled = folly::parseJson(folly_serialized);
 
@@ -187,6 +187,12 @@ std::string serialize_stored_session_credit(StoredSessionCredit& stored);
 StoredSessionCredit deserialize_stored_session_credit(
     const std::string& serialized);
 
+std::string serialize_session_credit_update_criteria(
+    const SessionCreditUpdateCriteria& stored);
+
+SessionCreditUpdateCriteria deserialize_session_credit_update_criteria(
+    const std::string& serialized);
+
 std::string serialize_stored_charging_grant(StoredChargingGrant& stored);
 
 std::string serialize_stored_monitor(StoredMonitor& stored);
@@ -207,8 +213,27 @@ BearerIDByPolicyID deserialize_bearer_id_by_policy(std::string& serialized);
 
 std::string serialize_bearer_id_by_policy(BearerIDByPolicyID bearer_map);
 
+// Leading byte identifying a binary-serialized session. JSON-serialized
+// sessions always start with '{', so the two formats can coexist in storage
+// during a rolling upgrade.
+constexpr uint8_t SESSION_BINARY_MAGIC = 0xBF;
+// Bumped whenever the binary layout changes
+constexpr uint8_t SESSION_BINARY_VERSION = 1;
+
 std::string serialize_stored_session(StoredSessionState& stored);
 
+/**
+ * Serialize a session with the compact binary codec. This avoids the
+ * folly::dynamic JSON round trip, which dominates serialization cost for
+ * large sessions. The output carries a magic byte and format version so
+ * deserialize_stored_session can dispatch on the stored format.
+ */
+std::string serialize_stored_session_binary(StoredSessionState& stored);
+
+/**
+ * Deserialize a session serialized with either the JSON or the binary codec,
+ * detected from the leading byte.
+ */
 StoredSessionState deserialize_stored_session(std::string& serialized);
 
 std::string serialize_policy_stats_map(PolicyStatsMap stats_map);
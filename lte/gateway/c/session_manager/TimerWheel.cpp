@@ -0,0 +1,93 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <utility>
+
+#include "TimerWheel.h"
+
+namespace magma {
+
+TimerWheel::TimerWheel(uint32_t tick_interval_ms, size_t num_slots)
+    : evb_(nullptr),
+      tick_interval_ms_(tick_interval_ms),
+      current_tick_(0),
+      pending_(0),
+      tick_scheduled_(false),
+      next_id_(1),
+      slots_(num_slots) {}
+
+void TimerWheel::attach(folly::EventBase* evb) {
+  evb_ = evb;
+}
+
+TimerWheel::TimerId TimerWheel::schedule(
+    std::function<void()> callback, uint32_t delay_ms) {
+  // Round up so a timer never fires early, and always push out at least one
+  // tick so callbacks stay asynchronous like runAfterDelay
+  const uint64_t ticks = std::max<uint64_t>(
+      (delay_ms + tick_interval_ms_ - 1) / tick_interval_ms_, 1);
+  const uint64_t deadline_tick = current_tick_ + ticks;
+  const size_t slot            = deadline_tick % slots_.size();
+  const TimerId id             = next_id_++;
+  slots_[slot][id] = Timer{std::move(callback), deadline_tick};
+  slot_by_id_[id]  = slot;
+  pending_++;
+  if (!tick_scheduled_) {
+    start_tick();
+  }
+  return id;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+  auto it = slot_by_id_.find(id);
+  if (it == slot_by_id_.end()) {
+    return false;
+  }
+  slots_[it->second].erase(id);
+  slot_by_id_.erase(it);
+  pending_--;
+  return true;
+}
+
+void TimerWheel::start_tick() {
+  tick_scheduled_ = true;
+  evb_->runAfterDelay([this] { on_tick(); }, tick_interval_ms_);
+}
+
+void TimerWheel::on_tick() {
+  tick_scheduled_ = false;
+  current_tick_++;
+  auto& slot = slots_[current_tick_ % slots_.size()];
+  std::vector<std::function<void()>> expired;
+  for (auto it = slot.begin(); it != slot.end();) {
+    if (it->second.deadline_tick <= current_tick_) {
+      expired.push_back(std::move(it->second.callback));
+      slot_by_id_.erase(it->first);
+      it = slot.erase(it);
+      pending_--;
+    } else {
+      // Timer belongs to a later rotation of the wheel
+      ++it;
+    }
+  }
+  if (pending_ > 0) {
+    start_tick();
+  }
+  // Run expired callbacks after re-arming the tick so callbacks that
+  // schedule new timers see a consistent wheel
+  for (auto& callback : expired) {
+    callback();
+  }
+}
+
+}  // namespace magma
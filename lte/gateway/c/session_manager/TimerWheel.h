@@ -0,0 +1,83 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/io/async/EventBase.h>
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace magma {
+
+/**
+ * TimerWheel is a hashed timer wheel for the coarse timeouts sessiond
+ * schedules in bulk (credit validity, revalidation, rule activation windows
+ * and retry backoffs). Timers hash into a fixed number of slots by deadline
+ * tick, so insert and cancel are O(1) and the event base only wakes once per
+ * tick instead of once per timer. All methods must be called from the event
+ * base thread; the wheel itself is driven by a single recurring runAfterDelay
+ * callback that is only armed while timers are pending.
+ */
+class TimerWheel {
+ public:
+  using TimerId = uint64_t;
+
+  explicit TimerWheel(
+      uint32_t tick_interval_ms = DEFAULT_TICK_INTERVAL_MS,
+      size_t num_slots          = DEFAULT_NUM_SLOTS);
+
+  /**
+   * Attach the event base that drives the wheel. Must be called before the
+   * first schedule call, mirroring LocalEnforcer::attachEventBase.
+   */
+  void attach(folly::EventBase* evb);
+
+  /**
+   * Schedule callback to run roughly delay_ms from now, rounded up to the
+   * next tick. Returns an id that can be passed to cancel.
+   */
+  TimerId schedule(std::function<void()> callback, uint32_t delay_ms);
+
+  /**
+   * Cancel a pending timer. Returns false if the timer already fired or was
+   * already cancelled.
+   */
+  bool cancel(TimerId id);
+
+  size_t pending() const { return pending_; }
+
+  static const uint32_t DEFAULT_TICK_INTERVAL_MS = 250;
+  static const size_t DEFAULT_NUM_SLOTS          = 512;
+
+ private:
+  struct Timer {
+    std::function<void()> callback;
+    uint64_t deadline_tick;
+  };
+
+  void start_tick();
+  void on_tick();
+
+  folly::EventBase* evb_;
+  uint32_t tick_interval_ms_;
+  uint64_t current_tick_;
+  size_t pending_;
+  bool tick_scheduled_;
+  TimerId next_id_;
+  std::vector<std::unordered_map<TimerId, Timer>> slots_;
+  std::unordered_map<TimerId, size_t> slot_by_id_;
+};
+
+}  // namespace magma
@@ -159,46 +159,49 @@ void UpfMsgManageHandler::SendPagingRequest(
 void UpfMsgManageHandler::get_session_from_imsi(
     const std::string& imsi, uint32_t te_id,
     std::function<void(Status, SmContextVoid)> response_callback) {
-  conv_enforcer_->get_event_base().runInEventBaseThread([this, imsi, te_id,
-                                                         response_callback]() {
-    if (!imsi.length()) {
-      MLOG(MERROR) << "get_subscriberid_from_ipv4 for IP"
-                      "returned an empty subscriber ID";
-      Status status(
-          grpc::NOT_FOUND,
-          "Session Not found because"
-          "subscriber ID not found for IP");
-      response_callback(status, SmContextVoid());
-      return;
-    }
+  // Paging trigger runs on the event base shard owning this SUPI
+  conv_enforcer_->get_event_base(imsi).runInEventBaseThread(
+      [this, imsi, te_id, response_callback]() {
+        if (!imsi.length()) {
+          MLOG(MERROR) << "get_subscriberid_from_ipv4 for IP"
+                          "returned an empty subscriber ID";
+          Status status(
+              grpc::NOT_FOUND,
+              "Session Not found because"
+              "subscriber ID not found for IP");
+          response_callback(status, SmContextVoid());
+          return;
+        }
 
-    // retrieve session_map entry
-    auto session_map = session_store_.read_sessions({imsi});
-    /* Search with session search criteria of IMSI and session_id and
-     * find  respective session to operate
-     */
-    SessionSearchCriteria criteria(imsi, IMSI_AND_TEID, te_id);
+        // retrieve session_map entry
+        auto session_map = session_store_.read_sessions({imsi});
+        /* Search with session search criteria of IMSI and session_id and
+         * find  respective session to operate
+         */
+        SessionSearchCriteria criteria(imsi, IMSI_AND_TEID, te_id);
 
-    auto session_it = session_store_.find_session(session_map, criteria);
-    if (!session_it) {
-      MLOG(MERROR) << "No session found in SessionMap for IMSI " << imsi
-                   << " with teid " << te_id;
-      Status status(
-          grpc::NOT_FOUND, "Session was not found for IMSI with teid");
-      response_callback(status, SmContextVoid());
-      return;
-    }
+        auto session_it = session_store_.find_session(session_map, criteria);
+        if (!session_it) {
+          MLOG(MERROR) << "No session found in SessionMap for IMSI " << imsi
+                       << " with teid " << te_id;
+          Status status(
+              grpc::NOT_FOUND, "Session was not found for IMSI with teid");
+          response_callback(status, SmContextVoid());
+          return;
+        }
 
-    auto& session = **session_it;
-    MLOG(MINFO) << "IDLE_MODE::: Session found in SendingPaging "
-                   "Request of imsi: "
-                << imsi << "  session_id: " << session->get_session_id();
-    // Generate Paging trigget to AMF.
-    conv_enforcer_->handle_state_update_to_amf(
-        *session, magma::lte::M5GSMCause::OPERATION_SUCCESS, UE_PAGING_NOTIFY);
-    MLOG(MINFO) << "UPF Paging notification forwarded to AMF of imsi:" << imsi;
-    response_callback(Status::OK, SmContextVoid());
-  });
+        auto& session = **session_it;
+        MLOG(MINFO) << "IDLE_MODE::: Session found in SendingPaging "
+                       "Request of imsi: "
+                    << imsi << "  session_id: " << session->get_session_id();
+        // Generate Paging trigget to AMF.
+        conv_enforcer_->handle_state_update_to_amf(
+            *session, magma::lte::M5GSMCause::OPERATION_SUCCESS,
+            UE_PAGING_NOTIFY);
+        MLOG(MINFO) << "UPF Paging notification forwarded to AMF of imsi:"
+                    << imsi;
+        response_callback(Status::OK, SmContextVoid());
+      });
   return;
 }
 }  // end namespace magma
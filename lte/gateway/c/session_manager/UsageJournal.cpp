@@ -0,0 +1,165 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "UsageJournal.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+
+#include "magma_logging.h"
+
+namespace {
+constexpr uint64_t JOURNAL_MAGIC   = 0x4c4e524a47414d55;  // "UMAGJRNL"
+constexpr uint64_t JOURNAL_VERSION = 1;
+}  // namespace
+
+namespace magma {
+namespace lte {
+
+std::unique_ptr<UsageJournal> UsageJournal::open(
+    const std::string& path, uint64_t record_capacity) {
+  size_t file_size =
+      sizeof(Header) + record_capacity * sizeof(UsageRecord);
+
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0600);
+  if (fd < 0) {
+    MLOG(MERROR) << "Could not open usage journal " << path;
+    return nullptr;
+  }
+  if (ftruncate(fd, file_size) != 0) {
+    MLOG(MERROR) << "Could not size usage journal " << path;
+    close(fd);
+    return nullptr;
+  }
+  void* base =
+      mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED) {
+    MLOG(MERROR) << "Could not map usage journal " << path;
+    close(fd);
+    return nullptr;
+  }
+
+  auto journal = std::unique_ptr<UsageJournal>(
+      new UsageJournal(fd, base, record_capacity));
+
+  Header* header = reinterpret_cast<Header*>(base);
+  if (header->magic != JOURNAL_MAGIC || header->capacity != record_capacity) {
+    // Fresh file, or the capacity changed: start over
+    memset(base, 0, file_size);
+    header->magic    = JOURNAL_MAGIC;
+    header->version  = JOURNAL_VERSION;
+    header->capacity = record_capacity;
+    header->next_seq = 1;
+    return journal;
+  }
+
+  // Recover the write position: a crash between the record stamp and the
+  // header update can leave the header one behind, the records themselves
+  // are authoritative
+  uint64_t max_seq = 0;
+  for (uint64_t i = 0; i < record_capacity; i++) {
+    uint64_t seq = journal->slot_for(i + 1)->seq;
+    if (seq > max_seq) {
+      max_seq = seq;
+    }
+  }
+  if (max_seq + 1 > header->next_seq) {
+    header->next_seq = max_seq + 1;
+  }
+  MLOG(MINFO) << "Usage journal " << path << " resuming at sequence "
+              << header->next_seq;
+  return journal;
+}
+
+UsageJournal::UsageJournal(int fd, void* base, uint64_t record_capacity)
+    : fd_(fd), base_(base), capacity_(record_capacity) {}
+
+UsageJournal::~UsageJournal() {
+  size_t file_size = sizeof(Header) + capacity_ * sizeof(UsageRecord);
+  msync(base_, file_size, MS_SYNC);
+  munmap(base_, file_size);
+  close(fd_);
+}
+
+UsageRecord* UsageJournal::slot_for(uint64_t seq) const {
+  auto* records = reinterpret_cast<UsageRecord*>(
+      static_cast<char*>(base_) + sizeof(Header));
+  return &records[(seq - 1) % capacity_];
+}
+
+void UsageJournal::append(
+    const std::string& imsi, const std::string& session_id,
+    uint64_t tx_bytes, uint64_t rx_bytes) {
+  std::lock_guard<std::mutex> lock(append_lock_);
+  Header* header = reinterpret_cast<Header*>(base_);
+  uint64_t seq   = header->next_seq;
+
+  UsageRecord* record = slot_for(seq);
+  // Invalidate the slot first so a reader never sees the old sequence
+  // paired with the new payload
+  __atomic_store_n(&record->seq, 0, __ATOMIC_RELEASE);
+  record->timestamp_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count();
+  record->tx_bytes = tx_bytes;
+  record->rx_bytes = rx_bytes;
+  strncpy(record->imsi, imsi.c_str(), sizeof(record->imsi) - 1);
+  record->imsi[sizeof(record->imsi) - 1] = '\0';
+  strncpy(record->session_id, session_id.c_str(),
+          sizeof(record->session_id) - 1);
+  record->session_id[sizeof(record->session_id) - 1] = '\0';
+  // The stamp publishes the record; everything above lands before it
+  __atomic_store_n(&record->seq, seq, __ATOMIC_RELEASE);
+
+  header->next_seq = seq + 1;
+}
+
+uint64_t UsageJournal::drain(
+    uint64_t from_seq,
+    const std::function<void(const UsageRecord&)>& cb) const {
+  uint64_t next;
+  {
+    std::lock_guard<std::mutex> lock(append_lock_);
+    next = reinterpret_cast<Header*>(base_)->next_seq;
+  }
+
+  uint64_t start = from_seq + 1;
+  if (next > capacity_ && start < next - capacity_) {
+    // The ring lapped the cursor; the overwritten records are gone
+    start = next - capacity_;
+  }
+
+  uint64_t delivered = from_seq;
+  for (uint64_t seq = start; seq < next; seq++) {
+    const UsageRecord* record = slot_for(seq);
+    if (__atomic_load_n(&record->seq, __ATOMIC_ACQUIRE) != seq) {
+      continue;  // torn by a crash, or overwritten mid-drain
+    }
+    cb(*record);
+    delivered = seq;
+  }
+  return delivered;
+}
+
+uint64_t UsageJournal::next_seq() const {
+  std::lock_guard<std::mutex> lock(append_lock_);
+  return reinterpret_cast<Header*>(base_)->next_seq;
+}
+
+}  // namespace lte
+}  // namespace magma
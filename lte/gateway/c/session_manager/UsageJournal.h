@@ -0,0 +1,106 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace magma {
+namespace lte {
+
+/**
+ * One fixed-size usage journal entry. The sequence stamp is written last
+ * (release-ordered), so a reader can tell a completed record from a slot
+ * that was mid-write when the process died: a torn slot carries a stale
+ * or zero sequence and is skipped.
+ */
+struct UsageRecord {
+  uint64_t seq;  // 0 while the slot is empty or mid-write
+  int64_t timestamp_ms;
+  uint64_t tx_bytes;
+  uint64_t rx_bytes;
+  char imsi[24];        // NUL-terminated, truncated if longer
+  char session_id[40];  // NUL-terminated, truncated if longer
+} __attribute__((packed));
+
+/**
+ * Append-only ring journal of usage records backed by an mmap'd file.
+ *
+ * An append is a memcpy into the mapping plus a sequence stamp; there is
+ * no syscall and no flush on the stats path, the kernel writes pages back
+ * on its own schedule. Records survive a process crash (the mapping is
+ * shared), and a half-written tail record is detectable through its
+ * sequence stamp. The ring keeps the newest `capacity` records; a drainer
+ * that falls further behind loses the oldest entries, which the drain
+ * cursor makes visible.
+ */
+class UsageJournal {
+ public:
+  /**
+   * Map the ring file at `path`, creating and sizing it on first use.
+   * Re-opening an existing file recovers the write position from the
+   * stored records. Returns nullptr when the file cannot be mapped.
+   */
+  static std::unique_ptr<UsageJournal> open(
+      const std::string& path, uint64_t record_capacity);
+
+  ~UsageJournal();
+
+  UsageJournal(const UsageJournal&) = delete;
+  UsageJournal& operator=(const UsageJournal&) = delete;
+
+  /**
+   * Append one record; never blocks on disk
+   */
+  void append(
+      const std::string& imsi, const std::string& session_id,
+      uint64_t tx_bytes, uint64_t rx_bytes);
+
+  /**
+   * Invoke cb for every completed record with seq > from_seq, oldest
+   * first, and return the highest sequence delivered (== from_seq when
+   * nothing new). An uploader persists the returned cursor and passes it
+   * back on the next drain.
+   */
+  uint64_t drain(
+      uint64_t from_seq,
+      const std::function<void(const UsageRecord&)>& cb) const;
+
+  // Sequence the next append will be stamped with
+  uint64_t next_seq() const;
+
+  uint64_t capacity() const { return capacity_; }
+
+ private:
+  struct Header {
+    uint64_t magic;
+    uint64_t version;
+    uint64_t capacity;
+    uint64_t next_seq;
+  };
+
+  UsageJournal(int fd, void* base, uint64_t record_capacity);
+
+  UsageRecord* slot_for(uint64_t seq) const;
+
+  int fd_;
+  void* base_;
+  uint64_t capacity_;
+  mutable std::mutex append_lock_;
+};
+
+}  // namespace lte
+}  // namespace magma
@@ -13,14 +13,18 @@
 
 #include <lte/protos/mconfig/mconfigs.pb.h>
 
+#include <chrono>
 #include <cstdlib>
+#include <future>
 #include <iostream>
 
+#include "FlowOpJournal.h"
 #include "GrpcMagmaUtils.h"
 #include "UpfMsgManageHandler.h"
 #include "LocalEnforcer.h"
 #include "magma_logging_init.h"
 #include "includes/MagmaService.h"
+#include "includes/MetricsHelpers.h"
 #include "includes/MConfigLoader.h"
 #include "OperationalStatesHandler.h"
 #include "includes/PolicyLoader.h"
@@ -32,7 +36,9 @@
 #include "SessionManagerServer.h"
 #include "SessionReporter.h"
 #include "SessionStore.h"
+#include "StateHandoff.h"
 #include "StatsPoller.h"
+#include "UsageJournal.h"
 
 #define SESSIOND_SERVICE "sessiond"
 #define SESSION_PROXY_SERVICE "session_proxy"
@@ -44,6 +50,7 @@
 #define DEFAULT_QUOTA_EXHAUSTION_TERMINATION_MS 30000  // 30sec
 #define DEFAULT_SESSION_MAX_RTX_COUNT 3
 #define DEFAULT_POLL_INTERVAL_TIME 5
+#define SESSIOND_MAX_LOOP_LATENCY_MS 100
 
 #ifdef DEBUG
 extern "C" void __gcov_flush(void);
@@ -139,6 +146,38 @@ void set_consts(const YAML::Node& config) {
   if (config["enable_ipfix"].IsDefined()) {
     magma::LocalEnforcer::SEND_IPFIX = config["enable_ipfix"].as<bool>();
   }
+  if (config["setup_batch_size"].IsDefined()) {
+    magma::LocalEnforcer::SETUP_BATCH_SIZE =
+        config["setup_batch_size"].as<uint32_t>();
+  }
+  if (config["setup_max_in_flight"].IsDefined()) {
+    magma::LocalEnforcer::SETUP_MAX_IN_FLIGHT =
+        config["setup_max_in_flight"].as<uint32_t>();
+  }
+  if (config["bearer_rule_batch_window_ms"].IsDefined()) {
+    magma::LocalEnforcer::BEARER_RULE_BATCH_WINDOW_MS =
+        config["bearer_rule_batch_window_ms"].as<uint32_t>();
+  }
+  if (config["aaa_batch_window_ms"].IsDefined()) {
+    aaa::AsyncAAAClient::BATCH_WINDOW_MS =
+        config["aaa_batch_window_ms"].as<uint32_t>();
+  }
+  if (config["aaa_batch_max_sessions"].IsDefined()) {
+    aaa::AsyncAAAClient::BATCH_MAX_SESSIONS =
+        config["aaa_batch_max_sessions"].as<uint32_t>();
+  }
+  if (config["update_coalescing_window_ms"].IsDefined()) {
+    magma::SessionReporterImpl::REPORT_COALESCING_WINDOW_MS =
+        config["update_coalescing_window_ms"].as<uint32_t>();
+  }
+  if (config["redis_write_behind"].IsDefined()) {
+    magma::lte::RedisStoreClient::WRITE_BEHIND =
+        config["redis_write_behind"].as<bool>();
+  }
+  if (config["redis_write_behind_max_pending"].IsDefined()) {
+    magma::lte::RedisStoreClient::WRITE_BEHIND_MAX_PENDING =
+        config["redis_write_behind_max_pending"].as<uint32_t>();
+  }
 
   // log all configs on startup
   MLOG(MINFO) << "==== Constants/Configs loaded from sessiond.yml ====";
@@ -163,14 +202,28 @@ magma::SessionStore* create_session_store(
   bool is_stateless = config["support_stateless"].IsDefined() &&
                       config["support_stateless"].as<bool>();
   if (is_stateless) {
+    bool serialize_as_binary =
+        config["session_serialization_format"].IsDefined() &&
+        config["session_serialization_format"].as<std::string>() == "binary";
+    MLOG(MINFO) << "Session serialization format: "
+                << (serialize_as_binary ? "binary" : "json");
+    bool compress_sessions = config["session_compression"].IsDefined() &&
+                             config["session_compression"].as<bool>();
+    std::string compression_dict;
+    if (config["session_compression_dict"].IsDefined()) {
+      compression_dict = config["session_compression_dict"].as<std::string>();
+    }
     auto store_client = std::make_shared<magma::lte::RedisStoreClient>(
         std::make_shared<cpp_redis::client>(),
-        config["sessions_table"].as<std::string>(), rule_store);
+        config["sessions_table"].as<std::string>(), rule_store,
+        serialize_as_binary, compress_sessions, compression_dict);
     bool connected;
     do {
       MLOG(MINFO) << "Attempting to connect to Redis";
       connected = store_client->try_redis_connect();
-      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      if (!connected) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      }
     } while (!connected);
     MLOG(MINFO) << "Successfully connected to Redis";
     return new magma::SessionStore(rule_store, metering_reporter, store_client);
@@ -227,6 +280,17 @@ int main(int argc, char* argv[]) {
   MLOG(MINFO) << "Starting Session Manager";
   folly::EventBase* evb = folly::EventBaseManager::get()->getEventBase();
 
+  // Surface main-loop stalls directly instead of learning about them from
+  // downstream timeouts; folly runs the callback from the loop itself once
+  // the observed loop latency exceeds the threshold
+  evb->setMaxLatency(std::chrono::milliseconds(SESSIOND_MAX_LOOP_LATENCY_MS),
+                     []() {
+                       MLOG(MERROR) << "sessiond main EventBase stalled >"
+                                    << SESSIOND_MAX_LOOP_LATENCY_MS << "ms";
+                       magma::service303::increment_counter(
+                           "eventbase_stalls", 1, size_t(0));
+                     });
+
   // Start off a thread to periodically load policy definitions from Redis into
   // RuleStore
   auto rule_store = std::make_shared<magma::StaticRuleStore>();
@@ -240,7 +304,55 @@ int main(int argc, char* argv[]) {
     policy_loader.stop();
   });
 
+  // Kick off the session store setup now so the blocking Redis connect
+  // and the metering counter restoration overlap with the gRPC client
+  // warmup below instead of serializing after it. set_consts runs first
+  // so the store client picks up the write-behind knobs
+  set_consts(config);
+  auto metering_reporter = std::make_shared<magma::MeteringReporter>();
+  if (config["enable_usage_journal"].IsDefined() &&
+      config["enable_usage_journal"].as<bool>()) {
+    std::string journal_path = "/var/opt/magma/sessiond_usage.journal";
+    if (config["usage_journal_path"].IsDefined()) {
+      journal_path = config["usage_journal_path"].as<std::string>();
+    }
+    uint64_t journal_records = 1 << 20;  // 1M slots, ~96MB on disk
+    if (config["usage_journal_records"].IsDefined()) {
+      journal_records = config["usage_journal_records"].as<uint64_t>();
+    }
+    auto journal =
+        magma::lte::UsageJournal::open(journal_path, journal_records);
+    if (journal) {
+      metering_reporter->attach_journal(std::move(journal));
+    }
+  }
+  std::future<magma::SessionStore*> session_store_future =
+      std::async(std::launch::async, [&]() {
+        magma::SessionStore* store =
+            create_session_store(config, rule_store, metering_reporter);
+        // service restart clears the UE metering metrics, so we need to
+        // offset metering_reporter with existing usage
+        store->initialize_metering_counter();
+        return store;
+      });
+
   auto pipelined_client = std::make_shared<magma::AsyncPipelinedClient>();
+  if (config["enable_flow_op_journal"].IsDefined() &&
+      config["enable_flow_op_journal"].as<bool>()) {
+    std::string journal_path = "/var/opt/magma/sessiond_flow_op.journal";
+    if (config["flow_op_journal_path"].IsDefined()) {
+      journal_path = config["flow_op_journal_path"].as<std::string>();
+    }
+    uint64_t journal_records = 1 << 12;  // 4k ops, ~8MB on disk
+    if (config["flow_op_journal_records"].IsDefined()) {
+      journal_records = config["flow_op_journal_records"].as<uint64_t>();
+    }
+    auto journal =
+        magma::lte::FlowOpJournal::open(journal_path, journal_records);
+    if (journal) {
+      pipelined_client->set_flow_op_journal(std::move(journal));
+    }
+  }
   std::thread pipelined_response_handling_thread([&]() {
     MLOG(MINFO) << "Started PipelineD response thread";
     pipelined_client->rpc_response_loop();
@@ -305,16 +417,23 @@ int main(int argc, char* argv[]) {
     reporter->rpc_response_loop();
   });
 
-  // Case on stateless config, setup the appropriate store client
-  auto metering_reporter = std::make_shared<magma::MeteringReporter>();
-  magma::SessionStore* session_store =
-      create_session_store(config, rule_store, metering_reporter);
-  // service restart clears the UE metering metrics, so we need to offset
-  // metering_reporter with existing usage
-  session_store->initialize_metering_counter();
+  // Collect the store prepared concurrently above; the enforcer is its
+  // first consumer, and by now the Redis connect has typically finished
+  // while the clients and reporter were warming up
+  magma::SessionStore* session_store = session_store_future.get();
+
+  // Warm handoff across upgrades: pull session state from an outgoing
+  // sessiond if one is listening, then take over the socket so this process
+  // can serve the next upgrade. Runs before the enforcer is built, so
+  // sync_sessions_on_restart below already sees the restored sessions.
+  if (config["state_handoff_socket"].IsDefined()) {
+    const auto handoff_socket =
+        config["state_handoff_socket"].as<std::string>();
+    magma::lte::StateHandoff::try_restore(
+        handoff_socket, session_store, rule_store);
+    magma::lte::StateHandoff::serve(handoff_socket, session_store);
+  }
 
-  // Some setup work for the SessionCredit class
-  set_consts(config);
   // Initialize the main logical component of SessionD
   auto local_enforcer = std::make_shared<magma::LocalEnforcer>(
       reporter, rule_store, *session_store, pipelined_client, events_reporter,
@@ -371,6 +490,15 @@ int main(int argc, char* argv[]) {
       server.GetNewCompletionQueue(), proxy_handler);
   server.AddServiceToServer(&local_service);
   MLOG(MINFO) << "Added LocalSessionManagerAsyncService to service's server";
+  // Additional completion queues let the local service handle requests on
+  // several cores; per-IMSI ordering is preserved by the sharded SessionStore
+  uint32_t grpc_completion_queues = 1;
+  if (config["grpc_completion_queues"].IsDefined()) {
+    grpc_completion_queues = config["grpc_completion_queues"].as<uint32_t>();
+  }
+  for (uint32_t i = 1; i < grpc_completion_queues; i++) {
+    local_service.add_completion_queue(server.GetNewCompletionQueue());
+  }
   server.AddServiceToServer(&proxy_service);
   MLOG(MINFO) << "Added SessionProxyResponderAsyncService to service's server";
 
@@ -423,6 +551,13 @@ int main(int argc, char* argv[]) {
     // 5G related SessionStateEnforcer main thread start to handled session
     // state
     conv_session_enforcer->attachEventBase(evb);
+    // Shard 5G session processing across dedicated event loops keyed by
+    // SUPI hash; 0 (the default) keeps it all on the main event base
+    uint32_t m5g_session_shards = 0;
+    if (config["m5g_session_shards"].IsDefined()) {
+      m5g_session_shards = config["m5g_session_shards"].as<uint32_t>();
+    }
+    conv_session_enforcer->start_session_shards(m5g_session_shards);
   }
 
   // For FWA always handle abort session
@@ -167,9 +167,9 @@ class MockPipelinedClient : public PipelinedClient {
           std::function<void(Status status, UPFSessionContextState)> callback));
   MOCK_METHOD0(get_next_teid, uint32_t());
   MOCK_METHOD0(get_current_teid, uint32_t());
-  MOCK_METHOD3(
+  MOCK_METHOD4(
       poll_stats, void(
-                      int cookie, int cookie_mask,
+                      int cookie, int cookie_mask, bool changed_only,
                       std::function<void(Status, RuleRecordTable)> callback));
 };
 
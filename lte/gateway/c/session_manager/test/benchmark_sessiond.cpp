@@ -0,0 +1,154 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CreditKey.h"
+#include "RuleStore.h"
+#include "SessionState.h"
+#include "SessionStore.h"
+#include "StoredState.h"
+
+// Micro-benchmarks for the sessiond hot paths: rule usage ingestion,
+// stored-state (de)serialization, SessionStore reads and CreditKey hashing.
+// Run the binary directly to get ns/op for each case; the numbers serve as
+// per-release baselines for catching storage-layer regressions.
+namespace magma {
+namespace {
+
+constexpr size_t NUM_SESSIONS = 10000;
+
+PolicyRule make_policy_rule(const std::string& rule_id) {
+  PolicyRule rule;
+  rule.set_id(rule_id);
+  rule.set_rating_group(1);
+  rule.set_monitoring_key("mk1");
+  rule.set_tracking_type(PolicyRule::OCS_AND_PCRF);
+  return rule;
+}
+
+SessionConfig make_session_config(const std::string& imsi) {
+  SessionConfig cfg;
+  Teids teids;
+  teids.set_agw_teid(1);
+  teids.set_enb_teid(2);
+  cfg.common_context.mutable_sid()->set_id(imsi);
+  cfg.common_context.set_ue_ipv4("192.168.128.11");
+  cfg.common_context.set_ue_ipv6("2001:db8::1");
+  cfg.common_context.mutable_teids()->CopyFrom(teids);
+  cfg.common_context.set_apn("apn");
+  cfg.common_context.set_msisdn("msisdn");
+  cfg.common_context.set_rat_type(TGPP_LTE);
+  return cfg;
+}
+
+std::string imsi_for(size_t i) {
+  return "IMSI00101" + std::to_string(1000000 + i);
+}
+
+std::unique_ptr<SessionState> make_session(
+    const std::string& imsi, StaticRuleStore& rule_store) {
+  auto session = std::make_unique<SessionState>(
+      imsi, imsi + "-1234", make_session_config(imsi), rule_store,
+      TgppContext{}, 12345, CreateSessionResponse{});
+  RuleLifetime lifetime;
+  session->activate_static_rule("benchmark_rule", lifetime, nullptr);
+  return session;
+}
+
+void benchmark_add_rule_usage(benchmark::State& state) {
+  auto rule_store = std::make_shared<StaticRuleStore>();
+  rule_store->insert_rule(make_policy_rule("benchmark_rule"));
+  auto session = make_session(imsi_for(0), *rule_store);
+
+  uint64_t tx = 0;
+  uint64_t rx = 0;
+  for (auto _ : state) {
+    tx += 100;
+    rx += 50;
+    session->add_rule_usage("benchmark_rule", 1, tx, rx, 0, 0, nullptr);
+  }
+}
+BENCHMARK(benchmark_add_rule_usage);
+
+void benchmark_serialize_stored_session(benchmark::State& state) {
+  auto rule_store = std::make_shared<StaticRuleStore>();
+  rule_store->insert_rule(make_policy_rule("benchmark_rule"));
+  auto session = make_session(imsi_for(0), *rule_store);
+  session->add_rule_usage("benchmark_rule", 1, 1000, 500, 0, 0, nullptr);
+  auto stored = session->marshal();
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(serialize_stored_session(stored));
+  }
+}
+BENCHMARK(benchmark_serialize_stored_session);
+
+void benchmark_deserialize_stored_session(benchmark::State& state) {
+  auto rule_store = std::make_shared<StaticRuleStore>();
+  rule_store->insert_rule(make_policy_rule("benchmark_rule"));
+  auto session = make_session(imsi_for(0), *rule_store);
+  session->add_rule_usage("benchmark_rule", 1, 1000, 500, 0, 0, nullptr);
+  auto stored     = session->marshal();
+  auto serialized = serialize_stored_session(stored);
+
+  for (auto _ : state) {
+    auto copy = serialized;
+    benchmark::DoNotOptimize(deserialize_stored_session(copy));
+  }
+}
+BENCHMARK(benchmark_deserialize_stored_session);
+
+void benchmark_session_store_read_sessions(benchmark::State& state) {
+  auto rule_store = std::make_shared<StaticRuleStore>();
+  rule_store->insert_rule(make_policy_rule("benchmark_rule"));
+  SessionStore session_store(
+      rule_store, std::make_shared<MeteringReporter>());
+  for (size_t i = 0; i < NUM_SESSIONS; i++) {
+    const auto imsi = imsi_for(i);
+    SessionVector sessions;
+    sessions.push_back(make_session(imsi, *rule_store));
+    session_store.create_sessions(imsi, std::move(sessions));
+  }
+
+  size_t next = 0;
+  for (auto _ : state) {
+    SessionRead req = {imsi_for(next % NUM_SESSIONS)};
+    next++;
+    benchmark::DoNotOptimize(session_store.read_sessions(req));
+  }
+}
+BENCHMARK(benchmark_session_store_read_sessions);
+
+void benchmark_credit_key_hash(benchmark::State& state) {
+  std::vector<CreditKey> keys;
+  keys.reserve(NUM_SESSIONS);
+  for (size_t i = 0; i < NUM_SESSIONS; i++) {
+    keys.push_back(CreditKey(i % 32, i % 4));
+  }
+
+  size_t next = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ccHash(keys[next % NUM_SESSIONS]));
+    next++;
+  }
+}
+BENCHMARK(benchmark_credit_key_hash);
+
+}  // namespace
+}  // namespace magma
+
+BENCHMARK_MAIN();
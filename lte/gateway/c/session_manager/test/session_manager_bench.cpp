@@ -0,0 +1,353 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/io/async/EventBaseManager.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Consts.h"
+#include "LocalEnforcer.h"
+#include "magma_logging_init.h"
+#include "ProtobufCreators.h"
+#include "RedisStoreClient.h"
+#include "SessiondMocks.h"
+#include "SessionStore.h"
+
+// Soak / limit benchmark for the full sessiond object graph: SessionStore
+// (MemoryStoreClient, or RedisStoreClient against a local redis) plus
+// LocalEnforcer wired to fake gRPC clients. Drives a configurable
+// create/update/terminate mix for an arbitrary duration and reports
+// throughput, p50/p99 operation latency and RSS growth at a fixed interval,
+// so session-map leaks and Redis write amplification show up long before
+// production does.
+//
+//   session_manager_bench --duration=3600 --subscribers=5000 \
+//       --mix=10:80:10 --redis --report-interval=30
+//
+// A duration of 0 runs until interrupted.
+
+namespace magma {
+namespace {
+
+constexpr uint32_t kChargingKey = 1;
+constexpr uint64_t kQuotaBytes  = 1UL << 30;
+const char* kRuleId             = "bench_rule";
+const char* kBenchIp            = "192.168.128.11";
+
+struct BenchArgs {
+  uint64_t duration_secs  = 60;
+  size_t subscribers      = 1000;
+  uint32_t create_weight  = 10;
+  uint32_t update_weight  = 80;
+  uint32_t term_weight    = 10;
+  uint64_t report_secs    = 10;
+  bool use_redis          = false;
+  std::string redis_host  = "127.0.0.1";
+  uint32_t redis_port     = 6379;
+};
+
+bool parse_args(int argc, char** argv, BenchArgs* args) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    auto value_of = [&arg](const char* prefix) {
+      return arg.substr(std::strlen(prefix));
+    };
+    if (arg.rfind("--duration=", 0) == 0) {
+      args->duration_secs = std::stoull(value_of("--duration="));
+    } else if (arg.rfind("--subscribers=", 0) == 0) {
+      args->subscribers = std::stoull(value_of("--subscribers="));
+    } else if (arg.rfind("--mix=", 0) == 0) {
+      if (std::sscanf(
+              value_of("--mix=").c_str(), "%u:%u:%u", &args->create_weight,
+              &args->update_weight, &args->term_weight) != 3) {
+        return false;
+      }
+    } else if (arg.rfind("--report-interval=", 0) == 0) {
+      args->report_secs = std::stoull(value_of("--report-interval="));
+    } else if (arg == "--redis") {
+      args->use_redis = true;
+    } else if (arg.rfind("--redis-host=", 0) == 0) {
+      args->redis_host = value_of("--redis-host=");
+    } else if (arg.rfind("--redis-port=", 0) == 0) {
+      args->redis_port = std::stoul(value_of("--redis-port="));
+    } else {
+      std::fprintf(stderr, "unknown argument: %s\n", arg.c_str());
+      return false;
+    }
+  }
+  return args->create_weight + args->update_weight + args->term_weight > 0;
+}
+
+uint64_t read_rss_kb() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("VmRSS:", 0) == 0) {
+      return std::stoull(line.substr(6));
+    }
+  }
+  return 0;
+}
+
+std::string imsi_for(size_t i) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "IMSI00101%09zu", i + 1);
+  return buf;
+}
+
+SessionConfig bench_config(const std::string& imsi) {
+  SessionConfig cfg;
+  Teids teids;
+  teids.set_agw_teid(TEID_1_UL);
+  teids.set_enb_teid(TEID_1_DL);
+  cfg.common_context = build_common_context(
+      imsi, kBenchIp, IPv6_1, teids, APN1, MSISDN, TGPP_LTE);
+  QosInformationRequest qos_info;
+  qos_info.set_apn_ambr_dl(64);
+  qos_info.set_br_unit(QosInformationRequest_BitrateUnitsAMBR_KBPS);
+  const auto& lte_context =
+      build_lte_context(IP2, "", "", "", "", BEARER_ID_1, &qos_info);
+  cfg.rat_specific_context.mutable_lte_context()->CopyFrom(lte_context);
+  return cfg;
+}
+
+class SoakDriver {
+ public:
+  explicit SoakDriver(const BenchArgs& args) : args_(args), rng_(0xb3ac4) {
+    rule_store_ = std::make_shared<StaticRuleStore>();
+    rule_store_->insert_rule(create_policy_rule(kRuleId, "", kChargingKey));
+
+    auto metering = std::make_shared<MeteringReporter>();
+    if (args_.use_redis) {
+      auto client = std::make_shared<cpp_redis::client>();
+      client->connect(args_.redis_host, args_.redis_port);
+      auto store_client = std::make_shared<RedisStoreClient>(
+          client, "sessiond_bench", rule_store_);
+      session_store_ =
+          std::make_shared<SessionStore>(rule_store_, metering, store_client);
+    } else {
+      session_store_ = std::make_shared<SessionStore>(rule_store_, metering);
+    }
+
+    reporter_  = std::make_shared<testing::NiceMock<MockSessionReporter>>();
+    pipelined_ = std::make_shared<testing::NiceMock<MockPipelinedClient>>();
+    spgw_client_ =
+        std::make_shared<testing::NiceMock<MockSpgwServiceClient>>();
+    aaa_client_ = std::make_shared<testing::NiceMock<MockAAAClient>>();
+    events_reporter_ =
+        std::make_shared<testing::NiceMock<MockEventsReporter>>();
+    enforcer_ = std::make_unique<LocalEnforcer>(
+        reporter_, rule_store_, *session_store_, pipelined_, events_reporter_,
+        spgw_client_, aaa_client_, 0, 0, get_default_mconfig());
+
+    evb_ = folly::EventBaseManager::get()->getEventBase();
+    enforcer_->attachEventBase(evb_);
+    evb_thread_ = std::thread([this]() { enforcer_->start(); });
+
+    active_.assign(args_.subscribers, false);
+    session_counter_.assign(args_.subscribers, 0);
+  }
+
+  ~SoakDriver() {
+    enforcer_->stop();
+    evb_thread_.join();
+  }
+
+  void run() {
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t start_rss_kb = read_rss_kb();
+    auto next_report = start + std::chrono::seconds(args_.report_secs);
+    std::vector<uint64_t> latencies_us;
+    latencies_us.reserve(1 << 20);
+    uint64_t interval_ops = 0;
+    uint64_t total_ops    = 0;
+
+    for (;;) {
+      const auto op_start = std::chrono::steady_clock::now();
+      if (args_.duration_secs > 0 &&
+          op_start - start >= std::chrono::seconds(args_.duration_secs)) {
+        break;
+      }
+      run_one_op();
+      const auto op_end = std::chrono::steady_clock::now();
+      latencies_us.push_back(
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              op_end - op_start)
+              .count());
+      interval_ops++;
+      total_ops++;
+
+      if (op_end >= next_report) {
+        report(
+            std::chrono::duration_cast<std::chrono::seconds>(op_end - start)
+                .count(),
+            interval_ops, latencies_us, start_rss_kb);
+        latencies_us.clear();
+        interval_ops = 0;
+        next_report += std::chrono::seconds(args_.report_secs);
+      }
+    }
+    std::printf(
+        "done: %lu ops total, %lu sessions active, rss %lu KB "
+        "(started at %lu KB)\n",
+        total_ops, active_count_, read_rss_kb(), start_rss_kb);
+  }
+
+ private:
+  void run_one_op() {
+    const uint32_t total =
+        args_.create_weight + args_.update_weight + args_.term_weight;
+    const uint32_t roll = rng_() % total;
+    if (roll < args_.create_weight || active_count_ == 0) {
+      do_create();
+    } else if (roll < args_.create_weight + args_.update_weight) {
+      do_update();
+    } else {
+      do_terminate();
+    }
+  }
+
+  size_t pick_subscriber(bool want_active) {
+    // Bounded probing keeps the driver O(1) even with a skewed mix
+    for (int probes = 0; probes < 64; probes++) {
+      size_t i = rng_() % args_.subscribers;
+      if (active_[i] == want_active) {
+        return i;
+      }
+    }
+    return args_.subscribers;  // give up, caller falls through
+  }
+
+  void do_create() {
+    size_t i = pick_subscriber(false);
+    if (i == args_.subscribers) {
+      return;
+    }
+    const std::string imsi = imsi_for(i);
+    const std::string session_id =
+        imsi + "-" + std::to_string(++session_counter_[i]);
+    auto session_map = session_store_->read_sessions(SessionRead{imsi});
+    CreateSessionResponse response;
+    create_credit_update_response(
+        imsi, session_id, kChargingKey, kQuotaBytes,
+        response.mutable_credits()->Add());
+    response.mutable_static_rules()->Add()->mutable_rule_id()->assign(kRuleId);
+    enforcer_->init_session(
+        session_map, imsi, session_id, bench_config(imsi), response);
+    Teids teids;
+    teids.set_agw_teid(TEID_1_UL);
+    teids.set_enb_teid(TEID_1_DL);
+    enforcer_->update_tunnel_ids(
+        session_map,
+        create_update_tunnel_ids_request(imsi, BEARER_ID_1, teids));
+    session_store_->create_sessions(imsi, std::move(session_map[imsi]));
+    active_[i] = true;
+    active_count_++;
+  }
+
+  void do_update() {
+    size_t i = pick_subscriber(true);
+    if (i == args_.subscribers) {
+      return;
+    }
+    const std::string imsi = imsi_for(i);
+    auto session_map = session_store_->read_sessions(SessionRead{imsi});
+    auto update      = SessionStore::get_default_session_update(session_map);
+    RuleRecordTable table;
+    create_rule_record(
+        imsi, kBenchIp, kRuleId, 1024, 2048, table.mutable_records()->Add());
+    enforcer_->aggregate_records(session_map, table, update);
+    session_store_->update_sessions(update);
+  }
+
+  void do_terminate() {
+    size_t i = pick_subscriber(true);
+    if (i == args_.subscribers) {
+      return;
+    }
+    const std::string imsi = imsi_for(i);
+    auto session_map =
+        session_store_->read_sessions_for_deletion(SessionRead{imsi});
+    auto update = SessionStore::get_default_session_update(session_map);
+    enforcer_->handle_termination_from_access(session_map, imsi, APN1, update);
+    session_store_->update_sessions(update);
+    active_[i] = false;
+    active_count_--;
+  }
+
+  void report(
+      uint64_t elapsed_secs, uint64_t interval_ops,
+      std::vector<uint64_t>& latencies_us, uint64_t start_rss_kb) {
+    uint64_t p50 = 0;
+    uint64_t p99 = 0;
+    if (!latencies_us.empty()) {
+      std::sort(latencies_us.begin(), latencies_us.end());
+      p50 = latencies_us[latencies_us.size() / 2];
+      p99 = latencies_us[(latencies_us.size() * 99) / 100];
+    }
+    const uint64_t rss_kb = read_rss_kb();
+    std::printf(
+        "[%6lus] %lu ops (%.1f/s) p50=%luus p99=%luus sessions=%lu "
+        "rss=%luKB (%+ldKB)\n",
+        elapsed_secs, interval_ops,
+        (double) interval_ops / (double) args_.report_secs, p50, p99,
+        active_count_, rss_kb, (int64_t) rss_kb - (int64_t) start_rss_kb);
+    std::fflush(stdout);
+  }
+
+  BenchArgs args_;
+  std::mt19937 rng_;
+  std::shared_ptr<StaticRuleStore> rule_store_;
+  std::shared_ptr<SessionStore> session_store_;
+  std::shared_ptr<MockSessionReporter> reporter_;
+  std::shared_ptr<MockPipelinedClient> pipelined_;
+  std::shared_ptr<MockSpgwServiceClient> spgw_client_;
+  std::shared_ptr<MockAAAClient> aaa_client_;
+  std::shared_ptr<MockEventsReporter> events_reporter_;
+  std::unique_ptr<LocalEnforcer> enforcer_;
+  folly::EventBase* evb_;
+  std::thread evb_thread_;
+  std::vector<bool> active_;
+  std::vector<uint32_t> session_counter_;
+  size_t active_count_ = 0;
+};
+
+}  // namespace
+}  // namespace magma
+
+int main(int argc, char** argv) {
+  ::testing::GMOCK_FLAG(verbose) = "error";
+  magma::BenchArgs args;
+  if (!magma::parse_args(argc, argv, &args)) {
+    std::fprintf(
+        stderr,
+        "usage: %s [--duration=SECS] [--subscribers=N] [--mix=C:U:T]\n"
+        "          [--report-interval=SECS] [--redis] [--redis-host=HOST]\n"
+        "          [--redis-port=PORT]\n",
+        argv[0]);
+    return 1;
+  }
+  magma::init_logging("session_manager_bench");
+  magma::SoakDriver driver(args);
+  driver.run();
+  return 0;
+}
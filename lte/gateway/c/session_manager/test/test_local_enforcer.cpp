@@ -56,6 +56,9 @@ class LocalEnforcerTest : public ::testing::Test {
     aaa_client           = std::make_shared<MockAAAClient>();
     events_reporter      = std::make_shared<MockEventsReporter>();
     auto default_mconfig = get_default_mconfig();
+    // Most tests assert the immediate per-rule install path; the batched
+    // path is covered by test_dedicated_bearer_batched_rule_install
+    LocalEnforcer::BEARER_RULE_BATCH_WINDOW_MS = 0;
     local_enforcer       = std::make_unique<LocalEnforcer>(
         reporter, rule_store, *session_store, pipelined_client, events_reporter,
         spgw_client, aaa_client, 0, 0, default_mconfig);
@@ -702,7 +705,7 @@ TEST_F(LocalEnforcerTest, test_collect_updates) {
       session_map,
       create_update_tunnel_ids_request(IMSI1, BEARER_ID_1, teids1));
 
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   auto update = SessionStore::get_default_session_update(session_map);
   auto empty_update =
       local_enforcer->collect_updates(session_map, actions, update);
@@ -774,7 +777,7 @@ TEST_F(LocalEnforcerTest, test_collect_updates_with_online_avp_to_0) {
   auto uc     = get_default_update_criteria();
   session_map[IMSI1][0]->increment_rule_stats("rule1", &uc);
   local_enforcer->aggregate_records(session_map, table, update);
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   auto session_update =
       local_enforcer->collect_updates(session_map, actions, update);
   local_enforcer->execute_actions(session_map, actions, update);
@@ -995,7 +998,7 @@ TEST_F(LocalEnforcerTest, test_terminate_credit_during_reporting) {
   local_enforcer->aggregate_records(session_map, table, update);
 
   // Collect updates to put key 1 into reporting state
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   auto usage_updates =
       local_enforcer->collect_updates(session_map, actions, update);
 
@@ -1219,7 +1222,7 @@ TEST_F(LocalEnforcerTest, test_final_unit_handling) {
   EXPECT_CALL(
       *spgw_client, delete_default_bearer(IMSI1, testing::_, testing::_));
   // call collect_updates to trigger actions
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   auto usage_updates =
       local_enforcer->collect_updates(session_map, actions, update);
   local_enforcer->execute_actions(session_map, actions, update);
@@ -1277,7 +1280,7 @@ TEST_F(LocalEnforcerTest, test_cwf_final_unit_handling) {
       .Times(1)
       .WillOnce(testing::Return(true));
   // call collect_updates to trigger actions
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   auto usage_updates =
       local_enforcer->collect_updates(session_map, actions, update);
   local_enforcer->execute_actions(session_map, actions, update);
@@ -1364,7 +1367,7 @@ TEST_F(LocalEnforcerTest, test_all) {
       1024);
 
   // Collect updates for reporting
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   auto session_update =
       local_enforcer->collect_updates(session_map, actions, update);
   local_enforcer->execute_actions(session_map, actions, update);
@@ -1482,7 +1485,7 @@ TEST_F(LocalEnforcerTest, test_credit_init_with_transient_error_redirect) {
       SERVICE_NEEDS_SUSPENSION);
 
   // Collect updates for reporting and check Redirect action needs to be done
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   auto session_update =
       local_enforcer->collect_updates(session_map, actions, update);
   EXPECT_EQ(actions.size(), 1);
@@ -1580,7 +1583,7 @@ TEST_F(LocalEnforcerTest, test_reauth_with_redirected_suspended_credit) {
 
   // execute redirection
   auto update = SessionStore::get_default_session_update(session_map);
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   auto session_update =
       local_enforcer->collect_updates(session_map, actions, update);
   local_enforcer->execute_actions(session_map, actions, update);
@@ -1648,7 +1651,7 @@ TEST_F(LocalEnforcerTest, test_re_auth) {
       local_enforcer->init_charging_reauth(session_map, reauth, update);
   EXPECT_EQ(result, ReAuthResult::UPDATE_INITIATED);
 
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   auto update_req =
       local_enforcer->collect_updates(session_map, actions, update);
   local_enforcer->execute_actions(session_map, actions, update);
@@ -1771,7 +1774,7 @@ TEST_F(LocalEnforcerTest, test_dynamic_rule_actions) {
       deactivate_flows_for_rules_for_termination(
           testing::_, testing::_, testing::_, testing::_, testing::_))
       .Times(1);
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   auto usage_updates =
       local_enforcer->collect_updates(session_map, actions, update);
   local_enforcer->execute_actions(session_map, actions, update);
@@ -1919,7 +1922,7 @@ TEST_F(LocalEnforcerTest, test_usage_monitors) {
       {{"1", 40}, {"3", 1024}, {"4", 1079}});
 
   // Collect updates, should only have mkeys 3 and 4
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   auto session_update =
       local_enforcer->collect_updates(session_map, actions, update);
   local_enforcer->execute_actions(session_map, actions, update);
@@ -2071,7 +2074,7 @@ TEST_F(LocalEnforcerTest, test_usage_monitor_disable) {
   local_enforcer->aggregate_records(session_map, table_1, update_1);
 
   // Collect updates, should have updates since all monitors got 80% exhausted
-  std::vector<std::unique_ptr<ServiceAction>> actions_1;
+  ServiceActionBatch actions_1;
   auto update_request_1 =
       local_enforcer->collect_updates(session_map, actions_1, update_1);
   EXPECT_EQ(update_request_1.updates_size(), 0);
@@ -2143,7 +2146,7 @@ TEST_F(LocalEnforcerTest, test_usage_monitor_disable) {
   // Collect updates, should receive three updatesResponses (two of them of the
   // last updates sent for  2 and 3.
   // Also it should mark 2 and 3 for deletion
-  std::vector<std::unique_ptr<ServiceAction>> actions_2;
+  ServiceActionBatch actions_2;
   auto update_request_2 =
       local_enforcer->collect_updates(session_map, actions_2, update_2);
   EXPECT_EQ(update_request_2.updates_size(), 0);
@@ -2241,6 +2244,54 @@ TEST_F(LocalEnforcerTest, test_dedicated_bearer_creation_on_session_init) {
       session_map, bearer_bind_req_success1, update);
 }
 
+// Two policies bound to the same dedicated bearer within the batching window
+// must be installed into PipelineD with a single activate_flows request
+TEST_F(LocalEnforcerTest, test_dedicated_bearer_batched_rule_install) {
+  LocalEnforcer::BEARER_RULE_BATCH_WINDOW_MS = 10;
+  CreateSessionResponse response;
+  const uint32_t default_bearer_id = 5;
+  const uint32_t bearer_1          = 6;
+  insert_static_rule_with_qos(0, "m1", "qos-rule1", 1);  // QCI=1
+  insert_static_rule_with_qos(0, "m1", "qos-rule2", 2);  // QCI=2
+
+  test_cfg_.common_context.mutable_sid()->set_id(IMSI1);
+  test_cfg_.common_context.set_apn("apn1");
+  auto lte_context = test_cfg_.rat_specific_context.mutable_lte_context();
+  lte_context->mutable_qos_info()->set_qos_class_id(5);
+  lte_context->set_bearer_id(default_bearer_id);  // linked_bearer_id
+
+  response.mutable_static_rules()->Add()->set_rule_id("qos-rule1");
+  response.mutable_static_rules()->Add()->set_rule_id("qos-rule2");
+  local_enforcer->init_session(
+      session_map, IMSI1, SESSION_ID_1, test_cfg_, response);
+  EXPECT_CALL(*spgw_client, create_dedicated_bearer(testing::_)).Times(1);
+  local_enforcer->update_tunnel_ids(
+      session_map,
+      create_update_tunnel_ids_request(IMSI1, default_bearer_id, teids1));
+
+  PolicyBearerBindingRequest bind_req1 = create_policy_bearer_bind_req(
+      IMSI1, default_bearer_id, "qos-rule1", bearer_1, 1, 2);
+  PolicyBearerBindingRequest bind_req2 = create_policy_bearer_bind_req(
+      IMSI1, default_bearer_id, "qos-rule2", bearer_1, 1, 2);
+
+  RuleToProcess expected_rule1 = make_rule_to_process("qos-rule1", 1, 2);
+  RuleToProcess expected_rule2 = make_rule_to_process("qos-rule2", 1, 2);
+  EXPECT_CALL(
+      *pipelined_client,
+      activate_flows_for_rules(
+          IMSI1, testing::_, testing::_, testing::_, testing::_, testing::_,
+          CheckRulesToProcess(
+              RulesToProcess{expected_rule1, expected_rule2}),
+          testing::_))
+      .Times(1);
+
+  auto update = SessionStore::get_default_session_update(session_map);
+  local_enforcer->bind_policy_to_bearer(session_map, bind_req1, update);
+  local_enforcer->bind_policy_to_bearer(session_map, bind_req2, update);
+  // Nothing is sent until the batching window elapses on the event base
+  run_evb();
+}
+
 // Create multiple rules with QoS and assert dedicated bearers are created
 // Simulate a policy->bearer mapping from MME, both success + failure.
 // Simulate additional rule updates to trigger dedicated bearer deletions
@@ -2597,7 +2648,7 @@ TEST_F(LocalEnforcerTest, test_revalidation_timer_on_init) {
   evb->loopOnce();
   auto update = SessionStore::get_default_session_update(session_map);
   session_map = session_store->read_sessions(SessionRead{IMSI1});
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   auto updates = local_enforcer->collect_updates(session_map, actions, update);
   EXPECT_EQ(updates.usage_monitors_size(), 1);
 }
@@ -2647,7 +2698,7 @@ TEST_F(LocalEnforcerTest, test_revalidation_timer_on_rar) {
   evb->loopOnce();
   evb->loopOnce();
   session_map = session_store->read_sessions(SessionRead{IMSI1});
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   auto updates = local_enforcer->collect_updates(session_map, actions, update);
   EXPECT_EQ(updates.usage_monitors_size(), 1);
 }
@@ -2724,7 +2775,7 @@ TEST_F(LocalEnforcerTest, test_revalidation_timer_on_update) {
   evb->loopOnce();
 
   session_map = session_store->read_sessions(SessionRead{IMSI1});
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   auto updates = local_enforcer->collect_updates(session_map, actions, update);
   EXPECT_EQ(updates.usage_monitors_size(), 1);
 }
@@ -2778,7 +2829,7 @@ TEST_F(LocalEnforcerTest, test_revalidation_timer_on_update_no_monitor) {
   evb->loopOnce();
 
   session_map = session_store->read_sessions(SessionRead{IMSI1});
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   auto updates = local_enforcer->collect_updates(session_map, actions, update);
   EXPECT_EQ(updates.usage_monitors_size(), 1);
 }
@@ -3037,12 +3088,12 @@ TEST_F(LocalEnforcerTest, test_final_unit_redirect_activation_and_termination) {
   local_enforcer->aggregate_records(session_map, table, update);
 
   // Collect actions and verify that restrict action is in the list
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   auto usage_updates =
       local_enforcer->collect_updates(session_map, actions, update);
   EXPECT_EQ(actions.size(), 1);
-  EXPECT_EQ(actions[0]->get_type(), REDIRECT);
-  PolicyRule redirect_rule = actions[0]->get_gy_rules_to_install()[0].rule;
+  EXPECT_EQ(actions[0].get_type(), REDIRECT);
+  PolicyRule redirect_rule = actions[0].get_gy_rules_to_install()[0].rule;
   EXPECT_EQ(redirect_rule.redirect().server_address(), "12.7.7.4");
 
   EXPECT_CALL(
@@ -3117,12 +3168,12 @@ TEST_F(LocalEnforcerTest, test_final_unit_activation_and_canceling) {
   local_enforcer->aggregate_records(session_map, table, update);
 
   // Collect actions and verify that restrict action is in the list
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   auto usage_updates =
       local_enforcer->collect_updates(session_map, actions, update);
   EXPECT_EQ(actions.size(), 1);
-  EXPECT_EQ(actions[0]->get_type(), RESTRICT_ACCESS);
-  EXPECT_EQ(actions[0]->get_gy_rules_to_install()[0].rule.id(), "rule1");
+  EXPECT_EQ(actions[0].get_type(), RESTRICT_ACCESS);
+  EXPECT_EQ(actions[0].get_gy_rules_to_install()[0].rule.id(), "rule1");
 
   EXPECT_CALL(
       *pipelined_client, add_gy_final_action_flow(
@@ -3219,7 +3270,7 @@ TEST_F(LocalEnforcerTest, test_final_unit_action_no_update) {
   session_map[IMSI1][0]->increment_rule_stats("static_rule1", &uc);
   local_enforcer->aggregate_records(session_map, table, update);
 
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   auto usage_updates =
       local_enforcer->collect_updates(session_map, actions, update);
   // No update should be seen
@@ -3237,9 +3288,9 @@ TEST_F(LocalEnforcerTest, test_final_unit_action_no_update) {
   actions.clear();
   usage_updates = local_enforcer->collect_updates(session_map, actions, update);
   EXPECT_EQ(actions.size(), 1);
-  EXPECT_EQ(actions[0]->get_type(), RESTRICT_ACCESS);
+  EXPECT_EQ(actions[0].get_type(), RESTRICT_ACCESS);
   EXPECT_EQ(
-      actions[0]->get_gy_rules_to_install()[0].rule.id(), "restrict_rule");
+      actions[0].get_gy_rules_to_install()[0].rule.id(), "restrict_rule");
 
   EXPECT_CALL(
       *pipelined_client,
@@ -3370,7 +3421,7 @@ TEST_F(
 
   // execute redirection
   auto update = SessionStore::get_default_session_update(session_map);
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   auto session_update =
       local_enforcer->collect_updates(session_map, actions, update);
   local_enforcer->execute_actions(session_map, actions, update);
@@ -3446,7 +3497,7 @@ TEST_F(
 
   // execute redirection
   auto update = SessionStore::get_default_session_update(session_map);
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   auto session_update =
       local_enforcer->collect_updates(session_map, actions, update);
   local_enforcer->execute_actions(session_map, actions, update);
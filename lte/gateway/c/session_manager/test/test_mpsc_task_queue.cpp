@@ -0,0 +1,72 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/io/async/EventBase.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "MpscTaskQueue.h"
+
+namespace magma {
+
+TEST(test_mpsc_task_queue, test_tasks_run_in_post_order) {
+  folly::EventBase evb;
+  MpscTaskQueue queue;
+  queue.attach(&evb);
+
+  std::vector<int> ran;
+  for (int i = 0; i < 10; i++) {
+    queue.post([&ran, i] { ran.push_back(i); });
+  }
+  evb.loopOnce();
+
+  ASSERT_EQ(ran.size(), 10);
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(ran[i], i);
+  }
+}
+
+TEST(test_mpsc_task_queue, test_posts_from_multiple_threads) {
+  folly::EventBase evb;
+  MpscTaskQueue queue;
+  queue.attach(&evb);
+
+  const int n_threads        = 4;
+  const int tasks_per_thread = 1000;
+  std::atomic<int> task_count(0);
+
+  std::vector<std::thread> producers;
+  for (int i = 0; i < n_threads; i++) {
+    producers.emplace_back([&queue, &task_count] {
+      for (int j = 0; j < tasks_per_thread; j++) {
+        queue.post([&task_count] { task_count++; });
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  while (task_count < n_threads * tasks_per_thread) {
+    evb.loopOnce();
+  }
+  EXPECT_EQ(task_count, n_threads * tasks_per_thread);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+}  // namespace magma
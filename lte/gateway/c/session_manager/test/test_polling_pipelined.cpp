@@ -117,25 +117,45 @@ TEST_F(LocalEnforcerStatsPollerTest, test_poll_stats) {
 
   local_enforcer->aggregate_records(session_map, table, update);
 
+  // The very first poll requests the full table; subsequent polls only ask
+  // for records whose counters moved
   int cookie      = 0;
   int cookie_mask = 0;
-  EXPECT_CALL(*pipelined_client, poll_stats(cookie, cookie_mask, testing::_))
+  EXPECT_CALL(
+      *pipelined_client, poll_stats(cookie, cookie_mask, false, testing::_))
       .Times(1);
   local_enforcer->poll_stats_enforcer(cookie, cookie_mask);
 
   cookie      = 1;
   cookie_mask = 0;
-  EXPECT_CALL(*pipelined_client, poll_stats(cookie, cookie_mask, testing::_))
+  EXPECT_CALL(
+      *pipelined_client, poll_stats(cookie, cookie_mask, true, testing::_))
       .Times(1);
   local_enforcer->poll_stats_enforcer(cookie, cookie_mask);
 
   cookie      = 0;
   cookie_mask = 1;
-  EXPECT_CALL(*pipelined_client, poll_stats(cookie, cookie_mask, testing::_))
+  EXPECT_CALL(
+      *pipelined_client, poll_stats(cookie, cookie_mask, true, testing::_))
       .Times(1);
   local_enforcer->poll_stats_enforcer(cookie, cookie_mask);
 }
 
+TEST_F(LocalEnforcerStatsPollerTest, test_adaptive_poll_interval) {
+  // Before any poll completes, the configured interval is used as-is
+  EXPECT_EQ(local_enforcer->get_stats_poll_interval(8), 8u);
+
+  // An idle dataplane (a poll that saw no counter movement) relaxes the
+  // interval
+  local_enforcer->handle_pipelined_response(Status::OK, RuleRecordTable());
+  EXPECT_EQ(local_enforcer->get_stats_poll_interval(8), 32u);
+
+  // A failed poll leaves the last observation in place
+  local_enforcer->handle_pipelined_response(
+      Status(grpc::ABORTED, "ABORTED"), RuleRecordTable());
+  EXPECT_EQ(local_enforcer->get_stats_poll_interval(8), 32u);
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   FLAGS_logtostderr = 1;
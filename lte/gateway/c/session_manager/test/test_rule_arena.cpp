@@ -0,0 +1,88 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "RuleStore.h"
+
+namespace magma {
+
+static PolicyRule make_rule(const std::string& id, uint32_t rating_group) {
+  PolicyRule rule;
+  rule.set_id(id);
+  rule.set_rating_group(rating_group);
+  rule.set_tracking_type(PolicyRule::ONLY_OCS);
+  return rule;
+}
+
+TEST(test_rule_arena, test_identical_definitions_share_one_object) {
+  auto rule = make_rule("rule1", 1);
+
+  auto p1 = PolicyRuleArena::instance().intern(rule);
+  auto p2 = PolicyRuleArena::instance().intern(rule);
+  EXPECT_EQ(p1.get(), p2.get());
+
+  // Any field difference yields a distinct canonical object
+  auto other = make_rule("rule1", 2);
+  auto p3    = PolicyRuleArena::instance().intern(other);
+  EXPECT_NE(p1.get(), p3.get());
+}
+
+TEST(test_rule_arena, test_stores_share_interned_rules) {
+  auto rule = make_rule("shared_rule", 1);
+
+  // Simulate the same PCRF template installed for two subscribers
+  DynamicRuleStore store_a;
+  DynamicRuleStore store_b;
+  store_a.insert_rule(rule);
+  store_b.insert_rule(rule);
+
+  PolicyRule out_a, out_b;
+  EXPECT_TRUE(store_a.get_rule("shared_rule", &out_a));
+  EXPECT_TRUE(store_b.get_rule("shared_rule", &out_b));
+  EXPECT_EQ(out_a.rating_group(), out_b.rating_group());
+
+  // Both stores resolve the id to the one arena object
+  std::vector<PolicyRule> defs_a, defs_b;
+  EXPECT_TRUE(store_a.get_rule_definitions_for_charging_key(
+      CreditKey(rule), defs_a));
+  EXPECT_TRUE(store_b.get_rule_definitions_for_charging_key(
+      CreditKey(rule), defs_b));
+  ASSERT_EQ(defs_a.size(), 1);
+  ASSERT_EQ(defs_b.size(), 1);
+}
+
+TEST(test_rule_arena, test_definitions_freed_when_last_store_drops_them) {
+  auto rule       = make_rule("transient_rule", 42);
+  auto live_start = PolicyRuleArena::instance().live_definition_count();
+
+  {
+    DynamicRuleStore store;
+    store.insert_rule(rule);
+    EXPECT_EQ(
+        PolicyRuleArena::instance().live_definition_count(), live_start + 1);
+  }
+
+  // The arena only holds weak references; the definition died with the store
+  EXPECT_EQ(PolicyRuleArena::instance().live_definition_count(), live_start);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+}  // namespace magma
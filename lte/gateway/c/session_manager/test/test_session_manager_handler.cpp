@@ -360,6 +360,49 @@ TEST_F(SessionManagerHandlerTest, test_create_session) {
   evb->loopOnce();
 }
 
+TEST_F(SessionManagerHandlerTest, test_create_session_dedup) {
+  send_empty_table_and_wait_for_successful_setup();
+  LocalCreateSessionRequest request;
+
+  grpc::ServerContext server_context;
+  request.mutable_common_context()->mutable_sid()->set_id(IMSI1);
+  request.mutable_common_context()->set_rat_type(RATType::TGPP_LTE);
+  request.mutable_common_context()->set_msisdn(MSISDN);
+
+  // Only the first of the identical requests may reach the reporter
+  std::function<void(Status, CreateSessionResponse)> report_cb;
+  EXPECT_CALL(*reporter, report_create_session(_, _))
+      .Times(1)
+      .WillOnce(testing::SaveArg<1>(&report_cb));
+
+  int responses       = 0;
+  auto count_response = [&responses](
+                            grpc::Status status,
+                            LocalCreateSessionResponse response_out) {
+    responses++;
+  };
+
+  // Retried identical requests attach to the in-flight original
+  session_manager->CreateSession(&server_context, &request, count_response);
+  session_manager->CreateSession(&server_context, &request, count_response);
+  session_manager->CreateSession(&server_context, &request, count_response);
+
+  // Run session creation in the EventBase loop; nobody is answered while
+  // the original is still in flight
+  evb->loopOnce();
+  EXPECT_EQ(responses, 0);
+
+  // Completing the original answers all attached duplicates with it
+  CreateSessionResponse create_response;
+  report_cb(grpc::Status::OK, create_response);
+  EXPECT_EQ(responses, 3);
+
+  // A later identical retry within the dedup window is served the
+  // completed response without reaching the reporter again
+  session_manager->CreateSession(&server_context, &request, count_response);
+  EXPECT_EQ(responses, 4);
+}
+
 TEST_F(SessionManagerHandlerTest, test_create_session_pipelined_unavailable) {
   send_empty_table();
   // On failure cases, LocalEnforcer will endlessly retry the setup call
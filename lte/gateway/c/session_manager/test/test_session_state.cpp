@@ -303,7 +303,7 @@ TEST_F(SessionStateTest, test_add_rule_usage) {
       update_criteria.monitor_credit_map["m2"].bucket_deltas[USED_RX], 2000);
 
   UpdateSessionRequest update;
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   session_state->get_updates(&update, &actions, &update_criteria);
   EXPECT_EQ(actions.size(), 0);
   EXPECT_EQ(update.updates_size(), 2);
@@ -375,7 +375,7 @@ TEST_F(SessionStateTest, test_mixed_tracking_rules) {
       update_criteria.monitor_credit_map["m3"].bucket_deltas[USED_TX], 5000);
 
   UpdateSessionRequest update;
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   session_state->get_updates(&update, &actions, nullptr);
   EXPECT_EQ(actions.size(), 0);
   EXPECT_EQ(update.updates_size(), 2);
@@ -406,7 +406,7 @@ TEST_F(SessionStateTest, test_session_level_key) {
 
   // check one updates will be sent
   UpdateSessionRequest update;
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   session_state->get_updates(&update, &actions, &update_criteria);
   EXPECT_EQ(actions.size(), 0);
   EXPECT_EQ(update.usage_monitors_size(), 1);
@@ -427,7 +427,7 @@ TEST_F(SessionStateTest, test_session_level_key) {
 
   // check final update will be sent
   UpdateSessionRequest update_2;
-  std::vector<std::unique_ptr<ServiceAction>> actions_2;
+  ServiceActionBatch actions_2;
   session_state->get_updates(&update_2, &actions_2, &update_criteria);
   // TODO: session level seemsd to be adding total values, no deltas
   // EXPECT_EQ(
@@ -460,7 +460,7 @@ TEST_F(SessionStateTest, test_reauth_key) {
   session_state->add_rule_usage("rule1", 1, 1000, 500, 0, 0, &update_criteria);
 
   UpdateSessionRequest update;
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   session_state->get_updates(&update, &actions, &update_criteria);
   EXPECT_EQ(update.updates_size(), 1);
   EXPECT_EQ(session_state->get_charging_credit(1, REPORTING_TX), 1000);
@@ -504,7 +504,7 @@ TEST_F(SessionStateTest, test_reauth_new_key) {
   EXPECT_EQ(new_charging_credits[1].reauth_state, REAUTH_REQUIRED);
 
   UpdateSessionRequest reauth_update;
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   session_state->get_updates(&reauth_update, &actions, &update_criteria);
   EXPECT_EQ(reauth_update.updates_size(), 1);
   auto& usage = reauth_update.updates(0).usage();
@@ -559,7 +559,7 @@ TEST_F(SessionStateTest, test_reauth_all) {
   EXPECT_EQ(credit_uc_2.reauth_state, REAUTH_REQUIRED);
 
   UpdateSessionRequest reauth_update;
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   session_state->get_updates(&reauth_update, &actions, &uc);
   EXPECT_EQ(reauth_update.updates_size(), 2);
 
@@ -599,7 +599,7 @@ TEST_F(SessionStateTest, test_tgpp_context_is_set_on_update) {
       1024);
 
   UpdateSessionRequest update;
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   session_state->get_updates(&update, &actions, nullptr);
   EXPECT_EQ(actions.size(), 0);
   EXPECT_EQ(update.updates_size(), 1);
@@ -844,7 +844,7 @@ TEST_F(SessionStateTest, test_multiple_final_action_empty_grant) {
 
   // check if we need to report the usage
   UpdateSessionRequest update;
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   session_state->get_updates(&update, &actions, &update_criteria);
   EXPECT_EQ(actions.size(), 0);
   EXPECT_EQ(update.updates_size(), 1);
@@ -1002,7 +1002,7 @@ TEST_F(SessionStateTest, test_monitor_cycle) {
 
   // Get the updates that will be sent to core
   UpdateSessionRequest update;
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   session_state->get_updates(&update, &actions, &update_criteria);
   EXPECT_EQ(actions.size(), 0);
   EXPECT_EQ(update.usage_monitors_size(), 1);
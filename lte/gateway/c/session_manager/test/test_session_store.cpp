@@ -628,6 +628,64 @@ TEST_F(SessionStoreTest, test_get_session) {
   EXPECT_FALSE(optional_it7);
 }
 
+TEST_F(SessionStoreTest, test_secondary_index_lookup) {
+  // Writes maintain the secondary index, so criteria lookups on a map read
+  // back from the store resolve through the indexed fast path
+  Teids teid;
+  teid.set_enb_teid(TEID_3_DL);
+  teid.set_agw_teid(TEID_3_UL);
+  auto session =
+      get_lte_session(IMSI3, SESSION_ID_3, IP3, IPv6_3, teid, "APN2");
+  auto sessions = SessionVector{};
+  sessions.push_back(std::move(session));
+  EXPECT_TRUE(session_store->create_sessions(IMSI3, std::move(sessions)));
+
+  auto session_map = session_store->read_sessions(SessionRead{IMSI3});
+
+  SessionSearchCriteria by_ipv4(IMSI3, IMSI_AND_UE_IPV4, IP3);
+  auto it_ipv4 = session_store->find_session(session_map, by_ipv4);
+  EXPECT_TRUE(it_ipv4);
+  EXPECT_EQ((**it_ipv4)->get_session_id(), SESSION_ID_3);
+
+  SessionSearchCriteria by_teid(IMSI3, IMSI_AND_TEID, TEID_3_DL);
+  auto it_teid = session_store->find_session(session_map, by_teid);
+  EXPECT_TRUE(it_teid);
+  EXPECT_EQ((**it_teid)->get_session_id(), SESSION_ID_3);
+
+  SessionSearchCriteria by_bad_teid(IMSI3, IMSI_AND_TEID, 99);
+  EXPECT_FALSE(session_store->find_session(session_map, by_bad_teid));
+}
+
+TEST_F(SessionStoreTest, test_sessions_snapshot) {
+  // Nothing committed yet -> empty snapshot
+  EXPECT_EQ(session_store->get_sessions_snapshot().size(), 0);
+  auto version_0 = session_store->get_snapshot_version();
+
+  auto sessions = SessionVector{};
+  sessions.push_back(get_session(IMSI1, SESSION_ID_1));
+  EXPECT_TRUE(session_store->create_sessions(IMSI1, std::move(sessions)));
+
+  // The commit published an immutable version for IMSI1
+  auto snapshot = session_store->get_sessions_snapshot();
+  EXPECT_EQ(snapshot.size(), 1);
+  ASSERT_NE(snapshot.find(IMSI1), snapshot.end());
+  EXPECT_EQ(snapshot[IMSI1]->size(), 1);
+  EXPECT_EQ(snapshot[IMSI1]->front().session_id, SESSION_ID_1);
+  EXPECT_GT(session_store->get_snapshot_version(), version_0);
+
+  // Terminate the session while still holding the old snapshot pinned
+  auto update_req = SessionUpdate{};
+  auto update_criteria             = get_default_update_criteria();
+  update_criteria.is_session_ended = true;
+  update_req[IMSI1][SESSION_ID_1]  = update_criteria;
+  EXPECT_TRUE(session_store->update_sessions(update_req));
+
+  // New readers see the subscriber gone, but the pinned version is intact
+  auto snapshot_2 = session_store->get_sessions_snapshot();
+  EXPECT_EQ(snapshot_2.find(IMSI1), snapshot_2.end());
+  EXPECT_EQ(snapshot[IMSI1]->front().session_id, SESSION_ID_1);
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
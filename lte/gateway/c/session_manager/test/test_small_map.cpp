@@ -0,0 +1,100 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "CreditKey.h"
+#include "SmallMap.h"
+
+namespace magma {
+
+TEST(test_small_map, test_insert_find_erase_inline) {
+  SmallMap<std::string, int, 4> map;
+
+  map["one"] = 1;
+  map["two"] = 2;
+  EXPECT_EQ(map.size(), 2);
+
+  auto it = map.find("one");
+  ASSERT_NE(it, map.end());
+  EXPECT_EQ(it->second, 1);
+  EXPECT_EQ(map.find("three"), map.end());
+
+  // operator[] on an existing key updates in place
+  map["one"] = 10;
+  EXPECT_EQ(map.size(), 2);
+  EXPECT_EQ(map.find("one")->second, 10);
+
+  EXPECT_EQ(map.erase("one"), 1);
+  EXPECT_EQ(map.erase("one"), 0);
+  EXPECT_EQ(map.size(), 1);
+  EXPECT_EQ(map.find("one"), map.end());
+  EXPECT_EQ(map.find("two")->second, 2);
+}
+
+TEST(test_small_map, test_spill_to_hash_map) {
+  SmallMap<std::string, int, 2> map;
+
+  for (int i = 0; i < 10; i++) {
+    map["key" + std::to_string(i)] = i;
+  }
+  EXPECT_EQ(map.size(), 10);
+
+  // All entries remain reachable after spilling past the inline capacity
+  for (int i = 0; i < 10; i++) {
+    auto it = map.find("key" + std::to_string(i));
+    ASSERT_NE(it, map.end());
+    EXPECT_EQ(it->second, i);
+  }
+
+  EXPECT_EQ(map.erase("key5"), 1);
+  EXPECT_EQ(map.size(), 9);
+  EXPECT_EQ(map.find("key5"), map.end());
+
+  int sum = 0;
+  for (auto& entry : map) {
+    sum += entry.second;
+  }
+  EXPECT_EQ(sum, 0 + 1 + 2 + 3 + 4 + 6 + 7 + 8 + 9);
+}
+
+TEST(test_small_map, test_credit_key_map_with_move_only_values) {
+  SmallMap<CreditKey, std::unique_ptr<int>, 2, decltype(&ccHash),
+           decltype(&ccEqual)>
+      map(4, &ccHash, &ccEqual);
+
+  map[CreditKey(1)] = std::make_unique<int>(100);
+  map[CreditKey(2)] = std::make_unique<int>(200);
+  EXPECT_EQ(*map.find(CreditKey(1))->second, 100);
+
+  // Erasing from the inline vector moves the surviving values
+  EXPECT_EQ(map.erase(CreditKey(1)), 1);
+  EXPECT_EQ(map.size(), 1);
+  EXPECT_EQ(*map.find(CreditKey(2))->second, 200);
+
+  // Spilling moves values into the hash map
+  map[CreditKey(3)] = std::make_unique<int>(300);
+  map[CreditKey(4)] = std::make_unique<int>(400);
+  EXPECT_EQ(map.size(), 3);
+  EXPECT_EQ(*map.find(CreditKey(2))->second, 200);
+  EXPECT_EQ(*map.find(CreditKey(4))->second, 400);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+}  // namespace magma
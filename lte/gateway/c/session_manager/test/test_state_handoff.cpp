@@ -0,0 +1,103 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+
+#include "Consts.h"
+#include "magma_logging.h"
+#include "ProtobufCreators.h"
+#include "RuleStore.h"
+#include "SessionState.h"
+#include "SessionStore.h"
+#include "StateHandoff.h"
+#include "StoredState.h"
+
+namespace magma {
+
+class StateHandoffTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    rule_store  = std::make_shared<StaticRuleStore>();
+    socket_path = "/tmp/sessiond_handoff_test_" +
+                  std::to_string(getpid()) + ".sock";
+    unlink(socket_path.c_str());
+  }
+
+  virtual void TearDown() { unlink(socket_path.c_str()); }
+
+  std::unique_ptr<SessionStore> make_store() {
+    return std::make_unique<SessionStore>(
+        rule_store, std::make_shared<MeteringReporter>());
+  }
+
+  std::unique_ptr<SessionState> get_session(
+      const std::string& imsi, const std::string& session_id) {
+    Teids teids;
+    teids.set_enb_teid(TEID_1_DL);
+    teids.set_agw_teid(TEID_1_UL);
+    SessionConfig cfg;
+    cfg.common_context = build_common_context(
+        imsi, IP2, IPv6_2, teids, APN1, MSISDN, TGPP_WLAN);
+    const auto& wlan_context = build_wlan_context(MAC_ADDR, RADIUS_SESSION_ID);
+    cfg.rat_specific_context.mutable_wlan_context()->CopyFrom(wlan_context);
+    auto tgpp_context   = TgppContext{};
+    auto pdp_start_time = 12345;
+    CreateSessionResponse response;
+    return std::make_unique<SessionState>(
+        imsi, session_id, cfg, *rule_store, tgpp_context, pdp_start_time,
+        response);
+  }
+
+  std::shared_ptr<StaticRuleStore> rule_store;
+  std::string socket_path;
+};
+
+TEST_F(StateHandoffTest, test_restore_without_predecessor) {
+  auto store = make_store();
+  // No listener on the socket -> cold start, store left untouched
+  EXPECT_FALSE(StateHandoff::try_restore(
+      socket_path, store.get(), rule_store));
+  EXPECT_EQ(store->read_all_sessions().size(), 0);
+}
+
+TEST_F(StateHandoffTest, test_handoff_between_stores) {
+  auto outgoing = make_store();
+  auto sessions = SessionVector{};
+  sessions.push_back(get_session(IMSI1, SESSION_ID_1));
+  sessions.push_back(get_session(IMSI1, SESSION_ID_2));
+  EXPECT_TRUE(outgoing->create_sessions(IMSI1, std::move(sessions)));
+
+  StateHandoff::serve(socket_path, outgoing.get());
+
+  auto incoming = make_store();
+  EXPECT_TRUE(StateHandoff::try_restore(
+      socket_path, incoming.get(), rule_store));
+
+  auto session_map = incoming->read_sessions(SessionRead{IMSI1});
+  EXPECT_EQ(session_map[IMSI1].size(), 2);
+  SessionSearchCriteria criteria(IMSI1, IMSI_AND_SESSION_ID, SESSION_ID_1);
+  auto session_it = incoming->find_session(session_map, criteria);
+  EXPECT_TRUE(session_it);
+  EXPECT_EQ((**session_it)->get_config().common_context.apn(), APN1);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+}  // namespace magma
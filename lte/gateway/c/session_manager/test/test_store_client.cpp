@@ -147,6 +147,66 @@ TEST_F(StoreClientTest, test_read_and_write) {
       response3.DebugString());
 }
 
+/**
+ * Test of the MemoryStoreClient borrow mode.
+ * 1) Write a session for IMSI1
+ * 2) Borrow the subscriber's sessions and mutate them in place
+ * 3) Write them back and verify the stored object is the borrowed one
+ * 4) Verify writes bump the commit version and hand-backs do not
+ */
+TEST_F(StoreClientTest, test_borrow_and_commit) {
+  std::string imsi  = "IMSI1";
+  std::string imsi2 = "IMSI2";
+  auto sid          = id_gen_.gen_session_id(imsi);
+  Teids teids;
+  teids.set_agw_teid(1);
+  teids.set_enb_teid(2);
+  SessionConfig cfg;
+  cfg.common_context = build_common_context(
+      "", "128.0.0.1", "2001:0db8:0a0b:12f0:0000:0000:0000:0001", teids, "APN",
+      "5100001234", TGPP_WLAN);
+  auto rule_store     = std::make_shared<StaticRuleStore>();
+  auto tgpp_context   = TgppContext{};
+  auto pdp_start_time = 12345;
+  CreateSessionResponse response;
+  create_credit_update_response(
+      imsi, sid, 1, 1000, response.mutable_credits()->Add());
+  auto session = std::make_unique<SessionState>(
+      imsi, sid, cfg, *rule_store, tgpp_context, pdp_start_time, response);
+
+  auto store_client = MemoryStoreClient(rule_store);
+  EXPECT_EQ(store_client.get_commit_version(), 0);
+
+  auto session_map = SessionMap{};
+  session_map[imsi].push_back(std::move(session));
+  store_client.write_sessions(std::move(session_map));
+  EXPECT_EQ(store_client.get_commit_version(), 1);
+
+  // Borrowing hands out the live sessions; missing subscribers still get
+  // empty entries like a read
+  std::set<std::string> requested_ids{imsi, imsi2};
+  auto borrowed = store_client.borrow_sessions(requested_ids);
+  EXPECT_EQ(borrowed.size(), 2);
+  EXPECT_EQ(borrowed[imsi].size(), 1);
+  EXPECT_EQ(borrowed[imsi2].size(), 0);
+  SessionState* live = borrowed[imsi].front().get();
+  live->increment_request_number(7);
+  store_client.write_sessions(std::move(borrowed));
+  EXPECT_EQ(store_client.get_commit_version(), 2);
+
+  // The stored session is the very object mutated above - no copies made
+  auto borrowed_2 = store_client.borrow_sessions({imsi});
+  EXPECT_EQ(borrowed_2[imsi].front().get(), live);
+  store_client.return_borrowed_sessions(std::move(borrowed_2));
+  EXPECT_EQ(store_client.get_commit_version(), 2);
+
+  // Plain reads still hand out deep copies of the live sessions
+  auto copies = store_client.read_sessions({imsi});
+  EXPECT_EQ(copies[imsi].size(), 1);
+  EXPECT_NE(copies[imsi].front().get(), live);
+  EXPECT_EQ(copies[imsi].front()->get_session_id(), sid);
+}
+
 TEST_F(StoreClientTest, test_lambdas) {
   auto sm = std::make_unique<int>(1);
 
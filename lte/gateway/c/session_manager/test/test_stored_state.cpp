@@ -245,6 +245,40 @@ TEST_F(StoredStateTest, test_stored_session_credit) {
   EXPECT_EQ(deserialized.grant_tracking_type, TX_ONLY);
 }
 
+TEST_F(StoredStateTest, test_session_credit_update_criteria) {
+  SessionCreditUpdateCriteria stored{};
+  stored.is_final                  = true;
+  stored.reauth_state              = REAUTH_REQUIRED;
+  stored.service_state             = SERVICE_ENABLED;
+  stored.expiry_time               = 1024;
+  stored.reporting                 = true;
+  stored.grant_tracking_type       = TX_ONLY;
+  stored.bucket_deltas[USED_TX]    = 111;
+  stored.bucket_deltas[USED_RX]    = 333;
+  stored.deleted                   = false;
+  stored.report_last_credit        = true;
+  stored.time_of_first_usage       = 5;
+  stored.time_of_last_usage        = 10;
+  stored.suspended                 = true;
+
+  auto serialized   = serialize_session_credit_update_criteria(stored);
+  auto deserialized = deserialize_session_credit_update_criteria(serialized);
+
+  EXPECT_EQ(deserialized.is_final, true);
+  EXPECT_EQ(deserialized.reauth_state, REAUTH_REQUIRED);
+  EXPECT_EQ(deserialized.service_state, SERVICE_ENABLED);
+  EXPECT_EQ(deserialized.expiry_time, 1024);
+  EXPECT_EQ(deserialized.reporting, true);
+  EXPECT_EQ(deserialized.grant_tracking_type, TX_ONLY);
+  EXPECT_EQ(deserialized.bucket_deltas[USED_TX], 111);
+  EXPECT_EQ(deserialized.bucket_deltas[USED_RX], 333);
+  EXPECT_EQ(deserialized.deleted, false);
+  EXPECT_EQ(deserialized.report_last_credit, true);
+  EXPECT_EQ(deserialized.time_of_first_usage, 5);
+  EXPECT_EQ(deserialized.time_of_last_usage, 10);
+  EXPECT_EQ(deserialized.suspended, true);
+}
+
 TEST_F(StoredStateTest, test_stored_monitor) {
   auto stored = get_stored_monitor();
 
@@ -378,6 +412,51 @@ TEST_F(StoredStateTest, test_stored_session) {
       40);
 }
 
+TEST_F(StoredStateTest, test_stored_session_binary) {
+  auto stored = get_stored_session();
+
+  auto serialized   = serialize_stored_session_binary(stored);
+  EXPECT_EQ(static_cast<uint8_t>(serialized[0]), SESSION_BINARY_MAGIC);
+  auto deserialized = deserialize_stored_session(serialized);
+
+  auto stored_charging_credit = deserialized.credit_map[CreditKey(1, 2)];
+  EXPECT_EQ(stored_charging_credit.is_final, true);
+  EXPECT_EQ(
+      stored_charging_credit.final_action_info.final_action,
+      ChargingCredit_FinalAction::ChargingCredit_FinalAction_REDIRECT);
+  EXPECT_EQ(stored_charging_credit.reauth_state, REAUTH_REQUIRED);
+  EXPECT_EQ(stored_charging_credit.service_state, SERVICE_NEEDS_ACTIVATION);
+  EXPECT_EQ(stored_charging_credit.expiry_time, 32);
+  EXPECT_EQ(stored_charging_credit.credit.buckets[USED_TX], 12345);
+  EXPECT_EQ(stored_charging_credit.credit.buckets[ALLOWED_TOTAL], 54321);
+
+  auto stored_monitor = deserialized.monitor_map["mk1"];
+  EXPECT_EQ(stored_monitor.credit.reporting, true);
+  EXPECT_EQ(stored_monitor.credit.buckets[USED_TX], 12345);
+  EXPECT_EQ(stored_monitor.level, MonitoringLevel::PCC_RULE_LEVEL);
+
+  EXPECT_EQ(deserialized.session_level_key, "session_level_key");
+  EXPECT_EQ(deserialized.imsi, "IMSI1");
+  EXPECT_EQ(deserialized.session_id, "session_id");
+  EXPECT_EQ(
+      deserialized.subscriber_quota_state,
+      SubscriberQuotaUpdate_Type_VALID_QUOTA);
+  EXPECT_EQ(deserialized.fsm_state, SESSION_RELEASED);
+  EXPECT_EQ(deserialized.tgpp_context.gx_dest_host(), "gx");
+  EXPECT_EQ(deserialized.tgpp_context.gy_dest_host(), "gy");
+  EXPECT_EQ(deserialized.pending_event_triggers.size(), 1);
+  EXPECT_EQ(deserialized.pending_event_triggers[REVALIDATION_TIMEOUT], READY);
+  EXPECT_EQ(deserialized.revalidation_time.seconds(), 32);
+  EXPECT_EQ(deserialized.bearer_id_by_policy.size(), 2);
+  EXPECT_EQ(deserialized.request_number, 1);
+  EXPECT_EQ(deserialized.pdp_start_time, 112233);
+  EXPECT_EQ(deserialized.pdp_end_time, 332211);
+  EXPECT_EQ(deserialized.policy_version_and_stats["rule1"].stats_map[1].tx, 1);
+  EXPECT_EQ(
+      deserialized.policy_version_and_stats["rule2"].stats_map[2].dropped_rx,
+      40);
+}
+
 TEST_F(StoredStateTest, test_policy_stats_map) {
   PolicyStatsMap original;
   StatsPerPolicy og_stats1, og_stats2;
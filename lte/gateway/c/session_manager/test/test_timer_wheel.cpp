@@ -0,0 +1,93 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/io/async/EventBase.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "TimerWheel.h"
+
+namespace magma {
+
+class TimerWheelTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    // Small tick so the tests run quickly
+    wheel = std::make_unique<TimerWheel>(10, 8);
+    wheel->attach(&evb);
+  }
+
+  folly::EventBase evb;
+  std::unique_ptr<TimerWheel> wheel;
+};
+
+TEST_F(TimerWheelTest, test_timers_fire_in_order) {
+  std::vector<int> fired;
+  wheel->schedule([&] { fired.push_back(2); }, 50);
+  wheel->schedule([&] { fired.push_back(1); }, 20);
+  EXPECT_EQ(wheel->pending(), 2);
+
+  while (wheel->pending() > 0) {
+    evb.loopOnce();
+  }
+  ASSERT_EQ(fired.size(), 2);
+  EXPECT_EQ(fired[0], 1);
+  EXPECT_EQ(fired[1], 2);
+}
+
+TEST_F(TimerWheelTest, test_cancel) {
+  bool fired    = false;
+  auto timer_id = wheel->schedule([&] { fired = true; }, 20);
+  EXPECT_TRUE(wheel->cancel(timer_id));
+  EXPECT_EQ(wheel->pending(), 0);
+  // Double cancel is a no-op
+  EXPECT_FALSE(wheel->cancel(timer_id));
+
+  // Keep one live timer so the wheel keeps ticking past the cancelled
+  // timer's deadline
+  bool other_fired = false;
+  wheel->schedule([&] { other_fired = true; }, 50);
+  while (wheel->pending() > 0) {
+    evb.loopOnce();
+  }
+  EXPECT_FALSE(fired);
+  EXPECT_TRUE(other_fired);
+}
+
+TEST_F(TimerWheelTest, test_delay_longer_than_one_rotation) {
+  // 8 slots * 10ms tick = 80ms per rotation; this timer wraps the wheel
+  bool fired = false;
+  wheel->schedule([&] { fired = true; }, 120);
+  while (wheel->pending() > 0) {
+    evb.loopOnce();
+  }
+  EXPECT_TRUE(fired);
+}
+
+TEST_F(TimerWheelTest, test_callback_schedules_new_timer) {
+  bool second_fired = false;
+  wheel->schedule(
+      [&] { wheel->schedule([&] { second_fired = true; }, 10); }, 10);
+  while (wheel->pending() > 0) {
+    evb.loopOnce();
+  }
+  EXPECT_TRUE(second_fired);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+}  // namespace magma
@@ -72,7 +72,7 @@ TEST_F(SessionStateTest, test_remove_monitor) {
 
   // check last update will be sent
   UpdateSessionRequest update;
-  std::vector<std::unique_ptr<ServiceAction>> actions;
+  ServiceActionBatch actions;
   session_state->get_updates(&update, &actions, &update_criteria);
   EXPECT_EQ(actions.size(), 0);
   EXPECT_EQ(update.usage_monitors_size(), 1);
@@ -18,6 +18,7 @@ import grpc
 from google.protobuf.json_format import MessageToJson
 from lte.protos.mobilityd_pb2 import (
     AllocateIPAddressResponse,
+    AllocateIPBatchResponse,
     AllocateIPRequest,
     IPAddress,
     IPBlock,
@@ -55,6 +56,21 @@ from .subscriberdb_client import (
 )
 
 
+class _BatchItemContext:
+    """ Captures per-item status codes during batched allocation so a
+        failed entry does not fail the whole batch RPC """
+
+    def __init__(self):
+        self.code = None
+        self.details = ''
+
+    def set_code(self, code):
+        self.code = code
+
+    def set_details(self, details):
+        self.details = details
+
+
 class MobilityServiceRpcServicer(MobilityServiceServicer):
     """ gRPC based server for the IPAllocator. """
 
@@ -174,6 +190,33 @@ class MobilityServiceRpcServicer(MobilityServiceServicer):
         """ Allocate an IP address from the free IP pool """
         logging.debug("Received AllocateIPAddress")
         self._print_grpc(request)
+        resp = self._allocate_ip_address(request, context)
+        self._print_grpc(resp)
+        return resp
+
+    def AllocateIPAddressBatch(self, request, context):
+        """ Allocate IP addresses for a batch of subscribers in one RPC
+
+        Allocation failures are captured per entry so that one exhausted
+        or misconfigured subscriber does not fail the whole batch.
+        """
+        logging.debug("Received AllocateIPAddressBatch")
+        self._print_grpc(request)
+        resp = AllocateIPBatchResponse()
+        for alloc_request in request.requests:
+            item_context = _BatchItemContext()
+            ip_resp = self._allocate_ip_address(alloc_request, item_context)
+            result = resp.results.add()
+            if item_context.code is None:
+                result.success = True
+                result.response.CopyFrom(ip_resp)
+            else:
+                result.status_code = item_context.code.value[0]
+                result.error_details = item_context.details
+        self._print_grpc(resp)
+        return resp
+
+    def _allocate_ip_address(self, request, context):
         composite_sid = SIDUtils.to_str(request.sid)
         if request.apn:
             composite_sid = composite_sid + "." + request.apn
@@ -208,8 +251,6 @@ class MobilityServiceRpcServicer(MobilityServiceServicer):
             )
         else:
             resp = AllocateIPAddressResponse()
-
-        self._print_grpc(resp)
         return resp
 
     @return_void
@@ -19,6 +19,7 @@ from concurrent import futures
 
 import grpc
 from lte.protos.mobilityd_pb2 import (
+    AllocateIPBatchRequest,
     AllocateIPRequest,
     GWInfo,
     IPAddress,
@@ -221,6 +222,40 @@ class RpcTests(unittest.TestCase):
         ip2 = ipaddress.ip_address(ip_msg2.ip_list[0].address)
         self.assertTrue(ip2 in self._block)
 
+    def test_allocate_ip_address_batch(self):
+        """ test AllocateIPAddressBatch result ordering """
+        self._stub.AddIPBlock(self._block_msg)
+
+        batch_request = AllocateIPBatchRequest()
+        for sid in (self._sid0, self._sid1):
+            batch_request.requests.add(
+                sid=sid,
+                version=AllocateIPRequest.IPV4,
+                apn=self._apn0,
+            )
+        resp = self._stub.AllocateIPAddressBatch(batch_request)
+        self.assertEqual(len(resp.results), 2)
+
+        ips = set()
+        for result in resp.results:
+            self.assertTrue(result.success)
+            ip = ipaddress.ip_address(result.response.ip_list[0].address)
+            self.assertTrue(ip in self._block)
+            ips.add(ip)
+        self.assertEqual(len(ips), 2)
+
+        # allocated IPs must be retrievable per subscriber
+        lookup = IPLookupRequest(
+            sid=self._sid0,
+            apn=self._apn0,
+            version=IPAddress.IPV4,
+        )
+        ip_msg = self._stub.GetIPForSubscriber(lookup)
+        self.assertEqual(
+            ipaddress.ip_address(ip_msg.address),
+            ipaddress.ip_address(resp.results[0].response.ip_list[0].address),
+        )
+
     def test_multiple_apn_ipallocation(self):
         """ test AllocateIPAddress for multiple APNs """
         self._stub.AddIPBlock(self._block_msg)
@@ -83,6 +83,9 @@ class EnforcementStatsController(PolicyMixin, RestartMixin, MagmaController):
         self._msg_hub = MessageHub(self.logger)
         self.unhandled_stats_msgs = []  # Store multi-part responses from ovs
         self.total_usage = {}  # Store total usage
+        # Byte counters seen by the previous GetStats poll, used to answer
+        # changed_only polls with just the records that moved
+        self._last_poll_counters = {}
         self._clean_restart = kwargs['config']['clean_restart']
         self._redis_enabled = kwargs['config'].get('redis_enabled', False)
         self._unmatched_bytes = 0  # Store bytes matched by default rule if any
@@ -572,10 +575,14 @@ class EnforcementStatsController(PolicyMixin, RestartMixin, MagmaController):
                               rule_num, e)
             return ""
 
-    def get_stats(self, cookie: int = 0, cookie_mask: int = 0):
+    def get_stats(self, cookie: int = 0, cookie_mask: int = 0,
+                  changed_only: bool = False):
         """
-        Use Ryu API to send a stats request containing cookie and cookie mask, retrieve a response and 
+        Use Ryu API to send a stats request containing cookie and cookie mask, retrieve a response and
         convert to a Rule Record Table and remove old flows
+
+        When changed_only is set, only records whose byte counters moved
+        since the previous poll are returned
         """
         if not self._datapath:
             self.logger.error("Could not initialize datapath for stats retrieval")
@@ -591,6 +598,8 @@ class EnforcementStatsController(PolicyMixin, RestartMixin, MagmaController):
             else:
                 usage = self._get_usage_from_flow_stat(response.body)
                 self.loop.call_soon_threadsafe(self._delete_old_flows, usage.values())
+                if changed_only:
+                    usage = self._filter_changed_records(usage)
                 record_table = RuleRecordTable(
                     records=usage.values(),
                     epoch=global_epoch)
@@ -599,6 +608,23 @@ class EnforcementStatsController(PolicyMixin, RestartMixin, MagmaController):
             self.logger.error("Could not obtain rule records due to either InvalidDatapath, OFError or UnexpectedMultiReply")
             return RuleRecordTable()
 
+    def _filter_changed_records(self, usage):
+        """
+        Return only the records whose byte counters moved since the
+        previous poll, refreshing the counter cache as a side effect.
+        Entries for flows that disappeared drop out of the cache, so a
+        re-created flow is always reported again.
+        """
+        changed = {}
+        current_counters = {}
+        for key, record in usage.items():
+            counters = (record.bytes_tx, record.bytes_rx)
+            current_counters[key] = counters
+            if self._last_poll_counters.get(key) != counters:
+                changed[key] = record
+        self._last_poll_counters = current_counters
+        return changed
+
 def _generate_rule_match(imsi, ip_addr, rule_num, version, direction):
     """
     Return a MagmaMatch that matches on the rule num and the version.
@@ -16,6 +16,7 @@ from typing import NamedTuple, Optional
 
 from lte.protos.pipelined_pb2 import (
     CauseIE,
+    Fsm_state,
     OffendingIE,
     PdrState,
     UPFSessionContextState,
@@ -44,6 +45,11 @@ class SessionStateManager:
     send_message_offset = 0
     periodic_config_msg_count = 0
 
+    # Mirrored rule ledger per subscriber: {subscriber_id: {pdr_id: version}}.
+    # Tracks the (pdr_id, pdr_version) pairs applied so far so incremental
+    # SessionSet updates can be audited against the SMF state checksum.
+    _version_ledger = {}
+
     """
     This controller manages session state information
     and reports session config to SMF.
@@ -55,6 +61,36 @@ class SessionStateManager:
         self._loop = loop
         self.logger = logger
 
+    @staticmethod
+    def _ledger_checksum(ledger) -> int:
+        """
+        FNV-1a over the (pdr_id, pdr_version) pairs in pdr_id order.
+        Must stay identical to pdr_state_checksum in SessionStateEnforcer.
+        """
+        checksum = 14695981039346656037
+        for pdr_id in sorted(ledger):
+            word = (pdr_id << 32) | (ledger[pdr_id] & 0xFFFFFFFF)
+            for shift in range(0, 64, 8):
+                checksum ^= (word >> shift) & 0xFF
+                checksum = (checksum * 1099511628211) & 0xFFFFFFFFFFFFFFFF
+        return checksum
+
+    @classmethod
+    def _update_version_ledger(cls, new_session) -> int:
+        """
+        Fold the incoming update into the subscriber's rule ledger and
+        return the resulting checksum. A base_version of 0 means the
+        message carries the full rule set and replaces the ledger.
+        """
+        if new_session.base_version == 0:
+            ledger = {}
+        else:
+            ledger = cls._version_ledger.get(new_session.subscriber_id, {})
+        for pdr_entry in new_session.set_gr_pdr:
+            ledger[pdr_entry.pdr_id] = pdr_entry.pdr_version
+        cls._version_ledger[new_session.subscriber_id] = ledger
+        return cls._ledger_checksum(ledger)
+
     # Creating the dict entries for the far group
     @staticmethod
     def _pdr_create_rule_group(new_session, pdr_rules) -> Optional[MsgParseOutput]:
@@ -124,6 +160,22 @@ class SessionStateManager:
         if pdr_validator:
             context_response.failure_rule_id.pdr.extend([pdr_validator.offending_ie])
             context_response.cause_info.cause_ie = pdr_validator.cause_info
+            return context_response
+
+        # Audit the incremental sync: fold the update into the mirrored
+        # ledger and compare with the full-state checksum sent by SMF.
+        # On mismatch ask SMF for a full push rather than failing rules.
+        if new_session.state.state == Fsm_state.FsmState.Value('RELEASE'):
+            SessionStateManager._version_ledger.pop(new_session.subscriber_id, None)
+        else:
+            ledger_checksum = SessionStateManager._update_version_ledger(new_session)
+            if new_session.state_checksum and \
+                    new_session.state_checksum != ledger_checksum:
+                self.logger.error("State checksum mismatch for subscriber %s: "
+                                  "smf %d, upf ledger %d. Requesting full state",
+                                  new_session.subscriber_id,
+                                  new_session.state_checksum, ledger_checksum)
+                context_response.cause_info.cause_ie = CauseIE.STATE_CHECKSUM_MISMATCH
 
         return context_response
 
@@ -946,7 +946,8 @@ class PipelinedRpcServicer(pipelined_pb2_grpc.PipelinedServicer):
         return ret
 
     def get_stats(self, request, fut):
-        response = self._enforcement_stats.get_stats(request.cookie, request.cookie_mask)
+        response = self._enforcement_stats.get_stats(
+            request.cookie, request.cookie_mask, request.changed_only)
         fut.set_result(response)
 
     def GetStats(self, request, context):
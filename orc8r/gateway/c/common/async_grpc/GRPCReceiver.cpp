@@ -25,17 +25,43 @@ void GRPCReceiver::rpc_response_loop() {
     if (!queue_.Next(&tag, &ok)) {
       return;
     }
-    if (!ok) {
-      MLOG(MINFO) << "gRPC receiver encountered error while processing request";
-      continue;
+    // Drain every response that has already completed before blocking
+    // again, so subclasses see the run as one burst and can batch the
+    // downstream work it triggers
+    on_burst_begin();
+    while (true) {
+      if (ok) {
+        static_cast<AsyncResponse*>(tag)->handle_response();
+      } else {
+        MLOG(MINFO)
+            << "gRPC receiver encountered error while processing request";
+      }
+      auto next_status =
+          queue_.AsyncNext(&tag, &ok, std::chrono::system_clock::now());
+      if (next_status != grpc::CompletionQueue::GOT_EVENT) {
+        on_burst_end();
+        if (next_status == grpc::CompletionQueue::SHUTDOWN) {
+          return;
+        }
+        break;
+      }
     }
-    static_cast<AsyncResponse*>(tag)->handle_response();
+  }
+}
+
+void GRPCReceiver::start_response_threads(size_t num_threads) {
+  for (size_t i = 0; i < num_threads; i++) {
+    response_threads_.emplace_back([this]() { rpc_response_loop(); });
   }
 }
 
 void GRPCReceiver::stop() {
   running_ = false;
   queue_.Shutdown();
+  for (auto& thread : response_threads_) {
+    thread.join();
+  }
+  response_threads_.clear();
   // Pop all items in the queue until it is empty
   // https://github.com/grpc/grpc/issues/8610
   void* tag;
@@ -18,8 +18,13 @@
 #include <stdint.h>                                // for uint32_t
 #include <atomic>                                  // for atomic
 #include <chrono>                                  // for operator+, seconds
+#include <condition_variable>                      // for condition_variable
 #include <functional>                              // for function
 #include <memory>                                  // for unique_ptr
+#include <mutex>                                   // for mutex, unique_lock
+#include <thread>                                  // for thread
+#include <utility>                                 // for move
+#include <vector>                                  // for vector
 namespace grpc {
 template<class R>
 class ClientAsyncResponseReader;
@@ -35,20 +40,43 @@ namespace magma {
 class GRPCReceiver {
  public:
   /**
-   * Begin the receiver loop, blocks
+   * Begin the receiver loop, blocks.
+   * Safe to call from several threads at once: CompletionQueue::Next is
+   * thread safe and each completed tag is handed to exactly one poller.
+   * Callbacks must be thread safe when more than one poller runs.
    */
   void rpc_response_loop();
 
   /**
-   * Stop the receiver loop
+   * Spawn num_threads pollers draining the shared completion queue, for
+   * clients whose response handling is thread safe and heavy enough to
+   * saturate a single poller. The threads are joined by stop()
+   */
+  void start_response_threads(size_t num_threads);
+
+  /**
+   * Stop the receiver loop and join any threads started by
+   * start_response_threads
    */
   void stop();
 
  protected:
   grpc::CompletionQueue queue_;
 
+  /**
+   * Hooks bracketing each run of responses that completed while the poller
+   * was busy or asleep: on_burst_begin is called before the first response
+   * of the run is handled, on_burst_end once the queue is momentarily
+   * empty again. Subclasses can override the pair to batch downstream work
+   * triggered by a flood of responses. Both run on the poller thread; with
+   * several pollers each thread brackets its own runs. Defaults do nothing.
+   */
+  virtual void on_burst_begin() {}
+  virtual void on_burst_end() {}
+
  private:
   std::atomic<bool> running_;
+  std::vector<std::thread> response_threads_;
 };
 
 /**
@@ -138,4 +166,163 @@ class AsyncLocalResponse : public AsyncGRPCResponse<ResponseType> {
   }
 };
 
+/**
+ * AsyncPooledResponse behaves like AsyncLocalResponse but recycles the
+ * storage of completed tags through a per-response-type free list, so
+ * steady-state traffic performs no heap allocation for its completion
+ * queue tags. grpc::ClientContext is single use, so the object is
+ * re-constructed in place on every reuse.
+ * Usage mirrors AsyncLocalResponse, with Alloc in place of new:
+ * auto response = AsyncPooledResponse<YourRPCResponseValue>::Alloc(
+ *   callback, RESPONSE_TIMEOUT);
+ */
+template<typename ResponseType>
+class AsyncPooledResponse : public AsyncGRPCResponse<ResponseType> {
+ public:
+  static AsyncPooledResponse* Alloc(
+      std::function<void(grpc::Status, ResponseType)> callback,
+      uint32_t timeout_sec) {
+    void* storage = pool_pop();
+    if (storage == nullptr) {
+      storage = ::operator new(sizeof(AsyncPooledResponse));
+    }
+    return new (storage) AsyncPooledResponse(callback, timeout_sec);
+  }
+
+  void handle_response() {
+    this->callback_(this->status_, this->response_);
+    this->~AsyncPooledResponse();
+    pool_push(this);
+  }
+
+ private:
+  AsyncPooledResponse(
+      std::function<void(grpc::Status, ResponseType)> callback,
+      uint32_t timeout_sec)
+      : AsyncGRPCResponse<ResponseType>(callback, timeout_sec) {}
+
+  static void* pool_pop() {
+    std::unique_lock<std::mutex> lock(pool_mutex_);
+    if (pool_.empty()) {
+      return nullptr;
+    }
+    void* storage = pool_.back();
+    pool_.pop_back();
+    return storage;
+  }
+
+  static void pool_push(void* storage) {
+    {
+      std::unique_lock<std::mutex> lock(pool_mutex_);
+      if (pool_.size() < MAX_POOLED_RESPONSES) {
+        pool_.push_back(storage);
+        return;
+      }
+    }
+    ::operator delete(storage);
+  }
+
+  // bounds the memory a burst can leave parked in the free list
+  static const size_t MAX_POOLED_RESPONSES = 1024;
+  static std::mutex pool_mutex_;
+  static std::vector<void*> pool_;
+};
+
+template<typename ResponseType>
+std::mutex AsyncPooledResponse<ResponseType>::pool_mutex_;
+template<typename ResponseType>
+std::vector<void*> AsyncPooledResponse<ResponseType>::pool_;
+
+/**
+ * GRPCBatcher coalesces requests for a deadline-tolerant RPC. Requests
+ * are appended under a short lock and the accumulated batch is handed to
+ * flush_fn either when it reaches max_batch_size (on the enqueueing
+ * thread) or when the oldest request has waited max_delay (on the
+ * batcher's timer thread). Clients opt in by funneling their per-record
+ * updates through Enqueue and sending one bulk RPC from flush_fn.
+ */
+template<typename RequestType>
+class GRPCBatcher {
+ public:
+  GRPCBatcher(
+      std::function<void(std::vector<RequestType>)> flush_fn,
+      size_t max_batch_size, std::chrono::milliseconds max_delay)
+      : flush_fn_(flush_fn),
+        max_batch_size_(max_batch_size),
+        max_delay_(max_delay),
+        running_(true),
+        timer_thread_([this]() { timer_loop(); }) {}
+
+  ~GRPCBatcher() {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      running_ = false;
+    }
+    batch_ready_.notify_all();
+    timer_thread_.join();
+  }
+
+  /**
+   * Add one request to the pending batch, flushing inline when the batch
+   * is full
+   */
+  void Enqueue(RequestType request) {
+    std::vector<RequestType> ready;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (pending_.empty()) {
+        oldest_enqueue_ = std::chrono::steady_clock::now();
+        // wake the timer so it waits on the new deadline
+        batch_ready_.notify_one();
+      }
+      pending_.push_back(std::move(request));
+      if (pending_.size() >= max_batch_size_) {
+        ready.swap(pending_);
+      }
+    }
+    if (!ready.empty()) {
+      flush_fn_(std::move(ready));
+    }
+  }
+
+ private:
+  void timer_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+      if (pending_.empty()) {
+        batch_ready_.wait(lock);
+        continue;
+      }
+      batch_ready_.wait_until(lock, oldest_enqueue_ + max_delay_);
+      if (!pending_.empty() &&
+          (!running_ ||
+           std::chrono::steady_clock::now() >= oldest_enqueue_ + max_delay_)) {
+        flush_locked(lock);
+      }
+    }
+    // hand off whatever is still pending on shutdown
+    if (!pending_.empty()) {
+      flush_locked(lock);
+    }
+  }
+
+  void flush_locked(std::unique_lock<std::mutex>& lock) {
+    std::vector<RequestType> ready;
+    ready.swap(pending_);
+    lock.unlock();
+    flush_fn_(std::move(ready));
+    lock.lock();
+  }
+
+  std::function<void(std::vector<RequestType>)> flush_fn_;
+  size_t max_batch_size_;
+  std::chrono::milliseconds max_delay_;
+  bool running_;
+  std::mutex mutex_;
+  std::condition_variable batch_ready_;
+  std::vector<RequestType> pending_;
+  std::chrono::steady_clock::time_point oldest_enqueue_;
+  std::thread timer_thread_;
+};
+
 }  // namespace magma
@@ -0,0 +1,92 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>      // for atomic_load_explicit, atomic_store_explicit
+#include <functional>  // for function
+#include <memory>      // for shared_ptr, make_shared
+#include <mutex>       // for mutex, lock_guard
+#include <string>      // for string
+#include <utility>     // for move
+#include <vector>      // for vector
+#include "includes/MConfigLoader.h"  // for MConfigLoader
+
+namespace magma {
+
+/**
+ * ConfigSnapshot publishes the parsed mconfig of a service as an immutable
+ * snapshot behind an atomically swapped shared_ptr. The file is parsed once
+ * per Reload; readers do a single atomic load and then touch plain protobuf
+ * fields, so hot paths consulting feature flags never see parser state and
+ * a reload never pauses them. MconfigType is the service's message from
+ * mconfigs.proto (e.g. mconfig::SessionD).
+ */
+template<typename MconfigType>
+class ConfigSnapshot {
+ public:
+  explicit ConfigSnapshot(const std::string& service_name)
+      : service_name_(service_name),
+        snapshot_(std::make_shared<const MconfigType>()) {
+    Reload();
+  }
+
+  /**
+   * Returns the current snapshot; never nullptr. When the initial load
+   * failed this is a default-constructed message, so readers always see
+   * well-defined (default) values
+   */
+  std::shared_ptr<const MconfigType> Get() const {
+    return std::atomic_load_explicit(&snapshot_, std::memory_order_acquire);
+  }
+
+  /**
+   * Re-parse the mconfig and publish a fresh snapshot, invoking the
+   * registered change callbacks with it. On parse failure the previous
+   * snapshot stays published and callbacks are not invoked.
+   * @return true if a new snapshot was published
+   */
+  bool Reload() {
+    auto fresh = std::make_shared<MconfigType>();
+    MConfigLoader loader;
+    if (!loader.load_service_mconfig(service_name_, fresh.get())) {
+      return false;
+    }
+    std::shared_ptr<const MconfigType> published = std::move(fresh);
+    std::atomic_store_explicit(
+        &snapshot_, published, std::memory_order_release);
+    std::lock_guard<std::mutex> lock(callbacks_mutex_);
+    for (auto& callback : callbacks_) {
+      callback(published);
+    }
+    return true;
+  }
+
+  /**
+   * Register a callback invoked with every successfully published
+   * snapshot, from the thread that called Reload
+   */
+  void RegisterChangeCallback(
+      std::function<void(std::shared_ptr<const MconfigType>)> callback) {
+    std::lock_guard<std::mutex> lock(callbacks_mutex_);
+    callbacks_.push_back(std::move(callback));
+  }
+
+ private:
+  std::string service_name_;
+  std::shared_ptr<const MconfigType> snapshot_;
+  std::mutex callbacks_mutex_;
+  std::vector<std::function<void(std::shared_ptr<const MconfigType>)>>
+      callbacks_;
+};
+
+}  // namespace magma
@@ -13,8 +13,15 @@
 #include "includes/EventdClient.h"
 #include <grpcpp/channel.h>                        // for Channel
 #include <grpcpp/impl/codegen/async_unary_call.h>  // for default_delete
+#include <sys/stat.h>                              // for stat
+#include <chrono>                                  // for milliseconds
+#include <cstdio>                                  // for remove
+#include <fstream>                                 // for ifstream, ofstream
+#include <string>                                  // for string
 #include <utility>                                 // for move
+#include <vector>                                  // for vector
 #include "includes/ServiceRegistrySingleton.h"     // for ServiceRegistrySin...
+#include "magma_logging.h"                         // for MLOG
 #include "orc8r/protos/common.pb.h"                // for Void
 #include "orc8r/protos/eventd.grpc.pb.h"           // for EventService::Stub
 namespace grpc {
@@ -23,18 +30,29 @@ class ClientContext;
 namespace grpc {
 class Status;
 }
-namespace magma {
-namespace orc8r {
-class Event;
-}
-}  // namespace magma
+
+namespace {
+// Coalesce events for up to half a second or 64 events per class
+constexpr size_t EVENT_BATCH_MAX_SIZE = 64;
+constexpr std::chrono::milliseconds EVENT_BATCH_MAX_DELAY(500);
+// Drop-eligible events are shed beyond this pending backlog
+constexpr size_t MAX_PENDING_DROP_ELIGIBLE = 4096;
+// Failed must-deliver batches are parked here until delivery recovers
+constexpr char EVENT_SPOOL_PATH[]     = "/var/opt/magma/eventd_spool.dat";
+constexpr size_t EVENT_SPOOL_MAX_BYTES = 8 * 1024 * 1024;
+}  // namespace
 
 namespace magma {
 
 using orc8r::Event;
+using orc8r::EventList;
 using orc8r::EventService;
 using orc8r::Void;
 
+void EventdClient::log_event_with_qos(const Event& request, EventQoS) {
+  log_event(request, [](Status status, Void v) {});
+}
+
 AsyncEventdClient& AsyncEventdClient::getInstance() {
   static AsyncEventdClient instance;
   return instance;
@@ -45,6 +63,25 @@ AsyncEventdClient::AsyncEventdClient() {
   channel = ServiceRegistrySingleton::Instance()->GetGrpcChannel(
       "eventd", ServiceRegistrySingleton::LOCAL);
   stub_ = EventService::NewStub(channel);
+  drop_eligible_batcher_.reset(new GRPCBatcher<Event>(
+      [this](std::vector<Event> events) {
+        drop_eligible_pending_.fetch_sub(events.size());
+        EventList batch;
+        for (auto& event : events) {
+          batch.add_events()->Swap(&event);
+        }
+        log_event_list(std::move(batch), false);
+      },
+      EVENT_BATCH_MAX_SIZE, EVENT_BATCH_MAX_DELAY));
+  must_deliver_batcher_.reset(new GRPCBatcher<Event>(
+      [this](std::vector<Event> events) {
+        EventList batch;
+        for (auto& event : events) {
+          batch.add_events()->Swap(&event);
+        }
+        log_event_list(std::move(batch), true);
+      },
+      EVENT_BATCH_MAX_SIZE, EVENT_BATCH_MAX_DELAY));
 }
 
 void AsyncEventdClient::log_event(
@@ -55,4 +92,89 @@ void AsyncEventdClient::log_event(
       stub_->AsyncLogEvent(local_response->get_context(), request, &queue_)));
 }
 
+void AsyncEventdClient::log_event_with_qos(const Event& request, EventQoS qos) {
+  if (qos == EVENT_QOS_MUST_DELIVER) {
+    must_deliver_batcher_->Enqueue(request);
+    return;
+  }
+  if (drop_eligible_pending_.fetch_add(1) >= MAX_PENDING_DROP_ELIGIBLE) {
+    drop_eligible_pending_.fetch_sub(1);
+    uint64_t dropped = ++dropped_events_;
+    if ((dropped % 1000) == 1) {
+      MLOG(MWARNING) << "eventd backlog full, dropped " << dropped
+                     << " drop-eligible events so far";
+    }
+    return;
+  }
+  drop_eligible_batcher_->Enqueue(request);
+}
+
+void AsyncEventdClient::log_event_list(EventList batch, bool must_deliver) {
+  auto local_response = new AsyncLocalResponse<Void>(
+      [this, batch, must_deliver](Status status, Void v) {
+        if (status.ok()) {
+          if (must_deliver) {
+            spool_replay();
+          }
+          return;
+        }
+        MLOG(MERROR) << "Could not log batch of " << batch.events_size()
+                     << " events, Error Message: " << status.error_message();
+        if (must_deliver) {
+          spool_append(batch);
+        }
+      },
+      RESPONSE_TIMEOUT_SEC);
+  local_response->set_response_reader(std::move(
+      stub_->AsyncLogEvents(local_response->get_context(), batch, &queue_)));
+}
+
+void AsyncEventdClient::spool_append(const EventList& batch) {
+  std::lock_guard<std::mutex> lock(spool_mutex_);
+  std::string payload;
+  if (!batch.SerializeToString(&payload)) {
+    return;
+  }
+  struct stat st;
+  size_t current_size = (stat(EVENT_SPOOL_PATH, &st) == 0) ? st.st_size : 0;
+  if (current_size + sizeof(uint32_t) + payload.size() >
+      EVENT_SPOOL_MAX_BYTES) {
+    MLOG(MWARNING) << "eventd spool full, dropping batch of "
+                   << batch.events_size() << " must-deliver events";
+    return;
+  }
+  std::ofstream out(EVENT_SPOOL_PATH, std::ios::binary | std::ios::app);
+  uint32_t length = payload.size();
+  out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+  out.write(payload.data(), payload.size());
+}
+
+void AsyncEventdClient::spool_replay() {
+  std::vector<EventList> batches;
+  {
+    std::lock_guard<std::mutex> lock(spool_mutex_);
+    std::ifstream in(EVENT_SPOOL_PATH, std::ios::binary);
+    if (!in) {
+      return;
+    }
+    uint32_t length;
+    while (in.read(reinterpret_cast<char*>(&length), sizeof(length))) {
+      std::string payload(length, '\0');
+      if (!in.read(&payload[0], length)) {
+        break;
+      }
+      EventList batch;
+      if (batch.ParseFromString(payload)) {
+        batches.push_back(std::move(batch));
+      }
+    }
+    in.close();
+    std::remove(EVENT_SPOOL_PATH);
+  }
+  // Failed replays are re-spooled by their completion callbacks
+  for (auto& batch : batches) {
+    log_event_list(std::move(batch), true);
+  }
+}
+
 }  // namespace magma
@@ -13,10 +13,12 @@
 #pragma once
 
 #include <orc8r/protos/eventd.grpc.pb.h>  // for EventService::Stub, EventSe...
-#include <stdint.h>                       // for uint32_t
+#include <stdint.h>                       // for uint32_t, uint64_t
+#include <atomic>                         // for atomic
 #include <functional>                     // for function
 #include <memory>                         // for unique_ptr
-#include "includes/GRPCReceiver.h"        // for GRPCReceiver
+#include <mutex>                          // for mutex
+#include "includes/GRPCReceiver.h"        // for GRPCReceiver, GRPCBatcher
 namespace grpc {
 class Status;
 }
@@ -30,11 +32,26 @@ namespace orc8r {
 class Void;
 }
 }  // namespace magma
+namespace magma {
+namespace orc8r {
+class EventList;
+}
+}  // namespace magma
 
 using grpc::Status;
 
 namespace magma {
 
+/**
+ * Delivery class of an event. Drop-eligible events are shed when the
+ * pending backlog grows, must-deliver events (billing relevant) are
+ * spooled to disk when delivery fails and replayed later.
+ */
+enum EventQoS {
+  EVENT_QOS_DROP_ELIGIBLE = 0,
+  EVENT_QOS_MUST_DELIVER  = 1,
+};
+
 /**
  * Base class for interfacing with EventD
  */
@@ -44,6 +61,13 @@ class EventdClient {
   virtual void log_event(
       const orc8r::Event& request,
       std::function<void(Status status, orc8r::Void)> callback) = 0;
+
+  /**
+   * Log an event with a delivery class. The default implementation
+   * forwards to log_event; AsyncEventdClient coalesces events per class
+   * into LogEvents batches instead of issuing one RPC each
+   */
+  virtual void log_event_with_qos(const orc8r::Event& request, EventQoS qos);
 };
 
 /**
@@ -61,10 +85,26 @@ class AsyncEventdClient : public GRPCReceiver, public EventdClient {
       const orc8r::Event& request,
       std::function<void(Status status, orc8r::Void)> callback);
 
+  void log_event_with_qos(
+      const orc8r::Event& request, EventQoS qos) override;
+
  private:
   AsyncEventdClient();
+  // issue one LogEvents call; failed must-deliver batches are spooled
+  void log_event_list(orc8r::EventList batch, bool must_deliver);
+  // append a failed must-deliver batch to the bounded on-disk spool
+  void spool_append(const orc8r::EventList& batch);
+  // resend spooled batches once delivery works again
+  void spool_replay();
+
   static const uint32_t RESPONSE_TIMEOUT_SEC = 6;
   std::unique_ptr<orc8r::EventService::Stub> stub_{};
+  // one batching interval per delivery class
+  std::unique_ptr<GRPCBatcher<orc8r::Event>> drop_eligible_batcher_;
+  std::unique_ptr<GRPCBatcher<orc8r::Event>> must_deliver_batcher_;
+  std::atomic<size_t> drop_eligible_pending_{0};
+  std::atomic<uint64_t> dropped_events_{0};
+  std::mutex spool_mutex_;
 };
 
 }  // namespace magma
@@ -0,0 +1,55 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+// Stable USDT tracepoints under the "magma" provider, so bpftrace/perf
+// scripts in production can attach by name instead of function offsets
+// that break on every release:
+//
+//   bpftrace -e 'usdt:/usr/local/bin/sessiond:magma:session_store_commit
+//                { @lat[arg0] = count(); }'
+//
+// Each probe compiles to a single nop when systemtap-sdt-dev is installed
+// at build time and to nothing at all when it is not, so no runtime or
+// build dependency is added.
+
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define MAGMA_HAVE_SDT 1
+#endif
+#endif
+
+#ifdef MAGMA_HAVE_SDT
+#define MAGMA_USDT1(name, a1) DTRACE_PROBE1(magma, name, a1)
+#define MAGMA_USDT2(name, a1, a2) DTRACE_PROBE2(magma, name, a1, a2)
+#define MAGMA_USDT3(name, a1, a2, a3) DTRACE_PROBE3(magma, name, a1, a2, a3)
+#else
+#define MAGMA_USDT1(name, a1)
+#define MAGMA_USDT2(name, a1, a2)
+#define MAGMA_USDT3(name, a1, a2, a3)
+#endif
+
+// FNV-1a over the IMSI string: probes carry this hash instead of the IMSI
+// itself so trace output can correlate a subscriber across probes without
+// writing the identifier into trace buffers
+static inline unsigned long long magma_sdt_imsi_hash(const char* imsi) {
+  unsigned long long h = 14695981039346656037ULL;
+
+  if (imsi) {
+    while (*imsi) {
+      h = (h ^ (unsigned char) *imsi++) * 1099511628211ULL;
+    }
+  }
+  return h;
+}
@@ -12,6 +12,7 @@
  */
 
 #include "includes/MagmaService.h"
+#include <google/protobuf/arena.h>                 // for Arena
 #include <google/protobuf/map.h>                   // for Map
 #include <grpcpp/impl/codegen/completion_queue.h>  // for ServerCompletionQueue
 #include <grpcpp/security/server_credentials.h>    // for InsecureServerCred...
@@ -54,6 +55,9 @@ using magma::service303::MagmaService;
 using magma::service303::MetricsSingleton;
 using namespace std::chrono;
 
+// Flush a GetMetricsStream chunk once it holds roughly this many bytes
+static constexpr size_t METRICS_STREAM_CHUNK_BYTES = 512 * 1024;
+
 MagmaService::MagmaService(const std::string& name, const std::string& version)
     : name_(name),
       version_(version),
@@ -149,7 +153,10 @@ Status MagmaService::GetMetrics(
   // Set all common metrics
   setSharedMetrics();
 
-  MetricsSingleton& instance                 = MetricsSingleton::Instance();
+  MetricsSingleton& instance = MetricsSingleton::Instance();
+  // Fold fast-handle counter shards into the prometheus counters before
+  // collecting
+  instance.FlushFastCounters();
   const std::vector<MetricFamily>& collected = instance.registry_->Collect();
   for (auto it = collected.begin(); it != collected.end(); it++) {
     MetricFamily* family = response->add_family();
@@ -158,6 +165,41 @@ Status MagmaService::GetMetrics(
   return Status::OK;
 }
 
+Status MagmaService::GetMetricsStream(
+    __attribute__((unused)) ServerContext* context,
+    __attribute__((unused)) const Void* request,
+    grpc::ServerWriter<MetricsContainer>* writer) {
+  // Set all common metrics
+  setSharedMetrics();
+
+  MetricsSingleton& instance = MetricsSingleton::Instance();
+  instance.FlushFastCounters();
+  const std::vector<MetricFamily>& collected = instance.registry_->Collect();
+
+  // One arena-backed chunk is reused for the whole stream: Clear() keeps
+  // the arena blocks alive, so the scrape allocates at most one chunk of
+  // proto memory instead of the full container
+  google::protobuf::Arena arena;
+  MetricsContainer* chunk =
+      google::protobuf::Arena::CreateMessage<MetricsContainer>(&arena);
+  size_t chunk_bytes = 0;
+  for (auto it = collected.begin(); it != collected.end(); it++) {
+    chunk->add_family()->CopyFrom(*it);
+    chunk_bytes += it->ByteSizeLong();
+    if (chunk_bytes >= METRICS_STREAM_CHUNK_BYTES) {
+      if (!writer->Write(*chunk)) {
+        return Status(grpc::StatusCode::ABORTED, "metrics stream closed");
+      }
+      chunk->Clear();
+      chunk_bytes = 0;
+    }
+  }
+  if ((chunk->family_size() > 0) && !writer->Write(*chunk)) {
+    return Status(grpc::StatusCode::ABORTED, "metrics stream closed");
+  }
+  return Status::OK;
+}
+
 Status MagmaService::SetLogLevel(
     __attribute__((unused)) ServerContext* context,
     const LogLevelMessage* request, __attribute__((unused)) Void* response) {
@@ -233,7 +275,8 @@ void MagmaService::setMetricsUptime() {
 
 void MagmaService::setMemoryUsage() {
   va_list ap;
-  const ProcFileUtils::memory_info_t mem_info = ProcFileUtils::getMemoryInfo();
+  const ProcFileUtils::memory_info_t mem_info =
+      ProcFileUtils::getCachedMemoryInfo();
   MetricsSingleton::Instance().SetGauge(
       "process_virtual_memory_bytes", mem_info.virtual_mem, 0, ap);
   MetricsSingleton::Instance().SetGauge(
@@ -33,6 +33,36 @@ void increment_counter(
   va_end(ap);
 }
 
+size_t get_counter_handle(const char* name, size_t n_labels, ...) {
+  va_list ap;
+  va_start(ap, n_labels);
+  size_t handle =
+      MetricsSingleton::Instance().GetFastCounterHandle(name, n_labels, ap);
+  va_end(ap);
+  return handle;
+}
+
+void increment_counter_handle(size_t handle, double increment) {
+  MetricsSingleton::Instance().IncrementFastCounter(handle, increment);
+}
+
+void* get_counter_series(const char* name, size_t n_labels, ...) {
+  va_list ap;
+  va_start(ap, n_labels);
+  void* series =
+      MetricsSingleton::Instance().ResolveCounterSeries(name, n_labels, ap);
+  va_end(ap);
+  return series;
+}
+
+uint64_t get_counter_series_epoch(void) {
+  return MetricsSingleton::Instance().GetCounterEpoch();
+}
+
+void increment_counter_series(void* series, double increment) {
+  MetricsSingleton::Instance().IncrementCounterSeries(series, increment);
+}
+
 void remove_gauge(const char* name, size_t n_labels, ...) {
   va_list ap;
   va_start(ap, n_labels);
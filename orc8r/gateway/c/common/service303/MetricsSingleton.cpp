@@ -12,6 +12,10 @@
  */
 
 #include "includes/MetricsSingleton.h"
+#include <pthread.h>            // for pthread_self
+#include <sched.h>              // for sched_getcpu
+#include <cassert>              // for assert
+#include <thread>               // for thread::hardware_concurrency
 #include <vector>               // for vector
 #include "counter.h"            // for Counter
 #include "counter_builder.h"    // for BuildCounter, CounterBuilder
@@ -45,7 +49,16 @@ MetricsSingleton::MetricsSingleton()
     : registry_(std::make_shared<Registry>()),
       counters_(registry_, BuildCounter),
       gauges_(registry_, BuildGauge),
-      histograms_(registry_, BuildHistogram) {}
+      histograms_(registry_, BuildHistogram) {
+  // Round the core count up to a power of two so the shard of a core is a
+  // single mask away
+  unsigned int cores = std::thread::hardware_concurrency();
+  size_t shards      = 1;
+  while (shards < cores) {
+    shards <<= 1;
+  }
+  fast_counter_shard_mask_ = shards - 1;
+}
 
 void MetricsSingleton::args_to_map(
     std::map<std::string, std::string>& labels, size_t label_count,
@@ -60,6 +73,23 @@ void MetricsSingleton::RemoveCounter(
   std::map<std::string, std::string> labels;
   args_to_map(labels, label_count, args);
   counters_.Remove(name, labels);
+  // Series pointers resolved before this removal may dangle now
+  counter_epoch_.fetch_add(1, std::memory_order_release);
+}
+
+void* MetricsSingleton::ResolveCounterSeries(
+    const char* name, size_t label_count, va_list& args) {
+  std::map<std::string, std::string> labels;
+  args_to_map(labels, label_count, args);
+  return &counters_.Get(name, labels);
+}
+
+uint64_t MetricsSingleton::GetCounterEpoch() {
+  return counter_epoch_.load(std::memory_order_acquire);
+}
+
+void MetricsSingleton::IncrementCounterSeries(void* series, double increment) {
+  static_cast<Counter*>(series)->Increment(increment);
 }
 
 void MetricsSingleton::IncrementCounter(
@@ -69,6 +99,63 @@ void MetricsSingleton::IncrementCounter(
   counters_.Get(name, labels).Increment(increment);
 }
 
+size_t MetricsSingleton::GetFastCounterHandle(
+    const char* name, size_t label_count, va_list& args) {
+  std::map<std::string, std::string> labels;
+  args_to_map(labels, label_count, args);
+  std::lock_guard<std::mutex> lock(fast_counters_mutex_);
+  Counter* counter = &counters_.Get(name, labels);
+  // Resolving an already registered timeseries returns its handle
+  size_t size = fast_counters_size_.load(std::memory_order_acquire);
+  for (size_t i = 0; i < size; i++) {
+    if (fast_counters_[i]->counter == counter) {
+      return i;
+    }
+  }
+  assert(size < MAX_FAST_COUNTERS);
+  std::unique_ptr<FastCounter> fast(new FastCounter());
+  fast->counter = counter;
+  fast->shards.reset(new FastCounterShard[fast_counter_shard_mask_ + 1]);
+  fast->flushed        = 0;
+  fast_counters_[size] = std::move(fast);
+  // Publish the entry before making its handle visible to incrementers
+  fast_counters_size_.store(size + 1, std::memory_order_release);
+  return size;
+}
+
+void MetricsSingleton::IncrementFastCounter(size_t handle, double increment) {
+  if (handle >= fast_counters_size_.load(std::memory_order_acquire)) {
+    return;
+  }
+  FastCounter* fast = fast_counters_[handle].get();
+  int cpu           = sched_getcpu();
+  size_t shard      = (cpu >= 0 ? (size_t) cpu : (size_t) pthread_self()) &
+                 fast_counter_shard_mask_;
+  std::atomic<double>& value = fast->shards[shard].value;
+  double current             = value.load(std::memory_order_relaxed);
+  while (!value.compare_exchange_weak(
+      current, current + increment, std::memory_order_relaxed)) {
+  }
+}
+
+void MetricsSingleton::FlushFastCounters() {
+  std::lock_guard<std::mutex> lock(fast_counters_mutex_);
+  size_t size = fast_counters_size_.load(std::memory_order_acquire);
+  for (size_t i = 0; i < size; i++) {
+    FastCounter* fast = fast_counters_[i].get();
+    double total      = 0;
+    for (size_t s = 0; s <= fast_counter_shard_mask_; s++) {
+      total += fast->shards[s].value.load(std::memory_order_relaxed);
+    }
+    // Prometheus counters are monotonic: fold in only the growth since the
+    // previous flush
+    if (total > fast->flushed) {
+      fast->counter->Increment(total - fast->flushed);
+      fast->flushed = total;
+    }
+  }
+}
+
 void MetricsSingleton::RemoveGauge(
     const char* name, size_t label_count, va_list& args) {
   std::map<std::string, std::string> labels;
@@ -13,8 +13,12 @@
  */
 
 #include "ProcFileUtils.h"
+#include <pthread.h>
+#include <sched.h>
+#include <chrono>   // for seconds
 #include <fstream>  // for basic_istream, ifstream
 #include <string>   // for string, operator>>, stod
+#include <thread>   // for thread, sleep_for
 
 namespace magma {
 namespace service303 {
@@ -23,6 +27,11 @@ const std::string ProcFileUtils::STATUS_FILE         = "/proc/self/status";
 const std::string ProcFileUtils::VIRTUAL_MEM_PREFIX  = "VmSize:";
 const std::string ProcFileUtils::PHYSICAL_MEM_PREFIX = "VmRSS:";
 
+const int ProcFileUtils::SAMPLING_INTERVAL_SEC = 5;
+std::once_flag ProcFileUtils::sampler_started_;
+std::atomic<double> ProcFileUtils::sampled_physical_mem_(-1);
+std::atomic<double> ProcFileUtils::sampled_virtual_mem_(-1);
+
 double ProcFileUtils::parseForPrefix(
     std::ifstream& infile, const std::string& to_compare,
     const std::string& prefix_name) {
@@ -62,5 +71,35 @@ const ProcFileUtils::memory_info_t ProcFileUtils::getMemoryInfo() {
   return info;
 }
 
+const ProcFileUtils::memory_info_t ProcFileUtils::getCachedMemoryInfo() {
+  std::call_once(sampler_started_, [] {
+    std::thread sampler([] { samplingLoop(); });
+    sampler.detach();
+  });
+
+  ProcFileUtils::memory_info_t info;
+  info.physical_mem = sampled_physical_mem_.load(std::memory_order_relaxed);
+  info.virtual_mem  = sampled_virtual_mem_.load(std::memory_order_relaxed);
+  if (info.physical_mem < 0 && info.virtual_mem < 0) {
+    // The first scrape can beat the first sample; take the direct read once
+    info = getMemoryInfo();
+  }
+  return info;
+}
+
+void ProcFileUtils::samplingLoop() {
+  // Under memory pressure /proc reads can block for seconds; this thread
+  // takes that hit at idle scheduling priority so scrapes never do
+  struct sched_param param = {};
+  pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+
+  while (true) {
+    ProcFileUtils::memory_info_t info = getMemoryInfo();
+    sampled_physical_mem_.store(info.physical_mem, std::memory_order_relaxed);
+    sampled_virtual_mem_.store(info.virtual_mem, std::memory_order_relaxed);
+    std::this_thread::sleep_for(std::chrono::seconds(SAMPLING_INTERVAL_SEC));
+  }
+}
+
 }  // namespace service303
 }  // namespace magma
@@ -12,7 +12,9 @@
  */
 #pragma once
 
+#include <atomic>  // for atomic
 #include <iosfwd>  // for ifstream
+#include <mutex>   // for once_flag
 #include <string>  // for stringnamespace magma {
 
 namespace magma {
@@ -39,6 +41,22 @@ class ProcFileUtils final {
    */
   static const memory_info_t getMemoryInfo();
 
+  /*
+   * Returns the most recent sample taken by the background sampling thread,
+   * starting that thread on first use. Never touches /proc on the calling
+   * thread, so metrics scrapes cannot stall on filesystem reads
+   *
+   * @return memory_info_t containing the last sampled memory usage
+   */
+  static const memory_info_t getCachedMemoryInfo();
+
+ private:
+  /*
+   * Body of the sampling thread: re-reads /proc at a fixed cadence into
+   * the atomics served by getCachedMemoryInfo
+   */
+  static void samplingLoop();
+
  private:
   /*
    * Helper function to read from the proc file stream and output the value if
@@ -56,6 +74,11 @@ class ProcFileUtils final {
   // status file labels
   static const std::string VIRTUAL_MEM_PREFIX;
   static const std::string PHYSICAL_MEM_PREFIX;
+
+  static const int SAMPLING_INTERVAL_SEC;
+  static std::once_flag sampler_started_;
+  static std::atomic<double> sampled_physical_mem_;
+  static std::atomic<double> sampled_virtual_mem_;
 };
 
 }  // namespace service303
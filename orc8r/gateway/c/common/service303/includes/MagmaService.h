@@ -174,6 +174,20 @@ class MagmaService final : public Service303::Service {
       ServerContext* context, const Void* request,
       MetricsContainer* response) override;
 
+  /*
+   * Streams the collected timeseries in bounded chunks, reusing one
+   * arena-backed chunk message, so scrape memory stays flat on
+   * metric-heavy services
+   *
+   * @param context: the grpc Server context
+   * @param request: void request param
+   * @param writer (out): stream of MetricsContainer chunks
+   * @return grpc Status instance
+   */
+  Status GetMetricsStream(
+      ServerContext* context, const Void* request,
+      grpc::ServerWriter<MetricsContainer>* writer) override;
+
   /*
    * Sets the log verbosity to print to syslog at runtime
    *
@@ -13,7 +13,8 @@
 
 #pragma once
 
-#include <stdio.h>  // for size_t
+#include <stdint.h>  // for uint64_t
+#include <stdio.h>   // for size_t
 
 namespace magma {
 namespace service303 {
@@ -36,6 +37,52 @@ void remove_counter(const char* name, size_t n_labels, ...);
 void increment_counter(
     const char* name, double increment, size_t n_labels, ...);
 
+/**
+ * Resolve a Counter metric to a stable handle usable with
+ * increment_counter_handle
+ * @param name
+ * @param n_labels number of labels
+ * @param ... label args (name, value)
+ * @return handle of the resolved timeseries
+ */
+size_t get_counter_handle(const char* name, size_t n_labels, ...);
+
+/**
+ * Increments a Counter previously resolved with get_counter_handle; the
+ * increment lands in a per-core atomic shard and is folded into the
+ * prometheus counter at scrape time, so this is safe on hot paths
+ * @param handle handle returned by get_counter_handle
+ * @param increment value to increment
+ */
+void increment_counter_handle(size_t handle, double increment);
+
+/**
+ * Resolve a Counter metric to an opaque series pointer usable with
+ * increment_counter_series. Unlike the fixed-capacity fast-handle API this
+ * suits short-lived per-session timeseries, but the pointer is only valid
+ * while no counter has been removed: capture get_counter_series_epoch() at
+ * resolution and re-resolve whenever the epoch has moved
+ * @param name
+ * @param n_labels number of labels
+ * @param ... label args (name, value)
+ * @return opaque pointer to the resolved timeseries
+ */
+void* get_counter_series(const char* name, size_t n_labels, ...);
+
+/**
+ * Epoch incremented by every counter removal; a series pointer resolved
+ * under an older epoch may dangle and must be re-resolved
+ */
+uint64_t get_counter_series_epoch(void);
+
+/**
+ * Increments a Counter previously resolved with get_counter_series without
+ * any label handling or lookup
+ * @param series pointer returned by get_counter_series
+ * @param increment value to increment
+ */
+void increment_counter_series(void* series, double increment);
+
 /**
  * Remove the gauge metric that matches name+labels given
  * @param name
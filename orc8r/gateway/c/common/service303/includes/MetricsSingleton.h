@@ -14,8 +14,11 @@
 
 #include <stdarg.h>           // for va_list
 #include <stddef.h>           // for size_t
+#include <stdint.h>           // for uint64_t
+#include <atomic>             // for atomic
 #include <map>                // for map
 #include <memory>             // for shared_ptr
+#include <mutex>              // for mutex
 #include <string>             // for string
 #include "MetricsRegistry.h"  // for MetricsRegistry, Registry
 namespace grpc {
@@ -89,6 +92,22 @@ class MetricsSingleton {
   void ObserveHistogram(
       const char* name, double observation, size_t label_count, va_list& args);
   double GetGauge(const char* name, size_t label_count, va_list& args);
+  // Fast-handle counter API: GetFastCounterHandle resolves a timeseries to
+  // a stable handle once, IncrementFastCounter then adds to a per-core
+  // shard with relaxed atomics and never builds label maps or hashes
+  // strings. FlushFastCounters folds the shard totals into the backing
+  // prometheus counters and runs at scrape time (MagmaService::GetMetrics).
+  size_t GetFastCounterHandle(
+      const char* name, size_t label_count, va_list& args);
+  void IncrementFastCounter(size_t handle, double increment);
+  void FlushFastCounters();
+  // Series-pointer counter API for short-lived timeseries (one per
+  // session): ResolveCounterSeries hands out the prometheus counter as an
+  // opaque pointer, valid until any RemoveCounter bumps the epoch
+  void* ResolveCounterSeries(
+      const char* name, size_t label_count, va_list& args);
+  uint64_t GetCounterEpoch();
+  void IncrementCounterSeries(void* series, double increment);
 
  private:
   MetricsSingleton();                         // Prevent construction
@@ -103,6 +122,27 @@ class MetricsSingleton {
   MetricsRegistry<Counter, CounterBuilder (&)()> counters_;
   MetricsRegistry<Gauge, GaugeBuilder (&)()> gauges_;
   MetricsRegistry<Histogram, HistogramBuilder (&)()> histograms_;
+  // One cache line per shard so concurrent increments from different cores
+  // never share a line
+  struct alignas(64) FastCounterShard {
+    std::atomic<double> value{0.0};
+  };
+  // A resolved counter timeseries, its per-core shards and the portion of
+  // the shard total already folded into the prometheus counter
+  struct FastCounter {
+    Counter* counter;
+    std::unique_ptr<FastCounterShard[]> shards;
+    double flushed;
+  };
+  static const size_t MAX_FAST_COUNTERS = 1024;
+  // Fixed-capacity handle table: entries are published by bumping
+  // fast_counters_size_, so increments never race a reallocation
+  std::unique_ptr<FastCounter> fast_counters_[MAX_FAST_COUNTERS];
+  std::atomic<size_t> fast_counters_size_{0};
+  // Bumped by RemoveCounter so series pointers can be validated cheaply
+  std::atomic<uint64_t> counter_epoch_{0};
+  size_t fast_counter_shard_mask_;
+  std::mutex fast_counters_mutex_;  // guards registration and flushing
   static MetricsSingleton* instance_;
 };
 
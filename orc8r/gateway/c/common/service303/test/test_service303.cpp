@@ -83,6 +83,32 @@ class Service303Client {
     return 0;
   }
 
+  /**
+   * Reassembles the chunked metrics stream into one container
+   *
+   * @param response: the MetricsContainer instance to populate
+   * @return 0 on success, -1 on failure
+   */
+  int GetMetricsStream(MetricsContainer* response) {
+    ClientContext context;
+    Void request;
+    std::unique_ptr<grpc::ClientReader<MetricsContainer>> reader(
+        stub_->GetMetricsStream(&context, request));
+    MetricsContainer chunk;
+    while (reader->Read(&chunk)) {
+      for (auto const& fam : chunk.family()) {
+        response->add_family()->CopyFrom(fam);
+      }
+    }
+    Status status = reader->Finish();
+    if (!status.ok()) {
+      std::cout << "GetMetricsStream fails with code " << status.error_code()
+                << ", msg: " << status.error_message() << std::endl;
+      return -1;
+    }
+    return 0;
+  }
+
  private:
   std::shared_ptr<Service303::Stub> stub_;
 };
@@ -162,6 +188,48 @@ TEST_F(Service303Test, test_counters) {
   EXPECT_EQ(counter.value(), 3);
 }
 
+// Tests that the chunked metrics stream carries the same timeseries as the
+// one-shot GetMetrics.
+TEST_F(Service303Test, test_metrics_stream) {
+  service303::increment_counter("test_stream_counter", 7, NO_LABELS);
+  MetricsContainer metrics_container;
+  EXPECT_EQ(0, service303_client->GetMetricsStream(&metrics_container));
+  const MetricFamily& family =
+      Service303Test::findFamily(metrics_container, "test_stream_counter");
+  EXPECT_EQ(family.metric().Get(0).counter().value(), 7);
+}
+
+// Tests that counters incremented through fast handles aggregate into the
+// same prometheus timeseries at scrape time.
+TEST_F(Service303Test, test_fast_counter_handles) {
+  size_t handle =
+      service303::get_counter_handle("test_fast_counter", 1, "key", "value");
+  // Resolving the same timeseries again returns the same handle
+  EXPECT_EQ(
+      handle,
+      service303::get_counter_handle("test_fast_counter", 1, "key", "value"));
+
+  // Increments from different threads land in per-core shards
+  std::thread incrementer_1(
+      [handle]() { service303::increment_counter_handle(handle, 2); });
+  std::thread incrementer_2(
+      [handle]() { service303::increment_counter_handle(handle, 3); });
+  incrementer_1.join();
+  incrementer_2.join();
+
+  MetricsContainer metrics_container;
+  EXPECT_EQ(0, service303_client->GetMetrics(&metrics_container));
+  const MetricFamily* family =
+      &Service303Test::findFamily(metrics_container, "test_fast_counter");
+  EXPECT_EQ(family->metric().Get(0).counter().value(), 5);
+
+  // A later scrape folds in only the growth since the previous one
+  service303::increment_counter_handle(handle, 1);
+  EXPECT_EQ(0, service303_client->GetMetrics(&metrics_container));
+  family = &Service303Test::findFamily(metrics_container, "test_fast_counter");
+  EXPECT_EQ(family->metric().Get(0).counter().value(), 6);
+}
+
 // Tests that Service303 can instrument gauges and read them over gRPC.
 TEST_F(Service303Test, test_gauges) {
   // Increment gauge with labels
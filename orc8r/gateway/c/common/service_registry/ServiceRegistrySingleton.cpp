@@ -13,16 +13,17 @@
 
 #include "includes/ServiceRegistrySingleton.h"
 #include <assert.h>                            // for assert
+#include <grpcpp/channel.h>                    // for Channel
 #include <grpcpp/create_channel.h>             // for CreateCustomChannel
 #include <grpcpp/impl/codegen/config.h>        // for string
 #include <grpcpp/security/credentials.h>       // for SslCredentials, SslCre...
 #include <grpcpp/support/channel_arguments.h>  // for ChannelArguments
+#include <stdlib.h>                            // for atoi, getenv
 #include <fstream>                             // for basic_ostream, basic_o...
+#include <mutex>                               // for unique_lock
 #include <stdexcept>                           // for invalid_argument
 #include <string>                              // for string, allocator, ope...
-namespace grpc {
-class Channel;
-}
+#include <utility>                             // for move
 
 using grpc::CreateCustomChannel;
 using grpc::InsecureChannelCredentials;
@@ -62,6 +63,11 @@ ServiceRegistrySingleton::ServiceRegistrySingleton() {
       new YAML::Node(ServiceRegistrySingleton::GetProxyConfig()));
   registry_ = std::unique_ptr<YAML::Node>(
       new YAML::Node(ServiceRegistrySingleton::GetRegistry()));
+  const char* pool_size = getenv("MAGMA_GRPC_CHANNELS_PER_TARGET");
+  channels_per_target_  = 1;
+  if ((pool_size != nullptr) && (atoi(pool_size) > 0)) {
+    channels_per_target_ = (size_t) atoi(pool_size);
+  }
 }
 
 ip_port_pair_t ServiceRegistrySingleton::GetServiceAddr(
@@ -111,10 +117,46 @@ ServiceRegistrySingleton::GetSslCredentials() {
 
 const std::shared_ptr<Channel> ServiceRegistrySingleton::GetGrpcChannel(
     const std::string& service, const std::string& destination) {
+  std::string target = service + ":" + destination;
+  {
+    // Fast path: the pool exists and the picked channel is usable
+    std::shared_lock<std::shared_timed_mutex> lock(channel_pools_mutex_);
+    auto it = channel_pools_.find(target);
+    if (it != channel_pools_.end()) {
+      channel_pool_t* pool = it->second.get();
+      size_t index =
+          pool->next_channel.fetch_add(1, std::memory_order_relaxed) %
+          pool->channels.size();
+      std::shared_ptr<Channel> channel = pool->channels[index];
+      if (channel->GetState(false) != GRPC_CHANNEL_SHUTDOWN) {
+        return channel;
+      }
+    }
+  }
+  // Slow path: build the pool or replace shut-down channels. The channel
+  // args (YAML lookups, cert loads) are resolved outside the lock.
   create_grpc_channel_args_t args =
       GetCreateGrpcChannelArgs(service, destination);
-  return ServiceRegistrySingleton::CreateGrpcChannel(
-      args.ip, args.port, args.authority, args.creds);
+  std::unique_lock<std::shared_timed_mutex> lock(channel_pools_mutex_);
+  auto it = channel_pools_.find(target);
+  if (it == channel_pools_.end()) {
+    std::unique_ptr<channel_pool_t> pool(new channel_pool_t());
+    for (size_t i = 0; i < channels_per_target_; i++) {
+      pool->channels.push_back(CreatePoolChannel(args, i));
+    }
+    it = channel_pools_.emplace(target, std::move(pool)).first;
+  } else {
+    channel_pool_t* pool = it->second.get();
+    for (size_t i = 0; i < pool->channels.size(); i++) {
+      if (pool->channels[i]->GetState(false) == GRPC_CHANNEL_SHUTDOWN) {
+        pool->channels[i] = CreatePoolChannel(args, i);
+      }
+    }
+  }
+  channel_pool_t* pool = it->second.get();
+  size_t index = pool->next_channel.fetch_add(1, std::memory_order_relaxed) %
+                 pool->channels.size();
+  return pool->channels[index];
 }
 const create_grpc_channel_args_t
 ServiceRegistrySingleton::GetCreateGrpcChannelArgs(
@@ -164,6 +206,29 @@ const std::shared_ptr<Channel> ServiceRegistrySingleton::CreateGrpcChannel(
   return CreateCustomChannel(ss.str(), creds, arg);
 }
 
+std::shared_ptr<Channel> ServiceRegistrySingleton::CreatePoolChannel(
+    const create_grpc_channel_args_t& args, size_t channel_index) {
+  std::shared_ptr<ChannelCredentials> creds = args.creds;
+  if (creds == nullptr) {
+    creds = InsecureChannelCredentials();
+  }
+  grpc::ChannelArguments arg;
+
+  arg.SetString("grpc.default_authority", args.authority);
+  arg.SetInt("grpc.keepalive_time_ms", 30 * 1000);
+  // Distinct argument per pool member, otherwise gRPC folds the channels
+  // of a target onto one shared HTTP/2 connection
+  arg.SetInt("magma.channel_index", (int) channel_index);
+  std::ostringstream ss;
+  ss << args.ip << ":" << args.port;
+
+  std::shared_ptr<Channel> channel = CreateCustomChannel(ss.str(), creds, arg);
+  // Kick off connection establishment now so the first RPC on the channel
+  // does not pay TCP/TLS/HTTP2 setup inline
+  channel->GetState(true);
+  return channel;
+}
+
 const std::shared_ptr<Channel>
 ServiceRegistrySingleton::GetBootstrapperGrpcChannel() {
   YAML::Node proxyConfig = *(this->proxy_config_);
@@ -13,8 +13,12 @@
 #pragma once
 
 #include <yaml-cpp/yaml.h>                 // IWYU pragma: keep
+#include <atomic>                          // for atomic
 #include <memory>                          // for shared_ptr, unique_ptr
+#include <shared_mutex>                    // for shared_timed_mutex
 #include <string>                          // for string
+#include <unordered_map>                   // for unordered_map
+#include <vector>                          // for vector
 #include "includes/ServiceConfigLoader.h"  // for ServiceConfigLoader
 namespace grpc {
 class Channel;
@@ -86,6 +90,11 @@ class ServiceRegistrySingleton {
   /*
    * Gets a grpc connection to the specified service based on service name
    * and destination.
+   * Channels are cached per service:destination target in a small pool of
+   * HTTP/2 connections (MAGMA_GRPC_CHANNELS_PER_TARGET, default 1) picked
+   * round-robin. Pool channels start connecting when the pool is built and
+   * shut-down channels are replaced on lookup, so callers never pay
+   * TCP/TLS/HTTP2 setup inline on a request path.
    * @param service: service name to where a connection should be open.
    * @param destination: str indicating if a connection to the cloud service
    * or local service. Can be either "local" or "cloud".
@@ -113,11 +122,27 @@ class ServiceRegistrySingleton {
   const std::shared_ptr<Channel> CreateGrpcChannel(
       const std::string& ip, const std::string& port,
       const std::string& authority, std::shared_ptr<ChannelCredentials> creds);
+  // create one pool member and kick off its connection establishment
+  std::shared_ptr<Channel> CreatePoolChannel(
+      const create_grpc_channel_args_t& args, size_t channel_index);
 
  private:
+  // A pool of HTTP/2 connections to one service:destination target,
+  // picked round-robin by GetGrpcChannel
+  typedef struct {
+    std::vector<std::shared_ptr<Channel>> channels;
+    std::atomic<size_t> next_channel{0};
+  } channel_pool_t;
+
   ServiceConfigLoader service_config_loader_;
   std::unique_ptr<YAML::Node> proxy_config_;
   std::unique_ptr<YAML::Node> registry_;
+  size_t channels_per_target_;
+  std::unordered_map<std::string, std::unique_ptr<channel_pool_t>>
+      channel_pools_;
+  // readers share the lock on the hot lookup path, pool construction and
+  // stale-channel replacement take it exclusively
+  std::shared_timed_mutex channel_pools_mutex_;
   static ServiceRegistrySingleton* instance_;
 };
 
@@ -41,6 +41,16 @@ TEST(TestServiceRegistry, test_get_local_channel_args) {
   EXPECT_EQ(args.authority, "mobilityd.local");
 }
 
+TEST(TestServiceRegistry, test_channel_pool_reuse) {
+  auto first = ServiceRegistrySingleton::Instance()->GetGrpcChannel(
+      "mobilityd", "local");
+  auto second = ServiceRegistrySingleton::Instance()->GetGrpcChannel(
+      "mobilityd", "local");
+  // With the default single-channel pool both lookups multiplex onto the
+  // same cached channel instead of opening a new connection
+  EXPECT_EQ(first.get(), second.get());
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -234,6 +234,12 @@ class MagmaService(Service303Servicer):
         (host, port) = ServiceRegistry.get_service_address(self._name)
         self._port = self._server.add_insecure_port('{}:{}'.format(host, port))
         logging.info("Listening on address %s:%d", host, self._port)
+        if self._config and self._config.get('grpc_unix_socket'):
+            # Additional listener on a Unix socket, so colocated clients
+            # can skip the loopback TCP stack
+            unix_socket = self._config['grpc_unix_socket']
+            self._server.add_insecure_port('unix://{}'.format(unix_socket))
+            logging.info("Listening on unix socket %s", unix_socket)
         self._state = ServiceInfo.ALIVE
         # Python services are healthy immediately when run
         self._health = ServiceInfo.APP_HEALTHY
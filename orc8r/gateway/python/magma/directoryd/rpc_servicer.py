@@ -80,13 +80,37 @@ class GatewayDirectoryServiceRpcServicer(GatewayDirectoryServiceServicer):
         """
         logging.debug("UpdateRecord request received")
         self._print_grpc(request)
+        self._update_record(request, context)
+
+    @return_void
+    def UpdateRecords(self, request, context):
+        """ Update a batch of directory records in one call
+
+        Args:
+            request (UpdateRecordsRequest): update records request
+        """
+        logging.debug(
+            "UpdateRecords request received with %d records",
+            len(request.records),
+        )
+        self._print_grpc(request)
+        for record in request.records:
+            if not self._update_record(record, context):
+                return
+
+    def _update_record(self, request, context) -> bool:
+        """ Apply a single record update, setting error codes on context
+
+        Returns:
+            True if the record was applied, False on error
+        """
         if len(request.id) == 0:
             context.set_code(grpc.StatusCode.INVALID_ARGUMENT)
             context.set_details(
                 "ID argument cannot be empty in "
                 "UpdateRecordRequest",
             )
-            return
+            return False
 
         try:
             # Lock Redis for requested key until update is complete
@@ -112,6 +136,8 @@ class GatewayDirectoryServiceRpcServicer(GatewayDirectoryServiceServicer):
             logging.error(e)
             context.set_code(grpc.StatusCode.UNAVAILABLE)
             context.set_details("Could not connect to redis: %s" % e)
+            return False
+        return True
 
     @return_void
     def DeleteRecord(self, request, context):
@@ -48,6 +48,17 @@ class EventDRpcServicer(eventd_pb2_grpc.EventServiceServicer):
         """
         Logs an event.
         """
+        self._log_single_event(request, context)
+
+    @return_void
+    def LogEvents(self, request: eventd_pb2.EventList, context):
+        """
+        Logs a batch of events from one client-side batching interval.
+        """
+        for event in request.events:
+            self._log_single_event(event, context)
+
+    def _log_single_event(self, request: eventd_pb2.Event, context):
         logging.debug("Logging event: %s", request)
 
         try: